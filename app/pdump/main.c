@@ -10,7 +10,10 @@
 #include <getopt.h>
 #include <signal.h>
 #include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <net/if.h>
+#include <sys/utsname.h>
 
 #include <rte_eal.h>
 #include <rte_alarm.h>
@@ -27,6 +30,15 @@
 #include <rte_ring.h>
 #include <rte_string_fns.h>
 #include <rte_pdump.h>
+#include <rte_pcapng.h>
+#include <rte_bpf.h>
+#include <rte_malloc.h>
+#include <rte_cycles.h>
+#include <rte_version.h>
+
+#ifdef RTE_PORT_PCAP
+#include <pcap/pcap.h>
+#endif
 
 #define CMD_LINE_OPT_PDUMP "pdump"
 #define CMD_LINE_OPT_PDUMP_NUM 256
@@ -41,6 +53,12 @@
 #define PDUMP_RING_SIZE_ARG "ring-size"
 #define PDUMP_MSIZE_ARG "mbuf-size"
 #define PDUMP_NUM_MBUFS_ARG "total-num-mbufs"
+#define PDUMP_SNAPLEN_ARG "snaplen"
+#define PDUMP_FILTER_ARG "filter"
+#define PDUMP_FORMAT_ARG "format"
+
+#define FORMAT_PCAP "pcap"
+#define FORMAT_PCAPNG "pcapng"
 
 #define VDEV_NAME_FMT "net_pcap_%s_%d"
 #define VDEV_PCAP_ARGS_FMT "tx_pcap=%s"
@@ -97,6 +115,9 @@ static const char * const valid_pdump_arguments[] = {
 	PDUMP_RING_SIZE_ARG,
 	PDUMP_MSIZE_ARG,
 	PDUMP_NUM_MBUFS_ARG,
+	PDUMP_SNAPLEN_ARG,
+	PDUMP_FILTER_ARG,
+	PDUMP_FORMAT_ARG,
 	NULL
 };
 
@@ -116,12 +137,16 @@ struct pdump_tuples {
 	uint32_t ring_size;
 	uint16_t mbuf_data_size;
 	uint32_t total_num_mbufs;
+	uint32_t snaplen;
+	char *filter;
+	bool pcapng;
 
 	/* params for library API call */
 	uint32_t dir;
 	struct rte_mempool *mp;
 	struct rte_ring *rx_ring;
 	struct rte_ring *tx_ring;
+	struct rte_bpf_prm *prm;
 
 	/* params for packet dumping */
 	enum pdump_by dump_by_type;
@@ -131,6 +156,11 @@ struct pdump_tuples {
 	enum pcap_stream tx_vdev_stream_type;
 	bool single_pdump_dev;
 
+	/* params for writing pcapng files directly */
+	rte_pcapng_t *rx_pcapng;
+	rte_pcapng_t *tx_pcapng;
+	uint64_t start_tsc;
+
 	/* stats */
 	struct pdump_stats stats;
 } __rte_cache_aligned;
@@ -160,7 +190,10 @@ pdump_usage(const char *prgname)
 			" tx-dev=<iface or pcap file>,"
 			"[ring-size=<ring size>default:16384],"
 			"[mbuf-size=<mbuf data size>default:2176],"
-			"[total-num-mbufs=<number of mbufs>default:65535]'\n",
+			"[total-num-mbufs=<number of mbufs>default:65535],"
+			"[snaplen=<bytes to capture per packet>],"
+			"[filter=<pcap filter expression>],"
+			"[format=<pcap | pcapng>default:pcap]'\n",
 			prgname);
 }
 
@@ -212,6 +245,40 @@ parse_rxtxdev(const char *key, const char *value, void *extra_args)
 	return 0;
 }
 
+#ifdef RTE_PORT_PCAP
+static int
+parse_filter(const char *key __rte_unused, const char *value,
+		void *extra_args)
+{
+	struct pdump_tuples *pt = extra_args;
+
+	pt->filter = strdup(value);
+	if (pt->filter == NULL)
+		return -ENOMEM;
+
+	return 0;
+}
+#endif
+
+static int
+parse_format(const char *key, const char *value, void *extra_args)
+{
+	struct pdump_tuples *pt = extra_args;
+
+	if (!strcmp(value, FORMAT_PCAPNG))
+		pt->pcapng = true;
+	else if (!strcmp(value, FORMAT_PCAP))
+		pt->pcapng = false;
+	else {
+		printf("invalid value:\"%s\" for key:\"%s\", "
+			"value must be "FORMAT_PCAP" or "FORMAT_PCAPNG"\n",
+			value, key);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static int
 parse_uint_value(const char *key, const char *value, void *extra_args)
 {
@@ -370,6 +437,57 @@ parse_pdump(const char *optarg)
 	} else
 		pt->total_num_mbufs = MBUFS_PER_POOL;
 
+	/* output format parsing and validation */
+	cnt1 = rte_kvargs_count(kvlist, PDUMP_FORMAT_ARG);
+	if (cnt1 == 1) {
+		ret = rte_kvargs_process(kvlist, PDUMP_FORMAT_ARG,
+						&parse_format, pt);
+		if (ret < 0)
+			goto free_kvlist;
+	}
+	if (pt->pcapng && (pt->rx_vdev_stream_type == IFACE ||
+			pt->tx_vdev_stream_type == IFACE)) {
+		printf("--pdump=\"%s\": "FORMAT_PCAPNG" format can only "
+			"be written to files\n", optarg);
+		ret = -1;
+		goto free_kvlist;
+	}
+
+	/* snaplen parsing and validation */
+	cnt1 = rte_kvargs_count(kvlist, PDUMP_SNAPLEN_ARG);
+	if (cnt1 == 1) {
+		v.min = 1;
+		v.max = UINT16_MAX;
+		ret = rte_kvargs_process(kvlist, PDUMP_SNAPLEN_ARG,
+						&parse_uint_value, &v);
+		if (ret < 0)
+			goto free_kvlist;
+		pt->snaplen = (uint32_t) v.val;
+
+		/* unless told otherwise, size mbufs for the snap length */
+		if (rte_kvargs_count(kvlist, PDUMP_MSIZE_ARG) == 0)
+			pt->mbuf_data_size = RTE_MIN(pt->mbuf_data_size,
+				pt->pcapng ? rte_pcapng_mbuf_size(pt->snaplen) :
+				RTE_PKTMBUF_HEADROOM + pt->snaplen);
+	} else
+		pt->snaplen = UINT32_MAX;
+
+	/* filter parsing */
+	cnt1 = rte_kvargs_count(kvlist, PDUMP_FILTER_ARG);
+	if (cnt1 == 1) {
+#ifdef RTE_PORT_PCAP
+		ret = rte_kvargs_process(kvlist, PDUMP_FILTER_ARG,
+						&parse_filter, pt);
+		if (ret < 0)
+			goto free_kvlist;
+#else
+		printf("--pdump=\"%s\": filter requires libpcap support\n",
+			optarg);
+		ret = -1;
+		goto free_kvlist;
+#endif
+	}
+
 	num_tuples++;
 
 free_kvlist:
@@ -430,11 +548,24 @@ monitor_primary(void *arg __rte_unused)
 	quit_signal = 1;
 }
 
+/* port id of the captured device, for either way it was given */
+static int
+pdump_port_id(const struct pdump_tuples *pt, uint16_t *port)
+{
+	if (pt->dump_by_type == DEVICE_ID)
+		return rte_eth_dev_get_port_by_name(pt->device_id, port);
+
+	*port = pt->port;
+	return 0;
+}
+
 static void
 print_pdump_stats(void)
 {
 	int i;
 	struct pdump_tuples *pt;
+	struct rte_pdump_stats st;
+	uint16_t port;
 
 	for (i = 0; i < num_tuples; i++) {
 		printf("##### PDUMP DEBUG STATS #####\n");
@@ -445,6 +576,18 @@ print_pdump_stats(void)
 							pt->stats.tx_pkts);
 		printf(" -packets freed:			%"PRIu64"\n",
 							pt->stats.freed_pkts);
+
+		if (pdump_port_id(pt, &port) != 0 ||
+				rte_pdump_stats(port, &st) != 0)
+			continue;
+		printf(" -packets accepted by filter:		%"PRIu64"\n",
+							st.accepted);
+		printf(" -packets rejected by filter:		%"PRIu64"\n",
+							st.filtered);
+		printf(" -packets dropped, no mbufs:		%"PRIu64"\n",
+							st.nombuf);
+		printf(" -packets dropped, ring full:		%"PRIu64"\n",
+							st.ringfull);
 	}
 }
 
@@ -459,7 +602,8 @@ disable_pdump(struct pdump_tuples *pt)
 }
 
 static inline void
-pdump_rxtx(struct rte_ring *ring, uint16_t vdev_id, struct pdump_stats *stats)
+pdump_rxtx(struct rte_ring *ring, uint16_t vdev_id, rte_pcapng_t *pcapng,
+	struct pdump_stats *stats)
 {
 	/* write input packets of port to vdev for pdump */
 	struct rte_mbuf *rxtx_bufs[BURST_SIZE];
@@ -469,7 +613,14 @@ pdump_rxtx(struct rte_ring *ring, uint16_t vdev_id, struct pdump_stats *stats)
 			(void *)rxtx_bufs, BURST_SIZE, NULL);
 	stats->dequeue_pkts += nb_in_deq;
 
-	if (nb_in_deq) {
+	if (nb_in_deq && pcapng != NULL) {
+		/* the packets are already formatted, write them as is */
+		if (rte_pcapng_write_packets(pcapng, rxtx_bufs,
+				nb_in_deq) < 0)
+			stats->freed_pkts += nb_in_deq;
+		else
+			stats->tx_pkts += nb_in_deq;
+	} else if (nb_in_deq) {
 		/* then sent on vdev */
 		uint16_t nb_in_txd = rte_eth_tx_burst(
 				vdev_id,
@@ -486,11 +637,11 @@ pdump_rxtx(struct rte_ring *ring, uint16_t vdev_id, struct pdump_stats *stats)
 }
 
 static void
-free_ring_data(struct rte_ring *ring, uint16_t vdev_id,
+free_ring_data(struct rte_ring *ring, uint16_t vdev_id, rte_pcapng_t *pcapng,
 		struct pdump_stats *stats)
 {
 	while (rte_ring_count(ring))
-		pdump_rxtx(ring, vdev_id, stats);
+		pdump_rxtx(ring, vdev_id, pcapng, stats);
 }
 
 static void
@@ -504,6 +655,8 @@ cleanup_rings(void)
 
 		if (pt->device_id)
 			free(pt->device_id);
+		free(pt->filter);
+		rte_free(pt->prm);
 
 		/* free the rings */
 		if (pt->rx_ring)
@@ -513,6 +666,37 @@ cleanup_rings(void)
 	}
 }
 
+/* write the capture statistics and close the pcapng file(s) */
+static void
+close_pcapng(struct pdump_tuples *pt)
+{
+	struct rte_pdump_stats st;
+	uint64_t end_tsc = rte_get_tsc_cycles();
+	rte_pcapng_t *files[] = { pt->rx_pcapng, pt->tx_pcapng };
+	bool have_stats;
+	uint16_t port;
+	unsigned int i;
+
+	have_stats = pdump_port_id(pt, &port) == 0 &&
+		rte_pdump_stats(port, &st) == 0;
+
+	for (i = 0; i < RTE_DIM(files); i++) {
+		if (files[i] == NULL)
+			continue;
+		/* rx and tx may share the same file */
+		if (i == 1 && files[1] == files[0])
+			break;
+
+		if (have_stats)
+			rte_pcapng_write_stats(files[i], port, NULL,
+					pt->start_tsc, end_tsc, st.accepted,
+					st.nombuf + st.ringfull);
+		rte_pcapng_close(files[i]);
+	}
+	pt->rx_pcapng = NULL;
+	pt->tx_pcapng = NULL;
+}
+
 static void
 cleanup_pdump_resources(void)
 {
@@ -532,9 +716,16 @@ cleanup_pdump_resources(void)
 		* the vdev, in order to release mbufs to the mepool.
 		**/
 		if (pt->dir & RTE_PDUMP_FLAG_RX)
-			free_ring_data(pt->rx_ring, pt->rx_vdev_id, &pt->stats);
+			free_ring_data(pt->rx_ring, pt->rx_vdev_id,
+				pt->rx_pcapng, &pt->stats);
 		if (pt->dir & RTE_PDUMP_FLAG_TX)
-			free_ring_data(pt->tx_ring, pt->tx_vdev_id, &pt->stats);
+			free_ring_data(pt->tx_ring, pt->tx_vdev_id,
+				pt->tx_pcapng, &pt->stats);
+
+		if (pt->pcapng) {
+			close_pcapng(pt);
+			continue;
+		}
 
 		/* Remove the vdev(s) created */
 		if (pt->dir & RTE_PDUMP_FLAG_RX) {
@@ -628,6 +819,113 @@ configure_vdev(uint16_t port_id)
 	return 0;
 }
 
+#ifdef RTE_PORT_PCAP
+/* compile the pcap filter expression and convert it to eBPF */
+static void
+compile_filter(struct pdump_tuples *pt)
+{
+	struct bpf_program fcode;
+	pcap_t *pcap;
+
+	pcap = pcap_open_dead(DLT_EN10MB,
+		pt->snaplen == UINT32_MAX ? UINT16_MAX : (int)pt->snaplen);
+	if (pcap == NULL) {
+		cleanup_rings();
+		rte_exit(EXIT_FAILURE, "pcap_open_dead failed\n");
+	}
+
+	if (pcap_compile(pcap, &fcode, pt->filter, 1,
+			PCAP_NETMASK_UNKNOWN) != 0) {
+		printf("invalid filter \"%s\": %s\n", pt->filter,
+			pcap_geterr(pcap));
+		pcap_close(pcap);
+		cleanup_rings();
+		rte_exit(EXIT_FAILURE, "filter compilation failed\n");
+	}
+
+	pt->prm = rte_bpf_convert(&fcode);
+	pcap_freecode(&fcode);
+	pcap_close(pcap);
+	if (pt->prm == NULL) {
+		cleanup_rings();
+		rte_exit(EXIT_FAILURE, "filter conversion failed: %s\n",
+			rte_strerror(rte_errno));
+	}
+}
+#endif
+
+static rte_pcapng_t *
+open_pcapng(const char *path)
+{
+	char osname[SIZE], appname[SIZE];
+	struct utsname uts;
+	rte_pcapng_t *pcapng;
+	int fd;
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return NULL;
+
+	if (uname(&uts) == 0)
+		snprintf(osname, sizeof(osname), "%s %s",
+			uts.sysname, uts.release);
+	else
+		strlcpy(osname, "unknown", sizeof(osname));
+	snprintf(appname, sizeof(appname), "dpdk-pdump (%s)", rte_version());
+
+	pcapng = rte_pcapng_fdopen(fd, osname, NULL, appname, NULL);
+	if (pcapng == NULL)
+		close(fd);
+
+	return pcapng;
+}
+
+/* pcapng output is written by this process instead of a pcap vdev */
+static void
+create_ring_pcapng(struct pdump_tuples *pt, int i)
+{
+	char ring_name[SIZE];
+
+	if (pt->dir & RTE_PDUMP_FLAG_RX) {
+		snprintf(ring_name, SIZE, RX_RING, i);
+		pt->rx_ring = rte_ring_create(ring_name, pt->ring_size,
+				rte_socket_id(), 0);
+		if (pt->rx_ring == NULL) {
+			cleanup_rings();
+			rte_exit(EXIT_FAILURE, "%s\n",
+				rte_strerror(rte_errno));
+		}
+
+		pt->rx_pcapng = open_pcapng(pt->rx_dev);
+		if (pt->rx_pcapng == NULL) {
+			cleanup_rings();
+			rte_exit(EXIT_FAILURE, "cannot open %s\n",
+				pt->rx_dev);
+		}
+	}
+
+	if (pt->dir & RTE_PDUMP_FLAG_TX) {
+		snprintf(ring_name, SIZE, TX_RING, i);
+		pt->tx_ring = rte_ring_create(ring_name, pt->ring_size,
+				rte_socket_id(), 0);
+		if (pt->tx_ring == NULL) {
+			cleanup_rings();
+			rte_exit(EXIT_FAILURE, "%s\n",
+				rte_strerror(rte_errno));
+		}
+
+		if (pt->single_pdump_dev)
+			pt->tx_pcapng = pt->rx_pcapng;
+		else
+			pt->tx_pcapng = open_pcapng(pt->tx_dev);
+		if (pt->tx_pcapng == NULL) {
+			cleanup_rings();
+			rte_exit(EXIT_FAILURE, "cannot open %s\n",
+				pt->tx_dev);
+		}
+	}
+}
+
 static void
 create_mp_ring_vdev(void)
 {
@@ -660,6 +958,16 @@ create_mp_ring_vdev(void)
 		}
 		pt->mp = mbuf_pool;
 
+#ifdef RTE_PORT_PCAP
+		if (pt->filter != NULL)
+			compile_filter(pt);
+#endif
+
+		if (pt->pcapng) {
+			create_ring_pcapng(pt, i);
+			continue;
+		}
+
 		if (pt->dir == RTE_PDUMP_FLAG_RXTX) {
 			/* if captured packets has to send to the same vdev */
 			/* create rx_ring */
@@ -827,53 +1135,62 @@ enable_pdump(void)
 	int i;
 	struct pdump_tuples *pt;
 	int ret = 0, ret1 = 0;
+	uint32_t format;
 
 	for (i = 0; i < num_tuples; i++) {
 		pt = &pdump_t[i];
+		format = pt->pcapng ? RTE_PDUMP_FLAG_PCAPNG : 0;
+		pt->start_tsc = rte_get_tsc_cycles();
 		if (pt->dir == RTE_PDUMP_FLAG_RXTX) {
 			if (pt->dump_by_type == DEVICE_ID) {
-				ret = rte_pdump_enable_by_deviceid(
+				ret = rte_pdump_enable_bpf_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						RTE_PDUMP_FLAG_RX,
+						RTE_PDUMP_FLAG_RX | format,
+						pt->snaplen,
 						pt->rx_ring,
-						pt->mp, NULL);
-				ret1 = rte_pdump_enable_by_deviceid(
+						pt->mp, pt->prm);
+				ret1 = rte_pdump_enable_bpf_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						RTE_PDUMP_FLAG_TX,
+						RTE_PDUMP_FLAG_TX | format,
+						pt->snaplen,
 						pt->tx_ring,
-						pt->mp, NULL);
+						pt->mp, pt->prm);
 			} else if (pt->dump_by_type == PORT_ID) {
-				ret = rte_pdump_enable(pt->port, pt->queue,
-						RTE_PDUMP_FLAG_RX,
-						pt->rx_ring, pt->mp, NULL);
-				ret1 = rte_pdump_enable(pt->port, pt->queue,
-						RTE_PDUMP_FLAG_TX,
-						pt->tx_ring, pt->mp, NULL);
+				ret = rte_pdump_enable_bpf(pt->port, pt->queue,
+						RTE_PDUMP_FLAG_RX | format,
+						pt->snaplen,
+						pt->rx_ring, pt->mp, pt->prm);
+				ret1 = rte_pdump_enable_bpf(pt->port, pt->queue,
+						RTE_PDUMP_FLAG_TX | format,
+						pt->snaplen,
+						pt->tx_ring, pt->mp, pt->prm);
 			}
 		} else if (pt->dir == RTE_PDUMP_FLAG_RX) {
 			if (pt->dump_by_type == DEVICE_ID)
-				ret = rte_pdump_enable_by_deviceid(
+				ret = rte_pdump_enable_bpf_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						pt->dir, pt->rx_ring,
-						pt->mp, NULL);
+						pt->dir | format, pt->snaplen,
+						pt->rx_ring,
+						pt->mp, pt->prm);
 			else if (pt->dump_by_type == PORT_ID)
-				ret = rte_pdump_enable(pt->port, pt->queue,
-						pt->dir,
-						pt->rx_ring, pt->mp, NULL);
+				ret = rte_pdump_enable_bpf(pt->port, pt->queue,
+						pt->dir | format, pt->snaplen,
+						pt->rx_ring, pt->mp, pt->prm);
 		} else if (pt->dir == RTE_PDUMP_FLAG_TX) {
 			if (pt->dump_by_type == DEVICE_ID)
-				ret = rte_pdump_enable_by_deviceid(
+				ret = rte_pdump_enable_bpf_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						pt->dir,
-						pt->tx_ring, pt->mp, NULL);
+						pt->dir | format, pt->snaplen,
+						pt->tx_ring,
+						pt->mp, pt->prm);
 			else if (pt->dump_by_type == PORT_ID)
-				ret = rte_pdump_enable(pt->port, pt->queue,
-						pt->dir,
-						pt->tx_ring, pt->mp, NULL);
+				ret = rte_pdump_enable_bpf(pt->port, pt->queue,
+						pt->dir | format, pt->snaplen,
+						pt->tx_ring, pt->mp, pt->prm);
 		}
 		if (ret < 0 || ret1 < 0) {
 			cleanup_pdump_resources();
@@ -886,9 +1203,11 @@ static inline void
 pdump_packets(struct pdump_tuples *pt)
 {
 	if (pt->dir & RTE_PDUMP_FLAG_RX)
-		pdump_rxtx(pt->rx_ring, pt->rx_vdev_id, &pt->stats);
+		pdump_rxtx(pt->rx_ring, pt->rx_vdev_id, pt->rx_pcapng,
+			&pt->stats);
 	if (pt->dir & RTE_PDUMP_FLAG_TX)
-		pdump_rxtx(pt->tx_ring, pt->tx_vdev_id, &pt->stats);
+		pdump_rxtx(pt->tx_ring, pt->tx_vdev_id, pt->tx_pcapng,
+			&pt->stats);
 }
 
 static int
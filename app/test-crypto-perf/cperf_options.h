@@ -26,6 +26,7 @@
 #define CPERF_OPTYPE		("optype")
 #define CPERF_SESSIONLESS	("sessionless")
 #define CPERF_OUT_OF_PLACE	("out-of-place")
+#define CPERF_RAW_DP		("raw-dp")
 #define CPERF_TEST_FILE		("test-file")
 #define CPERF_TEST_NAME		("test-name")
 
@@ -95,6 +96,7 @@ struct cperf_options {
 
 	uint32_t sessionless:1;
 	uint32_t out_of_place:1;
+	uint32_t raw_dp:1;
 	uint32_t silent:1;
 	uint32_t csv:1;
 
@@ -37,6 +37,7 @@ usage(char *progname)
 		"           auth-then-cipher / aead : set operation type\n"
 		" --sessionless: enable session-less crypto operations\n"
 		" --out-of-place: enable out-of-place crypto operations\n"
+		" --raw-dp: use the raw data-path API instead of crypto operations\n"
 		" --test-file NAME: set the test vector file path\n"
 		" --test-name NAME: set specific test name section in test file\n"
 		" --cipher-algo ALGO: set cipher algorithm\n"
@@ -477,6 +478,14 @@ parse_out_of_place(struct cperf_options *opts,
 	return 0;
 }
 
+static int
+parse_raw_dp(struct cperf_options *opts,
+		const char *arg __rte_unused)
+{
+	opts->raw_dp = 1;
+	return 0;
+}
+
 static int
 parse_test_file(struct cperf_options *opts,
 		const char *arg)
@@ -793,6 +802,7 @@ static struct option lgopts[] = {
 	{ CPERF_SILENT, no_argument, 0, 0 },
 	{ CPERF_SESSIONLESS, no_argument, 0, 0 },
 	{ CPERF_OUT_OF_PLACE, no_argument, 0, 0 },
+	{ CPERF_RAW_DP, no_argument, 0, 0 },
 	{ CPERF_TEST_FILE, required_argument, 0, 0 },
 	{ CPERF_TEST_NAME, required_argument, 0, 0 },
 
@@ -867,6 +877,7 @@ cperf_options_default(struct cperf_options *opts)
 	opts->test_name = NULL;
 	opts->sessionless = 0;
 	opts->out_of_place = 0;
+	opts->raw_dp = 0;
 	opts->csv = 0;
 
 	opts->cipher_algo = RTE_CRYPTO_CIPHER_AES_CBC;
@@ -909,6 +920,7 @@ cperf_opts_parse_long(int opt_idx, struct cperf_options *opts)
 		{ CPERF_OPTYPE,		parse_op_type },
 		{ CPERF_SESSIONLESS,	parse_sessionless },
 		{ CPERF_OUT_OF_PLACE,	parse_out_of_place },
+		{ CPERF_RAW_DP,		parse_raw_dp },
 		{ CPERF_IMIX,		parse_imix },
 		{ CPERF_TEST_FILE,	parse_test_file },
 		{ CPERF_TEST_NAME,	parse_test_name },
@@ -1059,6 +1071,24 @@ cperf_options_check(struct cperf_options *options)
 		return -EINVAL;
 	}
 
+	if (options->raw_dp) {
+		if (options->test != CPERF_TEST_TYPE_THROUGHPUT) {
+			RTE_LOG(ERR, USER1, "Raw data-path mode is only "
+					"supported by the throughput test\n");
+			return -EINVAL;
+		}
+		if (options->sessionless || options->out_of_place ||
+				options->op_type == CPERF_PDCP ||
+				options->imix_distribution_count != 0 ||
+				options->segment_sz < options->max_buffer_size +
+					options->digest_sz) {
+			RTE_LOG(ERR, USER1, "Raw data-path mode can only work "
+					"in-place with sessions, on non "
+					"segmented buffers and without IMIX\n");
+			return -EINVAL;
+		}
+	}
+
 	if ((options->imix_distribution_count != 0) &&
 			(options->imix_distribution_count !=
 				options->buffer_size_count)) {
@@ -1195,6 +1225,7 @@ cperf_options_dump(struct cperf_options *opts)
 	printf("# crypto operation: %s\n", cperf_op_type_strs[opts->op_type]);
 	printf("# sessionless: %s\n", opts->sessionless ? "yes" : "no");
 	printf("# out of place: %s\n", opts->out_of_place ? "yes" : "no");
+	printf("# raw data-path: %s\n", opts->raw_dp ? "yes" : "no");
 	if (opts->test == CPERF_TEST_TYPE_PMDCC)
 		printf("# inter-burst delay: %u ms\n", opts->pmdcc_delay);
 
@@ -20,6 +20,8 @@ struct cperf_throughput_ctx {
 
 	struct rte_cryptodev_sym_session *sess;
 
+	struct rte_crypto_raw_dp_ctx *raw_dp_ctx;
+
 	cperf_populate_ops_t populate_ops;
 
 	uint32_t src_buf_offset;
@@ -52,9 +54,95 @@ cperf_throughput_test_free(struct cperf_throughput_ctx *ctx)
 	if (ctx->pool)
 		rte_mempool_free(ctx->pool);
 
+	rte_free(ctx->raw_dp_ctx);
 	rte_free(ctx);
 }
 
+static int
+cperf_throughput_raw_dp_ctx_init(struct cperf_throughput_ctx *ctx)
+{
+	int size;
+
+	size = rte_cryptodev_get_raw_dp_ctx_size(ctx->dev_id);
+	if (size < 0) {
+		RTE_LOG(ERR, USER1, "Device %u does not support the raw "
+				"data-path API\n", ctx->dev_id);
+		return -1;
+	}
+
+	ctx->raw_dp_ctx = rte_zmalloc(NULL, size, 0);
+	if (ctx->raw_dp_ctx == NULL)
+		return -1;
+
+	if (rte_cryptodev_configure_raw_dp_ctx(ctx->dev_id, ctx->qp_id,
+			ctx->raw_dp_ctx, ctx->sess) < 0) {
+		RTE_LOG(ERR, USER1, "Failed to configure raw data-path "
+				"context of device %u queue pair %u\n",
+				ctx->dev_id, ctx->qp_id);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Enqueue the buffers of the crypto operation objects through the raw
+ * data-path API, using the objects only as buffer holders and user data.
+ * Data is processed in place from the start of the buffer, with the digest
+ * following it, as set up by the crypto operation populate functions.
+ */
+static uint16_t
+cperf_throughput_raw_enqueue_burst(struct cperf_throughput_ctx *ctx,
+		struct rte_crypto_op **ops, uint16_t nb_ops, uint16_t iv_offset)
+{
+	const struct cperf_options *options = ctx->options;
+	const struct cperf_test_vector *test_vector = ctx->test_vector;
+	struct rte_crypto_vec data_vec[nb_ops];
+	struct rte_crypto_sgl sgl[nb_ops];
+	void *iv[nb_ops], *aad[nb_ops], *digest[nb_ops];
+	struct rte_crypto_sym_vec vec;
+	union rte_crypto_sym_ofs ofs;
+	uint16_t aad_offset = iv_offset +
+			RTE_ALIGN_CEIL(test_vector->aead_iv.length, 16);
+	uint8_t digest_verify = options->op_type == CPERF_AEAD ?
+			options->aead_op == RTE_CRYPTO_AEAD_OP_DECRYPT :
+			options->auth_op == RTE_CRYPTO_AUTH_OP_VERIFY;
+	uint16_t i;
+
+	for (i = 0; i < nb_ops; i++) {
+		struct rte_mbuf *m = ops[i]->sym->m_src;
+
+		data_vec[i].base = rte_pktmbuf_mtod(m, void *);
+		data_vec[i].iova = rte_pktmbuf_iova(m);
+		data_vec[i].len = options->test_buffer_size;
+		sgl[i].vec = &data_vec[i];
+		sgl[i].num = 1;
+
+		iv[i] = rte_crypto_op_ctod_offset(ops[i], uint8_t *,
+				iv_offset);
+		aad[i] = rte_crypto_op_ctod_offset(ops[i], uint8_t *,
+				aad_offset);
+		if (digest_verify)
+			digest[i] = test_vector->digest.data;
+		else
+			digest[i] = rte_pktmbuf_mtod_offset(m, uint8_t *,
+					options->test_buffer_size);
+	}
+
+	vec.sgl = sgl;
+	vec.iv = iv;
+	vec.aad = aad;
+	vec.digest = digest;
+	vec.status = NULL;
+	vec.num = nb_ops;
+
+	/* cipher and auth regions cover the whole buffer */
+	ofs.raw = 0;
+
+	return rte_cryptodev_raw_enqueue_burst(ctx->raw_dp_ctx, &vec, ofs,
+			(void **)ops);
+}
+
 void *
 cperf_throughput_test_constructor(struct rte_mempool *sess_mp,
 		struct rte_mempool *sess_priv_mp,
@@ -65,7 +153,7 @@ cperf_throughput_test_constructor(struct rte_mempool *sess_mp,
 {
 	struct cperf_throughput_ctx *ctx = NULL;
 
-	ctx = rte_malloc(NULL, sizeof(struct cperf_throughput_ctx), 0);
+	ctx = rte_zmalloc(NULL, sizeof(struct cperf_throughput_ctx), 0);
 	if (ctx == NULL)
 		goto err;
 
@@ -85,6 +173,9 @@ cperf_throughput_test_constructor(struct rte_mempool *sess_mp,
 	if (ctx->sess == NULL)
 		goto err;
 
+	if (options->raw_dp && cperf_throughput_raw_dp_ctx_init(ctx) < 0)
+		goto err;
+
 	if (cperf_alloc_common_memory(options, test_vector, dev_id, qp_id, 0,
 			&ctx->src_buf_offset, &ctx->dst_buf_offset,
 			&ctx->pool) < 0)
@@ -109,6 +200,7 @@ cperf_throughput_test_runner(void *test_ctx)
 
 	struct rte_crypto_op *ops[ctx->options->max_burst_size];
 	struct rte_crypto_op *ops_processed[ctx->options->max_burst_size];
+	int32_t status[ctx->options->max_burst_size];
 	uint64_t i;
 
 	uint32_t lcore = rte_lcore_id();
@@ -173,11 +265,12 @@ cperf_throughput_test_runner(void *test_ctx)
 			}
 
 			/* Setup crypto op, attach mbuf etc */
-			(ctx->populate_ops)(ops, ctx->src_buf_offset,
-					ctx->dst_buf_offset,
-					ops_needed, ctx->sess,
-					ctx->options, ctx->test_vector,
-					iv_offset, &imix_idx);
+			if (ctx->raw_dp_ctx == NULL)
+				(ctx->populate_ops)(ops, ctx->src_buf_offset,
+						ctx->dst_buf_offset,
+						ops_needed, ctx->sess,
+						ctx->options, ctx->test_vector,
+						iv_offset, &imix_idx);
 
 			/**
 			 * When ops_needed is smaller than ops_enqd, the
@@ -204,8 +297,14 @@ cperf_throughput_test_runner(void *test_ctx)
 #endif /* CPERF_LINEARIZATION_ENABLE */
 
 			/* Enqueue burst of ops on crypto device */
-			ops_enqd = rte_cryptodev_enqueue_burst(ctx->dev_id, ctx->qp_id,
-					ops, burst_size);
+			if (ctx->raw_dp_ctx != NULL)
+				ops_enqd = cperf_throughput_raw_enqueue_burst(
+						ctx, ops, burst_size,
+						iv_offset);
+			else
+				ops_enqd = rte_cryptodev_enqueue_burst(
+						ctx->dev_id, ctx->qp_id,
+						ops, burst_size);
 			if (ops_enqd < burst_size)
 				ops_enqd_failed++;
 
@@ -218,8 +317,15 @@ cperf_throughput_test_runner(void *test_ctx)
 
 
 			/* Dequeue processed burst of ops from crypto device */
-			ops_deqd = rte_cryptodev_dequeue_burst(ctx->dev_id, ctx->qp_id,
-					ops_processed, test_burst_size);
+			if (ctx->raw_dp_ctx != NULL)
+				ops_deqd = rte_cryptodev_raw_dequeue_burst(
+						ctx->raw_dp_ctx,
+						(void **)ops_processed, status,
+						test_burst_size);
+			else
+				ops_deqd = rte_cryptodev_dequeue_burst(
+						ctx->dev_id, ctx->qp_id,
+						ops_processed, test_burst_size);
 
 			if (likely(ops_deqd))  {
 				/* Free crypto ops so they can be reused. */
@@ -241,12 +347,21 @@ cperf_throughput_test_runner(void *test_ctx)
 		/* Dequeue any operations still in the crypto device */
 
 		while (ops_deqd_total < ctx->options->total_ops) {
-			/* Sending 0 length burst to flush sw crypto device */
-			rte_cryptodev_enqueue_burst(ctx->dev_id, ctx->qp_id, NULL, 0);
-
 			/* dequeue burst */
-			ops_deqd = rte_cryptodev_dequeue_burst(ctx->dev_id, ctx->qp_id,
-					ops_processed, test_burst_size);
+			if (ctx->raw_dp_ctx != NULL)
+				ops_deqd = rte_cryptodev_raw_dequeue_burst(
+						ctx->raw_dp_ctx,
+						(void **)ops_processed, status,
+						test_burst_size);
+			else {
+				/* Sending 0 length burst to flush sw crypto device */
+				rte_cryptodev_enqueue_burst(ctx->dev_id,
+						ctx->qp_id, NULL, 0);
+
+				ops_deqd = rte_cryptodev_dequeue_burst(
+						ctx->dev_id, ctx->qp_id,
+						ops_processed, test_burst_size);
+			}
 			if (ops_deqd == 0)
 				ops_deqd_failed++;
 			else {
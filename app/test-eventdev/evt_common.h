@@ -64,13 +64,17 @@ struct evt_options {
 	uint32_t deq_tmo_nsec;
 	uint32_t q_priority:1;
 	uint32_t fwd_latency:1;
+	uint32_t lat_hist:1;
 	uint64_t nb_pkts;
+	uint64_t prod_rate;
 	uint64_t nb_timers;
 	uint64_t expiry_nsec;
 	uint64_t max_tmo_nsec;
 	uint64_t timer_tick_nsec;
 	uint64_t optm_timer_tick_nsec;
 	enum evt_prod_type prod_type;
+#define EVT_CSV_NAME_MAX_LEN      256
+	char csv_file[EVT_CSV_NAME_MAX_LEN];
 };
 
 static inline bool
@@ -78,6 +78,34 @@ evt_parse_fwd_latency(struct evt_options *opt, const char *arg __rte_unused)
 	return 0;
 }
 
+static int
+evt_parse_lat_hist(struct evt_options *opt, const char *arg __rte_unused)
+{
+	opt->lat_hist = 1;
+	return 0;
+}
+
+static int
+evt_parse_prod_rate(struct evt_options *opt, const char *arg)
+{
+	int ret;
+
+	ret = parser_read_uint64(&(opt->prod_rate), arg);
+
+	return ret;
+}
+
+static int
+evt_parse_csv(struct evt_options *opt, const char *arg)
+{
+	if (strlcpy(opt->csv_file, arg, EVT_CSV_NAME_MAX_LEN) >=
+			EVT_CSV_NAME_MAX_LEN) {
+		evt_err("csv file name too long");
+		return -EINVAL;
+	}
+	return 0;
+}
+
 static int
 evt_parse_queue_priority(struct evt_options *opt, const char *arg __rte_unused)
 {
@@ -270,6 +298,10 @@ usage(char *program)
 		"\t--nb_pkts          : number of packets to produce\n"
 		"\t--worker_deq_depth : dequeue depth of the worker\n"
 		"\t--fwd_latency      : perform fwd_latency measurement\n"
+		"\t--lat_hist         : collect per-stage latency histograms\n"
+		"\t--prod_rate        : open-loop mode, events per second\n"
+		"\t                     injected by each producer.\n"
+		"\t--csv              : append the results to a csv file.\n"
 		"\t--queue_priority   : enable queue priority\n"
 		"\t--deq_tmo_nsec     : global dequeue timeout\n"
 		"\t--prod_type_ethdev : use ethernet device as producer.\n"
@@ -344,6 +376,9 @@ static struct option lgopts[] = {
 	{ EVT_WKR_DEQ_DEP,         1, 0, 0 },
 	{ EVT_SCHED_TYPE_LIST,     1, 0, 0 },
 	{ EVT_FWD_LATENCY,         0, 0, 0 },
+	{ EVT_LAT_HIST,            0, 0, 0 },
+	{ EVT_PROD_RATE,           1, 0, 0 },
+	{ EVT_CSV,                 1, 0, 0 },
 	{ EVT_QUEUE_PRIORITY,      0, 0, 0 },
 	{ EVT_DEQ_TMO_NSEC,        1, 0, 0 },
 	{ EVT_PROD_ETHDEV,         0, 0, 0 },
@@ -378,6 +413,9 @@ evt_opts_parse_long(int opt_idx, struct evt_options *opt)
 		{ EVT_WKR_DEQ_DEP, evt_parse_wkr_deq_dep},
 		{ EVT_SCHED_TYPE_LIST, evt_parse_sched_type_list},
 		{ EVT_FWD_LATENCY, evt_parse_fwd_latency},
+		{ EVT_LAT_HIST, evt_parse_lat_hist},
+		{ EVT_PROD_RATE, evt_parse_prod_rate},
+		{ EVT_CSV, evt_parse_csv},
 		{ EVT_QUEUE_PRIORITY, evt_parse_queue_priority},
 		{ EVT_DEQ_TMO_NSEC, evt_parse_deq_tmo_nsec},
 		{ EVT_PROD_ETHDEV, evt_parse_eth_prod_type},
@@ -30,6 +30,9 @@
 #define EVT_NB_STAGES            ("nb_stages")
 #define EVT_SCHED_TYPE_LIST      ("stlist")
 #define EVT_FWD_LATENCY          ("fwd_latency")
+#define EVT_LAT_HIST             ("lat_hist")
+#define EVT_PROD_RATE            ("prod_rate")
+#define EVT_CSV                  ("csv")
 #define EVT_QUEUE_PRIORITY       ("queue_priority")
 #define EVT_DEQ_TMO_NSEC         ("deq_tmo_nsec")
 #define EVT_PROD_ETHDEV          ("prod_type_ethdev")
@@ -200,6 +203,16 @@ evt_dump_fwd_latency(struct evt_options *opt)
 	evt_dump("fwd_latency", "%s", EVT_BOOL_FMT(opt->fwd_latency));
 }
 
+static inline void
+evt_dump_lat_hist(struct evt_options *opt)
+{
+	evt_dump("lat_hist", "%s", EVT_BOOL_FMT(opt->lat_hist));
+	if (opt->prod_rate)
+		evt_dump("prod_rate", "%"PRIu64" events/s", opt->prod_rate);
+	if (opt->csv_file[0] != '\0')
+		evt_dump("csv", "%s", opt->csv_file);
+}
+
 static inline void
 evt_dump_queue_priority(struct evt_options *opt)
 {
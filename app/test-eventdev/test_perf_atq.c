@@ -52,6 +52,10 @@ perf_atq_worker(void *arg, const int enable_fwd_latency)
 		/* first stage in pipeline, mark ts to compute fwd latency */
 			atq_mark_fwd_latency(&ev);
 
+		if (w->hist != NULL)
+			perf_lat_hist_stage(w, &ev,
+					ev.sub_event_type % nb_stages, laststage);
+
 		/* last stage in pipeline */
 		if (unlikely((ev.sub_event_type % nb_stages) == laststage)) {
 			if (enable_fwd_latency)
@@ -94,6 +98,11 @@ perf_atq_worker_burst(void *arg, const int enable_fwd_latency)
 				 */
 				atq_mark_fwd_latency(&ev[i]);
 			}
+			if (w->hist != NULL)
+				perf_lat_hist_stage(w, &ev[i],
+						ev[i].sub_event_type % nb_stages,
+						laststage);
+
 			/* last stage in pipeline */
 			if (unlikely((ev[i].sub_event_type % nb_stages)
 						== laststage)) {
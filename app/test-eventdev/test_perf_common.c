@@ -4,13 +4,170 @@
 
 #include "test_perf_common.h"
 
+static void
+perf_lat_hist_merge(struct perf_lat_hist *dst, const struct perf_lat_hist *src)
+{
+	unsigned int i;
+
+	if (src->count == 0)
+		return;
+
+	for (i = 0; i < PERF_HIST_NB_BUCKETS; i++)
+		dst->bucket[i] += src->bucket[i];
+
+	dst->min = dst->count ? RTE_MIN(dst->min, src->min) : src->min;
+	dst->max = RTE_MAX(dst->max, src->max);
+	dst->sum += src->sum;
+	dst->jitter_sum += src->jitter_sum;
+	dst->count += src->count;
+}
+
+/* Upper bound of the bucket holding the pct-th percentile sample */
+static uint64_t
+perf_lat_hist_percentile(const struct perf_lat_hist *h, double pct)
+{
+	uint64_t target = (uint64_t)((h->count * pct) / 100);
+	uint64_t cum = 0, upper;
+	unsigned int i, shift;
+
+	if (target == 0)
+		target = 1;
+
+	for (i = 0; i < PERF_HIST_NB_BUCKETS; i++) {
+		cum += h->bucket[i];
+		if (cum >= target)
+			break;
+	}
+
+	if (i < PERF_HIST_SUB)
+		return i;
+
+	shift = i / PERF_HIST_SUB - 1;
+	upper = ((uint64_t)(PERF_HIST_SUB + i % PERF_HIST_SUB) << shift) +
+		(1ULL << shift) - 1;
+
+	return RTE_MIN(upper, h->max);
+}
+
+struct perf_lat_summary {
+	uint64_t samples;
+	double avg;
+	double min;
+	double p50;
+	double p99;
+	double p999;
+	double max;
+	double jitter;
+};
+
+/* The jitter is the mean difference between consecutive samples of a worker,
+ * nb_pairs is the number of such differences in the histogram.
+ */
+static void
+perf_lat_hist_summarize(const struct perf_lat_hist *h, uint64_t nb_pairs,
+		struct perf_lat_summary *sum)
+{
+	/* Report in nanoseconds */
+	const double ns = 1E9 / rte_get_timer_hz();
+
+	memset(sum, 0, sizeof(*sum));
+	if (h->count == 0)
+		return;
+
+	sum->samples = h->count;
+	sum->avg = ((double)h->sum / h->count) * ns;
+	sum->min = h->min * ns;
+	sum->p50 = perf_lat_hist_percentile(h, 50) * ns;
+	sum->p99 = perf_lat_hist_percentile(h, 99) * ns;
+	sum->p999 = perf_lat_hist_percentile(h, 99.9) * ns;
+	sum->max = h->max * ns;
+	sum->jitter = nb_pairs ?
+		((double)h->jitter_sum / nb_pairs) * ns : 0;
+}
+
+static FILE *
+perf_csv_open(struct evt_options *opt)
+{
+	FILE *f;
+
+	f = fopen(opt->csv_file, "a");
+	if (f == NULL) {
+		evt_err("failed to open %s", opt->csv_file);
+		return NULL;
+	}
+
+	/* Write the header only once, so runs can be appended to a file */
+	fseek(f, 0, SEEK_END);
+	if (ftell(f) == 0)
+		fprintf(f, "test,stage,samples,avg_ns,min_ns,p50_ns,p99_ns,"
+			"p99.9_ns,max_ns,jitter_ns,prod_rate,avg_mpps\n");
+
+	return f;
+}
+
+static void
+perf_lat_report(struct test_perf *t, struct evt_options *opt, FILE *csv)
+{
+	const uint8_t nb_stages = opt->nb_stages;
+	struct perf_lat_summary sum;
+	struct perf_lat_hist *h;
+	uint64_t nb_pairs;
+	char stage[16];
+	int i, s;
+
+	h = rte_zmalloc(NULL, sizeof(*h), RTE_CACHE_LINE_SIZE);
+	if (h == NULL) {
+		evt_err("failed to allocate latency histogram");
+		return;
+	}
+
+	printf("Latency distribution (ns):\n");
+	printf("%-8s %12s %10s %10s %10s %10s %10s %10s %10s\n", "stage",
+			"samples", "avg", "min", "p50", "p99", "p99.9", "max",
+			"jitter");
+
+	for (s = 0; s <= nb_stages; s++) {
+		memset(h, 0, sizeof(*h));
+		nb_pairs = 0;
+		for (i = 0; i < t->nb_workers; i++) {
+			const struct perf_lat_hist *wh;
+
+			if (t->worker[i].hist == NULL)
+				continue;
+			wh = &t->worker[i].hist[s];
+			perf_lat_hist_merge(h, wh);
+			nb_pairs += wh->count ? wh->count - 1 : 0;
+		}
+		perf_lat_hist_summarize(h, nb_pairs, &sum);
+
+		if (s == nb_stages)
+			snprintf(stage, sizeof(stage), "e2e");
+		else
+			snprintf(stage, sizeof(stage), "%d", s);
+
+		printf(CLGRN"%-8s %12"PRIu64" %10.0f %10.0f %10.0f %10.0f "
+				"%10.0f %10.0f %10.0f\n"CLNRM, stage,
+				sum.samples, sum.avg, sum.min, sum.p50, sum.p99,
+				sum.p999, sum.max, sum.jitter);
+
+		if (csv != NULL)
+			fprintf(csv, "%s,%s,%"PRIu64",%.0f,%.0f,%.0f,%.0f,"
+				"%.0f,%.0f,%.0f,%"PRIu64",%.3f\n",
+				opt->test_name, stage, sum.samples, sum.avg,
+				sum.min, sum.p50, sum.p99, sum.p999, sum.max,
+				sum.jitter, opt->prod_rate, t->avg_mpps);
+	}
+
+	rte_free(h);
+}
+
 int
 perf_test_result(struct evt_test *test, struct evt_options *opt)
 {
-	RTE_SET_USED(opt);
 	int i;
 	uint64_t total = 0;
 	struct test_perf *t = evt_test_priv(test);
+	FILE *csv = NULL;
 
 	printf("Packet distribution across worker cores :\n");
 	for (i = 0; i < t->nb_workers; i++)
@@ -22,6 +179,18 @@ perf_test_result(struct evt_test *test, struct evt_options *opt)
 				(((double)t->worker[i].processed_pkts)/total)
 				* 100);
 
+	if (opt->csv_file[0] != '\0')
+		csv = perf_csv_open(opt);
+
+	if (opt->lat_hist)
+		perf_lat_report(t, opt, csv);
+	else if (csv != NULL)
+		fprintf(csv, "%s,all,%"PRIu64",,,,,,,,%"PRIu64",%.3f\n",
+			opt->test_name, total, opt->prod_rate, t->avg_mpps);
+
+	if (csv != NULL)
+		fclose(csv);
+
 	return t->result;
 }
 
@@ -41,6 +210,10 @@ perf_producer(void *arg)
 	uint64_t count = 0;
 	struct perf_elt *m[BURST_SIZE + 1] = {NULL};
 	struct rte_event ev;
+	/* Open-loop mode injects events at a fixed rate */
+	const double cycles_per_ev = opt->prod_rate ?
+		(double)rte_get_timer_hz() / opt->prod_rate : 0;
+	const uint64_t start = rte_get_timer_cycles();
 
 	if (opt->verbose_level > 1)
 		printf("%s(): lcore %d dev_id %d port=%d queue %d\n", __func__,
@@ -60,13 +233,29 @@ perf_producer(void *arg)
 		for (i = 0; i < BURST_SIZE; i++) {
 			ev.flow_id = flow_counter++ % nb_flows;
 			ev.event_ptr = m[i];
-			m[i]->timestamp = rte_get_timer_cycles();
+			if (cycles_per_ev) {
+				/* Stamp the event with its scheduled injection
+				 * time, so the time it waits for the producer
+				 * counts towards its latency.
+				 */
+				m[i]->timestamp = start +
+					(uint64_t)((count + i) * cycles_per_ev);
+				while (rte_get_timer_cycles() <
+						m[i]->timestamp)
+					rte_pause();
+			} else {
+				m[i]->timestamp = rte_get_timer_cycles();
+			}
+			m[i]->stage_ts = m[i]->timestamp;
 			while (rte_event_enqueue_burst(dev_id,
 						       port, &ev, 1) != 1) {
 				if (t->done)
 					break;
 				rte_pause();
+				if (cycles_per_ev)
+					continue;
 				m[i]->timestamp = rte_get_timer_cycles();
+				m[i]->stage_ts = m[i]->timestamp;
 			}
 		}
 		count += BURST_SIZE;
@@ -119,12 +308,14 @@ perf_event_timer_producer(void *arg)
 			m[i]->tim.ev.flow_id = flow_counter++ % nb_flows;
 			m[i]->tim.ev.event_ptr = m[i];
 			m[i]->timestamp = rte_get_timer_cycles();
+			m[i]->stage_ts = m[i]->timestamp;
 			while (rte_event_timer_arm_burst(
 			       adptr[flow_counter % nb_timer_adptrs],
 			       (struct rte_event_timer **)&m[i], 1) != 1) {
 				if (t->done)
 					break;
 				m[i]->timestamp = rte_get_timer_cycles();
+				m[i]->stage_ts = m[i]->timestamp;
 			}
 			arm_latency += rte_get_timer_cycles() - m[i]->timestamp;
 		}
@@ -183,6 +374,7 @@ perf_event_timer_producer_burst(void *arg)
 			m[i]->tim.ev.flow_id = flow_counter++ % nb_flows;
 			m[i]->tim.ev.event_ptr = m[i];
 			m[i]->timestamp = rte_get_timer_cycles();
+			m[i]->stage_ts = m[i]->timestamp;
 		}
 		rte_event_timer_arm_tmo_tick_burst(
 				adptr[flow_counter % nb_timer_adptrs],
@@ -311,6 +503,7 @@ perf_launch_lcores(struct evt_test *test, struct evt_options *opt,
 			perf_cycles = new_cycles;
 			total_mpps += mpps;
 			++samples;
+			t->avg_mpps = total_mpps / samples;
 			if (opt->fwd_latency && pkts > 0) {
 				printf(CLGRN"\r%.3f mpps avg %.3f mpps [avg fwd latency %.3f us] "CLNRM,
 					mpps, total_mpps/samples,
@@ -614,6 +807,16 @@ perf_opt_check(struct evt_options *opt, uint64_t nb_queues)
 		evt_info("enabled queue priority for latency measurement");
 		opt->q_priority = 1;
 	}
+
+	if (opt->lat_hist && opt->prod_type == EVT_PROD_TYPE_ETH_RX_ADPTR) {
+		evt_info("lat_hist is not valid with ethdev producers, disabling");
+		opt->lat_hist = 0;
+	}
+
+	if (opt->prod_rate && opt->prod_type != EVT_PROD_TYPE_SYNT) {
+		evt_info("prod_rate is valid with synthetic producers only, ignoring");
+		opt->prod_rate = 0;
+	}
 	if (opt->nb_pkts == 0)
 		opt->nb_pkts = INT64_MAX/evt_nr_active_lcores(opt->plcores);
 
@@ -631,6 +834,7 @@ perf_opt_dump(struct evt_options *opt, uint8_t nb_queues)
 	evt_dump("nb_evdev_ports", "%d", perf_nb_event_ports(opt));
 	evt_dump("nb_evdev_queues", "%d", nb_queues);
 	evt_dump_queue_priority(opt);
+	evt_dump_lat_hist(opt);
 	evt_dump_sched_type_list(opt);
 	evt_dump_producer_type(opt);
 }
@@ -825,7 +1029,25 @@ perf_test_setup(struct evt_test *test, struct evt_options *opt)
 	t->opt = opt;
 	memcpy(t->sched_type_list, opt->sched_type_list,
 			sizeof(opt->sched_type_list));
+
+	if (opt->lat_hist) {
+		uint8_t i;
+
+		/* One histogram per stage plus end-to-end, per worker */
+		for (i = 0; i < t->nb_workers; i++) {
+			t->worker[i].hist = rte_zmalloc_socket(test->name,
+					sizeof(struct perf_lat_hist) *
+					(opt->nb_stages + 1),
+					RTE_CACHE_LINE_SIZE, opt->socket_id);
+			if (t->worker[i].hist == NULL) {
+				evt_err("failed to allocate latency histograms");
+				goto free_hist;
+			}
+		}
+	}
 	return 0;
+free_hist:
+	perf_test_destroy(test, opt);
 nomem:
 	return -ENOMEM;
 }
@@ -833,7 +1055,17 @@ perf_test_setup(struct evt_test *test, struct evt_options *opt)
 void
 perf_test_destroy(struct evt_test *test, struct evt_options *opt)
 {
+	struct test_perf *t = evt_test_priv(test);
+	int i;
+
 	RTE_SET_USED(opt);
 
+	if (t == NULL)
+		return;
+	for (i = 0; i < EVT_MAX_PORTS; i++) {
+		rte_free(t->worker[i].hist);
+		t->worker[i].hist = NULL;
+	}
 	rte_free(test->test_priv);
+	test->test_priv = NULL;
 }
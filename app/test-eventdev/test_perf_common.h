@@ -25,12 +25,33 @@
 
 struct test_perf;
 
+/* Log-linear latency histogram: values below PERF_HIST_SUB cycles get a
+ * bucket each, above that every power of 2 is split in PERF_HIST_SUB buckets,
+ * which bounds the percentile error to 1/PERF_HIST_SUB of the value.
+ */
+#define PERF_HIST_SUB_BITS 4
+#define PERF_HIST_SUB (1 << PERF_HIST_SUB_BITS)
+#define PERF_HIST_NB_BUCKETS ((64 - PERF_HIST_SUB_BITS + 1) * PERF_HIST_SUB)
+
+struct perf_lat_hist {
+	uint64_t count;
+	uint64_t sum;
+	uint64_t min;
+	uint64_t max;
+	/* Previous sample and sum of differences, for the jitter */
+	uint64_t last;
+	uint64_t jitter_sum;
+	uint64_t bucket[PERF_HIST_NB_BUCKETS];
+} __rte_cache_aligned;
+
 struct worker_data {
 	uint64_t processed_pkts;
 	uint64_t latency;
 	uint8_t dev_id;
 	uint8_t port_id;
 	struct test_perf *t;
+	/* nb_stages + 1 histograms, the last one is end-to-end latency */
+	struct perf_lat_hist *hist;
 } __rte_cache_aligned;
 
 struct prod_data {
@@ -49,6 +70,7 @@ struct test_perf {
 	uint64_t outstand_pkts;
 	uint8_t nb_workers;
 	enum evt_test_result result;
+	float avg_mpps;
 	uint32_t nb_flows;
 	uint64_t nb_pkts;
 	struct rte_mempool *pool;
@@ -66,6 +88,12 @@ struct perf_elt {
 		struct {
 			char pad[offsetof(struct rte_event_timer, user_meta)];
 			uint64_t timestamp;
+			/* Time the event entered its current stage */
+			uint64_t stage_ts;
+			/* Time the event was produced, as timestamp may be
+			 * reset on the first stage for fwd_latency.
+			 */
+			uint64_t e2e_ts;
 		};
 	};
 } __rte_cache_aligned;
@@ -131,6 +159,52 @@ perf_process_last_stage_latency(struct rte_mempool *const pool,
 	return count;
 }
 
+static inline __attribute__((always_inline)) void
+perf_lat_hist_add(struct perf_lat_hist *const h, const uint64_t v)
+{
+	unsigned int idx;
+
+	if (v < PERF_HIST_SUB) {
+		idx = v;
+	} else {
+		const unsigned int shift = 63 - __builtin_clzll(v) -
+				PERF_HIST_SUB_BITS;
+
+		idx = (shift + 1) * PERF_HIST_SUB +
+			((v >> shift) & (PERF_HIST_SUB - 1));
+	}
+
+	h->bucket[idx]++;
+	if (h->count) {
+		h->jitter_sum += v > h->last ? v - h->last : h->last - v;
+		h->min = RTE_MIN(h->min, v);
+	} else {
+		h->min = v;
+	}
+	h->max = RTE_MAX(h->max, v);
+	h->last = v;
+	h->sum += v;
+	h->count++;
+}
+
+/* Record the time the event spent reaching this stage, from the producer or
+ * the worker of the previous stage, and the end-to-end latency on the last
+ * stage.
+ */
+static inline __attribute__((always_inline)) void
+perf_lat_hist_stage(struct worker_data *const w, struct rte_event *const ev,
+		const uint8_t stage, const uint8_t laststage)
+{
+	struct perf_elt *const m = ev->event_ptr;
+	const uint64_t now = rte_get_timer_cycles();
+
+	if (stage == 0)
+		m->e2e_ts = m->stage_ts;
+	perf_lat_hist_add(&w->hist[stage], now - m->stage_ts);
+	if (stage == laststage)
+		perf_lat_hist_add(&w->hist[laststage + 1], now - m->e2e_ts);
+	m->stage_ts = now;
+}
 
 static inline int
 perf_nb_event_ports(struct evt_options *opt)
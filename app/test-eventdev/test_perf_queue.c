@@ -53,6 +53,10 @@ perf_queue_worker(void *arg, const int enable_fwd_latency)
 		/* first q in pipeline, mark timestamp to compute fwd latency */
 			mark_fwd_latency(&ev, nb_stages);
 
+		if (w->hist != NULL)
+			perf_lat_hist_stage(w, &ev,
+					ev.queue_id % nb_stages, laststage);
+
 		/* last stage in pipeline */
 		if (unlikely((ev.queue_id % nb_stages) == laststage)) {
 			if (enable_fwd_latency)
@@ -95,6 +99,11 @@ perf_queue_worker_burst(void *arg, const int enable_fwd_latency)
 				 */
 				mark_fwd_latency(&ev[i], nb_stages);
 			}
+			if (w->hist != NULL)
+				perf_lat_hist_stage(w, &ev[i],
+						ev[i].queue_id % nb_stages,
+						laststage);
+
 			/* last stage in pipeline */
 			if (unlikely((ev[i].queue_id % nb_stages) ==
 						 laststage)) {
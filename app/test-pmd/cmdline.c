@@ -617,7 +617,7 @@ static void cmd_help_long_parsed(void *parsed_result,
 			"set bonding mode IEEE802.3AD aggregator policy (port_id) (agg_name)"
 			"	Set Aggregation mode for IEEE802.3AD (mode 4)"
 
-			"set bonding xmit_balance_policy (port_id) (l2|l23|l34)\n"
+			"set bonding xmit_balance_policy (port_id) (l2|l23|l34|rss)\n"
 			"	Set the transmit balance policy for bonded device running in balance mode.\n\n"
 
 			"set bonding mon_period (port_id) (value)\n"
@@ -5794,6 +5794,8 @@ static void cmd_set_bonding_balance_xmit_policy_parsed(void *parsed_result,
 		policy = BALANCE_XMIT_POLICY_LAYER23;
 	} else if (!strcmp(res->policy, "l34")) {
 		policy = BALANCE_XMIT_POLICY_LAYER34;
+	} else if (!strcmp(res->policy, "rss")) {
+		policy = BALANCE_XMIT_POLICY_RSS;
 	} else {
 		printf("\t Invalid xmit policy selection");
 		return;
@@ -5820,12 +5822,12 @@ TOKEN_NUM_INITIALIZER(struct cmd_set_bonding_balance_xmit_policy_result,
 		port_id, UINT16);
 cmdline_parse_token_string_t cmd_setbonding_balance_xmit_policy_policy =
 TOKEN_STRING_INITIALIZER(struct cmd_set_bonding_balance_xmit_policy_result,
-		policy, "l2#l23#l34");
+		policy, "l2#l23#l34#rss");
 
 cmdline_parse_inst_t cmd_set_balance_xmit_policy = {
 		.f = cmd_set_bonding_balance_xmit_policy_parsed,
 		.help_str = "set bonding balance_xmit_policy <port_id> "
-			"l2|l23|l34: "
+			"l2|l23|l34|rss: "
 			"Set the bonding balance_xmit_policy for port_id",
 		.data = NULL,
 		.tokens = {
@@ -5887,6 +5889,9 @@ static void cmd_show_bonding_config_parsed(void *parsed_result,
 			case BALANCE_XMIT_POLICY_LAYER34:
 				printf("BALANCE_XMIT_POLICY_LAYER34");
 				break;
+			case BALANCE_XMIT_POLICY_RSS:
+				printf("BALANCE_XMIT_POLICY_RSS");
+				break;
 			}
 			printf("\n");
 		}
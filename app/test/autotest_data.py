@@ -494,6 +494,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Cryptodev cpu aesni gcm autotest",
+        "Command": "cryptodev_cpu_aesni_gcm_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Cryptodev null autotest",
         "Command": "cryptodev_null_autotest",
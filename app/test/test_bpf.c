@@ -8,6 +8,7 @@
 #include <inttypes.h>
 
 #include <rte_memory.h>
+#include <rte_malloc.h>
 #include <rte_debug.h>
 #include <rte_hexdump.h>
 #include <rte_random.h>
@@ -16,6 +17,7 @@
 #include <rte_bpf.h>
 #include <rte_ether.h>
 #include <rte_ip.h>
+#include <rte_udp.h>
 
 #include "test.h"
 
@@ -43,6 +45,13 @@ struct dummy_net {
 	struct rte_ipv4_hdr ip_hdr;
 };
 
+#define	DUMMY_MBUF_BUF_SIZE	(RTE_PKTMBUF_HEADROOM + 0x80)
+
+struct dummy_mbuf {
+	struct rte_mbuf mb[2];
+	uint8_t buf[2][DUMMY_MBUF_BUF_SIZE];
+};
+
 #define	TEST_FILL_1	0xDEADBEEF
 
 #define	TEST_MUL_1	21
@@ -2458,6 +2467,133 @@ static const struct rte_bpf_xsym test_call5_xsym[] = {
 	},
 };
 
+/* load packet data through BPF_LD | BPF_ABS and BPF_LD | BPF_IND */
+#define	TEST_LD_MBUF_PORT	0x1234
+#define	TEST_LD_MBUF_SEG0	(sizeof(struct rte_ether_hdr) + \
+	sizeof(struct rte_ipv4_hdr) + offsetof(struct rte_udp_hdr, dst_port) + 1)
+
+static const struct ebpf_insn test_ld_mbuf1_prog[] = {
+
+	/* BPF_ABS/BPF_IND always expect mbuf pointer in R6 */
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_6,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_LD | BPF_ABS | BPF_H),
+		.imm = offsetof(struct rte_ether_hdr, ether_type),
+	},
+	{
+		.code = (BPF_JMP | EBPF_JNE | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = RTE_ETHER_TYPE_IPV4,
+		.off = 6,
+	},
+	/* R7 = IPv4 header length */
+	{
+		.code = (BPF_LD | BPF_ABS | BPF_B),
+		.imm = sizeof(struct rte_ether_hdr),
+	},
+	{
+		.code = (BPF_ALU | BPF_AND | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = RTE_IPV4_HDR_IHL_MASK,
+	},
+	{
+		.code = (BPF_ALU | BPF_LSH | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 2,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_7,
+		.src_reg = EBPF_REG_0,
+	},
+	/* UDP destination port, crosses the segment boundary */
+	{
+		.code = (BPF_LD | BPF_IND | BPF_H),
+		.src_reg = EBPF_REG_7,
+		.imm = sizeof(struct rte_ether_hdr) +
+			offsetof(struct rte_udp_hdr, dst_port),
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+	{
+		.code = (BPF_ALU | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+static void
+dummy_mbuf_prep(struct rte_mbuf *mb, uint8_t buf[], uint32_t buf_len,
+	uint32_t data_len)
+{
+	memset(mb, 0, sizeof(*mb));
+	mb->buf_addr = buf;
+	mb->buf_iova = (uintptr_t)buf;
+	mb->buf_len = buf_len;
+	rte_mbuf_refcnt_set(mb, 1);
+
+	/* set pool pointer to dummy value, test doesn't use it */
+	mb->pool = (void *)buf;
+
+	rte_pktmbuf_reset(mb);
+	rte_pktmbuf_append(mb, data_len);
+}
+
+static void
+test_ld_mbuf1_prepare(void *arg)
+{
+	struct dummy_mbuf *dm;
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip;
+	uint8_t pkt[TEST_LD_MBUF_SEG0 + sizeof(struct rte_udp_hdr)];
+	uint32_t n;
+
+	dm = arg;
+	memset(pkt, 0, sizeof(pkt));
+
+	eth = (struct rte_ether_hdr *)pkt;
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+	ip = (struct rte_ipv4_hdr *)(eth + 1);
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->next_proto_id = IPPROTO_UDP;
+
+	*(unaligned_uint16_t *)((uint8_t *)(ip + 1) +
+		offsetof(struct rte_udp_hdr, dst_port)) =
+		rte_cpu_to_be_16(TEST_LD_MBUF_PORT);
+
+	/* split the packet between two segments */
+	n = TEST_LD_MBUF_SEG0;
+	dummy_mbuf_prep(&dm->mb[0], dm->buf[0], sizeof(dm->buf[0]), n);
+	dummy_mbuf_prep(&dm->mb[1], dm->buf[1], sizeof(dm->buf[1]),
+		sizeof(pkt) - n);
+
+	memcpy(rte_pktmbuf_mtod(&dm->mb[0], void *), pkt, n);
+	memcpy(rte_pktmbuf_mtod(&dm->mb[1], void *), pkt + n,
+		sizeof(pkt) - n);
+
+	rte_pktmbuf_chain(&dm->mb[0], &dm->mb[1]);
+}
+
+static int
+test_ld_mbuf1_check(uint64_t rc, const void *arg)
+{
+	uint64_t v;
+
+	RTE_SET_USED(arg);
+
+	v = TEST_LD_MBUF_PORT;
+	return cmp_res(__func__, v, rc, &v, &rc, sizeof(v));
+}
+
 static const struct bpf_test tests[] = {
 	{
 		.name = "test_store1",
@@ -2717,6 +2853,21 @@ static const struct bpf_test tests[] = {
 		/* for now don't support function calls on 32 bit platform */
 		.allow_fail = (sizeof(uint64_t) != sizeof(uintptr_t)),
 	},
+	{
+		.name = "test_ld_mbuf1",
+		.arg_sz = sizeof(struct dummy_mbuf),
+		.prm = {
+			.ins = test_ld_mbuf1_prog,
+			.nb_ins = RTE_DIM(test_ld_mbuf1_prog),
+			.prog_arg = {
+				.type = RTE_BPF_ARG_PTR_MBUF,
+				.size = sizeof(struct rte_mbuf),
+				.buf_size = DUMMY_MBUF_BUF_SIZE,
+			},
+		},
+		.prepare = test_ld_mbuf1_prepare,
+		.check_result = test_ld_mbuf1_check,
+	},
 };
 
 static int
@@ -2781,3 +2932,113 @@ test_bpf(void)
 }
 
 REGISTER_TEST_COMMAND(bpf_autotest, test_bpf);
+
+#ifdef RTE_PORT_PCAP
+#include <pcap/pcap.h>
+
+/*
+ * Compile a filter with libpcap, convert it to eBPF and run it over
+ * the packet, through the interpreter and the JIT if there is one.
+ * Returns 1 if the packet matches, 0 if not, -1 on error.
+ */
+static int
+test_bpf_match(pcap_t *pcap, const char *str, struct rte_mbuf *mb)
+{
+	struct bpf_program fcode;
+	struct rte_bpf_prm *prm;
+	struct rte_bpf *bpf;
+	struct rte_bpf_jit jit;
+	uint64_t rc;
+	int ret = -1;
+
+	if (pcap_compile(pcap, &fcode, str, 1, PCAP_NETMASK_UNKNOWN) != 0) {
+		printf("%s@%d: pcap_compile(\"%s\") failed: %s;\n",
+			__func__, __LINE__, str, pcap_geterr(pcap));
+		return -1;
+	}
+
+	prm = rte_bpf_convert(&fcode);
+	pcap_freecode(&fcode);
+	if (prm == NULL) {
+		printf("%s@%d: rte_bpf_convert(\"%s\") failed, error=%d(%s);\n",
+			__func__, __LINE__, str, rte_errno,
+			strerror(rte_errno));
+		return -1;
+	}
+
+	bpf = rte_bpf_load(prm);
+	rte_free(prm);
+	if (bpf == NULL) {
+		printf("%s@%d: failed to load \"%s\", error=%d(%s);\n",
+			__func__, __LINE__, str, rte_errno,
+			strerror(rte_errno));
+		return -1;
+	}
+
+	/* a capture filter returns non-zero when the packet matches */
+	rc = rte_bpf_exec(bpf, mb);
+	ret = rc != 0;
+
+	rte_bpf_get_jit(bpf, &jit);
+	if (jit.func != NULL && (jit.func(mb) != 0) != ret) {
+		printf("%s@%d: \"%s\" gives different results with JIT;\n",
+			__func__, __LINE__, str);
+		ret = -1;
+	}
+
+	rte_bpf_destroy(bpf);
+	return ret;
+}
+
+static int
+test_bpf_convert(void)
+{
+	static const struct {
+		const char *str;
+		int match;
+	} filters[] = {
+		{ "", 1 },
+		{ "ip", 1 },
+		{ "udp", 1 },
+		{ "udp dst port 4660", 1 },
+		{ "ip and udp[2:2] = 0x1234", 1 },
+		{ "not tcp", 1 },
+		{ "tcp", 0 },
+		{ "ip6", 0 },
+		{ "arp", 0 },
+		{ "udp dst port 53", 0 },
+		{ "udp src port 4660", 0 },
+		{ "vlan", 0 },
+	};
+	struct dummy_mbuf dm;
+	pcap_t *pcap;
+	uint32_t i;
+	int32_t rc, rv;
+
+	pcap = pcap_open_dead(DLT_EN10MB, 262144);
+	if (pcap == NULL) {
+		printf("%s@%d: pcap_open_dead failed;\n", __func__, __LINE__);
+		return -1;
+	}
+
+	/* UDP packet to port TEST_LD_MBUF_PORT, split in two segments */
+	test_ld_mbuf1_prepare(&dm);
+
+	rc = 0;
+	for (i = 0; i != RTE_DIM(filters); i++) {
+		rv = test_bpf_match(pcap, filters[i].str, &dm.mb[0]);
+		if (rv != filters[i].match) {
+			printf("%s@%d: filter \"%s\" %s, expected %s;\n",
+				__func__, __LINE__, filters[i].str,
+				rv < 0 ? "failed" : rv ? "matched" : "missed",
+				filters[i].match ? "match" : "miss");
+			rc = -1;
+		}
+	}
+
+	pcap_close(pcap);
+	return rc;
+}
+
+REGISTER_TEST_COMMAND(bpf_convert_autotest, test_bpf_convert);
+#endif /* RTE_PORT_PCAP */
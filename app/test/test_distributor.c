@@ -563,6 +563,35 @@ int test_error_distributor_create_numworkers(void)
 }
 
 
+static
+int test_error_distributor_configure(struct rte_distributor *ds,
+		struct rte_distributor *db)
+{
+	struct rte_distributor_conf conf = { 0 };
+
+	if (rte_distributor_configure(ds, &conf) != -ENOTSUP) {
+		printf("ERROR: No error on configure() of single distributor\n");
+		return -1;
+	}
+
+	conf.burst_size = RTE_DISTRIB_MAX_BURST_SIZE + 1;
+	if (rte_distributor_configure(db, &conf) != -EINVAL) {
+		printf("ERROR: No error on configure() with burst size > MAX\n");
+		return -1;
+	}
+
+	conf.burst_size = 0;
+	conf.flow_table_size = 1000;
+	if (rte_distributor_configure(db, &conf) != -EINVAL) {
+		printf("ERROR: No error on configure() with table size not a "
+				"power of 2\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
 /* Useful function which ensures that all worker functions terminate */
 static void
 quit_workers(struct worker_params *wp, struct rte_mempool *p)
@@ -593,7 +622,9 @@ test_distributor(void)
 {
 	static struct rte_distributor *ds;
 	static struct rte_distributor *db;
-	static struct rte_distributor *dist[2];
+	static struct rte_distributor *dt;
+	static struct rte_distributor *dist[3];
+	static const char * const names[] = { "single", "burst", "tuned" };
 	static struct rte_mempool *p;
 	int i;
 
@@ -629,6 +660,29 @@ test_distributor(void)
 		rte_distributor_clear_returns(ds);
 	}
 
+	/*
+	 * Short bursts, flow affinity and return batching: the sanity tests
+	 * must give the same results, only slower to drain returns.
+	 */
+	if (dt == NULL) {
+		struct rte_distributor_conf conf = {
+			.burst_size = 4,
+			.flow_table_size = 1024,
+			.flags = RTE_DISTRIB_F_RETURN_BATCH,
+		};
+
+		dt = rte_distributor_create("Test_dist_tuned", rte_socket_id(),
+				rte_lcore_count() - 1,
+				RTE_DIST_ALG_BURST);
+		if (dt == NULL || rte_distributor_configure(dt, &conf) != 0) {
+			printf("Error creating tuned burst distributor\n");
+			return -1;
+		}
+	} else {
+		rte_distributor_flush(dt);
+		rte_distributor_clear_returns(dt);
+	}
+
 	const unsigned nb_bufs = (511 * rte_lcore_count()) < BIG_BATCH ?
 			(BIG_BATCH * 2) - 1 : (511 * rte_lcore_count());
 	if (p == NULL) {
@@ -642,16 +696,13 @@ test_distributor(void)
 
 	dist[0] = ds;
 	dist[1] = db;
+	dist[2] = dt;
 
-	for (i = 0; i < 2; i++) {
+	for (i = 0; i < 3; i++) {
 
 		worker_params.dist = dist[i];
-		if (i)
-			strlcpy(worker_params.name, "burst",
-					sizeof(worker_params.name));
-		else
-			strlcpy(worker_params.name, "single",
-					sizeof(worker_params.name));
+		strlcpy(worker_params.name, names[i],
+				sizeof(worker_params.name));
 
 		rte_eal_mp_remote_launch(handle_work,
 				&worker_params, SKIP_MASTER);
@@ -694,6 +745,11 @@ test_distributor(void)
 		return -1;
 	}
 
+	if (test_error_distributor_configure(ds, db) == -1) {
+		printf("rte_distributor_configure parameter check tests failed");
+		return -1;
+	}
+
 	return 0;
 
 err:
@@ -658,6 +658,98 @@ adapter_start_stop(void)
 	return TEST_SUCCESS;
 }
 
+static int
+adapter_event_vector_config(void)
+{
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	struct rte_mempool *vector_mp;
+	struct rte_event ev;
+	int err;
+
+	vector_mp = rte_event_vector_pool_create("test_vector_pool", 64, 0,
+						32, rte_socket_id());
+	TEST_ASSERT(vector_mp != NULL, "Failed to create vector pool");
+
+	memset(&ev, 0, sizeof(ev));
+	ev.queue_id = 0;
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	ev.priority = 0;
+
+	queue_config.rx_queue_flags = 0;
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+					-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vec_conf.vector_sz = 32;
+	vec_conf.vector_timeout_ns = 100 * 1000;
+	vec_conf.vector_mp = vector_mp;
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, -1, &vec_conf);
+	if (!(default_params.caps &
+			RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR)) {
+		TEST_ASSERT(err == -ENOTSUP, "Expected -ENOTSUP got %d", err);
+		goto queue_del;
+	}
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, NULL);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(1,
+					TEST_ETHDEV_ID, 0, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	/* vector larger than the pool elements */
+	vec_conf.vector_sz = 64;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	vec_conf.vector_sz = 16;
+	vec_conf.vector_mp = NULL;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	/* zero vector size disables vectorization */
+	vec_conf.vector_sz = 0;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_start(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_stop(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+queue_del:
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* queues must be added before they can be vectorized */
+	vec_conf.vector_sz = 32;
+	vec_conf.vector_mp = vector_mp;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &vec_conf);
+	TEST_ASSERT(err < 0, "Expected error got %d", err);
+
+	rte_mempool_free(vector_mp);
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_stats(void)
 {
@@ -688,6 +780,8 @@ static struct unit_test_suite event_eth_rx_tests = {
 					adapter_multi_eth_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_start_stop),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_stats),
+		TEST_CASE_ST(adapter_create, adapter_free,
+					adapter_event_vector_config),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -457,6 +457,71 @@ tx_adapter_single(uint16_t port, uint16_t tx_queue_id,
 	return -1;
 }
 
+#define TXA_VECTOR_SIZE	8
+
+static int
+tx_adapter_vector(uint16_t port, uint16_t tx_queue_id,
+		struct rte_mbuf **m, uint16_t n, uint8_t qid,
+		struct rte_mempool *vector_mp)
+{
+	struct rte_event_vector *vec;
+	struct rte_event event;
+	struct rte_mbuf *r[TXA_VECTOR_SIZE];
+	uint16_t nb_rx;
+	unsigned int l;
+	uint16_t i;
+	int ret;
+
+	ret = rte_mempool_get(vector_mp, (void **)&vec);
+	TEST_ASSERT(ret == 0, "Failed to get event vector");
+
+	vec->nb_elem = n;
+	vec->attr_valid = 1;
+	vec->port = port;
+	vec->queue = tx_queue_id;
+	for (i = 0; i < n; i++)
+		vec->mbufs[i] = m[i];
+
+	memset(&event, 0, sizeof(event));
+	event.queue_id = qid;
+	event.op = RTE_EVENT_OP_NEW;
+	event.event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+	event.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	event.vec = vec;
+
+	l = 0;
+	while (rte_event_enqueue_burst(TEST_DEV_ID, 0, &event, 1) != 1) {
+		l++;
+		if (l > EDEV_RETRY)
+			break;
+	}
+	TEST_ASSERT(l < EDEV_RETRY, "Unable to enqueue to eventdev");
+
+	nb_rx = 0;
+	l = 0;
+	while (nb_rx < n && l++ < EDEV_RETRY) {
+
+		if (eid != ~0ULL) {
+			ret = rte_service_run_iter_on_app_lcore(eid, 0);
+			TEST_ASSERT(ret == 0, "failed to run service %d", ret);
+		}
+
+		ret = rte_service_run_iter_on_app_lcore(tid, 0);
+		TEST_ASSERT(ret == 0, "failed to run service %d", ret);
+
+		nb_rx += rte_eth_rx_burst(TEST_ETHDEV_PAIR_ID, tx_queue_id,
+				&r[nb_rx], n - nb_rx);
+	}
+
+	TEST_ASSERT_EQUAL(nb_rx, n, "Expected %u packets received %u",
+			n, nb_rx);
+	for (i = 0; i < n; i++)
+		TEST_ASSERT_EQUAL(r[i], m[i], "mbuf comparison failed"
+				" expected %p received %p", m[i], r[i]);
+
+	return 0;
+}
+
 static int
 tx_adapter_service(void)
 {
@@ -466,6 +531,7 @@ tx_adapter_service(void)
 	uint8_t ev_port, ev_qid;
 	struct rte_mbuf  bufs[RING_SIZE];
 	struct rte_mbuf *pbufs[RING_SIZE];
+	struct rte_mempool *vector_mp;
 	struct rte_event_dev_info dev_info;
 	struct rte_event_dev_config dev_conf;
 	struct rte_event_queue_conf qconf;
@@ -596,14 +662,28 @@ tx_adapter_service(void)
 		}
 	}
 
+	/* a vector event is expanded and its vector returned to the pool */
+	vector_mp = rte_event_vector_pool_create("txa_vector_pool", 1, 0,
+						TXA_VECTOR_SIZE, SOCKET0);
+	TEST_ASSERT(vector_mp != NULL, "Failed to create vector pool");
+	for (q = 0; q < MAX_NUM_QUEUE; q++) {
+		err = tx_adapter_vector(TEST_ETHDEV_ID, q, pbufs,
+					TXA_VECTOR_SIZE, ev_qid, vector_mp);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	}
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vector_mp), 1,
+			"Event vector not returned to its pool");
+	rte_mempool_free(vector_mp);
+
 	err = rte_event_eth_tx_adapter_stats_get(TEST_INST_ID, NULL);
 	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
 
 	err = rte_event_eth_tx_adapter_stats_get(TEST_INST_ID, &stats);
 	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
-	TEST_ASSERT_EQUAL(stats.tx_packets, MAX_NUM_QUEUE * RING_SIZE,
+	TEST_ASSERT_EQUAL(stats.tx_packets,
+			MAX_NUM_QUEUE * (RING_SIZE + TXA_VECTOR_SIZE),
 			"stats.tx_packets expected %u got %"PRIu64,
-			MAX_NUM_QUEUE * RING_SIZE,
+			MAX_NUM_QUEUE * (RING_SIZE + TXA_VECTOR_SIZE),
 			stats.tx_packets);
 
 	err = rte_event_eth_tx_adapter_stats_reset(TEST_INST_ID);
@@ -2988,6 +2988,73 @@ test_balance_l34_tx_burst_ipv6_toggle_udp_port(void)
 	return balance_l34_tx_burst(0, 0, 0, 0, 1);
 }
 
+#define TEST_BAL_RSS_SLAVE_COUNT	(4)
+#define TEST_BAL_RSS_FLOW_COUNT		(8)
+#define TEST_BAL_RSS_PKTS_PER_FLOW	(4)
+#define TEST_BAL_RSS_BURST_SIZE \
+	(TEST_BAL_RSS_FLOW_COUNT * TEST_BAL_RSS_PKTS_PER_FLOW)
+
+/* Slave the RSS policy picks for a hash, folded as the bonding PMD does */
+static uint16_t
+balance_rss_slave(uint32_t hash, uint16_t slave_count)
+{
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+
+	return hash % slave_count;
+}
+
+static int
+test_balance_rss_tx_burst(void)
+{
+	struct rte_mbuf *pkts_burst[TEST_BAL_RSS_BURST_SIZE];
+	unsigned int expected[TEST_BAL_RSS_SLAVE_COUNT] = { 0 };
+	unsigned int i, used = 0;
+	struct rte_eth_stats port_stats;
+	uint32_t hash;
+	int nb_tx;
+
+	TEST_ASSERT_SUCCESS(initialize_bonded_device_with_slaves(
+			BONDING_MODE_BALANCE, 0, TEST_BAL_RSS_SLAVE_COUNT, 1),
+			"Failed to initialize_bonded_device_with_slaves.");
+
+	TEST_ASSERT_SUCCESS(rte_eth_bond_xmit_policy_set(
+			test_params->bonded_port_id, BALANCE_XMIT_POLICY_RSS),
+			"Failed to set balance xmit policy.");
+
+	/* Identical headers, the flows only differ by their RSS hash */
+	TEST_ASSERT_EQUAL(generate_test_burst(pkts_burst,
+			TEST_BAL_RSS_BURST_SIZE, 0, 1, 0, 0, 0),
+			TEST_BAL_RSS_BURST_SIZE, "failed to generate packet burst");
+
+	for (i = 0; i < TEST_BAL_RSS_BURST_SIZE; i++) {
+		hash = (i % TEST_BAL_RSS_FLOW_COUNT) * 0x9e3779b9 + 1;
+		pkts_burst[i]->hash.rss = hash;
+		pkts_burst[i]->ol_flags |= PKT_RX_RSS_HASH;
+		expected[balance_rss_slave(hash, TEST_BAL_RSS_SLAVE_COUNT)]++;
+	}
+
+	nb_tx = rte_eth_tx_burst(test_params->bonded_port_id, 0, pkts_burst,
+			TEST_BAL_RSS_BURST_SIZE);
+	TEST_ASSERT_EQUAL(nb_tx, TEST_BAL_RSS_BURST_SIZE, "tx burst failed");
+
+	/* Each flow stays on one slave, and the flows use every slave */
+	for (i = 0; i < TEST_BAL_RSS_SLAVE_COUNT; i++) {
+		rte_eth_stats_get(test_params->slave_port_ids[i], &port_stats);
+		TEST_ASSERT_EQUAL(port_stats.opackets, (uint64_t)expected[i],
+				"Slave Port (%d) opackets value (%u) not as "
+				"expected (%u)", test_params->slave_port_ids[i],
+				(unsigned int)port_stats.opackets, expected[i]);
+		used += expected[i] != 0;
+	}
+	TEST_ASSERT_EQUAL(used, TEST_BAL_RSS_SLAVE_COUNT,
+			"Flows spread over %u slaves out of %u", used,
+			TEST_BAL_RSS_SLAVE_COUNT);
+
+	/* Clean up and remove slaves from bonded device */
+	return remove_slaves_and_stop_bonded_device();
+}
+
 #define TEST_BAL_SLAVE_TX_FAIL_SLAVE_COUNT			(2)
 #define TEST_BAL_SLAVE_TX_FAIL_BURST_SIZE_1			(40)
 #define TEST_BAL_SLAVE_TX_FAIL_BURST_SIZE_2			(20)
@@ -5116,6 +5183,7 @@ static struct unit_test_suite link_bonding_test_suite  = {
 		TEST_CASE(test_balance_l34_tx_burst_ipv6_toggle_ip_addr),
 		TEST_CASE(test_balance_l34_tx_burst_vlan_ipv6_toggle_ip_addr),
 		TEST_CASE(test_balance_l34_tx_burst_ipv6_toggle_udp_port),
+		TEST_CASE(test_balance_rss_tx_burst),
 		TEST_CASE(test_balance_tx_burst_slave_tx_fail),
 		TEST_CASE(test_balance_rx_burst),
 		TEST_CASE(test_balance_verify_promiscuous_enable_disable),
@@ -12,12 +12,14 @@
 
 #include <rte_common.h>
 #include <rte_memory.h>
+#include <rte_memzone.h>
 #include <rte_per_lcore.h>
 #include <rte_launch.h>
 #include <rte_eal.h>
 #include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_cycles.h>
+#include <rte_errno.h>
 #include <rte_random.h>
 #include <rte_string_fns.h>
 
@@ -371,6 +373,232 @@ test_multi_alloc_statistics(void)
 	return 0;
 }
 
+#define LCORE_CACHE_TEST_BLOCKS 256
+
+static int
+test_lcore_cache_per_lcore(__attribute__((unused)) void *arg)
+{
+	void *blocks[LCORE_CACHE_TEST_BLOCKS];
+	size_t sizes[LCORE_CACHE_TEST_BLOCKS];
+	const uint8_t pattern = rte_lcore_id();
+	unsigned int i, j, round;
+	int ret = 0;
+
+	for (round = 0; round < 100 && ret == 0; round++) {
+		for (i = 0; i < LCORE_CACHE_TEST_BLOCKS; i++) {
+			sizes[i] = 1 + rte_rand() % 2048;
+			blocks[i] = rte_malloc(NULL, sizes[i], 0);
+			if (blocks[i] == NULL) {
+				printf("rte_malloc returned NULL (i=%u)\n", i);
+				ret = -1;
+				break;
+			}
+			memset(blocks[i], pattern, sizes[i]);
+		}
+		/* no block can have been handed out twice */
+		for (j = 0; j < i && ret == 0; j++) {
+			const uint8_t *data = blocks[j];
+			size_t k;
+
+			for (k = 0; k < sizes[j]; k++) {
+				if (data[k] != pattern) {
+					printf("Block %u was overwritten\n", j);
+					ret = -1;
+					break;
+				}
+			}
+		}
+		while (i-- > 0)
+			rte_free(blocks[i]);
+	}
+
+	rte_malloc_lcore_cache_flush();
+	return ret;
+}
+
+static int
+test_lcore_cache(void)
+{
+	struct rte_malloc_socket_stats pre_stats, post_stats;
+	struct rte_malloc_socket_frag_stats frag_stats;
+	void *blocks[2 * RTE_MALLOC_LCORE_CACHE_SIZE];
+	int socket = rte_socket_id() == (unsigned int)SOCKET_ID_ANY ?
+			0 : (int)rte_socket_id();
+	const struct rte_memzone *mz;
+	unsigned int alloc_count, lcore_id, i;
+	uint8_t *p1, *p2, *p3;
+	int ret = 0;
+
+	if (rte_malloc_lcore_cache_enable(1) < 0) {
+		if (rte_errno == ENOTSUP) {
+			printf("lcore caches not available, skipping\n");
+			return 0;
+		}
+		return -1;
+	}
+
+	rte_malloc_get_socket_stats(socket, &pre_stats);
+	alloc_count = pre_stats.alloc_count;
+
+	/* a freed block is handed out again without going to the heap */
+	p1 = rte_malloc(NULL, 100, 0);
+	if (p1 == NULL) {
+		printf("rte_malloc returned NULL\n");
+		goto fail;
+	}
+	memset(p1, 0xa5, 100);
+	rte_malloc_get_socket_stats(socket, &pre_stats);
+	rte_free(p1);
+	p2 = rte_zmalloc(NULL, 100, 0);
+	rte_malloc_get_socket_stats(socket, &post_stats);
+	if (p2 != p1) {
+		printf("Freed block not reused from the lcore cache\n");
+		goto fail;
+	}
+	if (post_stats.alloc_count != pre_stats.alloc_count) {
+		printf("Cached block was returned to the heap\n");
+		goto fail;
+	}
+	for (i = 0; i < 100; i++) {
+		if (p2[i] != 0) {
+			printf("rte_zmalloc didn't zero the cached block\n");
+			rte_free(p2);
+			goto fail;
+		}
+	}
+	rte_free(p2);
+
+	/* a block freed twice is only cached once */
+	p1 = rte_malloc(NULL, 100, 0);
+	if (p1 == NULL) {
+		printf("rte_malloc returned NULL\n");
+		goto fail;
+	}
+	rte_free(p1);
+	rte_free(p1);
+	p2 = rte_malloc(NULL, 100, 0);
+	p3 = rte_malloc(NULL, 100, 0);
+	rte_free(p2);
+	rte_free(p3);
+	if (p2 == NULL || p2 == p3) {
+		printf("Block freed twice was handed out twice\n");
+		goto fail;
+	}
+
+	/* memzones are freed to the heap, not to the lcore cache */
+	rte_malloc_get_socket_stats(socket, &pre_stats);
+	mz = rte_memzone_reserve("lcore_cache_mz", RTE_CACHE_LINE_SIZE,
+			socket, 0);
+	if (mz == NULL) {
+		printf("Cannot reserve memzone\n");
+		goto fail;
+	}
+	rte_memzone_free(mz);
+	rte_malloc_get_socket_stats(socket, &post_stats);
+	if (post_stats.alloc_count != pre_stats.alloc_count) {
+		printf("Memzone memory was kept in the lcore cache\n");
+		goto fail;
+	}
+
+	rte_malloc_get_socket_frag_stats(socket, &frag_stats);
+	if (frag_stats.cached_count == 0 ||
+			frag_stats.cached_bytes != 128 * frag_stats.cached_count) {
+		printf("Cached blocks not accounted\n");
+		goto fail;
+	}
+
+	/* a cache never holds more than its size */
+	rte_malloc_lcore_cache_flush();
+	for (i = 0; i < RTE_DIM(blocks); i++) {
+		blocks[i] = rte_malloc(NULL, RTE_CACHE_LINE_SIZE, 0);
+		if (blocks[i] == NULL) {
+			printf("rte_malloc returned NULL (i=%u)\n", i);
+			while (i-- > 0)
+				rte_free(blocks[i]);
+			goto fail;
+		}
+	}
+	for (i = 0; i < RTE_DIM(blocks); i++)
+		rte_free(blocks[i]);
+	rte_malloc_get_socket_stats(socket, &post_stats);
+	rte_malloc_get_socket_frag_stats(socket, &frag_stats);
+	if (frag_stats.cached_count > RTE_MALLOC_LCORE_CACHE_SIZE ||
+			post_stats.alloc_count - alloc_count !=
+				frag_stats.cached_count) {
+		printf("Incorrect lcore cache size: %u blocks cached\n",
+				frag_stats.cached_count);
+		goto fail;
+	}
+
+	/* all lcores allocate and free concurrently */
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		rte_eal_remote_launch(test_lcore_cache_per_lcore, NULL,
+				lcore_id);
+	}
+	if (test_lcore_cache_per_lcore(NULL) < 0)
+		ret = -1;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			ret = -1;
+	}
+	if (ret < 0)
+		goto fail;
+
+	/* once flushed, the heap is back to its original state */
+	rte_malloc_get_socket_stats(socket, &post_stats);
+	if (post_stats.alloc_count != alloc_count) {
+		printf("Blocks still held after lcore cache flush\n");
+		goto fail;
+	}
+
+	rte_malloc_lcore_cache_enable(0);
+	return 0;
+
+fail:
+	rte_malloc_lcore_cache_flush();
+	rte_malloc_lcore_cache_enable(0);
+	return -1;
+}
+
+static int
+test_frag_stats(void)
+{
+	struct rte_malloc_socket_stats stats;
+	struct rte_malloc_socket_frag_stats frag_stats;
+	unsigned int i, count = 0;
+	int socket = 0;
+
+	if (rte_malloc_get_socket_frag_stats(-2, &frag_stats) != -1) {
+		printf("Invalid socket accepted\n");
+		return -1;
+	}
+
+	rte_malloc_get_socket_stats(socket, &stats);
+	rte_malloc_get_socket_frag_stats(socket, &frag_stats);
+
+	if (frag_stats.free_count != stats.free_count ||
+			frag_stats.heap_freesz_bytes != stats.heap_freesz_bytes ||
+			frag_stats.greatest_free_size !=
+				stats.greatest_free_size) {
+		printf("Fragmentation statistics don't match heap statistics\n");
+		return -1;
+	}
+	for (i = 0; i < RTE_MALLOC_FRAG_HIST_BUCKETS; i++)
+		count += frag_stats.free_hist[i];
+	if (count != frag_stats.free_count) {
+		printf("Free block histogram doesn't match free count\n");
+		return -1;
+	}
+	if (frag_stats.fragmentation > 100 ||
+			(frag_stats.free_count == 1 &&
+			 frag_stats.fragmentation != 0)) {
+		printf("Incorrect fragmentation: %u%%\n",
+				frag_stats.fragmentation);
+		return -1;
+	}
+	return 0;
+}
+
 static int
 test_realloc(void)
 {
@@ -962,6 +1190,20 @@ test_malloc(void)
 	else
 		printf("test_multi_alloc_statistics() passed\n");
 
+	ret = test_frag_stats();
+	if (ret < 0) {
+		printf("test_frag_stats() failed\n");
+		return ret;
+	}
+	printf("test_frag_stats() passed\n");
+
+	ret = test_lcore_cache();
+	if (ret < 0) {
+		printf("test_lcore_cache() failed\n");
+		return ret;
+	}
+	printf("test_lcore_cache() passed\n");
+
 	return 0;
 }
 
@@ -1869,6 +1869,69 @@ test_pktmbuf_alloc_bulk(struct rte_mempool *pktmbuf_pool)
 	return 0;
 }
 
+/*
+ * Test that a bulk of mbufs is reset like rte_pktmbuf_reset() does, whatever
+ * the state they were freed in, and that it can be fast freed.
+ */
+static int
+test_pktmbuf_alloc_bulk_reset(struct rte_mempool *pktmbuf_pool)
+{
+	struct rte_mbuf *mbufs[MEMPOOL_CACHE_SIZE];
+	unsigned int avail, idx, round;
+	struct rte_mbuf *m;
+	int ret;
+
+	avail = rte_mempool_avail_count(pktmbuf_pool);
+
+	for (round = 0; round < 2; round++) {
+		ret = rte_pktmbuf_alloc_bulk(pktmbuf_pool, mbufs,
+				RTE_DIM(mbufs));
+		if (ret != 0) {
+			printf("%s: Bulk alloc failed; ret val(%d)\n",
+					__func__, ret);
+			return -1;
+		}
+
+		for (idx = 0; idx < RTE_DIM(mbufs); idx++) {
+			m = mbufs[idx];
+			if (m->data_off != RTE_MIN((uint16_t)RTE_PKTMBUF_HEADROOM,
+						m->buf_len) ||
+					rte_mbuf_refcnt_read(m) != 1 ||
+					m->nb_segs != 1 || m->next != NULL ||
+					m->port != MBUF_INVALID_PORT ||
+					m->ol_flags != 0 || m->packet_type != 0 ||
+					m->pkt_len != 0 || m->data_len != 0 ||
+					m->vlan_tci != 0 ||
+					m->vlan_tci_outer != 0 ||
+					m->tx_offload != 0) {
+				printf("%s: mbuf %u not reset\n",
+						__func__, idx);
+				rte_pktmbuf_fast_free_bulk(mbufs,
+						RTE_DIM(mbufs));
+				return -1;
+			}
+
+			/* dirty the mbuf as a received packet would */
+			m->data_off = 0;
+			m->port = 1;
+			m->ol_flags = PKT_RX_RSS_HASH | PKT_RX_VLAN;
+			m->packet_type = RTE_PTYPE_L2_ETHER;
+			m->pkt_len = m->data_len = 60;
+			m->vlan_tci = m->vlan_tci_outer = 1;
+			m->hash.rss = 0xdeadbeef;
+			m->l2_len = sizeof(struct rte_ether_hdr);
+		}
+
+		rte_pktmbuf_fast_free_bulk(mbufs, RTE_DIM(mbufs));
+		if (rte_mempool_avail_count(pktmbuf_pool) != avail) {
+			printf("%s: mbufs not returned to the pool\n",
+					__func__);
+			return -1;
+		}
+	}
+	return 0;
+}
+
 /*
  * Negative testing for allocating a bulk of mbufs
  */
@@ -2411,6 +2474,106 @@ test_pktmbuf_ext_shinfo_init_helper(struct rte_mempool *pktmbuf_pool)
 	return -1;
 }
 
+/*
+ * Test the pool with pinned external data buffers
+ *  - Allocate external memory and create the pinned pool on top of it.
+ *  - Allocate mbuf, check the data buffer is located in external memory.
+ *  - Clone the mbuf, free the original one and check it is kept out of
+ *    the pool while the clone references its buffer.
+ *  - Free the clone and check the pinned mbuf returned to the pool.
+ */
+static int
+test_pktmbuf_ext_pinned_buffer(struct rte_mempool *pktmbuf_pool)
+{
+	struct rte_mempool *pinned_pool = NULL;
+	struct rte_pktmbuf_extmem ext_mem;
+	struct rte_mbuf *m = NULL;
+	struct rte_mbuf *clone = NULL;
+	unsigned int avail;
+
+	ext_mem.elt_size = RTE_MBUF_DEFAULT_BUF_SIZE;
+	ext_mem.buf_len = RTE_ALIGN_CEIL(NB_MBUF * ext_mem.elt_size,
+					 RTE_CACHE_LINE_SIZE);
+	ext_mem.buf_ptr = rte_malloc("test_extbuf", ext_mem.buf_len,
+				     RTE_CACHE_LINE_SIZE);
+	if (ext_mem.buf_ptr == NULL)
+		GOTO_FAIL("%s: External buffer allocation failed\n", __func__);
+	ext_mem.buf_iova = rte_malloc_virt2iova(ext_mem.buf_ptr);
+
+	/* not enough external memory for the requested mbufs */
+	pinned_pool = rte_pktmbuf_pool_create_extbuf("test_pinned_pool",
+			NB_MBUF + 1, 0, 0, ext_mem.elt_size,
+			SOCKET_ID_ANY, &ext_mem, 1);
+	if (pinned_pool != NULL)
+		GOTO_FAIL("%s: Pool creation should fail\n", __func__);
+
+	pinned_pool = rte_pktmbuf_pool_create_extbuf("test_pinned_pool",
+			NB_MBUF, 0, 0, ext_mem.elt_size,
+			SOCKET_ID_ANY, &ext_mem, 1);
+	if (pinned_pool == NULL)
+		GOTO_FAIL("%s: Pinned pool creation failed\n", __func__);
+	if (!(rte_pktmbuf_priv_flags(pinned_pool) &
+	      RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF))
+		GOTO_FAIL("%s: Pinned pool flag is not set\n", __func__);
+
+	m = rte_pktmbuf_alloc(pinned_pool);
+	if (m == NULL)
+		GOTO_FAIL("%s: mbuf allocation failed!\n", __func__);
+	if (m->ol_flags != EXT_ATTACHED_MBUF || !RTE_MBUF_HAS_PINNED_EXTBUF(m))
+		GOTO_FAIL("%s: mbuf is not pinned\n", __func__);
+	if ((char *)m->buf_addr < (char *)ext_mem.buf_ptr ||
+	    (char *)m->buf_addr + m->buf_len >
+	    (char *)ext_mem.buf_ptr + ext_mem.buf_len)
+		GOTO_FAIL("%s: Data buffer is not in external memory\n",
+			  __func__);
+	if (rte_pktmbuf_append(m, MBUF_TEST_DATA_LEN) == NULL)
+		GOTO_FAIL("%s: Cannot append data\n", __func__);
+
+	clone = rte_pktmbuf_clone(m, pktmbuf_pool);
+	if (clone == NULL)
+		GOTO_FAIL("%s: mbuf clone allocation failed!\n", __func__);
+	if (clone->buf_addr != m->buf_addr ||
+	    rte_mbuf_ext_refcnt_read(m->shinfo) != 2)
+		GOTO_FAIL("%s: Clone is not attached to pinned buffer\n",
+			  __func__);
+
+	/* the pinned mbuf is still referenced by the clone */
+	avail = rte_mempool_avail_count(pinned_pool);
+	rte_pktmbuf_free(m);
+	m = NULL;
+	if (rte_mempool_avail_count(pinned_pool) != avail)
+		GOTO_FAIL("%s: Referenced pinned mbuf was freed\n", __func__);
+
+	/* the last detach returns the pinned mbuf to its pool */
+	rte_pktmbuf_free(clone);
+	clone = NULL;
+	if (rte_mempool_avail_count(pinned_pool) != avail + 1)
+		GOTO_FAIL("%s: Pinned mbuf was not freed\n", __func__);
+
+	m = rte_pktmbuf_alloc(pinned_pool);
+	if (m == NULL)
+		GOTO_FAIL("%s: mbuf allocation failed!\n", __func__);
+	if (m->ol_flags != EXT_ATTACHED_MBUF ||
+	    rte_mbuf_ext_refcnt_read(m->shinfo) != 1)
+		GOTO_FAIL("%s: Pinned mbuf is not reset\n", __func__);
+	rte_pktmbuf_free(m);
+	m = NULL;
+
+	if (rte_mempool_avail_count(pinned_pool) != NB_MBUF)
+		GOTO_FAIL("%s: Pinned mbufs leaked\n", __func__);
+
+	rte_mempool_free(pinned_pool);
+	rte_free(ext_mem.buf_ptr);
+	return 0;
+
+fail:
+	rte_pktmbuf_free(clone);
+	rte_pktmbuf_free(m);
+	rte_mempool_free(pinned_pool);
+	rte_free(ext_mem.buf_ptr);
+	return -1;
+}
+
 static int
 test_mbuf_dyn(struct rte_mempool *pktmbuf_pool)
 {
@@ -2701,6 +2864,12 @@ test_mbuf(void)
 		goto err;
 	}
 
+	/* test for resetting a bulk of mbufs, and freeing it fast */
+	if (test_pktmbuf_alloc_bulk_reset(pktmbuf_pool) < 0) {
+		printf("test_pktmbuf_alloc_bulk_reset() failed\n");
+		goto err;
+	}
+
 	/* test for allocating a bulk of mbufs with various sizes */
 	if (test_neg_pktmbuf_alloc_bulk(pktmbuf_pool) < 0) {
 		printf("test_neg_rte_pktmbuf_alloc_bulk() failed\n");
@@ -2731,6 +2900,12 @@ test_mbuf(void)
 		goto err;
 	}
 
+	/* test the pool with pinned external data buffers */
+	if (test_pktmbuf_ext_pinned_buffer(pktmbuf_pool) < 0) {
+		printf("test_pktmbuf_ext_pinned_buffer() failed\n");
+		goto err;
+	}
+
 	ret = 0;
 err:
 	rte_mempool_free(pktmbuf_pool);
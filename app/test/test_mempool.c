@@ -208,6 +208,89 @@ static int test_mempool_creation_with_exceeded_cache_size(void)
 	return 0;
 }
 
+#define CACHE_ADAPT_SIZE 64
+#define CACHE_ADAPT_MIN 4
+#define CACHE_ADAPT_LOOPS 8192
+
+/*
+ * Check the per-lcore cache statistics and the adaptive cache sizing:
+ * the cache shrinks down to its lower bound when it is not accessing
+ * the pool, and grows back when requests cannot be served by the cache.
+ */
+static int
+test_mempool_cache_adaptive(void)
+{
+	struct rte_mempool_cache_stats stats;
+	struct rte_mempool *mp;
+	void *objs[CACHE_ADAPT_SIZE];
+	unsigned int lcore_id = rte_lcore_id();
+	uint32_t size;
+	unsigned int i;
+	int ret = 0;
+
+	mp = rte_mempool_create("test_cache_adaptive", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, CACHE_ADAPT_SIZE, 0,
+		NULL, NULL, my_obj_init, NULL, SOCKET_ID_ANY, 0);
+	if (mp == NULL)
+		RET_ERR();
+
+	/* first get refills the cache, the next ones are hits */
+	if (rte_mempool_get(mp, &objs[0]) < 0)
+		GOTO_ERR(ret, out);
+	rte_mempool_put(mp, objs[0]);
+	if (rte_mempool_get(mp, &objs[0]) < 0)
+		GOTO_ERR(ret, out);
+	rte_mempool_put(mp, objs[0]);
+	if (rte_mempool_cache_stats_get(mp, lcore_id, &stats, &size) < 0)
+		GOTO_ERR(ret, out);
+	if (stats.get_miss != 1 || stats.get_hit != 1 ||
+	    stats.put_hit != 2 || stats.put_flush != 0 || stats.resize != 0)
+		GOTO_ERR(ret, out);
+	if (size != CACHE_ADAPT_SIZE)
+		GOTO_ERR(ret, out);
+
+	if (rte_mempool_cache_adaptive_set(mp, CACHE_ADAPT_SIZE + 1) == 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_cache_adaptive_set(mp, CACHE_ADAPT_MIN) < 0)
+		GOTO_ERR(ret, out);
+
+	/* served by the cache only: shrink down to the lower bound */
+	for (i = 0; i < CACHE_ADAPT_LOOPS; i++) {
+		if (rte_mempool_get(mp, &objs[0]) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put(mp, objs[0]);
+	}
+	if (rte_mempool_cache_stats_get(mp, lcore_id, NULL, &size) < 0)
+		GOTO_ERR(ret, out);
+	if (size != CACHE_ADAPT_MIN || mp->local_cache[lcore_id].len > size)
+		GOTO_ERR(ret, out);
+
+	/* bulks larger than the cache: grow enough to serve them */
+	for (i = 0; i < CACHE_ADAPT_LOOPS; i++) {
+		if (rte_mempool_get_bulk(mp, objs, CACHE_ADAPT_SIZE / 2) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put_bulk(mp, objs, CACHE_ADAPT_SIZE / 2);
+	}
+	if (rte_mempool_cache_stats_get(mp, lcore_id, &stats, &size) < 0)
+		GOTO_ERR(ret, out);
+	if (size < CACHE_ADAPT_SIZE / 2 || stats.resize == 0 ||
+	    stats.get_miss <= 1)
+		GOTO_ERR(ret, out);
+
+	/* disabling restores the creation size */
+	if (rte_mempool_cache_adaptive_set(mp, 0) < 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_cache_stats_get(mp, lcore_id, NULL, &size) < 0 ||
+	    size != CACHE_ADAPT_SIZE)
+		GOTO_ERR(ret, out);
+
+	rte_mempool_dump(stdout, mp);
+
+out:
+	rte_mempool_free(mp);
+	return ret;
+}
+
 static struct rte_mempool *mp_spsc;
 static rte_spinlock_t scsp_spinlock;
 static void *scsp_obj_table[MAX_KEEP];
@@ -643,6 +726,10 @@ test_mempool(void)
 	if (test_mempool_same_name_twice_creation() < 0)
 		GOTO_ERR(ret, err);
 
+	/* per-lcore cache statistics and adaptive sizing */
+	if (test_mempool_cache_adaptive() < 0)
+		GOTO_ERR(ret, err);
+
 	/* test the stack handler */
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		GOTO_ERR(ret, err);
@@ -7,6 +7,7 @@
 #include <string.h>
 #include <inttypes.h>
 #include <sys/queue.h>
+#include <sys/mman.h>
 
 #include <rte_random.h>
 #include <rte_cycles.h>
@@ -928,6 +929,125 @@ test_memzone_free(void)
 	return 0;
 }
 
+static int
+test_memzone_persistent(void)
+{
+	const char *name = TEST_MEMZONE_NAME("persist");
+	const struct rte_memzone *mz;
+	const size_t len = 100000;
+	uint32_t *data;
+	void *addr;
+	unsigned int i;
+	int state;
+
+	rte_memzone_persist_remove(name);
+
+	mz = rte_memzone_reserve_persistent(name, len, SOCKET_ID_ANY, 0, 1,
+			&state);
+	if (mz == NULL && rte_errno == ENOTSUP) {
+		printf("Persistent memzones not supported, skipping\n");
+		return 0;
+	}
+	if (mz == NULL || state != RTE_MEMZONE_PERSIST_CREATED ||
+			(mz->flags & RTE_MEMZONE_PERSISTENT) == 0 ||
+			mz->len != len) {
+		printf("Fail to create persistent memzone\n");
+		return -1;
+	}
+	if (rte_memzone_lookup(name) != mz) {
+		printf("Persistent memzone not found\n");
+		return -1;
+	}
+	if (rte_memzone_reserve_persistent(name, len, SOCKET_ID_ANY, 0, 1,
+			&state) != NULL ||
+			rte_errno != EEXIST) {
+		printf("Persistent memzone reserved twice\n");
+		return -1;
+	}
+
+	/* fill, commit and reattach: same address and content */
+	data = mz->addr;
+	for (i = 0; i < len / sizeof(*data); i++)
+		data[i] = i;
+	addr = mz->addr;
+	if (rte_memzone_persist_commit(mz) || rte_memzone_free(mz)) {
+		printf("Fail to commit persistent memzone\n");
+		return -1;
+	}
+	mz = rte_memzone_reserve_persistent(name, len, SOCKET_ID_ANY, 0, 1,
+			&state);
+	if (mz == NULL || state != RTE_MEMZONE_PERSIST_ATTACHED ||
+			mz->addr != addr) {
+		printf("Fail to reattach persistent memzone\n");
+		return -1;
+	}
+	data = mz->addr;
+	for (i = 0; i < len / sizeof(*data); i++) {
+		if (data[i] != i) {
+			printf("Wrong content in reattached memzone\n");
+			return -1;
+		}
+	}
+
+	/* uncommitted content is discarded */
+	rte_memzone_free(mz);
+	mz = rte_memzone_reserve_persistent(name, len, SOCKET_ID_ANY, 0, 1,
+			&state);
+	if (mz == NULL || state != RTE_MEMZONE_PERSIST_CREATED ||
+			((uint32_t *)mz->addr)[1] != 0) {
+		printf("Uncommitted persistent memzone reattached\n");
+		return -1;
+	}
+
+	/* content of another version is discarded */
+	rte_memzone_persist_commit(mz);
+	rte_memzone_free(mz);
+	mz = rte_memzone_reserve_persistent(name, len, SOCKET_ID_ANY, 0, 2,
+			&state);
+	if (mz == NULL || state != RTE_MEMZONE_PERSIST_CREATED) {
+		printf("Persistent memzone of another version reattached\n");
+		return -1;
+	}
+	if (mz->socket_id != SOCKET_ID_ANY) {
+		printf("Wrong socket for persistent memzone\n");
+		return -1;
+	}
+
+	/* content whose address is taken is recreated elsewhere */
+	rte_memzone_persist_commit(mz);
+	addr = mz->addr;
+	rte_memzone_free(mz);
+	if (mmap(addr, len, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+			-1, 0) == MAP_FAILED) {
+		printf("Cannot map over persistent memzone address\n");
+		return -1;
+	}
+	mz = rte_memzone_reserve_persistent(name, len, SOCKET_ID_ANY, 0, 2,
+			&state);
+	munmap(addr, len);
+	if (mz == NULL || state != RTE_MEMZONE_PERSIST_CREATED ||
+			mz->addr == addr) {
+		printf("Persistent memzone not recreated at a free address\n");
+		return -1;
+	}
+	rte_memzone_free(mz);
+
+	if (rte_memzone_reserve_persistent(name, len, RTE_MAX_NUMA_NODES, 0,
+			2, &state) != NULL || rte_errno != EINVAL) {
+		printf("Persistent memzone reserved on invalid socket\n");
+		return -1;
+	}
+
+	if (rte_memzone_persist_commit(NULL) != -EINVAL ||
+			rte_memzone_persist_remove(name) != 0 ||
+			rte_memzone_persist_remove(name) != -ENOENT) {
+		printf("Fail to remove persistent memzone\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 static int test_memzones_left;
 static int memzone_walk_cnt;
 static void memzone_walk_clb(const struct rte_memzone *mz,
@@ -1085,6 +1205,10 @@ test_memzone(void)
 	if (test_memzone_free() < 0)
 		return -1;
 
+	printf("test persistent memzone\n");
+	if (test_memzone_persistent() < 0)
+		return -1;
+
 	printf("test reserving memzone with bigger size than the maximum\n");
 	if (test_memzone_reserving_zone_size_bigger_than_the_maximum() < 0)
 		return -1;
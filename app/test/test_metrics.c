@@ -3,11 +3,13 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <errno.h>
 
 #include <rte_lcore.h>
+#include <rte_launch.h>
 #include <rte_metrics.h>
 
 #include "test.h"
@@ -271,6 +273,124 @@ test_metrics_get_values(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_metrics_lcore_worker(void *arg)
+{
+	const uint16_t *keys = arg;
+	unsigned int i;
+
+	for (i = 0; i < 1000; i++) {
+		if (rte_metrics_lcore_add(keys[0], 2) < 0)
+			return -1;
+		if (rte_metrics_lcore_hist_add(keys[1], i) < 0)
+			return -1;
+	}
+	return 0;
+}
+
+/* Test case to validate per-lcore counters and histograms */
+static int
+test_metrics_lcore(void)
+{
+	struct rte_metric_histogram hist;
+	struct rte_metric_value *values;
+	unsigned int lcore_id, nb_lcores = 1;
+	uint16_t keys[2];
+	uint64_t sum;
+	unsigned int i;
+	int err, len;
+
+	/* Failure Test: invalid name and type */
+	err = rte_metrics_reg_lcore_metric(NULL,
+			RTE_METRICS_TYPE_LCORE_COUNTER);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_reg_lcore_metric("pkts", RTE_METRICS_TYPE_VALUE);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+
+	err = rte_metrics_reg_lcore_metric("pkts",
+			RTE_METRICS_TYPE_LCORE_COUNTER);
+	TEST_ASSERT(err >= 0, "%s, %d", __func__, __LINE__);
+	keys[0] = err;
+	err = rte_metrics_reg_lcore_metric("delay",
+			RTE_METRICS_TYPE_LCORE_HISTOGRAM);
+	TEST_ASSERT(err >= 0, "%s, %d", __func__, __LINE__);
+	keys[1] = err;
+
+	/* Failure Test: update of the wrong metric type */
+	err = rte_metrics_lcore_add(keys[1], 1);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_lcore_hist_add(keys[0], 1);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_lcore_add(0, 1);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_get_histogram(keys[0], &hist);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_get_histogram(keys[1], NULL);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+
+	/* Successful Test: concurrent updates from all lcores */
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		rte_eal_remote_launch(test_metrics_lcore_worker, keys,
+				lcore_id);
+		nb_lcores++;
+	}
+	err = test_metrics_lcore_worker(keys);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		err = rte_eal_wait_lcore(lcore_id);
+		TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+	}
+
+	len = rte_metrics_get_values(RTE_METRICS_GLOBAL, NULL, 0);
+	TEST_ASSERT(len > keys[1], "%s, %d", __func__, __LINE__);
+	values = calloc(len, sizeof(*values));
+	TEST_ASSERT(values != NULL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_get_values(RTE_METRICS_GLOBAL, values, len);
+	TEST_ASSERT(err == len, "%s, %d", __func__, __LINE__);
+	TEST_ASSERT(values[keys[0]].value == 2000ULL * nb_lcores,
+			"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(values[keys[1]].value == 1000ULL * nb_lcores,
+			"%s, %d", __func__, __LINE__);
+	free(values);
+
+	err = rte_metrics_get_histogram(keys[1], &hist);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+	TEST_ASSERT(hist.count == 1000ULL * nb_lcores,
+			"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(hist.sum == 999ULL * 1000 / 2 * nb_lcores,
+			"%s, %d", __func__, __LINE__);
+	/* Samples 0..999: one zero, then 2^(n-1) samples in bucket n */
+	TEST_ASSERT(hist.buckets[0] == nb_lcores, "%s, %d", __func__, __LINE__);
+	TEST_ASSERT(hist.buckets[1] == nb_lcores, "%s, %d", __func__, __LINE__);
+	TEST_ASSERT(hist.buckets[9] == 256ULL * nb_lcores,
+			"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(hist.buckets[10] == 488ULL * nb_lcores,
+			"%s, %d", __func__, __LINE__);
+	for (sum = 0, i = 0; i < RTE_METRICS_HIST_BUCKETS; i++)
+		sum += hist.buckets[i];
+	TEST_ASSERT(sum == hist.count, "%s, %d", __func__, __LINE__);
+
+	/* Successful Test: unregister, then register again with same key */
+	err = rte_metrics_unreg_lcore_metric(keys[1]);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_lcore_hist_add(keys[1], 1);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_unreg_lcore_metric(keys[1]);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_reg_lcore_metric("delay",
+			RTE_METRICS_TYPE_LCORE_HISTOGRAM);
+	TEST_ASSERT(err == keys[1], "%s, %d", __func__, __LINE__);
+	err = rte_metrics_get_histogram(keys[1], &hist);
+	TEST_ASSERT(err == 0 && hist.count == 0,
+			"%s, %d", __func__, __LINE__);
+
+	/* Failure Test: only per-lcore metrics can be unregistered */
+	err = rte_metrics_unreg_lcore_metric(0);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite metrics_testsuite  = {
 	.suite_name = "Metrics Unit Test Suite",
 	.setup = NULL,
@@ -313,7 +433,12 @@ static struct unit_test_suite metrics_testsuite  = {
 		 */
 		TEST_CASE(test_metrics_get_values),
 
-		/* TEST CASE 8: Test to unregister metrics*/
+		/* TEST CASE 8: Test to update per-lcore counters and
+		 * histograms from all lcores and aggregate them
+		 */
+		TEST_CASE(test_metrics_lcore),
+
+		/* TEST CASE 9: Test to unregister metrics*/
 		TEST_CASE(test_metrics_deinitialize),
 
 		TEST_CASES_END()
@@ -0,0 +1,280 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_cycles.h>
+#include <rte_pcapng.h>
+
+#include "test.h"
+
+/*
+ * Write packets with librte_pcapng and check that the file is made of
+ * well formed pcapng blocks holding the expected packets.
+ */
+
+#define PCAPNG_TEST_NB_PKTS	64
+#define PCAPNG_TEST_PKT_LEN	128
+#define PCAPNG_TEST_SNAPLEN	61	/* not a multiple of 4: padded */
+#define PCAPNG_TEST_PORT	0
+#define PCAPNG_TEST_QUEUE	1
+
+/* block types and byte order magic from the pcapng specification */
+#define PCAPNG_SECTION_BLOCK	0x0A0D0D0A
+#define PCAPNG_INTERFACE_BLOCK	1
+#define PCAPNG_STATS_BLOCK	5
+#define PCAPNG_PACKET_BLOCK	6
+#define PCAPNG_BYTE_ORDER_MAGIC	0x1A2B3C4D
+
+struct pcapng_test_epb {
+	uint32_t block_type;
+	uint32_t block_length;
+	uint32_t interface_id;
+	uint32_t timestamp_hi;
+	uint32_t timestamp_lo;
+	uint32_t capture_length;
+	uint32_t original_length;
+};
+
+static uint8_t
+pcapng_test_byte(uint32_t pkt, uint32_t off)
+{
+	return (uint8_t)(pkt * 7 + off);
+}
+
+static int
+pcapng_test_fill(struct rte_mempool *mp, struct rte_mbuf **pkts)
+{
+	uint32_t i, j;
+	uint8_t *data;
+
+	if (rte_pktmbuf_alloc_bulk(mp, pkts, PCAPNG_TEST_NB_PKTS) != 0)
+		return -1;
+
+	for (i = 0; i != PCAPNG_TEST_NB_PKTS; i++) {
+		data = (uint8_t *)rte_pktmbuf_append(pkts[i],
+				PCAPNG_TEST_PKT_LEN);
+		for (j = 0; j != PCAPNG_TEST_PKT_LEN; j++)
+			data[j] = pcapng_test_byte(i, j);
+	}
+
+	return 0;
+}
+
+/* walk the blocks of the file, checking the layout of each of them */
+static int
+pcapng_test_check(const uint8_t *buf, size_t size)
+{
+	const struct pcapng_test_epb *epb;
+	const uint8_t *data;
+	uint32_t type, len, trailer;
+	uint32_t nb_ifaces = 0, nb_pkts = 0, nb_stats = 0;
+	size_t off = 0;
+	uint32_t j;
+
+	while (off < size) {
+		TEST_ASSERT(size - off >= 3 * sizeof(uint32_t),
+			"truncated block at offset %zu", off);
+		memcpy(&type, buf + off, sizeof(type));
+		memcpy(&len, buf + off + sizeof(type), sizeof(len));
+		TEST_ASSERT(len % sizeof(uint32_t) == 0 &&
+			len >= 3 * sizeof(uint32_t) && len <= size - off,
+			"invalid length %u of block at offset %zu", len, off);
+		memcpy(&trailer, buf + off + len - sizeof(trailer),
+			sizeof(trailer));
+		TEST_ASSERT_EQUAL(len, trailer,
+			"block lengths differ at offset %zu", off);
+
+		if (off == 0) {
+			TEST_ASSERT_EQUAL(type, PCAPNG_SECTION_BLOCK,
+				"file does not start with a section header");
+			memcpy(&type, buf + 2 * sizeof(uint32_t),
+				sizeof(type));
+			TEST_ASSERT_EQUAL(type, PCAPNG_BYTE_ORDER_MAGIC,
+				"wrong byte order magic");
+		} else if (type == PCAPNG_INTERFACE_BLOCK) {
+			nb_ifaces++;
+		} else if (type == PCAPNG_PACKET_BLOCK) {
+			epb = (const struct pcapng_test_epb *)(buf + off);
+			TEST_ASSERT(epb->interface_id < nb_ifaces,
+				"packet %u from undescribed interface %u",
+				nb_pkts, epb->interface_id);
+			TEST_ASSERT_EQUAL(epb->capture_length,
+				PCAPNG_TEST_SNAPLEN,
+				"packet %u captured %u bytes", nb_pkts,
+				epb->capture_length);
+			TEST_ASSERT_EQUAL(epb->original_length,
+				PCAPNG_TEST_PKT_LEN,
+				"packet %u original length %u", nb_pkts,
+				epb->original_length);
+			TEST_ASSERT(sizeof(*epb) +
+				RTE_ALIGN(epb->capture_length,
+					sizeof(uint32_t)) < len,
+				"packet %u data overflows its block", nb_pkts);
+
+			data = (const uint8_t *)(epb + 1);
+			for (j = 0; j != epb->capture_length; j++)
+				TEST_ASSERT_EQUAL(data[j],
+					pcapng_test_byte(nb_pkts, j),
+					"packet %u differs at byte %u",
+					nb_pkts, j);
+			nb_pkts++;
+		} else if (type == PCAPNG_STATS_BLOCK) {
+			nb_stats++;
+		} else {
+			TEST_ASSERT(0, "unexpected block type %#x", type);
+		}
+
+		off += len;
+	}
+
+	TEST_ASSERT(nb_ifaces > 0, "no interface description");
+	TEST_ASSERT_EQUAL(nb_pkts, PCAPNG_TEST_NB_PKTS,
+		"%u packets in file, expected %u", nb_pkts,
+		PCAPNG_TEST_NB_PKTS);
+	TEST_ASSERT_EQUAL(nb_stats, 1, "%u statistics blocks", nb_stats);
+
+	return TEST_SUCCESS;
+}
+
+static int
+pcapng_test_read(const char *name)
+{
+	struct stat st;
+	uint8_t *buf;
+	ssize_t n;
+	int fd, ret;
+
+	fd = open(name, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) < 0) {
+		printf("can not read %s\n", name);
+		if (fd >= 0)
+			close(fd);
+		return TEST_FAILED;
+	}
+
+	buf = malloc(st.st_size);
+	if (buf == NULL) {
+		close(fd);
+		return TEST_FAILED;
+	}
+
+	n = read(fd, buf, st.st_size);
+	close(fd);
+	if (n != st.st_size) {
+		printf("short read of %s\n", name);
+		free(buf);
+		return TEST_FAILED;
+	}
+
+	ret = pcapng_test_check(buf, st.st_size);
+	free(buf);
+	return ret;
+}
+
+static int
+test_pcapng(void)
+{
+	char name[] = "/tmp/pcapng_test_XXXXXX.pcapng";
+	struct rte_mbuf *pkts[PCAPNG_TEST_NB_PKTS];
+	struct rte_mbuf *copies[PCAPNG_TEST_NB_PKTS];
+	struct rte_mempool *mp = NULL, *copy_mp = NULL;
+	rte_pcapng_t *pcapng = NULL;
+	uint64_t start;
+	ssize_t len;
+	int fd = -1, ret = TEST_FAILED;
+	uint32_t i;
+
+	mp = rte_pktmbuf_pool_create("pcapng_test_pool",
+			2 * PCAPNG_TEST_NB_PKTS - 1, 0, 0,
+			RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	copy_mp = rte_pktmbuf_pool_create("pcapng_copy_pool",
+			2 * PCAPNG_TEST_NB_PKTS - 1, 0, 0,
+			rte_pcapng_mbuf_size(PCAPNG_TEST_PKT_LEN),
+			SOCKET_ID_ANY);
+	if (mp == NULL || copy_mp == NULL) {
+		printf("can not create mempools\n");
+		goto out;
+	}
+
+	if (pcapng_test_fill(mp, pkts) < 0) {
+		printf("can not allocate packets\n");
+		goto out;
+	}
+
+	fd = mkstemps(name, strlen(".pcapng"));
+	if (fd < 0) {
+		printf("can not create %s\n", name);
+		goto free_pkts;
+	}
+
+	pcapng = rte_pcapng_fdopen(fd, NULL, NULL, "pcapng_autotest", NULL);
+	if (pcapng == NULL) {
+		printf("rte_pcapng_fdopen failed\n");
+		close(fd);
+		goto unlink;
+	}
+
+	start = rte_get_tsc_cycles();
+	for (i = 0; i != PCAPNG_TEST_NB_PKTS; i++) {
+		copies[i] = rte_pcapng_copy(PCAPNG_TEST_PORT,
+				PCAPNG_TEST_QUEUE, pkts[i], copy_mp,
+				PCAPNG_TEST_SNAPLEN, rte_get_tsc_cycles(),
+				RTE_PCAPNG_DIRECTION_IN);
+		if (copies[i] == NULL) {
+			printf("rte_pcapng_copy of packet %u failed\n", i);
+			rte_pktmbuf_free_bulk(copies, i);
+			goto close;
+		}
+	}
+
+	/* in two bursts, the port is described only once */
+	len = rte_pcapng_write_packets(pcapng, copies,
+			PCAPNG_TEST_NB_PKTS / 2);
+	if (len > 0)
+		len = rte_pcapng_write_packets(pcapng,
+				copies + PCAPNG_TEST_NB_PKTS / 2,
+				PCAPNG_TEST_NB_PKTS - PCAPNG_TEST_NB_PKTS / 2);
+	else
+		rte_pktmbuf_free_bulk(copies + PCAPNG_TEST_NB_PKTS / 2,
+				PCAPNG_TEST_NB_PKTS - PCAPNG_TEST_NB_PKTS / 2);
+	if (len <= 0) {
+		printf("rte_pcapng_write_packets failed\n");
+		goto close;
+	}
+
+	if (rte_pcapng_write_stats(pcapng, PCAPNG_TEST_PORT, "test end",
+			start, rte_get_tsc_cycles(),
+			PCAPNG_TEST_NB_PKTS, 0) <= 0) {
+		printf("rte_pcapng_write_stats failed\n");
+		goto close;
+	}
+
+	rte_pcapng_close(pcapng);
+	pcapng = NULL;
+
+	ret = pcapng_test_read(name);
+
+close:
+	if (pcapng != NULL)
+		rte_pcapng_close(pcapng);
+unlink:
+	unlink(name);
+free_pkts:
+	rte_pktmbuf_free_bulk(pkts, PCAPNG_TEST_NB_PKTS);
+out:
+	rte_mempool_free(copy_mp);
+	rte_mempool_free(mp);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(pcapng_autotest, test_pcapng);
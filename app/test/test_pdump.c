@@ -5,8 +5,10 @@
 #include <unistd.h>
 #include <stdint.h>
 #include <limits.h>
+#include <inttypes.h>
 
 #include <rte_ethdev_driver.h>
+#include <rte_malloc.h>
 #include <rte_pdump.h>
 #include "rte_eal.h"
 #include "rte_lcore.h"
@@ -44,6 +46,126 @@ test_pdump_init(void)
 	return ret;
 }
 
+/*
+ * Filter returning a constant, in shared memory so that the primary
+ * process can load it.
+ */
+static struct rte_bpf_prm *
+test_pdump_filter(int32_t rc)
+{
+	struct rte_bpf_prm *prm;
+	struct ebpf_insn *ins;
+
+	prm = rte_zmalloc("pdump_test_filter",
+			sizeof(*prm) + 2 * sizeof(*ins), 0);
+	if (prm == NULL)
+		return NULL;
+
+	ins = (struct ebpf_insn *)(prm + 1);
+	ins[0].code = (BPF_ALU | EBPF_MOV | BPF_K);
+	ins[0].dst_reg = EBPF_REG_0;
+	ins[0].imm = rc;
+	ins[1].code = (BPF_JMP | EBPF_EXIT);
+
+	prm->ins = ins;
+	prm->nb_ins = 2;
+	prm->prog_arg.type = RTE_BPF_ARG_PTR_MBUF;
+	prm->prog_arg.size = sizeof(struct rte_mbuf);
+	prm->prog_arg.buf_size = RTE_MBUF_DEFAULT_BUF_SIZE;
+
+	return prm;
+}
+
+/* free the packets captured so far, returning their number */
+static unsigned int
+test_pdump_drain(struct rte_ring *ring)
+{
+	struct rte_mbuf *pkts[NUM_PACKETS];
+	unsigned int n, total = 0;
+
+	while ((n = rte_ring_dequeue_burst(ring, (void **)pkts,
+			NUM_PACKETS, NULL)) != 0) {
+		rte_pktmbuf_free_bulk(pkts, n);
+		total += n;
+	}
+
+	return total;
+}
+
+/*
+ * Capture the packets sent by the primary process through a filter
+ * rejecting all of them, then through one accepting all of them, and
+ * check what reached the ring and the capture statistics.
+ */
+static int
+run_pdump_filter_tests(struct rte_ring *ring, struct rte_mempool *mp)
+{
+	struct rte_pdump_stats before, after;
+	struct rte_bpf_prm *prm;
+	unsigned int captured;
+	int32_t accept;
+	int ret;
+
+	for (accept = 0; accept <= 1; accept++) {
+		printf("\n***** filter %s all packets *****\n",
+			accept ? "accepting" : "rejecting");
+
+		prm = test_pdump_filter(accept);
+		if (prm == NULL) {
+			printf("failed to allocate filter\n");
+			return -1;
+		}
+
+		test_pdump_drain(ring);
+		if (rte_pdump_stats(portid, &before) < 0) {
+			printf("rte_pdump_stats failed\n");
+			rte_free(prm);
+			return -1;
+		}
+
+		ret = rte_pdump_enable_bpf(portid, QUEUE_ID,
+				RTE_PDUMP_FLAG_RXTX, UINT32_MAX, ring, mp, prm);
+		if (ret < 0) {
+			printf("rte_pdump_enable_bpf failed\n");
+			rte_free(prm);
+			return -1;
+		}
+
+		/* let the primary process send packets */
+		usleep(100000);
+
+		ret = rte_pdump_disable(portid, QUEUE_ID, RTE_PDUMP_FLAG_RXTX);
+		rte_free(prm);
+		if (ret < 0) {
+			printf("rte_pdump_disable failed\n");
+			return -1;
+		}
+
+		captured = test_pdump_drain(ring);
+		if (rte_pdump_stats(portid, &after) < 0) {
+			printf("rte_pdump_stats failed\n");
+			return -1;
+		}
+
+		if (accept ? (captured == 0 ||
+				after.accepted == before.accepted ||
+				after.filtered != before.filtered) :
+				(captured != 0 ||
+				after.accepted != before.accepted ||
+				after.filtered == before.filtered)) {
+			printf("unexpected capture: %u packets, "
+				"%"PRIu64" accepted, %"PRIu64" filtered\n",
+				captured, after.accepted - before.accepted,
+				after.filtered - before.filtered);
+			return -1;
+		}
+		printf("%u packets captured, %"PRIu64" filtered\n",
+			captured, after.filtered - before.filtered);
+	}
+
+	return 0;
+}
+
 int
 run_pdump_client_tests(void)
 {
@@ -116,6 +238,10 @@ run_pdump_client_tests(void)
 			printf("\n***** flags = RTE_PDUMP_FLAG_RXTX *****\n");
 		}
 	}
+	ret = run_pdump_filter_tests(ring_client, mp);
+	if (ret < 0)
+		printf("pdump filter tests failed\n");
+
 	if (ring_client != NULL)
 		test_ring_free(ring_client);
 	if (mp != NULL)
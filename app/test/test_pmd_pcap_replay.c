@@ -0,0 +1,320 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rte_bus_vdev.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+#include "test.h"
+
+/*
+ * Write small pcap files and replay them through the pcap PMD, checking
+ * how the file parser handles malformed and nanosecond resolution files.
+ */
+
+#define REPLAY_TEST_VDEV	"net_pcap_replay_test"
+#define REPLAY_TEST_NB_MBUF	512
+#define REPLAY_TEST_BURST	32
+#define REPLAY_TEST_PKT_LEN	60
+
+/* libpcap file format */
+#define REPLAY_TEST_MAGIC_USEC	0xa1b2c3d4
+#define REPLAY_TEST_MAGIC_NSEC	0xa1b23c4d
+#define REPLAY_TEST_LINKTYPE	1	/* Ethernet */
+
+struct replay_test_file_hdr {
+	uint32_t magic;
+	uint16_t version_major;
+	uint16_t version_minor;
+	int32_t thiszone;
+	uint32_t sigfigs;
+	uint32_t snaplen;
+	uint32_t linktype;
+};
+
+struct replay_test_rec_hdr {
+	uint32_t ts_sec;
+	uint32_t ts_frac;
+	uint32_t caplen;
+	uint32_t len;
+};
+
+static struct rte_mempool *replay_test_mp;
+static char replay_test_file[] = "/tmp/dpdk_pcap_replay_XXXXXX";
+
+static uint8_t
+replay_test_byte(uint32_t pkt, uint32_t off)
+{
+	return (uint8_t)(pkt * 13 + off);
+}
+
+static int
+replay_test_write_hdr(FILE *f, uint32_t magic)
+{
+	struct replay_test_file_hdr hdr = {
+		.magic = magic,
+		.version_major = 2,
+		.version_minor = 4,
+		.snaplen = UINT16_MAX,
+		.linktype = REPLAY_TEST_LINKTYPE,
+	};
+
+	return fwrite(&hdr, sizeof(hdr), 1, f) == 1 ? 0 : -1;
+}
+
+/* Write a record holding caplen bytes, of which only len are present */
+static int
+replay_test_write_rec(FILE *f, uint32_t pkt, uint32_t sec, uint32_t frac,
+		uint32_t caplen, uint32_t len)
+{
+	struct replay_test_rec_hdr rec = {
+		.ts_sec = sec,
+		.ts_frac = frac,
+		.caplen = caplen,
+		.len = caplen,
+	};
+	uint8_t data[REPLAY_TEST_PKT_LEN];
+	uint32_t i;
+
+	if (len > sizeof(data))
+		return -1;
+	for (i = 0; i != len; i++)
+		data[i] = replay_test_byte(pkt, i);
+
+	if (fwrite(&rec, sizeof(rec), 1, f) != 1)
+		return -1;
+	return fwrite(data, 1, len, f) == len ? 0 : -1;
+}
+
+static FILE *
+replay_test_create(void)
+{
+	return fopen(replay_test_file, "w");
+}
+
+static int
+replay_test_port_setup(uint16_t *port_id)
+{
+	char args[sizeof(replay_test_file) + 16];
+	struct rte_eth_conf conf;
+
+	snprintf(args, sizeof(args), "replay=%s", replay_test_file);
+	if (rte_vdev_init(REPLAY_TEST_VDEV, args) < 0)
+		return -1;
+
+	memset(&conf, 0, sizeof(conf));
+	if (rte_eth_dev_get_port_by_name(REPLAY_TEST_VDEV, port_id) != 0 ||
+			rte_eth_dev_configure(*port_id, 1, 1, &conf) < 0 ||
+			rte_eth_rx_queue_setup(*port_id, 0, 0, SOCKET_ID_ANY,
+				NULL, replay_test_mp) < 0 ||
+			rte_eth_tx_queue_setup(*port_id, 0, 0, SOCKET_ID_ANY,
+				NULL) < 0 ||
+			rte_eth_dev_start(*port_id) < 0) {
+		rte_vdev_uninit(REPLAY_TEST_VDEV);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Receive everything the port replays, the file is not looped over */
+static unsigned int
+replay_test_rx(uint16_t port_id, struct rte_mbuf **pkts, unsigned int max)
+{
+	unsigned int nb_rx = 0;
+	uint16_t n;
+
+	do {
+		n = rte_eth_rx_burst(port_id, 0, &pkts[nb_rx],
+				max - nb_rx);
+		nb_rx += n;
+	} while (n != 0 && nb_rx < max);
+
+	return nb_rx;
+}
+
+static int
+test_replay_truncated_header(void)
+{
+	struct replay_test_file_hdr hdr = { .magic = REPLAY_TEST_MAGIC_USEC };
+	uint16_t port_id;
+	FILE *f;
+
+	f = replay_test_create();
+	TEST_ASSERT_NOT_NULL(f, "Cannot create %s", replay_test_file);
+	TEST_ASSERT_EQUAL(fwrite(&hdr, sizeof(hdr) / 2, 1, f), 1,
+			"Cannot write %s", replay_test_file);
+	fclose(f);
+
+	TEST_ASSERT_FAIL(replay_test_port_setup(&port_id),
+			"File with a truncated header was replayed");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_replay_bad_magic(void)
+{
+	uint16_t port_id;
+	FILE *f;
+
+	f = replay_test_create();
+	TEST_ASSERT_NOT_NULL(f, "Cannot create %s", replay_test_file);
+	TEST_ASSERT_SUCCESS(replay_test_write_hdr(f, 0xdeadbeef) ||
+			replay_test_write_rec(f, 0, 1, 0, REPLAY_TEST_PKT_LEN,
+				REPLAY_TEST_PKT_LEN),
+			"Cannot write %s", replay_test_file);
+	fclose(f);
+
+	TEST_ASSERT_FAIL(replay_test_port_setup(&port_id),
+			"File with a bad magic was replayed");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * The packets before a truncated record are replayed. They are also
+ * checked after the port is closed, as the mapping must stay until the
+ * mbufs attached to it are freed.
+ */
+static int
+test_replay_truncated_record(void)
+{
+	struct rte_mbuf *pkts[REPLAY_TEST_BURST];
+	unsigned int nb_rx, i, j;
+	const uint8_t *data;
+	uint16_t port_id;
+	FILE *f;
+
+	f = replay_test_create();
+	TEST_ASSERT_NOT_NULL(f, "Cannot create %s", replay_test_file);
+	TEST_ASSERT_SUCCESS(replay_test_write_hdr(f, REPLAY_TEST_MAGIC_USEC) ||
+			replay_test_write_rec(f, 0, 1, 0, REPLAY_TEST_PKT_LEN,
+				REPLAY_TEST_PKT_LEN) ||
+			replay_test_write_rec(f, 1, 1, 10, REPLAY_TEST_PKT_LEN,
+				REPLAY_TEST_PKT_LEN) ||
+			replay_test_write_rec(f, 2, 1, 20, REPLAY_TEST_PKT_LEN,
+				REPLAY_TEST_PKT_LEN / 2),
+			"Cannot write %s", replay_test_file);
+	fclose(f);
+
+	TEST_ASSERT_SUCCESS(replay_test_port_setup(&port_id),
+			"Cannot replay %s", replay_test_file);
+	nb_rx = replay_test_rx(port_id, pkts, RTE_DIM(pkts));
+
+	rte_eth_dev_stop(port_id);
+	rte_eth_dev_close(port_id);
+	rte_vdev_uninit(REPLAY_TEST_VDEV);
+
+	TEST_ASSERT_EQUAL(nb_rx, 2, "Received %u packets instead of 2", nb_rx);
+	for (i = 0; i != nb_rx; i++) {
+		TEST_ASSERT_EQUAL(rte_pktmbuf_pkt_len(pkts[i]),
+				REPLAY_TEST_PKT_LEN,
+				"Bad length of packet %u", i);
+		data = rte_pktmbuf_mtod(pkts[i], const uint8_t *);
+		for (j = 0; j != REPLAY_TEST_PKT_LEN; j++)
+			TEST_ASSERT_EQUAL(data[j], replay_test_byte(i, j),
+					"Bad data in packet %u at %u", i, j);
+	}
+	rte_pktmbuf_free_bulk(pkts, nb_rx);
+
+	return TEST_SUCCESS;
+}
+
+/* Fractions of seconds are nanoseconds, mbuf timestamps microseconds */
+static int
+test_replay_nsec_magic(void)
+{
+	struct rte_mbuf *pkts[REPLAY_TEST_BURST];
+	unsigned int nb_rx;
+	uint16_t port_id;
+	FILE *f;
+
+	f = replay_test_create();
+	TEST_ASSERT_NOT_NULL(f, "Cannot create %s", replay_test_file);
+	TEST_ASSERT_SUCCESS(replay_test_write_hdr(f, REPLAY_TEST_MAGIC_NSEC) ||
+			replay_test_write_rec(f, 0, 1, 123456789,
+				REPLAY_TEST_PKT_LEN, REPLAY_TEST_PKT_LEN) ||
+			replay_test_write_rec(f, 1, 2, 999,
+				REPLAY_TEST_PKT_LEN, REPLAY_TEST_PKT_LEN),
+			"Cannot write %s", replay_test_file);
+	fclose(f);
+
+	TEST_ASSERT_SUCCESS(replay_test_port_setup(&port_id),
+			"Cannot replay %s", replay_test_file);
+	nb_rx = replay_test_rx(port_id, pkts, RTE_DIM(pkts));
+
+	rte_eth_dev_stop(port_id);
+	rte_eth_dev_close(port_id);
+	rte_vdev_uninit(REPLAY_TEST_VDEV);
+
+	if (nb_rx != 2) {
+		rte_pktmbuf_free_bulk(pkts, nb_rx);
+		printf("Received %u packets instead of 2\n", nb_rx);
+		return TEST_FAILED;
+	}
+	TEST_ASSERT(pkts[0]->ol_flags & PKT_RX_TIMESTAMP,
+			"Timestamp not set");
+	TEST_ASSERT_EQUAL(pkts[0]->timestamp, 1123456,
+			"Bad timestamp %"PRIu64" of packet 0",
+			pkts[0]->timestamp);
+	TEST_ASSERT_EQUAL(pkts[1]->timestamp, 2000000,
+			"Bad timestamp %"PRIu64" of packet 1",
+			pkts[1]->timestamp);
+	rte_pktmbuf_free_bulk(pkts, nb_rx);
+
+	return TEST_SUCCESS;
+}
+
+static int
+replay_test_setup(void)
+{
+	int fd;
+
+	fd = mkstemp(replay_test_file);
+	TEST_ASSERT(fd >= 0, "Cannot create temporary file");
+	close(fd);
+
+	replay_test_mp = rte_pktmbuf_pool_create("pcap_replay_test",
+			REPLAY_TEST_NB_MBUF, 32, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(replay_test_mp, "Cannot create mbuf pool");
+
+	return TEST_SUCCESS;
+}
+
+static void
+replay_test_teardown(void)
+{
+	rte_mempool_free(replay_test_mp);
+	replay_test_mp = NULL;
+	unlink(replay_test_file);
+}
+
+static struct unit_test_suite pcap_replay_testsuite = {
+	.suite_name = "pcap PMD replay unit test suite",
+	.setup = replay_test_setup,
+	.teardown = replay_test_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_replay_truncated_header),
+		TEST_CASE(test_replay_bad_magic),
+		TEST_CASE(test_replay_truncated_record),
+		TEST_CASE(test_replay_nsec_magic),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_pmd_pcap_replay(void)
+{
+	return unit_test_suite_runner(&pcap_replay_testsuite);
+}
+
+REGISTER_TEST_COMMAND(pcap_replay_autotest, test_pmd_pcap_replay);
@@ -9,6 +9,8 @@
 #include <rte_eth_ring.h>
 #include <rte_ethdev.h>
 #include <rte_bus_vdev.h>
+#include <rte_ip.h>
+#include <rte_udp.h>
 
 #define SOCKET0 0
 #define RING_SIZE 256
@@ -418,6 +420,325 @@ test_pmd_ring_pair_create_attach(void)
 	return TEST_SUCCESS;
 }
 
+#define RSS_NB_FLOWS 16
+
+/* Build an UDP packet of flow number flow */
+static struct rte_mbuf *
+test_rss_build_packet(unsigned int flow)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip;
+	struct rte_udp_hdr *udp;
+	struct rte_mbuf *m;
+
+	m = rte_pktmbuf_alloc(mp);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+			sizeof(*eth) + sizeof(*ip) + sizeof(*udp));
+	memset(eth, 0, sizeof(*eth) + sizeof(*ip) + sizeof(*udp));
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+	ip = (struct rte_ipv4_hdr *)(eth + 1);
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 1, flow));
+
+	udp = (struct rte_udp_hdr *)(ip + 1);
+	udp->src_port = rte_cpu_to_be_16(1024 + flow);
+	udp->dst_port = rte_cpu_to_be_16(80);
+
+	return m;
+}
+
+/*
+ * Send RSS_NB_FLOWS flows on tx queue 0 and check every packet is
+ * received on the queue given by the RETA entry of its hash.
+ */
+static int
+test_rss_send_flows(int port, const uint16_t *reta)
+{
+	struct rte_mbuf *pbufs[RSS_NB_FLOWS];
+	unsigned int i, q, nb_rx, total = 0;
+
+	for (i = 0; i < RSS_NB_FLOWS; i++) {
+		pbufs[i] = test_rss_build_packet(i);
+		TEST_ASSERT_NOT_NULL(pbufs[i], "Failed to allocate packet");
+	}
+
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(port, 0, pbufs, RSS_NB_FLOWS),
+			RSS_NB_FLOWS, "Failed to transmit packet burst");
+
+	for (q = 0; q < NUM_RINGS; q++) {
+		nb_rx = rte_eth_rx_burst(port, q, pbufs, RSS_NB_FLOWS);
+		for (i = 0; i < nb_rx; i++) {
+			TEST_ASSERT(pbufs[i]->ol_flags & PKT_RX_RSS_HASH,
+					"Packet has no RSS hash");
+			TEST_ASSERT_EQUAL(reta[pbufs[i]->hash.rss &
+					(ETH_RSS_RETA_SIZE_128 - 1)], q,
+					"Packet received on wrong queue %u", q);
+			rte_pktmbuf_free(pbufs[i]);
+		}
+		total += nb_rx;
+	}
+	TEST_ASSERT_EQUAL(total, RSS_NB_FLOWS, "Lost packets");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_rss_steering(void)
+{
+	struct rte_eth_rss_reta_entry64 reta_conf[ETH_RSS_RETA_SIZE_128 /
+			RTE_RETA_GROUP_SIZE];
+	struct rte_eth_conf conf;
+	uint16_t reta[ETH_RSS_RETA_SIZE_128];
+	int port = rxtx_portd;
+	unsigned int i, q;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.rxmode.mq_mode = ETH_MQ_RX_RSS;
+	conf.rx_adv_conf.rss_conf.rss_hf = ETH_RSS_IPV4 |
+		ETH_RSS_NONFRAG_IPV4_UDP;
+
+	TEST_ASSERT_SUCCESS(rte_eth_dev_configure(port, NUM_RINGS, NUM_RINGS,
+			&conf), "Configure failed for port %d", port);
+	for (q = 0; q < NUM_RINGS; q++) {
+		TEST_ASSERT_SUCCESS(rte_eth_tx_queue_setup(port, q, RING_SIZE,
+				SOCKET0, NULL), "TX queue setup failed");
+		TEST_ASSERT_SUCCESS(rte_eth_rx_queue_setup(port, q, RING_SIZE,
+				SOCKET0, NULL, mp), "RX queue setup failed");
+	}
+	TEST_ASSERT_SUCCESS(rte_eth_dev_start(port),
+			"Error starting port %d", port);
+
+	/* default RETA spreads over all queues */
+	for (i = 0; i < ETH_RSS_RETA_SIZE_128; i++)
+		reta[i] = i % NUM_RINGS;
+	TEST_ASSERT_SUCCESS(test_rss_send_flows(port, reta),
+			"Default RETA steering failed");
+
+	/* send everything to the last queue */
+	memset(reta_conf, 0, sizeof(reta_conf));
+	for (i = 0; i < ETH_RSS_RETA_SIZE_128; i++) {
+		reta[i] = NUM_RINGS - 1;
+		reta_conf[i / RTE_RETA_GROUP_SIZE].mask = UINT64_MAX;
+		reta_conf[i / RTE_RETA_GROUP_SIZE].reta[i % RTE_RETA_GROUP_SIZE]
+			= reta[i];
+	}
+	TEST_ASSERT_SUCCESS(rte_eth_dev_rss_reta_update(port, reta_conf,
+			ETH_RSS_RETA_SIZE_128), "RETA update failed");
+	TEST_ASSERT_SUCCESS(test_rss_send_flows(port, reta),
+			"Updated RETA steering failed");
+
+	rte_eth_dev_stop(port);
+
+	return TEST_SUCCESS;
+}
+
+/* From the Microsoft RSS verification suite, as in test_thash.c */
+static const uint8_t rss_ms_key[] = {
+	0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2,
+	0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+	0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4,
+	0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+	0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
+};
+
+static const struct {
+	uint32_t dst_ip;
+	uint32_t src_ip;
+	uint16_t dst_port;
+	uint16_t src_port;
+	uint32_t hash_l3;
+	uint32_t hash_l3l4;
+} rss_ms_v4[] = {
+	{RTE_IPV4(161, 142, 100, 80), RTE_IPV4(66, 9, 149, 187),
+		1766, 2794, 0x323e8fc2, 0x51ccc178},
+	{RTE_IPV4(65, 69, 140, 83), RTE_IPV4(199, 92, 111, 2),
+		4739, 14230, 0xd718262a, 0xc626b0ea},
+	{RTE_IPV4(12, 22, 207, 184), RTE_IPV4(24, 19, 198, 95),
+		38024, 12898, 0xd2d0a5de, 0x5c2b394a},
+	{RTE_IPV4(209, 142, 163, 6), RTE_IPV4(38, 27, 205, 30),
+		2217, 48228, 0x82989176, 0xafc7327f},
+	{RTE_IPV4(202, 188, 127, 2), RTE_IPV4(153, 39, 163, 191),
+		1303, 44251, 0x5d1809c5, 0x10e828a2},
+};
+
+static const struct {
+	uint8_t dst_ip[16];
+	uint8_t src_ip[16];
+	uint16_t dst_port;
+	uint16_t src_port;
+	uint32_t hash_l3;
+	uint32_t hash_l3l4;
+} rss_ms_v6[] = {
+	/* 3ffe:2501:200:3::1, 3ffe:2501:200:1fff::7 */
+	{{0x3f, 0xfe, 0x25, 0x01, 0x02, 0x00, 0x00, 0x03,
+	  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01},
+	 {0x3f, 0xfe, 0x25, 0x01, 0x02, 0x00, 0x1f, 0xff,
+	  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07},
+		1766, 2794, 0x2cc18cd5, 0x40207d3d},
+	/* ff02::1, 3ffe:501:8::260:97ff:fe40:efab */
+	{{0xff, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01},
+	 {0x3f, 0xfe, 0x05, 0x01, 0x00, 0x08, 0x00, 0x00,
+	  0x02, 0x60, 0x97, 0xff, 0xfe, 0x40, 0xef, 0xab},
+		4739, 14230, 0x0f0c461c, 0xdde51bbf},
+	/* fe80::200:f8ff:fe21:67cf, 3ffe:1900:4545:3:200:f8ff:fe21:67cf */
+	{{0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	  0x02, 0x00, 0xf8, 0xff, 0xfe, 0x21, 0x67, 0xcf},
+	 {0x3f, 0xfe, 0x19, 0x00, 0x45, 0x45, 0x00, 0x03,
+	  0x02, 0x00, 0xf8, 0xff, 0xfe, 0x21, 0x67, 0xcf},
+		38024, 44251, 0x4b61e985, 0x02d1feef},
+};
+
+/* Build an UDP packet of a verification suite entry */
+static struct rte_mbuf *
+test_rss_build_vector(unsigned int idx, int ipv6)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip4;
+	struct rte_ipv6_hdr *ip6;
+	struct rte_udp_hdr *udp;
+	struct rte_mbuf *m;
+	size_t l3_len = ipv6 ? sizeof(*ip6) : sizeof(*ip4);
+
+	m = rte_pktmbuf_alloc(mp);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+			sizeof(*eth) + l3_len + sizeof(*udp));
+	memset(eth, 0, sizeof(*eth) + l3_len + sizeof(*udp));
+	udp = (struct rte_udp_hdr *)((char *)(eth + 1) + l3_len);
+
+	if (ipv6) {
+		eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ip6 = (struct rte_ipv6_hdr *)(eth + 1);
+		ip6->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ip6->proto = IPPROTO_UDP;
+		memcpy(ip6->src_addr, rss_ms_v6[idx].src_ip,
+				sizeof(ip6->src_addr));
+		memcpy(ip6->dst_addr, rss_ms_v6[idx].dst_ip,
+				sizeof(ip6->dst_addr));
+		udp->src_port = rte_cpu_to_be_16(rss_ms_v6[idx].src_port);
+		udp->dst_port = rte_cpu_to_be_16(rss_ms_v6[idx].dst_port);
+	} else {
+		eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+		ip4 = (struct rte_ipv4_hdr *)(eth + 1);
+		ip4->version_ihl = RTE_IPV4_VHL_DEF;
+		ip4->next_proto_id = IPPROTO_UDP;
+		ip4->src_addr = rte_cpu_to_be_32(rss_ms_v4[idx].src_ip);
+		ip4->dst_addr = rte_cpu_to_be_32(rss_ms_v4[idx].dst_ip);
+		udp->src_port = rte_cpu_to_be_16(rss_ms_v4[idx].src_port);
+		udp->dst_port = rte_cpu_to_be_16(rss_ms_v4[idx].dst_port);
+	}
+
+	return m;
+}
+
+/* Send one verification suite entry and return the hash it got */
+static int
+test_rss_vector_hash(int port, unsigned int idx, int ipv6, uint32_t *hash)
+{
+	struct rte_mbuf *m;
+	unsigned int q;
+
+	m = test_rss_build_vector(idx, ipv6);
+	TEST_ASSERT_NOT_NULL(m, "Failed to allocate packet");
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(port, 0, &m, 1), 1,
+			"Failed to transmit packet");
+
+	for (q = 0; q < NUM_RINGS; q++)
+		if (rte_eth_rx_burst(port, q, &m, 1) == 1)
+			break;
+	TEST_ASSERT(q < NUM_RINGS, "Lost packet");
+	TEST_ASSERT(m->ol_flags & PKT_RX_RSS_HASH, "Packet has no RSS hash");
+	*hash = m->hash.rss;
+	rte_pktmbuf_free(m);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_rss_configure(int port, uint16_t nb_tx_queues, uint64_t rss_hf)
+{
+	struct rte_eth_conf conf;
+	unsigned int q;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.rxmode.mq_mode = ETH_MQ_RX_RSS;
+	conf.rx_adv_conf.rss_conf.rss_key = (uint8_t *)(uintptr_t)rss_ms_key;
+	conf.rx_adv_conf.rss_conf.rss_key_len = sizeof(rss_ms_key);
+	conf.rx_adv_conf.rss_conf.rss_hf = rss_hf;
+
+	TEST_ASSERT_SUCCESS(rte_eth_dev_configure(port, NUM_RINGS,
+			nb_tx_queues, &conf),
+			"Configure failed for port %d", port);
+	for (q = 0; q < nb_tx_queues; q++)
+		TEST_ASSERT_SUCCESS(rte_eth_tx_queue_setup(port, q, RING_SIZE,
+				SOCKET0, NULL), "TX queue setup failed");
+	for (q = 0; q < NUM_RINGS; q++)
+		TEST_ASSERT_SUCCESS(rte_eth_rx_queue_setup(port, q, RING_SIZE,
+				SOCKET0, NULL, mp), "RX queue setup failed");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check the computed Toeplitz hashes against the verification suite, for
+ * addresses and ports, then addresses only.
+ */
+static int
+test_rss_hash_vectors(void)
+{
+	int port = rxtx_portd;
+	uint32_t hash, expected;
+	unsigned int i;
+	int l4;
+
+	/* an rx only port has no redirection target */
+	TEST_ASSERT_SUCCESS(test_rss_configure(port, 0,
+			ETH_RSS_IPV4 | ETH_RSS_NONFRAG_IPV4_UDP),
+			"RSS configuration of rx only port failed");
+
+	for (l4 = 1; l4 >= 0; l4--) {
+		TEST_ASSERT_SUCCESS(test_rss_configure(port, NUM_RINGS,
+				ETH_RSS_IPV4 | ETH_RSS_IPV6 | (l4 ?
+				ETH_RSS_NONFRAG_IPV4_UDP |
+				ETH_RSS_NONFRAG_IPV6_UDP : 0)),
+				"RSS configuration failed");
+		TEST_ASSERT_SUCCESS(rte_eth_dev_start(port),
+				"Error starting port %d", port);
+
+		for (i = 0; i < RTE_DIM(rss_ms_v4); i++) {
+			TEST_ASSERT_SUCCESS(test_rss_vector_hash(port, i, 0,
+					&hash), "IPv4 vector %u failed", i);
+			expected = l4 ? rss_ms_v4[i].hash_l3l4 :
+				rss_ms_v4[i].hash_l3;
+			TEST_ASSERT_EQUAL(hash, expected,
+					"Wrong hash 0x%x of IPv4 vector %u",
+					hash, i);
+		}
+		for (i = 0; i < RTE_DIM(rss_ms_v6); i++) {
+			TEST_ASSERT_SUCCESS(test_rss_vector_hash(port, i, 1,
+					&hash), "IPv6 vector %u failed", i);
+			expected = l4 ? rss_ms_v6[i].hash_l3l4 :
+				rss_ms_v6[i].hash_l3;
+			TEST_ASSERT_EQUAL(hash, expected,
+					"Wrong hash 0x%x of IPv6 vector %u",
+					hash, i);
+		}
+
+		rte_eth_dev_stop(port);
+	}
+
+	return TEST_SUCCESS;
+}
+
 static void
 test_cleanup_resources(void)
 {
@@ -564,6 +885,8 @@ unit_test_suite test_pmd_ring_suite  = {
 		TEST_CASE(test_send_basic_packets),
 		TEST_CASE(test_get_stats_for_port),
 		TEST_CASE(test_stats_reset_for_port),
+		TEST_CASE(test_rss_steering),
+		TEST_CASE(test_rss_hash_vectors),
 		TEST_CASE(test_pmd_ring_pair_create_attach),
 		TEST_CASE(test_command_line_ring_port),
 		TEST_CASES_END()
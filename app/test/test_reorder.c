@@ -268,8 +268,10 @@ test_reorder_drain(void)
 		ret = -1;
 		goto exit;
 	}
-	if (robufs[0] != NULL)
+	if (robufs[0] != NULL) {
 		rte_pktmbuf_free(robufs[0]);
+		robufs[0] = NULL;
+	}
 
 	/* Insert more packets
 	 * RB[] = {NULL, NULL, NULL, NULL}
@@ -303,8 +305,10 @@ test_reorder_drain(void)
 		goto exit;
 	}
 	for (i = 0; i < 3; i++) {
-		if (robufs[i] != NULL)
+		if (robufs[i] != NULL) {
 			rte_pktmbuf_free(robufs[i]);
+			robufs[i] = NULL;
+		}
 	}
 
 	/*
@@ -330,6 +334,169 @@ test_reorder_drain(void)
 	return ret;
 }
 
+static int
+test_reorder_insert_bulk(void)
+{
+	struct rte_reorder_params params = {
+		.name = "test_insert_bulk",
+		.socket_id = rte_socket_id(),
+		.size = 8,
+		.nb_flows = 0,
+	};
+	/* the first mbuf opens the window, the last is far outside it */
+	static const uint32_t seqns[] = { 0, 2, 3, 1, 5, 4, 100 };
+	const unsigned int num_bufs = RTE_DIM(seqns);
+	struct rte_reorder_buffer *b;
+	struct rte_mempool *p = test_params->p;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	unsigned int i, cnt;
+	int ret = -1;
+
+	memset(robufs, 0, sizeof(robufs));
+
+	b = rte_reorder_create_ext(&params);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+	TEST_ASSERT(rte_reorder_seqn_dynfield_offset >= 0,
+			"Sequence number field not registered");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		TEST_ASSERT_NOT_NULL(bufs[i], "Packet allocation failed\n");
+		*rte_reorder_seqn(bufs[i]) = seqns[i];
+		/* must be ignored: the dynamic field is used */
+		bufs[i]->seqn = num_bufs - i;
+	}
+
+	cnt = rte_reorder_insert_bulk(b, bufs, num_bufs);
+	if (cnt != num_bufs - 1 || rte_errno != ERANGE) {
+		printf("%s:%d: inserted %u of %u packets\n",
+				__func__, __LINE__, cnt, num_bufs);
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++)
+		bufs[i] = NULL;
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != num_bufs - 1) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++) {
+		if (*rte_reorder_seqn(robufs[i]) != i) {
+			printf("%s:%d: packet %u drained out of order\n",
+					__func__, __LINE__, i);
+			goto exit;
+		}
+	}
+
+	ret = 0;
+exit:
+	rte_reorder_free(b);
+	for (i = 0; i < num_bufs; i++) {
+		if (bufs[i] != NULL)
+			rte_pktmbuf_free(bufs[i]);
+		if (robufs[i] != NULL)
+			rte_pktmbuf_free(robufs[i]);
+	}
+	return ret;
+}
+
+static int
+test_reorder_flows(void)
+{
+	struct rte_reorder_params params = {
+		.name = "test_flows",
+		.socket_id = rte_socket_id(),
+		.size = 4,
+		.nb_flows = 4,
+	};
+	/* flow 1 gets 11 last, flow 2 is complete but out of order */
+	static const uint32_t flows[] = { 1, 2, 1, 2, 2, 1 };
+	static const uint32_t seqns[] = { 10, 20, 12, 22, 21, 11 };
+	const unsigned int num_bufs = RTE_DIM(seqns);
+	struct rte_reorder_buffer *b;
+	struct rte_mempool *p = test_params->p;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	unsigned int i, cnt;
+	int ret = -1;
+
+	memset(robufs, 0, sizeof(robufs));
+
+	params.nb_flows = 3;
+	b = rte_reorder_create_ext(&params);
+	TEST_ASSERT((b == NULL) && (rte_errno == EINVAL),
+			"No error on create with invalid number of flows");
+	params.nb_flows = 4;
+
+	b = rte_reorder_create_ext(&params);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		TEST_ASSERT_NOT_NULL(bufs[i], "Packet allocation failed\n");
+		bufs[i]->hash.usr = flows[i];
+		*rte_reorder_seqn(bufs[i]) = seqns[i];
+	}
+
+	/* flow 1 holds 10 and 12 but waits for 11, flow 2 is in order */
+	cnt = rte_reorder_insert_bulk(b, bufs, num_bufs - 1);
+	if (cnt != num_bufs - 1) {
+		printf("%s:%d: inserted %u of %u packets\n",
+				__func__, __LINE__, cnt, num_bufs - 1);
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++)
+		bufs[i] = NULL;
+
+	/* RB[1] = {10}, flow 2 is not held back by the gap in flow 1 */
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 4) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		goto exit;
+	}
+	if (*rte_reorder_seqn(robufs[0]) != 10 ||
+			*rte_reorder_seqn(robufs[1]) != 20 ||
+			*rte_reorder_seqn(robufs[2]) != 21 ||
+			*rte_reorder_seqn(robufs[3]) != 22) {
+		printf("%s:%d: packets drained out of order\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++) {
+		rte_pktmbuf_free(robufs[i]);
+		robufs[i] = NULL;
+	}
+
+	/* the missing packet releases the rest of flow 1 */
+	if (rte_reorder_insert(b, bufs[5]) != 0) {
+		printf("%s:%d: Error inserting packet\n", __func__, __LINE__);
+		goto exit;
+	}
+	bufs[5] = NULL;
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 2 || *rte_reorder_seqn(robufs[0]) != 11 ||
+			*rte_reorder_seqn(robufs[1]) != 12) {
+		printf("%s:%d:%d: expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		goto exit;
+	}
+
+	ret = 0;
+exit:
+	rte_reorder_free(b);
+	for (i = 0; i < num_bufs; i++) {
+		if (bufs[i] != NULL)
+			rte_pktmbuf_free(bufs[i]);
+		if (robufs[i] != NULL)
+			rte_pktmbuf_free(robufs[i]);
+	}
+	return ret;
+}
+
 static int
 test_setup(void)
 {
@@ -380,6 +547,8 @@ static struct unit_test_suite reorder_test_suite  = {
 		TEST_CASE(test_reorder_free),
 		TEST_CASE(test_reorder_insert),
 		TEST_CASE(test_reorder_drain),
+		TEST_CASE(test_reorder_insert_bulk),
+		TEST_CASE(test_reorder_flows),
 		TEST_CASES_END()
 	}
 };
@@ -376,6 +376,14 @@ service_lcore_attr_get(void)
 			"lcore_attr_get() failed to get loops "
 			"(expected > zero)");
 
+	lcore_attr_id = RTE_SERVICE_LCORE_ATTR_CYCLES;
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_attr_get(slcore_id,
+			lcore_attr_id, &lcore_attr_value),
+			"Valid lcore_attr_get() call didn't return success");
+	TEST_ASSERT(lcore_attr_value > 0,
+			"lcore_attr_get() failed to get cycles "
+			"(expected > zero)");
+
 	lcore_attr_id++;  // invalid lcore attr id
 	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_attr_get(slcore_id,
 			lcore_attr_id, &lcore_attr_value),
@@ -397,6 +405,172 @@ service_lcore_attr_get(void)
 	return unregister_all();
 }
 
+/* verify weighted scheduling, budget and cycles histogram of a service */
+static int
+service_weight_budget(void)
+{
+	unregister_all();
+
+	struct rte_service_spec service;
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = dummy_cb;
+	snprintf(service.name, sizeof(service.name), DUMMY_SERVICE_NAME);
+	uint32_t id;
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, &id),
+			"Register of service failed");
+	rte_service_component_runstate_set(id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 1),
+			"Error: Service start returned non-zero");
+	rte_service_set_stats_enable(id, 1);
+
+	uint64_t attr_value;
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id, RTE_SERVICE_ATTR_WEIGHT,
+			&attr_value), "Failed to get weight");
+	TEST_ASSERT_EQUAL(1, attr_value, "Default weight is not 1");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_weight_set(id, 0),
+			"Zero weight didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_weight_set(UINT32_MAX, 1),
+			"Invalid service id didn't return -EINVAL");
+
+	const uint32_t weight = 4;
+	TEST_ASSERT_EQUAL(0, rte_service_weight_set(id, weight),
+			"Failed to set weight");
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id, RTE_SERVICE_ATTR_WEIGHT,
+			&attr_value), "Failed to get weight");
+	TEST_ASSERT_EQUAL(weight, attr_value, "Weight not set");
+
+	/* run the weighted service: each loop invokes it weight times */
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service and core failed");
+	rte_service_attr_reset_all(id);
+	rte_service_lcore_attr_reset_all(slcore_id);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 0),
+			"Disabling valid service and core failed");
+	rte_service_lcore_stop(slcore_id);
+	rte_eal_wait_lcore(slcore_id);
+
+	uint64_t calls, loops;
+	rte_service_attr_get(id, RTE_SERVICE_ATTR_CALL_COUNT, &calls);
+	rte_service_lcore_attr_get(slcore_id, RTE_SERVICE_LCORE_ATTR_LOOPS,
+			&loops);
+	/* the core may loop a few times after the service got unmapped */
+	TEST_ASSERT(calls > 0 && calls <= weight * loops,
+			"Unexpected service call count %"PRIu64" loops %"PRIu64,
+			calls, loops);
+	TEST_ASSERT_EQUAL(0, calls % weight,
+			"Weighted service not run weight times per loop");
+
+	/* the histogram accounts for every call */
+	uint64_t hist[RTE_SERVICE_HIST_BUCKETS];
+	uint64_t hist_calls = 0;
+	uint32_t i;
+	TEST_ASSERT_EQUAL(RTE_SERVICE_HIST_BUCKETS,
+			rte_service_cycles_histogram_get(id, hist,
+				RTE_SERVICE_HIST_BUCKETS),
+			"Failed to get the cycles histogram");
+	for (i = 0; i < RTE_SERVICE_HIST_BUCKETS; i++)
+		hist_calls += hist[i];
+	TEST_ASSERT_EQUAL(calls, hist_calls,
+			"Cycles histogram doesn't match call count");
+
+	/* a budget of one cycle stops after the first call of each loop */
+	TEST_ASSERT_EQUAL(0, rte_service_budget_set(id, 1),
+			"Failed to set budget");
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id, RTE_SERVICE_ATTR_BUDGET,
+			&attr_value), "Failed to get budget");
+	TEST_ASSERT_EQUAL(1, attr_value, "Budget not set");
+	rte_service_attr_reset_all(id);
+	rte_service_lcore_attr_reset_all(slcore_id);
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 0),
+			"Disabling valid service and core failed");
+	rte_service_lcore_stop(slcore_id);
+	rte_eal_wait_lcore(slcore_id);
+
+	rte_service_attr_get(id, RTE_SERVICE_ATTR_CALL_COUNT, &calls);
+	rte_service_lcore_attr_get(slcore_id, RTE_SERVICE_LCORE_ATTR_LOOPS,
+			&loops);
+	TEST_ASSERT(calls > 0 && calls <= loops,
+			"Budget didn't limit the service to one call per loop");
+
+	return unregister_all();
+}
+
+/* verify a service can be moved from a service core to another one */
+static int
+service_lcore_migrate(void)
+{
+	unregister_all();
+
+	if (!rte_lcore_is_enabled(0) || !rte_lcore_is_enabled(1) ||
+	    !rte_lcore_is_enabled(2))
+		return TEST_SKIPPED;
+
+	uint32_t slcore_1 = rte_get_next_lcore(/* start core */ -1,
+					       /* skip master */ 1,
+					       /* wrap */ 0);
+	uint32_t slcore_2 = rte_get_next_lcore(/* start core */ slcore_1,
+					       /* skip master */ 1,
+					       /* wrap */ 0);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_1),
+			"Service core add fail");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_2),
+			"Service core add fail");
+
+	struct rte_service_spec service;
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = dummy_cb;
+	snprintf(service.name, sizeof(service.name), DUMMY_SERVICE_NAME);
+	uint32_t id;
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, &id),
+			"Register of service failed");
+	rte_service_component_runstate_set(id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 1),
+			"Error: Service start returned non-zero");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_1, 1),
+			"Enabling valid service and core failed");
+
+	TEST_ASSERT_EQUAL(-ENOENT, rte_service_lcore_migrate(id, slcore_2,
+			slcore_1), "Migrate of unmapped service didn't fail");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_migrate(id, slcore_1,
+			rte_lcore_id()), "Migrate to non service core didn't fail");
+
+	rte_service_lcore_start(slcore_1);
+	rte_service_lcore_start(slcore_2);
+	rte_delay_ms(20);
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_migrate(id, slcore_1,
+			slcore_2), "Migrate of running service failed");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_get(id, slcore_1),
+			"Service still mapped to source core");
+	TEST_ASSERT_EQUAL(1, rte_service_map_lcore_get(id, slcore_2),
+			"Service not mapped to destination core");
+
+	/* the service keeps running on the destination core */
+	const uint64_t tick = service_tick;
+	rte_delay_ms(20);
+	TEST_ASSERT(service_tick != tick,
+			"Service not run after migration");
+
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 0),
+			"Failed to stop service");
+	rte_service_lcore_stop(slcore_1);
+	rte_service_lcore_stop(slcore_2);
+	rte_eal_wait_lcore(slcore_1);
+	rte_eal_wait_lcore(slcore_2);
+
+	return unregister_all();
+}
+
 /* verify service dump */
 static int
 service_dump(void)
@@ -910,6 +1084,8 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_dump),
 		TEST_CASE_ST(dummy_register, NULL, service_attr_get),
 		TEST_CASE_ST(dummy_register, NULL, service_lcore_attr_get),
+		TEST_CASE_ST(dummy_register, NULL, service_weight_budget),
+		TEST_CASE_ST(dummy_register, NULL, service_lcore_migrate),
 		TEST_CASE_ST(dummy_register, NULL, service_probe_capability),
 		TEST_CASE_ST(dummy_register, NULL, service_start_stop),
 		TEST_CASE_ST(dummy_register, NULL, service_lcore_add_del),
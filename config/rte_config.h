@@ -40,6 +40,7 @@
 #define RTE_MAX_MEM_MB_PER_TYPE 65536
 #define RTE_MAX_MEM_MB 524288
 #define RTE_MAX_MEMZONE 2560
+#define RTE_MALLOC_LCORE_CACHE_SIZE 32
 #define RTE_MAX_TAILQ 32
 #define RTE_LOG_DP_LEVEL RTE_LOG_INFO
 #define RTE_BACKTRACE 1
@@ -62,6 +63,7 @@
 #define RTE_MAX_QUEUES_PER_PORT 1024
 #define RTE_ETHDEV_QUEUE_STAT_CNTRS 16
 #define RTE_ETHDEV_RXTX_CALLBACKS 1
+#undef RTE_ETHDEV_QUEUE_SW_STATS
 
 /* cryptodev defines */
 #define RTE_CRYPTO_MAX_DEVS 64
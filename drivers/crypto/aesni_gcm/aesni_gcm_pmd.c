@@ -435,6 +435,217 @@ handle_completed_gcm_crypto_op(struct aesni_gcm_qp *qp,
 	}
 }
 
+static inline void
+aesni_gcm_fill_error_code(struct rte_crypto_sym_vec *vec, int32_t errnum)
+{
+	uint32_t i;
+
+	for (i = 0; i < vec->num; i++)
+		vec->status[i] = errnum;
+}
+
+static inline int32_t
+aesni_gcm_sgl_op_finalize_encryption(const struct aesni_gcm_ops *ops,
+	const struct aesni_gcm_session *s, struct gcm_context_data *gdata_ctx,
+	uint8_t *digest)
+{
+	if (s->req_digest_length != s->gen_digest_length) {
+		uint8_t tmpdigest[s->gen_digest_length];
+
+		ops->finalize_enc(&s->gdata_key, gdata_ctx, tmpdigest,
+			s->gen_digest_length);
+		memcpy(digest, tmpdigest, s->req_digest_length);
+	} else {
+		ops->finalize_enc(&s->gdata_key, gdata_ctx, digest,
+			s->gen_digest_length);
+	}
+
+	return 0;
+}
+
+static inline int32_t
+aesni_gcm_sgl_op_finalize_decryption(const struct aesni_gcm_ops *ops,
+	const struct aesni_gcm_session *s, struct gcm_context_data *gdata_ctx,
+	uint8_t *digest)
+{
+	uint8_t tmpdigest[s->gen_digest_length];
+
+	ops->finalize_dec(&s->gdata_key, gdata_ctx, tmpdigest,
+		s->gen_digest_length);
+
+	return memcmp(digest, tmpdigest, s->req_digest_length) == 0 ? 0 :
+		EBADMSG;
+}
+
+static inline int32_t
+aesni_gmac_sgl_op_finalize_verify(const struct aesni_gcm_ops *ops,
+	const struct aesni_gcm_session *s, struct gcm_context_data *gdata_ctx,
+	uint8_t *digest)
+{
+	uint8_t tmpdigest[s->gen_digest_length];
+
+	/* GMAC verification generates the tag with the encrypt path */
+	ops->finalize_enc(&s->gdata_key, gdata_ctx, tmpdigest,
+		s->gen_digest_length);
+
+	return memcmp(digest, tmpdigest, s->req_digest_length) == 0 ? 0 :
+		EBADMSG;
+}
+
+static inline void
+aesni_gcm_process_gcm_sgl_op(const struct aesni_gcm_ops *ops,
+	const struct aesni_gcm_session *s, struct gcm_context_data *gdata_ctx,
+	struct rte_crypto_sgl *sgl, void *iv, void *aad)
+{
+	uint32_t i;
+
+	/* init crypto operation */
+	ops->init(&s->gdata_key, gdata_ctx, iv, aad,
+		(uint64_t)s->aad_length);
+
+	/* update with sgl data */
+	for (i = 0; i < sgl->num; i++) {
+		struct rte_crypto_vec *vec = &sgl->vec[i];
+
+		if (s->op == AESNI_GCM_OP_AUTHENTICATED_ENCRYPTION)
+			ops->update_enc(&s->gdata_key, gdata_ctx,
+				vec->base, vec->base, vec->len);
+		else
+			ops->update_dec(&s->gdata_key, gdata_ctx,
+				vec->base, vec->base, vec->len);
+	}
+}
+
+static inline int32_t
+aesni_gcm_process_gmac_sgl_op(const struct aesni_gcm_ops *ops,
+	const struct aesni_gcm_session *s, struct gcm_context_data *gdata_ctx,
+	struct rte_crypto_sgl *sgl, void *iv)
+{
+	/* GMAC authenticates its data as AAD, which has to be contiguous */
+	if (sgl->num != 1)
+		return ENOTSUP;
+
+	ops->init(&s->gdata_key, gdata_ctx, iv, sgl->vec[0].base,
+		sgl->vec[0].len);
+
+	return 0;
+}
+
+static inline uint32_t
+aesni_gcm_sgl_encrypt(const struct aesni_gcm_ops *ops,
+	const struct aesni_gcm_session *s, struct gcm_context_data *gdata_ctx,
+	struct rte_crypto_sym_vec *vec)
+{
+	uint32_t i, processed;
+
+	processed = 0;
+	for (i = 0; i < vec->num; ++i) {
+		aesni_gcm_process_gcm_sgl_op(ops, s, gdata_ctx,
+			&vec->sgl[i], vec->iv[i], vec->aad[i]);
+		vec->status[i] = aesni_gcm_sgl_op_finalize_encryption(ops, s,
+			gdata_ctx, vec->digest[i]);
+		processed += (vec->status[i] == 0);
+	}
+
+	return processed;
+}
+
+static inline uint32_t
+aesni_gcm_sgl_decrypt(const struct aesni_gcm_ops *ops,
+	const struct aesni_gcm_session *s, struct gcm_context_data *gdata_ctx,
+	struct rte_crypto_sym_vec *vec)
+{
+	uint32_t i, processed;
+
+	processed = 0;
+	for (i = 0; i < vec->num; ++i) {
+		aesni_gcm_process_gcm_sgl_op(ops, s, gdata_ctx,
+			&vec->sgl[i], vec->iv[i], vec->aad[i]);
+		vec->status[i] = aesni_gcm_sgl_op_finalize_decryption(ops, s,
+			gdata_ctx, vec->digest[i]);
+		processed += (vec->status[i] == 0);
+	}
+
+	return processed;
+}
+
+static inline uint32_t
+aesni_gmac_sgl_generate(const struct aesni_gcm_ops *ops,
+	const struct aesni_gcm_session *s, struct gcm_context_data *gdata_ctx,
+	struct rte_crypto_sym_vec *vec)
+{
+	uint32_t i, processed;
+
+	processed = 0;
+	for (i = 0; i < vec->num; ++i) {
+		vec->status[i] = aesni_gcm_process_gmac_sgl_op(ops, s,
+			gdata_ctx, &vec->sgl[i], vec->iv[i]);
+		if (vec->status[i] != 0)
+			continue;
+		vec->status[i] = aesni_gcm_sgl_op_finalize_encryption(ops, s,
+			gdata_ctx, vec->digest[i]);
+		processed += (vec->status[i] == 0);
+	}
+
+	return processed;
+}
+
+static inline uint32_t
+aesni_gmac_sgl_verify(const struct aesni_gcm_ops *ops,
+	const struct aesni_gcm_session *s, struct gcm_context_data *gdata_ctx,
+	struct rte_crypto_sym_vec *vec)
+{
+	uint32_t i, processed;
+
+	processed = 0;
+	for (i = 0; i < vec->num; ++i) {
+		vec->status[i] = aesni_gcm_process_gmac_sgl_op(ops, s,
+			gdata_ctx, &vec->sgl[i], vec->iv[i]);
+		if (vec->status[i] != 0)
+			continue;
+		vec->status[i] = aesni_gmac_sgl_op_finalize_verify(ops, s,
+			gdata_ctx, vec->digest[i]);
+		processed += (vec->status[i] == 0);
+	}
+
+	return processed;
+}
+
+/** Process CPU crypto bulk operations */
+uint32_t
+aesni_gcm_pmd_cpu_crypto_process(struct rte_cryptodev *dev,
+	struct rte_cryptodev_sym_session *sess,
+	__rte_unused union rte_crypto_sym_ofs ofs,
+	struct rte_crypto_sym_vec *vec)
+{
+	struct aesni_gcm_private *internals = dev->data->dev_private;
+	const struct aesni_gcm_ops *ops;
+	struct aesni_gcm_session *s;
+	struct gcm_context_data gdata_ctx;
+
+	s = get_sym_session_private_data(sess, dev->driver_id);
+	if (unlikely(s == NULL)) {
+		aesni_gcm_fill_error_code(vec, EINVAL);
+		return 0;
+	}
+
+	ops = &internals->ops[s->key];
+
+	switch (s->op) {
+	case AESNI_GCM_OP_AUTHENTICATED_ENCRYPTION:
+		return aesni_gcm_sgl_encrypt(ops, s, &gdata_ctx, vec);
+	case AESNI_GCM_OP_AUTHENTICATED_DECRYPTION:
+		return aesni_gcm_sgl_decrypt(ops, s, &gdata_ctx, vec);
+	case AESNI_GMAC_OP_GENERATE:
+		return aesni_gmac_sgl_generate(ops, s, &gdata_ctx, vec);
+	case AESNI_GMAC_OP_VERIFY:
+		return aesni_gmac_sgl_verify(ops, s, &gdata_ctx, vec);
+	default:
+		aesni_gcm_fill_error_code(vec, EINVAL);
+		return 0;
+	}
+}
+
 static uint16_t
 aesni_gcm_pmd_dequeue_burst(void *queue_pair,
 		struct rte_crypto_op **ops, uint16_t nb_ops)
@@ -527,7 +738,8 @@ aesni_gcm_create(const char *name,
 			RTE_CRYPTODEV_FF_SYM_OPERATION_CHAINING |
 			RTE_CRYPTODEV_FF_IN_PLACE_SGL |
 			RTE_CRYPTODEV_FF_OOP_SGL_IN_LB_OUT |
-			RTE_CRYPTODEV_FF_OOP_LB_IN_LB_OUT;
+			RTE_CRYPTODEV_FF_OOP_LB_IN_LB_OUT |
+			RTE_CRYPTODEV_FF_SYM_CPU_CRYPTO;
 
 	/* Check CPU for support for AES instruction set */
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AES))
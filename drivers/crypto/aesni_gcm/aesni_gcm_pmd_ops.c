@@ -333,7 +333,8 @@ struct rte_cryptodev_ops aesni_gcm_pmd_ops = {
 
 		.sym_session_get_size	= aesni_gcm_pmd_sym_session_get_size,
 		.sym_session_configure	= aesni_gcm_pmd_sym_session_configure,
-		.sym_session_clear	= aesni_gcm_pmd_sym_session_clear
+		.sym_session_clear	= aesni_gcm_pmd_sym_session_clear,
+		.sym_cpu_process	= aesni_gcm_pmd_cpu_crypto_process
 };
 
 struct rte_cryptodev_ops *rte_aesni_gcm_pmd_ops = &aesni_gcm_pmd_ops;
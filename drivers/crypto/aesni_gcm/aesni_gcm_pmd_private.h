@@ -110,6 +110,17 @@ aesni_gcm_set_session_parameters(const struct aesni_gcm_ops *ops,
 		const struct rte_crypto_sym_xform *xform);
 
 
+/**
+ * Process a vector of operations synchronously on the calling lcore.
+ *
+ * @return
+ * - Number of operations successfully processed
+ */
+extern uint32_t
+aesni_gcm_pmd_cpu_crypto_process(struct rte_cryptodev *dev,
+	struct rte_cryptodev_sym_session *sess, union rte_crypto_sym_ofs ofs,
+	struct rte_crypto_sym_vec *vec);
+
 /**
  * Device specific operations function pointer structure */
 extern struct rte_cryptodev_ops *rte_aesni_gcm_pmd_ops;
@@ -174,6 +174,8 @@ struct aesni_mb_qp {
 	 * by the driver when verifying a digest provided
 	 * by the user (using authentication verify operation)
 	 */
+	struct rte_cryptodev_raw_cpl_ring *raw_cpl;
+	/**< Completions of raw data-path operations */
 } __rte_cache_aligned;
 
 /** AES-NI multi-buffer private session structure */
@@ -267,11 +269,23 @@ struct aesni_mb_session {
 	} aead;
 } __rte_cache_aligned;
 
+/** AES-NI multi-buffer raw data-path context private data */
+struct aesni_mb_raw_ctx {
+	struct aesni_mb_session *sess;
+	/**< Session of the operations */
+};
+
 extern int
 aesni_mb_set_session_parameters(const MB_MGR *mb_mgr,
 		struct aesni_mb_session *sess,
 		const struct rte_crypto_sym_xform *xform);
 
+/** Configure a raw data-path context */
+extern int
+aesni_mb_pmd_configure_raw_dp_ctx(struct rte_cryptodev *dev, uint16_t qp_id,
+		struct rte_crypto_raw_dp_ctx *ctx,
+		struct rte_cryptodev_sym_session *sess);
+
 /** device specific operations function pointer structure */
 extern struct rte_cryptodev_ops *rte_aesni_mb_pmd_ops;
 
@@ -809,31 +809,16 @@ auth_start_offset(struct rte_crypto_op *op, struct aesni_mb_session *session,
 }
 
 /**
- * Process a crypto operation and complete a JOB_AES_HMAC job structure for
- * submission to the multi buffer library for processing.
+ * Set the session dependent parameters of a JOB_AES_HMAC job structure,
+ * common to crypto operations and raw data-path operations.
  *
- * @param	qp	queue pair
  * @param	job	JOB_AES_HMAC structure to fill
- * @param	m	mbuf to process
- *
- * @return
- * - Completed JOB_AES_HMAC structure pointer on success
- * - NULL pointer if completion of JOB_AES_HMAC structure isn't possible
+ * @param	session	session of the operation
  */
-static inline int
-set_mb_job_params(JOB_AES_HMAC *job, struct aesni_mb_qp *qp,
-		struct rte_crypto_op *op, uint8_t *digest_idx)
+static inline void
+set_mb_job_session_params(JOB_AES_HMAC *job,
+		struct aesni_mb_session *session)
 {
-	struct rte_mbuf *m_src = op->sym->m_src, *m_dst;
-	struct aesni_mb_session *session;
-	uint32_t m_offset, oop;
-
-	session = get_session(qp, op);
-	if (session == NULL) {
-		op->status = RTE_CRYPTO_OP_STATUS_INVALID_SESSION;
-		return -1;
-	}
-
 	/* Set crypto operation */
 	job->chain_order = session->chain_order;
 
@@ -859,7 +844,6 @@ set_mb_job_params(JOB_AES_HMAC *job, struct aesni_mb_qp *qp,
 		break;
 
 	case AES_CCM:
-		job->u.CCM.aad = op->sym->aead.aad.data + 18;
 		job->u.CCM.aad_len_in_bytes = session->aead.aad_len;
 		job->aes_enc_key_expanded =
 				session->cipher.expanded_aes_keys.encode;
@@ -878,16 +862,11 @@ set_mb_job_params(JOB_AES_HMAC *job, struct aesni_mb_qp *qp,
 		break;
 
 	case AES_GMAC:
-		if (session->cipher.mode == GCM) {
-			job->u.GCM.aad = op->sym->aead.aad.data;
+		if (session->cipher.mode == GCM)
 			job->u.GCM.aad_len_in_bytes = session->aead.aad_len;
-		} else {
+		else
 			/* For GMAC */
-			job->u.GCM.aad = rte_pktmbuf_mtod_offset(m_src,
-					uint8_t *, op->sym->auth.data.offset);
-			job->u.GCM.aad_len_in_bytes = op->sym->auth.data.length;
 			job->cipher_mode = GCM;
-		}
 		job->aes_enc_key_expanded = &session->cipher.gcm_key;
 		job->aes_dec_key_expanded = &session->cipher.gcm_key;
 		break;
@@ -908,6 +887,55 @@ set_mb_job_params(JOB_AES_HMAC *job, struct aesni_mb_qp *qp,
 				session->cipher.expanded_aes_keys.decode;
 		}
 	}
+}
+
+/**
+ * Process a crypto operation and complete a JOB_AES_HMAC job structure for
+ * submission to the multi buffer library for processing.
+ *
+ * @param	qp	queue pair
+ * @param	job	JOB_AES_HMAC structure to fill
+ * @param	m	mbuf to process
+ *
+ * @return
+ * - Completed JOB_AES_HMAC structure pointer on success
+ * - NULL pointer if completion of JOB_AES_HMAC structure isn't possible
+ */
+static inline int
+set_mb_job_params(JOB_AES_HMAC *job, struct aesni_mb_qp *qp,
+		struct rte_crypto_op *op, uint8_t *digest_idx)
+{
+	struct rte_mbuf *m_src = op->sym->m_src, *m_dst;
+	struct aesni_mb_session *session;
+	uint32_t m_offset, oop;
+
+	session = get_session(qp, op);
+	if (session == NULL) {
+		op->status = RTE_CRYPTO_OP_STATUS_INVALID_SESSION;
+		return -1;
+	}
+
+	set_mb_job_session_params(job, session);
+
+	switch (job->hash_alg) {
+	case AES_CCM:
+		job->u.CCM.aad = op->sym->aead.aad.data + 18;
+		break;
+
+	case AES_GMAC:
+		if (session->cipher.mode == GCM) {
+			job->u.GCM.aad = op->sym->aead.aad.data;
+		} else {
+			/* For GMAC */
+			job->u.GCM.aad = rte_pktmbuf_mtod_offset(m_src,
+					uint8_t *, op->sym->auth.data.offset);
+			job->u.GCM.aad_len_in_bytes = op->sym->auth.data.length;
+		}
+		break;
+
+	default:
+		break;
+	}
 
 	if (!op->sym->m_dst) {
 		/* in-place operation */
@@ -1015,6 +1043,100 @@ set_mb_job_params(JOB_AES_HMAC *job, struct aesni_mb_qp *qp,
 	return 0;
 }
 
+/**
+ * Complete a JOB_AES_HMAC job structure for a raw data-path operation.
+ * The data is processed in place, *ofs* gives the cipher and authentication
+ * regions inside it.
+ *
+ * @return
+ * - 0 on success
+ * - errno value if the operation can't be processed
+ */
+static inline int
+set_mb_job_params_raw(JOB_AES_HMAC *job, struct aesni_mb_qp *qp,
+		struct aesni_mb_session *session,
+		const struct rte_crypto_sgl *sgl, void *iv, void *aad,
+		void *digest, union rte_crypto_sym_ofs ofs, void *user_data,
+		uint8_t *digest_idx)
+{
+	uint8_t *buf;
+	uint32_t len;
+
+	/* Multi-buffer library processes contiguous data only */
+	if (unlikely(sgl->num != 1))
+		return ENOTSUP;
+
+	buf = sgl->vec[0].base;
+	len = sgl->vec[0].len;
+
+	set_mb_job_session_params(job, session);
+
+	/* Set digest output location */
+	if (job->hash_alg != NULL_HASH &&
+			(session->auth.operation == RTE_CRYPTO_AUTH_OP_VERIFY ||
+			session->auth.req_digest_len !=
+				session->auth.gen_digest_len)) {
+		job->auth_tag_output = qp->temp_digests[*digest_idx];
+		*digest_idx = (*digest_idx + 1) % MAX_JOBS;
+	} else
+		job->auth_tag_output = digest;
+
+	job->auth_tag_output_len_in_bytes = session->auth.gen_digest_len;
+	job->iv_len_in_bytes = session->iv.length;
+	job->iv = iv;
+
+	/* Data Parameters */
+	job->src = buf;
+	job->dst = buf + ofs.ofs.cipher.head;
+	job->cipher_start_src_offset_in_bytes = ofs.ofs.cipher.head;
+	job->msg_len_to_cipher_in_bytes = len - ofs.ofs.cipher.head -
+			ofs.ofs.cipher.tail;
+
+	switch (job->hash_alg) {
+	case AES_CCM:
+		job->u.CCM.aad = (uint8_t *)aad + 18;
+		job->hash_start_src_offset_in_bytes =
+				job->cipher_start_src_offset_in_bytes;
+		job->msg_len_to_hash_in_bytes =
+				job->msg_len_to_cipher_in_bytes;
+		job->iv = (uint8_t *)iv + 1;
+		break;
+
+	case AES_GMAC:
+		if (session->cipher.mode == GCM) {
+			job->u.GCM.aad = aad;
+			job->hash_start_src_offset_in_bytes =
+					job->cipher_start_src_offset_in_bytes;
+			job->msg_len_to_hash_in_bytes =
+					job->msg_len_to_cipher_in_bytes;
+		} else {
+			/* For GMAC */
+			job->u.GCM.aad = buf + ofs.ofs.auth.head;
+			job->u.GCM.aad_len_in_bytes = len -
+					ofs.ofs.auth.head - ofs.ofs.auth.tail;
+			job->dst = buf + ofs.ofs.auth.head;
+			job->cipher_start_src_offset_in_bytes =
+					ofs.ofs.auth.head;
+			job->hash_start_src_offset_in_bytes =
+					ofs.ofs.auth.head;
+			job->msg_len_to_cipher_in_bytes = 0;
+			job->msg_len_to_hash_in_bytes = 0;
+		}
+		break;
+
+	default:
+		job->hash_start_src_offset_in_bytes = ofs.ofs.auth.head;
+		job->msg_len_to_hash_in_bytes = len - ofs.ofs.auth.head -
+				ofs.ofs.auth.tail;
+	}
+
+	/* Keep user data and digest for the completion */
+	job->user_data = user_data;
+	job->user_data2 = digest;
+
+	return 0;
+}
+
 static inline void
 verify_digest(JOB_AES_HMAC *job, void *digest, uint16_t len, uint8_t *status)
 {
@@ -1152,6 +1274,48 @@ flush_mb_mgr(struct aesni_mb_qp *qp, struct rte_crypto_op **ops,
 	return processed_ops;
 }
 
+/**
+ * Process a completed raw data-path job.
+ *
+ * @return
+ * - 0 on success, errno value otherwise
+ */
+static inline int32_t
+post_process_mb_job_raw(JOB_AES_HMAC *job, struct aesni_mb_session *sess)
+{
+	void *digest = job->user_data2;
+
+	if (unlikely(job->status != STS_COMPLETED))
+		return EINVAL;
+
+	if (job->hash_alg == NULL_HASH)
+		return 0;
+
+	if (sess->auth.operation == RTE_CRYPTO_AUTH_OP_VERIFY) {
+		if (memcmp(job->auth_tag_output, digest,
+				sess->auth.req_digest_len) != 0)
+			return EBADMSG;
+	} else if (sess->auth.req_digest_len != sess->auth.gen_digest_len)
+		memcpy(digest, job->auth_tag_output, sess->auth.req_digest_len);
+
+	return 0;
+}
+
+/**
+ * Place completed raw data-path jobs on the completion ring, until
+ * get_completed_job returns NULL.
+ */
+static inline void
+handle_completed_jobs_raw(struct aesni_mb_qp *qp,
+		struct aesni_mb_session *sess, JOB_AES_HMAC *job)
+{
+	while (job != NULL) {
+		rte_cryptodev_raw_cpl_ring_put(qp->raw_cpl, job->user_data,
+				post_process_mb_job_raw(job, sess));
+		job = IMB_GET_COMPLETED_JOB(qp->mb_mgr);
+	}
+}
+
 static inline JOB_AES_HMAC *
 set_job_null_op(JOB_AES_HMAC *job, struct rte_crypto_op *op)
 {
@@ -1239,6 +1403,111 @@ aesni_mb_pmd_dequeue_burst(void *queue_pair, struct rte_crypto_op **ops,
 	return processed_jobs;
 }
 
+/**
+ * Enqueue burst of raw data-path operations. The jobs are submitted to the
+ * multi buffer library and flushed before returning, so all the enqueued
+ * operations are completed.
+ */
+static uint32_t
+aesni_mb_pmd_raw_enqueue_burst(void *qp_data, uint8_t *drv_ctx,
+		struct rte_crypto_sym_vec *vec, union rte_crypto_sym_ofs ofs,
+		void *user_data[])
+{
+	struct aesni_mb_qp *qp = qp_data;
+	struct aesni_mb_raw_ctx *ctx = (struct aesni_mb_raw_ctx *)drv_ctx;
+	JOB_AES_HMAC *job;
+	uint32_t i, n;
+	int32_t status;
+
+	n = RTE_MIN(vec->num,
+		rte_cryptodev_raw_cpl_ring_free_count(qp->raw_cpl));
+
+	uint8_t digest_idx = qp->digest_idx;
+	for (i = 0; i != n; i++) {
+		/* Get next free mb job struct from mb manager */
+		job = IMB_GET_NEXT_JOB(qp->mb_mgr);
+		if (unlikely(job == NULL)) {
+			/* if no free mb job structs we need to flush mb_mgr */
+			handle_completed_jobs_raw(qp, ctx->sess,
+					IMB_FLUSH_JOB(qp->mb_mgr));
+			job = IMB_GET_NEXT_JOB(qp->mb_mgr);
+		}
+
+		status = set_mb_job_params_raw(job, qp, ctx->sess,
+				&vec->sgl[i], vec->iv[i], vec->aad[i],
+				vec->digest[i], ofs, user_data[i],
+				&digest_idx);
+		if (unlikely(status != 0)) {
+			rte_cryptodev_raw_cpl_ring_put(qp->raw_cpl,
+					user_data[i], status);
+			continue;
+		}
+
+		/* Submit job to multi-buffer for processing */
+#ifdef RTE_LIBRTE_PMD_AESNI_MB_DEBUG
+		job = IMB_SUBMIT_JOB(qp->mb_mgr);
+#else
+		job = IMB_SUBMIT_JOB_NOCHECK(qp->mb_mgr);
+#endif
+		handle_completed_jobs_raw(qp, ctx->sess, job);
+	}
+
+	/* Flush the remaining jobs */
+	while ((job = IMB_FLUSH_JOB(qp->mb_mgr)) != NULL)
+		handle_completed_jobs_raw(qp, ctx->sess, job);
+
+	qp->digest_idx = digest_idx;
+	qp->stats.enqueued_count += n;
+
+	return n;
+}
+
+/** Dequeue burst of raw data-path operations */
+static uint32_t
+aesni_mb_pmd_raw_dequeue_burst(void *qp_data,
+		uint8_t *drv_ctx __rte_unused, void *user_data[],
+		int32_t status[], uint32_t max)
+{
+	struct aesni_mb_qp *qp = qp_data;
+	uint32_t n;
+
+	n = rte_cryptodev_raw_cpl_ring_get(qp->raw_cpl, user_data, status,
+			max);
+	qp->stats.dequeued_count += n;
+
+	return n;
+}
+
+/** Configure a raw data-path context */
+int
+aesni_mb_pmd_configure_raw_dp_ctx(struct rte_cryptodev *dev, uint16_t qp_id,
+		struct rte_crypto_raw_dp_ctx *ctx,
+		struct rte_cryptodev_sym_session *sess)
+{
+	struct aesni_mb_qp *qp = dev->data->queue_pairs[qp_id];
+	struct aesni_mb_raw_ctx *raw_ctx =
+			(struct aesni_mb_raw_ctx *)ctx->drv_ctx_data;
+
+	raw_ctx->sess = get_sym_session_private_data(sess,
+			cryptodev_driver_id);
+	if (raw_ctx->sess == NULL)
+		return -EINVAL;
+
+	if (qp->raw_cpl == NULL) {
+		qp->raw_cpl = rte_cryptodev_raw_cpl_ring_create(
+				rte_ring_get_size(qp->ingress_queue),
+				dev->data->socket_id);
+		if (qp->raw_cpl == NULL)
+			return -ENOMEM;
+	}
+
+	ctx->qp_data = qp;
+	ctx->enqueue_burst = aesni_mb_pmd_raw_enqueue_burst;
+	ctx->dequeue_burst = aesni_mb_pmd_raw_dequeue_burst;
+
+	return 0;
+}
+
 static int cryptodev_aesni_mb_remove(struct rte_vdev_device *vdev);
 
 static int
@@ -1276,7 +1545,8 @@ cryptodev_aesni_mb_create(const char *name,
 
 	dev->feature_flags = RTE_CRYPTODEV_FF_SYMMETRIC_CRYPTO |
 			RTE_CRYPTODEV_FF_SYM_OPERATION_CHAINING |
-			RTE_CRYPTODEV_FF_OOP_LB_IN_LB_OUT;
+			RTE_CRYPTODEV_FF_OOP_LB_IN_LB_OUT |
+			RTE_CRYPTODEV_FF_SYM_RAW_DP;
 
 	/* Check CPU for support for AES instruction set */
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AES))
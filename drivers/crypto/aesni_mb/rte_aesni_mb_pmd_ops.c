@@ -586,6 +586,7 @@ aesni_mb_pmd_qp_release(struct rte_cryptodev *dev, uint16_t qp_id)
 			rte_ring_free(r);
 		if (qp->mb_mgr)
 			free_mb_mgr(qp->mb_mgr);
+		rte_cryptodev_raw_cpl_ring_free(qp->raw_cpl);
 		rte_free(qp);
 		dev->data->queue_pairs[qp_id] = NULL;
 	}
@@ -773,6 +774,13 @@ aesni_mb_pmd_sym_session_configure(struct rte_cryptodev *dev,
 	return 0;
 }
 
+/** Returns the size of the raw data-path context private data */
+static int
+aesni_mb_pmd_get_raw_dp_ctx_size(struct rte_cryptodev *dev __rte_unused)
+{
+	return sizeof(struct aesni_mb_raw_ctx);
+}
+
 /** Clear the memory of session so it doesn't leave key material behind */
 static void
 aesni_mb_pmd_sym_session_clear(struct rte_cryptodev *dev,
@@ -807,7 +815,10 @@ struct rte_cryptodev_ops aesni_mb_pmd_ops = {
 
 		.sym_session_get_size	= aesni_mb_pmd_sym_session_get_size,
 		.sym_session_configure	= aesni_mb_pmd_sym_session_configure,
-		.sym_session_clear	= aesni_mb_pmd_sym_session_clear
+		.sym_session_clear	= aesni_mb_pmd_sym_session_clear,
+
+		.sym_get_raw_dp_ctx_size = aesni_mb_pmd_get_raw_dp_ctx_size,
+		.sym_configure_raw_dp_ctx = aesni_mb_pmd_configure_raw_dp_ctx
 };
 
 struct rte_cryptodev_ops *rte_aesni_mb_pmd_ops = &aesni_mb_pmd_ops;
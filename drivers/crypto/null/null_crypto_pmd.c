@@ -155,6 +155,68 @@ null_crypto_pmd_dequeue_burst(void *queue_pair, struct rte_crypto_op **ops,
 	return nb_dequeued;
 }
 
+/** Enqueue burst of raw data-path operations */
+static uint32_t
+null_crypto_pmd_raw_enqueue_burst(void *qp_data,
+		uint8_t *drv_ctx __rte_unused, struct rte_crypto_sym_vec *vec,
+		union rte_crypto_sym_ofs ofs __rte_unused, void *user_data[])
+{
+	struct null_crypto_qp *qp = qp_data;
+	uint32_t i, n;
+
+	n = RTE_MIN(vec->num,
+		rte_cryptodev_raw_cpl_ring_free_count(qp->raw_cpl));
+
+	/* nothing to process, complete the operations straight away */
+	for (i = 0; i != n; i++)
+		rte_cryptodev_raw_cpl_ring_put(qp->raw_cpl, user_data[i], 0);
+
+	qp->qp_stats.enqueued_count += n;
+	return n;
+}
+
+/** Dequeue burst of raw data-path operations */
+static uint32_t
+null_crypto_pmd_raw_dequeue_burst(void *qp_data,
+		uint8_t *drv_ctx __rte_unused, void *user_data[],
+		int32_t status[], uint32_t max)
+{
+	struct null_crypto_qp *qp = qp_data;
+	uint32_t n;
+
+	n = rte_cryptodev_raw_cpl_ring_get(qp->raw_cpl, user_data, status,
+			max);
+	qp->qp_stats.dequeued_count += n;
+
+	return n;
+}
+
+/** Configure a raw data-path context */
+int
+null_crypto_pmd_configure_raw_dp_ctx(struct rte_cryptodev *dev,
+		uint16_t qp_id, struct rte_crypto_raw_dp_ctx *ctx,
+		struct rte_cryptodev_sym_session *sess)
+{
+	struct null_crypto_qp *qp = dev->data->queue_pairs[qp_id];
+
+	if (get_sym_session_private_data(sess, dev->driver_id) == NULL)
+		return -EINVAL;
+
+	if (qp->raw_cpl == NULL) {
+		qp->raw_cpl = rte_cryptodev_raw_cpl_ring_create(
+				rte_ring_get_size(qp->processed_pkts),
+				dev->data->socket_id);
+		if (qp->raw_cpl == NULL)
+			return -ENOMEM;
+	}
+
+	ctx->qp_data = qp;
+	ctx->enqueue_burst = null_crypto_pmd_raw_enqueue_burst;
+	ctx->dequeue_burst = null_crypto_pmd_raw_dequeue_burst;
+
+	return 0;
+}
+
 /** Create crypto device */
 static int
 cryptodev_null_create(const char *name,
@@ -178,7 +240,8 @@ cryptodev_null_create(const char *name,
 
 	dev->feature_flags = RTE_CRYPTODEV_FF_SYMMETRIC_CRYPTO |
 			RTE_CRYPTODEV_FF_SYM_OPERATION_CHAINING |
-			RTE_CRYPTODEV_FF_IN_PLACE_SGL;
+			RTE_CRYPTODEV_FF_IN_PLACE_SGL |
+			RTE_CRYPTODEV_FF_SYM_RAW_DP;
 
 	internals = dev->data->dev_private;
 
@@ -138,6 +138,8 @@ null_crypto_pmd_qp_release(struct rte_cryptodev *dev, uint16_t qp_id)
 		if (qp->processed_pkts)
 			rte_ring_free(qp->processed_pkts);
 
+		rte_cryptodev_raw_cpl_ring_free(qp->raw_cpl);
+
 		rte_free(dev->data->queue_pairs[qp_id]);
 		dev->data->queue_pairs[qp_id] = NULL;
 	}
@@ -297,6 +299,13 @@ null_crypto_pmd_sym_session_configure(struct rte_cryptodev *dev __rte_unused,
 	return 0;
 }
 
+/** Returns the size of the raw data-path context private data */
+static int
+null_crypto_pmd_get_raw_dp_ctx_size(struct rte_cryptodev *dev __rte_unused)
+{
+	return 0;
+}
+
 /** Clear the memory of session so it doesn't leave key material behind */
 static void
 null_crypto_pmd_sym_session_clear(struct rte_cryptodev *dev,
@@ -331,7 +340,10 @@ static struct rte_cryptodev_ops pmd_ops = {
 
 		.sym_session_get_size	= null_crypto_pmd_sym_session_get_size,
 		.sym_session_configure	= null_crypto_pmd_sym_session_configure,
-		.sym_session_clear	= null_crypto_pmd_sym_session_clear
+		.sym_session_clear	= null_crypto_pmd_sym_session_clear,
+
+		.sym_get_raw_dp_ctx_size = null_crypto_pmd_get_raw_dp_ctx_size,
+		.sym_configure_raw_dp_ctx = null_crypto_pmd_configure_raw_dp_ctx
 };
 
 struct rte_cryptodev_ops *null_crypto_pmd_ops = &pmd_ops;
@@ -35,6 +35,8 @@ struct null_crypto_qp {
 	/**< Session Mempool */
 	struct rte_cryptodev_stats qp_stats;
 	/**< Queue pair statistics */
+	struct rte_cryptodev_raw_cpl_ring *raw_cpl;
+	/**< Completions of raw data-path operations */
 } __rte_cache_aligned;
 
 
@@ -48,6 +50,12 @@ extern int
 null_crypto_set_session_parameters(struct null_crypto_session *sess,
 		const struct rte_crypto_sym_xform *xform);
 
+/** Configure a raw data-path context */
+extern int
+null_crypto_pmd_configure_raw_dp_ctx(struct rte_cryptodev *dev,
+		uint16_t qp_id, struct rte_crypto_raw_dp_ctx *ctx,
+		struct rte_cryptodev_sym_session *sess);
+
 /** device specific operations function pointer structure */
 extern struct rte_cryptodev_ops *null_crypto_pmd_ops;
 
@@ -73,6 +73,8 @@ struct openssl_qp {
 	 * by the driver when verifying a digest provided
 	 * by the user (using authentication verify operation)
 	 */
+	struct rte_cryptodev_raw_cpl_ring *raw_cpl;
+	/**< Completions of raw data-path operations */
 } __rte_cache_aligned;
 
 /** OPENSSL crypto private session structure */
@@ -147,6 +149,12 @@ struct openssl_session {
 
 } __rte_cache_aligned;
 
+/** OPENSSL raw data-path context private data */
+struct openssl_raw_ctx {
+	struct openssl_session *sess;
+	/**< Session of the operations */
+};
+
 /** OPENSSL crypto private asymmetric session structure */
 struct openssl_asym_session {
 	enum rte_crypto_asym_xform_type xfrm_type;
@@ -181,6 +189,12 @@ openssl_set_session_parameters(struct openssl_session *sess,
 extern void
 openssl_reset_session(struct openssl_session *sess);
 
+/** Configure a raw data-path context */
+extern int
+openssl_pmd_configure_raw_dp_ctx(struct rte_cryptodev *dev, uint16_t qp_id,
+		struct rte_crypto_raw_dp_ctx *ctx,
+		struct rte_cryptodev_sym_session *sess);
+
 /** device specific operations function pointer structure */
 extern struct rte_cryptodev_ops *rte_openssl_pmd_ops;
 
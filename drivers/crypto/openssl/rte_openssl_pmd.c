@@ -2099,6 +2099,296 @@ process_op(struct openssl_qp *qp, struct rte_crypto_op *op,
 	return retval;
 }
 
+/*
+ *------------------------------------------------------------------------------
+ * Raw data-path
+ *------------------------------------------------------------------------------
+ */
+
+/** Process cipher of a contiguous raw buffer, in place */
+static int
+process_openssl_raw_cipher(struct openssl_session *sess, uint8_t *data,
+		int len, uint8_t *iv)
+{
+	EVP_CIPHER_CTX *ctx;
+	int totlen, status = -EINVAL;
+
+	if (sess->cipher.mode != OPENSSL_CIPHER_LIB)
+		return -ENOTSUP;
+
+	ctx = EVP_CIPHER_CTX_new();
+	EVP_CIPHER_CTX_copy(ctx, sess->cipher.ctx);
+
+	if (sess->cipher.direction == RTE_CRYPTO_CIPHER_OP_ENCRYPT) {
+		if (EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, iv) <= 0)
+			goto process_raw_cipher_err;
+		EVP_CIPHER_CTX_set_padding(ctx, 0);
+		if (EVP_EncryptUpdate(ctx, data, &totlen, data, len) <= 0)
+			goto process_raw_cipher_err;
+		if (EVP_EncryptFinal_ex(ctx, data + totlen, &totlen) <= 0)
+			goto process_raw_cipher_err;
+	} else {
+		if (EVP_DecryptInit_ex(ctx, NULL, NULL, NULL, iv) <= 0)
+			goto process_raw_cipher_err;
+		EVP_CIPHER_CTX_set_padding(ctx, 0);
+		if (EVP_DecryptUpdate(ctx, data, &totlen, data, len) <= 0)
+			goto process_raw_cipher_err;
+		if (EVP_DecryptFinal_ex(ctx, data + totlen, &totlen) <= 0)
+			goto process_raw_cipher_err;
+	}
+	status = 0;
+
+process_raw_cipher_err:
+	EVP_CIPHER_CTX_free(ctx);
+	return status;
+}
+
+/** Process auth of a contiguous raw buffer, generating or verifying digest */
+static int
+process_openssl_raw_auth(struct openssl_qp *qp, struct openssl_session *sess,
+		const uint8_t *data, int len, uint8_t *digest)
+{
+	EVP_MD_CTX *ctx_a;
+	HMAC_CTX *ctx_h;
+	unsigned int dstlen;
+	uint8_t *dst = qp->temp_digest;
+	int status = -EINVAL;
+
+	switch (sess->auth.mode) {
+	case OPENSSL_AUTH_AS_AUTH:
+		ctx_a = EVP_MD_CTX_create();
+		EVP_MD_CTX_copy_ex(ctx_a, sess->auth.auth.ctx);
+		if (EVP_DigestInit_ex(ctx_a, sess->auth.auth.evp_algo,
+				NULL) > 0 &&
+				EVP_DigestUpdate(ctx_a, data, len) > 0 &&
+				EVP_DigestFinal_ex(ctx_a, dst, &dstlen) > 0)
+			status = 0;
+		EVP_MD_CTX_destroy(ctx_a);
+		break;
+	case OPENSSL_AUTH_AS_HMAC:
+		ctx_h = HMAC_CTX_new();
+		HMAC_CTX_copy(ctx_h, sess->auth.hmac.ctx);
+		if (HMAC_Update(ctx_h, data, len) == 1 &&
+				HMAC_Final(ctx_h, dst, &dstlen) == 1)
+			status = 0;
+		HMAC_CTX_free(ctx_h);
+		break;
+	default:
+		break;
+	}
+
+	if (status != 0)
+		return status;
+
+	if (sess->auth.operation == RTE_CRYPTO_AUTH_OP_VERIFY) {
+		if (CRYPTO_memcmp(dst, digest, sess->auth.digest_length) != 0)
+			return -EBADMSG;
+	} else
+		memcpy(digest, dst, sess->auth.digest_length);
+
+	return 0;
+}
+
+/** Process AEAD or GMAC of a contiguous raw buffer, in place */
+static int
+process_openssl_raw_combined(struct openssl_session *sess, uint8_t *data,
+		int len, uint8_t *aad, int aadlen, uint8_t *iv, uint8_t *tag)
+{
+	EVP_CIPHER_CTX *ctx;
+	int unused, ccm, tag_ctrl, status = -EINVAL;
+	int taglen = sess->auth.digest_length;
+
+	if (sess->auth.algo == RTE_CRYPTO_AUTH_AES_GMAC ||
+			sess->aead_algo == RTE_CRYPTO_AEAD_AES_GCM) {
+		ccm = 0;
+	} else {
+		/* CCM nonce and AAD start after the reserved bytes */
+		ccm = 1;
+		iv += 1;
+		aad += 18;
+	}
+	tag_ctrl = sess->cipher.direction == RTE_CRYPTO_CIPHER_OP_ENCRYPT ?
+			EVP_CTRL_GCM_GET_TAG : EVP_CTRL_GCM_SET_TAG;
+
+	ctx = EVP_CIPHER_CTX_new();
+	EVP_CIPHER_CTX_copy(ctx, sess->cipher.ctx);
+
+	if (sess->cipher.direction == RTE_CRYPTO_CIPHER_OP_ENCRYPT) {
+		if (EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, iv) <= 0)
+			goto process_raw_combined_err;
+		if (ccm && EVP_EncryptUpdate(ctx, NULL, &unused, NULL,
+				len) <= 0)
+			goto process_raw_combined_err;
+		if (aadlen > 0 && EVP_EncryptUpdate(ctx, NULL, &unused, aad,
+				aadlen) <= 0)
+			goto process_raw_combined_err;
+		if (len > 0 && EVP_EncryptUpdate(ctx, data, &unused, data,
+				len) <= 0)
+			goto process_raw_combined_err;
+		if (EVP_EncryptFinal_ex(ctx, data, &unused) <= 0)
+			goto process_raw_combined_err;
+		if (EVP_CIPHER_CTX_ctrl(ctx, tag_ctrl, taglen, tag) <= 0)
+			goto process_raw_combined_err;
+	} else {
+		if (EVP_CIPHER_CTX_ctrl(ctx, tag_ctrl, taglen, tag) <= 0)
+			goto process_raw_combined_err;
+		if (EVP_DecryptInit_ex(ctx, NULL, NULL, NULL, iv) <= 0)
+			goto process_raw_combined_err;
+		if (ccm && EVP_DecryptUpdate(ctx, NULL, &unused, NULL,
+				len) <= 0)
+			goto process_raw_combined_err;
+		if (aadlen > 0 && EVP_DecryptUpdate(ctx, NULL, &unused, aad,
+				aadlen) <= 0)
+			goto process_raw_combined_err;
+		/* CCM verifies the tag in the update of the payload */
+		if ((len > 0 || ccm) && EVP_DecryptUpdate(ctx, data, &unused,
+				data, len) <= 0) {
+			status = ccm ? -EBADMSG : -EINVAL;
+			goto process_raw_combined_err;
+		}
+		if (!ccm && EVP_DecryptFinal_ex(ctx, data, &unused) <= 0) {
+			status = -EBADMSG;
+			goto process_raw_combined_err;
+		}
+	}
+	status = 0;
+
+process_raw_combined_err:
+	EVP_CIPHER_CTX_free(ctx);
+	return status;
+}
+
+/** Process one raw data-path element, returning its completion status */
+static int32_t
+process_openssl_raw_op(struct openssl_qp *qp, struct openssl_session *sess,
+		const struct rte_crypto_sgl *sgl, uint8_t *iv, uint8_t *aad,
+		uint8_t *digest, union rte_crypto_sym_ofs ofs)
+{
+	uint8_t *data, *cipher, *auth;
+	int cipher_len, auth_len, status;
+
+	/* Raw operations are processed on contiguous data only */
+	if (sgl->num != 1)
+		return ENOTSUP;
+
+	data = sgl->vec[0].base;
+	cipher = data + ofs.ofs.cipher.head;
+	cipher_len = sgl->vec[0].len - ofs.ofs.cipher.head -
+			ofs.ofs.cipher.tail;
+	auth = data + ofs.ofs.auth.head;
+	auth_len = sgl->vec[0].len - ofs.ofs.auth.head - ofs.ofs.auth.tail;
+
+	switch (sess->chain_order) {
+	case OPENSSL_CHAIN_ONLY_CIPHER:
+		status = process_openssl_raw_cipher(sess, cipher, cipher_len,
+				iv);
+		break;
+	case OPENSSL_CHAIN_ONLY_AUTH:
+		status = process_openssl_raw_auth(qp, sess, auth, auth_len,
+				digest);
+		break;
+	case OPENSSL_CHAIN_CIPHER_AUTH:
+		status = process_openssl_raw_cipher(sess, cipher, cipher_len,
+				iv);
+		if (status == 0)
+			status = process_openssl_raw_auth(qp, sess, auth,
+					auth_len, digest);
+		break;
+	case OPENSSL_CHAIN_AUTH_CIPHER:
+		status = process_openssl_raw_auth(qp, sess, auth, auth_len,
+				digest);
+		if (status == 0)
+			status = process_openssl_raw_cipher(sess, cipher,
+					cipher_len, iv);
+		break;
+	case OPENSSL_CHAIN_COMBINED:
+		if (sess->auth.algo == RTE_CRYPTO_AUTH_AES_GMAC)
+			status = process_openssl_raw_combined(sess, NULL, 0,
+					auth, auth_len, iv, digest);
+		else
+			status = process_openssl_raw_combined(sess, cipher,
+					cipher_len, aad, sess->auth.aad_length,
+					iv, digest);
+		break;
+	default:
+		status = -ENOTSUP;
+		break;
+	}
+
+	return -status;
+}
+
+/** Enqueue burst of raw data-path operations, processed synchronously */
+static uint32_t
+openssl_pmd_raw_enqueue_burst(void *qp_data, uint8_t *drv_ctx,
+		struct rte_crypto_sym_vec *vec, union rte_crypto_sym_ofs ofs,
+		void *user_data[])
+{
+	struct openssl_qp *qp = qp_data;
+	struct openssl_raw_ctx *ctx = (struct openssl_raw_ctx *)drv_ctx;
+	uint32_t i, n;
+	int32_t status;
+
+	n = RTE_MIN(vec->num, rte_cryptodev_raw_cpl_ring_free_count(
+			qp->raw_cpl));
+
+	for (i = 0; i < n; i++) {
+		status = process_openssl_raw_op(qp, ctx->sess, &vec->sgl[i],
+				vec->iv[i], vec->aad[i], vec->digest[i], ofs);
+		rte_cryptodev_raw_cpl_ring_put(qp->raw_cpl, user_data[i],
+				status);
+	}
+
+	qp->stats.enqueued_count += n;
+	return n;
+}
+
+/** Dequeue burst of raw data-path operations */
+static uint32_t
+openssl_pmd_raw_dequeue_burst(void *qp_data,
+		__rte_unused uint8_t *drv_ctx, void *user_data[],
+		int32_t status[], uint32_t max)
+{
+	struct openssl_qp *qp = qp_data;
+	uint32_t n;
+
+	n = rte_cryptodev_raw_cpl_ring_get(qp->raw_cpl, user_data, status,
+			max);
+	qp->stats.dequeued_count += n;
+	return n;
+}
+
+/** Set up raw data-path context for a queue pair and session */
+int
+openssl_pmd_configure_raw_dp_ctx(struct rte_cryptodev *dev, uint16_t qp_id,
+		struct rte_crypto_raw_dp_ctx *raw_ctx,
+		struct rte_cryptodev_sym_session *sess)
+{
+	struct openssl_qp *qp = dev->data->queue_pairs[qp_id];
+	struct openssl_raw_ctx *ctx = (struct openssl_raw_ctx *)
+			raw_ctx->drv_ctx_data;
+	struct openssl_session *s;
+
+	s = get_sym_session_private_data(sess, cryptodev_driver_id);
+	if (s == NULL)
+		return -EINVAL;
+
+	if (qp->raw_cpl == NULL) {
+		qp->raw_cpl = rte_cryptodev_raw_cpl_ring_create(
+				rte_ring_get_size(qp->processed_ops),
+				dev->data->socket_id);
+		if (qp->raw_cpl == NULL)
+			return -ENOMEM;
+	}
+
+	ctx->sess = s;
+	raw_ctx->qp_data = qp;
+	raw_ctx->enqueue_burst = openssl_pmd_raw_enqueue_burst;
+	raw_ctx->dequeue_burst = openssl_pmd_raw_dequeue_burst;
+
+	return 0;
+}
+
 /*
  *------------------------------------------------------------------------------
  * PMD Framework
@@ -2183,7 +2473,8 @@ cryptodev_openssl_create(const char *name,
 			RTE_CRYPTODEV_FF_OOP_LB_IN_LB_OUT |
 			RTE_CRYPTODEV_FF_ASYMMETRIC_CRYPTO |
 			RTE_CRYPTODEV_FF_RSA_PRIV_OP_KEY_EXP |
-			RTE_CRYPTODEV_FF_RSA_PRIV_OP_KEY_QT;
+			RTE_CRYPTODEV_FF_RSA_PRIV_OP_KEY_QT |
+			RTE_CRYPTODEV_FF_SYM_RAW_DP;
 
 	internals = dev->data->dev_private;
 
@@ -662,6 +662,8 @@ openssl_pmd_qp_release(struct rte_cryptodev *dev, uint16_t qp_id)
 		if (qp->processed_ops)
 			rte_ring_free(qp->processed_ops);
 
+		rte_cryptodev_raw_cpl_ring_free(qp->raw_cpl);
+
 		rte_free(dev->data->queue_pairs[qp_id]);
 		dev->data->queue_pairs[qp_id] = NULL;
 	}
@@ -1159,6 +1161,13 @@ openssl_pmd_asym_session_configure(struct rte_cryptodev *dev __rte_unused,
 	return 0;
 }
 
+/** Returns the size of the raw data-path context private data */
+static int
+openssl_pmd_get_raw_dp_ctx_size(struct rte_cryptodev *dev __rte_unused)
+{
+	return sizeof(struct openssl_raw_ctx);
+}
+
 /** Clear the memory of session so it doesn't leave key material behind */
 static void
 openssl_pmd_sym_session_clear(struct rte_cryptodev *dev,
@@ -1249,7 +1258,10 @@ struct rte_cryptodev_ops openssl_pmd_ops = {
 		.sym_session_configure	= openssl_pmd_sym_session_configure,
 		.asym_session_configure	= openssl_pmd_asym_session_configure,
 		.sym_session_clear	= openssl_pmd_sym_session_clear,
-		.asym_session_clear	= openssl_pmd_asym_session_clear
+		.asym_session_clear	= openssl_pmd_asym_session_clear,
+
+		.sym_get_raw_dp_ctx_size = openssl_pmd_get_raw_dp_ctx_size,
+		.sym_configure_raw_dp_ctx = openssl_pmd_configure_raw_dp_ctx
 };
 
 struct rte_cryptodev_ops *rte_openssl_pmd_ops = &openssl_pmd_ops;
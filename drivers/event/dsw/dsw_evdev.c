@@ -3,10 +3,12 @@
  */
 
 #include <stdbool.h>
+#include <stdlib.h>
 
 #include <rte_cycles.h>
 #include <rte_eventdev_pmd.h>
 #include <rte_eventdev_pmd_vdev.h>
+#include <rte_kvargs.h>
 #include <rte_random.h>
 
 #include "dsw_evdev.h"
@@ -61,10 +63,11 @@ dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	rte_atomic16_init(&port->load);
 
 	port->load_update_interval =
-		(DSW_LOAD_UPDATE_INTERVAL * rte_get_timer_hz()) / US_PER_S;
+		(DSW_LOAD_UPDATE_INTERVAL(dsw->migration_interval) *
+		 rte_get_timer_hz()) / US_PER_S;
 
 	port->migration_interval =
-		(DSW_MIGRATION_INTERVAL * rte_get_timer_hz()) / US_PER_S;
+		(dsw->migration_interval * rte_get_timer_hz()) / US_PER_S;
 
 	dev->data->ports[port_id] = port;
 
@@ -271,6 +274,7 @@ dsw_start(struct rte_eventdev *dev)
 	uint64_t now;
 
 	rte_atomic32_init(&dsw->credits_on_loan);
+	rte_atomic16_init(&dsw->migrations_in_progress);
 
 	initial_flow_to_port_assignment(dsw);
 
@@ -387,12 +391,114 @@ static struct rte_eventdev_ops dsw_evdev_ops = {
 	.xstats_get_by_name = dsw_xstats_get_by_name
 };
 
+static int
+set_load_percent(const char *key __rte_unused, const char *value,
+		 void *opaque)
+{
+	int16_t *load = opaque;
+	int percent = atoi(value);
+
+	if (percent < 0 || percent > 100)
+		return -1;
+	*load = DSW_LOAD_FROM_PERCENT(percent);
+	return 0;
+}
+
+static int
+set_migration_interval(const char *key __rte_unused, const char *value,
+		       void *opaque)
+{
+	uint32_t *interval = opaque;
+	int us = atoi(value);
+
+	/* The load update interval is a quarter of it. */
+	if (us < 4)
+		return -1;
+	*interval = us;
+	return 0;
+}
+
+static int
+set_max_migrations(const char *key __rte_unused, const char *value,
+		   void *opaque)
+{
+	uint16_t *max_migrations = opaque;
+	int max = atoi(value);
+
+	if (max < 0 || max > DSW_MAX_PORTS)
+		return -1;
+	*max_migrations = max;
+	return 0;
+}
+
+static int
+dsw_parse_args(struct dsw_evdev *dsw, const char *name, const char *params)
+{
+	static const char *const args[] = {
+		DSW_MIN_SOURCE_LOAD_ARG,
+		DSW_MAX_TARGET_LOAD_ARG,
+		DSW_MIGRATION_INTERVAL_ARG,
+		DSW_MAX_MIGRATIONS_ARG,
+		NULL
+	};
+	struct rte_kvargs *kvlist;
+	int ret;
+
+	if (params == NULL || params[0] == '\0')
+		return 0;
+
+	kvlist = rte_kvargs_parse(params, args);
+	if (kvlist == NULL) {
+		DSW_LOG(INFO, "Ignoring unsupported parameters when creating "
+			"device '%s'\n", name);
+		return 0;
+	}
+
+	ret = rte_kvargs_process(kvlist, DSW_MIN_SOURCE_LOAD_ARG,
+				 set_load_percent, &dsw->min_source_load);
+	if (ret != 0) {
+		DSW_LOG(ERR, "%s: Error parsing %s parameter\n", name,
+			DSW_MIN_SOURCE_LOAD_ARG);
+		goto out;
+	}
+
+	ret = rte_kvargs_process(kvlist, DSW_MAX_TARGET_LOAD_ARG,
+				 set_load_percent, &dsw->max_target_load);
+	if (ret != 0) {
+		DSW_LOG(ERR, "%s: Error parsing %s parameter\n", name,
+			DSW_MAX_TARGET_LOAD_ARG);
+		goto out;
+	}
+
+	ret = rte_kvargs_process(kvlist, DSW_MIGRATION_INTERVAL_ARG,
+				 set_migration_interval,
+				 &dsw->migration_interval);
+	if (ret != 0) {
+		DSW_LOG(ERR, "%s: Error parsing %s parameter\n", name,
+			DSW_MIGRATION_INTERVAL_ARG);
+		goto out;
+	}
+
+	ret = rte_kvargs_process(kvlist, DSW_MAX_MIGRATIONS_ARG,
+				 set_max_migrations, &dsw->max_migrations);
+	if (ret != 0) {
+		DSW_LOG(ERR, "%s: Error parsing %s parameter\n", name,
+			DSW_MAX_MIGRATIONS_ARG);
+		goto out;
+	}
+
+out:
+	rte_kvargs_free(kvlist);
+	return ret;
+}
+
 static int
 dsw_probe(struct rte_vdev_device *vdev)
 {
 	const char *name;
 	struct rte_eventdev *dev;
 	struct dsw_evdev *dsw;
+	int ret;
 
 	name = rte_vdev_device_name(vdev);
 
@@ -415,6 +521,24 @@ dsw_probe(struct rte_vdev_device *vdev)
 	dsw = dev->data->dev_private;
 	dsw->data = dev->data;
 
+	dsw->min_source_load = DSW_MIN_SOURCE_LOAD_FOR_MIGRATION;
+	dsw->max_target_load = DSW_MAX_TARGET_LOAD_FOR_MIGRATION;
+	dsw->migration_interval = DSW_MIGRATION_INTERVAL;
+	dsw->max_migrations = 0;
+
+	ret = dsw_parse_args(dsw, name, rte_vdev_device_args(vdev));
+	if (ret != 0) {
+		rte_event_pmd_vdev_uninit(name);
+		return -EINVAL;
+	}
+
+	if (dsw->min_source_load > dsw->max_target_load) {
+		DSW_LOG(ERR, "%s: %s must not be above %s\n", name,
+			DSW_MIN_SOURCE_LOAD_ARG, DSW_MAX_TARGET_LOAD_ARG);
+		rte_event_pmd_vdev_uninit(name);
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
@@ -436,3 +560,8 @@ static struct rte_vdev_driver evdev_dsw_pmd_drv = {
 };
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_DSW_PMD, evdev_dsw_pmd_drv);
+RTE_PMD_REGISTER_PARAM_STRING(EVENTDEV_NAME_DSW_PMD,
+	DSW_MIN_SOURCE_LOAD_ARG "=<int> "
+	DSW_MAX_TARGET_LOAD_ARG "=<int> "
+	DSW_MIGRATION_INTERVAL_ARG "=<int> "
+	DSW_MAX_MIGRATIONS_ARG "=<int>");
@@ -70,19 +70,34 @@
  * source ports, to be migrated too quickly to a lightly loaded port -
  * in particular since this might cause the system to oscillate.
  */
-#define DSW_LOAD_UPDATE_INTERVAL (DSW_MIGRATION_INTERVAL/4)
+#define DSW_LOAD_UPDATE_INTERVAL(migration_interval) \
+	((migration_interval)/4)
 #define DSW_OLD_LOAD_WEIGHT (1)
 
+/* Number of past load measurements kept per port, for the
+ * port_<n>_load_history_<m> xstats.
+ */
+#define DSW_LOAD_HISTORY_LEN (16)
+
 /* The minimum time (in us) between two flow migrations. What puts an
  * upper limit on the actual migration rate is primarily the pace in
  * which the ports send and receive control messages, which in turn is
  * largely a function of how much cycles are spent the processing of
  * an event burst.
+ *
+ * The interval and the load thresholds below are defaults, which
+ * may be overridden with devargs.
  */
 #define DSW_MIGRATION_INTERVAL (1000)
 #define DSW_MIN_SOURCE_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(70))
 #define DSW_MAX_TARGET_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(95))
 
+/* Devargs */
+#define DSW_MIN_SOURCE_LOAD_ARG "min_source_load"
+#define DSW_MAX_TARGET_LOAD_ARG "max_target_load"
+#define DSW_MIGRATION_INTERVAL_ARG "migration_interval"
+#define DSW_MAX_MIGRATIONS_ARG "max_migrations"
+
 #define DSW_MAX_EVENTS_RECORDED (128)
 
 /* Only one outstanding migration per port is allowed */
@@ -156,9 +171,15 @@ struct dsw_port {
 	enum dsw_migration_state migration_state;
 
 	uint64_t migration_start;
+	uint64_t migrations_started;
 	uint64_t migrations;
 	uint64_t migration_latency;
 
+	/* Reasons for an overloaded port not to migrate any flow. */
+	uint64_t migrations_aborted_single_flow;
+	uint64_t migrations_aborted_no_target;
+	uint64_t migrations_aborted_limit;
+
 	uint8_t migration_target_port_id;
 	struct dsw_queue_flow migration_target_qf;
 	uint8_t cfm_cnt;
@@ -200,6 +221,10 @@ struct dsw_port {
 
 	/* Estimate of current port load. */
 	rte_atomic16_t load __rte_cache_aligned;
+
+	/* Most recent load estimates, oldest overwritten first. */
+	uint16_t load_history_idx;
+	int16_t load_history[DSW_LOAD_HISTORY_LEN];
 } __rte_cache_aligned;
 
 struct dsw_queue {
@@ -219,7 +244,16 @@ struct dsw_evdev {
 	uint8_t num_queues;
 	int32_t max_inflight;
 
+	/* Migration tuning, set from devargs at probe time. */
+	int16_t min_source_load;
+	int16_t max_target_load;
+	uint32_t migration_interval;
+	uint16_t max_migrations;
+
 	rte_atomic32_t credits_on_loan __rte_cache_aligned;
+
+	/* Ports with a flow migration in progress. */
+	rte_atomic16_t migrations_in_progress __rte_cache_aligned;
 };
 
 #define DSW_CTL_PAUS_REQ (0)
@@ -268,6 +302,11 @@ dsw_pmd_priv(const struct rte_eventdev *eventdev)
 	return eventdev->data->dev_private;
 }
 
+#define DSW_LOG(level, fmt, args...)					\
+	RTE_LOG(level, EVENTDEV, "[%s] %s() line %u: " fmt,		\
+		DSW_PMD_NAME,						\
+		__func__, __LINE__, ## args)
+
 #define DSW_LOG_DP(level, fmt, args...)					\
 	RTE_LOG_DP(level, EVENTDEV, "[%s] %s() line %u: " fmt,		\
 		   DSW_PMD_NAME,					\
@@ -160,6 +160,10 @@ dsw_port_load_update(struct dsw_port *port, uint64_t now)
 		(DSW_OLD_LOAD_WEIGHT+1);
 
 	rte_atomic16_set(&port->load, new_load);
+
+	port->load_history[port->load_history_idx] = new_load;
+	port->load_history_idx =
+		(port->load_history_idx + 1) % DSW_LOAD_HISTORY_LEN;
 }
 
 static void
@@ -628,6 +632,8 @@ dsw_port_end_migration(struct dsw_evdev *dsw, struct dsw_port *port)
 	port->migration_state = DSW_MIGRATION_STATE_IDLE;
 	port->seen_events_len = 0;
 
+	rte_atomic16_dec(&dsw->migrations_in_progress);
+
 	dsw_port_migration_stats(port);
 
 	if (dsw->queues[queue_id].schedule_type != RTE_SCHED_TYPE_PARALLEL) {
@@ -685,11 +691,11 @@ dsw_port_consider_migration(struct dsw_evdev *dsw,
 	}
 
 	source_port_load = rte_atomic16_read(&source_port->load);
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION) {
+	if (source_port_load < dsw->min_source_load) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 				"Load %d is below threshold level %d.\n",
 				DSW_LOAD_TO_PERCENT(source_port_load),
-		       DSW_LOAD_TO_PERCENT(DSW_MIN_SOURCE_LOAD_FOR_MIGRATION));
+				DSW_LOAD_TO_PERCENT(dsw->min_source_load));
 		return;
 	}
 
@@ -698,11 +704,12 @@ dsw_port_consider_migration(struct dsw_evdev *dsw,
 	 */
 	any_port_below_limit =
 		dsw_retrieve_port_loads(dsw, port_loads,
-					DSW_MAX_TARGET_LOAD_FOR_MIGRATION);
+					dsw->max_target_load);
 	if (!any_port_below_limit) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 				"Candidate target ports are all too highly "
 				"loaded.\n");
+		source_port->migrations_aborted_no_target++;
 		return;
 	}
 
@@ -724,6 +731,7 @@ dsw_port_consider_migration(struct dsw_evdev *dsw,
 				"queue_id %d flow_hash %d has been seen.\n",
 				bursts[0].queue_flow.queue_id,
 				bursts[0].queue_flow.flow_hash);
+		source_port->migrations_aborted_single_flow++;
 		return;
 	}
 
@@ -735,16 +743,30 @@ dsw_port_consider_migration(struct dsw_evdev *dsw,
 	 */
 	if (!dsw_select_migration_target(dsw, source_port, bursts, num_bursts,
 					 port_loads,
-					 DSW_MIN_SOURCE_LOAD_FOR_MIGRATION,
+					 dsw->min_source_load,
 					 &source_port->migration_target_qf,
 					 &source_port->migration_target_port_id)
 	    &&
 	    !dsw_select_migration_target(dsw, source_port, bursts, num_bursts,
 					 port_loads,
-					 DSW_MAX_TARGET_LOAD_FOR_MIGRATION,
+					 dsw->max_target_load,
 					 &source_port->migration_target_qf,
-				       &source_port->migration_target_port_id))
+				       &source_port->migration_target_port_id)) {
+		source_port->migrations_aborted_no_target++;
 		return;
+	}
+
+	/* Limit the number of ports migrating at the same time, since
+	 * every migration pauses the flow on all ports.
+	 */
+	if (rte_atomic16_add_return(&dsw->migrations_in_progress, 1) >
+	    dsw->max_migrations && dsw->max_migrations > 0) {
+		DSW_LOG_DP_PORT(DEBUG, source_port->id, "Too many migrations "
+				"already in progress.\n");
+		rte_atomic16_dec(&dsw->migrations_in_progress);
+		source_port->migrations_aborted_limit++;
+		return;
+	}
 
 	DSW_LOG_DP_PORT(DEBUG, source_port->id, "Migrating queue_id %d "
 			"flow_hash %d from port %d to port %d.\n",
@@ -756,6 +778,7 @@ dsw_port_consider_migration(struct dsw_evdev *dsw,
 
 	source_port->migration_state = DSW_MIGRATION_STATE_PAUSING;
 	source_port->migration_start = rte_get_timer_cycles();
+	source_port->migrations_started++;
 
 	/* No need to go through the whole pause procedure for
 	 * parallel queues, since atomic/ordered semantics need not to
@@ -35,14 +35,18 @@ struct dsw_xstat_dev {
 	dsw_xstats_dev_get_value_fn get_value_fn;
 };
 
+/* The parameter of a port xstat is either a queue id, or the age of
+ * a load measurement.
+ */
 typedef
 uint64_t (*dsw_xstats_port_get_value_fn)(struct dsw_evdev *dsw,
-					 uint8_t port_id, uint8_t queue_id);
+					 uint8_t port_id, uint8_t param);
 
 struct dsw_xstats_port {
 	const char *name_fmt;
 	dsw_xstats_port_get_value_fn get_value_fn;
 	bool per_queue;
+	bool per_load_sample;
 };
 
 static uint64_t
@@ -51,8 +55,15 @@ dsw_xstats_dev_credits_on_loan(struct dsw_evdev *dsw)
 	return rte_atomic32_read(&dsw->credits_on_loan);
 }
 
+static uint64_t
+dsw_xstats_dev_migrations_in_progress(struct dsw_evdev *dsw)
+{
+	return rte_atomic16_read(&dsw->migrations_in_progress);
+}
+
 static struct dsw_xstat_dev dsw_dev_xstats[] = {
-	{ "dev_credits_on_loan", dsw_xstats_dev_credits_on_loan }
+	{ "dev_credits_on_loan", dsw_xstats_dev_credits_on_loan },
+	{ "dev_migrations_in_progress", dsw_xstats_dev_migrations_in_progress }
 };
 
 #define DSW_GEN_PORT_ACCESS_FN(_variable)				\
@@ -84,8 +95,25 @@ dsw_xstats_port_get_queue_dequeued(struct dsw_evdev *dsw, uint8_t port_id,
 	return dsw->ports[port_id].queue_dequeued[queue_id];
 }
 
+DSW_GEN_PORT_ACCESS_FN(migrations_started)
+
 DSW_GEN_PORT_ACCESS_FN(migrations)
 
+static uint64_t
+dsw_xstats_port_get_migrations_aborted(struct dsw_evdev *dsw, uint8_t port_id,
+				       uint8_t queue_id __rte_unused)
+{
+	struct dsw_port *port = &dsw->ports[port_id];
+
+	return port->migrations_aborted_single_flow +
+		port->migrations_aborted_no_target +
+		port->migrations_aborted_limit;
+}
+
+DSW_GEN_PORT_ACCESS_FN(migrations_aborted_single_flow)
+DSW_GEN_PORT_ACCESS_FN(migrations_aborted_no_target)
+DSW_GEN_PORT_ACCESS_FN(migrations_aborted_limit)
+
 static uint64_t
 dsw_xstats_port_get_migration_latency(struct dsw_evdev *dsw, uint8_t port_id,
 				      uint8_t queue_id __rte_unused)
@@ -121,35 +149,75 @@ dsw_xstats_port_get_load(struct dsw_evdev *dsw, uint8_t port_id,
 	return DSW_LOAD_TO_PERCENT(load);
 }
 
+static uint64_t
+dsw_xstats_port_get_load_history(struct dsw_evdev *dsw, uint8_t port_id,
+				 uint8_t age)
+{
+	struct dsw_port *port = &dsw->ports[port_id];
+	uint16_t idx;
+
+	/* load_history_idx is where the next measurement goes */
+	idx = (port->load_history_idx + DSW_LOAD_HISTORY_LEN - 1 - age) %
+		DSW_LOAD_HISTORY_LEN;
+
+	return DSW_LOAD_TO_PERCENT(port->load_history[idx]);
+}
+
 DSW_GEN_PORT_ACCESS_FN(last_bg)
 
 static struct dsw_xstats_port dsw_port_xstats[] = {
 	{ "port_%u_new_enqueued", dsw_xstats_port_get_new_enqueued,
-	  false },
+	  false, false },
 	{ "port_%u_forward_enqueued", dsw_xstats_port_get_forward_enqueued,
-	  false },
+	  false, false },
 	{ "port_%u_release_enqueued", dsw_xstats_port_get_release_enqueued,
-	  false },
+	  false, false },
 	{ "port_%u_queue_%u_enqueued", dsw_xstats_port_get_queue_enqueued,
-	  true },
+	  true, false },
 	{ "port_%u_dequeued", dsw_xstats_port_get_dequeued,
-	  false },
+	  false, false },
 	{ "port_%u_queue_%u_dequeued", dsw_xstats_port_get_queue_dequeued,
-	  true },
+	  true, false },
+	{ "port_%u_migrations_started", dsw_xstats_port_get_migrations_started,
+	  false, false },
 	{ "port_%u_migrations", dsw_xstats_port_get_migrations,
-	  false },
+	  false, false },
+	{ "port_%u_migrations_aborted", dsw_xstats_port_get_migrations_aborted,
+	  false, false },
+	{ "port_%u_migrations_aborted_single_flow",
+	  dsw_xstats_port_get_migrations_aborted_single_flow,
+	  false, false },
+	{ "port_%u_migrations_aborted_no_target",
+	  dsw_xstats_port_get_migrations_aborted_no_target,
+	  false, false },
+	{ "port_%u_migrations_aborted_limit",
+	  dsw_xstats_port_get_migrations_aborted_limit,
+	  false, false },
 	{ "port_%u_migration_latency", dsw_xstats_port_get_migration_latency,
-	  false },
+	  false, false },
 	{ "port_%u_event_proc_latency", dsw_xstats_port_get_event_proc_latency,
-	  false },
+	  false, false },
 	{ "port_%u_inflight_credits", dsw_xstats_port_get_inflight_credits,
-	  false },
+	  false, false },
 	{ "port_%u_load", dsw_xstats_port_get_load,
-	  false },
+	  false, false },
+	{ "port_%u_load_history_%u", dsw_xstats_port_get_load_history,
+	  false, true },
 	{ "port_%u_last_bg", dsw_xstats_port_get_last_bg,
-	  false }
+	  false, false }
 };
 
+static unsigned int
+dsw_xstats_port_num_params(struct dsw_evdev *dsw,
+			   const struct dsw_xstats_port *xstat)
+{
+	if (xstat->per_queue)
+		return dsw->num_queues;
+	if (xstat->per_load_sample)
+		return DSW_LOAD_HISTORY_LEN;
+	return 0;
+}
+
 static int
 dsw_xstats_dev_get_names(struct rte_event_dev_xstats_name *xstats_names,
 			 unsigned int *ids, unsigned int size)
@@ -169,7 +237,8 @@ dsw_xstats_port_get_names(struct dsw_evdev *dsw, uint8_t port_id,
 			  struct rte_event_dev_xstats_name *xstats_names,
 			  unsigned int *ids, unsigned int size)
 {
-	uint8_t queue_id = 0;
+	unsigned int param = 0;
+	unsigned int num_params;
 	unsigned int id_idx;
 	unsigned int stat_idx;
 
@@ -178,13 +247,15 @@ dsw_xstats_port_get_names(struct dsw_evdev *dsw, uint8_t port_id,
 	     id_idx++) {
 		struct dsw_xstats_port *xstat = &dsw_port_xstats[stat_idx];
 
-		if (xstat->per_queue) {
-			ids[id_idx] = DSW_XSTATS_ID_CREATE(stat_idx, queue_id);
+		num_params = dsw_xstats_port_num_params(dsw, xstat);
+
+		if (xstat->per_queue || xstat->per_load_sample) {
+			ids[id_idx] = DSW_XSTATS_ID_CREATE(stat_idx, param);
 			snprintf(xstats_names[id_idx].name,
 				 RTE_EVENT_DEV_XSTATS_NAME_SIZE,
 				 dsw_port_xstats[stat_idx].name_fmt, port_id,
-				 queue_id);
-			queue_id++;
+				 param);
+			param++;
 		} else {
 			ids[id_idx] = stat_idx;
 			snprintf(xstats_names[id_idx].name,
@@ -192,9 +263,9 @@ dsw_xstats_port_get_names(struct dsw_evdev *dsw, uint8_t port_id,
 				 dsw_port_xstats[stat_idx].name_fmt, port_id);
 		}
 
-		if (!(xstat->per_queue && queue_id < dsw->num_queues)) {
+		if (param >= num_params) {
 			stat_idx++;
-			queue_id = 0;
+			param = 0;
 		}
 	}
 	return id_idx;
@@ -249,12 +320,12 @@ dsw_xstats_port_get(const struct rte_eventdev *dev, uint8_t port_id,
 		unsigned int id = ids[i];
 		unsigned int stat_idx = DSW_XSTATS_ID_GET_STAT(id);
 		struct dsw_xstats_port *xstat = &dsw_port_xstats[stat_idx];
-		uint8_t queue_id = 0;
+		uint8_t param = 0;
 
-		if (xstat->per_queue)
-			queue_id = DSW_XSTATS_ID_GET_PARAM(id);
+		if (xstat->per_queue || xstat->per_load_sample)
+			param = DSW_XSTATS_ID_GET_PARAM(id);
 
-		values[i] = xstat->get_value_fn(dsw, port_id, queue_id);
+		values[i] = xstat->get_value_fn(dsw, port_id, param);
 	}
 	return n;
 }
@@ -19,6 +19,7 @@
 #define NUMA_NODE_ARG "numa_node"
 #define SCHED_QUANTA_ARG "sched_quanta"
 #define CREDIT_QUANTA_ARG "credit_quanta"
+#define SCHED_SHARDS_ARG "sched_shards"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
@@ -115,6 +116,8 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 	}
 
 	p->unlinks_in_progress += unlinked;
+	for (i = 1; i < sw->nb_shards; i++)
+		sw->shards[i].ports[p->id].unlinks_in_progress += unlinked;
 	rte_smp_mb();
 
 	return unlinked;
@@ -123,9 +126,81 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 static int
 sw_port_unlinks_in_progress(struct rte_eventdev *dev, void *port)
 {
-	RTE_SET_USED(dev);
+	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_port *p = port;
-	return p->unlinks_in_progress;
+	int unlinks = p->unlinks_in_progress;
+	unsigned int i;
+
+	/* each shard acks the unlinks separately, they are done once all
+	 * shards have acked them
+	 */
+	for (i = 1; i < sw->nb_shards; i++)
+		unlinks = RTE_MAX(unlinks, (int)sw->shards[i].ports[p->id]
+				.unlinks_in_progress);
+
+	return unlinks;
+}
+
+/* Set up the rings and scheduler state of a port for one of the additional
+ * scheduler shards. Shard zero uses the port itself.
+ */
+static int
+sw_shard_port_setup(struct rte_eventdev *dev, struct sw_shard *s,
+		uint8_t port_id, const struct rte_event_port_conf *conf)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	struct sw_port *p = &sw->ports[port_id];
+	struct sw_port *sp = &s->ports[port_id];
+	struct rte_event_ring *existing_ring;
+	char buf[RTE_RING_NAMESIZE];
+	unsigned int i;
+
+	memset(sp, 0, sizeof(*sp));
+	sp->id = port_id;
+	sp->sw = sw;
+
+	snprintf(buf, sizeof(buf), "sw%d_p%u_s%u_rx", dev->data->dev_id,
+			port_id, s->id);
+	existing_ring = rte_event_ring_lookup(buf);
+	if (existing_ring)
+		rte_event_ring_free(existing_ring);
+
+	sp->rx_worker_ring = rte_event_ring_create(buf, MAX_SW_PROD_Q_DEPTH,
+			dev->data->socket_id,
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (sp->rx_worker_ring == NULL) {
+		SW_LOG_ERR("Error creating RX ring for port %d shard %d\n",
+				port_id, s->id);
+		return -1;
+	}
+
+	snprintf(buf, sizeof(buf), "sw%d_p%u_s%u_cq", dev->data->dev_id,
+			port_id, s->id);
+	existing_ring = rte_event_ring_lookup(buf);
+	if (existing_ring)
+		rte_event_ring_free(existing_ring);
+
+	sp->cq_worker_ring = rte_event_ring_create(buf, conf->dequeue_depth,
+			dev->data->socket_id,
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (sp->cq_worker_ring == NULL) {
+		rte_event_ring_free(sp->rx_worker_ring);
+		sp->rx_worker_ring = NULL;
+		SW_LOG_ERR("Error creating CQ ring for port %d shard %d\n",
+				port_id, s->id);
+		return -1;
+	}
+	s->cq_ring_space[port_id] = conf->dequeue_depth;
+
+	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
+		sp->hist_list[i].fid = -1;
+		sp->hist_list[i].qid = -1;
+	}
+
+	p->rx_shard_ring[s->id] = sp->rx_worker_ring;
+	p->cq_shard_ring[s->id] = sp->cq_worker_ring;
+
+	return 0;
 }
 
 static int
@@ -148,6 +223,9 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		 * the sum to no leak credits
 		 */
 		int possible_inflights = p->inflight_credits + p->inflights;
+		for (i = 1; i < sw->nb_shards; i++)
+			possible_inflights +=
+				sw->shards[i].ports[port_id].inflights;
 		rte_atomic32_sub(&sw->inflights, possible_inflights);
 	}
 
@@ -193,13 +271,20 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 				port_id);
 		return -1;
 	}
-	sw->cq_ring_space[port_id] = conf->dequeue_depth;
+	sw->shards[0].cq_ring_space[port_id] = conf->dequeue_depth;
 
 	/* set hist list contents to empty */
 	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
 		p->hist_list[i].fid = -1;
 		p->hist_list[i].qid = -1;
 	}
+
+	p->rx_shard_ring[0] = p->rx_worker_ring;
+	p->cq_shard_ring[0] = p->cq_worker_ring;
+	for (i = 1; i < sw->nb_shards; i++)
+		if (sw_shard_port_setup(dev, &sw->shards[i], port_id,
+				conf) < 0)
+			return -1;
 	dev->data->ports[port_id] = p;
 
 	rte_smp_wmb();
@@ -211,9 +296,19 @@ static void
 sw_port_release(void *port)
 {
 	struct sw_port *p = (void *)port;
+	unsigned int i;
+
 	if (p == NULL)
 		return;
 
+	for (i = 1; p->sw != NULL && i < p->sw->nb_shards; i++) {
+		struct sw_port *sp = &p->sw->shards[i].ports[p->id];
+
+		rte_event_ring_free(sp->rx_worker_ring);
+		rte_event_ring_free(sp->cq_worker_ring);
+		memset(sp, 0, sizeof(*sp));
+	}
+
 	rte_event_ring_free(p->rx_worker_ring);
 	rte_event_ring_free(p->cq_worker_ring);
 	memset(p, 0, sizeof(*p));
@@ -238,6 +333,11 @@ qid_init(struct sw_evdev *sw, unsigned int idx, int type,
 	qid->type = type;
 	qid->priority = queue_conf->priority;
 
+	/* QIDs are spread over the scheduler shards round-robin */
+	sw->qid_shard[idx] = idx % sw->nb_shards;
+	if (type == RTE_SCHED_TYPE_ORDERED)
+		sw->qid_shard[idx] |= SW_SHARD_ORDERED;
+
 	if (qid->type == RTE_SCHED_TYPE_ORDERED) {
 		char ring_name[RTE_RING_NAMESIZE];
 		uint32_t window_size;
@@ -369,7 +469,7 @@ sw_init_qid_iqs(struct sw_evdev *sw)
 			continue;
 
 		for (j = 0; j < SW_IQS_MAX; j++)
-			iq_init(sw, &qid->iq[j]);
+			iq_init(sw_qid_to_shard(sw, i), &qid->iq[j]);
 	}
 }
 
@@ -391,14 +491,23 @@ sw_qids_empty(struct sw_evdev *sw)
 static int
 sw_ports_empty(struct sw_evdev *sw)
 {
-	unsigned int i;
+	unsigned int i, j;
 
 	for (i = 0; i < sw->port_count; i++) {
-		if ((rte_event_ring_count(sw->ports[i].rx_worker_ring)) ||
-		     rte_event_ring_count(sw->ports[i].cq_worker_ring))
-			return 0;
+		for (j = 0; j < sw->nb_shards; j++) {
+			const struct sw_port *p = &sw->shards[j].ports[i];
+
+			if ((rte_event_ring_count(p->rx_worker_ring)) ||
+			     rte_event_ring_count(p->cq_worker_ring))
+				return 0;
+		}
 	}
 
+	for (j = 0; j < sw->nb_shards; j++)
+		if (sw->shards[j].handoff_ring &&
+		    rte_event_ring_count(sw->shards[j].handoff_ring))
+			return 0;
+
 	return 1;
 }
 
@@ -429,9 +538,9 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_shard *s,
+		struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -443,7 +552,7 @@ sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
 	while (iq_count(iq) > 0) {
 		struct rte_event ev;
 
-		iq_dequeue_burst(sw, iq, &ev, 1);
+		iq_dequeue_burst(s, iq, &ev, 1);
 
 		if (flush)
 			flush(dev_id, ev, arg);
@@ -458,7 +567,8 @@ sw_drain_queues(struct rte_eventdev *dev)
 
 	for (i = 0; i < sw->qid_count; i++) {
 		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+			sw_drain_queue(dev, sw_qid_to_shard(sw, i),
+					&sw->qids[i].iq[j]);
 	}
 }
 
@@ -475,7 +585,8 @@ sw_clean_qid_iqs(struct rte_eventdev *dev)
 		for (j = 0; j < SW_IQS_MAX; j++) {
 			if (!qid->iq[j].head)
 				continue;
-			iq_free_chunk_list(sw, qid->iq[j].head);
+			iq_free_chunk_list(sw_qid_to_shard(sw, i),
+					qid->iq[j].head);
 			qid->iq[j].head = NULL;
 		}
 	}
@@ -512,40 +623,84 @@ sw_port_def_conf(struct rte_eventdev *dev, uint8_t port_id,
 }
 
 static int
-sw_dev_configure(const struct rte_eventdev *dev)
+sw_shard_configure(struct sw_evdev *sw, struct sw_shard *s)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
-	const struct rte_eventdev_data *data = dev->data;
-	const struct rte_event_dev_config *conf = &data->dev_conf;
-	int num_chunks, i;
+	char buf[RTE_RING_NAMESIZE];
+	struct rte_event_ring *existing_ring;
+	int num_qids, num_chunks, i;
 
-	sw->qid_count = conf->nb_event_queues;
-	sw->port_count = conf->nb_event_ports;
-	sw->nb_events_limit = conf->nb_events_limit;
-	rte_atomic32_set(&sw->inflights, 0);
+	/* QIDs owned by this shard, see qid_init() */
+	num_qids = (sw->qid_count + sw->nb_shards - 1 - s->id) /
+			sw->nb_shards;
 
 	/* Number of chunks sized for worst-case spread of events across IQs */
 	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
-			sw->qid_count*SW_IQS_MAX*2;
+			num_qids*SW_IQS_MAX*2;
 
 	/* If this is a reconfiguration, free the previous IQ allocation. All
 	 * IQ chunk references were cleaned out of the QIDs in sw_stop(), and
 	 * will be reinitialized in sw_start().
 	 */
-	if (sw->chunks)
-		rte_free(sw->chunks);
+	if (s->chunks)
+		rte_free(s->chunks);
 
-	sw->chunks = rte_malloc_socket(NULL,
+	s->chunks = rte_malloc_socket(NULL,
 				       sizeof(struct sw_queue_chunk) *
 				       num_chunks,
 				       0,
 				       sw->data->socket_id);
-	if (!sw->chunks)
+	if (!s->chunks)
 		return -ENOMEM;
 
-	sw->chunk_list_head = NULL;
+	s->chunk_list_head = NULL;
 	for (i = 0; i < num_chunks; i++)
-		iq_free_chunk(sw, &sw->chunks[i]);
+		iq_free_chunk(s, &s->chunks[i]);
+
+	if (sw->nb_shards == 1)
+		return 0;
+
+	if (s->ports == NULL) {
+		s->ports = rte_zmalloc_socket(NULL,
+				sizeof(struct sw_port) * SW_PORTS_MAX,
+				RTE_CACHE_LINE_SIZE, sw->data->socket_id);
+		if (s->ports == NULL)
+			return -ENOMEM;
+	}
+
+	/* Every shard may hand all inflight events to this one */
+	snprintf(buf, sizeof(buf), "sw%d_s%u_handoff", sw->data->dev_id,
+			s->id);
+	existing_ring = rte_event_ring_lookup(buf);
+	if (existing_ring)
+		rte_event_ring_free(existing_ring);
+
+	s->handoff_ring = rte_event_ring_create(buf, SW_INFLIGHT_EVENTS_TOTAL,
+			sw->data->socket_id, RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (s->handoff_ring == NULL)
+		return -ENOMEM;
+
+	return 0;
+}
+
+static int
+sw_dev_configure(const struct rte_eventdev *dev)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	const struct rte_eventdev_data *data = dev->data;
+	const struct rte_event_dev_config *conf = &data->dev_conf;
+	unsigned int i;
+	int ret;
+
+	sw->qid_count = conf->nb_event_queues;
+	sw->port_count = conf->nb_event_ports;
+	sw->nb_events_limit = conf->nb_events_limit;
+	rte_atomic32_set(&sw->inflights, 0);
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		ret = sw_shard_configure(sw, &sw->shards[i]);
+		if (ret < 0)
+			return ret;
+	}
 
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
@@ -629,16 +784,28 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	static const char * const q_type_strings[] = {
 			"Ordered", "Atomic", "Parallel", "Directed"
 	};
-	uint32_t i;
-	fprintf(f, "EventDev %s: ports %d, qids %d\n", "todo-fix-name",
-			sw->port_count, sw->qid_count);
-
-	fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
-		sw->stats.rx_pkts, sw->stats.rx_dropped, sw->stats.tx_pkts);
-	fprintf(f, "\tsched calls: %"PRIu64"\n", sw->sched_called);
-	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sw->sched_cq_qid_called);
-	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sw->sched_no_iq_enqueues);
-	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sw->sched_no_cq_enqueues);
+	uint32_t i, s;
+	fprintf(f, "EventDev %s: ports %d, qids %d, shards %d\n",
+			"todo-fix-name", sw->port_count, sw->qid_count,
+			sw->nb_shards);
+
+	for (s = 0; s < sw->nb_shards; s++) {
+		const struct sw_shard *shard = &sw->shards[s];
+
+		if (sw->nb_shards > 1)
+			fprintf(f, "  Shard %d\n", s);
+		fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64
+			"\n\ttx   %"PRIu64"\n", shard->stats.rx_pkts,
+			shard->stats.rx_dropped, shard->stats.tx_pkts);
+		fprintf(f, "\tsched calls: %"PRIu64"\n",
+				shard->sched_called);
+		fprintf(f, "\tsched cq/qid call: %"PRIu64"\n",
+				shard->sched_cq_qid_called);
+		fprintf(f, "\tsched no IQ enq: %"PRIu64"\n",
+				shard->sched_no_iq_enqueues);
+		fprintf(f, "\tsched no CQ enq: %"PRIu64"\n",
+				shard->sched_no_cq_enqueues);
+	}
 	uint32_t inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
@@ -663,6 +830,13 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 			(p->inflights == p->inflight_max) ?
 				COL_RED : COL_RESET,
 			sw->ports[i].inflights, COL_RESET);
+		for (s = 1; s < sw->nb_shards; s++) {
+			const struct sw_port *sp = &sw->shards[s].ports[i];
+
+			fprintf(f, "\tshard %d: rx   %"PRIu64"\ttx   %"PRIu64
+				"\tinflight %d\n", s, sp->stats.rx_pkts,
+				sp->stats.tx_pkts, sp->inflights);
+		}
 
 		fprintf(f, "\tMax New: %u"
 			"\tAvg cycles PP: %"PRIu64"\tCredits: %u\n",
@@ -806,12 +980,16 @@ sw_start(struct rte_eventdev *dev)
 	 * "If two members compare as equal, their order in the sorted
 	 * array is undefined."
 	 */
-	uint32_t qidx = 0;
+	for (i = 0; i < sw->nb_shards; i++)
+		sw->shards[i].qid_count = 0;
 	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
 		for (i = 0; i < sw->qid_count; i++) {
 			if (sw->qids[i].priority == j) {
-				sw->qids_prioritized[qidx] = &sw->qids[i];
-				qidx++;
+				struct sw_shard *s = sw_qid_to_shard(sw, i);
+
+				s->qids_prioritized[s->qid_count] =
+						&sw->qids[i];
+				s->qid_count++;
 			}
 		}
 	}
@@ -871,11 +1049,22 @@ sw_close(struct rte_eventdev *dev)
 		sw_port_release(&sw->ports[i]);
 	sw->port_count = 0;
 
-	memset(&sw->stats, 0, sizeof(sw->stats));
-	sw->sched_called = 0;
-	sw->sched_no_iq_enqueues = 0;
-	sw->sched_no_cq_enqueues = 0;
-	sw->sched_cq_qid_called = 0;
+	for (i = 0; i < sw->nb_shards; i++) {
+		struct sw_shard *s = &sw->shards[i];
+
+		memset(&s->stats, 0, sizeof(s->stats));
+		s->sched_called = 0;
+		s->sched_no_iq_enqueues = 0;
+		s->sched_no_cq_enqueues = 0;
+		s->sched_cq_qid_called = 0;
+
+		if (i == 0)
+			continue;
+		rte_event_ring_free(s->handoff_ring);
+		s->handoff_ring = NULL;
+		rte_free(s->ports);
+		s->ports = NULL;
+	}
 
 	return 0;
 }
@@ -910,6 +1099,16 @@ set_credit_quanta(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_sched_shards(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int *shards = opaque;
+	*shards = atoi(value);
+	if (*shards < 1 || *shards > SW_SCHED_SHARDS_MAX)
+		return -1;
+	return 0;
+}
+
 
 static int32_t sw_sched_service_func(void *args)
 {
@@ -957,6 +1156,7 @@ sw_probe(struct rte_vdev_device *vdev)
 		NUMA_NODE_ARG,
 		SCHED_QUANTA_ARG,
 		CREDIT_QUANTA_ARG,
+		SCHED_SHARDS_ARG,
 		NULL
 	};
 	const char *name;
@@ -966,6 +1166,8 @@ sw_probe(struct rte_vdev_device *vdev)
 	int socket_id = rte_socket_id();
 	int sched_quanta  = SW_DEFAULT_SCHED_QUANTA;
 	int credit_quanta = SW_DEFAULT_CREDIT_QUANTA;
+	int sched_shards = 1;
+	int i;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1007,13 +1209,24 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SCHED_SHARDS_ARG,
+					set_sched_shards, &sched_shards);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing sched shards parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
 
 	SW_LOG_INFO(
-			"Creating eventdev sw device %s, numa_node=%d, sched_quanta=%d, credit_quanta=%d\n",
-			name, socket_id, sched_quanta, credit_quanta);
+			"Creating eventdev sw device %s, numa_node=%d, sched_quanta=%d, credit_quanta=%d, sched_shards=%d\n",
+			name, socket_id, sched_quanta, credit_quanta,
+			sched_shards);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id);
@@ -1038,6 +1251,14 @@ sw_probe(struct rte_vdev_device *vdev)
 	/* copy values passed from vdev command line to instance */
 	sw->credit_update_quanta = credit_quanta;
 	sw->sched_quanta = sched_quanta;
+	sw->nb_shards = sched_shards;
+
+	for (i = 0; i < sched_shards; i++) {
+		sw->shards[i].sw = sw;
+		sw->shards[i].id = i;
+		rte_spinlock_init(&sw->shards[i].lock);
+	}
+	sw->shards[0].ports = sw->ports;
 
 	/* register service with EAL */
 	struct rte_service_spec service;
@@ -1048,6 +1269,9 @@ sw_probe(struct rte_vdev_device *vdev)
 	service.socket_id = socket_id;
 	service.callback = sw_sched_service_func;
 	service.callback_userdata = (void *)dev;
+	/* shards are scheduled in parallel by the cores running the service */
+	if (sched_shards > 1)
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
 
 	int32_t ret = rte_service_component_register(&service, &sw->service_id);
 	if (ret) {
@@ -1082,7 +1306,8 @@ static struct rte_vdev_driver evdev_sw_pmd_drv = {
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
-		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>");
+		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
+		SCHED_SHARDS_ARG "=<int>");
 
 /* declared extern in header, for access from other .c files */
 int eventdev_sw_log_level;
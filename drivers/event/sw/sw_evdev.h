@@ -9,6 +9,7 @@
 #include <rte_eventdev.h>
 #include <rte_eventdev_pmd_vdev.h>
 #include <rte_atomic.h>
+#include <rte_spinlock.h>
 
 #define SW_DEFAULT_CREDIT_QUANTA 32
 #define SW_DEFAULT_SCHED_QUANTA 128
@@ -21,6 +22,7 @@
 /* allow for lots of over-provisioning */
 #define MAX_SW_PROD_Q_DEPTH 4096
 #define SW_FRAGMENTS_MAX 16
+#define SW_SCHED_SHARDS_MAX 4
 
 /* Should be power-of-two minus one, to leave room for the next pointer */
 #define SW_EVS_PER_Q_CHUNK 255
@@ -33,6 +35,11 @@
 
 #define SW_PORT_HIST_LIST (MAX_SW_PROD_Q_DEPTH) /* size of our history list */
 #define NUM_SAMPLES 64 /* how many data points use for average stats */
+/* size of the per port list of shards that scheduled unreleased events */
+#define SW_PORT_SHARD_HIST (SW_PORT_HIST_LIST * SW_SCHED_SHARDS_MAX)
+/* set in qid_shard[] and shard history entries for ordered QIDs */
+#define SW_SHARD_ORDERED 0x80
+#define SW_SHARD_MASK (SW_SHARD_ORDERED - 1)
 
 #define EVENTDEV_NAME_SW_PMD event_sw
 #define SW_PMD_NAME RTE_STR(event_sw)
@@ -201,8 +208,60 @@ struct sw_port {
 	struct rte_event cq_buf[MAX_SW_CONS_Q_DEPTH];
 
 	uint8_t num_qids_mapped;
+
+	/* With sharded scheduling, the worker exchanges events with each
+	 * shard over its own pair of rings. Index zero aliases the rx and cq
+	 * worker rings above, which are used by shard zero.
+	 */
+	struct rte_event_ring *rx_shard_ring[SW_SCHED_SHARDS_MAX];
+	struct rte_event_ring *cq_shard_ring[SW_SCHED_SHARDS_MAX];
+	uint8_t cq_shard_next; /* shard cq ring to poll first on dequeue */
+	/* Shard which scheduled each unreleased event, in dequeue order, so
+	 * that releases and forwards are returned to the shard holding the
+	 * history list entry.
+	 */
+	uint16_t shard_hist_head;
+	uint16_t shard_hist_tail;
+	uint8_t shard_hist[SW_PORT_SHARD_HIST];
 };
 
+/* A scheduler instance. Each QID is owned by one shard, which holds the IQ
+ * memory and the per port scheduling state (history lists and cq buffers)
+ * needed to schedule it, so that shards can run in parallel on different
+ * service cores.
+ */
+struct sw_shard {
+	struct sw_evdev *sw;
+	uint8_t id;
+	/* held by the core currently running this shard */
+	rte_spinlock_t lock;
+
+	/* Scheduler side port state. Shard zero uses sw->ports, the other
+	 * shards use a private array holding their own rings to the workers.
+	 */
+	struct sw_port *ports;
+
+	/* Events to QIDs owned by another shard, e.g. from reordering */
+	struct rte_event_ring *handoff_ring;
+
+	struct sw_queue_chunk *chunk_list_head;
+	struct sw_queue_chunk *chunks;
+
+	/* Cache how many packets are in each cq */
+	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
+
+	/* Array of pointers to the QIDs of this shard sorted by priority */
+	uint32_t qid_count;
+	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+
+	/* Stats */
+	struct sw_point_stats stats __rte_cache_aligned;
+	uint64_t sched_called;
+	uint64_t sched_no_iq_enqueues;
+	uint64_t sched_no_cq_enqueues;
+	uint64_t sched_cq_qid_called;
+} __rte_cache_aligned;
+
 struct sw_evdev {
 	struct rte_eventdev_data *data;
 
@@ -227,22 +286,15 @@ struct sw_evdev {
 
 	/* Internal queues - one per logical queue */
 	struct sw_qid qids[RTE_EVENT_MAX_QUEUES_PER_DEV] __rte_cache_aligned;
-	struct sw_queue_chunk *chunk_list_head;
-	struct sw_queue_chunk *chunks;
 
-	/* Cache how many packets are in each cq */
-	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
-
-	/* Array of pointers to load-balanced QIDs sorted by priority level */
-	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+	/* Scheduler shards, and the shard owning each QID as seen by the
+	 * workers, with SW_SHARD_ORDERED set for ordered QIDs.
+	 */
+	struct sw_shard shards[SW_SCHED_SHARDS_MAX];
+	uint8_t qid_shard[RTE_EVENT_MAX_QUEUES_PER_DEV] __rte_cache_aligned;
+	uint8_t nb_shards;
 
-	/* Stats */
-	struct sw_point_stats stats __rte_cache_aligned;
-	uint64_t sched_called;
 	int32_t sched_quanta;
-	uint64_t sched_no_iq_enqueues;
-	uint64_t sched_no_cq_enqueues;
-	uint64_t sched_cq_qid_called;
 
 	uint8_t started;
 	uint32_t credit_update_quanta;
@@ -270,6 +322,12 @@ sw_pmd_priv_const(const struct rte_eventdev *eventdev)
 	return eventdev->data->dev_private;
 }
 
+static inline struct sw_shard *
+sw_qid_to_shard(struct sw_evdev *sw, uint32_t qid)
+{
+	return &sw->shards[sw->qid_shard[qid] & SW_SHARD_MASK];
+}
+
 uint16_t sw_event_enqueue(void *port, const struct rte_event *ev);
 uint16_t sw_event_enqueue_burst(void *port, const struct rte_event ev[],
 		uint16_t num);
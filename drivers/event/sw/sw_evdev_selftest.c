@@ -154,9 +154,11 @@ init(struct test *t, int nb_queues, int nb_ports)
 	int ret;
 
 	void *temp = t->mbuf_pool; /* save and restore mbuf pool */
+	uint32_t service_id = t->service_id;
 
 	memset(t, 0, sizeof(*t));
 	t->mbuf_pool = temp;
+	t->service_id = service_id;
 
 	ret = rte_event_dev_configure(evdev, &config);
 	if (ret < 0)
@@ -3157,6 +3159,82 @@ worker_loopback(struct test *t, uint8_t disable_implicit_release)
 
 static struct rte_mempool *eventdev_func_mempool;
 
+/*
+ * Run the functional tests again on a device sharding its scheduling over
+ * several scheduler instances, with the QIDs spread over the shards.
+ */
+static int
+sharded_tests(struct test *t)
+{
+	static const struct {
+		const char *name;
+		int (*fn)(struct test *t);
+	} tests[] = {
+		{ "Single Directed Packet", test_single_directed_packet },
+		{ "Directed Forward Credit", test_directed_forward_credits },
+		{ "Single Load Balanced Packet", single_packet },
+		{ "Unordered Basic", unordered_basic },
+		{ "Ordered Basic", ordered_basic },
+		{ "Burst Packets", burst_packets },
+		{ "Load Balancing", load_balancing },
+		{ "Prioritized Directed", test_priority_directed },
+		{ "Prioritized Atomic", test_priority_atomic },
+		{ "Prioritized Ordered", test_priority_ordered },
+		{ "Prioritized Unordered", test_priority_unordered },
+		{ "Invalid QID", invalid_qid },
+		{ "Load Balancing History", load_balancing_history },
+		{ "Inflight Count", inflight_counts },
+		{ "Abuse Inflights", abuse_inflights },
+		{ "Unlink-in-progress", unlink_in_progress },
+		{ "Ordered Reconfigure", ordered_reconfigure },
+		{ "Port LB Single Reconfig", port_single_lb_reconfig },
+		{ "Port Reconfig Credits", port_reconfig_credits },
+		{ "Stop Flush", dev_stop_flush },
+	};
+	const char *eventdev_name = "event_sw_sharded";
+	int main_evdev = evdev;
+	uint32_t main_service_id = t->service_id;
+	unsigned int i;
+	int ret = 0;
+
+	if (rte_vdev_init(eventdev_name, "sched_shards=3") < 0) {
+		printf("%d: Error creating sharded eventdev\n", __LINE__);
+		return -1;
+	}
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0 ||
+			rte_event_dev_service_id_get(evdev, &t->service_id)) {
+		printf("%d: Error finding sharded eventdev\n", __LINE__);
+		ret = -1;
+		goto out;
+	}
+	rte_service_runstate_set(t->service_id, 1);
+	rte_service_set_runstate_mapped_check(t->service_id, 0);
+
+	for (i = 0; i < RTE_DIM(tests); i++) {
+		printf("*** Running %s test (sharded)...\n", tests[i].name);
+		ret = tests[i].fn(t);
+		if (ret != 0) {
+			printf("ERROR - %s test (sharded) FAILED.\n",
+					tests[i].name);
+			break;
+		}
+	}
+
+	if (ret == 0 && rte_lcore_count() >= 3) {
+		printf("*** Running Worker loopback test (sharded)...\n");
+		ret = worker_loopback(t, 0);
+		if (ret != 0)
+			printf("ERROR - Worker loopback test (sharded) FAILED.\n");
+	}
+
+out:
+	rte_vdev_uninit(eventdev_name);
+	evdev = main_evdev;
+	t->service_id = main_service_id;
+	return ret;
+}
+
 int
 test_sw_eventdev(void)
 {
@@ -3385,6 +3463,11 @@ test_sw_eventdev(void)
 		printf("### Not enough cores for worker loopback tests.\n");
 		printf("### Need at least 3 cores for the tests.\n");
 	}
+	ret = sharded_tests(t);
+	if (ret != 0) {
+		printf("ERROR - Sharded scheduling tests FAILED.\n");
+		goto test_fail;
+	}
 
 	/*
 	 * Free test instance, leaving mempool initialized, and a pointer to it
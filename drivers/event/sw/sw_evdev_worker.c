@@ -23,8 +23,16 @@ sw_event_release(struct sw_port *p, uint8_t index)
 	struct rte_event ev;
 	ev.op = sw_qe_flag_map[RTE_EVENT_OP_RELEASE];
 
+	/* return it to the shard which scheduled the event */
+	struct rte_event_ring *ring = p->rx_worker_ring;
+	if (p->sw->nb_shards > 1) {
+		uint8_t shard = p->shard_hist[p->shard_hist_tail++ &
+				(SW_PORT_SHARD_HIST - 1)];
+		ring = p->rx_shard_ring[shard & SW_SHARD_MASK];
+	}
+
 	uint16_t free_count;
-	rte_event_ring_enqueue_burst(p->rx_worker_ring, &ev, 1, &free_count);
+	rte_event_ring_enqueue_burst(ring, &ev, 1, &free_count);
 
 	/* each release returns one credit */
 	p->outstanding_releases--;
@@ -49,6 +57,100 @@ enqueue_burst_with_ops(struct rte_event_ring *r, const struct rte_event *events,
 	return rte_event_ring_enqueue_burst(r, tmp_evs, n, NULL);
 }
 
+/*
+ * Enqueue for sharded scheduling: new events go to the shard owning their
+ * destination QID and releases to the shard which scheduled the released
+ * event. A forward from an ordered QID goes whole to the scheduling shard, as
+ * it has to pass through the reorder buffer of that QID. Other forwards
+ * crossing shards are split in a release and a new event, so that the events
+ * a port enqueues to a QID stay in order.
+ */
+static inline uint16_t
+sw_event_enqueue_shards(struct sw_evdev *sw, struct sw_port *p,
+		const struct rte_event ev[], uint16_t num)
+{
+	struct rte_event evs[SW_SCHED_SHARDS_MAX][PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint32_t cnt[SW_SCHED_SHARDS_MAX] = {0};
+	uint32_t space[SW_SCHED_SHARDS_MAX];
+	uint16_t shard_hist_tail = p->shard_hist_tail;
+	uint32_t i, k;
+
+	/* the port is the only producer on its rings, so space found here
+	 * cannot be taken away before the enqueue below
+	 */
+	for (k = 0; k < sw->nb_shards; k++)
+		space[k] = rte_event_ring_free_count(p->rx_shard_ring[k]);
+
+	for (i = 0; i < num; i++) {
+		int op = ev[i].op;
+		int outstanding = p->outstanding_releases > 0;
+		const uint8_t invalid_qid = (ev[i].queue_id >= sw->qid_count);
+		uint8_t ops = sw_qe_flag_map[op];
+		uint8_t dest = 0, src;
+		int split = 0;
+
+		/* invalid QIDs go to shard zero, whose scheduler drops them */
+		if (likely(!invalid_qid))
+			dest = sw->qid_shard[ev[i].queue_id] & SW_SHARD_MASK;
+		if (unlikely(dest >= sw->nb_shards))
+			dest = 0;
+		src = dest;
+
+		ops &= ~(invalid_qid << QE_FLAG_VALID_SHIFT);
+		/* nothing to release, there is no history to complete */
+		if (!outstanding)
+			ops &= ~QE_FLAG_COMPLETE;
+
+		if (ops & QE_FLAG_COMPLETE) {
+			const uint8_t hist = p->shard_hist[shard_hist_tail &
+					(SW_PORT_SHARD_HIST - 1)];
+
+			src = hist & SW_SHARD_MASK;
+			if (unlikely(src >= sw->nb_shards))
+				src = 0;
+			if (hist & SW_SHARD_ORDERED)
+				dest = src;
+			split = (ops & QE_FLAG_VALID) && src != dest;
+		}
+
+		if (cnt[src] == space[src] ||
+				(split && cnt[dest] == space[dest]))
+			break;
+
+		p->inflight_credits -= (op == RTE_EVENT_OP_NEW);
+		p->inflight_credits += (op == RTE_EVENT_OP_RELEASE) *
+					outstanding;
+
+		if (ops & QE_FLAG_COMPLETE) {
+			p->outstanding_releases--;
+			shard_hist_tail++;
+		}
+
+		/* error case: branch to avoid touching p->stats */
+		if (unlikely(invalid_qid && op != RTE_EVENT_OP_RELEASE)) {
+			p->stats.rx_dropped++;
+			p->inflight_credits++;
+		}
+
+		struct rte_event *qe = &evs[src][cnt[src]++];
+		*qe = ev[i];
+		qe->op = split ? (ops & ~QE_FLAG_VALID) : ops;
+		if (split) {
+			qe = &evs[dest][cnt[dest]++];
+			*qe = ev[i];
+			qe->op = ops & ~QE_FLAG_COMPLETE;
+		}
+	}
+
+	for (k = 0; k < sw->nb_shards; k++)
+		if (cnt[k])
+			rte_event_ring_enqueue_burst(p->rx_shard_ring[k],
+					evs[k], cnt[k], NULL);
+
+	p->shard_hist_tail = shard_hist_tail;
+	return i;
+}
+
 uint16_t
 sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 {
@@ -58,6 +160,7 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 	struct sw_evdev *sw = (void *)p->sw;
 	uint32_t sw_inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credit_update_quanta = sw->credit_update_quanta;
+	uint32_t enq;
 	int new = 0;
 
 	if (num > PORT_ENQUEUE_MAX_BURST_SIZE)
@@ -83,6 +186,11 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 		num = (p->inflight_credits < new) ? p->inflight_credits : new;
 	}
 
+	if (sw->nb_shards > 1) {
+		enq = sw_event_enqueue_shards(sw, p, ev, num);
+		goto end;
+	}
+
 	for (i = 0; i < num; i++) {
 		int op = ev[i].op;
 		int outstanding = p->outstanding_releases > 0;
@@ -110,8 +218,8 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 	}
 
 	/* returns number of events actually enqueued */
-	uint32_t enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, i,
-					     new_ops);
+	enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, i, new_ops);
+end:
 	if (p->outstanding_releases == 0 && p->last_dequeue_burst_sz != 0) {
 		uint64_t burst_ticks = rte_get_timer_cycles() -
 				p->last_dequeue_ticks;
@@ -137,17 +245,54 @@ sw_event_enqueue(void *port, const struct rte_event *ev)
 	return sw_event_enqueue_burst(port, ev, 1);
 }
 
+/*
+ * Dequeue for sharded scheduling, taking events from the cq ring of each
+ * shard in turn and recording which shard scheduled them.
+ */
+static inline uint16_t
+sw_event_dequeue_shards(struct sw_evdev *sw, struct sw_port *p,
+		struct rte_event *ev, uint16_t num)
+{
+	const uint32_t nb_shards = sw->nb_shards;
+	uint32_t k, shard = p->cq_shard_next;
+	uint16_t ndeq = 0;
+
+	for (k = 0; k < nb_shards && ndeq < num; k++) {
+		uint16_t i, n;
+
+		n = rte_event_ring_dequeue_burst(p->cq_shard_ring[shard],
+				&ev[ndeq], num - ndeq, NULL);
+		for (i = ndeq; i < ndeq + n; i++) {
+			uint8_t ordered = sw->qid_shard[ev[i].queue_id] &
+					SW_SHARD_ORDERED;
+			p->shard_hist[p->shard_hist_head++ &
+					(SW_PORT_SHARD_HIST - 1)] =
+				shard | ordered;
+		}
+		ndeq += n;
+
+		if (++shard == nb_shards)
+			shard = 0;
+	}
+
+	if (++p->cq_shard_next == nb_shards)
+		p->cq_shard_next = 0;
+
+	return ndeq;
+}
+
 uint16_t
 sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 		uint64_t wait)
 {
 	RTE_SET_USED(wait);
 	struct sw_port *p = (void *)port;
+	struct sw_evdev *sw = (void *)p->sw;
 	struct rte_event_ring *ring = p->cq_worker_ring;
+	uint16_t ndeq;
 
 	/* check that all previous dequeues have been released */
 	if (p->implicit_release) {
-		struct sw_evdev *sw = (void *)p->sw;
 		uint32_t credit_update_quanta = sw->credit_update_quanta;
 		uint16_t out_rels = p->outstanding_releases;
 		uint16_t i;
@@ -162,7 +307,10 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 	}
 
 	/* returns number of events actually dequeued */
-	uint16_t ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+	if (sw->nb_shards == 1)
+		ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+	else
+		ndeq = sw_event_dequeue_shards(sw, p, ev, num);
 	if (unlikely(ndeq == 0)) {
 		p->zero_polls++;
 		p->total_polls++;
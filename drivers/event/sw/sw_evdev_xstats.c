@@ -47,39 +47,69 @@ struct sw_xstats_entry {
 };
 
 static uint64_t
-get_dev_stat(const struct sw_evdev *sw, uint16_t obj_idx __rte_unused,
-		enum xstats_type type, int extra_arg __rte_unused)
+get_shard_stat(const struct sw_shard *s, enum xstats_type type)
 {
 	switch (type) {
-	case rx: return sw->stats.rx_pkts;
-	case tx: return sw->stats.tx_pkts;
-	case dropped: return sw->stats.rx_dropped;
-	case calls: return sw->sched_called;
-	case no_iq_enq: return sw->sched_no_iq_enqueues;
-	case no_cq_enq: return sw->sched_no_cq_enqueues;
+	case rx: return s->stats.rx_pkts;
+	case tx: return s->stats.tx_pkts;
+	case dropped: return s->stats.rx_dropped;
+	case calls: return s->sched_called;
+	case no_iq_enq: return s->sched_no_iq_enqueues;
+	case no_cq_enq: return s->sched_no_cq_enqueues;
 	default: return -1;
 	}
 }
 
 static uint64_t
-get_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
+get_dev_stat(const struct sw_evdev *sw, uint16_t obj_idx __rte_unused,
 		enum xstats_type type, int extra_arg __rte_unused)
 {
-	const struct sw_port *p = &sw->ports[obj_idx];
+	uint64_t val = 0;
+	unsigned int i;
 
+	/* device stats are the sum over all scheduler shards */
+	for (i = 0; i < sw->nb_shards; i++)
+		val += get_shard_stat(&sw->shards[i], type);
+
+	return val;
+}
+
+static uint64_t
+get_port_shard_stat(const struct sw_port *p, enum xstats_type type)
+{
 	switch (type) {
 	case rx: return p->stats.rx_pkts;
 	case tx: return p->stats.tx_pkts;
 	case dropped: return p->stats.rx_dropped;
 	case inflight: return p->inflights;
-	case pkt_cycles: return p->avg_pkt_ticks;
-	case calls: return p->total_polls;
-	case credits: return p->inflight_credits;
-	case poll_return: return p->zero_polls;
 	case rx_used: return rte_event_ring_count(p->rx_worker_ring);
 	case rx_free: return rte_event_ring_free_count(p->rx_worker_ring);
 	case tx_used: return rte_event_ring_count(p->cq_worker_ring);
 	case tx_free: return rte_event_ring_free_count(p->cq_worker_ring);
+	default: return 0;
+	}
+}
+
+static uint64_t
+get_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
+		enum xstats_type type, int extra_arg __rte_unused)
+{
+	const struct sw_port *p = &sw->ports[obj_idx];
+	uint64_t val = 0;
+	unsigned int i;
+
+	switch (type) {
+	case pkt_cycles: return p->avg_pkt_ticks;
+	case calls: return p->total_polls;
+	case credits: return p->inflight_credits;
+	case poll_return: return p->zero_polls;
+	case rx: case tx: case dropped: case inflight:
+	case rx_used: case rx_free: case tx_used: case tx_free:
+		/* scheduler side state is kept per shard, sum it up */
+		for (i = 0; i < sw->nb_shards; i++)
+			val += get_port_shard_stat(
+					&sw->shards[i].ports[obj_idx], type);
+		return val;
 	default: return -1;
 	}
 }
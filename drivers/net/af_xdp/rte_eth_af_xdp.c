@@ -6,8 +6,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <poll.h>
+#include <pthread.h>
 #include <netinet/in.h>
 #include <net/if.h>
+#include <sys/queue.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
 #include <linux/if_ether.h>
@@ -50,6 +52,14 @@
 #define PF_XDP AF_XDP
 #endif
 
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+
+#ifndef SO_BUSY_POLL_BUDGET
+#define SO_BUSY_POLL_BUDGET 70
+#endif
+
 static int af_xdp_logtype;
 
 #define AF_XDP_LOG(level, fmt, args...)			\
@@ -68,19 +78,21 @@ static int af_xdp_logtype;
 #define ETH_AF_XDP_DFLT_NUM_DESCS	XSK_RING_CONS__DEFAULT_NUM_DESCS
 #define ETH_AF_XDP_DFLT_START_QUEUE_IDX	0
 #define ETH_AF_XDP_DFLT_QUEUE_COUNT	1
+#define ETH_AF_XDP_DFLT_BUSY_BUDGET	0
+#define ETH_AF_XDP_DFLT_BUSY_TIMEOUT	20
 
 #define ETH_AF_XDP_RX_BATCH_SIZE	32
 #define ETH_AF_XDP_TX_BATCH_SIZE	32
 
 
 struct xsk_umem_info {
-	struct xsk_ring_prod fq;
-	struct xsk_ring_cons cq;
 	struct xsk_umem *umem;
 	struct rte_ring *buf_ring;
 	const struct rte_memzone *mz;
 	struct rte_mempool *mb_pool;
 	void *buffer;
+	uint32_t refcnt;
+	uint32_t max_xsks;
 };
 
 struct rx_stats {
@@ -97,9 +109,14 @@ struct pkt_rx_queue {
 
 	struct rx_stats stats;
 
+	/* fill and completion rings are per socket when the umem is shared */
+	struct xsk_ring_prod fq;
+	struct xsk_ring_cons cq;
+
 	struct pkt_tx_queue *pair;
 	struct pollfd fds[1];
 	int xsk_queue_idx;
+	int busy_budget;
 };
 
 struct tx_stats {
@@ -125,6 +142,8 @@ struct pmd_internals {
 	int queue_cnt;
 	int max_queue_cnt;
 	int combined_queue_cnt;
+	int shared_umem;
+	int busy_budget;
 
 	struct rte_ether_addr eth_addr;
 
@@ -135,11 +154,15 @@ struct pmd_internals {
 #define ETH_AF_XDP_IFACE_ARG			"iface"
 #define ETH_AF_XDP_START_QUEUE_ARG		"start_queue"
 #define ETH_AF_XDP_QUEUE_COUNT_ARG		"queue_count"
+#define ETH_AF_XDP_SHARED_UMEM_ARG		"shared_umem"
+#define ETH_AF_XDP_BUSY_BUDGET_ARG		"busy_budget"
 
 static const char * const valid_arguments[] = {
 	ETH_AF_XDP_IFACE_ARG,
 	ETH_AF_XDP_START_QUEUE_ARG,
 	ETH_AF_XDP_QUEUE_COUNT_ARG,
+	ETH_AF_XDP_SHARED_UMEM_ARG,
+	ETH_AF_XDP_BUSY_BUDGET_ARG,
 	NULL
 };
 
@@ -150,12 +173,23 @@ static const struct rte_eth_link pmd_link = {
 	.link_autoneg = ETH_LINK_AUTONEG
 };
 
+/* List which tracks PMDs to facilitate sharing UMEMs across them. */
+struct internal_list {
+	TAILQ_ENTRY(internal_list) next;
+	struct rte_eth_dev *eth_dev;
+};
+
+TAILQ_HEAD(internal_list_head, internal_list);
+static struct internal_list_head internal_list =
+	TAILQ_HEAD_INITIALIZER(internal_list);
+
+static pthread_mutex_t internal_list_lock = PTHREAD_MUTEX_INITIALIZER;
+
 #if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
 static inline int
 reserve_fill_queue_zc(struct xsk_umem_info *umem, uint16_t reserve_size,
-		      struct rte_mbuf **bufs)
+		      struct rte_mbuf **bufs, struct xsk_ring_prod *fq)
 {
-	struct xsk_ring_prod *fq = &umem->fq;
 	uint32_t idx;
 	uint16_t i;
 
@@ -182,9 +216,9 @@ reserve_fill_queue_zc(struct xsk_umem_info *umem, uint16_t reserve_size,
 #else
 static inline int
 reserve_fill_queue_cp(struct xsk_umem_info *umem, uint16_t reserve_size,
-		      struct rte_mbuf **bufs __rte_unused)
+		      struct rte_mbuf **bufs __rte_unused,
+		      struct xsk_ring_prod *fq)
 {
-	struct xsk_ring_prod *fq = &umem->fq;
 	void *addrs[reserve_size];
 	uint32_t idx;
 	uint16_t i;
@@ -217,12 +251,32 @@ reserve_fill_queue_cp(struct xsk_umem_info *umem, uint16_t reserve_size,
 
 static inline int
 reserve_fill_queue(struct xsk_umem_info *umem, uint16_t reserve_size,
-		   struct rte_mbuf **bufs)
+		   struct rte_mbuf **bufs, struct xsk_ring_prod *fq)
 {
 #if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
-	return reserve_fill_queue_zc(umem, reserve_size, bufs);
+	return reserve_fill_queue_zc(umem, reserve_size, bufs, fq);
 #else
-	return reserve_fill_queue_cp(umem, reserve_size, bufs);
+	return reserve_fill_queue_cp(umem, reserve_size, bufs, fq);
+#endif
+}
+
+/*
+ * Called when the rx ring is empty. With preferred busy polling the
+ * kernel NAPI context is driven from here instead of by interrupts,
+ * so always enter the kernel; otherwise only when it asks for a wakeup.
+ */
+static inline void
+rx_wakeup(struct pkt_rx_queue *rxq)
+{
+	if (rxq->busy_budget) {
+		(void)recvfrom(xsk_socket__fd(rxq->xsk), NULL, 0,
+			       MSG_DONTWAIT, NULL, NULL);
+		return;
+	}
+
+#if defined(XDP_USE_NEED_WAKEUP)
+	if (xsk_ring_prod__needs_wakeup(&rxq->fq))
+		(void)poll(rxq->fds, 1, 1000);
 #endif
 }
 
@@ -248,11 +302,7 @@ af_xdp_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	rcvd = xsk_ring_cons__peek(rx, nb_pkts, &idx_rx);
 
 	if (rcvd == 0) {
-#if defined(XDP_USE_NEED_WAKEUP)
-		if (xsk_ring_prod__needs_wakeup(&umem->fq))
-			(void)poll(rxq->fds, 1, 1000);
-#endif
-
+		rx_wakeup(rxq);
 		goto out;
 	}
 
@@ -280,7 +330,7 @@ af_xdp_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 	xsk_ring_cons__release(rx, rcvd);
 
-	(void)reserve_fill_queue(umem, rcvd, fq_bufs);
+	(void)reserve_fill_queue(umem, rcvd, fq_bufs, &rxq->fq);
 
 	/* statistics */
 	rxq->stats.rx_pkts += rcvd;
@@ -300,7 +350,7 @@ af_xdp_rx_cp(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	struct pkt_rx_queue *rxq = queue;
 	struct xsk_ring_cons *rx = &rxq->rx;
 	struct xsk_umem_info *umem = rxq->umem;
-	struct xsk_ring_prod *fq = &umem->fq;
+	struct xsk_ring_prod *fq = &rxq->fq;
 	uint32_t idx_rx = 0;
 	unsigned long rx_bytes = 0;
 	int rcvd, i;
@@ -312,16 +362,13 @@ af_xdp_rx_cp(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 	rcvd = xsk_ring_cons__peek(rx, nb_pkts, &idx_rx);
 	if (rcvd == 0) {
-#if defined(XDP_USE_NEED_WAKEUP)
-		if (xsk_ring_prod__needs_wakeup(fq))
-			(void)poll(rxq->fds, 1, 1000);
-#endif
-
+		rx_wakeup(rxq);
 		goto out;
 	}
 
 	if (xsk_prod_nb_free(fq, free_thresh) >= free_thresh)
-		(void)reserve_fill_queue(umem, ETH_AF_XDP_RX_BATCH_SIZE, NULL);
+		(void)reserve_fill_queue(umem, ETH_AF_XDP_RX_BATCH_SIZE,
+					 NULL, fq);
 
 	for (i = 0; i < rcvd; i++) {
 		const struct xdp_desc *desc;
@@ -370,9 +417,8 @@ eth_af_xdp_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 }
 
 static void
-pull_umem_cq(struct xsk_umem_info *umem, int size)
+pull_umem_cq(struct xsk_umem_info *umem, int size, struct xsk_ring_cons *cq)
 {
-	struct xsk_ring_cons *cq = &umem->cq;
 	size_t i, n;
 	uint32_t idx_cq = 0;
 
@@ -394,7 +440,7 @@ pull_umem_cq(struct xsk_umem_info *umem, int size)
 }
 
 static void
-kick_tx(struct pkt_tx_queue *txq)
+kick_tx(struct pkt_tx_queue *txq, struct xsk_ring_cons *cq)
 {
 	struct xsk_umem_info *umem = txq->umem;
 
@@ -409,10 +455,11 @@ kick_tx(struct pkt_tx_queue *txq)
 
 			/* pull from completion queue to leave more space */
 			if (errno == EAGAIN)
-				pull_umem_cq(umem, ETH_AF_XDP_TX_BATCH_SIZE);
+				pull_umem_cq(umem, ETH_AF_XDP_TX_BATCH_SIZE,
+					     cq);
 		}
 #ifndef XDP_UMEM_UNALIGNED_CHUNK_FLAG
-	pull_umem_cq(umem, ETH_AF_XDP_TX_BATCH_SIZE);
+	pull_umem_cq(umem, ETH_AF_XDP_TX_BATCH_SIZE, cq);
 #endif
 }
 
@@ -422,6 +469,7 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
 	struct pkt_tx_queue *txq = queue;
 	struct xsk_umem_info *umem = txq->umem;
+	struct xsk_ring_cons *cq = &txq->pair->cq;
 	struct rte_mbuf *mbuf;
 	unsigned long tx_bytes = 0;
 	int i;
@@ -430,14 +478,14 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	struct xdp_desc *desc;
 	uint64_t addr, offset;
 
-	pull_umem_cq(umem, nb_pkts);
+	pull_umem_cq(umem, nb_pkts, cq);
 
 	for (i = 0; i < nb_pkts; i++) {
 		mbuf = bufs[i];
 
 		if (mbuf->pool == umem->mb_pool) {
 			if (!xsk_ring_prod__reserve(&txq->tx, 1, &idx_tx)) {
-				kick_tx(txq);
+				kick_tx(txq, cq);
 				goto out;
 			}
 			desc = xsk_ring_prod__tx_desc(&txq->tx, idx_tx);
@@ -458,7 +506,7 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 			if (!xsk_ring_prod__reserve(&txq->tx, 1, &idx_tx)) {
 				rte_pktmbuf_free(local_mbuf);
-				kick_tx(txq);
+				kick_tx(txq, cq);
 				goto out;
 			}
 
@@ -483,7 +531,7 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 #if defined(XDP_USE_NEED_WAKEUP)
 	if (xsk_ring_prod__needs_wakeup(&txq->tx))
 #endif
-		kick_tx(txq);
+		kick_tx(txq, cq);
 
 out:
 	xsk_ring_prod__submit(&txq->tx, count);
@@ -500,6 +548,7 @@ af_xdp_tx_cp(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
 	struct pkt_tx_queue *txq = queue;
 	struct xsk_umem_info *umem = txq->umem;
+	struct xsk_ring_cons *cq = &txq->pair->cq;
 	struct rte_mbuf *mbuf;
 	void *addrs[ETH_AF_XDP_TX_BATCH_SIZE];
 	unsigned long tx_bytes = 0;
@@ -508,7 +557,7 @@ af_xdp_tx_cp(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 	nb_pkts = RTE_MIN(nb_pkts, ETH_AF_XDP_TX_BATCH_SIZE);
 
-	pull_umem_cq(umem, nb_pkts);
+	pull_umem_cq(umem, nb_pkts, cq);
 
 	nb_pkts = rte_ring_dequeue_bulk(umem->buf_ring, addrs,
 					nb_pkts, NULL);
@@ -516,7 +565,7 @@ af_xdp_tx_cp(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		return 0;
 
 	if (xsk_ring_prod__reserve(&txq->tx, nb_pkts, &idx_tx) != nb_pkts) {
-		kick_tx(txq);
+		kick_tx(txq, cq);
 		rte_ring_enqueue_bulk(umem->buf_ring, addrs, nb_pkts, NULL);
 		return 0;
 	}
@@ -539,7 +588,7 @@ af_xdp_tx_cp(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 	xsk_ring_prod__submit(&txq->tx, nb_pkts);
 
-	kick_tx(txq);
+	kick_tx(txq, cq);
 
 	txq->stats.tx_pkts += nb_pkts;
 	txq->stats.tx_bytes += tx_bytes;
@@ -678,7 +727,7 @@ static void
 xdp_umem_destroy(struct xsk_umem_info *umem)
 {
 #if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
-	rte_mempool_free(umem->mb_pool);
+	/* the mempool belongs to the application, possibly shared */
 	umem->mb_pool = NULL;
 #else
 	rte_memzone_free(umem->mz);
@@ -692,29 +741,53 @@ xdp_umem_destroy(struct xsk_umem_info *umem)
 	umem = NULL;
 }
 
+/* Drop a socket reference, the last one releases the umem. */
+static void
+xdp_umem_put(struct xsk_umem_info *umem)
+{
+	if (__atomic_sub_fetch(&umem->refcnt, 1, __ATOMIC_ACQ_REL) != 0)
+		return;
+
+	(void)xsk_umem__delete(umem->umem);
+	xdp_umem_destroy(umem);
+}
+
 static void
 eth_dev_close(struct rte_eth_dev *dev)
 {
 	struct pmd_internals *internals = dev->data->dev_private;
+	struct internal_list *list;
 	struct pkt_rx_queue *rxq;
 	int i;
 
 	AF_XDP_LOG(INFO, "Closing AF_XDP ethdev on numa socket %u\n",
 		rte_socket_id());
 
+	pthread_mutex_lock(&internal_list_lock);
+
+	TAILQ_FOREACH(list, &internal_list, next) {
+		if (list->eth_dev == dev) {
+			TAILQ_REMOVE(&internal_list, list, next);
+			rte_free(list);
+			break;
+		}
+	}
+
 	for (i = 0; i < internals->queue_cnt; i++) {
 		rxq = &internals->rx_queues[i];
 		if (rxq->umem == NULL)
 			break;
 		xsk_socket__delete(rxq->xsk);
-		(void)xsk_umem__delete(rxq->umem->umem);
-		xdp_umem_destroy(rxq->umem);
+		xdp_umem_put(rxq->umem);
+		rxq->umem = NULL;
 
 		/* free pkt_tx_queue */
 		rte_free(rxq->pair);
 		rte_free(rxq);
 	}
 
+	pthread_mutex_unlock(&internal_list_lock);
+
 	/*
 	 * MAC is not allocated dynamically, setting it to NULL would prevent
 	 * from releasing it in rte_eth_dev_release_port.
@@ -745,11 +818,62 @@ static inline uint64_t get_base_addr(struct rte_mempool *mp)
 	return (uint64_t)memhdr->addr & ~(getpagesize() - 1);
 }
 
+/*
+ * Look for a umem set up by another queue, on this or another port,
+ * from the same mempool. Any umem found has its reference count taken.
+ */
+static int
+get_shared_umem(struct pkt_rx_queue *rxq, const char *if_name,
+		struct xsk_umem_info **umem)
+{
+	struct internal_list *list;
+	struct pmd_internals *internals;
+	struct pkt_rx_queue *list_rxq;
+	int i, ret = 0;
+
+	pthread_mutex_lock(&internal_list_lock);
+
+	TAILQ_FOREACH(list, &internal_list, next) {
+		internals = list->eth_dev->data->dev_private;
+		if (!internals->shared_umem)
+			continue;
+
+		for (i = 0; i < internals->queue_cnt; i++) {
+			list_rxq = &internals->rx_queues[i];
+			if (list_rxq == rxq || list_rxq->umem == NULL ||
+			    list_rxq->mb_pool != rxq->mb_pool)
+				continue;
+
+			/* a netdev queue can only be bound once */
+			if (strncmp(internals->if_name, if_name,
+				    IFNAMSIZ) == 0 &&
+			    list_rxq->xsk_queue_idx == rxq->xsk_queue_idx) {
+				AF_XDP_LOG(ERR, "%s,qid%d is already bound to a umem\n",
+					   if_name, rxq->xsk_queue_idx);
+				ret = -EBUSY;
+				goto out;
+			}
+
+			if (list_rxq->umem->refcnt >= list_rxq->umem->max_xsks)
+				continue;
+
+			*umem = list_rxq->umem;
+			__atomic_add_fetch(&(*umem)->refcnt, 1,
+					   __ATOMIC_ACQ_REL);
+			goto out;
+		}
+	}
+
+out:
+	pthread_mutex_unlock(&internal_list_lock);
+	return ret;
+}
+
 static struct
-xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals __rte_unused,
+xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
 				  struct pkt_rx_queue *rxq)
 {
-	struct xsk_umem_info *umem;
+	struct xsk_umem_info *umem = NULL;
 	int ret;
 	struct xsk_umem_config usr_config = {
 		.fill_size = ETH_AF_XDP_DFLT_NUM_DESCS,
@@ -758,6 +882,17 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals __rte_unused,
 	void *base_addr = NULL;
 	struct rte_mempool *mb_pool = rxq->mb_pool;
 
+	if (internals->shared_umem) {
+		if (get_shared_umem(rxq, internals->if_name, &umem) < 0)
+			return NULL;
+
+		if (umem != NULL) {
+			AF_XDP_LOG(INFO, "%s,qid%d sharing umem\n",
+				   internals->if_name, rxq->xsk_queue_idx);
+			return umem;
+		}
+	}
+
 	usr_config.frame_size = rte_pktmbuf_data_room_size(mb_pool) +
 					ETH_AF_XDP_MBUF_OVERHEAD +
 					mb_pool->private_data_size;
@@ -771,11 +906,15 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals __rte_unused,
 	}
 
 	umem->mb_pool = mb_pool;
+	umem->refcnt = 1;
+	/* every socket on the umem keeps its rings filled from the pool */
+	umem->max_xsks = RTE_MAX(mb_pool->populated_size /
+				 ETH_AF_XDP_NUM_BUFFERS, 1U);
 	base_addr = (void *)get_base_addr(mb_pool);
 
 	ret = xsk_umem__create(&umem->umem, base_addr,
 			       mb_pool->populated_size * usr_config.frame_size,
-			       &umem->fq, &umem->cq,
+			       &rxq->fq, &rxq->cq,
 			       &usr_config);
 
 	if (ret) {
@@ -784,6 +923,10 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals __rte_unused,
 	}
 	umem->buffer = base_addr;
 
+	if (internals->shared_umem)
+		AF_XDP_LOG(INFO, "Max xsks for umem of %s: %u\n",
+			   mb_pool->name, umem->max_xsks);
+
 #else
 static struct
 xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
@@ -806,6 +949,7 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
 		AF_XDP_LOG(ERR, "Failed to allocate umem info");
 		return NULL;
 	}
+	umem->refcnt = 1;
 
 	snprintf(ring_name, sizeof(ring_name), "af_xdp_ring_%s_%u",
 		       internals->if_name, rxq->xsk_queue_idx);
@@ -836,7 +980,7 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
 
 	ret = xsk_umem__create(&umem->umem, mz->addr,
 			       ETH_AF_XDP_NUM_BUFFERS * ETH_AF_XDP_FRAME_SIZE,
-			       &umem->fq, &umem->cq,
+			       &rxq->fq, &rxq->cq,
 			       &usr_config);
 
 	if (ret) {
@@ -853,6 +997,83 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
 	return NULL;
 }
 
+static int
+create_shared_socket(struct xsk_socket **xsk_ptr, const char *ifname,
+		     __u32 queue_id, struct xsk_umem *umem,
+		     struct xsk_ring_cons *rx, struct xsk_ring_prod *tx,
+		     struct xsk_ring_prod *fill, struct xsk_ring_cons *comp,
+		     const struct xsk_socket_config *config)
+{
+#if defined(RTE_LIBRTE_AF_XDP_PMD_SHARED_UMEM)
+	return xsk_socket__create_shared(xsk_ptr, ifname, queue_id, umem, rx,
+					 tx, fill, comp, config);
+#else
+	RTE_SET_USED(xsk_ptr);
+	RTE_SET_USED(ifname);
+	RTE_SET_USED(queue_id);
+	RTE_SET_USED(umem);
+	RTE_SET_USED(rx);
+	RTE_SET_USED(tx);
+	RTE_SET_USED(fill);
+	RTE_SET_USED(comp);
+	RTE_SET_USED(config);
+	return -ENOTSUP;
+#endif
+}
+
+/*
+ * Let the rx burst drive the NAPI context of the queue (kernel >= 5.11).
+ * If the kernel refuses, restore the defaults and carry on without.
+ */
+static int
+configure_preferred_busy_poll(struct pkt_rx_queue *rxq)
+{
+	int fd = xsk_socket__fd(rxq->xsk);
+	int sock_opt;
+
+	sock_opt = 1;
+	if (setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL,
+		       &sock_opt, sizeof(sock_opt)) < 0) {
+		AF_XDP_LOG(WARNING, "Failed to set SO_PREFER_BUSY_POLL\n");
+		goto err_prefer;
+	}
+
+	sock_opt = ETH_AF_XDP_DFLT_BUSY_TIMEOUT;
+	if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL,
+		       &sock_opt, sizeof(sock_opt)) < 0) {
+		AF_XDP_LOG(WARNING, "Failed to set SO_BUSY_POLL\n");
+		goto err_timeout;
+	}
+
+	sock_opt = rxq->busy_budget;
+	if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET,
+		       &sock_opt, sizeof(sock_opt)) == 0) {
+		AF_XDP_LOG(INFO, "Busy polling budget set to: %d\n",
+			   rxq->busy_budget);
+		return 0;
+	}
+	AF_XDP_LOG(WARNING, "Failed to set SO_BUSY_POLL_BUDGET\n");
+
+	sock_opt = 0;
+	if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL,
+		       &sock_opt, sizeof(sock_opt)) < 0) {
+		AF_XDP_LOG(ERR, "Failed to unset SO_BUSY_POLL\n");
+		return -1;
+	}
+
+err_timeout:
+	sock_opt = 0;
+	if (setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL,
+		       &sock_opt, sizeof(sock_opt)) < 0) {
+		AF_XDP_LOG(ERR, "Failed to unset SO_PREFER_BUSY_POLL\n");
+		return -1;
+	}
+
+err_prefer:
+	rxq->busy_budget = 0;
+	return 0;
+}
+
 static int
 xsk_configure(struct pmd_internals *internals, struct pkt_rx_queue *rxq,
 	      int ring_size)
@@ -878,21 +1099,37 @@ xsk_configure(struct pmd_internals *internals, struct pkt_rx_queue *rxq,
 	cfg.bind_flags |= XDP_USE_NEED_WAKEUP;
 #endif
 
-	ret = xsk_socket__create(&rxq->xsk, internals->if_name,
-			rxq->xsk_queue_idx, rxq->umem->umem, &rxq->rx,
-			&txq->tx, &cfg);
+	if (internals->shared_umem)
+		ret = create_shared_socket(&rxq->xsk, internals->if_name,
+				rxq->xsk_queue_idx, rxq->umem->umem, &rxq->rx,
+				&txq->tx, &rxq->fq, &rxq->cq, &cfg);
+	else
+		ret = xsk_socket__create(&rxq->xsk, internals->if_name,
+				rxq->xsk_queue_idx, rxq->umem->umem, &rxq->rx,
+				&txq->tx, &cfg);
 	if (ret) {
 		AF_XDP_LOG(ERR, "Failed to create xsk socket.\n");
 		goto err;
 	}
 
+	if (rxq->busy_budget) {
+		ret = configure_preferred_busy_poll(rxq);
+		if (ret) {
+			xsk_socket__delete(rxq->xsk);
+			AF_XDP_LOG(ERR, "Failed to configure busy polling.\n");
+			goto err;
+		}
+	}
+
 #if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
 	if (rte_pktmbuf_alloc_bulk(rxq->umem->mb_pool, fq_bufs, reserve_size)) {
 		AF_XDP_LOG(DEBUG, "Failed to get enough buffers for fq.\n");
+		xsk_socket__delete(rxq->xsk);
+		ret = -ENOMEM;
 		goto err;
 	}
 #endif
-	ret = reserve_fill_queue(rxq->umem, reserve_size, fq_bufs);
+	ret = reserve_fill_queue(rxq->umem, reserve_size, fq_bufs, &rxq->fq);
 	if (ret) {
 		xsk_socket__delete(rxq->xsk);
 		AF_XDP_LOG(ERR, "Failed to reserve fill queue.\n");
@@ -902,7 +1139,9 @@ xsk_configure(struct pmd_internals *internals, struct pkt_rx_queue *rxq,
 	return 0;
 
 err:
-	xdp_umem_destroy(rxq->umem);
+	xdp_umem_put(rxq->umem);
+	rxq->umem = NULL;
+	txq->umem = NULL;
 
 	return ret;
 }
@@ -1132,7 +1371,7 @@ xdp_get_channels_info(const char *if_name, int *max_queues,
 
 static int
 parse_parameters(struct rte_kvargs *kvlist, char *if_name, int *start_queue,
-			int *queue_cnt)
+			int *queue_cnt, int *shared_umem, int *busy_budget)
 {
 	int ret;
 
@@ -1153,6 +1392,18 @@ parse_parameters(struct rte_kvargs *kvlist, char *if_name, int *start_queue,
 		goto free_kvlist;
 	}
 
+	ret = rte_kvargs_process(kvlist, ETH_AF_XDP_SHARED_UMEM_ARG,
+				 &parse_integer_arg, shared_umem);
+	if (ret < 0)
+		goto free_kvlist;
+
+	ret = rte_kvargs_process(kvlist, ETH_AF_XDP_BUSY_BUDGET_ARG,
+				 &parse_integer_arg, busy_budget);
+	if (ret < 0 || *busy_budget > UINT16_MAX) {
+		ret = -EINVAL;
+		goto free_kvlist;
+	}
+
 free_kvlist:
 	rte_kvargs_free(kvlist);
 	return ret;
@@ -1190,11 +1441,13 @@ get_iface_info(const char *if_name,
 
 static struct rte_eth_dev *
 init_internals(struct rte_vdev_device *dev, const char *if_name,
-			int start_queue_idx, int queue_cnt)
+			int start_queue_idx, int queue_cnt, int shared_umem,
+			int busy_budget)
 {
 	const char *name = rte_vdev_device_name(dev);
 	const unsigned int numa_node = dev->device.numa_node;
 	struct pmd_internals *internals;
+	struct internal_list *list;
 	struct rte_eth_dev *eth_dev;
 	int ret;
 	int i;
@@ -1205,6 +1458,8 @@ init_internals(struct rte_vdev_device *dev, const char *if_name,
 
 	internals->start_queue_idx = start_queue_idx;
 	internals->queue_cnt = queue_cnt;
+	internals->shared_umem = shared_umem;
+	internals->busy_budget = busy_budget;
 	strlcpy(internals->if_name, if_name, IFNAMSIZ);
 
 	if (xdp_get_channels_info(if_name, &internals->max_queue_cnt,
@@ -1240,6 +1495,7 @@ init_internals(struct rte_vdev_device *dev, const char *if_name,
 		internals->rx_queues[i].pair = &internals->tx_queues[i];
 		internals->rx_queues[i].xsk_queue_idx = start_queue_idx + i;
 		internals->tx_queues[i].xsk_queue_idx = start_queue_idx + i;
+		internals->rx_queues[i].busy_budget = busy_budget;
 	}
 
 	ret = get_iface_info(if_name, &internals->eth_addr,
@@ -1247,9 +1503,15 @@ init_internals(struct rte_vdev_device *dev, const char *if_name,
 	if (ret)
 		goto err_free_tx;
 
+	list = rte_zmalloc_socket(name, sizeof(*list), 0, numa_node);
+	if (list == NULL)
+		goto err_free_tx;
+
 	eth_dev = rte_eth_vdev_allocate(dev, 0);
-	if (eth_dev == NULL)
+	if (eth_dev == NULL) {
+		rte_free(list);
 		goto err_free_tx;
+	}
 
 	eth_dev->data->dev_private = internals;
 	eth_dev->data->dev_link = pmd_link;
@@ -1264,6 +1526,11 @@ init_internals(struct rte_vdev_device *dev, const char *if_name,
 	AF_XDP_LOG(INFO, "Zero copy between umem and mbuf enabled.\n");
 #endif
 
+	list->eth_dev = eth_dev;
+	pthread_mutex_lock(&internal_list_lock);
+	TAILQ_INSERT_TAIL(&internal_list, list, next);
+	pthread_mutex_unlock(&internal_list_lock);
+
 	return eth_dev;
 
 err_free_tx:
@@ -1282,6 +1549,8 @@ rte_pmd_af_xdp_probe(struct rte_vdev_device *dev)
 	char if_name[IFNAMSIZ] = {'\0'};
 	int xsk_start_queue_idx = ETH_AF_XDP_DFLT_START_QUEUE_IDX;
 	int xsk_queue_cnt = ETH_AF_XDP_DFLT_QUEUE_COUNT;
+	int shared_umem = 0;
+	int busy_budget = ETH_AF_XDP_DFLT_BUSY_BUDGET;
 	struct rte_eth_dev *eth_dev = NULL;
 	const char *name;
 
@@ -1311,18 +1580,26 @@ rte_pmd_af_xdp_probe(struct rte_vdev_device *dev)
 		dev->device.numa_node = rte_socket_id();
 
 	if (parse_parameters(kvlist, if_name, &xsk_start_queue_idx,
-			     &xsk_queue_cnt) < 0) {
+			     &xsk_queue_cnt, &shared_umem, &busy_budget) < 0) {
 		AF_XDP_LOG(ERR, "Invalid kvargs value\n");
 		return -EINVAL;
 	}
 
+#if !defined(RTE_LIBRTE_AF_XDP_PMD_SHARED_UMEM) || \
+	!defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+	if (shared_umem) {
+		AF_XDP_LOG(ERR, "Shared umem requires zero copy support and libbpf with xsk_socket__create_shared()\n");
+		return -EINVAL;
+	}
+#endif
+
 	if (strlen(if_name) == 0) {
 		AF_XDP_LOG(ERR, "Network interface must be specified\n");
 		return -EINVAL;
 	}
 
 	eth_dev = init_internals(dev, if_name, xsk_start_queue_idx,
-					xsk_queue_cnt);
+					xsk_queue_cnt, shared_umem, busy_budget);
 	if (eth_dev == NULL) {
 		AF_XDP_LOG(ERR, "Failed to init internals\n");
 		return -1;
@@ -1365,7 +1642,9 @@ RTE_PMD_REGISTER_VDEV(net_af_xdp, pmd_af_xdp_drv);
 RTE_PMD_REGISTER_PARAM_STRING(net_af_xdp,
 			      "iface=<string> "
 			      "start_queue=<int> "
-			      "queue_count=<int> ");
+			      "queue_count=<int> "
+			      "shared_umem=<int> "
+			      "busy_budget=<int> ");
 
 RTE_INIT(af_xdp_init_log)
 {
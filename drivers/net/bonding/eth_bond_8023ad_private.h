@@ -10,6 +10,8 @@
 #include <rte_ether.h>
 #include <rte_byteorder.h>
 #include <rte_atomic.h>
+#include <rte_ring.h>
+#include <rte_spinlock.h>
 #include <rte_flow.h>
 
 #include "rte_eth_bond_8023ad.h"
@@ -175,6 +177,19 @@ struct mode8023ad_private {
 		uint16_t tx_qid;
 	} dedicated_queues;
 	enum rte_bond_8023ad_agg_selection agg_selection;
+
+	/**
+	 * Active slaves in DISTRIBUTING state, copied by the tx burst
+	 * functions without locking. dist_seq is odd while the list is
+	 * being updated, readers retry their copy if it changed meanwhile.
+	 */
+	uint16_t dist_count;
+	uint16_t dist_slaves[RTE_MAX_ETHPORTS];
+	uint32_t dist_seq;
+	rte_spinlock_t dist_lock;	/**< serializes list updates */
+
+	/** Number of LACP packets waiting in the slaves tx_ring */
+	rte_atomic32_t tx_ring_count;
 };
 
 /**
@@ -225,6 +240,52 @@ bond_mode_8023ad_enable(struct rte_eth_dev *dev);
  */
 int bond_mode_8023ad_disable(struct rte_eth_dev *dev);
 
+/**
+ * @internal
+ *
+ * Rebuilds and publishes the list of slaves in DISTRIBUTING state, after
+ * the active slaves or their state changed.
+ * @param internals Bonded device private data.
+ */
+void
+bond_mode_8023ad_dist_update(struct bond_dev_private *internals);
+
+/**
+ * @internal
+ *
+ * Queues a LACP control packet to be sent by the tx burst functions.
+ * @return
+ *   0 on success, -ENOBUFS if the slave tx_ring is full.
+ */
+static inline int
+bond_mode_8023ad_tx_ring_enqueue(struct mode8023ad_private *mode4,
+		struct port *port, struct rte_mbuf *pkt)
+{
+	int retval = rte_ring_enqueue(port->tx_ring, pkt);
+
+	if (retval == 0)
+		rte_atomic32_inc(&mode4->tx_ring_count);
+	return retval;
+}
+
+/**
+ * @internal
+ *
+ * Takes a LACP control packet queued for a slave.
+ * @return
+ *   0 on success, -ENOENT if there is none.
+ */
+static inline int
+bond_mode_8023ad_tx_ring_dequeue(struct mode8023ad_private *mode4,
+		struct port *port, struct rte_mbuf **pkt)
+{
+	int retval = rte_ring_dequeue(port->tx_ring, (void **)pkt);
+
+	if (retval == 0)
+		rte_atomic32_dec(&mode4->tx_ring_count);
+	return retval;
+}
+
 /**
  * @internal
  *
@@ -32,6 +32,7 @@
 #define PMD_BOND_XMIT_POLICY_LAYER2_KVARG	("l2")
 #define PMD_BOND_XMIT_POLICY_LAYER23_KVARG	("l23")
 #define PMD_BOND_XMIT_POLICY_LAYER34_KVARG	("l34")
+#define PMD_BOND_XMIT_POLICY_RSS_KVARG		("rss")
 
 extern int bond_logtype;
 
@@ -116,7 +117,7 @@ struct bond_dev_private {
 	/**< Flag for whether primary port is user defined or not */
 
 	uint8_t balance_xmit_policy;
-	/**< Transmit policy - l2 / l23 / l34 for operation in balance mode */
+	/**< Transmit policy - l2 / l23 / l34 / rss for operation in balance mode */
 	burst_xmit_hash_t burst_xmit_hash;
 	/**< Transmit policy hash function */
 
@@ -265,6 +266,10 @@ void
 burst_xmit_l34_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
 		uint16_t slave_count, uint16_t *slaves);
 
+void
+burst_xmit_rss_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint16_t slave_count, uint16_t *slaves);
+
 
 void
 bond_ethdev_primary_set(struct bond_dev_private *internals,
@@ -87,6 +87,8 @@ extern "C" {
 /**< Layer 2+3 (Ethernet MAC + IP Addresses) transmit load balancing */
 #define BALANCE_XMIT_POLICY_LAYER34		(2)
 /**< Layer 3+4 (IP Addresses + UDP Ports) transmit load balancing */
+#define BALANCE_XMIT_POLICY_RSS			(3)
+/**< RSS hash computed by the receiving NIC, or layer 3+4 if not available */
 
 /**
  * Create a bonded rte_eth_dev device
@@ -615,7 +615,8 @@ tx_machine(struct bond_dev_private *internals, uint16_t slave_id)
 	BOND_PRINT_LACP(lacpdu);
 
 	if (internals->mode4.dedicated_queues.enabled == 0) {
-		int retval = rte_ring_enqueue(port->tx_ring, lacp_pkt);
+		int retval = bond_mode_8023ad_tx_ring_enqueue(&internals->mode4,
+				port, lacp_pkt);
 		if (retval != 0) {
 			/* If TX ring full, drop packet and free message.
 			   Retransmission will happen in next function call. */
@@ -918,6 +919,8 @@ bond_mode_8023ad_periodic_cb(void *arg)
 		show_warnings(slave_id);
 	}
 
+	bond_mode_8023ad_dist_update(internals);
+
 	rte_eal_alarm_set(internals->mode4.update_timeout_us,
 			bond_mode_8023ad_periodic_cb, arg);
 }
@@ -1091,9 +1094,11 @@ bond_mode_8023ad_activate_slave(struct rte_eth_dev *bond_dev,
 }
 
 int
-bond_mode_8023ad_deactivate_slave(struct rte_eth_dev *bond_dev __rte_unused,
+bond_mode_8023ad_deactivate_slave(struct rte_eth_dev *bond_dev,
 		uint16_t slave_id)
 {
+	struct bond_dev_private *internals = bond_dev->data->dev_private;
+	struct rte_mbuf *tx_pkt;
 	void *pkt = NULL;
 	struct port *port = NULL;
 	uint8_t old_partner_state;
@@ -1120,8 +1125,9 @@ bond_mode_8023ad_deactivate_slave(struct rte_eth_dev *bond_dev __rte_unused,
 	while (rte_ring_dequeue(port->rx_ring, &pkt) == 0)
 		rte_pktmbuf_free((struct rte_mbuf *)pkt);
 
-	while (rte_ring_dequeue(port->tx_ring, &pkt) == 0)
-			rte_pktmbuf_free((struct rte_mbuf *)pkt);
+	while (bond_mode_8023ad_tx_ring_dequeue(&internals->mode4, port,
+			&tx_pkt) == 0)
+		rte_pktmbuf_free(tx_pkt);
 	return 0;
 }
 
@@ -1250,6 +1256,39 @@ bond_mode_8023ad_enable(struct rte_eth_dev *bond_dev)
 	return 0;
 }
 
+void
+bond_mode_8023ad_dist_update(struct bond_dev_private *internals)
+{
+	struct mode8023ad_private *mode4 = &internals->mode4;
+	uint16_t slaves[RTE_MAX_ETHPORTS];
+	uint16_t i, count, slave_id;
+	uint32_t seq;
+
+	rte_spinlock_lock(&mode4->dist_lock);
+
+	count = 0;
+	for (i = 0; i < internals->active_slave_count; i++) {
+		slave_id = internals->active_slaves[i];
+		if (ACTOR_STATE(&bond_mode_8023ad_ports[slave_id],
+				DISTRIBUTING))
+			slaves[count++] = slave_id;
+	}
+
+	/* only publish changes, readers retry while the list is written */
+	if (count != mode4->dist_count ||
+			memcmp(slaves, mode4->dist_slaves,
+				count * sizeof(slaves[0])) != 0) {
+		seq = mode4->dist_seq;
+		__atomic_store_n(&mode4->dist_seq, seq + 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		memcpy(mode4->dist_slaves, slaves, count * sizeof(slaves[0]));
+		mode4->dist_count = count;
+		__atomic_store_n(&mode4->dist_seq, seq + 2, __ATOMIC_RELEASE);
+	}
+
+	rte_spinlock_unlock(&mode4->dist_lock);
+}
+
 int
 bond_mode_8023ad_start(struct rte_eth_dev *bond_dev)
 {
@@ -1320,7 +1359,8 @@ bond_mode_8023ad_handle_slow_pkt(struct bond_dev_private *internals,
 		rte_eth_macaddr_get(slave_id, &m_hdr->eth_hdr.s_addr);
 
 		if (internals->mode4.dedicated_queues.enabled == 0) {
-			int retval = rte_ring_enqueue(port->tx_ring, pkt);
+			int retval = bond_mode_8023ad_tx_ring_enqueue(mode4,
+					port, pkt);
 			if (retval != 0) {
 				/* reset timer */
 				port->rx_marker_timer = 0;
@@ -1570,6 +1610,8 @@ rte_eth_bond_8023ad_ext_distrib(uint16_t port_id, uint16_t slave_id,
 	else
 		ACTOR_STATE_CLR(port, DISTRIBUTING);
 
+	bond_mode_8023ad_dist_update(rte_eth_devices[port_id].data->dev_private);
+
 	return 0;
 }
 
@@ -1605,6 +1647,7 @@ int
 rte_eth_bond_8023ad_ext_slowtx(uint16_t port_id, uint16_t slave_id,
 		struct rte_mbuf *lacp_pkt)
 {
+	struct bond_dev_private *internals;
 	struct port *port;
 	int res;
 
@@ -1626,7 +1669,9 @@ rte_eth_bond_8023ad_ext_slowtx(uint16_t port_id, uint16_t slave_id,
 
 	MODE4_DEBUG("sending LACP frame\n");
 
-	return rte_ring_enqueue(port->tx_ring, lacp_pkt);
+	internals = rte_eth_devices[port_id].data->dev_private;
+	return bond_mode_8023ad_tx_ring_enqueue(&internals->mode4, port,
+			lacp_pkt);
 }
 
 static void
@@ -1658,6 +1703,8 @@ bond_mode_8023ad_ext_periodic_cb(void *arg)
 		}
 	}
 
+	bond_mode_8023ad_dist_update(internals);
+
 	rte_eal_alarm_set(internals->mode4.update_timeout_us,
 			bond_mode_8023ad_ext_periodic_cb, arg);
 }
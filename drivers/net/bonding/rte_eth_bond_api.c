@@ -93,6 +93,8 @@ activate_slave(struct rte_eth_dev *eth_dev, uint16_t port_id)
 	internals->active_slaves[internals->active_slave_count] = port_id;
 	internals->active_slave_count++;
 
+	if (internals->mode == BONDING_MODE_8023AD)
+		bond_mode_8023ad_dist_update(internals);
 	if (internals->mode == BONDING_MODE_TLB)
 		bond_tlb_activate_slave(internals);
 	if (internals->mode == BONDING_MODE_ALB)
@@ -129,6 +131,9 @@ deactivate_slave(struct rte_eth_dev *eth_dev, uint16_t port_id)
 	RTE_ASSERT(active_count < RTE_DIM(internals->active_slaves));
 	internals->active_slave_count = active_count;
 
+	if (internals->mode == BONDING_MODE_8023AD)
+		bond_mode_8023ad_dist_update(internals);
+
 	/* Resetting active_slave when reaches to max
 	 * no of slaves in active list
 	 */
@@ -947,6 +952,10 @@ rte_eth_bond_xmit_policy_set(uint16_t bonded_port_id, uint8_t policy)
 		internals->balance_xmit_policy = policy;
 		internals->burst_xmit_hash = burst_xmit_l34_hash;
 		break;
+	case BALANCE_XMIT_POLICY_RSS:
+		internals->balance_xmit_policy = policy;
+		internals->burst_xmit_hash = burst_xmit_rss_hash;
+		break;
 
 	default:
 		return -1;
@@ -19,6 +19,7 @@
 #include <rte_alarm.h>
 #include <rte_cycles.h>
 #include <rte_string_fns.h>
+#include <rte_pause.h>
 
 #include "rte_eth_bond.h"
 #include "eth_bond_private.h"
@@ -677,135 +678,201 @@ ipv6_hash(struct rte_ipv6_hdr *ipv6_hdr)
 }
 
 
-void
-burst_xmit_l2_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
-		uint16_t slave_count, uint16_t *slaves)
+/* Packets ahead of the one being hashed whose headers are prefetched */
+#define BOND_XMIT_HASH_PREFETCH_OFFSET 4
+
+static inline uint32_t
+xmit_l2_hash(struct rte_mbuf *m)
 {
 	struct rte_ether_hdr *eth_hdr;
 	uint32_t hash;
-	int i;
 
-	for (i = 0; i < nb_pkts; i++) {
-		eth_hdr = rte_pktmbuf_mtod(buf[i], struct rte_ether_hdr *);
+	eth_hdr = rte_pktmbuf_mtod(m, struct rte_ether_hdr *);
 
-		hash = ether_hash(eth_hdr);
+	hash = ether_hash(eth_hdr);
 
-		slaves[i] = (hash ^= hash >> 8) % slave_count;
-	}
+	return hash ^ (hash >> 8);
 }
 
-void
-burst_xmit_l23_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
-		uint16_t slave_count, uint16_t *slaves)
+static inline uint32_t
+xmit_l23_hash(struct rte_mbuf *m)
 {
-	uint16_t i;
 	struct rte_ether_hdr *eth_hdr;
 	uint16_t proto;
 	size_t vlan_offset;
 	uint32_t hash, l3hash;
 
-	for (i = 0; i < nb_pkts; i++) {
-		eth_hdr = rte_pktmbuf_mtod(buf[i], struct rte_ether_hdr *);
-		l3hash = 0;
+	eth_hdr = rte_pktmbuf_mtod(m, struct rte_ether_hdr *);
+	l3hash = 0;
 
-		proto = eth_hdr->ether_type;
-		hash = ether_hash(eth_hdr);
+	proto = eth_hdr->ether_type;
+	hash = ether_hash(eth_hdr);
 
-		vlan_offset = get_vlan_offset(eth_hdr, &proto);
+	vlan_offset = get_vlan_offset(eth_hdr, &proto);
 
-		if (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) == proto) {
-			struct rte_ipv4_hdr *ipv4_hdr = (struct rte_ipv4_hdr *)
-					((char *)(eth_hdr + 1) + vlan_offset);
-			l3hash = ipv4_hash(ipv4_hdr);
+	if (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) == proto) {
+		struct rte_ipv4_hdr *ipv4_hdr = (struct rte_ipv4_hdr *)
+				((char *)(eth_hdr + 1) + vlan_offset);
+		l3hash = ipv4_hash(ipv4_hdr);
 
-		} else if (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) == proto) {
-			struct rte_ipv6_hdr *ipv6_hdr = (struct rte_ipv6_hdr *)
-					((char *)(eth_hdr + 1) + vlan_offset);
-			l3hash = ipv6_hash(ipv6_hdr);
-		}
+	} else if (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) == proto) {
+		struct rte_ipv6_hdr *ipv6_hdr = (struct rte_ipv6_hdr *)
+				((char *)(eth_hdr + 1) + vlan_offset);
+		l3hash = ipv6_hash(ipv6_hdr);
+	}
 
-		hash = hash ^ l3hash;
-		hash ^= hash >> 16;
-		hash ^= hash >> 8;
+	hash = hash ^ l3hash;
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
 
-		slaves[i] = hash % slave_count;
-	}
+	return hash;
 }
 
-void
-burst_xmit_l34_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
-		uint16_t slave_count, uint16_t *slaves)
+static inline uint32_t
+xmit_l34_hash(struct rte_mbuf *m)
 {
 	struct rte_ether_hdr *eth_hdr;
 	uint16_t proto;
 	size_t vlan_offset;
-	int i;
 
 	struct rte_udp_hdr *udp_hdr;
 	struct rte_tcp_hdr *tcp_hdr;
 	uint32_t hash, l3hash, l4hash;
 
-	for (i = 0; i < nb_pkts; i++) {
-		eth_hdr = rte_pktmbuf_mtod(buf[i], struct rte_ether_hdr *);
-		size_t pkt_end = (size_t)eth_hdr + rte_pktmbuf_data_len(buf[i]);
-		proto = eth_hdr->ether_type;
-		vlan_offset = get_vlan_offset(eth_hdr, &proto);
-		l3hash = 0;
-		l4hash = 0;
-
-		if (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) == proto) {
-			struct rte_ipv4_hdr *ipv4_hdr = (struct rte_ipv4_hdr *)
-					((char *)(eth_hdr + 1) + vlan_offset);
-			size_t ip_hdr_offset;
-
-			l3hash = ipv4_hash(ipv4_hdr);
-
-			/* there is no L4 header in fragmented packet */
-			if (likely(rte_ipv4_frag_pkt_is_fragmented(ipv4_hdr)
-								== 0)) {
-				ip_hdr_offset = (ipv4_hdr->version_ihl
-					& RTE_IPV4_HDR_IHL_MASK) *
-					RTE_IPV4_IHL_MULTIPLIER;
-
-				if (ipv4_hdr->next_proto_id == IPPROTO_TCP) {
-					tcp_hdr = (struct rte_tcp_hdr *)
-						((char *)ipv4_hdr +
-							ip_hdr_offset);
-					if ((size_t)tcp_hdr + sizeof(*tcp_hdr)
-							< pkt_end)
-						l4hash = HASH_L4_PORTS(tcp_hdr);
-				} else if (ipv4_hdr->next_proto_id ==
-								IPPROTO_UDP) {
-					udp_hdr = (struct rte_udp_hdr *)
-						((char *)ipv4_hdr +
-							ip_hdr_offset);
-					if ((size_t)udp_hdr + sizeof(*udp_hdr)
-							< pkt_end)
-						l4hash = HASH_L4_PORTS(udp_hdr);
-				}
-			}
-		} else if  (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) == proto) {
-			struct rte_ipv6_hdr *ipv6_hdr = (struct rte_ipv6_hdr *)
-					((char *)(eth_hdr + 1) + vlan_offset);
-			l3hash = ipv6_hash(ipv6_hdr);
-
-			if (ipv6_hdr->proto == IPPROTO_TCP) {
-				tcp_hdr = (struct rte_tcp_hdr *)(ipv6_hdr + 1);
-				l4hash = HASH_L4_PORTS(tcp_hdr);
-			} else if (ipv6_hdr->proto == IPPROTO_UDP) {
-				udp_hdr = (struct rte_udp_hdr *)(ipv6_hdr + 1);
-				l4hash = HASH_L4_PORTS(udp_hdr);
+	eth_hdr = rte_pktmbuf_mtod(m, struct rte_ether_hdr *);
+	size_t pkt_end = (size_t)eth_hdr + rte_pktmbuf_data_len(m);
+	proto = eth_hdr->ether_type;
+	vlan_offset = get_vlan_offset(eth_hdr, &proto);
+	l3hash = 0;
+	l4hash = 0;
+
+	if (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) == proto) {
+		struct rte_ipv4_hdr *ipv4_hdr = (struct rte_ipv4_hdr *)
+				((char *)(eth_hdr + 1) + vlan_offset);
+		size_t ip_hdr_offset;
+
+		l3hash = ipv4_hash(ipv4_hdr);
+
+		/* there is no L4 header in fragmented packet */
+		if (likely(rte_ipv4_frag_pkt_is_fragmented(ipv4_hdr) == 0)) {
+			ip_hdr_offset = (ipv4_hdr->version_ihl
+				& RTE_IPV4_HDR_IHL_MASK) *
+				RTE_IPV4_IHL_MULTIPLIER;
+
+			if (ipv4_hdr->next_proto_id == IPPROTO_TCP) {
+				tcp_hdr = (struct rte_tcp_hdr *)
+					((char *)ipv4_hdr + ip_hdr_offset);
+				if ((size_t)tcp_hdr + sizeof(*tcp_hdr)
+						< pkt_end)
+					l4hash = HASH_L4_PORTS(tcp_hdr);
+			} else if (ipv4_hdr->next_proto_id == IPPROTO_UDP) {
+				udp_hdr = (struct rte_udp_hdr *)
+					((char *)ipv4_hdr + ip_hdr_offset);
+				if ((size_t)udp_hdr + sizeof(*udp_hdr)
+						< pkt_end)
+					l4hash = HASH_L4_PORTS(udp_hdr);
 			}
 		}
+	} else if (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) == proto) {
+		struct rte_ipv6_hdr *ipv6_hdr = (struct rte_ipv6_hdr *)
+				((char *)(eth_hdr + 1) + vlan_offset);
+		l3hash = ipv6_hash(ipv6_hdr);
+
+		if (ipv6_hdr->proto == IPPROTO_TCP) {
+			tcp_hdr = (struct rte_tcp_hdr *)(ipv6_hdr + 1);
+			l4hash = HASH_L4_PORTS(tcp_hdr);
+		} else if (ipv6_hdr->proto == IPPROTO_UDP) {
+			udp_hdr = (struct rte_udp_hdr *)(ipv6_hdr + 1);
+			l4hash = HASH_L4_PORTS(udp_hdr);
+		}
+	}
 
-		hash = l3hash ^ l4hash;
-		hash ^= hash >> 16;
-		hash ^= hash >> 8;
+	hash = l3hash ^ l4hash;
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
 
-		slaves[i] = hash % slave_count;
+	return hash;
+}
+
+/*
+ * Header parsing is too branchy to be vectorized, so the burst is
+ * pipelined instead: the headers of the next packets are prefetched
+ * while the current one is hashed.
+ */
+static __rte_always_inline void
+burst_xmit_hash_prefetch(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint16_t slave_count, uint16_t *slaves,
+		uint32_t (*hash_fn)(struct rte_mbuf *))
+{
+	uint16_t i;
+
+	for (i = 0; i < RTE_MIN(nb_pkts, BOND_XMIT_HASH_PREFETCH_OFFSET); i++)
+		rte_prefetch0(rte_pktmbuf_mtod(buf[i], void *));
+
+	for (i = 0; i < nb_pkts; i++) {
+		if (i + BOND_XMIT_HASH_PREFETCH_OFFSET < nb_pkts)
+			rte_prefetch0(rte_pktmbuf_mtod(
+				buf[i + BOND_XMIT_HASH_PREFETCH_OFFSET],
+				void *));
+		slaves[i] = hash_fn(buf[i]) % slave_count;
 	}
 }
 
+void
+burst_xmit_l2_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint16_t slave_count, uint16_t *slaves)
+{
+	burst_xmit_hash_prefetch(buf, nb_pkts, slave_count, slaves,
+			xmit_l2_hash);
+}
+
+void
+burst_xmit_l23_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint16_t slave_count, uint16_t *slaves)
+{
+	burst_xmit_hash_prefetch(buf, nb_pkts, slave_count, slaves,
+			xmit_l23_hash);
+}
+
+void
+burst_xmit_l34_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint16_t slave_count, uint16_t *slaves)
+{
+	burst_xmit_hash_prefetch(buf, nb_pkts, slave_count, slaves,
+			xmit_l34_hash);
+}
+
+static inline uint32_t
+xmit_rss_hash(struct rte_mbuf *m)
+{
+	uint32_t hash;
+
+	/* hash of packets which did not come from a NIC with RSS */
+	if (unlikely(!(m->ol_flags & PKT_RX_RSS_HASH)))
+		return xmit_l34_hash(m);
+
+	/*
+	 * Fold the high bits, the low ones also select the rx queue
+	 * through the RETA and would map each queue to a single slave.
+	 */
+	hash = m->hash.rss;
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+
+	return hash;
+}
+
+void
+burst_xmit_rss_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint16_t slave_count, uint16_t *slaves)
+{
+	uint16_t i;
+
+	/* packet data is only read by the fallback, no prefetch */
+	for (i = 0; i < nb_pkts; i++)
+		slaves[i] = xmit_rss_hash(buf[i]) % slave_count;
+}
+
 struct bwg_slave {
 	uint64_t bwg_left_int;
 	uint64_t bwg_left_remainder;
@@ -1208,19 +1275,16 @@ bond_ethdev_tx_burst_balance(void *queue, struct rte_mbuf **bufs,
 				slave_count);
 }
 
-static inline uint16_t
-tx_burst_8023ad(void *queue, struct rte_mbuf **bufs, uint16_t nb_bufs,
-		bool dedicated_txq)
+/* Send the LACP control packets queued by the mode 4 state machines */
+static void
+tx_burst_8023ad_ctrl(struct bond_tx_queue *bd_tx_q)
 {
-	struct bond_tx_queue *bd_tx_q = (struct bond_tx_queue *)queue;
 	struct bond_dev_private *internals = bd_tx_q->dev_private;
+	struct mode8023ad_private *mode4 = &internals->mode4;
 
 	uint16_t slave_port_ids[RTE_MAX_ETHPORTS];
 	uint16_t slave_count;
 
-	uint16_t dist_slave_port_ids[RTE_MAX_ETHPORTS];
-	uint16_t dist_slave_count;
-
 	uint16_t slave_tx_count;
 
 	uint16_t i;
@@ -1228,16 +1292,9 @@ tx_burst_8023ad(void *queue, struct rte_mbuf **bufs, uint16_t nb_bufs,
 	/* Copy slave list to protect against slave up/down changes during tx
 	 * bursting */
 	slave_count = internals->active_slave_count;
-	if (unlikely(slave_count < 1))
-		return 0;
-
 	memcpy(slave_port_ids, internals->active_slaves,
 			sizeof(slave_port_ids[0]) * slave_count);
 
-	if (dedicated_txq)
-		goto skip_tx_ring;
-
-	/* Check for LACP control packets and send if available */
 	for (i = 0; i < slave_count; i++) {
 		struct port *port = &bond_mode_8023ad_ports[slave_port_ids[i]];
 		struct rte_mbuf *ctrl_pkt = NULL;
@@ -1245,32 +1302,64 @@ tx_burst_8023ad(void *queue, struct rte_mbuf **bufs, uint16_t nb_bufs,
 		if (likely(rte_ring_empty(port->tx_ring)))
 			continue;
 
-		if (rte_ring_dequeue(port->tx_ring,
-				     (void **)&ctrl_pkt) != -ENOENT) {
+		if (bond_mode_8023ad_tx_ring_dequeue(mode4, port,
+				&ctrl_pkt) == 0) {
 			slave_tx_count = rte_eth_tx_burst(slave_port_ids[i],
 					bd_tx_q->queue_id, &ctrl_pkt, 1);
 			/*
 			 * re-enqueue LAG control plane packets to buffering
 			 * ring if transmission fails so the packet isn't lost.
 			 */
-			if (slave_tx_count != 1)
-				rte_ring_enqueue(port->tx_ring,	ctrl_pkt);
+			if (slave_tx_count != 1 &&
+			    bond_mode_8023ad_tx_ring_enqueue(mode4, port,
+					ctrl_pkt) != 0)
+				rte_pktmbuf_free(ctrl_pkt);
 		}
 	}
+}
+
+static inline uint16_t
+tx_burst_8023ad(void *queue, struct rte_mbuf **bufs, uint16_t nb_bufs,
+		bool dedicated_txq)
+{
+	struct bond_tx_queue *bd_tx_q = (struct bond_tx_queue *)queue;
+	struct bond_dev_private *internals = bd_tx_q->dev_private;
+	struct mode8023ad_private *mode4 = &internals->mode4;
+
+	uint16_t dist_slave_port_ids[RTE_MAX_ETHPORTS];
+	uint16_t dist_slave_count;
+	uint32_t seq;
+
+	/*
+	 * The state machines count the LACP packets they queue, so the
+	 * slave rings are only looked at when there is one to send.
+	 */
+	if (!dedicated_txq &&
+	    unlikely(rte_atomic32_read(&mode4->tx_ring_count) > 0))
+		tx_burst_8023ad_ctrl(bd_tx_q);
 
-skip_tx_ring:
 	if (unlikely(nb_bufs == 0))
 		return 0;
 
-	dist_slave_count = 0;
-	for (i = 0; i < slave_count; i++) {
-		struct port *port = &bond_mode_8023ad_ports[slave_port_ids[i]];
-
-		if (ACTOR_STATE(port, DISTRIBUTING))
-			dist_slave_port_ids[dist_slave_count++] =
-					slave_port_ids[i];
+	/*
+	 * Copy the slaves in DISTRIBUTING state, as published by the
+	 * control path, and retry if the list changed during the copy.
+	 */
+	for (;;) {
+		seq = __atomic_load_n(&mode4->dist_seq, __ATOMIC_ACQUIRE);
+		if (unlikely(seq & 1)) {
+			rte_pause();
+			continue;
+		}
+		dist_slave_count = RTE_MIN(mode4->dist_count,
+				(uint16_t)RTE_MAX_ETHPORTS);
+		memcpy(dist_slave_port_ids, mode4->dist_slaves,
+			dist_slave_count * sizeof(dist_slave_port_ids[0]));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (likely(__atomic_load_n(&mode4->dist_seq,
+				__ATOMIC_RELAXED) == seq))
+			break;
 	}
-
 	if (unlikely(dist_slave_count < 1))
 		return 0;
 
@@ -2050,6 +2139,7 @@ bond_ethdev_stop(struct rte_eth_dev *eth_dev)
 	uint16_t i;
 
 	if (internals->mode == BONDING_MODE_8023AD) {
+		struct rte_mbuf *ctrl_pkt;
 		struct port *port;
 		void *pkt = NULL;
 
@@ -2064,8 +2154,10 @@ bond_ethdev_stop(struct rte_eth_dev *eth_dev)
 				rte_pktmbuf_free(pkt);
 
 			RTE_ASSERT(port->tx_ring != NULL);
-			while (rte_ring_dequeue(port->tx_ring, &pkt) != -ENOENT)
-				rte_pktmbuf_free(pkt);
+			while (bond_mode_8023ad_tx_ring_dequeue(
+					&internals->mode4, port,
+					&ctrl_pkt) == 0)
+				rte_pktmbuf_free(ctrl_pkt);
 		}
 	}
 
@@ -3206,6 +3298,7 @@ bond_alloc(struct rte_vdev_device *dev, uint8_t mode)
 
 	rte_spinlock_init(&internals->lock);
 	rte_spinlock_init(&internals->lsc_lock);
+	rte_spinlock_init(&internals->mode4.dist_lock);
 
 	internals->port_id = eth_dev->data->port_id;
 	internals->mode = BONDING_MODE_INVALID;
@@ -16,6 +16,7 @@
 
 #include <rte_version.h>
 #include <rte_mbuf.h>
+#include <rte_memcpy.h>
 #include <rte_ether.h>
 #include <rte_ethdev_driver.h>
 #include <rte_ethdev_vdev.h>
@@ -38,6 +39,7 @@
 #define ETH_MEMIF_SOCKET_ARG		"socket"
 #define ETH_MEMIF_MAC_ARG		"mac"
 #define ETH_MEMIF_ZC_ARG		"zero-copy"
+#define ETH_MEMIF_RX_ZC_ARG		"rx-zero-copy"
 #define ETH_MEMIF_SECRET_ARG		"secret"
 
 static const char * const valid_arguments[] = {
@@ -48,6 +50,7 @@ static const char * const valid_arguments[] = {
 	ETH_MEMIF_SOCKET_ARG,
 	ETH_MEMIF_MAC_ARG,
 	ETH_MEMIF_ZC_ARG,
+	ETH_MEMIF_RX_ZC_ARG,
 	ETH_MEMIF_SECRET_ARG,
 	NULL
 };
@@ -166,6 +169,7 @@ memif_mp_request_regions(struct rte_eth_dev *dev)
 			}
 			r->fd = reply->fds[0];
 			r->addr = NULL;
+			r->refcnt = 1;
 
 			proc_private->regions[reply_param->idx] = r;
 			proc_private->regions_num++;
@@ -327,6 +331,86 @@ eth_memif_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		goto refill;
 	n_slots = last_slot - cur_slot;
 
+	if (likely(mbuf_size >= pmd->run.pkt_buffer_size)) {
+		/* Every buffer fits in one mbuf: allocate mbufs in bulk,
+		 * copy each buffer at once and prefetch the next one.
+		 */
+		struct rte_mbuf *mbufs[ETH_MEMIF_RX_BURST];
+		uint16_t i, n, pkt_slot;
+
+		while (n_slots && n_rx_pkts < nb_pkts) {
+			n = RTE_MIN(nb_pkts - n_rx_pkts, n_slots);
+			n = RTE_MIN(n, ETH_MEMIF_RX_BURST);
+			if (unlikely(rte_pktmbuf_alloc_bulk(mq->mempool,
+							    mbufs, n) < 0))
+				goto no_free_bufs;
+
+			for (i = 0; i < n && n_slots; i++) {
+				mbuf_head = mbufs[i];
+				mbuf = mbuf_head;
+				pkt_slot = cur_slot;
+next_slot1:
+				d0 = &ring->desc[cur_slot & mask];
+				if (unlikely(d0->length > mbuf_size)) {
+					/* a peer in zero-copy mode may use larger
+					 * buffers, segment the packet below
+					 */
+					n_slots += cur_slot - pkt_slot;
+					cur_slot = pkt_slot;
+					rte_pktmbuf_free_bulk(&mbufs[i], n - i);
+					goto copy_segmented;
+				}
+				if (n_slots > 1)
+					rte_prefetch0(memif_get_buffer(proc_private,
+						&ring->desc[(cur_slot + 1) & mask]));
+
+				mbuf->port = mq->in_port;
+				cp_len = d0->length;
+				rte_pktmbuf_data_len(mbuf) = cp_len;
+				rte_pktmbuf_pkt_len(mbuf) = cp_len;
+				if (mbuf != mbuf_head)
+					rte_pktmbuf_pkt_len(mbuf_head) += cp_len;
+
+				rte_memcpy(rte_pktmbuf_mtod(mbuf, void *),
+					   memif_get_buffer(proc_private, d0),
+					   cp_len);
+
+				cur_slot++;
+				n_slots--;
+
+				if (d0->flags & MEMIF_DESC_FLAG_NEXT) {
+					mbuf_tail = mbuf;
+					mbuf = rte_pktmbuf_alloc(mq->mempool);
+					if (unlikely(mbuf == NULL))
+						goto free_bulk;
+					ret = memif_pktmbuf_chain(mbuf_head,
+								  mbuf_tail,
+								  mbuf);
+					if (unlikely(ret < 0)) {
+						MIF_LOG(ERR, "number-of-segments-overflow");
+						rte_pktmbuf_free(mbuf);
+						goto free_bulk;
+					}
+					goto next_slot1;
+				}
+
+				mq->n_bytes += rte_pktmbuf_pkt_len(mbuf_head);
+				*bufs++ = mbuf_head;
+				n_rx_pkts++;
+			}
+
+			if (i < n)
+				rte_pktmbuf_free_bulk(&mbufs[i], n - i);
+		}
+		goto no_free_bufs;
+
+free_bulk:
+		/* drop the partially received packet and the unused mbufs */
+		rte_pktmbuf_free_bulk(&mbufs[i], n - i);
+		goto no_free_bufs;
+	}
+
+copy_segmented:
 	while (n_slots && n_rx_pkts < nb_pkts) {
 		mbuf_head = rte_pktmbuf_alloc(mq->mempool);
 		if (unlikely(mbuf_head == NULL))
@@ -413,6 +497,311 @@ eth_memif_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return n_rx_pkts;
 }
 
+/* Register a shared memory region as external memory and DMA map it
+ * for the ports, so that the mbufs attached to its buffers carry a
+ * valid IOVA and can be transmitted by physical devices.
+ */
+static void
+memif_region_register(struct memif_region *r)
+{
+	size_t page_sz = sysconf(_SC_PAGESIZE);
+	size_t len = RTE_ALIGN_CEIL(r->region_size, page_sz);
+	unsigned int n_pages = len / page_sz;
+	struct rte_eth_dev_info dev_info;
+	rte_iova_t *iovas;
+	uint16_t port_id;
+	unsigned int i;
+
+	if (r->registered || r->addr == NULL)
+		return;
+	r->iova = RTE_BAD_IOVA;
+
+	/* physical addresses of the peer's pages are not known */
+	if (rte_eal_iova_mode() != RTE_IOVA_VA) {
+		MIF_LOG(INFO, "IOVA as PA, zero-copy rx mbufs have no IOVA.");
+		return;
+	}
+
+	iovas = malloc(sizeof(*iovas) * n_pages);
+	if (iovas == NULL)
+		return;
+	for (i = 0; i < n_pages; i++)
+		iovas[i] = (rte_iova_t)(uintptr_t)r->addr + i * page_sz;
+
+	if (rte_extmem_register(r->addr, len, iovas, n_pages, page_sz) < 0) {
+		MIF_LOG(ERR, "Failed to register region: %s",
+			rte_strerror(rte_errno));
+		free(iovas);
+		return;
+	}
+	free(iovas);
+
+	/* ports not supporting DMA mapping (-ENOTSUP) need no mapping */
+	RTE_ETH_FOREACH_DEV(port_id) {
+		if (rte_eth_dev_info_get(port_id, &dev_info) != 0)
+			continue;
+		rte_dev_dma_map(dev_info.device, r->addr,
+				(uintptr_t)r->addr, len);
+	}
+
+	r->iova = (rte_iova_t)(uintptr_t)r->addr;
+	r->registered = 1;
+}
+
+static void
+memif_region_unregister(struct memif_region *r)
+{
+	size_t len = RTE_ALIGN_CEIL(r->region_size, sysconf(_SC_PAGESIZE));
+	struct rte_eth_dev_info dev_info;
+	uint16_t port_id;
+
+	RTE_ETH_FOREACH_DEV(port_id) {
+		if (rte_eth_dev_info_get(port_id, &dev_info) != 0)
+			continue;
+		rte_dev_dma_unmap(dev_info.device, r->addr,
+				  (uintptr_t)r->addr, len);
+	}
+	if (rte_extmem_unregister(r->addr, len) < 0)
+		MIF_LOG(ERR, "Failed to unregister region: %s",
+			rte_strerror(rte_errno));
+	r->registered = 0;
+}
+
+/* Drop a reference to a region, unmap and free it with the last one */
+static void
+memif_region_put(struct memif_region *r)
+{
+	if (__atomic_sub_fetch(&r->refcnt, 1, __ATOMIC_ACQ_REL) != 0)
+		return;
+
+	if (r->addr != NULL) {
+		if (r->registered)
+			memif_region_unregister(r);
+		munmap(r->addr, r->region_size);
+		if (r->fd > 0) {
+			close(r->fd);
+			r->fd = -1;
+		}
+	}
+	rte_free(r);
+}
+
+static void
+memif_extbuf_ctx_put(struct memif_extbuf_ctx *ctx)
+{
+	memif_region_index_t i;
+
+	if (__atomic_sub_fetch(&ctx->refcnt, 1, __ATOMIC_ACQ_REL) != 0)
+		return;
+
+	for (i = 0; i < ctx->regions_num; i++)
+		if (ctx->regions[i] != NULL)
+			memif_region_put(ctx->regions[i]);
+	rte_free(ctx);
+}
+
+/* Called when the last mbuf attached to a shared memory buffer is freed */
+static void
+memif_extbuf_free_cb(void *addr __rte_unused, void *opaque)
+{
+	struct memif_extbuf *eb = opaque;
+	struct memif_extbuf_ctx *ctx = eb->ctx;
+
+	__atomic_store_n(&eb->done, 1, __ATOMIC_RELEASE);
+	memif_extbuf_ctx_put(ctx);
+}
+
+/* Set up the zero-copy rx state of a queue for a new connection. The
+ * previous context, if any, is released by the queue but lives on until
+ * the mbufs still attached to it are freed.
+ */
+static int
+memif_init_extbuf(struct rte_eth_dev *dev, struct memif_queue *mq)
+{
+	struct pmd_process_private *proc_private = dev->process_private;
+	uint16_t ring_size = 1 << mq->log2_ring_size;
+	struct memif_extbuf_ctx *ctx;
+	struct memif_region *r;
+	uint16_t i;
+
+	if (mq->extbuf != NULL) {
+		memif_extbuf_ctx_put(mq->extbuf);
+		mq->extbuf = NULL;
+	}
+
+	ctx = rte_zmalloc("memif_extbuf", sizeof(*ctx) +
+			  sizeof(struct memif_extbuf) * ring_size, 0);
+	if (ctx == NULL)
+		return -ENOMEM;
+
+	ctx->refcnt = 1;
+	for (i = 0; i < proc_private->regions_num; i++) {
+		r = proc_private->regions[i];
+		if (r == NULL)
+			continue;
+		memif_region_register(r);
+		__atomic_add_fetch(&r->refcnt, 1, __ATOMIC_RELAXED);
+		ctx->regions[i] = r;
+	}
+	ctx->regions_num = proc_private->regions_num;
+
+	for (i = 0; i < ring_size; i++) {
+		ctx->slot[i].shinfo.free_cb = memif_extbuf_free_cb;
+		ctx->slot[i].shinfo.fcb_opaque = &ctx->slot[i];
+		ctx->slot[i].ctx = ctx;
+	}
+	mq->extbuf = ctx;
+	mq->ext_tail = 0;
+
+	return 0;
+}
+
+/* Receive without copying: the mbufs are attached to the shared memory
+ * buffers and the slots are handed back to the peer once they are freed.
+ */
+static uint16_t
+eth_memif_rx_extbuf(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct memif_queue *mq = queue;
+	struct pmd_internals *pmd = rte_eth_devices[mq->in_port].data->dev_private;
+	struct pmd_process_private *proc_private =
+		rte_eth_devices[mq->in_port].process_private;
+	memif_ring_t *ring = memif_get_ring_from_queue(proc_private, mq);
+	uint16_t cur_slot, last_slot, n_slots, ring_size, mask, s0;
+	uint16_t n_rx_pkts = 0;
+	memif_ring_type_t type = mq->type;
+	memif_desc_t *d0;
+	struct memif_extbuf_ctx *ctx = mq->extbuf;
+	struct memif_extbuf *eb;
+	struct memif_region *r;
+	struct rte_mbuf *mbuf, *mbuf_head, *mbuf_tail;
+	struct rte_mbuf *mbufs[ETH_MEMIF_RX_BURST];
+	uint16_t i, n;
+	uint64_t b;
+	ssize_t size __rte_unused;
+	uint16_t head;
+	int ret;
+	struct rte_eth_link link;
+
+	if (unlikely((pmd->flags & ETH_MEMIF_FLAG_CONNECTED) == 0))
+		return 0;
+	if (unlikely(ring == NULL)) {
+		/* Secondary process will attempt to request regions. */
+		ret = rte_eth_link_get(mq->in_port, &link);
+		if (ret < 0)
+			MIF_LOG(ERR, "Failed to get port %u link info: %s",
+				mq->in_port, rte_strerror(-ret));
+		return 0;
+	}
+
+	/* consume interrupt */
+	if ((ring->flags & MEMIF_RING_FLAG_MASK_INT) == 0)
+		size = read(mq->intr_handle.fd, &b, sizeof(b));
+
+	ring_size = 1 << mq->log2_ring_size;
+	mask = ring_size - 1;
+
+	if (type == MEMIF_RING_S2M) {
+		cur_slot = mq->last_head;
+		last_slot = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	} else {
+		cur_slot = mq->last_tail;
+		last_slot = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	}
+
+	/* reclaim the slots whose mbufs were freed, in ring order */
+	while (mq->ext_tail != cur_slot) {
+		eb = &ctx->slot[mq->ext_tail & mask];
+		if (__atomic_load_n(&eb->done, __ATOMIC_ACQUIRE) == 0)
+			break;
+		eb->done = 0;
+		mq->ext_tail++;
+	}
+
+	n_slots = last_slot - cur_slot;
+	while (n_slots && n_rx_pkts < nb_pkts) {
+		n = RTE_MIN(nb_pkts - n_rx_pkts, n_slots);
+		n = RTE_MIN(n, ETH_MEMIF_RX_BURST);
+		if (unlikely(rte_pktmbuf_alloc_bulk(mq->mempool, mbufs, n) < 0))
+			break;
+
+		for (i = 0; i < n && n_slots; i++) {
+			mbuf_head = mbufs[i];
+			mbuf = mbuf_head;
+next_slot:
+			s0 = cur_slot & mask;
+			d0 = &ring->desc[s0];
+			eb = &ctx->slot[s0];
+			r = ctx->regions[d0->region];
+
+			/* the attached mbuf keeps the context alive */
+			__atomic_add_fetch(&ctx->refcnt, 1, __ATOMIC_RELAXED);
+			rte_mbuf_ext_refcnt_set(&eb->shinfo, 1);
+			rte_pktmbuf_attach_extbuf(mbuf,
+					(uint8_t *)r->addr + d0->offset,
+					r->registered ? r->iova + d0->offset :
+					RTE_BAD_IOVA,
+					pmd->run.pkt_buffer_size, &eb->shinfo);
+			mbuf->port = mq->in_port;
+			rte_pktmbuf_data_len(mbuf) = d0->length;
+			rte_pktmbuf_pkt_len(mbuf) = d0->length;
+			if (mbuf != mbuf_head)
+				rte_pktmbuf_pkt_len(mbuf_head) += d0->length;
+
+			cur_slot++;
+			n_slots--;
+
+			if (d0->flags & MEMIF_DESC_FLAG_NEXT) {
+				mbuf_tail = mbuf;
+				mbuf = rte_pktmbuf_alloc(mq->mempool);
+				if (unlikely(mbuf == NULL))
+					goto free_bulk;
+				ret = memif_pktmbuf_chain(mbuf_head, mbuf_tail,
+							  mbuf);
+				if (unlikely(ret < 0)) {
+					MIF_LOG(ERR, "number-of-segments-overflow");
+					rte_pktmbuf_free(mbuf);
+					goto free_bulk;
+				}
+				goto next_slot;
+			}
+
+			mq->n_bytes += rte_pktmbuf_pkt_len(mbuf_head);
+			*bufs++ = mbuf_head;
+			n_rx_pkts++;
+		}
+
+		if (i < n)
+			rte_pktmbuf_free_bulk(&mbufs[i], n - i);
+	}
+	goto no_free_bufs;
+
+free_bulk:
+	/* the slots of the dropped packet are returned once reclaimed */
+	rte_pktmbuf_free_bulk(&mbufs[i], n - i);
+
+no_free_bufs:
+	if (type == MEMIF_RING_S2M) {
+		__atomic_store_n(&ring->tail, mq->ext_tail, __ATOMIC_RELEASE);
+		mq->last_head = cur_slot;
+	} else {
+		mq->last_tail = cur_slot;
+
+		head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		n_slots = ring_size - head + mq->ext_tail;
+
+		while (n_slots--) {
+			s0 = head++ & mask;
+			d0 = &ring->desc[s0];
+			d0->length = pmd->run.pkt_buffer_size;
+		}
+		__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+	}
+
+	mq->n_pkts += n_rx_pkts;
+	return n_rx_pkts;
+}
+
 static uint16_t
 eth_memif_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
@@ -541,6 +930,7 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	memif_desc_t *d0;
 	struct rte_mbuf *mbuf;
 	struct rte_mbuf *mbuf_head;
+	struct rte_mbuf **tx_bufs = bufs;
 	uint64_t a;
 	ssize_t size;
 	struct rte_eth_link link;
@@ -576,12 +966,30 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		mbuf_head = *bufs++;
 		mbuf = mbuf_head;
 
+		if (n_tx_pkts + 1 < nb_pkts)
+			rte_prefetch0(rte_pktmbuf_mtod(*bufs, void *));
+
 		saved_slot = slot;
 		d0 = &ring->desc[slot & mask];
+		d0->flags = 0;
 		dst_off = 0;
 		dst_len = (type == MEMIF_RING_S2M) ?
 			pmd->run.pkt_buffer_size : d0->length;
 
+		if (likely(rte_pktmbuf_is_contiguous(mbuf) &&
+			   rte_pktmbuf_data_len(mbuf) <= dst_len)) {
+			/* single buffer packet, copy it at once */
+			cp_len = rte_pktmbuf_data_len(mbuf);
+			rte_memcpy(memif_get_buffer(proc_private, d0),
+				   rte_pktmbuf_mtod(mbuf, void *), cp_len);
+			d0->length = cp_len;
+			mq->n_bytes += cp_len;
+			n_tx_pkts++;
+			slot++;
+			n_free--;
+			continue;
+		}
+
 next_in_chain:
 		src_off = 0;
 		src_len = rte_pktmbuf_data_len(mbuf);
@@ -625,7 +1033,6 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		n_tx_pkts++;
 		slot++;
 		n_free--;
-		rte_pktmbuf_free(mbuf_head);
 	}
 
 no_free_slots:
@@ -634,6 +1041,9 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	else
 		__atomic_store_n(&ring->tail, slot, __ATOMIC_RELEASE);
 
+	/* all copied, return the mbufs to their pools at once */
+	rte_pktmbuf_free_bulk(tx_bufs, n_tx_pkts);
+
 	if ((ring->flags & MEMIF_RING_FLAG_MASK_INT) == 0) {
 		a = 1;
 		size = write(mq->intr_handle.fd, &a, sizeof(a));
@@ -814,14 +1224,8 @@ memif_free_regions(struct rte_eth_dev *dev)
 				if (r->fd > 0)
 					close(r->fd);
 			}
-			if (r->addr != NULL) {
-				munmap(r->addr, r->region_size);
-				if (r->fd > 0) {
-					close(r->fd);
-					r->fd = -1;
-				}
-			}
-			rte_free(r);
+			/* zero-copy rx mbufs may still use the region */
+			memif_region_put(r);
 			proc_private->regions[i] = NULL;
 		}
 	}
@@ -858,6 +1262,7 @@ memif_region_init_zc(const struct rte_memseg_list *msl, const struct rte_memseg
 		if (r->fd < 0)
 			return -1;
 		r->pkt_buffer_offset = 0;
+		r->refcnt = 1;
 
 		proc_private->regions[proc_private->regions_num - 1] = r;
 	} else {
@@ -931,6 +1336,7 @@ memif_region_init_shm(struct rte_eth_dev *dev, uint8_t has_buffers)
 		goto error;
 	}
 
+	r->refcnt = 1;
 	proc_private->regions[proc_private->regions_num] = r;
 	proc_private->regions_num++;
 
@@ -1148,6 +1554,12 @@ memif_connect(struct rte_eth_dev *dev)
 			/* enable polling mode */
 			if (pmd->role == MEMIF_ROLE_MASTER)
 				ring->flags = MEMIF_RING_FLAG_MASK_INT;
+			if (pmd->role == MEMIF_ROLE_MASTER &&
+			    (pmd->flags & ETH_MEMIF_FLAG_RX_ZERO_COPY) &&
+			    memif_init_extbuf(dev, mq) < 0) {
+				MIF_LOG(ERR, "Failed to allocate rx buffer state");
+				return -1;
+			}
 		}
 		for (i = 0; i < pmd->run.num_m2s_rings; i++) {
 			mq = (pmd->role == MEMIF_ROLE_SLAVE) ?
@@ -1164,6 +1576,12 @@ memif_connect(struct rte_eth_dev *dev)
 			/* enable polling mode */
 			if (pmd->role == MEMIF_ROLE_SLAVE)
 				ring->flags = MEMIF_RING_FLAG_MASK_INT;
+			if (pmd->role == MEMIF_ROLE_SLAVE &&
+			    (pmd->flags & ETH_MEMIF_FLAG_RX_ZERO_COPY) &&
+			    memif_init_extbuf(dev, mq) < 0) {
+				MIF_LOG(ERR, "Failed to allocate rx buffer state");
+				return -1;
+			}
 		}
 
 		pmd->flags &= ~ETH_MEMIF_FLAG_CONNECTING;
@@ -1306,6 +1724,8 @@ memif_queue_release(void *queue)
 	if (!mq)
 		return;
 
+	if (mq->extbuf != NULL)
+		memif_extbuf_ctx_put(mq->extbuf);
 	rte_free(mq);
 }
 
@@ -1469,6 +1889,9 @@ memif_create(struct rte_vdev_device *vdev, enum memif_role_t role,
 	/* Zero-copy flag irelevant to master. */
 	if (pmd->role == MEMIF_ROLE_MASTER)
 		pmd->flags &= ~ETH_MEMIF_FLAG_ZERO_COPY;
+	/* Slave in zero-copy mode already receives into its own mbufs. */
+	if (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY)
+		pmd->flags &= ~ETH_MEMIF_FLAG_RX_ZERO_COPY;
 
 	ret = memif_socket_init(eth_dev, socket_filename);
 	if (ret < 0)
@@ -1495,6 +1918,9 @@ memif_create(struct rte_vdev_device *vdev, enum memif_role_t role,
 	if (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY) {
 		eth_dev->rx_pkt_burst = eth_memif_rx_zc;
 		eth_dev->tx_pkt_burst = eth_memif_tx_zc;
+	} else if (pmd->flags & ETH_MEMIF_FLAG_RX_ZERO_COPY) {
+		eth_dev->rx_pkt_burst = eth_memif_rx_extbuf;
+		eth_dev->tx_pkt_burst = eth_memif_tx;
 	} else {
 		eth_dev->rx_pkt_burst = eth_memif_rx;
 		eth_dev->tx_pkt_burst = eth_memif_tx;
@@ -1545,6 +1971,23 @@ memif_set_zc(const char *key __rte_unused, const char *value, void *extra_args)
 	return 0;
 }
 
+static int
+memif_set_rx_zc(const char *key __rte_unused, const char *value,
+		void *extra_args)
+{
+	uint32_t *flags = (uint32_t *)extra_args;
+
+	if (strstr(value, "yes") != NULL) {
+		*flags |= ETH_MEMIF_FLAG_RX_ZERO_COPY;
+	} else if (strstr(value, "no") != NULL) {
+		*flags &= ~ETH_MEMIF_FLAG_RX_ZERO_COPY;
+	} else {
+		MIF_LOG(ERR, "Failed to parse rx-zero-copy param: %s.", value);
+		return -EINVAL;
+	}
+	return 0;
+}
+
 static int
 memif_set_id(const char *key __rte_unused, const char *value, void *extra_args)
 {
@@ -1670,6 +2113,7 @@ rte_pmd_memif_probe(struct rte_vdev_device *vdev)
 	struct rte_ether_addr *ether_addr = rte_zmalloc("",
 		sizeof(struct rte_ether_addr), 0);
 	struct rte_eth_dev *eth_dev;
+	struct pmd_internals *pmd;
 
 	rte_eth_random_addr(ether_addr->addr_bytes);
 
@@ -1682,6 +2126,18 @@ rte_pmd_memif_probe(struct rte_vdev_device *vdev)
 			return -1;
 		}
 
+		/* Zero-copy rx mbufs point to the mappings of the primary
+		 * process, and the copy path would hand back the slots they
+		 * still use to the peer.
+		 */
+		pmd = eth_dev->data->dev_private;
+		if (pmd->flags & ETH_MEMIF_FLAG_RX_ZERO_COPY) {
+			MIF_LOG(ERR, "%s: zero-copy receive is not supported "
+				"by secondary processes", name);
+			rte_eth_dev_release_port(eth_dev);
+			return -ENOTSUP;
+		}
+
 		eth_dev->dev_ops = &ops;
 		eth_dev->device = &vdev->device;
 		eth_dev->rx_pkt_burst = eth_memif_rx;
@@ -1749,6 +2205,10 @@ rte_pmd_memif_probe(struct rte_vdev_device *vdev)
 					 &memif_set_zc, &flags);
 		if (ret < 0)
 			goto exit;
+		ret = rte_kvargs_process(kvlist, ETH_MEMIF_RX_ZC_ARG,
+					 &memif_set_rx_zc, &flags);
+		if (ret < 0)
+			goto exit;
 		ret = rte_kvargs_process(kvlist, ETH_MEMIF_SECRET_ARG,
 					 &memif_set_secret, (void *)(&secret));
 		if (ret < 0)
@@ -1794,6 +2254,7 @@ RTE_PMD_REGISTER_PARAM_STRING(net_memif,
 			      ETH_MEMIF_SOCKET_ARG "=<string>"
 			      ETH_MEMIF_MAC_ARG "=xx:xx:xx:xx:xx:xx"
 			      ETH_MEMIF_ZC_ARG "=yes|no"
+			      ETH_MEMIF_RX_ZC_ARG "=yes|no"
 			      ETH_MEMIF_SECRET_ARG "=<string>");
 
 int memif_logtype;
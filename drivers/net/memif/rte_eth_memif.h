@@ -28,6 +28,7 @@
 #define ETH_MEMIF_SHM_NAME_SIZE			32
 #define ETH_MEMIF_DISC_STRING_SIZE		96
 #define ETH_MEMIF_SECRET_SIZE			24
+#define ETH_MEMIF_RX_BURST			32
 
 extern int memif_logtype;
 
@@ -46,6 +47,32 @@ struct memif_region {
 	int fd;					/**< shared memory file descriptor */
 	uint32_t pkt_buffer_offset;
 	/**< offset from 'addr' to first packet buffer */
+	uint32_t refcnt;
+	/**< references held by the device and by zero-copy rx contexts */
+	uint8_t registered;			/**< registered as external memory */
+	rte_iova_t iova;			/**< IOVA of 'addr' if registered */
+};
+
+struct memif_extbuf_ctx;
+
+/* State of a ring slot whose buffer is attached to an rx mbuf. */
+struct memif_extbuf {
+	struct rte_mbuf_ext_shared_info shinfo;	/**< attached mbuf info */
+	struct memif_extbuf_ctx *ctx;		/**< owning context */
+	uint16_t done;				/**< mbuf has been freed */
+};
+
+/* Zero-copy rx state of a queue for one connection. It keeps the shared
+ * memory regions mapped until the queue has dropped it and every mbuf
+ * attached to its slots has been freed.
+ */
+struct memif_extbuf_ctx {
+	uint32_t refcnt;
+	/**< attached slots, plus one while the queue uses the context */
+	memif_region_index_t regions_num;	/**< number of regions */
+	struct memif_region *regions[ETH_MEMIF_MAX_REGION_NUM];
+	/**< regions referenced by the context */
+	struct memif_extbuf slot[];		/**< per slot state */
 };
 
 struct memif_queue {
@@ -68,6 +95,12 @@ struct memif_queue {
 	 * mbufs to free them once master has received them.
 	 */
 
+	struct memif_extbuf_ctx *extbuf;
+	/**< Per slot state, used in zero-copy rx. Slots are returned to
+	 * the peer once the mbufs attached to them have been freed.
+	 */
+	uint16_t ext_tail;			/**< oldest slot not returned */
+
 	/* rx/tx info */
 	uint64_t n_pkts;			/**< number of rx/tx packets */
 	uint64_t n_bytes;			/**< number of rx/tx bytes */
@@ -89,6 +122,8 @@ struct pmd_internals {
 /**< device is zero-copy enabled */
 #define ETH_MEMIF_FLAG_DISABLED		(1 << 3)
 /**< device has not been configured and can not accept connection requests */
+#define ETH_MEMIF_FLAG_RX_ZERO_COPY	(1 << 4)
+/**< device receives into mbufs attached to the peer's packet buffers */
 
 	char *socket_filename;			/**< pointer to socket filename */
 	char secret[ETH_MEMIF_SECRET_SIZE]; /**< secret (optional security parameter) */
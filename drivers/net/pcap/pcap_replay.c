@@ -0,0 +1,509 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+
+#include "pcap_replay.h"
+
+/* libpcap file format */
+#define PCAP_MAGIC_USEC		0xa1b2c3d4
+#define PCAP_MAGIC_NSEC		0xa1b23c4d
+#define PCAP_FILE_HDR_LEN	24
+#define PCAP_REC_HDR_LEN	16
+
+/* pcapng file format */
+#define PCAPNG_BLOCK_SHB	0x0a0d0d0a
+#define PCAPNG_BLOCK_IDB	1
+#define PCAPNG_BLOCK_SPB	3
+#define PCAPNG_BLOCK_EPB	6
+#define PCAPNG_BYTE_ORDER_MAGIC	0x1a2b3c4d
+#define PCAPNG_OPT_END		0
+#define PCAPNG_OPT_IF_TSRESOL	9
+#define PCAPNG_MAX_IF		32
+
+#define LINKTYPE_ETHERNET	1
+
+struct replay_if {
+	uint16_t linktype;
+	uint32_t snaplen;
+	uint8_t tsresol;
+};
+
+struct replay_parser {
+	struct pcap_replay *replay;
+	enum pcap_replay_hash hash;
+	int swap;			/* file byte order differs from cpu */
+	uint64_t last_ts;
+	struct replay_if ifs[PCAPNG_MAX_IF];
+	uint32_t nb_ifs;
+};
+
+static inline uint16_t
+replay_get16(const struct replay_parser *p, const uint8_t *ptr)
+{
+	uint16_t v;
+
+	memcpy(&v, ptr, sizeof(v));
+	return p->swap ? rte_bswap16(v) : v;
+}
+
+static inline uint32_t
+replay_get32(const struct replay_parser *p, const uint8_t *ptr)
+{
+	uint32_t v;
+
+	memcpy(&v, ptr, sizeof(v));
+	return p->swap ? rte_bswap32(v) : v;
+}
+
+/* Combine two values independently of their order */
+static inline uint32_t
+replay_hash_pair(uint32_t h, uint32_t a, uint32_t b)
+{
+	return (h ^ RTE_MIN(a, b)) * 0x9e3779b1 + RTE_MAX(a, b);
+}
+
+/* Hash which is the same in both directions of a flow */
+static uint32_t
+replay_flow_hash(const uint8_t *pkt, uint32_t len, int use_ports)
+{
+	const struct rte_ether_hdr *eth = (const struct rte_ether_hdr *)pkt;
+	const struct rte_vlan_hdr *vlan;
+	const struct rte_ipv4_hdr *ip4;
+	const struct rte_ipv6_hdr *ip6;
+	const uint16_t *ports;
+	uint32_t off = sizeof(*eth);
+	uint32_t l4_off, h, i;
+	uint16_t type;
+	uint8_t proto;
+
+	if (len < off)
+		return 0;
+
+	type = eth->ether_type;
+	while ((type == RTE_BE16(RTE_ETHER_TYPE_VLAN) ||
+			type == RTE_BE16(RTE_ETHER_TYPE_QINQ)) &&
+			len >= off + sizeof(*vlan)) {
+		vlan = (const struct rte_vlan_hdr *)(pkt + off);
+		type = vlan->eth_proto;
+		off += sizeof(*vlan);
+	}
+
+	if (type == RTE_BE16(RTE_ETHER_TYPE_IPV4) &&
+			len >= off + sizeof(*ip4)) {
+		ip4 = (const struct rte_ipv4_hdr *)(pkt + off);
+		h = replay_hash_pair(0, ip4->src_addr, ip4->dst_addr);
+		proto = ip4->next_proto_id;
+		l4_off = off + (ip4->version_ihl & RTE_IPV4_HDR_IHL_MASK) *
+			RTE_IPV4_IHL_MULTIPLIER;
+		/* only the first fragment has the ports */
+		if (ip4->fragment_offset &
+				RTE_BE16(RTE_IPV4_HDR_OFFSET_MASK |
+					 RTE_IPV4_HDR_MF_FLAG))
+			use_ports = 0;
+	} else if (type == RTE_BE16(RTE_ETHER_TYPE_IPV6) &&
+			len >= off + sizeof(*ip6)) {
+		uint32_t src, dst;
+
+		ip6 = (const struct rte_ipv6_hdr *)(pkt + off);
+		h = 0;
+		for (i = 0; i < sizeof(ip6->src_addr); i += sizeof(h)) {
+			memcpy(&src, &ip6->src_addr[i], sizeof(src));
+			memcpy(&dst, &ip6->dst_addr[i], sizeof(dst));
+			h = replay_hash_pair(h, src, dst);
+		}
+		proto = ip6->proto;
+		l4_off = off + sizeof(*ip6);
+	} else {
+		return 0;
+	}
+
+	if (use_ports && (proto == IPPROTO_TCP || proto == IPPROTO_UDP ||
+			proto == IPPROTO_SCTP) && len >= l4_off + 4) {
+		ports = (const uint16_t *)(pkt + l4_off);
+		h = replay_hash_pair(h, ports[0], ports[1]);
+	}
+	h ^= proto;
+
+	/* murmur3 finalizer */
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+
+	return h;
+}
+
+static int
+replay_index_add(struct pcap_replay_index *index, uint64_t offset,
+		uint32_t len, uint64_t ts)
+{
+	struct pcap_replay_pkt *pkts;
+	uint64_t size;
+
+	if (index->nb_pkts == index->size) {
+		size = index->size ? index->size * 2 : 1024;
+		pkts = realloc(index->pkts, size * sizeof(*pkts));
+		if (pkts == NULL)
+			return -ENOMEM;
+		index->pkts = pkts;
+		index->size = size;
+	}
+
+	pkts = &index->pkts[index->nb_pkts++];
+	pkts->offset = offset;
+	pkts->ts = ts;
+	pkts->len = len;
+
+	return 0;
+}
+
+static int
+replay_add(struct replay_parser *p, uint16_t linktype, uint64_t offset,
+		uint32_t caplen, uint64_t ts)
+{
+	struct pcap_replay *r = p->replay;
+	uint16_t q = 0;
+
+	/* attached as mbuf external buffer, whose length is 16 bits */
+	if (caplen == 0 || caplen > UINT16_MAX) {
+		r->nb_skipped++;
+		return 0;
+	}
+
+	if (r->nb_pkts == 0)
+		r->first_ts = ts;
+	ts = (ts > r->first_ts) ? ts - r->first_ts : 0;
+	r->duration = RTE_MAX(r->duration, ts);
+	p->last_ts = ts + r->first_ts;
+
+	if (r->nb_queues > 1) {
+		if (p->hash == PCAP_REPLAY_HASH_RR)
+			q = r->nb_pkts % r->nb_queues;
+		else if (linktype == LINKTYPE_ETHERNET)
+			q = replay_flow_hash(r->addr + offset, caplen,
+				p->hash == PCAP_REPLAY_HASH_FLOW) %
+				r->nb_queues;
+	}
+	r->nb_pkts++;
+
+	return replay_index_add(&r->queue[q], offset, caplen, ts);
+}
+
+static int
+replay_parse_pcap(struct replay_parser *p)
+{
+	const uint8_t *addr = p->replay->addr;
+	size_t size = p->replay->size;
+	uint64_t off = PCAP_FILE_HDR_LEN;
+	uint32_t magic, sec, frac, caplen;
+	uint16_t linktype;
+	int nsec;
+	int ret;
+
+	memcpy(&magic, addr, sizeof(magic));
+	if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC) {
+		p->swap = 0;
+	} else if (magic == rte_bswap32(PCAP_MAGIC_USEC) ||
+			magic == rte_bswap32(PCAP_MAGIC_NSEC)) {
+		p->swap = 1;
+		magic = rte_bswap32(magic);
+	} else {
+		return -EINVAL;
+	}
+	nsec = (magic == PCAP_MAGIC_NSEC);
+	/* upper bits of the link type carry FCS information */
+	linktype = replay_get32(p, addr + 20) & 0xffff;
+
+	while (off + PCAP_REC_HDR_LEN <= size) {
+		sec = replay_get32(p, addr + off);
+		frac = replay_get32(p, addr + off + 4);
+		caplen = replay_get32(p, addr + off + 8);
+		off += PCAP_REC_HDR_LEN;
+
+		/* truncated file */
+		if (caplen > size - off)
+			break;
+
+		ret = replay_add(p, linktype, off, caplen,
+				(uint64_t)sec * NS_PER_S +
+				(nsec ? frac : frac * 1000ULL));
+		if (ret < 0)
+			return ret;
+
+		off += caplen;
+	}
+
+	return 0;
+}
+
+/* Convert a pcapng timestamp in if_tsresol units to nanoseconds */
+static uint64_t
+replay_ts_to_ns(uint64_t ts, uint8_t tsresol)
+{
+	uint8_t exp = tsresol & 0x7f;
+	uint64_t mul = 1;
+
+	if (tsresol & 0x80) {
+		/* negative power of 2, keep the product below 2^64 */
+		if (exp > 33) {
+			ts >>= exp - 33;
+			exp = 33;
+		}
+		return (ts >> exp) * NS_PER_S +
+			(((ts & ((1ULL << exp) - 1)) * NS_PER_S) >> exp);
+	}
+
+	/* negative power of 10 */
+	exp = RTE_MIN(exp, 19);
+	if (exp <= 9) {
+		while (exp++ < 9)
+			mul *= 10;
+		return ts * mul;
+	}
+	while (exp-- > 9)
+		mul *= 10;
+	return ts / mul;
+}
+
+static void
+replay_parse_idb(struct replay_parser *p, const uint8_t *body,
+		const uint8_t *end)
+{
+	struct replay_if *ifs;
+	uint16_t code, len;
+
+	if (p->nb_ifs == PCAPNG_MAX_IF || body + 8 > end)
+		return;
+
+	ifs = &p->ifs[p->nb_ifs++];
+	ifs->linktype = replay_get16(p, body);
+	ifs->snaplen = replay_get32(p, body + 4);
+	ifs->tsresol = 6;
+
+	for (body += 8; body + 4 <= end; body += 4 + RTE_ALIGN(len, 4)) {
+		code = replay_get16(p, body);
+		len = replay_get16(p, body + 2);
+		if (code == PCAPNG_OPT_END)
+			break;
+		if (code == PCAPNG_OPT_IF_TSRESOL && len >= 1 &&
+				body + 5 <= end)
+			ifs->tsresol = body[4];
+	}
+}
+
+static int
+replay_parse_pcapng(struct replay_parser *p)
+{
+	const uint8_t *addr = p->replay->addr;
+	size_t size = p->replay->size;
+	uint64_t off = 0;
+	const uint8_t *body;
+	const struct replay_if *ifs;
+	uint32_t type, len, magic, id, caplen;
+	uint64_t ts;
+	int ret;
+
+	while (off + 12 <= size) {
+		memcpy(&type, addr + off, sizeof(type));
+		if (type == PCAPNG_BLOCK_SHB) {
+			/* new section, may change the byte order */
+			memcpy(&magic, addr + off + 8, sizeof(magic));
+			if (magic == PCAPNG_BYTE_ORDER_MAGIC)
+				p->swap = 0;
+			else if (magic == rte_bswap32(PCAPNG_BYTE_ORDER_MAGIC))
+				p->swap = 1;
+			else
+				return -EINVAL;
+			p->nb_ifs = 0;
+		} else {
+			type = replay_get32(p, addr + off);
+		}
+
+		len = replay_get32(p, addr + off + 4);
+		if (len < 12 || (len & 3) != 0 || len > size - off)
+			break;
+		body = addr + off + 8;
+
+		switch (type) {
+		case PCAPNG_BLOCK_IDB:
+			replay_parse_idb(p, body, addr + off + len - 4);
+			break;
+		case PCAPNG_BLOCK_EPB:
+			if (len < 32)
+				break;
+			id = replay_get32(p, body);
+			if (id >= p->nb_ifs)
+				break;
+			ifs = &p->ifs[id];
+			ts = (uint64_t)replay_get32(p, body + 4) << 32 |
+				replay_get32(p, body + 8);
+			caplen = replay_get32(p, body + 12);
+			if (caplen > len - 32)
+				break;
+			ret = replay_add(p, ifs->linktype,
+					body + 20 - addr, caplen,
+					replay_ts_to_ns(ts, ifs->tsresol));
+			if (ret < 0)
+				return ret;
+			break;
+		case PCAPNG_BLOCK_SPB:
+			/* no timestamp, sent right after the previous one */
+			if (len < 16 || p->nb_ifs == 0)
+				break;
+			ifs = &p->ifs[0];
+			caplen = RTE_MIN(replay_get32(p, body), len - 16);
+			if (ifs->snaplen != 0)
+				caplen = RTE_MIN(caplen, ifs->snaplen);
+			ret = replay_add(p, ifs->linktype, body + 4 - addr,
+					caplen, p->last_ts);
+			if (ret < 0)
+				return ret;
+			break;
+		default:
+			break;
+		}
+
+		off += len;
+	}
+
+	return 0;
+}
+
+/* Drop a reference, unmap the file and free the index with the last one */
+static void
+replay_put(struct pcap_replay *replay)
+{
+	uint16_t i;
+
+	if (__atomic_sub_fetch(&replay->refcnt, 1, __ATOMIC_ACQ_REL) != 0)
+		return;
+
+	for (i = 0; i < replay->nb_queues; i++)
+		free(replay->queue[i].pkts);
+
+	munmap(replay->addr, replay->size);
+	free(replay);
+}
+
+/* Called when the last mbuf attached through an external buffer info
+ * is freed.
+ */
+static void
+replay_free_cb(void *addr __rte_unused, void *opaque)
+{
+	replay_put(opaque);
+}
+
+void
+pcap_replay_close(struct pcap_replay *replay)
+{
+	struct rte_mbuf_ext_shared_info *shinfo;
+	uint16_t i, j;
+
+	if (replay == NULL)
+		return;
+
+	/* Each external buffer info holds one reference of its own, until
+	 * the mbufs attached through it are freed.
+	 */
+	for (i = 0; i < replay->nb_queues; i++) {
+		for (j = 0; j < PCAP_REPLAY_SHINFO_NUM; j++) {
+			shinfo = &replay->queue[i].shinfo[j];
+			if (rte_mbuf_ext_refcnt_update(shinfo, -1) == 0)
+				replay_put(replay);
+		}
+	}
+	replay_put(replay);
+}
+
+int
+pcap_replay_open(const char *filename, uint16_t nb_queues,
+		enum pcap_replay_hash hash, struct pcap_replay **replay)
+{
+	struct replay_parser p = { .hash = hash };
+	struct rte_mbuf_ext_shared_info *shinfo;
+	struct pcap_replay *r;
+	struct stat st;
+	uint32_t magic;
+	uint16_t i, j;
+	void *addr;
+	int fd, ret;
+
+	if (nb_queues == 0)
+		return -EINVAL;
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+
+	if (fstat(fd, &st) < 0) {
+		ret = -errno;
+		close(fd);
+		return ret;
+	}
+	if ((size_t)st.st_size < PCAP_FILE_HDR_LEN) {
+		close(fd);
+		return -EINVAL;
+	}
+
+	/* private mapping: packets can be modified, the file is not */
+	addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+		    fd, 0);
+	ret = -errno;
+	close(fd);
+	if (addr == MAP_FAILED)
+		return ret;
+	madvise(addr, st.st_size, MADV_SEQUENTIAL);
+
+	r = calloc(1, sizeof(*r) + nb_queues * sizeof(r->queue[0]));
+	if (r == NULL) {
+		munmap(addr, st.st_size);
+		return -ENOMEM;
+	}
+	r->addr = addr;
+	r->size = st.st_size;
+	r->nb_queues = nb_queues;
+	r->refcnt = 1;
+	for (i = 0; i < nb_queues; i++) {
+		r->queue[i].base = r->addr;
+		for (j = 0; j < PCAP_REPLAY_SHINFO_NUM; j++) {
+			shinfo = &r->queue[i].shinfo[j];
+			shinfo->free_cb = replay_free_cb;
+			shinfo->fcb_opaque = r;
+			rte_mbuf_ext_refcnt_set(shinfo, 1);
+			r->refcnt++;
+		}
+	}
+	p.replay = r;
+
+	memcpy(&magic, addr, sizeof(magic));
+	if (magic == PCAPNG_BLOCK_SHB)
+		ret = replay_parse_pcapng(&p);
+	else
+		ret = replay_parse_pcap(&p);
+	if (ret < 0) {
+		pcap_replay_close(r);
+		return ret;
+	}
+
+	madvise(addr, st.st_size, MADV_NORMAL);
+	*replay = r;
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _PCAP_REPLAY_H_
+#define _PCAP_REPLAY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <rte_mbuf.h>
+
+/*
+ * Replayed packets share a few external buffer infos per queue, as one
+ * 16-bit reference count could not cover all the mbufs in flight.
+ */
+#define PCAP_REPLAY_SHINFO_NUM 16
+
+/** How packets of the replayed file are spread across rx queues */
+enum pcap_replay_hash {
+	PCAP_REPLAY_HASH_FLOW,	/**< symmetric IP addresses and L4 ports */
+	PCAP_REPLAY_HASH_IP,	/**< symmetric IP addresses */
+	PCAP_REPLAY_HASH_RR,	/**< round robin, ignoring packet contents */
+};
+
+/** One packet of the replayed file */
+struct pcap_replay_pkt {
+	uint64_t offset;	/**< packet data offset in the file */
+	uint64_t ts;		/**< time since the first packet, in ns */
+	uint32_t len;		/**< captured length */
+};
+
+/** Packets of the file assigned to one rx queue, in file order */
+struct pcap_replay_index {
+	const uint8_t *base;		/**< start of the mapped file */
+	struct pcap_replay_pkt *pkts;
+	uint64_t nb_pkts;
+	uint64_t size;			/**< number of allocated entries */
+	/** Shared by the mbufs attached to the packets of this queue */
+	struct rte_mbuf_ext_shared_info shinfo[PCAP_REPLAY_SHINFO_NUM];
+};
+
+struct pcap_replay {
+	uint8_t *addr;			/**< private mapping of the file */
+	size_t size;			/**< file size */
+	uint64_t first_ts;		/**< first packet time, in ns */
+	uint64_t duration;		/**< time until the last packet, in ns */
+	uint64_t nb_pkts;		/**< packets indexed */
+	uint64_t nb_skipped;		/**< packets too large for an mbuf */
+	uint32_t refcnt;		/**< port and external buffer infos */
+	uint16_t nb_queues;
+	struct pcap_replay_index queue[];
+};
+
+/**
+ * Map a pcap or pcapng file and index its packets per rx queue.
+ *
+ * The mapping is private and writable, so packets may be modified in
+ * place without changing the file.
+ *
+ * @return
+ *   0 on success, negative errno value otherwise.
+ */
+int pcap_replay_open(const char *filename, uint16_t nb_queues,
+		enum pcap_replay_hash hash, struct pcap_replay **replay);
+
+/**
+ * Release the reference of the port. The file is unmapped and the index
+ * freed once the last mbuf attached to the mapping is freed.
+ */
+void pcap_replay_close(struct pcap_replay *replay);
+
+#endif /* _PCAP_REPLAY_H_ */
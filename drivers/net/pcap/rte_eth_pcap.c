@@ -27,6 +27,8 @@
 #include <rte_bus_vdev.h>
 #include <rte_string_fns.h>
 
+#include "pcap_replay.h"
+
 #define RTE_ETH_PCAP_SNAPSHOT_LEN 65535
 #define RTE_ETH_PCAP_SNAPLEN RTE_ETHER_MAX_JUMBO_FRAME_LEN
 #define RTE_ETH_PCAP_PROMISC 1
@@ -40,6 +42,10 @@
 #define ETH_PCAP_IFACE_ARG    "iface"
 #define ETH_PCAP_PHY_MAC_ARG  "phy_mac"
 #define ETH_PCAP_INFINITE_RX_ARG  "infinite_rx"
+#define ETH_PCAP_REPLAY_ARG   "replay"
+#define ETH_PCAP_REPLAY_QUEUES_ARG "replay_queues"
+#define ETH_PCAP_REPLAY_HASH_ARG "replay_hash"
+#define ETH_PCAP_REPLAY_SPEED_ARG "replay_speed"
 
 #define ETH_PCAP_ARG_MAXLEN	64
 
@@ -67,6 +73,12 @@ struct pcap_rx_queue {
 
 	/* Contains pre-generated packets to be looped through */
 	struct rte_ring *pkts;
+
+	/* Packets of the memory-mapped file to replay on this queue */
+	struct pcap_replay_index *replay;
+	uint64_t replay_next;
+	/* Time added by the previous loops over the file, in ns */
+	uint64_t replay_loop_ts;
 };
 
 struct pcap_tx_queue {
@@ -86,12 +98,18 @@ struct pmd_internals {
 	int single_iface;
 	int phy_mac;
 	unsigned int infinite_rx;
+	/* TSC cycles per ns of capture time, 0 to replay at full speed */
+	double replay_cycles_per_ns;
+	uint64_t replay_start_tsc;
+	uint64_t replay_first_ts;
+	uint64_t replay_duration;
 };
 
 struct pmd_process_private {
 	pcap_t *rx_pcap[RTE_PMD_PCAP_MAX_QUEUES];
 	pcap_t *tx_pcap[RTE_PMD_PCAP_MAX_QUEUES];
 	pcap_dumper_t *tx_dumper[RTE_PMD_PCAP_MAX_QUEUES];
+	struct pcap_replay *replay;
 };
 
 struct pmd_devargs {
@@ -114,6 +132,12 @@ struct pmd_devargs_all {
 	unsigned int is_rx_pcap;
 	unsigned int is_rx_iface;
 	unsigned int infinite_rx;
+	unsigned int is_rx_replay;
+	const char *replay_file;
+	unsigned int replay_queues;
+	enum pcap_replay_hash replay_hash;
+	double replay_speed;
+	struct pcap_replay *replay;
 };
 
 static const char *valid_arguments[] = {
@@ -125,6 +149,10 @@ static const char *valid_arguments[] = {
 	ETH_PCAP_IFACE_ARG,
 	ETH_PCAP_PHY_MAC_ARG,
 	ETH_PCAP_INFINITE_RX_ARG,
+	ETH_PCAP_REPLAY_ARG,
+	ETH_PCAP_REPLAY_QUEUES_ARG,
+	ETH_PCAP_REPLAY_HASH_ARG,
+	ETH_PCAP_REPLAY_SPEED_ARG,
 	NULL
 };
 
@@ -216,6 +244,83 @@ eth_pcap_rx_infinite(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return i;
 }
 
+/*
+ * Replay packets of a memory-mapped file. Packet data is not copied, the
+ * mbufs are attached to the mapping as external buffers.
+ */
+static uint16_t
+eth_pcap_rx_replay(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pcap_rx_queue *pcap_q = queue;
+	const struct pmd_internals *internals =
+		rte_eth_devices[pcap_q->port_id].data->dev_private;
+	struct pcap_replay_index *index = pcap_q->replay;
+	const struct pcap_replay_pkt *pkt;
+	struct rte_mbuf_ext_shared_info *shinfo;
+	struct rte_mbuf *mbuf;
+	uint64_t now = 0, ts;
+	uint32_t rx_bytes = 0;
+	uint16_t i;
+
+	if (unlikely(index == NULL || index->nb_pkts == 0))
+		return 0;
+
+	if (!internals->infinite_rx)
+		nb_pkts = RTE_MIN((uint64_t)nb_pkts,
+				index->nb_pkts - pcap_q->replay_next);
+	if (unlikely(nb_pkts == 0))
+		return 0;
+
+	if (rte_pktmbuf_alloc_bulk(pcap_q->mb_pool, bufs, nb_pkts) != 0)
+		return 0;
+
+	if (internals->replay_cycles_per_ns > 0)
+		now = rte_get_timer_cycles();
+
+	for (i = 0; i < nb_pkts; i++) {
+		if (pcap_q->replay_next == index->nb_pkts) {
+			/* Loop over the file, after its last packet. */
+			pcap_q->replay_next = 0;
+			pcap_q->replay_loop_ts += internals->replay_duration;
+		}
+		pkt = &index->pkts[pcap_q->replay_next];
+		ts = pkt->ts + pcap_q->replay_loop_ts;
+
+		/* Stop at the first packet which is not due yet. */
+		if (now != 0 && internals->replay_start_tsc +
+				(uint64_t)(ts * internals->replay_cycles_per_ns)
+				> now)
+			break;
+
+		if (pcap_q->replay_next + 1 < index->nb_pkts)
+			rte_prefetch0(index->base + pkt[1].offset);
+
+		mbuf = bufs[i];
+		shinfo = &index->shinfo[pcap_q->replay_next &
+				(PCAP_REPLAY_SHINFO_NUM - 1)];
+		rte_mbuf_ext_refcnt_update(shinfo, 1);
+		rte_pktmbuf_attach_extbuf(mbuf,
+				(void *)(uintptr_t)(index->base + pkt->offset),
+				RTE_BAD_IOVA, pkt->len, shinfo);
+		mbuf->data_len = pkt->len;
+		mbuf->pkt_len = pkt->len;
+		mbuf->timestamp = (internals->replay_first_ts + ts) / 1000;
+		mbuf->ol_flags |= PKT_RX_TIMESTAMP;
+		mbuf->port = pcap_q->port_id;
+		rx_bytes += pkt->len;
+		pcap_q->replay_next++;
+	}
+
+	if (i < nb_pkts)
+		rte_mempool_put_bulk(pcap_q->mb_pool, (void **)&bufs[i],
+				nb_pkts - i);
+
+	pcap_q->rx_stat.pkts += i;
+	pcap_q->rx_stat.bytes += rx_bytes;
+
+	return i;
+}
+
 static uint16_t
 eth_pcap_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
@@ -565,6 +670,17 @@ eth_dev_start(struct rte_eth_dev *dev)
 		}
 	}
 
+	/* Replay starts over from the first packet */
+	if (pp->replay != NULL) {
+		for (i = 0; i < dev->data->nb_rx_queues; i++) {
+			rx = &internals->rx_queue[i];
+			rx->replay_next = 0;
+			rx->replay_loop_ts = 0;
+		}
+		internals->replay_start_tsc = rte_get_timer_cycles();
+		goto status_up;
+	}
+
 	/* If not open already, open rx pcaps */
 	for (i = 0; i < dev->data->nb_rx_queues; i++) {
 		rx = &internals->rx_queue[i];
@@ -724,6 +840,16 @@ eth_dev_close(struct rte_eth_dev *dev)
 {
 	unsigned int i;
 	struct pmd_internals *internals = dev->data->dev_private;
+	struct pmd_process_private *pp = dev->process_private;
+
+	/* Mbufs still attached keep the mapping until they are freed. */
+	if (pp->replay != NULL) {
+		for (i = 0; i < dev->data->nb_rx_queues; i++)
+			internals->rx_queue[i].replay = NULL;
+		pcap_replay_close(pp->replay);
+		pp->replay = NULL;
+		return;
+	}
 
 	/* Device wide flag, but cleanup must be performed per queue. */
 	if (internals->infinite_rx) {
@@ -762,6 +888,7 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 		struct rte_mempool *mb_pool)
 {
 	struct pmd_internals *internals = dev->data->dev_private;
+	struct pmd_process_private *pp = dev->process_private;
 	struct pcap_rx_queue *pcap_q = &internals->rx_queue[rx_queue_id];
 
 	pcap_q->mb_pool = mb_pool;
@@ -769,15 +896,18 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 	pcap_q->queue_id = rx_queue_id;
 	dev->data->rx_queues[rx_queue_id] = pcap_q;
 
+	if (pp->replay != NULL) {
+		pcap_q->replay = &pp->replay->queue[rx_queue_id];
+		return 0;
+	}
+
 	if (internals->infinite_rx) {
-		struct pmd_process_private *pp;
 		char ring_name[NAME_MAX];
 		static uint32_t ring_number;
 		uint64_t pcap_pkt_count = 0;
 		struct rte_mbuf *bufs[1];
 		pcap_t **pcap;
 
-		pp = rte_eth_devices[pcap_q->port_id].process_private;
 		pcap = &pp->rx_pcap[pcap_q->queue_id];
 
 		if (unlikely(*pcap == NULL))
@@ -1073,6 +1203,139 @@ get_infinite_rx_arg(const char *key __rte_unused,
 	return 0;
 }
 
+static int
+get_replay_file_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	*(const char **)extra_args = value;
+	return 0;
+}
+
+static int
+get_replay_queues_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	unsigned int *nb_queues = extra_args;
+	char *end;
+	unsigned long n;
+
+	errno = 0;
+	n = strtoul(value, &end, 10);
+	if (errno != 0 || *end != '\0' || n == 0 ||
+			n > RTE_PMD_PCAP_MAX_QUEUES) {
+		PMD_LOG(ERR, "Invalid %s: %s, must be 1 to %d",
+			ETH_PCAP_REPLAY_QUEUES_ARG, value,
+			RTE_PMD_PCAP_MAX_QUEUES);
+		return -EINVAL;
+	}
+	*nb_queues = n;
+	return 0;
+}
+
+static int
+get_replay_hash_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	enum pcap_replay_hash *hash = extra_args;
+
+	if (strcmp(value, "flow") == 0)
+		*hash = PCAP_REPLAY_HASH_FLOW;
+	else if (strcmp(value, "ip") == 0)
+		*hash = PCAP_REPLAY_HASH_IP;
+	else if (strcmp(value, "rr") == 0)
+		*hash = PCAP_REPLAY_HASH_RR;
+	else {
+		PMD_LOG(ERR, "Invalid %s: %s, must be flow, ip or rr",
+			ETH_PCAP_REPLAY_HASH_ARG, value);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static int
+get_replay_speed_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	double *speed = extra_args;
+	char *end;
+
+	errno = 0;
+	*speed = strtod(value, &end);
+	if (errno != 0 || *end != '\0' || *speed < 0) {
+		PMD_LOG(ERR, "Invalid %s: %s", ETH_PCAP_REPLAY_SPEED_ARG,
+			value);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+/*
+ * Maps the file to replay and spreads its packets over the rx queues.
+ */
+static int
+open_replay(struct rte_kvargs *kvlist, struct pmd_devargs_all *devargs_all,
+		struct pmd_devargs *pcaps)
+{
+	unsigned int i;
+	int ret;
+
+	if (rte_kvargs_count(kvlist, ETH_PCAP_REPLAY_ARG) != 1) {
+		PMD_LOG(ERR, "Only one file can be replayed per port");
+		return -EINVAL;
+	}
+
+	devargs_all->replay_queues = 1;
+	devargs_all->replay_hash = PCAP_REPLAY_HASH_FLOW;
+	devargs_all->replay_speed = 0;
+
+	ret = rte_kvargs_process(kvlist, ETH_PCAP_REPLAY_ARG,
+			&get_replay_file_arg, &devargs_all->replay_file);
+	if (ret < 0)
+		return ret;
+	ret = rte_kvargs_process(kvlist, ETH_PCAP_REPLAY_QUEUES_ARG,
+			&get_replay_queues_arg, &devargs_all->replay_queues);
+	if (ret < 0)
+		return ret;
+	ret = rte_kvargs_process(kvlist, ETH_PCAP_REPLAY_HASH_ARG,
+			&get_replay_hash_arg, &devargs_all->replay_hash);
+	if (ret < 0)
+		return ret;
+	ret = rte_kvargs_process(kvlist, ETH_PCAP_REPLAY_SPEED_ARG,
+			&get_replay_speed_arg, &devargs_all->replay_speed);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < devargs_all->replay_queues; i++) {
+		ret = add_queue(pcaps, devargs_all->replay_file,
+				ETH_PCAP_REPLAY_ARG, NULL, NULL);
+		if (ret < 0)
+			return ret;
+	}
+
+	/* The mapping is per process, secondaries do not replay. */
+	if (rte_eal_process_type() == RTE_PROC_SECONDARY)
+		return 0;
+
+	ret = pcap_replay_open(devargs_all->replay_file,
+			devargs_all->replay_queues, devargs_all->replay_hash,
+			&devargs_all->replay);
+	if (ret < 0) {
+		PMD_LOG(ERR, "Couldn't replay %s: %s",
+			devargs_all->replay_file, strerror(-ret));
+		return ret;
+	}
+	if (devargs_all->replay->nb_skipped != 0)
+		PMD_LOG(WARNING, "%" PRIu64 " packets larger than %u bytes "
+			"will not be replayed from %s",
+			devargs_all->replay->nb_skipped, UINT16_MAX,
+			devargs_all->replay_file);
+	PMD_LOG(INFO, "Replaying %" PRIu64 " packets from %s on %u queues",
+		devargs_all->replay->nb_pkts, devargs_all->replay_file,
+		devargs_all->replay_queues);
+
+	return 0;
+}
+
 static int
 pmd_init_internals(struct rte_vdev_device *vdev,
 		const unsigned int nb_rx_queues,
@@ -1295,8 +1558,23 @@ eth_from_pcaps(struct rte_vdev_device *vdev,
 	}
 
 	internals->infinite_rx = infinite_rx;
+
+	if (devargs_all->replay != NULL) {
+		struct pmd_process_private *pp = eth_dev->process_private;
+
+		pp->replay = devargs_all->replay;
+		internals->replay_first_ts = pp->replay->first_ts;
+		internals->replay_duration = pp->replay->duration;
+		internals->replay_cycles_per_ns = 0;
+		if (devargs_all->replay_speed > 0)
+			internals->replay_cycles_per_ns = (double)hz / 1E9 /
+				devargs_all->replay_speed;
+	}
+
 	/* Assign rx ops. */
-	if (infinite_rx)
+	if (devargs_all->replay != NULL)
+		eth_dev->rx_pkt_burst = eth_pcap_rx_replay;
+	else if (infinite_rx)
 		eth_dev->rx_pkt_burst = eth_pcap_rx_infinite;
 	else if (devargs_all->is_rx_pcap || devargs_all->is_rx_iface ||
 			single_iface)
@@ -1395,6 +1673,8 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 		rte_kvargs_count(kvlist, ETH_PCAP_RX_PCAP_ARG) ? 1 : 0;
 	devargs_all.is_rx_iface =
 		rte_kvargs_count(kvlist, ETH_PCAP_RX_IFACE_ARG) ? 1 : 0;
+	devargs_all.is_rx_replay =
+		rte_kvargs_count(kvlist, ETH_PCAP_REPLAY_ARG) ? 1 : 0;
 	pcaps.num_of_queue = 0;
 
 	devargs_all.is_tx_pcap =
@@ -1403,7 +1683,7 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 		rte_kvargs_count(kvlist, ETH_PCAP_TX_IFACE_ARG) ? 1 : 0;
 	dumpers.num_of_queue = 0;
 
-	if (devargs_all.is_rx_pcap) {
+	if (devargs_all.is_rx_pcap || devargs_all.is_rx_replay) {
 		/*
 		 * We check whether we want to infinitely rx the pcap file.
 		 */
@@ -1426,7 +1706,11 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 					"argument has been provided more than once "
 					"for %s", name);
 		}
+	}
 
+	if (devargs_all.is_rx_replay) {
+		ret = open_replay(kvlist, &devargs_all, &pcaps);
+	} else if (devargs_all.is_rx_pcap) {
 		ret = rte_kvargs_process(kvlist, ETH_PCAP_RX_PCAP_ARG,
 				&open_rx_pcap, &pcaps);
 	} else if (devargs_all.is_rx_iface) {
@@ -1526,6 +1810,8 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 	ret = eth_from_pcaps(dev, &devargs_all);
 
 free_kvlist:
+	if (ret < 0)
+		pcap_replay_close(devargs_all.replay);
 	rte_kvargs_free(kvlist);
 
 	return ret;
@@ -1578,7 +1864,11 @@ RTE_PMD_REGISTER_PARAM_STRING(net_pcap,
 	ETH_PCAP_TX_IFACE_ARG "=<ifc> "
 	ETH_PCAP_IFACE_ARG "=<ifc> "
 	ETH_PCAP_PHY_MAC_ARG "=<int>"
-	ETH_PCAP_INFINITE_RX_ARG "=<0|1>");
+	ETH_PCAP_INFINITE_RX_ARG "=<0|1> "
+	ETH_PCAP_REPLAY_ARG "=<string> "
+	ETH_PCAP_REPLAY_QUEUES_ARG "=<int> "
+	ETH_PCAP_REPLAY_HASH_ARG "=flow|ip|rr "
+	ETH_PCAP_REPLAY_SPEED_ARG "=<float>");
 
 RTE_INIT(eth_pcap_init_log)
 {
@@ -11,12 +11,30 @@
 #include <rte_bus_vdev.h>
 #include <rte_kvargs.h>
 #include <rte_errno.h>
+#include <rte_net.h>
+#include <rte_thash.h>
 
 #define ETH_RING_NUMA_NODE_ACTION_ARG	"nodeaction"
 #define ETH_RING_ACTION_CREATE		"CREATE"
 #define ETH_RING_ACTION_ATTACH		"ATTACH"
 #define ETH_RING_INTERNAL_ARG		"internal"
 
+#define ETH_RING_RSS_KEY_SIZE		40
+#define ETH_RING_RSS_BURST		32
+#define ETH_RING_RSS_OFFLOAD_ALL ( \
+	ETH_RSS_IPV4 | \
+	ETH_RSS_FRAG_IPV4 | \
+	ETH_RSS_NONFRAG_IPV4_TCP | \
+	ETH_RSS_NONFRAG_IPV4_UDP | \
+	ETH_RSS_NONFRAG_IPV4_SCTP | \
+	ETH_RSS_NONFRAG_IPV4_OTHER | \
+	ETH_RSS_IPV6 | \
+	ETH_RSS_FRAG_IPV6 | \
+	ETH_RSS_NONFRAG_IPV6_TCP | \
+	ETH_RSS_NONFRAG_IPV6_UDP | \
+	ETH_RSS_NONFRAG_IPV6_SCTP | \
+	ETH_RSS_NONFRAG_IPV6_OTHER)
+
 static const char *valid_arguments[] = {
 	ETH_RING_NUMA_NODE_ACTION_ARG,
 	ETH_RING_INTERNAL_ARG,
@@ -37,10 +55,13 @@ enum dev_action {
 	DEV_ATTACH
 };
 
+struct pmd_internals;
+
 struct ring_queue {
 	struct rte_ring *rng;
 	rte_atomic64_t rx_pkts;
 	rte_atomic64_t tx_pkts;
+	struct pmd_internals *internals;
 };
 
 struct pmd_internals {
@@ -52,6 +73,23 @@ struct pmd_internals {
 
 	struct rte_ether_addr address;
 	enum dev_action action;
+
+	/*
+	 * RSS is applied on transmit: the hash must be known before a packet
+	 * is enqueued, to pick the ring, i.e. the peer rx queue.
+	 */
+	uint64_t rss_hf;
+	uint16_t reta[ETH_RSS_RETA_SIZE_128];
+	uint8_t rss_key[ETH_RING_RSS_KEY_SIZE] __rte_aligned(sizeof(uint32_t));
+	/* key converted for rte_softrss_be() */
+	uint32_t rss_key_be[ETH_RING_RSS_KEY_SIZE / sizeof(uint32_t)];
+};
+
+static const uint8_t default_rss_key[ETH_RING_RSS_KEY_SIZE] = {
+	0x6D, 0x5A, 0x56, 0xDA, 0x25, 0x5B, 0x0E, 0xC2, 0x41, 0x67, 0x25, 0x3D,
+	0x43, 0xA3, 0x8F, 0xB0, 0xD0, 0xCA, 0x2B, 0xCB, 0xAE, 0x7B, 0x30, 0xB4,
+	0x77, 0xCB, 0x2D, 0xA3, 0x80, 0x30, 0xF2, 0x0C, 0x6A, 0x42, 0xB7, 0x3B,
+	0xBE, 0xAC, 0x01, 0xFA
 };
 
 static struct rte_eth_link pmd_link = {
@@ -95,8 +133,229 @@ eth_ring_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 	return nb_tx;
 }
 
+/*
+ * Select the tuple to hash, as a NIC would for the enabled RSS types:
+ * returns 2 for addresses and ports, 1 for addresses only, 0 for none.
+ */
+static inline int
+eth_ring_rss_fields(uint64_t rss_hf, uint32_t l4_ptype, int ipv6)
+{
+	uint64_t l3_hf = ipv6 ? ETH_RSS_IPV6 : ETH_RSS_IPV4;
+	uint64_t l4_hf = 0;
+
+	switch (l4_ptype) {
+	case RTE_PTYPE_L4_TCP:
+		l4_hf = ipv6 ? ETH_RSS_NONFRAG_IPV6_TCP :
+			ETH_RSS_NONFRAG_IPV4_TCP;
+		break;
+	case RTE_PTYPE_L4_UDP:
+		l4_hf = ipv6 ? ETH_RSS_NONFRAG_IPV6_UDP :
+			ETH_RSS_NONFRAG_IPV4_UDP;
+		break;
+	case RTE_PTYPE_L4_SCTP:
+		l4_hf = ipv6 ? ETH_RSS_NONFRAG_IPV6_SCTP :
+			ETH_RSS_NONFRAG_IPV4_SCTP;
+		break;
+	case RTE_PTYPE_L4_FRAG:
+		l3_hf |= ipv6 ? ETH_RSS_FRAG_IPV6 : ETH_RSS_FRAG_IPV4;
+		break;
+	default:
+		l3_hf |= ipv6 ? ETH_RSS_NONFRAG_IPV6_OTHER :
+			ETH_RSS_NONFRAG_IPV4_OTHER;
+		break;
+	}
+
+	if (rss_hf & l4_hf)
+		return 2;
+	if (rss_hf & l3_hf)
+		return 1;
+	return 0;
+}
+
+/* Compute the Toeplitz hash of a packet, return 0 if it is not hashed */
+static inline int
+eth_ring_rss_hash(const struct pmd_internals *internals, struct rte_mbuf *m,
+		uint32_t *hash)
+{
+	union rte_thash_tuple tuple;
+	struct rte_net_hdr_lens hdr_lens;
+	const struct rte_udp_hdr *l4;
+	struct rte_udp_hdr l4_copy;
+	uint32_t ptype, len;
+	int fields;
+
+	ptype = rte_net_get_ptype(m, &hdr_lens, RTE_PTYPE_L2_MASK |
+			RTE_PTYPE_L3_MASK | RTE_PTYPE_L4_MASK);
+
+	if (RTE_ETH_IS_IPV4_HDR(ptype)) {
+		const struct rte_ipv4_hdr *ip;
+		struct rte_ipv4_hdr ip_copy;
+
+		fields = eth_ring_rss_fields(internals->rss_hf,
+				ptype & RTE_PTYPE_L4_MASK, 0);
+		if (fields == 0)
+			return 0;
+		ip = rte_pktmbuf_read(m, hdr_lens.l2_len, sizeof(*ip),
+				&ip_copy);
+		if (ip == NULL)
+			return 0;
+		tuple.v4.src_addr = rte_be_to_cpu_32(ip->src_addr);
+		tuple.v4.dst_addr = rte_be_to_cpu_32(ip->dst_addr);
+		len = (fields == 2) ? RTE_THASH_V4_L4_LEN : RTE_THASH_V4_L3_LEN;
+	} else if (RTE_ETH_IS_IPV6_HDR(ptype)) {
+		const struct rte_ipv6_hdr *ip;
+		struct rte_ipv6_hdr ip_copy;
+
+		fields = eth_ring_rss_fields(internals->rss_hf,
+				ptype & RTE_PTYPE_L4_MASK, 1);
+		if (fields == 0)
+			return 0;
+		ip = rte_pktmbuf_read(m, hdr_lens.l2_len, sizeof(*ip),
+				&ip_copy);
+		if (ip == NULL)
+			return 0;
+		rte_thash_load_v6_addrs(ip, &tuple);
+		len = (fields == 2) ? RTE_THASH_V6_L4_LEN : RTE_THASH_V6_L3_LEN;
+	} else {
+		return 0;
+	}
+
+	if (fields == 2) {
+		/* TCP, UDP and SCTP ports are at the same place */
+		l4 = rte_pktmbuf_read(m, hdr_lens.l2_len + hdr_lens.l3_len,
+				sizeof(*l4), &l4_copy);
+		if (l4 == NULL)
+			return 0;
+		if (RTE_ETH_IS_IPV4_HDR(ptype)) {
+			tuple.v4.sport = rte_be_to_cpu_16(l4->src_port);
+			tuple.v4.dport = rte_be_to_cpu_16(l4->dst_port);
+		} else {
+			tuple.v6.sport = rte_be_to_cpu_16(l4->src_port);
+			tuple.v6.dport = rte_be_to_cpu_16(l4->dst_port);
+		}
+	}
+
+	*hash = rte_softrss_be((uint32_t *)&tuple, len,
+			(const uint8_t *)internals->rss_key_be);
+	return 1;
+}
+
+/*
+ * Transmit with RSS: each packet goes to the ring selected by the RETA
+ * entry of its hash. As several tx queues may then feed the same ring,
+ * the multi-producer enqueue is used. Packets which could not be
+ * enqueued are moved to the end of bufs, as the bonding PMD does.
+ */
+static uint16_t
+eth_ring_tx_rss(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
+{
+	struct ring_queue *r = q;
+	const struct pmd_internals *internals = r->internals;
+	struct rte_mbuf *queue_bufs[RTE_PMD_RING_MAX_TX_RINGS]
+			[ETH_RING_RSS_BURST];
+	uint16_t nb_queue_bufs[RTE_PMD_RING_MAX_TX_RINGS];
+	struct rte_mbuf *unsent[ETH_RING_RSS_BURST];
+	uint16_t nb_tx = 0, nb_sent, nb_unsent, nb, i, qid, k;
+	struct rte_mbuf *m;
+	uint32_t hash;
+
+	while (nb_tx < nb_bufs) {
+		nb = RTE_MIN(nb_bufs - nb_tx, ETH_RING_RSS_BURST);
+		memset(nb_queue_bufs, 0, sizeof(nb_queue_bufs));
+
+		for (i = 0; i < nb; i++) {
+			m = bufs[nb_tx + i];
+			qid = 0;
+			if (eth_ring_rss_hash(internals, m, &hash)) {
+				m->hash.rss = hash;
+				m->ol_flags |= PKT_RX_RSS_HASH;
+				qid = internals->reta[hash &
+					(ETH_RSS_RETA_SIZE_128 - 1)];
+			}
+			queue_bufs[qid][nb_queue_bufs[qid]++] = m;
+		}
+
+		nb_sent = 0;
+		nb_unsent = 0;
+		for (qid = 0; qid < internals->max_tx_queues; qid++) {
+			if (nb_queue_bufs[qid] == 0)
+				continue;
+
+			k = rte_ring_mp_enqueue_burst(
+					internals->tx_ring_queues[qid].rng,
+					(void **)queue_bufs[qid],
+					nb_queue_bufs[qid], NULL);
+			for (i = 0; i < k; i++)
+				bufs[nb_tx + nb_sent++] = queue_bufs[qid][i];
+			for (; i < nb_queue_bufs[qid]; i++)
+				unsent[nb_unsent++] = queue_bufs[qid][i];
+		}
+
+		if (nb_unsent != 0) {
+			memcpy(&bufs[nb_tx + nb_sent], unsent,
+				sizeof(unsent[0]) * nb_unsent);
+			nb_tx += nb_sent;
+			break;
+		}
+		nb_tx += nb;
+	}
+
+	if (r->rng->flags & RING_F_SP_ENQ)
+		r->tx_pkts.cnt += nb_tx;
+	else
+		rte_atomic64_add(&(r->tx_pkts), nb_tx);
+	return nb_tx;
+}
+
+/* Switch the tx burst function according to the enabled RSS types */
+static void
+eth_ring_rss_apply(struct rte_eth_dev *dev)
+{
+	struct pmd_internals *internals = dev->data->dev_private;
+
+	dev->tx_pkt_burst = (internals->rss_hf != 0) ?
+		eth_ring_tx_rss : eth_ring_tx;
+}
+
+static void
+eth_ring_rss_key_set(struct pmd_internals *internals, const uint8_t *key)
+{
+	memcpy(internals->rss_key, key, ETH_RING_RSS_KEY_SIZE);
+	rte_convert_rss_key((const uint32_t *)internals->rss_key,
+			internals->rss_key_be, ETH_RING_RSS_KEY_SIZE);
+}
+
 static int
-eth_dev_configure(struct rte_eth_dev *dev __rte_unused) { return 0; }
+eth_dev_configure(struct rte_eth_dev *dev)
+{
+	struct pmd_internals *internals = dev->data->dev_private;
+	struct rte_eth_conf *dev_conf = &dev->data->dev_conf;
+	struct rte_eth_rss_conf *rss_conf = &dev_conf->rx_adv_conf.rss_conf;
+	unsigned int i;
+
+	internals->rss_hf = 0;
+	if (dev_conf->rxmode.mq_mode & ETH_MQ_RX_RSS_FLAG)
+		internals->rss_hf = rss_conf->rss_hf & ETH_RING_RSS_OFFLOAD_ALL;
+
+	if (rss_conf->rss_key != NULL) {
+		if (rss_conf->rss_key_len != ETH_RING_RSS_KEY_SIZE) {
+			PMD_LOG(ERR, "RSS key length must be %d",
+				ETH_RING_RSS_KEY_SIZE);
+			return -EINVAL;
+		}
+		eth_ring_rss_key_set(internals, rss_conf->rss_key);
+	} else {
+		eth_ring_rss_key_set(internals, default_rss_key);
+	}
+
+	/* rx only ports have no ring to steer packets to */
+	for (i = 0; i < RTE_DIM(internals->reta); i++)
+		internals->reta[i] = (dev->data->nb_tx_queues != 0) ?
+			i % dev->data->nb_tx_queues : 0;
+
+	eth_ring_rss_apply(dev);
+	return 0;
+}
 
 static int
 eth_dev_start(struct rte_eth_dev *dev)
@@ -146,6 +405,7 @@ eth_tx_queue_setup(struct rte_eth_dev *dev, uint16_t tx_queue_id,
 {
 	struct pmd_internals *internals = dev->data->dev_private;
 
+	internals->tx_ring_queues[tx_queue_id].internals = internals;
 	dev->data->tx_queues[tx_queue_id] = &internals->tx_ring_queues[tx_queue_id];
 	return 0;
 }
@@ -162,6 +422,93 @@ eth_dev_info(struct rte_eth_dev *dev,
 	dev_info->max_rx_queues = (uint16_t)internals->max_rx_queues;
 	dev_info->max_tx_queues = (uint16_t)internals->max_tx_queues;
 	dev_info->min_rx_bufsize = 0;
+	dev_info->reta_size = ETH_RSS_RETA_SIZE_128;
+	dev_info->hash_key_size = ETH_RING_RSS_KEY_SIZE;
+	dev_info->flow_type_rss_offloads = ETH_RING_RSS_OFFLOAD_ALL;
+
+	return 0;
+}
+
+static int
+eth_rss_reta_update(struct rte_eth_dev *dev,
+		struct rte_eth_rss_reta_entry64 *reta_conf, uint16_t reta_size)
+{
+	struct pmd_internals *internals = dev->data->dev_private;
+	uint16_t i, idx, shift;
+
+	if (reta_size != ETH_RSS_RETA_SIZE_128)
+		return -EINVAL;
+
+	/* entries select the ring a packet is transmitted to */
+	for (i = 0; i < reta_size; i++) {
+		idx = i / RTE_RETA_GROUP_SIZE;
+		shift = i % RTE_RETA_GROUP_SIZE;
+		if ((reta_conf[idx].mask >> shift) & 0x1 &&
+				reta_conf[idx].reta[shift] >=
+				dev->data->nb_tx_queues)
+			return -EINVAL;
+	}
+
+	for (i = 0; i < reta_size; i++) {
+		idx = i / RTE_RETA_GROUP_SIZE;
+		shift = i % RTE_RETA_GROUP_SIZE;
+		if ((reta_conf[idx].mask >> shift) & 0x1)
+			internals->reta[i] = reta_conf[idx].reta[shift];
+	}
+
+	return 0;
+}
+
+static int
+eth_rss_reta_query(struct rte_eth_dev *dev,
+		struct rte_eth_rss_reta_entry64 *reta_conf, uint16_t reta_size)
+{
+	struct pmd_internals *internals = dev->data->dev_private;
+	uint16_t i, idx, shift;
+
+	if (reta_size != ETH_RSS_RETA_SIZE_128)
+		return -EINVAL;
+
+	for (i = 0; i < reta_size; i++) {
+		idx = i / RTE_RETA_GROUP_SIZE;
+		shift = i % RTE_RETA_GROUP_SIZE;
+		if ((reta_conf[idx].mask >> shift) & 0x1)
+			reta_conf[idx].reta[shift] = internals->reta[i];
+	}
+
+	return 0;
+}
+
+static int
+eth_rss_hash_update(struct rte_eth_dev *dev, struct rte_eth_rss_conf *rss_conf)
+{
+	struct pmd_internals *internals = dev->data->dev_private;
+
+	if (rss_conf->rss_key != NULL) {
+		if (rss_conf->rss_key_len != ETH_RING_RSS_KEY_SIZE)
+			return -EINVAL;
+		eth_ring_rss_key_set(internals, rss_conf->rss_key);
+	}
+
+	internals->rss_hf = rss_conf->rss_hf & ETH_RING_RSS_OFFLOAD_ALL;
+	dev->data->dev_conf.rx_adv_conf.rss_conf.rss_hf = internals->rss_hf;
+	eth_ring_rss_apply(dev);
+
+	return 0;
+}
+
+static int
+eth_rss_hash_conf_get(struct rte_eth_dev *dev,
+		struct rte_eth_rss_conf *rss_conf)
+{
+	struct pmd_internals *internals = dev->data->dev_private;
+
+	rss_conf->rss_hf = internals->rss_hf;
+	if (rss_conf->rss_key != NULL) {
+		memcpy(rss_conf->rss_key, internals->rss_key,
+			ETH_RING_RSS_KEY_SIZE);
+		rss_conf->rss_key_len = ETH_RING_RSS_KEY_SIZE;
+	}
 
 	return 0;
 }
@@ -242,6 +589,10 @@ static const struct eth_dev_ops ops = {
 	.stats_reset = eth_stats_reset,
 	.mac_addr_remove = eth_mac_addr_remove,
 	.mac_addr_add = eth_mac_addr_add,
+	.reta_update = eth_rss_reta_update,
+	.reta_query = eth_rss_reta_query,
+	.rss_hash_update = eth_rss_hash_update,
+	.rss_hash_conf_get = eth_rss_hash_conf_get,
 };
 
 static int
@@ -54,6 +54,7 @@
 #define ETH_TAP_REMOTE_ARG      "remote"
 #define ETH_TAP_MAC_ARG         "mac"
 #define ETH_TAP_MAC_FIXED       "fixed"
+#define ETH_TAP_VNET_HDR_ARG    "vnet_hdr"
 
 #define ETH_TAP_USR_MAC_FMT     "xx:xx:xx:xx:xx:xx"
 #define ETH_TAP_CMP_MAC_FMT     "0123456789ABCDEFabcdef"
@@ -70,12 +71,16 @@
 
 #define TAP_IOV_DEFAULT_MAX 1024
 
+/* Largest packet exchanged with the kernel when it does TSO/GRO */
+#define TAP_VNET_MAX_PKT_LEN (RTE_IPV4_MAX_PKT_LEN + RTE_ETHER_HDR_LEN)
+
 static int tap_devices_count;
 
 static const char *valid_arguments[] = {
 	ETH_TAP_IFACE_ARG,
 	ETH_TAP_REMOTE_ARG,
 	ETH_TAP_MAC_ARG,
+	ETH_TAP_VNET_HDR_ARG,
 	NULL
 };
 
@@ -144,6 +149,14 @@ tun_alloc(struct pmd_internals *pmd, int is_keepalive)
 	 */
 	ifr.ifr_flags = (pmd->type == ETH_TUNTAP_TYPE_TAP) ?
 		IFF_TAP : IFF_TUN | IFF_POINTOPOINT;
+	/*
+	 * With a virtio-net header, checksums and TCP segmentation are
+	 * left to the kernel, which also passes GRO packets unsegmented.
+	 */
+	RTE_BUILD_BUG_ON(sizeof(struct tap_pkt_hdr) !=
+			 sizeof(struct tun_pi) + sizeof(struct virtio_net_hdr));
+	if (pmd->vnet_hdr)
+		ifr.ifr_flags |= IFF_VNET_HDR;
 	strlcpy(ifr.ifr_name, pmd->name, IFNAMSIZ);
 
 	fd = open(TUN_TAP_DEV_PATH, O_RDWR);
@@ -321,6 +334,48 @@ tap_verify_csum(struct rte_mbuf *mbuf)
 	}
 }
 
+/* Report the offloads done by the kernel, as described by the vnet header */
+static void
+tap_rx_vnet_offload(struct rte_mbuf *mbuf, const struct virtio_net_hdr *hdr,
+		    const struct rte_net_hdr_lens *hdr_lens)
+{
+	uint32_t l4 = mbuf->packet_type & RTE_PTYPE_L4_MASK;
+	int l4_supported = (l4 == RTE_PTYPE_L4_TCP || l4 == RTE_PTYPE_L4_UDP);
+
+	if (hdr->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) {
+		if (l4_supported &&
+		    hdr->csum_start == hdr_lens->l2_len + hdr_lens->l3_len) {
+			/* checksum not computed, data known to be valid */
+			mbuf->ol_flags |= PKT_RX_L4_CKSUM_NONE;
+		} else {
+			/* Unknown protocol or tunnel, do sw cksum */
+			uint16_t csum = 0, off;
+
+			rte_raw_cksum_mbuf(mbuf, hdr->csum_start,
+				rte_pktmbuf_pkt_len(mbuf) - hdr->csum_start,
+				&csum);
+			if (likely(csum != 0xffff))
+				csum = ~csum;
+			off = hdr->csum_offset + hdr->csum_start;
+			if (rte_pktmbuf_data_len(mbuf) >= off + 1)
+				*rte_pktmbuf_mtod_offset(mbuf, uint16_t *,
+					off) = csum;
+		}
+	} else if (hdr->flags & VIRTIO_NET_HDR_F_DATA_VALID && l4_supported) {
+		mbuf->ol_flags |= PKT_RX_L4_CKSUM_GOOD;
+	}
+
+	switch (hdr->gso_type & ~VIRTIO_NET_HDR_GSO_ECN) {
+	case VIRTIO_NET_HDR_GSO_TCPV4:
+	case VIRTIO_NET_HDR_GSO_TCPV6:
+		mbuf->ol_flags |= PKT_RX_LRO;
+		mbuf->tso_segsz = hdr->gso_size;
+		break;
+	default:
+		break;
+	}
+}
+
 static uint64_t
 tap_rx_offload_get_port_capa(void)
 {
@@ -360,22 +415,25 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		struct rte_mbuf *seg = NULL;
 		struct rte_mbuf *new_tail = NULL;
 		uint16_t data_off = rte_pktmbuf_headroom(mbuf);
+
+		struct rte_net_hdr_lens hdr_lens;
+		int hdr_len = (*rxq->iovecs)[0].iov_len;
 		int len;
 
 		len = readv(process_private->rxq_fds[rxq->queue_id],
 			*rxq->iovecs,
 			1 + (rxq->rxmode->offloads & DEV_RX_OFFLOAD_SCATTER ?
 			     rxq->nb_rx_desc : 1));
-		if (len < (int)sizeof(struct tun_pi))
+		if (len < hdr_len)
 			break;
 
 		/* Packet couldn't fit in the provided mbuf */
-		if (unlikely(rxq->pi.flags & TUN_PKT_STRIP)) {
+		if (unlikely(rxq->hdr.pi.flags & TUN_PKT_STRIP)) {
 			rxq->stats.ierrors++;
 			continue;
 		}
 
-		len -= sizeof(struct tun_pi);
+		len -= hdr_len;
 
 		mbuf->pkt_len = len;
 		mbuf->port = rxq->in_port;
@@ -418,9 +476,12 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			data_off = 0;
 		}
 		seg->next = NULL;
-		mbuf->packet_type = rte_net_get_ptype(mbuf, NULL,
+		mbuf->packet_type = rte_net_get_ptype(mbuf, &hdr_lens,
 						      RTE_PTYPE_ALL_MASK);
-		if (rxq->rxmode->offloads & DEV_RX_OFFLOAD_CHECKSUM)
+		if (rxq->vnet_hdr && (rxq->hdr.vnet.flags ||
+		    rxq->hdr.vnet.gso_type != VIRTIO_NET_HDR_GSO_NONE))
+			tap_rx_vnet_offload(mbuf, &rxq->hdr.vnet, &hdr_lens);
+		else if (rxq->rxmode->offloads & DEV_RX_OFFLOAD_CHECKSUM)
 			tap_verify_csum(mbuf);
 
 		/* account for the receive frame */
@@ -521,6 +582,64 @@ tap_tx_l3_cksum(char *packet, uint64_t ol_flags, unsigned int l2_len,
 	}
 }
 
+/*
+ * Leave L4 checksum and TCP segmentation to the kernel: fill the vnet
+ * header and put the pseudo header checksum in the copied L4 header, the
+ * way the kernel expects it for partially checksummed packets.
+ */
+static void
+tap_tx_vnet_hdr(char *packet, const struct rte_mbuf *mbuf,
+		struct virtio_net_hdr *vnet)
+{
+	uint64_t ol_flags = mbuf->ol_flags;
+	void *l3_hdr = packet + mbuf->l2_len;
+	uint16_t l3_plen = rte_pktmbuf_pkt_len(mbuf) - mbuf->l2_len;
+	uint16_t *l4_cksum;
+	uint16_t csum_offset;
+
+	if (ol_flags & PKT_TX_IPV4) {
+		struct rte_ipv4_hdr *iph = l3_hdr;
+		uint16_t cksum;
+
+		/* the kernel checks it before segmenting */
+		if (ol_flags & PKT_TX_TCP_SEG)
+			iph->total_length = rte_cpu_to_be_16(l3_plen);
+		iph->hdr_checksum = 0;
+		cksum = rte_raw_cksum(iph, mbuf->l3_len);
+		iph->hdr_checksum = (cksum == 0xffff) ? cksum : ~cksum;
+	} else if (ol_flags & PKT_TX_TCP_SEG) {
+		struct rte_ipv6_hdr *iph = l3_hdr;
+
+		iph->payload_len = rte_cpu_to_be_16(l3_plen -
+				sizeof(struct rte_ipv6_hdr));
+	}
+
+	if ((ol_flags & PKT_TX_L4_MASK) == PKT_TX_UDP_CKSUM)
+		csum_offset = offsetof(struct rte_udp_hdr, dgram_cksum);
+	else if ((ol_flags & PKT_TX_L4_MASK) == PKT_TX_TCP_CKSUM)
+		csum_offset = offsetof(struct rte_tcp_hdr, cksum);
+	else
+		return;
+
+	/* pseudo header including the L4 length */
+	l4_cksum = (uint16_t *)(packet + mbuf->l2_len + mbuf->l3_len +
+			csum_offset);
+	if (ol_flags & PKT_TX_IPV4)
+		*l4_cksum = rte_ipv4_phdr_cksum(l3_hdr, 0);
+	else
+		*l4_cksum = rte_ipv6_phdr_cksum(l3_hdr, 0);
+
+	vnet->flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+	vnet->csum_start = mbuf->l2_len + mbuf->l3_len;
+	vnet->csum_offset = csum_offset;
+	if (ol_flags & PKT_TX_TCP_SEG) {
+		vnet->gso_type = (ol_flags & PKT_TX_IPV4) ?
+			VIRTIO_NET_HDR_GSO_TCPV4 : VIRTIO_NET_HDR_GSO_TCPV6;
+		vnet->gso_size = mbuf->tso_segsz;
+		vnet->hdr_len = mbuf->l2_len + mbuf->l3_len + mbuf->l4_len;
+	}
+}
+
 static inline void
 tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			struct rte_mbuf **pmbufs,
@@ -535,7 +654,7 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 	for (i = 0; i < num_mbufs; i++) {
 		struct rte_mbuf *mbuf = pmbufs[i];
 		struct iovec iovecs[mbuf->nb_segs + 2];
-		struct tun_pi pi = { .flags = 0, .proto = 0x00 };
+		struct tap_pkt_hdr hdr;
 		struct rte_mbuf *seg = mbuf;
 		char m_copy[mbuf->data_len];
 		int proto;
@@ -549,6 +668,7 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 		uint16_t l4_phdr_cksum = 0; /* TCP/UDP pseudo header checksum */
 		uint16_t is_cksum = 0; /* in case cksum should be offloaded */
 
+		memset(&hdr, 0, sizeof(hdr));
 		l4_cksum = NULL;
 		if (txq->type == ETH_TUNTAP_TYPE_TUN) {
 			/*
@@ -563,7 +683,7 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			 */
 			char *buff_data = rte_pktmbuf_mtod(seg, void *);
 			proto = (*buff_data & 0xf0);
-			pi.proto = (proto == 0x40) ?
+			hdr.pi.proto = (proto == 0x40) ?
 				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) :
 				((proto == 0x60) ?
 					rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) :
@@ -571,12 +691,13 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 		}
 
 		k = 0;
-		iovecs[k].iov_base = &pi;
-		iovecs[k].iov_len = sizeof(pi);
+		iovecs[k].iov_base = &hdr;
+		iovecs[k].iov_len = txq->vnet_hdr ? sizeof(hdr) : sizeof(hdr.pi);
 		k++;
 
 		nb_segs = mbuf->nb_segs;
-		if (txq->csum &&
+		if ((txq->csum ||
+		     (txq->vnet_hdr && (mbuf->ol_flags & PKT_TX_TCP_SEG))) &&
 		    ((mbuf->ol_flags & (PKT_TX_IP_CKSUM | PKT_TX_IPV4) ||
 		     (mbuf->ol_flags & PKT_TX_L4_MASK) == PKT_TX_UDP_CKSUM ||
 		     (mbuf->ol_flags & PKT_TX_L4_MASK) == PKT_TX_TCP_CKSUM))) {
@@ -595,10 +716,13 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			 */
 			rte_memcpy(m_copy, rte_pktmbuf_mtod(mbuf, void *),
 					l234_hlen);
-			tap_tx_l3_cksum(m_copy, mbuf->ol_flags,
-				       mbuf->l2_len, mbuf->l3_len, mbuf->l4_len,
-				       &l4_cksum, &l4_phdr_cksum,
-				       &l4_raw_cksum);
+			if (txq->vnet_hdr)
+				tap_tx_vnet_hdr(m_copy, mbuf, &hdr.vnet);
+			else
+				tap_tx_l3_cksum(m_copy, mbuf->ol_flags,
+					mbuf->l2_len, mbuf->l3_len,
+					mbuf->l4_len, &l4_cksum,
+					&l4_phdr_cksum, &l4_raw_cksum);
 			iovecs[k].iov_base = m_copy;
 			iovecs[k].iov_len = l234_hlen;
 			k++;
@@ -668,7 +792,16 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		uint64_t tso;
 
 		tso = mbuf_in->ol_flags & PKT_TX_TCP_SEG;
-		if (tso) {
+		if (tso && txq->vnet_hdr) {
+			/* The kernel segments the packet, in one write */
+			mbuf_in->ol_flags |= PKT_TX_TCP_CKSUM;
+			if (unlikely(mbuf_in->tso_segsz == 0))
+				break;
+
+			ret = 0;
+			mbuf = &mbuf_in;
+			num_mbufs = 1;
+		} else if (tso) {
 			struct rte_gso_ctx *gso_ctx = &txq->gso_ctx;
 
 			assert(gso_ctx != NULL);
@@ -873,6 +1006,25 @@ tap_dev_configure(struct rte_eth_dev *dev)
 		return -1;
 	}
 
+	if (pmd->vnet_hdr) {
+		uint64_t rx_offloads = dev->data->dev_conf.rxmode.offloads;
+
+		/* Offloads the kernel may leave to us on receive */
+		pmd->tun_offloads = 0;
+		if (rx_offloads & (DEV_RX_OFFLOAD_UDP_CKSUM |
+				   DEV_RX_OFFLOAD_TCP_CKSUM |
+				   DEV_RX_OFFLOAD_TCP_LRO))
+			pmd->tun_offloads |= TUN_F_CSUM;
+		if (rx_offloads & DEV_RX_OFFLOAD_TCP_LRO) {
+			if (!(rx_offloads & DEV_RX_OFFLOAD_SCATTER)) {
+				TAP_LOG(ERR, "%s: LRO requires Rx scatter",
+					dev->device->name);
+				return -EINVAL;
+			}
+			pmd->tun_offloads |= TUN_F_TSO4 | TUN_F_TSO6;
+		}
+	}
+
 	TAP_LOG(INFO, "%s: %s: TX configured queues number: %u",
 		dev->device->name, pmd->name, dev->data->nb_tx_queues);
 
@@ -934,6 +1086,11 @@ tap_dev_info(struct rte_eth_dev *dev, struct rte_eth_dev_info *dev_info)
 	dev_info->tx_queue_offload_capa = tap_tx_offload_get_queue_capa();
 	dev_info->tx_offload_capa = tap_tx_offload_get_port_capa() |
 				    dev_info->tx_queue_offload_capa;
+	if (internals->vnet_hdr) {
+		/* GRO is configured for the whole device */
+		dev_info->rx_offload_capa |= DEV_RX_OFFLOAD_TCP_LRO;
+		dev_info->max_lro_pkt_size = TAP_VNET_MAX_PKT_LEN;
+	}
 	dev_info->hash_key_size = TAP_RSS_HASH_KEY_SIZE;
 	/*
 	 * limitation: TAP supports all of IP, UDP and TCP hash
@@ -1370,6 +1527,13 @@ tap_setup_queue(struct rte_eth_dev *dev,
 			pmd->name, dir, qid, *fd);
 	}
 
+	if (pmd->vnet_hdr &&
+	    ioctl(*fd, TUNSETOFFLOAD, pmd->tun_offloads) < 0) {
+		TAP_LOG(ERR, "%s: unable to set offloads 0x%x: %s",
+			pmd->name, pmd->tun_offloads, strerror(errno));
+		return -1;
+	}
+
 	tx->mtu = &dev->data->mtu;
 	rx->rxmode = &dev->data->dev_conf.rxmode;
 	if (gso_ctx) {
@@ -1422,6 +1586,7 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 	rxq->in_port = dev->data->port_id;
 	rxq->queue_id = rx_queue_id;
 	rxq->nb_rx_desc = nb_desc;
+	rxq->vnet_hdr = internals->vnet_hdr;
 	iovecs = rte_zmalloc_socket(dev->device->name, sizeof(*iovecs), 0,
 				    socket_id);
 	if (!iovecs) {
@@ -1439,8 +1604,9 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		goto error;
 	}
 
-	(*rxq->iovecs)[0].iov_len = sizeof(struct tun_pi);
-	(*rxq->iovecs)[0].iov_base = &rxq->pi;
+	(*rxq->iovecs)[0].iov_len = rxq->vnet_hdr ?
+		sizeof(rxq->hdr) : sizeof(rxq->hdr.pi);
+	(*rxq->iovecs)[0].iov_base = &rxq->hdr;
 
 	for (i = 1; i <= nb_desc; i++) {
 		*tmp = rte_pktmbuf_alloc(rxq->mp);
@@ -1491,6 +1657,7 @@ tap_tx_queue_setup(struct rte_eth_dev *dev,
 	txq = dev->data->tx_queues[tx_queue_id];
 	txq->out_port = dev->data->port_id;
 	txq->queue_id = tx_queue_id;
+	txq->vnet_hdr = internals->vnet_hdr;
 
 	offloads = tx_conf->offloads | dev->data->dev_conf.txmode.offloads;
 	txq->csum = !!(offloads &
@@ -1751,7 +1918,7 @@ static const char *tuntap_types[ETH_TUNTAP_TYPE_MAX] = {
 static int
 eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 		   char *remote_iface, struct rte_ether_addr *mac_addr,
-		   enum rte_tuntap_type type)
+		   enum rte_tuntap_type type, int vnet_hdr)
 {
 	int numa_node = rte_socket_id();
 	struct rte_eth_dev *dev;
@@ -1784,6 +1951,7 @@ eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 	pmd->dev = dev;
 	strlcpy(pmd->name, tap_name, sizeof(pmd->name));
 	pmd->type = type;
+	pmd->vnet_hdr = vnet_hdr;
 
 	pmd->ioctl_sock = socket(AF_INET, SOCK_DGRAM, 0);
 	if (pmd->ioctl_sock == -1) {
@@ -2081,6 +2249,25 @@ set_mac_type(const char *key __rte_unused,
 	return -1;
 }
 
+static int
+set_vnet_hdr(const char *key __rte_unused,
+	     const char *value,
+	     void *extra_args)
+{
+	int *vnet_hdr = extra_args;
+
+	if (!value)
+		return 0;
+
+	if (strcmp(value, "0") && strcmp(value, "1")) {
+		TAP_LOG(ERR, "TAP vnet_hdr (%s) must be 0 or 1", value);
+		return -1;
+	}
+	*vnet_hdr = value[0] == '1';
+
+	return 0;
+}
+
 /*
  * Open a TUN interface device. TUN PMD
  * 1) sets tap_type as false
@@ -2138,7 +2325,7 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 	TAP_LOG(DEBUG, "Initializing pmd_tun for %s", name);
 
 	ret = eth_dev_tap_create(dev, tun_name, remote_iface, 0,
-				 ETH_TUNTAP_TYPE_TUN);
+				 ETH_TUNTAP_TYPE_TUN, 0);
 
 leave:
 	if (ret == -1) {
@@ -2271,6 +2458,7 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	struct rte_ether_addr user_mac = { .addr_bytes = {0} };
 	struct rte_eth_dev *eth_dev;
 	int tap_devices_count_increased = 0;
+	int vnet_hdr = 0;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -2344,6 +2532,16 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 				if (ret == -1)
 					goto leave;
 			}
+
+			if (rte_kvargs_count(kvlist,
+					     ETH_TAP_VNET_HDR_ARG) == 1) {
+				ret = rte_kvargs_process(kvlist,
+							 ETH_TAP_VNET_HDR_ARG,
+							 &set_vnet_hdr,
+							 &vnet_hdr);
+				if (ret == -1)
+					goto leave;
+			}
 		}
 	}
 	pmd_link.link_speed = speed;
@@ -2362,7 +2560,7 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	tap_devices_count++;
 	tap_devices_count_increased = 1;
 	ret = eth_dev_tap_create(dev, tap_name, remote_iface, &user_mac,
-		ETH_TUNTAP_TYPE_TAP);
+		ETH_TUNTAP_TYPE_TAP, vnet_hdr);
 
 leave:
 	if (ret == -1) {
@@ -2454,7 +2652,8 @@ RTE_PMD_REGISTER_PARAM_STRING(net_tun,
 RTE_PMD_REGISTER_PARAM_STRING(net_tap,
 			      ETH_TAP_IFACE_ARG "=<string> "
 			      ETH_TAP_MAC_ARG "=" ETH_TAP_MAC_ARG_FMT " "
-			      ETH_TAP_REMOTE_ARG "=<string>");
+			      ETH_TAP_REMOTE_ARG "=<string> "
+			      ETH_TAP_VNET_HDR_ARG "=<0|1>");
 int tap_logtype;
 
 RTE_INIT(tap_init_log)
@@ -12,6 +12,7 @@
 #include <net/if.h>
 
 #include <linux/if_tun.h>
+#include <linux/virtio_net.h>
 
 #include <rte_ethdev_driver.h>
 #include <rte_ether.h>
@@ -32,6 +33,15 @@ enum rte_tuntap_type {
 	ETH_TUNTAP_TYPE_MAX,
 };
 
+/*
+ * Header preceding each packet on the TUN/TAP file descriptors,
+ * both parts are 16-bit aligned so there is no padding in between.
+ */
+struct tap_pkt_hdr {
+	struct tun_pi pi;               /* packet info */
+	struct virtio_net_hdr vnet;     /* offloads, only with vnet_hdr */
+};
+
 struct pkt_stats {
 	uint64_t opackets;              /* Number of output packets */
 	uint64_t ipackets;              /* Number of input packets */
@@ -52,13 +62,15 @@ struct rx_queue {
 	struct rte_eth_rxmode *rxmode;  /* RX features */
 	struct rte_mbuf *pool;          /* mbufs pool for this queue */
 	struct iovec (*iovecs)[];       /* descriptors for this queue */
-	struct tun_pi pi;               /* packet info for iovecs */
+	struct tap_pkt_hdr hdr;         /* packet header for iovecs */
+	int vnet_hdr;                   /* 1 if packets have a vnet header */
 };
 
 struct tx_queue {
 	int type;                       /* Type field - TUN|TAP */
 	uint16_t *mtu;                  /* Pointer to MTU from dev_data */
 	uint16_t csum:1;                /* Enable checksum offloading */
+	uint16_t vnet_hdr:1;            /* Offloads done by the kernel */
 	struct pkt_stats stats;         /* Stats for this TX queue */
 	struct rte_gso_ctx gso_ctx;     /* GSO context */
 	uint16_t out_port;              /* Port ID */
@@ -80,6 +92,8 @@ struct pmd_internals {
 	int flower_support;               /* 1 if kernel supports, else 0 */
 	int flower_vlan_support;          /* 1 if kernel supports, else 0 */
 	int rss_enabled;                  /* 1 if RSS is enabled, else 0 */
+	int vnet_hdr;                     /* 1 if virtio-net header is used */
+	unsigned int tun_offloads;        /* TUN_F_* flags for the kernel */
 	/* implicit rules set when RSS is enabled */
 	int map_fd;                       /* BPF RSS map fd */
 	int bpf_fd[RTE_PMD_TAP_MAX_QUEUES];/* List of bpf fds per queue */
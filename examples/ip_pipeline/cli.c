@@ -14,6 +14,7 @@
 #include "cli.h"
 
 #include "cryptodev.h"
+#include "eventdev.h"
 #include "kni.h"
 #include "link.h"
 #include "mempool.h"
@@ -877,6 +878,87 @@ cmd_cryptodev(char **tokens,
 	}
 }
 
+static const char cmd_eventdev_help[] =
+"eventdev <eventdev_name>\n"
+"   dev <device_name> | dev_id <device_id>\n"
+"   queues <n_queues> ports <n_ports>\n"
+"   [events <n_events>]\n";
+
+static void
+cmd_eventdev(char **tokens,
+	uint32_t n_tokens,
+	char *out,
+	size_t out_size)
+{
+	struct eventdev_params params;
+	char *name;
+
+	memset(&params, 0, sizeof(params));
+	if ((n_tokens != 8) && (n_tokens != 10)) {
+		snprintf(out, out_size, MSG_ARG_MISMATCH, tokens[0]);
+		return;
+	}
+
+	name = tokens[1];
+
+	if (strcmp(tokens[2], "dev") == 0)
+		params.dev_name = tokens[3];
+	else if (strcmp(tokens[2], "dev_id") == 0) {
+		if (parser_read_uint32(&params.dev_id, tokens[3]) < 0) {
+			snprintf(out, out_size,	MSG_ARG_INVALID,
+				"dev_id");
+			return;
+		}
+	} else {
+		snprintf(out, out_size,	MSG_ARG_INVALID,
+			"eventdev");
+		return;
+	}
+
+	if (strcmp(tokens[4], "queues")) {
+		snprintf(out, out_size,	MSG_ARG_NOT_FOUND,
+			"queues");
+		return;
+	}
+
+	if (parser_read_uint32(&params.n_queues, tokens[5]) < 0) {
+		snprintf(out, out_size,	MSG_ARG_INVALID,
+			"n_queues");
+		return;
+	}
+
+	if (strcmp(tokens[6], "ports")) {
+		snprintf(out, out_size,	MSG_ARG_NOT_FOUND,
+			"ports");
+		return;
+	}
+
+	if (parser_read_uint32(&params.n_ports, tokens[7]) < 0) {
+		snprintf(out, out_size,	MSG_ARG_INVALID,
+			"n_ports");
+		return;
+	}
+
+	if (n_tokens == 10) {
+		if (strcmp(tokens[8], "events")) {
+			snprintf(out, out_size,	MSG_ARG_NOT_FOUND,
+				"events");
+			return;
+		}
+
+		if (parser_read_uint32(&params.n_events, tokens[9]) < 0) {
+			snprintf(out, out_size,	MSG_ARG_INVALID,
+				"n_events");
+			return;
+		}
+	}
+
+	if (eventdev_create(name, &params) == NULL) {
+		snprintf(out, out_size, MSG_CMD_FAIL, tokens[0]);
+		return;
+	}
+}
+
 static const char cmd_port_in_action_profile_help[] =
 "port in action profile <profile_name>\n"
 "   [filter match | mismatch offset <key_offset> mask <key_mask> key <key_value> port <port_id>]\n"
@@ -1560,6 +1642,7 @@ static const char cmd_pipeline_port_in_help[] =
 "   | kni <kni_name>\n"
 "   | source mempool <mempool_name> file <file_name> bpp <n_bytes_per_pkt>\n"
 "   | cryptodev <cryptodev_name> rxq <queue_id>\n"
+"   | eventdev <eventdev_name> port <port_id> queue <queue_id>\n"
 "   [action <port_in_action_profile_name>]\n"
 "   [disabled]\n";
 
@@ -1752,6 +1835,40 @@ cmd_pipeline_port_in(char **tokens,
 		p.cryptodev.f_callback = NULL;
 
 		t0 += 4;
+	} else if (strcmp(tokens[t0], "eventdev") == 0) {
+		if (n_tokens < t0 + 6) {
+			snprintf(out, out_size, MSG_ARG_MISMATCH,
+				"pipeline port in eventdev");
+			return;
+		}
+
+		p.type = PORT_IN_EVENTDEV;
+
+		p.dev_name = tokens[t0 + 1];
+
+		if (strcmp(tokens[t0 + 2], "port") != 0) {
+			snprintf(out, out_size, MSG_ARG_NOT_FOUND, "port");
+			return;
+		}
+
+		if (parser_read_uint16(&p.eventdev.port_id,
+			tokens[t0 + 3]) != 0) {
+			snprintf(out, out_size, MSG_ARG_INVALID, "port_id");
+			return;
+		}
+
+		if (strcmp(tokens[t0 + 4], "queue") != 0) {
+			snprintf(out, out_size, MSG_ARG_NOT_FOUND, "queue");
+			return;
+		}
+
+		if (parser_read_uint16(&p.eventdev.queue_id,
+			tokens[t0 + 5]) != 0) {
+			snprintf(out, out_size, MSG_ARG_INVALID, "queue_id");
+			return;
+		}
+
+		t0 += 6;
 	} else {
 		snprintf(out, out_size, MSG_ARG_INVALID, tokens[0]);
 		return;
@@ -1799,7 +1916,8 @@ static const char cmd_pipeline_port_out_help[] =
 "   | tap <tap_name>\n"
 "   | kni <kni_name>\n"
 "   | sink [file <file_name> pkts <max_n_pkts>]\n"
-"   | cryptodev <cryptodev_name> txq <txq_id> offset <crypto_op_offset>\n";
+"   | cryptodev <cryptodev_name> txq <txq_id> offset <crypto_op_offset>\n"
+"   | eventdev <eventdev_name> port <port_id> queue <queue_id>\n";
 
 static void
 cmd_pipeline_port_out(char **tokens,
@@ -1968,6 +2086,37 @@ cmd_pipeline_port_out(char **tokens,
 			snprintf(out, out_size, MSG_ARG_INVALID, "queue_id");
 			return;
 		}
+	} else if (strcmp(tokens[6], "eventdev") == 0) {
+		if (n_tokens != 12) {
+			snprintf(out, out_size, MSG_ARG_MISMATCH,
+				"pipeline port out eventdev");
+			return;
+		}
+
+		p.type = PORT_OUT_EVENTDEV;
+
+		p.dev_name = tokens[7];
+
+		if (strcmp(tokens[8], "port") != 0) {
+			snprintf(out, out_size, MSG_ARG_NOT_FOUND, "port");
+			return;
+		}
+
+		if (parser_read_uint16(&p.eventdev.port_id, tokens[9]) != 0) {
+			snprintf(out, out_size, MSG_ARG_INVALID, "port_id");
+			return;
+		}
+
+		if (strcmp(tokens[10], "queue") != 0) {
+			snprintf(out, out_size, MSG_ARG_NOT_FOUND, "queue");
+			return;
+		}
+
+		if (parser_read_uint16(&p.eventdev.queue_id, tokens[11])
+				!= 0) {
+			snprintf(out, out_size, MSG_ARG_INVALID, "queue_id");
+			return;
+		}
 	} else {
 		snprintf(out, out_size, MSG_ARG_INVALID, tokens[0]);
 		return;
@@ -6062,6 +6211,7 @@ cmd_help(char **tokens, uint32_t n_tokens, char *out, size_t out_size)
 			"\ttmgr subport pipe\n"
 			"\ttap\n"
 			"\tkni\n"
+			"\teventdev\n"
 			"\tport in action profile\n"
 			"\ttable action profile\n"
 			"\tpipeline\n"
@@ -6157,6 +6307,11 @@ cmd_help(char **tokens, uint32_t n_tokens, char *out, size_t out_size)
 		return;
 	}
 
+	if (strcmp(tokens[0], "eventdev") == 0) {
+		snprintf(out, out_size, "\n%s\n", cmd_eventdev_help);
+		return;
+	}
+
 	if ((n_tokens == 4) &&
 		(strcmp(tokens[0], "port") == 0) &&
 		(strcmp(tokens[1], "in") == 0) &&
@@ -6469,6 +6624,11 @@ cli_process(char *in, char *out, size_t out_size)
 		return;
 	}
 
+	if (strcmp(tokens[0], "eventdev") == 0) {
+		cmd_eventdev(tokens, n_tokens, out, out_size);
+		return;
+	}
+
 	if (strcmp(tokens[0], "port") == 0) {
 		cmd_port_in_action_profile(tokens, n_tokens, out, out_size);
 		return;
@@ -0,0 +1,224 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_eventdev.h>
+#include <rte_lcore.h>
+#include <rte_service.h>
+#include <rte_string_fns.h>
+
+#include "eventdev.h"
+
+static struct eventdev_list eventdev_list;
+
+int
+eventdev_init(void)
+{
+	TAILQ_INIT(&eventdev_list);
+
+	return 0;
+}
+
+struct eventdev *
+eventdev_find(const char *name)
+{
+	struct eventdev *eventdev;
+
+	if (name == NULL)
+		return NULL;
+
+	TAILQ_FOREACH(eventdev, &eventdev_list, node)
+		if (strcmp(eventdev->name, name) == 0)
+			return eventdev;
+
+	return NULL;
+}
+
+struct eventdev *
+eventdev_next(struct eventdev *eventdev)
+{
+	return (eventdev == NULL) ?
+			TAILQ_FIRST(&eventdev_list) :
+			TAILQ_NEXT(eventdev, node);
+}
+
+struct eventdev *
+eventdev_create(const char *name, struct eventdev_params *params)
+{
+	struct rte_event_dev_info dev_info;
+	struct rte_event_dev_config dev_conf;
+	struct rte_event_queue_conf queue_conf;
+	struct rte_event_port_conf port_conf;
+	struct eventdev *eventdev;
+	uint32_t dev_id, i;
+	int status;
+
+	/* Check input params */
+	if ((name == NULL) ||
+		eventdev_find(name) ||
+		(params->n_queues == 0) ||
+		(params->n_ports == 0))
+		return NULL;
+
+	if (params->dev_name) {
+		status = rte_event_dev_get_dev_id(params->dev_name);
+		if (status < 0)
+			return NULL;
+
+		dev_id = (uint32_t)status;
+	} else {
+		if (params->dev_id >= rte_event_dev_count())
+			return NULL;
+
+		dev_id = params->dev_id;
+	}
+
+	status = rte_event_dev_info_get(dev_id, &dev_info);
+	if (status < 0)
+		return NULL;
+
+	if ((params->n_queues > dev_info.max_event_queues) ||
+		(params->n_ports > dev_info.max_event_ports) ||
+		(params->n_events > (uint32_t)dev_info.max_num_events))
+		return NULL;
+
+	/* Resource create */
+	memset(&dev_conf, 0, sizeof(dev_conf));
+	dev_conf.dequeue_timeout_ns = dev_info.min_dequeue_timeout_ns;
+	dev_conf.nb_events_limit = params->n_events ?
+		(int32_t)params->n_events : dev_info.max_num_events;
+	dev_conf.nb_event_queues = params->n_queues;
+	dev_conf.nb_event_ports = params->n_ports;
+	dev_conf.nb_event_queue_flows = dev_info.max_event_queue_flows;
+	dev_conf.nb_event_port_dequeue_depth =
+		dev_info.max_event_port_dequeue_depth;
+	dev_conf.nb_event_port_enqueue_depth =
+		dev_info.max_event_port_enqueue_depth;
+
+	status = rte_event_dev_configure(dev_id, &dev_conf);
+	if (status < 0)
+		return NULL;
+
+	/* All queues are atomic: any port linked to a queue may process
+	 * any flow, but a flow is only processed by one port at a time.
+	 */
+	for (i = 0; i < params->n_queues; i++) {
+		status = rte_event_queue_default_conf_get(dev_id, i,
+			&queue_conf);
+		if (status < 0)
+			return NULL;
+
+		queue_conf.event_queue_cfg = 0;
+		queue_conf.schedule_type = RTE_SCHED_TYPE_ATOMIC;
+
+		status = rte_event_queue_setup(dev_id, i, &queue_conf);
+		if (status < 0)
+			return NULL;
+	}
+
+	for (i = 0; i < params->n_ports; i++) {
+		status = rte_event_port_default_conf_get(dev_id, i,
+			&port_conf);
+		if (status < 0)
+			return NULL;
+
+		status = rte_event_port_setup(dev_id, i, &port_conf);
+		if (status < 0)
+			return NULL;
+	}
+
+	/* Node allocation */
+	eventdev = calloc(1, sizeof(struct eventdev));
+	if (eventdev == NULL)
+		return NULL;
+
+	/* Node fill in */
+	strlcpy(eventdev->name, name, sizeof(eventdev->name));
+	eventdev->dev_id = dev_id;
+	eventdev->n_queues = params->n_queues;
+	eventdev->n_ports = params->n_ports;
+	eventdev->started = 0;
+
+	/* Node add to list */
+	TAILQ_INSERT_TAIL(&eventdev_list, eventdev, node);
+
+	return eventdev;
+}
+
+int
+eventdev_port_link(struct eventdev *eventdev,
+	uint32_t port_id,
+	uint32_t queue_id)
+{
+	uint8_t queue = queue_id;
+
+	/* Check input params */
+	if ((eventdev == NULL) ||
+		(port_id >= eventdev->n_ports) ||
+		(queue_id >= eventdev->n_queues))
+		return -1;
+
+	if (rte_event_port_link(eventdev->dev_id, port_id,
+		&queue, NULL, 1) != 1)
+		return -1;
+
+	return 0;
+}
+
+/* Devices without a distributed scheduler need a service core to run
+ * their scheduler on.
+ */
+static int
+eventdev_service_start(struct eventdev *eventdev)
+{
+	uint32_t lcores[RTE_MAX_LCORE];
+	uint32_t service_id;
+	int n_lcores, status;
+
+	if (rte_event_dev_service_id_get(eventdev->dev_id, &service_id) != 0)
+		return 0;
+
+	n_lcores = rte_service_lcore_list(lcores, RTE_DIM(lcores));
+	if (n_lcores <= 0)
+		return -1;
+
+	status = rte_service_runstate_set(service_id, 1);
+	if (status)
+		return -1;
+
+	status = rte_service_map_lcore_set(service_id, lcores[0], 1);
+	if (status)
+		return -1;
+
+	status = rte_service_lcore_start(lcores[0]);
+	if (status && (status != -EALREADY))
+		return -1;
+
+	return 0;
+}
+
+int
+eventdev_start(struct eventdev *eventdev)
+{
+	/* Check input params */
+	if (eventdev == NULL)
+		return -1;
+
+	if (eventdev->started)
+		return 0;
+
+	if (eventdev_service_start(eventdev))
+		return -1;
+
+	if (rte_event_dev_start(eventdev->dev_id) < 0)
+		return -1;
+
+	eventdev->started = 1;
+
+	return 0;
+}
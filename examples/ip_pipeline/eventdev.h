@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _INCLUDE_EVENTDEV_H_
+#define _INCLUDE_EVENTDEV_H_
+
+#include <stdint.h>
+#include <sys/queue.h>
+
+#include <rte_eventdev.h>
+
+#include "common.h"
+
+struct eventdev {
+	TAILQ_ENTRY(eventdev) node;
+	char name[NAME_SIZE];
+	uint8_t dev_id;
+	uint32_t n_queues;
+	uint32_t n_ports;
+	int started;
+};
+
+TAILQ_HEAD(eventdev_list, eventdev);
+
+int
+eventdev_init(void);
+
+struct eventdev *
+eventdev_find(const char *name);
+
+struct eventdev *
+eventdev_next(struct eventdev *eventdev);
+
+struct eventdev_params {
+	const char *dev_name;
+	uint32_t dev_id; /**< Valid only when *dev_name* is NULL. */
+	uint32_t n_queues;
+	uint32_t n_ports;
+	uint32_t n_events; /**< 0 for the device maximum. */
+};
+
+struct eventdev *
+eventdev_create(const char *name, struct eventdev_params *params);
+
+int
+eventdev_port_link(struct eventdev *eventdev,
+	uint32_t port_id,
+	uint32_t queue_id);
+
+int
+eventdev_start(struct eventdev *eventdev);
+
+#endif /* _INCLUDE_EVENTDEV_H_ */
@@ -15,6 +15,7 @@
 #include "conn.h"
 #include "kni.h"
 #include "cryptodev.h"
+#include "eventdev.h"
 #include "link.h"
 #include "mempool.h"
 #include "pipeline.h"
@@ -219,6 +220,14 @@ main(int argc, char **argv)
 		return status;
 	}
 
+	/* Eventdev */
+	status = eventdev_init();
+	if (status) {
+		printf("Error: Eventdev initialization failed (%d)\n",
+				status);
+		return status;
+	}
+
 	/* Action */
 	status = port_in_action_profile_init();
 	if (status) {
@@ -19,6 +19,7 @@
 #include <rte_port_fd.h>
 #include <rte_port_sched.h>
 #include <rte_port_sym_crypto.h>
+#include <rte_port_eventdev.h>
 
 #include <rte_table_acl.h>
 #include <rte_table_array.h>
@@ -38,6 +39,7 @@
 #include "tmgr.h"
 #include "swq.h"
 #include "cryptodev.h"
+#include "eventdev.h"
 
 #ifndef PIPELINE_MSGQ_SIZE
 #define PIPELINE_MSGQ_SIZE                                 64
@@ -148,6 +150,24 @@ pipeline_create(const char *name, struct pipeline_params *params)
 	return pipeline;
 }
 
+static int
+pipeline_port_in_eventdev_find(struct pipeline *pipeline,
+	struct eventdev *eventdev,
+	uint16_t port_id)
+{
+	uint32_t i;
+
+	for (i = 0; i < pipeline->n_ports_in; i++) {
+		struct port_in *port_in = &pipeline->port_in[i];
+
+		if ((port_in->eventdev == eventdev) &&
+			(port_in->params.eventdev.port_id == port_id))
+			return 1;
+	}
+
+	return 0;
+}
+
 int
 pipeline_port_in_create(const char *pipeline_name,
 	struct port_in_params *params,
@@ -165,12 +185,14 @@ pipeline_port_in_create(const char *pipeline_name,
 #endif
 		struct rte_port_source_params source;
 		struct rte_port_sym_crypto_reader_params sym_crypto;
+		struct rte_port_eventdev_reader_params eventdev;
 	} pp;
 
 	struct pipeline *pipeline;
 	struct port_in *port_in;
 	struct port_in_action_profile *ap;
 	struct rte_port_in_action *action;
+	struct eventdev *eventdev = NULL;
 	uint32_t port_id;
 	int status;
 
@@ -319,6 +341,24 @@ pipeline_port_in_create(const char *pipeline_name,
 		break;
 	}
 
+	case PORT_IN_EVENTDEV:
+	{
+		eventdev = eventdev_find(params->dev_name);
+		if (eventdev == NULL)
+			return -1;
+
+		if (eventdev_port_link(eventdev, params->eventdev.port_id,
+			params->eventdev.queue_id))
+			return -1;
+
+		pp.eventdev.eventdev_id = eventdev->dev_id;
+		pp.eventdev.port_id = params->eventdev.port_id;
+
+		p.ops = &rte_port_eventdev_reader_ops;
+		p.arg_create = &pp.eventdev;
+		break;
+	}
+
 	default:
 		return -1;
 	}
@@ -361,8 +401,12 @@ pipeline_port_in_create(const char *pipeline_name,
 	memcpy(&port_in->params, params, sizeof(*params));
 	port_in->ap = ap;
 	port_in->a = action;
+	port_in->eventdev = eventdev;
 	pipeline->n_ports_in++;
 
+	if (eventdev)
+		pipeline->eventdev_in = 1;
+
 	return 0;
 }
 
@@ -409,6 +453,7 @@ pipeline_port_out_create(const char *pipeline_name,
 #endif
 		struct rte_port_sink_params sink;
 		struct rte_port_sym_crypto_writer_params sym_crypto;
+		struct rte_port_eventdev_writer_flow_params eventdev;
 	} pp;
 
 	union {
@@ -419,8 +464,10 @@ pipeline_port_out_create(const char *pipeline_name,
 		struct rte_port_kni_writer_nodrop_params kni;
 #endif
 		struct rte_port_sym_crypto_writer_nodrop_params sym_crypto;
+		struct rte_port_eventdev_writer_nodrop_flow_params eventdev;
 	} pp_nodrop;
 
+	struct eventdev *eventdev = NULL;
 	struct pipeline *pipeline;
 	uint32_t port_id;
 	int status;
@@ -608,6 +655,54 @@ pipeline_port_out_create(const char *pipeline_name,
 		break;
 	}
 
+	case PORT_OUT_EVENTDEV:
+	{
+		uint8_t evt_op;
+
+		eventdev = eventdev_find(params->dev_name);
+		if (eventdev == NULL)
+			return -1;
+
+		if ((params->eventdev.port_id >= eventdev->n_ports) ||
+			(params->eventdev.queue_id >= eventdev->n_queues))
+			return -1;
+
+		/* Events must be forwarded on the port they were dequeued
+		 * from, anything else injects new events.
+		 */
+		evt_op = pipeline_port_in_eventdev_find(pipeline,
+			eventdev, params->eventdev.port_id) ?
+			RTE_EVENT_OP_FORWARD : RTE_EVENT_OP_NEW;
+
+		pp.eventdev.writer.eventdev_id = eventdev->dev_id;
+		pp.eventdev.writer.port_id = params->eventdev.port_id;
+		pp.eventdev.writer.queue_id = params->eventdev.queue_id;
+		pp.eventdev.writer.enq_burst_sz = params->burst_size;
+		pp.eventdev.writer.sched_type = RTE_SCHED_TYPE_ATOMIC;
+		pp.eventdev.writer.evt_op = evt_op;
+		pp.eventdev.flow_id_from_rss = 1;
+		pp.eventdev.flow_id = 0;
+
+		pp_nodrop.eventdev.writer.eventdev_id = eventdev->dev_id;
+		pp_nodrop.eventdev.writer.port_id = params->eventdev.port_id;
+		pp_nodrop.eventdev.writer.queue_id = params->eventdev.queue_id;
+		pp_nodrop.eventdev.writer.enq_burst_sz = params->burst_size;
+		pp_nodrop.eventdev.writer.sched_type = RTE_SCHED_TYPE_ATOMIC;
+		pp_nodrop.eventdev.writer.evt_op = evt_op;
+		pp_nodrop.eventdev.writer.n_retries = params->n_retries;
+		pp_nodrop.eventdev.flow_id_from_rss = 1;
+		pp_nodrop.eventdev.flow_id = 0;
+
+		if (params->retry == 0) {
+			p.ops = &rte_port_eventdev_writer_flow_ops;
+			p.arg_create = &pp.eventdev;
+		} else {
+			p.ops = &rte_port_eventdev_writer_nodrop_flow_ops;
+			p.arg_create = &pp_nodrop.eventdev;
+		}
+		break;
+	}
+
 	default:
 		return -1;
 	}
@@ -624,6 +719,7 @@ pipeline_port_out_create(const char *pipeline_name,
 		return -1;
 
 	/* Pipeline */
+	pipeline->eventdev_out[pipeline->n_ports_out] = eventdev;
 	pipeline->n_ports_out++;
 
 	return 0;
@@ -28,6 +28,7 @@ enum port_in_type {
 	PORT_IN_KNI,
 	PORT_IN_SOURCE,
 	PORT_IN_CRYPTODEV,
+	PORT_IN_EVENTDEV,
 };
 
 struct port_in_params {
@@ -55,6 +56,11 @@ struct port_in_params {
 			void *f_callback;
 			void *arg_callback;
 		} cryptodev;
+
+		struct {
+			uint16_t port_id;
+			uint16_t queue_id;
+		} eventdev;
 	};
 	uint32_t burst_size;
 
@@ -70,6 +76,7 @@ enum port_out_type {
 	PORT_OUT_KNI,
 	PORT_OUT_SINK,
 	PORT_OUT_CRYPTODEV,
+	PORT_OUT_EVENTDEV,
 };
 
 struct port_out_params {
@@ -89,6 +96,11 @@ struct port_out_params {
 			uint16_t queue_id;
 			uint32_t op_offset;
 		} cryptodev;
+
+		struct {
+			uint16_t port_id;
+			uint16_t queue_id;
+		} eventdev;
 	};
 	uint32_t burst_size;
 	int retry;
@@ -147,10 +159,13 @@ struct table_rule;
 
 TAILQ_HEAD(table_rule_list, table_rule);
 
+struct eventdev;
+
 struct port_in {
 	struct port_in_params params;
 	struct port_in_action_profile *ap;
 	struct rte_port_in_action *a;
+	struct eventdev *eventdev; /* PORT_IN_EVENTDEV only */
 };
 
 struct table {
@@ -168,10 +183,17 @@ struct pipeline {
 	struct rte_pipeline *p;
 	struct port_in port_in[RTE_PIPELINE_PORT_IN_MAX];
 	struct table table[RTE_PIPELINE_TABLE_MAX];
+	struct eventdev *eventdev_out[RTE_PIPELINE_PORT_OUT_MAX];
 	uint32_t n_ports_in;
 	uint32_t n_ports_out;
 	uint32_t n_tables;
 
+	/* Output ports are flushed after every run when an input port is
+	 * an eventdev port, so that events are forwarded before their
+	 * atomic context is released by the next dequeue.
+	 */
+	int eventdev_in;
+
 	struct rte_ring *msgq_req;
 	struct rte_ring *msgq_rsp;
 	uint32_t timer_period_ms;
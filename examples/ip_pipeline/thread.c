@@ -16,6 +16,7 @@
 #include <rte_table_lpm_ipv6.h>
 
 #include "common.h"
+#include "eventdev.h"
 #include "thread.h"
 #include "pipeline.h"
 
@@ -65,6 +66,7 @@ struct pipeline_data {
 
 struct thread_data {
 	struct rte_pipeline *p[THREAD_PIPELINES_MAX];
+	int flush_on_run[THREAD_PIPELINES_MAX];
 	uint32_t n_pipelines;
 
 	struct pipeline_data pipeline_data[THREAD_PIPELINES_MAX];
@@ -200,6 +202,7 @@ struct thread_msg_req {
 			struct rte_ring *msgq_rsp;
 			uint32_t timer_period_ms;
 			uint32_t n_tables;
+			int flush_on_run;
 		} pipeline_enable;
 
 		struct {
@@ -277,6 +280,19 @@ thread_pipeline_enable(uint32_t thread_id,
 		p->enabled)
 		return -1;
 
+	/* Event devices start with the first pipeline using them, all links
+	 * to their queues must be in place by then.
+	 */
+	for (i = 0; i < p->n_ports_in; i++)
+		if (p->port_in[i].eventdev &&
+			eventdev_start(p->port_in[i].eventdev))
+			return -1;
+
+	for (i = 0; i < p->n_ports_out; i++)
+		if (p->eventdev_out[i] &&
+			eventdev_start(p->eventdev_out[i]))
+			return -1;
+
 	if (!thread_is_running(thread_id)) {
 		struct thread_data *td = &thread_data[thread_id];
 		struct pipeline_data *tdp = &td->pipeline_data[td->n_pipelines];
@@ -286,6 +302,7 @@ thread_pipeline_enable(uint32_t thread_id,
 
 		/* Data plane thread */
 		td->p[td->n_pipelines] = p->p;
+		td->flush_on_run[td->n_pipelines] = p->eventdev_in;
 
 		tdp->p = p->p;
 		for (i = 0; i < p->n_tables; i++)
@@ -322,6 +339,7 @@ thread_pipeline_enable(uint32_t thread_id,
 	req->pipeline_enable.msgq_rsp = p->msgq_rsp;
 	req->pipeline_enable.timer_period_ms = p->timer_period_ms;
 	req->pipeline_enable.n_tables = p->n_tables;
+	req->pipeline_enable.flush_on_run = p->eventdev_in;
 
 	/* Send request and wait for response */
 	rsp = thread_msg_send_recv(thread_id, req);
@@ -387,6 +405,8 @@ thread_pipeline_disable(uint32_t thread_id,
 					&td->pipeline_data[td->n_pipelines - 1];
 
 				td->p[i] = pipeline_last;
+				td->flush_on_run[i] =
+					td->flush_on_run[td->n_pipelines - 1];
 				memcpy(tdp, tdp_last, sizeof(*tdp));
 			}
 
@@ -472,6 +492,7 @@ thread_msg_handle_pipeline_enable(struct thread_data *t,
 	}
 
 	t->p[t->n_pipelines] = req->pipeline_enable.p;
+	t->flush_on_run[t->n_pipelines] = req->pipeline_enable.flush_on_run;
 
 	p->p = req->pipeline_enable.p;
 	for (i = 0; i < req->pipeline_enable.n_tables; i++)
@@ -516,6 +537,7 @@ thread_msg_handle_pipeline_disable(struct thread_data *t,
 				&t->pipeline_data[n_pipelines - 1];
 
 			t->p[i] = pipeline_last;
+			t->flush_on_run[i] = t->flush_on_run[n_pipelines - 1];
 			memcpy(p, p_last, sizeof(*p));
 		}
 
@@ -3140,9 +3162,13 @@ thread_main(void *arg __rte_unused)
 		uint32_t j;
 
 		/* Data Plane */
-		for (j = 0; j < t->n_pipelines; j++)
+		for (j = 0; j < t->n_pipelines; j++) {
 			rte_pipeline_run(t->p[j]);
 
+			if (t->flush_on_run[j])
+				rte_pipeline_flush(t->p[j]);
+		}
+
 		/* Control Plane */
 		if ((i & 0xF) == 0) {
 			uint64_t time = rte_get_tsc_cycles();
@@ -529,6 +529,10 @@ ipsec_enqueue(ipsec_xform_fn xform_func, struct ipsec_ctx *ipsec_ctx,
 					ips->security.ctx, ips->security.ses,
 					pkts[i], NULL);
 			continue;
+		case RTE_SECURITY_ACTION_TYPE_CPU_CRYPTO:
+			/* not supported by the legacy data-path */
+			rte_pktmbuf_free(pkts[i]);
+			continue;
 		}
 
 		RTE_ASSERT(sa->cdev_id_qp < ipsec_ctx->nb_qps);
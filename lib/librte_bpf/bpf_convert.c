@@ -0,0 +1,396 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+/*
+ * Convert classic BPF (cBPF), as produced by pcap_compile(),
+ * into DPDK eBPF.
+ */
+
+#include <pcap/pcap.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_errno.h>
+
+#include "bpf_impl.h"
+
+/*
+ * cBPF to eBPF register mappings:
+ * A (accumulator) is kept in R0, as BPF_LD | BPF_ABS/BPF_IND
+ * implicitly return fetched packet data in R0,
+ * R6 holds the mbuf pointer (implicit input for packet data loads),
+ * X (index register) is kept in R7, R8 is a scratch register.
+ * cBPF scratch memory M[] is located at the top of the stack.
+ */
+#define REG_A		EBPF_REG_0
+#define REG_MBUF	EBPF_REG_6
+#define REG_X		EBPF_REG_7
+#define REG_TMP		EBPF_REG_8
+#define REG_FP		EBPF_REG_10
+
+/* each M[] word occupies its own 8B stack slot */
+#define MEM_OFF(k)	(-(int16_t)((BPF_MEMWORDS - (k)) * sizeof(uint64_t)))
+
+struct cbpf_conv {
+	const struct bpf_insn *in;  /* cBPF program */
+	uint32_t nb_in;
+	const uint32_t *map;        /* eBPF index for every cBPF instruction */
+	struct ebpf_insn *out;      /* NULL on the sizing pass */
+	uint32_t nb_out;
+};
+
+static void
+emit(struct cbpf_conv *cv, uint8_t code, uint8_t dst, uint8_t src,
+	int16_t off, int32_t imm)
+{
+	struct ebpf_insn *ins;
+
+	if (cv->out != NULL) {
+		ins = cv->out + cv->nb_out;
+		ins->code = code;
+		ins->dst_reg = dst;
+		ins->src_reg = src;
+		ins->off = off;
+		ins->imm = imm;
+	}
+	cv->nb_out++;
+}
+
+/*
+ * jump offset for the instruction about to be emitted,
+ * to the cBPF instruction with index tgt.
+ */
+static int
+jmp_off(const struct cbpf_conv *cv, uint32_t tgt, int16_t *off)
+{
+	int64_t d;
+
+	if (tgt >= cv->nb_in)
+		return -EINVAL;
+
+	/* offsets are not known yet on the sizing pass */
+	if (cv->out == NULL) {
+		*off = 0;
+		return 0;
+	}
+
+	d = (int64_t)cv->map[tgt] - (cv->nb_out + 1);
+	if (d > INT16_MAX)
+		return -E2BIG;
+
+	*off = d;
+	return 0;
+}
+
+static int
+conv_jmp(struct cbpf_conv *cv, uint32_t i, const struct bpf_insn *fp)
+{
+	int rc;
+	int16_t off;
+	uint8_t op, src;
+	uint32_t jt, jf;
+
+	jt = i + 1 + fp->jt;
+	jf = i + 1 + fp->jf;
+	op = BPF_OP(fp->code);
+
+	/* comparison is unsigned, don't let imm to be sign-extended */
+	if (BPF_SRC(fp->code) == BPF_X)
+		src = REG_X;
+	else if ((int32_t)fp->k < 0) {
+		emit(cv, BPF_ALU | EBPF_MOV | BPF_K, REG_TMP, 0, 0, fp->k);
+		src = REG_TMP;
+	} else
+		src = 0;
+
+	/* jump if false only: invert the condition, where possible */
+	if (fp->jt == 0 && fp->jf != 0 && op != BPF_JSET) {
+		if (op == BPF_JEQ)
+			op = EBPF_JNE;
+		else if (op == BPF_JGT)
+			op = EBPF_JLE;
+		else
+			op = EBPF_JLT;
+		jt = jf;
+		jf = i + 1;
+	}
+
+	rc = jmp_off(cv, jt, &off);
+	if (rc != 0)
+		return rc;
+	emit(cv, BPF_JMP | op | (src != 0 ? BPF_X : BPF_K), REG_A, src, off,
+		src != 0 ? 0 : fp->k);
+
+	if (jf != i + 1) {
+		rc = jmp_off(cv, jf, &off);
+		if (rc != 0)
+			return rc;
+		emit(cv, BPF_JMP | BPF_JA, 0, 0, off, 0);
+	}
+
+	return 0;
+}
+
+static int
+conv_insn(struct cbpf_conv *cv, uint32_t i)
+{
+	int16_t off;
+	const struct bpf_insn *fp;
+
+	fp = cv->in + i;
+
+	switch (fp->code) {
+	/* A = A <op> X/k */
+	case BPF_ALU | BPF_ADD | BPF_X:
+	case BPF_ALU | BPF_SUB | BPF_X:
+	case BPF_ALU | BPF_MUL | BPF_X:
+	case BPF_ALU | BPF_DIV | BPF_X:
+	case BPF_ALU | BPF_MOD | BPF_X:
+	case BPF_ALU | BPF_OR | BPF_X:
+	case BPF_ALU | BPF_AND | BPF_X:
+	case BPF_ALU | BPF_XOR | BPF_X:
+	case BPF_ALU | BPF_LSH | BPF_X:
+	case BPF_ALU | BPF_RSH | BPF_X:
+		emit(cv, fp->code, REG_A, REG_X, 0, 0);
+		break;
+	case BPF_ALU | BPF_DIV | BPF_K:
+	case BPF_ALU | BPF_MOD | BPF_K:
+		if (fp->k == 0)
+			return -EINVAL;
+		/* fall through */
+	case BPF_ALU | BPF_ADD | BPF_K:
+	case BPF_ALU | BPF_SUB | BPF_K:
+	case BPF_ALU | BPF_MUL | BPF_K:
+	case BPF_ALU | BPF_OR | BPF_K:
+	case BPF_ALU | BPF_AND | BPF_K:
+	case BPF_ALU | BPF_XOR | BPF_K:
+	case BPF_ALU | BPF_LSH | BPF_K:
+	case BPF_ALU | BPF_RSH | BPF_K:
+		emit(cv, fp->code, REG_A, 0, 0, fp->k);
+		break;
+	case BPF_ALU | BPF_NEG:
+		emit(cv, fp->code, REG_A, 0, 0, 0);
+		break;
+
+	/* A = k, A = len, A = M[k], A = P[k:size], A = P[X + k:size] */
+	case BPF_LD | BPF_IMM:
+		emit(cv, BPF_ALU | EBPF_MOV | BPF_K, REG_A, 0, 0, fp->k);
+		break;
+	case BPF_LD | BPF_W | BPF_LEN:
+		emit(cv, BPF_LDX | BPF_MEM | BPF_W, REG_A, REG_MBUF,
+			offsetof(struct rte_mbuf, pkt_len), 0);
+		break;
+	case BPF_LD | BPF_MEM:
+		if (fp->k >= BPF_MEMWORDS)
+			return -EINVAL;
+		emit(cv, BPF_LDX | BPF_MEM | BPF_W, REG_A, REG_FP,
+			MEM_OFF(fp->k), 0);
+		break;
+	case BPF_LD | BPF_ABS | BPF_W:
+	case BPF_LD | BPF_ABS | BPF_H:
+	case BPF_LD | BPF_ABS | BPF_B:
+		emit(cv, fp->code, 0, 0, 0, fp->k);
+		break;
+	case BPF_LD | BPF_IND | BPF_W:
+	case BPF_LD | BPF_IND | BPF_H:
+	case BPF_LD | BPF_IND | BPF_B:
+		emit(cv, fp->code, 0, REG_X, 0, fp->k);
+		break;
+
+	/* X = k, X = len, X = M[k], X = 4 * (P[k:1] & 0xf) */
+	case BPF_LDX | BPF_IMM:
+		emit(cv, BPF_ALU | EBPF_MOV | BPF_K, REG_X, 0, 0, fp->k);
+		break;
+	case BPF_LDX | BPF_W | BPF_LEN:
+		emit(cv, BPF_LDX | BPF_MEM | BPF_W, REG_X, REG_MBUF,
+			offsetof(struct rte_mbuf, pkt_len), 0);
+		break;
+	case BPF_LDX | BPF_MEM:
+		if (fp->k >= BPF_MEMWORDS)
+			return -EINVAL;
+		emit(cv, BPF_LDX | BPF_MEM | BPF_W, REG_X, REG_FP,
+			MEM_OFF(fp->k), 0);
+		break;
+	case BPF_LDX | BPF_B | BPF_MSH:
+		emit(cv, EBPF_ALU64 | EBPF_MOV | BPF_X, REG_TMP, REG_A, 0, 0);
+		emit(cv, BPF_LD | BPF_ABS | BPF_B, 0, 0, 0, fp->k);
+		emit(cv, BPF_ALU | BPF_AND | BPF_K, REG_A, 0, 0, 0xf);
+		emit(cv, BPF_ALU | BPF_LSH | BPF_K, REG_A, 0, 0, 2);
+		emit(cv, BPF_ALU | EBPF_MOV | BPF_X, REG_X, REG_A, 0, 0);
+		emit(cv, EBPF_ALU64 | EBPF_MOV | BPF_X, REG_A, REG_TMP, 0, 0);
+		break;
+
+	/* M[k] = A, M[k] = X */
+	case BPF_ST:
+	case BPF_STX:
+		if (fp->k >= BPF_MEMWORDS)
+			return -EINVAL;
+		emit(cv, BPF_STX | BPF_MEM | BPF_W, REG_FP,
+			fp->code == BPF_ST ? REG_A : REG_X, MEM_OFF(fp->k), 0);
+		break;
+
+	/* jumps */
+	case BPF_JMP | BPF_JA:
+		if (jmp_off(cv, i + 1 + fp->k, &off) != 0)
+			return -EINVAL;
+		emit(cv, BPF_JMP | BPF_JA, 0, 0, off, 0);
+		break;
+	case BPF_JMP | BPF_JEQ | BPF_K:
+	case BPF_JMP | BPF_JEQ | BPF_X:
+	case BPF_JMP | BPF_JGT | BPF_K:
+	case BPF_JMP | BPF_JGT | BPF_X:
+	case BPF_JMP | BPF_JGE | BPF_K:
+	case BPF_JMP | BPF_JGE | BPF_X:
+	case BPF_JMP | BPF_JSET | BPF_K:
+	case BPF_JMP | BPF_JSET | BPF_X:
+		return conv_jmp(cv, i, fp);
+
+	/* return k, A or X */
+	case BPF_RET | BPF_K:
+		emit(cv, BPF_ALU | EBPF_MOV | BPF_K, REG_A, 0, 0, fp->k);
+		emit(cv, BPF_JMP | EBPF_EXIT, 0, 0, 0, 0);
+		break;
+	case BPF_RET | BPF_X:
+		emit(cv, BPF_ALU | EBPF_MOV | BPF_X, REG_A, REG_X, 0, 0);
+		/* fall through */
+	case BPF_RET | BPF_A:
+		emit(cv, BPF_JMP | EBPF_EXIT, 0, 0, 0, 0);
+		break;
+
+	/* X = A, A = X */
+	case BPF_MISC | BPF_TAX:
+		emit(cv, BPF_ALU | EBPF_MOV | BPF_X, REG_X, REG_A, 0, 0);
+		break;
+	case BPF_MISC | BPF_TXA:
+		emit(cv, BPF_ALU | EBPF_MOV | BPF_X, REG_A, REG_X, 0, 0);
+		break;
+
+	default:
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+/*
+ * Translate the whole program, into cv->out when it is set,
+ * otherwise only count the eBPF instructions needed.
+ */
+static int
+conv_prog(struct cbpf_conv *cv, uint32_t *map)
+{
+	int rc;
+	uint32_t i;
+	int use_mem;
+
+	cv->nb_out = 0;
+
+	/* R6 = ctx, A = 0, X = 0 */
+	emit(cv, EBPF_ALU64 | EBPF_MOV | BPF_X, REG_MBUF, EBPF_REG_1, 0, 0);
+	emit(cv, BPF_ALU | EBPF_MOV | BPF_K, REG_A, 0, 0, 0);
+	emit(cv, BPF_ALU | EBPF_MOV | BPF_K, REG_X, 0, 0, 0);
+
+	/* M[] content is zero at start, as it is for cBPF */
+	use_mem = 0;
+	for (i = 0; i != cv->nb_in; i++) {
+		if (BPF_CLASS(cv->in[i].code) == BPF_ST ||
+				BPF_CLASS(cv->in[i].code) == BPF_STX ||
+				cv->in[i].code == (BPF_LD | BPF_MEM) ||
+				cv->in[i].code == (BPF_LDX | BPF_MEM))
+			use_mem = 1;
+	}
+	for (i = 0; use_mem != 0 && i != BPF_MEMWORDS; i++)
+		emit(cv, BPF_ST | BPF_MEM | EBPF_DW, REG_FP, 0,
+			MEM_OFF(i), 0);
+
+	for (i = 0; i != cv->nb_in; i++) {
+		if (map != NULL)
+			map[i] = cv->nb_out;
+
+		rc = conv_insn(cv, i);
+		if (rc != 0) {
+			RTE_BPF_LOG(ERR, "%s: cannot convert %u-th "
+				"instruction (code: %#x): %d;\n",
+				__func__, i, cv->in[i].code, rc);
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+struct rte_bpf_prm *
+rte_bpf_convert(const struct bpf_program *prog)
+{
+	int rc;
+	uint32_t *map;
+	struct rte_bpf_prm *prm;
+	struct cbpf_conv cv;
+
+	if (prog == NULL || prog->bf_len == 0 ||
+			BPF_CLASS(prog->bf_insns[prog->bf_len - 1].code) !=
+			BPF_RET) {
+		RTE_BPF_LOG(ERR, "%s: invalid cBPF program\n", __func__);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	map = malloc(prog->bf_len * sizeof(map[0]));
+	if (map == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	memset(&cv, 0, sizeof(cv));
+	cv.in = prog->bf_insns;
+	cv.nb_in = prog->bf_len;
+	cv.map = map;
+
+	/* first pass: count eBPF instructions and fill the index map */
+	rc = conv_prog(&cv, map);
+	if (rc != 0) {
+		free(map);
+		rte_errno = -rc;
+		return NULL;
+	}
+
+	/*
+	 * allocate parameters and instructions from the shared memory,
+	 * so the result can be handed over to another process.
+	 */
+	prm = rte_zmalloc("bpf_filter",
+		sizeof(*prm) + cv.nb_out * sizeof(struct ebpf_insn), 0);
+	if (prm == NULL) {
+		free(map);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	/* second pass: generate the code, with jump offsets resolved */
+	cv.out = (struct ebpf_insn *)(prm + 1);
+	rc = conv_prog(&cv, NULL);
+	free(map);
+	if (rc != 0) {
+		rte_free(prm);
+		rte_errno = -rc;
+		return NULL;
+	}
+
+	prm->ins = cv.out;
+	prm->nb_ins = cv.nb_out;
+	prm->prog_arg.type = RTE_BPF_ARG_PTR_MBUF;
+	prm->prog_arg.size = sizeof(struct rte_mbuf);
+	prm->prog_arg.buf_size = RTE_MBUF_DEFAULT_BUF_SIZE;
+
+	return prm;
+}
@@ -112,6 +112,47 @@ bpf_alu_le(uint64_t reg[EBPF_REG_NUM], const struct ebpf_insn *ins)
 	}
 }
 
+uint64_t
+bpf_ld_mbuf(const struct rte_mbuf *mb, uint32_t off, uint32_t len)
+{
+	const void *p;
+	union {
+		uint8_t u8;
+		uint16_t u16;
+		uint32_t u32;
+	} buf;
+
+	p = rte_pktmbuf_read(mb, off, len, &buf);
+	if (p == NULL)
+		return BPF_LD_MBUF_ERR;
+
+	if (len == sizeof(uint8_t))
+		return *(const uint8_t *)p;
+	else if (len == sizeof(uint16_t))
+		return rte_be_to_cpu_16(*(const unaligned_uint16_t *)p);
+	else
+		return rte_be_to_cpu_32(*(const unaligned_uint32_t *)p);
+}
+
+/*
+ * BPF_LD | BPF_ABS/BPF_IND: R6 holds the mbuf pointer, result goes to R0,
+ * out of bounds access terminates the program with return value zero.
+ */
+static inline int
+bpf_ld_pkt(uint64_t reg[EBPF_REG_NUM], const struct ebpf_insn *ins,
+	uint32_t off)
+{
+	uint64_t v;
+
+	v = bpf_ld_mbuf((const struct rte_mbuf *)(uintptr_t)reg[EBPF_REG_6],
+		off, bpf_size(BPF_SIZE(ins->code)));
+	if (v == BPF_LD_MBUF_ERR)
+		return -ERANGE;
+
+	reg[EBPF_REG_0] = v;
+	return 0;
+}
+
 static inline uint64_t
 bpf_exec(const struct rte_bpf *bpf, uint64_t reg[EBPF_REG_NUM])
 {
@@ -296,6 +337,20 @@ bpf_exec(const struct rte_bpf *bpf, uint64_t reg[EBPF_REG_NUM])
 				(uint64_t)(uint32_t)ins[1].imm << 32;
 			ins++;
 			break;
+		/* packet data load instructions */
+		case (BPF_LD | BPF_ABS | BPF_B):
+		case (BPF_LD | BPF_ABS | BPF_H):
+		case (BPF_LD | BPF_ABS | BPF_W):
+			if (bpf_ld_pkt(reg, ins, ins->imm) != 0)
+				return 0;
+			break;
+		case (BPF_LD | BPF_IND | BPF_B):
+		case (BPF_LD | BPF_IND | BPF_H):
+		case (BPF_LD | BPF_IND | BPF_W):
+			if (bpf_ld_pkt(reg, ins,
+					(uint32_t)reg[ins->src_reg] + ins->imm))
+				return 0;
+			break;
 		/* store instructions */
 		case (BPF_STX | BPF_MEM | BPF_B):
 			BPF_ST_REG(reg, ins, uint8_t);
@@ -23,6 +23,19 @@ struct rte_bpf {
 
 extern int bpf_validate(struct rte_bpf *bpf);
 
+/*
+ * Value returned by bpf_ld_mbuf() when the requested data lies
+ * beyond the end of the packet.
+ */
+#define	BPF_LD_MBUF_ERR	UINT64_MAX
+
+/*
+ * Fetch packet data for BPF_LD | BPF_ABS and BPF_LD | BPF_IND
+ * instructions, used by both the interpreter and the JIT-ed code.
+ */
+extern uint64_t bpf_ld_mbuf(const struct rte_mbuf *mb, uint32_t off,
+	uint32_t len);
+
 extern int bpf_jit(struct rte_bpf *bpf);
 
 extern int bpf_jit_x86(struct rte_bpf *);
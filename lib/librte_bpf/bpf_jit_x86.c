@@ -857,6 +857,45 @@ emit_jcc(struct bpf_jit_state *st, uint32_t op, int32_t ofs)
 	emit_abs_jcc(st, op, st->off[st->idx + ofs]);
 }
 
+/*
+ * emit code for BPF_LD | BPF_ABS/BPF_IND packet data load:
+ * mov %<sreg>, %esi (BPF_IND only)
+ * add <imm>, %esi (BPF_IND only)
+ * OR
+ * mov <imm>, %esi (BPF_ABS)
+ * mov %rbx, %rdi
+ * mov <size>, %edx
+ * call bpf_ld_mbuf
+ * xor %r10, %r10
+ * mov %rax, %r11
+ * shr $32, %r11
+ * cmovnz %r10, %rax
+ * jnz <exit>
+ */
+static void
+emit_ld_mbuf(struct bpf_jit_state *st, uint32_t op, uint32_t sreg,
+	uint32_t imm)
+{
+	if (BPF_MODE(op) == BPF_IND) {
+		emit_mov_reg(st, BPF_ALU | EBPF_MOV | BPF_X, sreg, RSI);
+		emit_alu_imm(st, BPF_ALU | BPF_ADD | BPF_K, RSI, imm);
+	} else
+		emit_mov_imm(st, BPF_ALU | EBPF_MOV | BPF_K, RSI, imm);
+
+	emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X,
+		ebpf2x86[EBPF_REG_6], RDI);
+	emit_mov_imm(st, BPF_ALU | EBPF_MOV | BPF_K, RDX,
+		bpf_size(BPF_SIZE(op)));
+
+	emit_call(st, (uintptr_t)bpf_ld_mbuf);
+
+	/* out of packet bounds, exit with return value zero */
+	emit_mov_imm(st, EBPF_ALU64 | EBPF_MOV | BPF_K, REG_TMP1, 0);
+	emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X, RAX, REG_TMP0);
+	emit_shift_imm(st, EBPF_ALU64 | BPF_RSH | BPF_K, REG_TMP0, 32);
+	emit_movcc_reg(st, BPF_JMP | EBPF_JNE | BPF_X, REG_TMP1, RAX);
+	emit_abs_jcc(st, BPF_JMP | EBPF_JNE | BPF_K, st->exit.off);
+}
 
 /*
  * emit cmp <imm>, %<dreg>
@@ -1240,6 +1279,15 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 			emit_ld_imm64(st, dr, ins[0].imm, ins[1].imm);
 			i++;
 			break;
+		/* load absolute/indirect packet data instructions */
+		case (BPF_LD | BPF_ABS | BPF_B):
+		case (BPF_LD | BPF_ABS | BPF_H):
+		case (BPF_LD | BPF_ABS | BPF_W):
+		case (BPF_LD | BPF_IND | BPF_B):
+		case (BPF_LD | BPF_IND | BPF_H):
+		case (BPF_LD | BPF_IND | BPF_W):
+			emit_ld_mbuf(st, op, sr, ins->imm);
+			break;
 		/* store instructions */
 		case (BPF_STX | BPF_MEM | BPF_B):
 		case (BPF_STX | BPF_MEM | BPF_H):
@@ -205,6 +205,34 @@ __rte_experimental
 int
 rte_bpf_get_jit(const struct rte_bpf *bpf, struct rte_bpf_jit *jit);
 
+#ifdef RTE_PORT_PCAP
+
+struct bpf_program;
+
+/**
+ * Convert a cBPF program (as produced by pcap_compile()) into eBPF.
+ * The result expects a pointer to rte_mbuf as its argument and
+ * uses BPF_LD | BPF_ABS/BPF_IND instructions to access packet data.
+ * Note that the returned parameters (and instructions they refer to)
+ * are allocated from the DPDK shared memory, so they can be passed
+ * to another DPDK process (e.g. to the primary one via rte_pdump).
+ *
+ * @param prog
+ *   Classic BPF program to convert.
+ * @return
+ *   Pointer to the eBPF load parameters, to be released with rte_free(),
+ *   or NULL on error, with error code set in rte_errno.
+ *   Possible rte_errno errors include:
+ *   - EINVAL - invalid parameter passed to function
+ *   - ENOTSUP - program uses cBPF extensions that are not supported
+ *   - ENOMEM - can't reserve enough memory
+ */
+__rte_experimental
+struct rte_bpf_prm *
+rte_bpf_convert(const struct bpf_program *prog);
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -450,6 +450,10 @@ rte_cryptodev_asym_get_xform_enum(enum rte_crypto_asym_xform_type *xform_enum,
 /**< Support encrypted-digest operations where digest is appended to data */
 #define RTE_CRYPTODEV_FF_ASYM_SESSIONLESS		(1ULL << 20)
 /**< Support asymmetric session-less operations */
+#define	RTE_CRYPTODEV_FF_SYM_CPU_CRYPTO			(1ULL << 21)
+/**< Support synchronous CPU crypto operations */
+#define	RTE_CRYPTODEV_FF_SYM_RAW_DP			(1ULL << 22)
+/**< Support raw data-path operations, without crypto ops nor mbufs */
 
 
 /**
@@ -1274,6 +1278,182 @@ void *
 rte_cryptodev_sym_session_get_user_data(
 					struct rte_cryptodev_sym_session *sess);
 
+/**
+ * Perform actual crypto processing (encrypt/digest or auth/decrypt)
+ * on user provided data.
+ *
+ * The operations are done synchronously on the calling lcore, without
+ * crypto operations nor queue pairs, by devices supporting
+ * RTE_CRYPTODEV_FF_SYM_CPU_CRYPTO.
+ *
+ * @param	dev_id	The device identifier.
+ * @param	sess	Cryptodev session structure
+ * @param	ofs	Start and stop offsets for auth and cipher operations
+ * @param	vec	Vectorized operation descriptor
+ *
+ * @return
+ *  - Returns number of successfully processed packets.
+ */
+__rte_experimental
+uint32_t
+rte_cryptodev_sym_cpu_crypto_process(uint8_t dev_id,
+	struct rte_cryptodev_sym_session *sess, union rte_crypto_sym_ofs ofs,
+	struct rte_crypto_sym_vec *vec);
+
+/**
+ * Enqueue a burst of raw data-path operations to a queue pair.
+ *
+ * @param	qp		Driver specific queue pair data.
+ * @param	drv_ctx		Driver specific context data.
+ * @param	vec		Vectorized operation descriptor.
+ * @param	ofs		Start and stop offsets for auth and cipher
+ *				operations.
+ * @param	user_data	Array of user data, one per operation.
+ *
+ * @return
+ *  - Number of operations enqueued, starting from the first one.
+ */
+typedef uint32_t (*cryptodev_sym_raw_enqueue_burst_t)(void *qp,
+	uint8_t *drv_ctx, struct rte_crypto_sym_vec *vec,
+	union rte_crypto_sym_ofs ofs, void *user_data[]);
+
+/**
+ * Dequeue a burst of completed raw data-path operations from a queue pair.
+ *
+ * @param	qp		Driver specific queue pair data.
+ * @param	drv_ctx		Driver specific context data.
+ * @param	user_data	Array to fill with the user data of the
+ *				completed operations.
+ * @param	status		Array to fill with the status of the completed
+ *				operations: 0 on success, errno value otherwise.
+ * @param	max		Size of the *user_data* and *status* arrays.
+ *
+ * @return
+ *  - Number of operations dequeued.
+ */
+typedef uint32_t (*cryptodev_sym_raw_dequeue_burst_t)(void *qp,
+	uint8_t *drv_ctx, void *user_data[], int32_t status[], uint32_t max);
+
+/**
+ * Context of the raw data-path API, binding one queue pair of a device
+ * to one symmetric session.
+ *
+ * The structure is allocated by the application with the size returned by
+ * rte_cryptodev_get_raw_dp_ctx_size() and filled by
+ * rte_cryptodev_configure_raw_dp_ctx(). Several contexts may be bound to the
+ * same queue pair, but like the queue pair itself they must not be used by
+ * more than one lcore at a time.
+ */
+struct rte_crypto_raw_dp_ctx {
+	void *qp_data;
+	/**< Driver specific queue pair data */
+	cryptodev_sym_raw_enqueue_burst_t enqueue_burst;
+	/**< Driver enqueue function */
+	cryptodev_sym_raw_dequeue_burst_t dequeue_burst;
+	/**< Driver dequeue function */
+	__extension__ uint8_t drv_ctx_data[];
+	/**< Driver specific context data */
+};
+
+/**
+ * Get the size of the raw data-path context of a device.
+ *
+ * @param	dev_id	The device identifier.
+ *
+ * @return
+ *   - The size of the context to allocate, in bytes.
+ *   - -EINVAL if *dev_id* is invalid.
+ *   - -ENOTSUP if the device does not support the raw data-path API.
+ */
+__rte_experimental
+int
+rte_cryptodev_get_raw_dp_ctx_size(uint8_t dev_id);
+
+/**
+ * Configure a raw data-path context for a queue pair and a session.
+ *
+ * The queue pair must already be set up and must not be used for
+ * *rte_crypto_op* processing, as completions of both APIs would interleave.
+ *
+ * @param	dev_id	The device identifier.
+ * @param	qp_id	The index of the queue pair to use.
+ * @param	ctx	The context to fill, of the size returned by
+ *			rte_cryptodev_get_raw_dp_ctx_size().
+ * @param	sess	Symmetric session initialized for the device.
+ *
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL on invalid parameters.
+ *   - -ENOTSUP if the device does not support the raw data-path API or the
+ *     session transforms.
+ *   - -ENOMEM if the queue pair resources could not be allocated.
+ */
+__rte_experimental
+int
+rte_cryptodev_configure_raw_dp_ctx(uint8_t dev_id, uint16_t qp_id,
+	struct rte_crypto_raw_dp_ctx *ctx,
+	struct rte_cryptodev_sym_session *sess);
+
+/**
+ * Enqueue a burst of symmetric operations described by data vectors.
+ *
+ * No *rte_crypto_op* nor *rte_mbuf* is needed: each operation is made of
+ * a scatter-gather list of data, IV, AAD and digest pointers taken from
+ * *vec* and an opaque *user_data* pointer given back on dequeue. The
+ * *status* field of *vec* is not used.
+ *
+ * The data of each operation covers both the cipher and the authentication
+ * regions, *ofs* gives their head and tail offsets inside it. For AEAD
+ * algorithms only the cipher offsets are used. Operations are done in place.
+ *
+ * @param	ctx		Raw data-path context.
+ * @param	vec		Vectorized operation descriptor.
+ * @param	ofs		Start and stop offsets for auth and cipher
+ *				operations.
+ * @param	user_data	Array of *vec->num* user data pointers.
+ *
+ * @return
+ *  - Number of operations enqueued, starting from the first one. Fewer than
+ *    *vec->num* means the queue pair is full.
+ */
+__rte_experimental
+static inline uint32_t
+rte_cryptodev_raw_enqueue_burst(struct rte_crypto_raw_dp_ctx *ctx,
+	struct rte_crypto_sym_vec *vec, union rte_crypto_sym_ofs ofs,
+	void *user_data[])
+{
+	return (*ctx->enqueue_burst)(ctx->qp_data, ctx->drv_ctx_data, vec,
+			ofs, user_data);
+}
+
+/**
+ * Dequeue a burst of completed operations enqueued with
+ * rte_cryptodev_raw_enqueue_burst() on the queue pair of the context.
+ *
+ * Completions are not guaranteed to follow the enqueue order, the user data
+ * identifies each operation.
+ *
+ * @param	ctx		Raw data-path context.
+ * @param	user_data	Array to fill with the user data of the
+ *				completed operations.
+ * @param	status		Array to fill with the status of the completed
+ *				operations: 0 on success, EBADMSG on digest
+ *				verification failure, other errno value on
+ *				error.
+ * @param	max		Size of the *user_data* and *status* arrays.
+ *
+ * @return
+ *  - Number of operations dequeued.
+ */
+__rte_experimental
+static inline uint32_t
+rte_cryptodev_raw_dequeue_burst(struct rte_crypto_raw_dp_ctx *ctx,
+	void *user_data[], int32_t status[], uint32_t max)
+{
+	return (*ctx->dequeue_burst)(ctx->qp_data, ctx->drv_ctx_data,
+			user_data, status, max);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -308,6 +308,47 @@ typedef void (*cryptodev_sym_free_session_t)(struct rte_cryptodev *dev,
  */
 typedef void (*cryptodev_asym_free_session_t)(struct rte_cryptodev *dev,
 		struct rte_cryptodev_asym_session *sess);
+/**
+ * Perform actual crypto processing (encrypt/digest or auth/decrypt)
+ * on user provided data.
+ *
+ * @param	dev	Crypto device pointer
+ * @param	sess	Cryptodev session structure
+ * @param	ofs	Start and stop offsets for auth and cipher operations
+ * @param	vec	Vectorized operation descriptor
+ *
+ * @return
+ *  - Returns number of successfully processed packets.
+ *
+ */
+typedef uint32_t (*cryptodev_sym_cpu_crypto_process_t)
+	(struct rte_cryptodev *dev, struct rte_cryptodev_sym_session *sess,
+	union rte_crypto_sym_ofs ofs, struct rte_crypto_sym_vec *vec);
+
+/**
+ * Get the size of the driver specific data of a raw data-path context.
+ *
+ * @param	dev	Crypto device pointer
+ *
+ * @return
+ *  - Size of the driver specific context data.
+ */
+typedef int (*cryptodev_sym_get_raw_dp_ctx_size_t)(struct rte_cryptodev *dev);
+
+/**
+ * Fill a raw data-path context for a queue pair and a session.
+ *
+ * @param	dev	Crypto device pointer
+ * @param	qp_id	Queue pair index, already checked to be set up
+ * @param	ctx	Raw data-path context to fill
+ * @param	sess	Cryptodev session structure
+ *
+ * @return
+ *  - 0 on success, negative errno value otherwise.
+ */
+typedef int (*cryptodev_sym_configure_raw_dp_ctx_t)(struct rte_cryptodev *dev,
+	uint16_t qp_id, struct rte_crypto_raw_dp_ctx *ctx,
+	struct rte_cryptodev_sym_session *sess);
 
 /** Crypto device operations function pointer table */
 struct rte_cryptodev_ops {
@@ -342,6 +383,12 @@ struct rte_cryptodev_ops {
 	/**< Clear a Crypto sessions private data. */
 	cryptodev_asym_free_session_t asym_session_clear;
 	/**< Clear a Crypto sessions private data. */
+	cryptodev_sym_cpu_crypto_process_t sym_cpu_process;
+	/**< process input data synchronously (cpu-crypto). */
+	cryptodev_sym_get_raw_dp_ctx_size_t sym_get_raw_dp_ctx_size;
+	/**< Get raw data-path context private data size. */
+	cryptodev_sym_configure_raw_dp_ctx_t sym_configure_raw_dp_ctx;
+	/**< Configure raw data-path context. */
 };
 
 
@@ -506,6 +553,120 @@ set_asym_session_private_data(struct rte_cryptodev_asym_session *sess,
 	sess->sess_private_data[driver_id] = private_data;
 }
 
+/** Completion of a raw data-path operation */
+struct rte_cryptodev_raw_cpl {
+	void *user_data;
+	/**< User data of the operation */
+	int32_t status;
+	/**< 0 on success, errno value otherwise */
+};
+
+/**
+ * Single producer, single consumer FIFO of raw data-path completions,
+ * for software PMDs which complete the operations while enqueuing them.
+ */
+struct rte_cryptodev_raw_cpl_ring {
+	uint32_t head;
+	/**< Index of the next completion to write */
+	uint32_t tail;
+	/**< Index of the next completion to read */
+	uint32_t mask;
+	/**< Number of entries minus one */
+	__extension__ struct rte_cryptodev_raw_cpl cpl[];
+	/**< Completion entries */
+};
+
+/**
+ * @internal
+ * Allocate a FIFO of raw data-path completions.
+ *
+ * @param	count		Minimum number of completions to hold.
+ * @param	socket_id	Socket to allocate the FIFO on.
+ *
+ * @return
+ *   - Pointer to the FIFO, NULL on allocation failure.
+ */
+static inline struct rte_cryptodev_raw_cpl_ring *
+rte_cryptodev_raw_cpl_ring_create(uint32_t count, int socket_id)
+{
+	struct rte_cryptodev_raw_cpl_ring *r;
+	uint32_t size;
+
+	size = rte_align32pow2(count + 1);
+	r = rte_zmalloc_socket("cryptodev raw completions", sizeof(*r) +
+			size * sizeof(r->cpl[0]), RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (r != NULL)
+		r->mask = size - 1;
+
+	return r;
+}
+
+/**
+ * @internal
+ * Free a FIFO of raw data-path completions.
+ */
+static inline void
+rte_cryptodev_raw_cpl_ring_free(struct rte_cryptodev_raw_cpl_ring *r)
+{
+	rte_free(r);
+}
+
+/**
+ * @internal
+ * Get the number of completions which can still be put in the FIFO.
+ */
+static inline uint32_t
+rte_cryptodev_raw_cpl_ring_free_count(
+		const struct rte_cryptodev_raw_cpl_ring *r)
+{
+	return r->mask - (r->head - __atomic_load_n(&r->tail,
+			__ATOMIC_ACQUIRE));
+}
+
+/**
+ * @internal
+ * Put a completion in the FIFO, space must have been checked with
+ * rte_cryptodev_raw_cpl_ring_free_count().
+ */
+static inline void
+rte_cryptodev_raw_cpl_ring_put(struct rte_cryptodev_raw_cpl_ring *r,
+		void *user_data, int32_t status)
+{
+	struct rte_cryptodev_raw_cpl *cpl = &r->cpl[r->head & r->mask];
+
+	cpl->user_data = user_data;
+	cpl->status = status;
+	__atomic_store_n(&r->head, r->head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @internal
+ * Get up to *max* completions from the FIFO.
+ *
+ * @return
+ *   - Number of completions returned.
+ */
+static inline uint32_t
+rte_cryptodev_raw_cpl_ring_get(struct rte_cryptodev_raw_cpl_ring *r,
+		void *user_data[], int32_t status[], uint32_t max)
+{
+	uint32_t i, n, tail;
+	struct rte_cryptodev_raw_cpl *cpl;
+
+	tail = r->tail;
+	n = RTE_MIN(max, __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail);
+
+	for (i = 0; i != n; i++) {
+		cpl = &r->cpl[(tail + i) & r->mask];
+		user_data[i] = cpl->user_data;
+		status[i] = cpl->status;
+	}
+
+	__atomic_store_n(&r->tail, tail + n, __ATOMIC_RELEASE);
+	return n;
+}
+
 #ifdef __cplusplus
 }
 #endif
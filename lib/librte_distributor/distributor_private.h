@@ -32,6 +32,7 @@ extern "C" {
 #define RTE_DISTRIB_GET_BUF (1)    /**< worker requests a buffer, returns old */
 #define RTE_DISTRIB_RETURN_BUF (2) /**< worker returns a buffer, no request */
 #define RTE_DISTRIB_VALID_BUF (4)  /**< set if bufptr contains ptr */
+#define RTE_DISTRIB_STOP_BUF (8)   /**< worker stops requesting buffers */
 
 #define RTE_DISTRIB_BACKLOG_SIZE 8
 #define RTE_DISTRIB_BACKLOG_MASK (RTE_DISTRIB_BACKLOG_SIZE - 1)
@@ -66,6 +67,12 @@ union rte_distributor_buffer_single {
  */
 #define RTE_DIST_BURST_SIZE 8
 
+/*
+ * Return slots per worker: the second cache line is only used when a worker
+ * batching its returns hands back its staged packets along with a burst.
+ */
+#define RTE_DIST_RETURN_SLOTS (2 * RTE_DIST_BURST_SIZE)
+
 struct rte_distributor_backlog {
 	unsigned int start;
 	unsigned int count;
@@ -122,12 +129,16 @@ struct rte_distributor_buffer {
 
 	int64_t pad1 __rte_cache_aligned;    /* <= one cache line  */
 
-	volatile int64_t retptr64[RTE_DIST_BURST_SIZE]
+	volatile int64_t retptr64[RTE_DIST_RETURN_SLOTS]
 		__rte_cache_aligned; /* <= incoming from worker */
 
 	int64_t pad2 __rte_cache_aligned;    /* <= one cache line  */
 
 	int count __rte_cache_aligned;       /* <= number of current mbufs */
+
+	/* Returns held back by the worker with RTE_DISTRIB_F_RETURN_BATCH */
+	struct rte_mbuf *ret_stage[RTE_DIST_BURST_SIZE] __rte_cache_aligned;
+	unsigned int ret_stage_count;
 };
 
 struct rte_distributor {
@@ -155,6 +166,18 @@ struct rte_distributor {
 	enum rte_distributor_match_function dist_match_fn;
 
 	struct rte_distributor_single *d_single;
+
+	unsigned int socket_id;  /**< NUMA node of the instance */
+	unsigned int burst_size; /**< Max packets per burst to a worker */
+	uint32_t flags;          /**< RTE_DISTRIB_F_* */
+
+	/**
+	 * Flow affinity table, indexed by tag. Each entry holds the tag in
+	 * its upper 16 bits and the worker id + 1 it was last sent to in its
+	 * lower 16 bits, 0 if unused.
+	 */
+	uint32_t *flow_table;
+	uint32_t flow_table_mask;
 };
 
 void
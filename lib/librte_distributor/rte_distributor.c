@@ -13,6 +13,7 @@
 #include <rte_errno.h>
 #include <rte_string_fns.h>
 #include <rte_eal_memconfig.h>
+#include <rte_malloc.h>
 #include <rte_pause.h>
 #include <rte_tailq.h>
 
@@ -31,13 +32,57 @@ EAL_REGISTER_TAILQ(rte_dist_burst_tailq)
 
 /**** Burst Packet APIs called by workers ****/
 
+/*
+ * With RTE_DISTRIB_F_RETURN_BATCH, gather the packets held by a worker and
+ * the ones it returns now into ret, and return their number.
+ */
+static unsigned int
+unstage_returns(struct rte_distributor_buffer *buf, struct rte_mbuf **oldpkt,
+		unsigned int count, struct rte_mbuf **ret)
+{
+	unsigned int staged = buf->ret_stage_count;
+	unsigned int i;
+
+	for (i = 0; i < staged; i++)
+		ret[i] = buf->ret_stage[i];
+	for (i = 0; i < count; i++)
+		ret[staged + i] = oldpkt[i];
+	buf->ret_stage_count = 0;
+
+	return staged + count;
+}
+
+/*
+ * With RTE_DISTRIB_F_RETURN_BATCH, hold back the packets a worker returns
+ * until a full burst has built up, or until the worker has nothing new to
+ * return, i.e. is idle. Returns the number of packets to hand back now,
+ * gathered into ret.
+ */
+static unsigned int
+stage_returns(struct rte_distributor_buffer *buf, struct rte_mbuf **oldpkt,
+		unsigned int count, struct rte_mbuf **ret)
+{
+	unsigned int staged = buf->ret_stage_count;
+	unsigned int i;
+
+	if (count != 0 && staged + count < RTE_DIST_BURST_SIZE) {
+		for (i = 0; i < count; i++)
+			buf->ret_stage[staged + i] = oldpkt[i];
+		buf->ret_stage_count = staged + count;
+		return 0;
+	}
+
+	return unstage_returns(buf, oldpkt, count, ret);
+}
+
 void
 rte_distributor_request_pkt(struct rte_distributor *d,
 		unsigned int worker_id, struct rte_mbuf **oldpkt,
 		unsigned int count)
 {
 	struct rte_distributor_buffer *buf = &(d->bufs[worker_id]);
-	unsigned int i;
+	struct rte_mbuf *ret[RTE_DIST_RETURN_SLOTS];
+	unsigned int i, end;
 
 	volatile int64_t *retptr64;
 
@@ -65,7 +110,15 @@ rte_distributor_request_pkt(struct rte_distributor *d,
 	 * handshake bits. Populate the retptrs with returning packets.
 	 */
 
-	for (i = count; i < RTE_DIST_BURST_SIZE; i++)
+	if (d->flags & RTE_DISTRIB_F_RETURN_BATCH) {
+		count = stage_returns(buf, oldpkt, count, ret);
+		oldpkt = ret;
+	}
+
+	/* the distributor reads the second line only after a full first one */
+	end = count < RTE_DIST_BURST_SIZE ?
+			RTE_DIST_BURST_SIZE : RTE_DIST_RETURN_SLOTS;
+	for (i = count; i < end; i++)
 		buf->retptr64[i] = 0;
 
 	/* Set Return bit for each packet returned */
@@ -160,6 +213,7 @@ rte_distributor_return_pkt(struct rte_distributor *d,
 		unsigned int worker_id, struct rte_mbuf **oldpkt, int num)
 {
 	struct rte_distributor_buffer *buf = &d->bufs[worker_id];
+	struct rte_mbuf *ret[RTE_DIST_RETURN_SLOTS];
 	unsigned int i;
 
 	if (unlikely(d->alg_type == RTE_DIST_ALG_SINGLE)) {
@@ -170,9 +224,21 @@ rte_distributor_return_pkt(struct rte_distributor *d,
 			return -EINVAL;
 	}
 
+	/*
+	 * Hand back everything held, the worker may be stopping. While the
+	 * distributor still owns the return line, it takes the held packets
+	 * back itself, see handle_staged_returns().
+	 */
+	if ((d->flags & RTE_DISTRIB_F_RETURN_BATCH) &&
+			!(__atomic_load_n(&(buf->retptr64[0]), __ATOMIC_ACQUIRE)
+			& RTE_DISTRIB_GET_BUF)) {
+		num = unstage_returns(buf, oldpkt, num, ret);
+		oldpkt = ret;
+	}
+
 	/* Sync with distributor to acquire retptrs */
 	__atomic_thread_fence(__ATOMIC_ACQUIRE);
-	for (i = 0; i < RTE_DIST_BURST_SIZE; i++)
+	for (i = 0; i < RTE_DIST_RETURN_SLOTS; i++)
 		/* Switch off the return bit first */
 		buf->retptr64[i] &= ~RTE_DISTRIB_RETURN_BUF;
 
@@ -180,11 +246,13 @@ rte_distributor_return_pkt(struct rte_distributor *d,
 		buf->retptr64[i] = (((int64_t)(uintptr_t)oldpkt[i]) <<
 			RTE_DISTRIB_FLAG_BITS) | RTE_DISTRIB_RETURN_BUF;
 
-	/* set the GET_BUF but even if we got no returns.
+	/* set the GET_BUF but even if we got no returns, and STOP_BUF so
+	 * that the distributor forgets the flows of this worker.
 	 * Sync with distributor on GET_BUF flag. Release retptrs.
 	 */
 	__atomic_store_n(&(buf->retptr64[0]),
-		buf->retptr64[0] | RTE_DISTRIB_GET_BUF, __ATOMIC_RELEASE);
+		buf->retptr64[0] | RTE_DISTRIB_GET_BUF | RTE_DISTRIB_STOP_BUF,
+		__ATOMIC_RELEASE);
 
 	return 0;
 }
@@ -255,6 +323,28 @@ find_match_scalar(struct rte_distributor *d,
 }
 
 
+static inline uint32_t *
+flow_table_entry(struct rte_distributor *d, uint16_t tag)
+{
+	/* the bottom bit of tags is always set */
+	return &d->flow_table[(tag >> 1) & d->flow_table_mask];
+}
+
+/*
+ * Forget the flows last sent to a worker which stopped requesting
+ * packets, so that they move to the other workers. Entries are
+ * otherwise only replaced by the flows they collide with.
+ */
+static void
+flow_table_evict(struct rte_distributor *d, unsigned int wkr)
+{
+	uint32_t i;
+
+	for (i = 0; i <= d->flow_table_mask; i++)
+		if ((d->flow_table[i] & 0xffff) == wkr + 1)
+			d->flow_table[i] = 0;
+}
+
 /*
  * When the handshake bits indicate that there are packets coming
  * back from the worker, this function is called to copy and store
@@ -269,11 +359,19 @@ handle_returns(struct rte_distributor *d, unsigned int wkr)
 			ret_count = d->returns.count;
 	unsigned int count = 0;
 	unsigned int i;
+	int64_t flags;
 
 	/* Sync on GET_BUF flag. Acquire retptrs. */
-	if (__atomic_load_n(&(buf->retptr64[0]), __ATOMIC_ACQUIRE)
-		& RTE_DISTRIB_GET_BUF) {
-		for (i = 0; i < RTE_DIST_BURST_SIZE; i++) {
+	flags = __atomic_load_n(&(buf->retptr64[0]), __ATOMIC_ACQUIRE);
+	if (flags & RTE_DISTRIB_GET_BUF) {
+		if (unlikely(flags & RTE_DISTRIB_STOP_BUF) &&
+				d->flow_table != NULL)
+			flow_table_evict(d, wkr);
+		for (i = 0; i < RTE_DIST_RETURN_SLOTS; i++) {
+			/* second line is only used after a full first one */
+			if (i == RTE_DIST_BURST_SIZE &&
+					count < RTE_DIST_BURST_SIZE)
+				break;
 			if (buf->retptr64[i] & RTE_DISTRIB_RETURN_BUF) {
 				oldbuf = ((uintptr_t)(buf->retptr64[i] >>
 					RTE_DISTRIB_FLAG_BITS));
@@ -293,6 +391,39 @@ handle_returns(struct rte_distributor *d, unsigned int wkr)
 	return count;
 }
 
+/*
+ * With RTE_DISTRIB_F_RETURN_BATCH, also take back the packets a worker
+ * holds back, so that they are not left with a worker waiting for work.
+ * This is only safe while the distributor owns the return line, as the
+ * worker only touches its held packets once GET_BUF has been cleared.
+ */
+static unsigned int
+handle_staged_returns(struct rte_distributor *d, unsigned int wkr)
+{
+	struct rte_distributor_buffer *buf = &(d->bufs[wkr]);
+	unsigned int ret_start = d->returns.start,
+			ret_count = d->returns.count;
+	unsigned int count;
+	unsigned int i;
+
+	/* Sync on GET_BUF flag. Acquire held packets. */
+	if (!(d->flags & RTE_DISTRIB_F_RETURN_BATCH) ||
+			!(__atomic_load_n(&(buf->retptr64[0]),
+				__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF))
+		return handle_returns(d, wkr);
+
+	count = buf->ret_stage_count;
+	for (i = 0; i < count; i++)
+		store_return((uintptr_t)buf->ret_stage[i], d,
+				&ret_start, &ret_count);
+	buf->ret_stage_count = 0;
+	d->returns.start = ret_start;
+	d->returns.count = ret_count;
+
+	/* Clearing GET_BUF also releases the held packets to the worker */
+	return count + handle_returns(d, wkr);
+}
+
 /*
  * This function releases a burst (cache line) to a worker.
  * It is called from the process function when a cacheline is
@@ -339,6 +470,40 @@ release(struct rte_distributor *d, unsigned int wkr)
 
 }
 
+/*
+ * Look the incoming tags up in the flow affinity table. A hit gives the
+ * worker the flow was last sent to, which is the only worker that can
+ * still have it in flight, as every assignment updates the table. Only
+ * when some tag misses do we need to match against all workers.
+ */
+static inline void
+find_match_flow_table(struct rte_distributor *d, uint16_t *data_ptr,
+		uint16_t *output_ptr, unsigned int pkts)
+{
+	uint16_t hits[RTE_DIST_BURST_SIZE];
+	unsigned int i, nb_hits = 0;
+	uint32_t entry;
+
+	for (i = 0; i < pkts; i++) {
+		entry = *flow_table_entry(d, data_ptr[i]);
+		hits[i] = (entry >> 16) == data_ptr[i] ? entry & 0xffff : 0;
+		nb_hits += hits[i] != 0;
+	}
+
+	if (nb_hits < pkts) {
+		switch (d->dist_match_fn) {
+		case RTE_DIST_MATCH_VECTOR:
+			find_match_vec(d, data_ptr, output_ptr);
+			break;
+		default:
+			find_match_scalar(d, data_ptr, output_ptr);
+		}
+	}
+
+	for (i = 0; i < pkts; i++)
+		if (hits[i] != 0)
+			output_ptr[i] = hits[i];
+}
 
 /* process a set of packets to distribute them to workers */
 int
@@ -381,10 +546,10 @@ rte_distributor_process(struct rte_distributor *d,
 			__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF)
 			d->bufs[wkr].count = 0;
 
-		if ((num_mbufs - next_idx) < RTE_DIST_BURST_SIZE)
+		if ((num_mbufs - next_idx) < d->burst_size)
 			pkts = num_mbufs - next_idx;
 		else
-			pkts = RTE_DIST_BURST_SIZE;
+			pkts = d->burst_size;
 
 		for (i = 0; i < pkts; i++) {
 			if (mbufs[next_idx + i]) {
@@ -396,12 +561,16 @@ rte_distributor_process(struct rte_distributor *d,
 		for (; i < RTE_DIST_BURST_SIZE; i++)
 			flows[i] = 0;
 
-		switch (d->dist_match_fn) {
-		case RTE_DIST_MATCH_VECTOR:
-			find_match_vec(d, &flows[0], &matches[0]);
-			break;
-		default:
-			find_match_scalar(d, &flows[0], &matches[0]);
+		if (d->flow_table != NULL) {
+			find_match_flow_table(d, &flows[0], &matches[0], pkts);
+		} else {
+			switch (d->dist_match_fn) {
+			case RTE_DIST_MATCH_VECTOR:
+				find_match_vec(d, &flows[0], &matches[0]);
+				break;
+			default:
+				find_match_scalar(d, &flows[0], &matches[0]);
+			}
 		}
 
 		/*
@@ -431,13 +600,16 @@ rte_distributor_process(struct rte_distributor *d,
 			 */
 			/* matches[j] = 0; */
 
+			if (d->flow_table != NULL)
+				*flow_table_entry(d, new_tag) =
+					((uint32_t)new_tag << 16) |
+					(matches[j] ? matches[j] : wkr + 1);
+
 			if (matches[j]) {
 				struct rte_distributor_backlog *bl =
 						&d->backlog[matches[j]-1];
-				if (unlikely(bl->count ==
-						RTE_DIST_BURST_SIZE)) {
+				if (unlikely(bl->count == d->burst_size))
 					release(d, matches[j]-1);
-				}
 
 				/* Add to worker that already has flow */
 				unsigned int idx = bl->count++;
@@ -448,10 +620,8 @@ rte_distributor_process(struct rte_distributor *d,
 			} else {
 				struct rte_distributor_backlog *bl =
 						&d->backlog[wkr];
-				if (unlikely(bl->count ==
-						RTE_DIST_BURST_SIZE)) {
+				if (unlikely(bl->count == d->burst_size))
 					release(d, wkr);
-				}
 
 				/* Add to current worker worker */
 				unsigned int idx = bl->count++;
@@ -490,9 +660,7 @@ rte_distributor_returned_pkts(struct rte_distributor *d,
 		struct rte_mbuf **mbufs, unsigned int max_mbufs)
 {
 	struct rte_distributor_returned_pkts *returns = &d->returns;
-	unsigned int retval = (max_mbufs < returns->count) ?
-			max_mbufs : returns->count;
-	unsigned int i;
+	unsigned int retval, i, wkr;
 
 	if (d->alg_type == RTE_DIST_ALG_SINGLE) {
 		/* Call the old API */
@@ -500,6 +668,15 @@ rte_distributor_returned_pkts(struct rte_distributor *d,
 				mbufs, max_mbufs);
 	}
 
+	/*
+	 * With nothing else to hand back, take back the packets held by
+	 * workers, they may be waiting for work for a while.
+	 */
+	if ((d->flags & RTE_DISTRIB_F_RETURN_BATCH) && returns->count == 0)
+		for (wkr = 0; wkr < d->num_workers; wkr++)
+			handle_staged_returns(d, wkr);
+
+	retval = (max_mbufs < returns->count) ? max_mbufs : returns->count;
 	for (i = 0; i < retval; i++) {
 		unsigned int idx = (returns->start + i) &
 				RTE_DISTRIB_RETURNS_MASK;
@@ -557,7 +734,7 @@ rte_distributor_flush(struct rte_distributor *d)
 	rte_distributor_process(d, NULL, 0);
 
 	for (wkr = 0; wkr < d->num_workers; wkr++)
-		handle_returns(d, wkr);
+		handle_staged_returns(d, wkr);
 
 	return flushed;
 }
@@ -581,6 +758,46 @@ rte_distributor_clear_returns(struct rte_distributor *d)
 				__ATOMIC_RELEASE);
 }
 
+int
+rte_distributor_configure(struct rte_distributor *d,
+		const struct rte_distributor_conf *conf)
+{
+	unsigned int burst_size;
+	uint32_t *flow_table = NULL;
+
+	if (d == NULL || conf == NULL)
+		return -EINVAL;
+	if (d->alg_type == RTE_DIST_ALG_SINGLE)
+		return -ENOTSUP;
+
+	burst_size = conf->burst_size ? conf->burst_size : RTE_DIST_BURST_SIZE;
+	if (burst_size > RTE_DIST_BURST_SIZE)
+		return -EINVAL;
+	/* tags carry 15 significant bits */
+	if (conf->flow_table_size > (1u << 15) ||
+			(conf->flow_table_size != 0 &&
+			 !rte_is_power_of_2(conf->flow_table_size)))
+		return -EINVAL;
+	if (conf->flags & ~RTE_DISTRIB_F_RETURN_BATCH)
+		return -EINVAL;
+
+	if (conf->flow_table_size != 0) {
+		flow_table = rte_zmalloc_socket("DIST_FLOW_TABLE",
+				conf->flow_table_size * sizeof(*flow_table),
+				RTE_CACHE_LINE_SIZE, d->socket_id);
+		if (flow_table == NULL)
+			return -ENOMEM;
+	}
+
+	rte_free(d->flow_table);
+	d->flow_table = flow_table;
+	d->flow_table_mask = conf->flow_table_size - 1;
+	d->burst_size = burst_size;
+	d->flags = conf->flags;
+
+	return 0;
+}
+
 /* creates a distributor instance */
 struct rte_distributor *
 rte_distributor_create(const char *name,
@@ -599,6 +816,7 @@ rte_distributor_create(const char *name,
 	/* compilation-time checks */
 	RTE_BUILD_BUG_ON((sizeof(*d) & RTE_CACHE_LINE_MASK) != 0);
 	RTE_BUILD_BUG_ON((RTE_DISTRIB_MAX_WORKERS & 7) != 0);
+	RTE_BUILD_BUG_ON(RTE_DISTRIB_MAX_BURST_SIZE != RTE_DIST_BURST_SIZE);
 
 	if (name == NULL || num_workers >=
 		(unsigned int)RTE_MIN(RTE_DISTRIB_MAX_WORKERS, RTE_MAX_LCORE)) {
@@ -634,6 +852,10 @@ rte_distributor_create(const char *name,
 	strlcpy(d->name, name, sizeof(d->name));
 	d->num_workers = num_workers;
 	d->alg_type = alg_type;
+	d->socket_id = socket_id;
+	d->burst_size = RTE_DIST_BURST_SIZE;
+	d->flags = 0;
+	d->flow_table = NULL;
 
 	d->dist_match_fn = RTE_DIST_MATCH_SCALAR;
 #if defined(RTE_ARCH_X86)
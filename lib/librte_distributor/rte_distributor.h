@@ -13,6 +13,10 @@
  * one-at-a-time to workers, with dynamic load balancing.
  */
 
+#include <stdint.h>
+
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -27,6 +31,29 @@ enum rte_distributor_alg_type {
 struct rte_distributor;
 struct rte_mbuf;
 
+/** Maximum number of packets passed to a worker at a time. */
+#define RTE_DISTRIB_MAX_BURST_SIZE 8
+
+/**
+ * Let workers hold back returned packets until they have a full burst of
+ * them, or have nothing new to return, instead of handing them back to the
+ * distributor on every request.
+ */
+#define RTE_DISTRIB_F_RETURN_BATCH (1u << 0)
+
+/** Tuning of a burst distributor, see rte_distributor_configure(). */
+struct rte_distributor_conf {
+	unsigned int burst_size;
+	/**< Packets sent to a worker at a time, 1 to
+	 * RTE_DISTRIB_MAX_BURST_SIZE. 0 keeps RTE_DISTRIB_MAX_BURST_SIZE.
+	 */
+	unsigned int flow_table_size;
+	/**< Entries in the flow affinity table, a power of 2 up to 32768,
+	 * or 0 to disable it.
+	 */
+	uint32_t flags; /**< RTE_DISTRIB_F_* flags. */
+};
+
 /**
  * Function to create a new distributor instance
  *
@@ -52,6 +79,37 @@ rte_distributor_create(const char *name, unsigned int socket_id,
 		unsigned int num_workers,
 		unsigned int alg_type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Tune a burst distributor instance.
+ *
+ * Must be called before the first packet is processed, or after the
+ * instance has been flushed with all workers stopped.
+ *
+ * With a flow affinity table, the distributor remembers the worker each
+ * flow tag was last sent to, and sends further packets of the flow to
+ * that worker without matching them against the in-flight tags of all
+ * workers. A flow stays on its worker until its table entry is taken by
+ * a colliding flow, or until the worker calls rte_distributor_return_pkt().
+ * Flows colliding in the table fall back to matching.
+ *
+ * @param d
+ *   The distributor instance, created with RTE_DIST_ALG_BURST.
+ * @param conf
+ *   The new configuration.
+ * @return
+ *   - 0 on success
+ *   - -EINVAL if a parameter is invalid
+ *   - -ENOTSUP for an RTE_DIST_ALG_SINGLE instance
+ *   - -ENOMEM if the flow affinity table cannot be allocated
+ */
+__rte_experimental
+int
+rte_distributor_configure(struct rte_distributor *d,
+		const struct rte_distributor_conf *conf);
+
 /*  *** APIS to be called on the distributor lcore ***  */
 /*
  * The following APIs are the public APIs which are designed for use on a
@@ -9,7 +9,16 @@
 #include <inttypes.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <sys/queue.h>
+#include <sys/stat.h>
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+#include <numa.h>
+#include <numaif.h>
+#endif
 
 #include <rte_log.h>
 #include <rte_memory.h>
@@ -19,11 +28,14 @@
 #include <rte_errno.h>
 #include <rte_string_fns.h>
 #include <rte_common.h>
+#include <rte_spinlock.h>
 
 #include "malloc_heap.h"
 #include "malloc_elem.h"
 #include "eal_private.h"
 #include "eal_memcfg.h"
+#include "eal_internal_cfg.h"
+#include "eal_filesystem.h"
 
 static inline const struct rte_memzone *
 memzone_lookup_thread_unsafe(const char *name)
@@ -241,6 +253,542 @@ rte_memzone_reserve(const char *name, size_t len, int socket_id,
 					       flags, RTE_CACHE_LINE_SIZE, 0);
 }
 
+#define MEMZONE_PERSIST_MAGIC 0x31305a4d54535250ULL /* "PRSTMZ01" */
+#define MEMZONE_PERSIST_MAX_TRIES 16
+
+/*
+ * Header of a persistent memzone file, stored at the end of the mapping
+ * right after the memzone data so that no extra page is needed for it.
+ */
+struct memzone_persist_hdr {
+	uint64_t magic;
+	uint64_t va;        /**< Virtual address of the mapping. */
+	uint64_t len;       /**< Length of the memzone. */
+	uint64_t page_sz;   /**< Page size of the file. */
+	uint32_t version;   /**< Application version of the content. */
+	uint32_t committed; /**< Content was committed by its owner. */
+	int32_t socket_id;  /**< Socket requested at creation. */
+	uint32_t reserved;
+};
+
+static size_t
+memzone_persist_map_len(size_t len, uint64_t page_sz)
+{
+	return RTE_ALIGN_CEIL(len + sizeof(struct memzone_persist_hdr),
+			page_sz);
+}
+
+static struct memzone_persist_hdr *
+memzone_persist_get_hdr(void *addr, size_t map_len)
+{
+	return RTE_PTR_ADD(addr,
+			map_len - sizeof(struct memzone_persist_hdr));
+}
+
+static uint64_t
+memzone_flags_to_pgsz(unsigned int flags)
+{
+	if (flags & RTE_MEMZONE_256KB)
+		return RTE_PGSIZE_256K;
+	if (flags & RTE_MEMZONE_2MB)
+		return RTE_PGSIZE_2M;
+	if (flags & RTE_MEMZONE_16MB)
+		return RTE_PGSIZE_16M;
+	if (flags & RTE_MEMZONE_256MB)
+		return RTE_PGSIZE_256M;
+	if (flags & RTE_MEMZONE_512MB)
+		return RTE_PGSIZE_512M;
+	if (flags & RTE_MEMZONE_1GB)
+		return RTE_PGSIZE_1G;
+	if (flags & RTE_MEMZONE_4GB)
+		return RTE_PGSIZE_4G;
+	if (flags & RTE_MEMZONE_16GB)
+		return RTE_PGSIZE_16G;
+	return 0;
+}
+
+/* Directory holding the files of persistent memzones of a page size */
+static void
+memzone_persist_dir(const struct hugepage_info *hpi, char *dir, size_t len)
+{
+	snprintf(dir, len, "%s/%s_persist",
+		hpi != NULL ? hpi->hugedir : rte_eal_get_runtime_dir(),
+		eal_get_hugefile_prefix());
+}
+
+/* Select the directory and page size of a new persistent memzone */
+static int
+memzone_persist_location(unsigned int flags, char *dir, size_t len,
+		uint64_t *page_sz)
+{
+	const struct hugepage_info *hpi = NULL;
+	uint64_t req_sz = memzone_flags_to_pgsz(flags);
+	unsigned int i;
+
+	if (internal_config.in_memory)
+		return -ENOTSUP;
+
+	if (internal_config.no_hugetlbfs) {
+		memzone_persist_dir(NULL, dir, len);
+		*page_sz = sysconf(_SC_PAGESIZE);
+		return 0;
+	}
+
+	/* hugepage sizes are sorted largest first */
+	for (i = 0; i < internal_config.num_hugepage_sizes; i++) {
+		if (req_sz == 0 ||
+				internal_config.hugepage_info[i].hugepage_sz ==
+				req_sz) {
+			hpi = &internal_config.hugepage_info[i];
+			break;
+		}
+	}
+	if (hpi == NULL && (flags & RTE_MEMZONE_SIZE_HINT_ONLY) &&
+			internal_config.num_hugepage_sizes > 0)
+		hpi = &internal_config.hugepage_info[0];
+	if (hpi == NULL)
+		return -EINVAL;
+	if (hpi->hugedir[0] == '\0')
+		return -ENOTSUP;
+
+	memzone_persist_dir(hpi, dir, len);
+	*page_sz = hpi->hugepage_sz;
+	return 0;
+}
+
+/* Read the header of a persistent memzone file, return its mapping length */
+static ssize_t
+memzone_persist_read_hdr(int fd, struct memzone_persist_hdr *hdr)
+{
+	struct stat st;
+
+	if (fstat(fd, &st) < 0 ||
+			(size_t)st.st_size < sizeof(*hdr) ||
+			pread(fd, hdr, sizeof(*hdr),
+				st.st_size - sizeof(*hdr)) != sizeof(*hdr) ||
+			hdr->magic != MEMZONE_PERSIST_MAGIC ||
+			memzone_persist_map_len(hdr->len, hdr->page_sz) !=
+				(size_t)st.st_size)
+		return -1;
+	return st.st_size;
+}
+
+/*
+ * Return the end of the area of another persistent memzone that overlaps
+ * [addr, addr + len), so new memzones do not take the address that a
+ * memzone not reattached yet will need.
+ */
+static void *
+memzone_persist_overlap(const char *dir, const char *name, void *addr,
+		size_t len)
+{
+	struct memzone_persist_hdr hdr;
+	struct dirent *dirent;
+	void *end = NULL;
+	ssize_t map_len;
+	DIR *d;
+	int fd;
+
+	d = opendir(dir);
+	if (d == NULL)
+		return NULL;
+
+	while (end == NULL && (dirent = readdir(d)) != NULL) {
+		if (dirent->d_name[0] == '.' ||
+				strcmp(dirent->d_name, name) == 0)
+			continue;
+		fd = openat(dirfd(d), dirent->d_name, O_RDONLY);
+		if (fd < 0)
+			continue;
+		map_len = memzone_persist_read_hdr(fd, &hdr);
+		close(fd);
+		if (map_len < 0)
+			continue;
+		if (hdr.va < (uintptr_t)addr + len &&
+				(uintptr_t)addr < hdr.va + map_len)
+			end = (void *)(uintptr_t)(hdr.va + map_len);
+	}
+	closedir(d);
+
+	return end;
+}
+
+/* Map a persistent memzone file at the requested address */
+static void *
+memzone_persist_mmap(int fd, void *va, size_t map_len, uint64_t page_sz,
+		int va_flags)
+{
+	int mmap_flags = MAP_SHARED | MAP_FIXED;
+	size_t size = map_len;
+	void *addr;
+
+#ifdef MAP_POPULATE
+	mmap_flags |= MAP_POPULATE;
+#endif
+	/* reserve the area first, this checks the requested address */
+	addr = eal_get_virtual_area(va, &size, page_sz, va_flags, 0);
+	if (addr == NULL)
+		return NULL;
+
+	if (mmap(addr, map_len, PROT_READ | PROT_WRITE, mmap_flags,
+			fd, 0) == MAP_FAILED) {
+		rte_errno = errno;
+		munmap(addr, map_len);
+		return NULL;
+	}
+	return addr;
+}
+
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+/* Prefer the requested socket for the pages faulted in by new mappings */
+static struct bitmask *
+memzone_persist_set_numa(int socket_id, int *oldpolicy)
+{
+	struct bitmask *oldmask;
+
+	if (socket_id == SOCKET_ID_ANY || numa_available() != 0)
+		return NULL;
+
+	oldmask = numa_allocate_nodemask();
+	if (get_mempolicy(oldpolicy, oldmask->maskp,
+			oldmask->size + 1, 0, 0) < 0)
+		*oldpolicy = MPOL_DEFAULT;
+	numa_set_preferred(socket_id);
+	return oldmask;
+}
+
+static void
+memzone_persist_restore_numa(struct bitmask *oldmask, int oldpolicy)
+{
+	if (oldmask == NULL)
+		return;
+	if (oldpolicy == MPOL_DEFAULT ||
+			set_mempolicy(oldpolicy, oldmask->maskp,
+				oldmask->size + 1) < 0)
+		numa_set_localalloc();
+	numa_free_nodemask(oldmask);
+}
+#endif
+
+/* Reset a persistent memzone file and map it at a free address */
+static void *
+memzone_persist_create(int fd, const char *dir, const char *name,
+		size_t map_len, uint64_t page_sz, int socket_id)
+{
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+	struct bitmask *oldmask;
+	int oldpolicy;
+#endif
+	void *addr, *end;
+	unsigned int try;
+
+	if (ftruncate(fd, 0) < 0 || ftruncate(fd, map_len) < 0) {
+		RTE_LOG(ERR, EAL, "%s(): cannot resize memzone <%s> file: %s\n",
+			__func__, name, strerror(errno));
+		rte_errno = errno;
+		return NULL;
+	}
+
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+	oldmask = memzone_persist_set_numa(socket_id, &oldpolicy);
+#else
+	RTE_SET_USED(socket_id);
+#endif
+	addr = memzone_persist_mmap(fd, NULL, map_len, page_sz, 0);
+	for (try = 0; addr != NULL && try < MEMZONE_PERSIST_MAX_TRIES; try++) {
+		end = memzone_persist_overlap(dir, name, addr, map_len);
+		if (end == NULL)
+			break;
+		munmap(addr, map_len);
+		addr = memzone_persist_mmap(fd, end, map_len, page_sz,
+				EAL_VIRTUAL_AREA_ADDR_IS_HINT);
+	}
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+	memzone_persist_restore_numa(oldmask, oldpolicy);
+#endif
+	if (addr == NULL || try == MEMZONE_PERSIST_MAX_TRIES) {
+		if (addr != NULL)
+			munmap(addr, map_len);
+		RTE_LOG(ERR, EAL, "%s(): cannot map memzone <%s>\n",
+			__func__, name);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	return addr;
+}
+
+static void *
+memzone_persist_map(const char *dir, const char *name, size_t len,
+		uint64_t page_sz, int socket_id, uint32_t version, int *state)
+{
+	size_t map_len = memzone_persist_map_len(len, page_sz);
+	struct memzone_persist_hdr hdr, *mz_hdr;
+	char path[PATH_MAX];
+	void *addr = NULL;
+	int fd;
+
+	if (mkdir(dir, 0700) < 0 && errno != EEXIST) {
+		RTE_LOG(ERR, EAL, "%s(): cannot create %s: %s\n",
+			__func__, dir, strerror(errno));
+		rte_errno = errno;
+		return NULL;
+	}
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+	fd = open(path, O_CREAT | O_RDWR, 0600);
+	if (fd < 0) {
+		RTE_LOG(ERR, EAL, "%s(): cannot open %s: %s\n",
+			__func__, path, strerror(errno));
+		rte_errno = errno;
+		return NULL;
+	}
+
+	if (memzone_persist_read_hdr(fd, &hdr) == (ssize_t)map_len &&
+			hdr.len == len && hdr.page_sz == page_sz &&
+			hdr.version == version && hdr.committed &&
+			(socket_id == SOCKET_ID_ANY ||
+				hdr.socket_id == socket_id)) {
+		addr = memzone_persist_mmap(fd, (void *)(uintptr_t)hdr.va,
+				map_len, page_sz, 0);
+		/* pointers in the content are only valid at that address */
+		if (addr == NULL)
+			RTE_LOG(WARNING, EAL, "%s(): cannot remap memzone <%s> at %p, recreating it\n",
+				__func__, name, (void *)(uintptr_t)hdr.va);
+		else
+			*state = RTE_MEMZONE_PERSIST_ATTACHED;
+	}
+
+	if (addr == NULL) {
+		/* discard stale, uncommitted or unreachable content */
+		addr = memzone_persist_create(fd, dir, name, map_len, page_sz,
+				socket_id);
+		if (addr == NULL) {
+			close(fd);
+			return NULL;
+		}
+
+		memset(&hdr, 0, sizeof(hdr));
+		hdr.magic = MEMZONE_PERSIST_MAGIC;
+		hdr.va = (uintptr_t)addr;
+		hdr.len = len;
+		hdr.page_sz = page_sz;
+		hdr.version = version;
+		hdr.socket_id = socket_id;
+		memcpy(memzone_persist_get_hdr(addr, map_len), &hdr,
+			sizeof(hdr));
+		*state = RTE_MEMZONE_PERSIST_CREATED;
+	}
+
+	/* content may change until it is committed again */
+	mz_hdr = memzone_persist_get_hdr(addr, map_len);
+	__atomic_store_n(&mz_hdr->committed, 0, __ATOMIC_RELEASE);
+
+	close(fd);
+	return addr;
+}
+
+static void
+memzone_persist_unmap(void *addr, size_t len, uint64_t page_sz)
+{
+	size_t map_len = memzone_persist_map_len(len, page_sz);
+
+	rte_extmem_unregister(addr, map_len);
+	munmap(addr, map_len);
+}
+
+/*
+ * Persistent memzones are mapped by the primary process only, secondary
+ * processes map them when looking them up. Addresses mapped by this
+ * process, per memzone index.
+ */
+static void *memzone_persist_attached[RTE_MAX_MEMZONE];
+static rte_spinlock_t memzone_persist_attach_lock = RTE_SPINLOCK_INITIALIZER;
+
+/* Map in a secondary process a persistent memzone of the primary */
+static int
+memzone_persist_attach(const struct rte_memzone *mz, unsigned int idx)
+{
+	size_t map_len = memzone_persist_map_len(mz->len, mz->hugepage_sz);
+	const struct hugepage_info *hpi = NULL;
+	struct memzone_persist_hdr hdr;
+	char dir[PATH_MAX], path[PATH_MAX];
+	void *addr;
+	unsigned int i;
+	int fd, ret = 0;
+
+	rte_spinlock_lock(&memzone_persist_attach_lock);
+	if (memzone_persist_attached[idx] == mz->addr)
+		goto unlock;
+
+	for (i = 0; i < internal_config.num_hugepage_sizes; i++) {
+		if (internal_config.hugepage_info[i].hugepage_sz ==
+				mz->hugepage_sz) {
+			hpi = &internal_config.hugepage_info[i];
+			break;
+		}
+	}
+	memzone_persist_dir(hpi, dir, sizeof(dir));
+	snprintf(path, sizeof(path), "%s/%s", dir, mz->name);
+
+	fd = open(path, O_RDWR);
+	if (fd < 0) {
+		ret = -errno;
+		goto unlock;
+	}
+	/* the file must be the one the primary mapped */
+	if (memzone_persist_read_hdr(fd, &hdr) != (ssize_t)map_len ||
+			hdr.va != (uintptr_t)mz->addr) {
+		close(fd);
+		ret = -ENOENT;
+		goto unlock;
+	}
+	addr = memzone_persist_mmap(fd, mz->addr, map_len, mz->hugepage_sz,
+			0);
+	close(fd);
+	if (addr == NULL) {
+		ret = -EADDRNOTAVAIL;
+		goto unlock;
+	}
+	if (rte_extmem_attach(addr, map_len) < 0) {
+		ret = -rte_errno;
+		munmap(addr, map_len);
+		goto unlock;
+	}
+	memzone_persist_attached[idx] = addr;
+unlock:
+	rte_spinlock_unlock(&memzone_persist_attach_lock);
+	if (ret < 0)
+		RTE_LOG(ERR, EAL, "%s(): cannot map memzone <%s> at %p: %s\n",
+			__func__, mz->name, mz->addr, strerror(-ret));
+	return ret;
+}
+
+const struct rte_memzone *
+rte_memzone_reserve_persistent(const char *name, size_t len, int socket_id,
+		unsigned int flags, uint32_t version, int *state)
+{
+	struct rte_mem_config *mcfg;
+	struct rte_memzone *mz;
+	struct rte_fbarray *arr;
+	char dir[PATH_MAX];
+	uint64_t page_sz;
+	size_t map_len;
+	void *addr;
+	int mz_idx;
+	int ret;
+
+	if (name == NULL || len == 0 || state == NULL ||
+			strchr(name, '/') != NULL || name[0] == '.' ||
+			(socket_id != SOCKET_ID_ANY &&
+			(socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES))) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	if (strlen(name) > sizeof(mz->name) - 1) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY) {
+		rte_errno = E_RTE_SECONDARY;
+		return NULL;
+	}
+
+	ret = memzone_persist_location(flags, dir, sizeof(dir), &page_sz);
+	if (ret < 0) {
+		rte_errno = -ret;
+		return NULL;
+	}
+	map_len = memzone_persist_map_len(len, page_sz);
+
+	mcfg = rte_eal_get_configuration()->mem_config;
+	arr = &mcfg->memzones;
+
+	rte_rwlock_write_lock(&mcfg->mlock);
+
+	mz = NULL;
+	if (memzone_lookup_thread_unsafe(name) != NULL) {
+		rte_errno = EEXIST;
+		goto unlock;
+	}
+	mz_idx = rte_fbarray_find_next_free(arr, 0);
+	if (mz_idx < 0) {
+		rte_errno = ENOSPC;
+		goto unlock;
+	}
+
+	addr = memzone_persist_map(dir, name, len, page_sz, socket_id, version,
+			state);
+	if (addr == NULL)
+		goto unlock;
+	if (rte_extmem_register(addr, map_len, NULL, 0, page_sz) < 0) {
+		munmap(addr, map_len);
+		goto unlock;
+	}
+
+	rte_fbarray_set_used(arr, mz_idx);
+	mz = rte_fbarray_get(arr, mz_idx);
+	strlcpy(mz->name, name, sizeof(mz->name));
+	mz->iova = rte_eal_iova_mode() == RTE_IOVA_VA ?
+			(uintptr_t)addr : RTE_BAD_IOVA;
+	mz->addr = addr;
+	mz->len = len;
+	mz->hugepage_sz = page_sz;
+	mz->socket_id = memzone_persist_get_hdr(addr, map_len)->socket_id;
+	mz->flags = RTE_MEMZONE_PERSISTENT;
+
+	RTE_LOG(DEBUG, EAL, "%s(): memzone <%s> %s at %p\n", __func__, name,
+		*state == RTE_MEMZONE_PERSIST_ATTACHED ?
+			"reattached" : "created", addr);
+unlock:
+	rte_rwlock_write_unlock(&mcfg->mlock);
+
+	return mz;
+}
+
+int
+rte_memzone_persist_commit(const struct rte_memzone *mz)
+{
+	struct memzone_persist_hdr *hdr;
+
+	if (mz == NULL || (mz->flags & RTE_MEMZONE_PERSISTENT) == 0)
+		return -EINVAL;
+
+	hdr = memzone_persist_get_hdr(mz->addr,
+			memzone_persist_map_len(mz->len, mz->hugepage_sz));
+	/* make all content stores visible before the commit flag */
+	__atomic_store_n(&hdr->committed, 1, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+int
+rte_memzone_persist_remove(const char *name)
+{
+	char dir[PATH_MAX], path[PATH_MAX];
+	int ret = -ENOENT;
+	unsigned int i;
+
+	if (name == NULL || strchr(name, '/') != NULL || name[0] == '.')
+		return -EINVAL;
+
+	if (internal_config.no_hugetlbfs) {
+		memzone_persist_dir(NULL, dir, sizeof(dir));
+		snprintf(path, sizeof(path), "%s/%s", dir, name);
+		if (unlink(path) == 0)
+			ret = 0;
+	}
+	for (i = 0; i < internal_config.num_hugepage_sizes; i++) {
+		memzone_persist_dir(&internal_config.hugepage_info[i],
+				dir, sizeof(dir));
+		snprintf(path, sizeof(path), "%s/%s", dir, name);
+		if (unlink(path) == 0)
+			ret = 0;
+	}
+
+	return ret;
+}
+
 int
 rte_memzone_free(const struct rte_memzone *mz)
 {
@@ -249,6 +797,9 @@ rte_memzone_free(const struct rte_memzone *mz)
 	struct rte_memzone *found_mz;
 	int ret = 0;
 	void *addr = NULL;
+	bool persistent = false;
+	uint64_t page_sz = 0;
+	size_t len = 0;
 	unsigned idx;
 
 	if (mz == NULL)
@@ -269,14 +820,27 @@ rte_memzone_free(const struct rte_memzone *mz)
 		ret = -EINVAL;
 	} else {
 		addr = found_mz->addr;
+		persistent = (found_mz->flags & RTE_MEMZONE_PERSISTENT) != 0;
+		if (persistent) {
+			rte_spinlock_lock(&memzone_persist_attach_lock);
+			memzone_persist_attached[idx] = NULL;
+			rte_spinlock_unlock(&memzone_persist_attach_lock);
+		}
+		len = found_mz->len;
+		page_sz = found_mz->hugepage_sz;
 		memset(found_mz, 0, sizeof(*found_mz));
 		rte_fbarray_set_free(arr, idx);
 	}
 
 	rte_rwlock_write_unlock(&mcfg->mlock);
 
-	if (addr != NULL)
-		rte_free(addr);
+	/* not through the lcore caches of rte_free(), the memzone memory
+	 * goes back to the heap
+	 */
+	if (addr != NULL && persistent)
+		memzone_persist_unmap(addr, len, page_sz);
+	else if (addr != NULL)
+		malloc_heap_free(malloc_elem_from_data(addr));
 
 	return ret;
 }
@@ -289,6 +853,7 @@ rte_memzone_lookup(const char *name)
 {
 	struct rte_mem_config *mcfg;
 	const struct rte_memzone *memzone = NULL;
+	int ret;
 
 	mcfg = rte_eal_get_configuration()->mem_config;
 
@@ -296,6 +861,16 @@ rte_memzone_lookup(const char *name)
 
 	memzone = memzone_lookup_thread_unsafe(name);
 
+	if (memzone != NULL && (memzone->flags & RTE_MEMZONE_PERSISTENT) &&
+			rte_eal_process_type() != RTE_PROC_PRIMARY) {
+		ret = memzone_persist_attach(memzone,
+				rte_fbarray_find_idx(&mcfg->memzones, memzone));
+		if (ret < 0) {
+			rte_errno = -ret;
+			memzone = NULL;
+		}
+	}
+
 	rte_rwlock_read_unlock(&mcfg->mlock);
 
 	return memzone;
@@ -32,6 +32,32 @@ struct rte_malloc_socket_stats {
 	size_t heap_allocsz_bytes; /**< Total allocated bytes on heap */
 };
 
+/** Number of buckets of the free block size histogram of a heap. */
+#define RTE_MALLOC_FRAG_HIST_BUCKETS 16
+
+/**
+ * Structure to hold heap fragmentation statistics obtained from
+ * rte_malloc_get_socket_frag_stats function.
+ */
+struct rte_malloc_socket_frag_stats {
+	size_t heap_freesz_bytes;  /**< Total free bytes on heap */
+	size_t greatest_free_size; /**< Size in bytes of largest free block */
+	unsigned int free_count;   /**< Number of free elements on heap */
+	/**
+	 * Share of the free bytes outside of the largest free block,
+	 * in percent: 0 when all free memory is contiguous.
+	 */
+	unsigned int fragmentation;
+	/**
+	 * Number of free elements by size: bucket i counts the elements of
+	 * [64 << i, 64 << (i + 1)) bytes, the last one all larger elements.
+	 */
+	unsigned int free_hist[RTE_MALLOC_FRAG_HIST_BUCKETS];
+	/** Number of elements held in the lcore caches of this process */
+	unsigned int cached_count;
+	size_t cached_bytes; /**< Total bytes held in the lcore caches */
+};
+
 /**
  * This function allocates memory from the huge-page area of memory. The memory
  * is not cleared. In NUMA systems, the memory allocated resides on the same
@@ -492,6 +518,66 @@ __rte_experimental
 int
 rte_malloc_heap_socket_is_external(int socket_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get fragmentation statistics of the heap on a given socket.
+ *
+ * @param socket
+ *   Socket ID to get the statistics of
+ * @param frag_stats
+ *   Structure filled with the fragmentation statistics of the heap
+ * @return
+ *   0 on success, -1 if the socket ID is invalid
+ */
+__rte_experimental
+int
+rte_malloc_get_socket_frag_stats(int socket,
+		struct rte_malloc_socket_frag_stats *frag_stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enable or disable the per-lcore caches of small allocations.
+ *
+ * When enabled, the allocations of up to 2048 bytes and no more than
+ * cacheline alignment made by an EAL thread on its local socket are served
+ * from size classes of power-of-two sizes, cached per lcore. Freeing such
+ * an allocation from an EAL thread of the same socket puts it back in the
+ * cache of that thread, without taking the heap lock. The caches are refilled
+ * from, and flushed to, the heap in bulk.
+ *
+ * Memory held in the caches is still accounted as allocated in the heap
+ * statistics.
+ *
+ * @note The caches are private to each process. Before disabling them,
+ *   or before an lcore stops allocating memory, its cache should be
+ *   returned to the heap with ``rte_malloc_lcore_cache_flush()``.
+ *
+ * @param enable
+ *   Non-zero to enable the caches, zero to disable them
+ * @return
+ *   0 on success
+ *   -1 on error, with rte_errno set to ENOTSUP if the caches are not
+ *   available, which is the case with RTE_MALLOC_DEBUG
+ */
+__rte_experimental
+int
+rte_malloc_lcore_cache_enable(int enable);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Return all the allocations held in the cache of the calling lcore
+ * to their heap.
+ */
+__rte_experimental
+void
+rte_malloc_lcore_cache_flush(void);
+
 /**
  * Dump statistics.
  *
@@ -41,6 +41,12 @@ extern "C" {
 #define RTE_MEMZONE_4GB            0x00080000   /**< Use 4GB pages. */
 #define RTE_MEMZONE_SIZE_HINT_ONLY 0x00000004   /**< Use available page size */
 #define RTE_MEMZONE_IOVA_CONTIG    0x00100000   /**< Ask for IOVA-contiguous memzone. */
+#define RTE_MEMZONE_PERSISTENT     0x00200000   /**< Backed by a persistent file. */
+
+/** Persistent memzone was created, its content must be initialized. */
+#define RTE_MEMZONE_PERSIST_CREATED  0
+/** Persistent memzone was remapped with the content of a previous process. */
+#define RTE_MEMZONE_PERSIST_ATTACHED 1
 
 /**
  * A structure describing a memzone, which is a contiguous portion of
@@ -273,6 +279,8 @@ const struct rte_memzone *rte_memzone_reserve_bounded(const char *name,
 /**
  * Free a memzone.
  *
+ * Freeing a persistent memzone unmaps it but keeps its backing file.
+ *
  * @param mz
  *   A pointer to the memzone
  * @return
@@ -281,16 +289,114 @@ const struct rte_memzone *rte_memzone_reserve_bounded(const char *name,
  */
 int rte_memzone_free(const struct rte_memzone *mz);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reserve a memzone that survives the process.
+ *
+ * The memzone is backed by a file named after the memzone in a
+ * subdirectory of the hugetlbfs mount point, or of the runtime
+ * directory when hugepages are not used. If the file exists, was
+ * committed with rte_memzone_persist_commit() by its previous owner,
+ * and matches the requested length, page size, socket and version, it
+ * is remapped at the virtual address it had in the previous process so
+ * that pointers stored in the memzone stay valid. Otherwise, or if that
+ * address is no longer available, the file is reset and a new zeroed
+ * memzone is created.
+ *
+ * The content is considered modified as soon as the memzone is
+ * reserved: it must be committed again before the process exits for
+ * the next process to reattach it.
+ *
+ * The memzone is registered as external memory, it is not part of any
+ * malloc heap and has no IOVA unless the IOVA mode is VA. Secondary
+ * processes map it when looking it up with rte_memzone_lookup(). Use
+ * --base-virtaddr to make the virtual address layout reproducible
+ * between runs.
+ *
+ * @param name
+ *   The name of the memzone, also used as the file name.
+ * @param len
+ *   The size of the memory to be reserved, must not be 0.
+ * @param socket_id
+ *   The socket identifier in the case of NUMA. The value can be
+ *   SOCKET_ID_ANY if there is no NUMA constraint, the pages then follow
+ *   the NUMA policy of the calling thread. Otherwise the pages of a new
+ *   memzone are preferably taken from that socket.
+ * @param flags
+ *   Page size flags, as for rte_memzone_reserve(). The largest hugepage
+ *   size in use is taken if none is given.
+ * @param version
+ *   Version of the layout of the memzone content. A memzone is only
+ *   reattached by a process passing the same version.
+ * @param state
+ *   Set to RTE_MEMZONE_PERSIST_ATTACHED if the previous content was
+ *   reattached, RTE_MEMZONE_PERSIST_CREATED otherwise.
+ * @return
+ *   A pointer to a correctly-filled read-only memzone descriptor, or NULL
+ *   on error.
+ *   On error case, rte_errno will be set appropriately:
+ *    - E_RTE_SECONDARY - function was called from a secondary process instance
+ *    - ENOTSUP - persistent memory files are not available (in-memory mode)
+ *    - ENOSPC - the maximum number of memzones has already been allocated
+ *    - EEXIST - a memzone with the same name already exists
+ *    - EINVAL - invalid parameters
+ *    - other errno values on file or mapping errors
+ */
+__rte_experimental
+const struct rte_memzone *rte_memzone_reserve_persistent(const char *name,
+			size_t len, int socket_id, unsigned int flags,
+			uint32_t version, int *state);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Mark the content of a persistent memzone as consistent, so that it
+ * can be reattached by a later process.
+ *
+ * @param mz
+ *   A memzone reserved with rte_memzone_reserve_persistent().
+ * @return
+ *  -EINVAL - invalid parameter.
+ *  0 - success
+ */
+__rte_experimental
+int rte_memzone_persist_commit(const struct rte_memzone *mz);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Remove the backing file of a persistent memzone, of any page size.
+ * A memzone currently reserved stays valid until it is freed.
+ *
+ * @param name
+ *   The name of the memzone.
+ * @return
+ *  -EINVAL - invalid parameter.
+ *  -ENOENT - no such persistent memzone.
+ *  0 - success
+ */
+__rte_experimental
+int rte_memzone_persist_remove(const char *name);
+
 /**
  * Lookup for a memzone.
  *
  * Get a pointer to a descriptor of an already reserved memory
  * zone identified by the name given as an argument.
  *
+ * In a secondary process, a persistent memzone is mapped at the address
+ * it has in the primary process the first time it is looked up.
+ *
  * @param name
  *   The name of the memzone.
  * @return
- *   A pointer to a read-only memzone descriptor.
+ *   A pointer to a read-only memzone descriptor, or NULL if not found or
+ *   if a persistent memzone cannot be mapped in a secondary process, in
+ *   which case rte_errno is set.
  */
 const struct rte_memzone *rte_memzone_lookup(const char *name);
 
@@ -32,6 +32,7 @@ extern "C" {
 #include <sys/queue.h>
 
 #include <rte_config.h>
+#include <rte_compat.h>
 #include <rte_lcore.h>
 
 #define RTE_SERVICE_NAME_MAX 32
@@ -362,6 +363,16 @@ int32_t rte_service_dump(FILE *f, uint32_t id);
  */
 #define RTE_SERVICE_ATTR_CALL_COUNT 1
 
+/**
+ * Returns the weight of this service, see *rte_service_weight_set*.
+ */
+#define RTE_SERVICE_ATTR_WEIGHT 2
+
+/**
+ * Returns the cycle budget of this service, see *rte_service_budget_set*.
+ */
+#define RTE_SERVICE_ATTR_BUDGET 3
+
 /**
  * Get an attribute from a service.
  *
@@ -380,11 +391,110 @@ int32_t rte_service_attr_get(uint32_t id, uint32_t attr_id,
  */
 int32_t rte_service_attr_reset_all(uint32_t id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the weight of a service.
+ *
+ * On each loop of a service core, a service is invoked *weight* times in a
+ * row before the service core moves to the next mapped service. The default
+ * weight of a service is 1, which gives every mapped service the same share
+ * of the loop.
+ *
+ * @param id The id of the service.
+ * @param weight Number of invocations per loop, must be non-zero.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid service id or weight
+ */
+__rte_experimental
+int32_t rte_service_weight_set(uint32_t id, uint32_t weight);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the cycle budget of a service.
+ *
+ * When a budget is set, a service core stops the weighted invocations of the
+ * service for the current loop once the callbacks have consumed at least
+ * *cycles* TSC cycles, and moves to the next mapped service. A budget does
+ * not preempt a running callback.
+ *
+ * @param id The id of the service.
+ * @param cycles Cycle budget per loop, or zero to disable the budget.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid service id
+ */
+__rte_experimental
+int32_t rte_service_budget_set(uint32_t id, uint64_t cycles);
+
+/** Number of buckets of the service cycles histogram. */
+#define RTE_SERVICE_HIST_BUCKETS 32
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the histogram of the cycles consumed per invocation of a service.
+ *
+ * The histogram is collected when statistics are enabled for the service,
+ * see *rte_service_set_stats_enable*. Bucket 0 counts the invocations which
+ * took zero cycles, bucket *i* counts the invocations which took between
+ * 2^(i-1) and 2^i - 1 cycles, and the last bucket counts all the longer ones.
+ * It is reset by *rte_service_attr_reset_all*.
+ *
+ * @param id The id of the service.
+ * @param [out] hist Array filled with the histogram buckets.
+ * @param n The size of *hist*, up to RTE_SERVICE_HIST_BUCKETS.
+ * @retval >=0 Number of buckets written to *hist*
+ * @retval -EINVAL Invalid service id or NULL *hist*
+ */
+__rte_experimental
+int32_t rte_service_cycles_histogram_get(uint32_t id, uint64_t hist[],
+		uint32_t n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Move a service from one service core to another one at runtime.
+ *
+ * This allows the application to rebalance the services based on the load
+ * measured on the service cores, see RTE_SERVICE_LCORE_ATTR_CYCLES and
+ * RTE_SERVICE_ATTR_CYCLES.
+ *
+ * An MT safe service is mapped to the destination core before being
+ * unmapped from the source core. Otherwise the service is unmapped from the
+ * source core first, and the function waits for the source core to complete
+ * the loops which may still run it before mapping the service to the
+ * destination core, so that the service never runs concurrently on both
+ * cores.
+ *
+ * @param id The id of the service.
+ * @param src_lcore The service core currently running the service.
+ * @param dst_lcore The service core to run the service on.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid service id, or lcores which are not service cores
+ * @retval -ENOENT The service is not mapped to *src_lcore*
+ * @retval -EBUSY Called from the running *src_lcore* for an MT unsafe
+ *         service
+ */
+__rte_experimental
+int32_t rte_service_lcore_migrate(uint32_t id, uint32_t src_lcore,
+		uint32_t dst_lcore);
+
 /**
  * Returns the number of times the service runner has looped.
  */
 #define RTE_SERVICE_LCORE_ATTR_LOOPS 0
 
+/**
+ * Returns the number of cycles consumed by the services running on the
+ * service core, for the services with statistics enabled.
+ */
+#define RTE_SERVICE_LCORE_ATTR_CYCLES 1
+
 /**
  * Get an attribute from a service core.
  *
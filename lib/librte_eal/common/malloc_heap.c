@@ -252,6 +252,52 @@ heap_alloc(struct malloc_heap *heap, const char *type __rte_unused, size_t size,
 	return elem == NULL ? NULL : (void *)(&elem[1]);
 }
 
+/*
+ * Allocate up to n elements of the same size from the free memory of a heap,
+ * taking the heap lock only once. The heap is not expanded, so fewer elements,
+ * possibly none, are returned if there isn't enough free memory.
+ */
+unsigned int
+malloc_heap_alloc_bulk(struct malloc_heap *heap, size_t size, size_t align,
+		void **objs, unsigned int n)
+{
+	unsigned int i;
+
+	rte_spinlock_lock(&heap->lock);
+
+	for (i = 0; i < n; i++) {
+		objs[i] = heap_alloc(heap, NULL, size, 0, align, 0, false);
+		if (objs[i] == NULL)
+			break;
+	}
+
+	rte_spinlock_unlock(&heap->lock);
+
+	return i;
+}
+
+/*
+ * Free elements held in an lcore cache, taking the heap lock only once.
+ * Unlike malloc_heap_free(), no pages are returned to the system: the
+ * elements are small, their memory is left to later allocations.
+ */
+void
+malloc_heap_free_bulk(struct malloc_heap *heap, void **objs, unsigned int n)
+{
+	struct malloc_elem *elem;
+	unsigned int i;
+
+	rte_spinlock_lock(&heap->lock);
+
+	for (i = 0; i < n; i++) {
+		elem = malloc_elem_from_data(objs[i]);
+		elem->state = ELEM_FREE;
+		malloc_elem_free(elem);
+	}
+
+	rte_spinlock_unlock(&heap->lock);
+}
+
 static void *
 heap_alloc_biggest(struct malloc_heap *heap, const char *type __rte_unused,
 		unsigned int flags, size_t align, bool contig)
@@ -1052,6 +1098,50 @@ malloc_heap_get_stats(struct malloc_heap *heap,
 	return 0;
 }
 
+/*
+ * Function to retrieve fragmentation data for a given heap
+ */
+int
+malloc_heap_get_frag_stats(struct malloc_heap *heap,
+		struct rte_malloc_socket_frag_stats *frag_stats)
+{
+	size_t idx;
+	unsigned int bucket;
+	struct malloc_elem *elem;
+
+	memset(frag_stats, 0, sizeof(*frag_stats));
+
+	rte_spinlock_lock(&heap->lock);
+
+	for (idx = 0; idx < RTE_HEAP_NUM_FREELISTS; idx++) {
+		for (elem = LIST_FIRST(&heap->free_head[idx]);
+			!!elem; elem = LIST_NEXT(elem, free_list))
+		{
+			frag_stats->free_count++;
+			frag_stats->heap_freesz_bytes += elem->size;
+			if (elem->size > frag_stats->greatest_free_size)
+				frag_stats->greatest_free_size = elem->size;
+
+			/* bucket i holds sizes in [64 << i, 64 << (i + 1)) */
+			bucket = rte_fls_u64(elem->size >> 6);
+			bucket = bucket > 0 ? bucket - 1 : 0;
+			if (bucket >= RTE_MALLOC_FRAG_HIST_BUCKETS)
+				bucket = RTE_MALLOC_FRAG_HIST_BUCKETS - 1;
+			frag_stats->free_hist[bucket]++;
+		}
+	}
+
+	rte_spinlock_unlock(&heap->lock);
+
+	/* share of the free memory that can't serve the largest allocation */
+	if (frag_stats->heap_freesz_bytes != 0)
+		frag_stats->fragmentation = 100 -
+			(unsigned int)(frag_stats->greatest_free_size * 100 /
+				frag_stats->heap_freesz_bytes);
+
+	return 0;
+}
+
 /*
  * Function to retrieve data for a given heap
  */
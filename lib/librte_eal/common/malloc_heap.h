@@ -52,6 +52,13 @@ void *
 malloc_heap_alloc(const char *type, size_t size, int socket, unsigned int flags,
 		size_t align, size_t bound, bool contig);
 
+unsigned int
+malloc_heap_alloc_bulk(struct malloc_heap *heap, size_t size, size_t align,
+		void **objs, unsigned int n);
+
+void
+malloc_heap_free_bulk(struct malloc_heap *heap, void **objs, unsigned int n);
+
 void *
 malloc_heap_alloc_biggest(const char *type, int socket, unsigned int flags,
 		size_t align, bool contig);
@@ -91,6 +98,10 @@ int
 malloc_heap_get_stats(struct malloc_heap *heap,
 		struct rte_malloc_socket_stats *socket_stats);
 
+int
+malloc_heap_get_frag_stats(struct malloc_heap *heap,
+		struct rte_malloc_socket_frag_stats *frag_stats);
+
 void
 malloc_heap_dump(struct malloc_heap *heap, FILE *f);
 
@@ -28,26 +28,190 @@
 #include "eal_memcfg.h"
 #include "eal_private.h"
 
+/*
+ * Size classes of the lcore caches: powers of two from 64 bytes
+ * (1 << MALLOC_CACHE_MIN_SHIFT) to 2048 bytes.
+ */
+#define MALLOC_CACHE_MIN_SHIFT 6
+#define MALLOC_CACHE_NB_CLASSES 6
+#define MALLOC_CACHE_MAX_SIZE \
+	(1U << (MALLOC_CACHE_MIN_SHIFT + MALLOC_CACHE_NB_CLASSES - 1))
+
+/*
+ * Cache of small heap elements of an lcore. The cached elements stay
+ * allocated in the heap of the lcore's socket, in the ELEM_CACHED state
+ * so that they cannot be freed again, and are only handed out again to
+ * the same lcore, without taking the heap lock.
+ */
+struct malloc_lcore_cache {
+	struct malloc_heap *heap; /**< Heap of the lcore's socket */
+	unsigned int len[MALLOC_CACHE_NB_CLASSES];
+	void *objs[MALLOC_CACHE_NB_CLASSES][RTE_MALLOC_LCORE_CACHE_SIZE];
+} __rte_cache_aligned;
+
+static struct malloc_lcore_cache malloc_lcore_caches[RTE_MAX_LCORE];
+static int malloc_lcore_cache_enabled;
+
+static struct malloc_lcore_cache *
+malloc_lcore_cache_get_local(void)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *cache;
+	int heap_id;
+
+	if (!malloc_lcore_cache_enabled || lcore_id >= RTE_MAX_LCORE)
+		return NULL;
+
+	cache = &malloc_lcore_caches[lcore_id];
+	if (unlikely(cache->heap == NULL)) {
+		heap_id = malloc_socket_to_heap_id(malloc_get_numa_socket());
+		if (heap_id < 0)
+			return NULL;
+		cache->heap = &mcfg->malloc_heaps[heap_id];
+	}
+	return cache;
+}
+
+/* get a small element from the cache of the calling lcore */
+static void *
+malloc_lcore_cache_alloc(size_t size, unsigned int align, int socket)
+{
+	struct malloc_lcore_cache *cache;
+	unsigned int cls;
+	void **objs;
+	void *ptr;
+
+	if (size > MALLOC_CACHE_MAX_SIZE || align > RTE_CACHE_LINE_SIZE ||
+			(socket != SOCKET_ID_ANY && socket != (int)rte_socket_id()))
+		return NULL;
+
+	cache = malloc_lcore_cache_get_local();
+	if (cache == NULL)
+		return NULL;
+
+	cls = RTE_MAX(rte_log2_u32(size), (uint32_t)MALLOC_CACHE_MIN_SHIFT) -
+			MALLOC_CACHE_MIN_SHIFT;
+	objs = cache->objs[cls];
+
+	/* refill half of the cache from the memory already in the heap,
+	 * leaving the heap expansion to the regular allocation path
+	 */
+	if (cache->len[cls] == 0) {
+		cache->len[cls] = malloc_heap_alloc_bulk(cache->heap,
+				1U << (cls + MALLOC_CACHE_MIN_SHIFT),
+				RTE_CACHE_LINE_SIZE, objs,
+				RTE_MALLOC_LCORE_CACHE_SIZE / 2);
+		if (cache->len[cls] == 0)
+			return NULL;
+	}
+
+	ptr = objs[--cache->len[cls]];
+	malloc_elem_from_data(ptr)->state = ELEM_BUSY;
+	return ptr;
+}
+
+/* put a small element in the cache of the calling lcore, 0 on success */
+static int
+malloc_lcore_cache_free(struct malloc_elem *elem)
+{
+	struct malloc_lcore_cache *cache;
+	unsigned int cls, n;
+	size_t size;
+	void **objs;
+
+	cache = malloc_lcore_cache_get_local();
+	if (cache == NULL || elem == NULL || elem->heap != cache->heap ||
+			elem->state != ELEM_BUSY || elem->pad != 0)
+		return -1;
+
+	/* only elements of the exact size of a class can be cached */
+	size = elem->size - MALLOC_ELEM_OVERHEAD;
+	if (size > MALLOC_CACHE_MAX_SIZE || !rte_is_power_of_2(size) ||
+			size < (1U << MALLOC_CACHE_MIN_SHIFT))
+		return -1;
+
+	cls = rte_log2_u32(size) - MALLOC_CACHE_MIN_SHIFT;
+	objs = cache->objs[cls];
+
+	/* return the older half of a full cache to the heap */
+	if (cache->len[cls] == RTE_MALLOC_LCORE_CACHE_SIZE) {
+		n = RTE_MALLOC_LCORE_CACHE_SIZE / 2;
+		malloc_heap_free_bulk(cache->heap, objs, n);
+		cache->len[cls] -= n;
+		memmove(objs, &objs[n], cache->len[cls] * sizeof(objs[0]));
+	}
+
+	elem->state = ELEM_CACHED;
+	objs[cache->len[cls]++] = RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN);
+	return 0;
+}
+
+void
+rte_malloc_lcore_cache_flush(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *cache;
+	unsigned int cls;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return;
+
+	cache = &malloc_lcore_caches[lcore_id];
+	for (cls = 0; cls < MALLOC_CACHE_NB_CLASSES; cls++) {
+		if (cache->len[cls] == 0)
+			continue;
+		malloc_heap_free_bulk(cache->heap, cache->objs[cls],
+				cache->len[cls]);
+		cache->len[cls] = 0;
+	}
+}
+
+int
+rte_malloc_lcore_cache_enable(int enable)
+{
+#if defined(RTE_MALLOC_DEBUG) || RTE_MALLOC_LCORE_CACHE_SIZE < 2
+	/* freed elements must go through the heap to be checked */
+	if (enable) {
+		rte_errno = ENOTSUP;
+		return -1;
+	}
+#endif
+	malloc_lcore_cache_enabled = !!enable;
+	return 0;
+}
 
 /* Free the memory space back to heap */
 void rte_free(void *addr)
 {
+	struct malloc_elem *elem;
+
 	if (addr == NULL) return;
-	if (malloc_heap_free(malloc_elem_from_data(addr)) < 0)
+	elem = malloc_elem_from_data(addr);
+	if (malloc_lcore_cache_free(elem) == 0)
+		return;
+	if (malloc_heap_free(elem) < 0)
 		RTE_LOG(ERR, EAL, "Error: Invalid memory\n");
 }
 
-/*
- * Allocate memory on specified heap.
- */
-void *
-rte_malloc_socket(const char *type, size_t size, unsigned int align,
-		int socket_arg)
+static void *
+malloc_socket(const char *type, size_t size, unsigned int align,
+		int socket_arg, bool zero)
 {
+	void *ptr;
+
 	/* return NULL if size is 0 or alignment is not power-of-2 */
 	if (size == 0 || (align && !rte_is_power_of_2(align)))
 		return NULL;
 
+	ptr = malloc_lcore_cache_alloc(size, align, socket_arg);
+	if (ptr != NULL) {
+		/* unlike the heap, the caches don't clear freed memory */
+		if (zero)
+			memset(ptr, 0, size);
+		return ptr;
+	}
+
 	/* if there are no hugepages and if we are not allocating from an
 	 * external heap, use memory from any socket available. checking for
 	 * socket being external may return -1 in case of invalid socket, but
@@ -57,8 +221,29 @@ rte_malloc_socket(const char *type, size_t size, unsigned int align,
 				!rte_eal_has_hugepages())
 		socket_arg = SOCKET_ID_ANY;
 
-	return malloc_heap_alloc(type, size, socket_arg, 0,
+	ptr = malloc_heap_alloc(type, size, socket_arg, 0,
 			align == 0 ? 1 : align, 0, false);
+
+#ifdef RTE_MALLOC_DEBUG
+	/*
+	 * If DEBUG is enabled, then freed memory is marked with poison
+	 * value and set to zero on allocation.
+	 * If DEBUG is not enabled then  memory is already zeroed.
+	 */
+	if (zero && ptr != NULL)
+		memset(ptr, 0, size);
+#endif
+	return ptr;
+}
+
+/*
+ * Allocate memory on specified heap.
+ */
+void *
+rte_malloc_socket(const char *type, size_t size, unsigned int align,
+		int socket_arg)
+{
+	return malloc_socket(type, size, align, socket_arg, false);
 }
 
 /*
@@ -76,18 +261,7 @@ rte_malloc(const char *type, size_t size, unsigned align)
 void *
 rte_zmalloc_socket(const char *type, size_t size, unsigned align, int socket)
 {
-	void *ptr = rte_malloc_socket(type, size, align, socket);
-
-#ifdef RTE_MALLOC_DEBUG
-	/*
-	 * If DEBUG is enabled, then freed memory is marked with poison
-	 * value and set to zero on allocation.
-	 * If DEBUG is not enabled then  memory is already zeroed.
-	 */
-	if (ptr != NULL)
-		memset(ptr, 0, size);
-#endif
-	return ptr;
+	return malloc_socket(type, size, align, socket, true);
 }
 
 /*
@@ -196,6 +370,42 @@ rte_malloc_get_socket_stats(int socket,
 			socket_stats);
 }
 
+/*
+ * Function to retrieve fragmentation data for heap on given socket
+ */
+int
+rte_malloc_get_socket_frag_stats(int socket,
+		struct rte_malloc_socket_frag_stats *frag_stats)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct malloc_heap *heap;
+	unsigned int lcore_id, cls, len;
+	int heap_idx;
+
+	heap_idx = malloc_socket_to_heap_id(socket);
+	if (heap_idx < 0)
+		return -1;
+	heap = &mcfg->malloc_heaps[heap_idx];
+
+	malloc_heap_get_frag_stats(heap, frag_stats);
+
+	/* the caches of other lcores may change while they are read */
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		const struct malloc_lcore_cache *cache =
+				&malloc_lcore_caches[lcore_id];
+
+		if (cache->heap != heap)
+			continue;
+		for (cls = 0; cls < MALLOC_CACHE_NB_CLASSES; cls++) {
+			len = cache->len[cls];
+			frag_stats->cached_count += len;
+			frag_stats->cached_bytes +=
+				(size_t)len << (cls + MALLOC_CACHE_MIN_SHIFT);
+		}
+	}
+	return 0;
+}
+
 /*
  * Function to dump contents of all heaps
  */
@@ -281,12 +491,14 @@ rte_malloc_dump_stats(FILE *f, __rte_unused const char *type)
 	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
 	unsigned int heap_id;
 	struct rte_malloc_socket_stats sock_stats;
+	struct rte_malloc_socket_frag_stats frag_stats;
 
 	/* Iterate through all initialised heaps */
 	for (heap_id = 0; heap_id < RTE_MAX_HEAPS; heap_id++) {
 		struct malloc_heap *heap = &mcfg->malloc_heaps[heap_id];
 
 		malloc_heap_get_stats(heap, &sock_stats);
+		malloc_heap_get_frag_stats(heap, &frag_stats);
 
 		fprintf(f, "Heap id:%u\n", heap_id);
 		fprintf(f, "\tHeap name:%s\n", heap->name);
@@ -297,6 +509,7 @@ rte_malloc_dump_stats(FILE *f, __rte_unused const char *type)
 				sock_stats.greatest_free_size);
 		fprintf(f, "\tAlloc_count:%u,\n",sock_stats.alloc_count);
 		fprintf(f, "\tFree_count:%u,\n", sock_stats.free_count);
+		fprintf(f, "\tFragmentation:%u%%,\n", frag_stats.fragmentation);
 	}
 	return;
 }
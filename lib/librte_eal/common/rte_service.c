@@ -20,6 +20,7 @@
 #include <rte_atomic.h>
 #include <rte_memory.h>
 #include <rte_malloc.h>
+#include <rte_pause.h>
 
 #include "eal_private.h"
 
@@ -49,10 +50,15 @@ struct rte_service_spec_impl {
 	int8_t comp_runstate;
 	uint8_t internal_flags;
 
+	/* scheduling parameters */
+	uint32_t weight;
+	uint64_t budget;
+
 	/* per service statistics */
 	rte_atomic32_t num_mapped_cores;
 	uint64_t calls;
 	uint64_t cycles_spent;
+	uint64_t cycles_hist[RTE_SERVICE_HIST_BUCKETS];
 } __rte_cache_aligned;
 
 /* the internal values of a service core */
@@ -63,6 +69,7 @@ struct core_state {
 	uint8_t is_service_core; /* set if core is currently a service core */
 	uint8_t service_active_on_lcore[RTE_SERVICE_NUM_MAX];
 	uint64_t loops;
+	uint64_t cycles;
 	uint64_t calls_per_service[RTE_SERVICE_NUM_MAX];
 } __rte_cache_aligned;
 
@@ -255,6 +262,7 @@ rte_service_component_register(const struct rte_service_spec *spec,
 
 	struct rte_service_spec_impl *s = &rte_services[free_slot];
 	s->spec = *spec;
+	s->weight = 1;
 	s->internal_flags |= SERVICE_F_REGISTERED | SERVICE_F_START_CHECK;
 
 	rte_smp_wmb();
@@ -332,7 +340,17 @@ rte_service_runstate_get(uint32_t id)
 		(check_disabled | lcore_mapped);
 }
 
-static inline void
+/* histogram bucket of an invocation: log2 of the cycles it took */
+static inline uint32_t
+service_hist_bucket(uint64_t cycles)
+{
+	uint32_t bucket = rte_fls_u64(cycles);
+
+	return RTE_MIN(bucket, (uint32_t)RTE_SERVICE_HIST_BUCKETS - 1);
+}
+
+/* returns the cycles spent in the callback, or zero if not measured */
+static inline uint64_t
 rte_service_runner_do_callback(struct rte_service_spec_impl *s,
 			       struct core_state *cs, uint32_t service_idx)
 {
@@ -342,18 +360,46 @@ rte_service_runner_do_callback(struct rte_service_spec_impl *s,
 		uint64_t start = rte_rdtsc();
 		s->spec.callback(userdata);
 		uint64_t end = rte_rdtsc();
-		s->cycles_spent += end - start;
+		uint64_t cycles = end - start;
+		s->cycles_spent += cycles;
+		s->cycles_hist[service_hist_bucket(cycles)]++;
+		cs->cycles += cycles;
 		cs->calls_per_service[service_idx]++;
 		s->calls++;
-	} else
+		return cycles;
+	} else if (s->budget != 0) {
+		uint64_t start = rte_rdtsc();
 		s->spec.callback(userdata);
+		return rte_rdtsc() - start;
+	}
+
+	s->spec.callback(userdata);
+	return 0;
+}
+
+/* run the service up to its weight, stopping once its budget is spent */
+static inline void
+rte_service_runner_do_weighted(struct rte_service_spec_impl *s,
+			       struct core_state *cs, uint32_t service_idx,
+			       uint32_t weighted)
+{
+	const uint32_t weight = weighted ? s->weight : 1;
+	const uint64_t budget = s->budget;
+	uint64_t spent = 0;
+	uint32_t n;
+
+	for (n = 0; n < weight; n++) {
+		spent += rte_service_runner_do_callback(s, cs, service_idx);
+		if (budget != 0 && spent >= budget)
+			break;
+	}
 }
 
 
 /* Expects the service 's' is valid. */
 static int32_t
 service_run(uint32_t i, struct core_state *cs, uint64_t service_mask,
-	    struct rte_service_spec_impl *s)
+	    struct rte_service_spec_impl *s, uint32_t weighted)
 {
 	if (!s)
 		return -EINVAL;
@@ -376,10 +422,10 @@ service_run(uint32_t i, struct core_state *cs, uint64_t service_mask,
 		if (!rte_atomic32_cmpset((uint32_t *)&s->execute_lock, 0, 1))
 			return -EBUSY;
 
-		rte_service_runner_do_callback(s, cs, i);
+		rte_service_runner_do_weighted(s, cs, i, weighted);
 		rte_atomic32_clear(&s->execute_lock);
 	} else
-		rte_service_runner_do_callback(s, cs, i);
+		rte_service_runner_do_weighted(s, cs, i, weighted);
 
 	return 0;
 }
@@ -395,7 +441,7 @@ rte_service_may_be_active(uint32_t id)
 		return -EINVAL;
 
 	for (i = 0; i < lcore_count; i++) {
-		if (lcore_states[i].service_active_on_lcore[id])
+		if (lcore_states[ids[i]].service_active_on_lcore[id])
 			return 1;
 	}
 
@@ -424,7 +470,7 @@ rte_service_run_iter_on_app_lcore(uint32_t id, uint32_t serialize_mt_unsafe)
 		return -EBUSY;
 	}
 
-	int ret = service_run(id, cs, UINT64_MAX, s);
+	int ret = service_run(id, cs, UINT64_MAX, s, 0);
 
 	if (serialize_mt_unsafe)
 		rte_atomic32_dec(&s->num_mapped_cores);
@@ -447,7 +493,7 @@ rte_service_runner_func(void *arg)
 			if (!service_valid(i))
 				continue;
 			/* return value ignored as no change to code flow */
-			service_run(i, cs, service_mask, service_get(i));
+			service_run(i, cs, service_mask, service_get(i), 1);
 		}
 
 		cs->loops++;
@@ -613,6 +659,53 @@ rte_service_map_lcore_get(uint32_t id, uint32_t lcore)
 	return ret;
 }
 
+int32_t
+rte_service_lcore_migrate(uint32_t id, uint32_t src_lcore, uint32_t dst_lcore)
+{
+	struct rte_service_spec_impl *s;
+	struct core_state *src;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	if (src_lcore >= RTE_MAX_LCORE || dst_lcore >= RTE_MAX_LCORE ||
+			src_lcore == dst_lcore)
+		return -EINVAL;
+
+	src = &lcore_states[src_lcore];
+	if (!src->is_service_core || !lcore_states[dst_lcore].is_service_core)
+		return -EINVAL;
+
+	if (!(src->service_mask & (UINT64_C(1) << id)))
+		return -ENOENT;
+
+	/* an MT safe service can run on both cores for a while */
+	if (service_mt_safe(s)) {
+		rte_service_map_lcore_set(id, dst_lcore, 1);
+		rte_service_map_lcore_set(id, src_lcore, 0);
+		return 0;
+	}
+
+	/* the source core cannot wait for itself to complete a loop */
+	if (src->runstate == RUNSTATE_RUNNING &&
+			(uint32_t)rte_lcore_id() == src_lcore)
+		return -EBUSY;
+
+	/* otherwise unmap it first, then wait for the source core to
+	 * complete the loop it is in, which may still run the service, and
+	 * the next one, which may have read the service mask before the
+	 * unmap was visible to it.
+	 */
+	rte_service_map_lcore_set(id, src_lcore, 0);
+	rte_smp_mb();
+	const uint64_t loops = *(volatile uint64_t *)&src->loops;
+	while (src->runstate == RUNSTATE_RUNNING &&
+			*(volatile uint64_t *)&src->loops - loops < 2)
+		rte_pause();
+
+	rte_service_map_lcore_set(id, dst_lcore, 1);
+
+	return 0;
+}
+
 static void
 set_lcore_state(uint32_t lcore, int32_t state)
 {
@@ -754,11 +847,59 @@ rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 	case RTE_SERVICE_ATTR_CALL_COUNT:
 		*attr_value = s->calls;
 		return 0;
+	case RTE_SERVICE_ATTR_WEIGHT:
+		*attr_value = s->weight;
+		return 0;
+	case RTE_SERVICE_ATTR_BUDGET:
+		*attr_value = s->budget;
+		return 0;
 	default:
 		return -EINVAL;
 	}
 }
 
+int32_t
+rte_service_weight_set(uint32_t id, uint32_t weight)
+{
+	struct rte_service_spec_impl *s;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	if (weight == 0)
+		return -EINVAL;
+
+	s->weight = weight;
+	rte_smp_wmb();
+	return 0;
+}
+
+int32_t
+rte_service_budget_set(uint32_t id, uint64_t cycles)
+{
+	struct rte_service_spec_impl *s;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	s->budget = cycles;
+	rte_smp_wmb();
+	return 0;
+}
+
+int32_t
+rte_service_cycles_histogram_get(uint32_t id, uint64_t hist[], uint32_t n)
+{
+	struct rte_service_spec_impl *s;
+	uint32_t i;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	if (hist == NULL)
+		return -EINVAL;
+
+	n = RTE_MIN(n, (uint32_t)RTE_SERVICE_HIST_BUCKETS);
+	for (i = 0; i < n; i++)
+		hist[i] = s->cycles_hist[i];
+
+	return n;
+}
+
 int32_t
 rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 			   uint64_t *attr_value)
@@ -776,6 +917,9 @@ rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 	case RTE_SERVICE_LCORE_ATTR_LOOPS:
 		*attr_value = cs->loops;
 		return 0;
+	case RTE_SERVICE_LCORE_ATTR_CYCLES:
+		*attr_value = cs->cycles;
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -796,6 +940,7 @@ rte_service_dump_one(FILE *f, struct rte_service_spec_impl *s,
 	if (reset) {
 		s->cycles_spent = 0;
 		s->calls = 0;
+		memset(s->cycles_hist, 0, sizeof(s->cycles_hist));
 		return;
 	}
 
@@ -803,9 +948,11 @@ rte_service_dump_one(FILE *f, struct rte_service_spec_impl *s,
 		return;
 
 	fprintf(f, "  %s: stats %d\tcalls %"PRIu64"\tcycles %"
-			PRIu64"\tavg: %"PRIu64"\n",
+			PRIu64"\tavg: %"PRIu64"\tweight %u\tbudget %"
+			PRIu64"\n",
 			s->spec.name, service_stats_enabled(s), s->calls,
-			s->cycles_spent, s->cycles_spent / calls);
+			s->cycles_spent, s->cycles_spent / calls,
+			s->weight, s->budget);
 }
 
 int32_t
@@ -832,6 +979,7 @@ rte_service_lcore_attr_reset_all(uint32_t lcore)
 		return -ENOTSUP;
 
 	cs->loops = 0;
+	cs->cycles = 0;
 
 	return 0;
 }
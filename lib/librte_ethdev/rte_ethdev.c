@@ -104,6 +104,45 @@ static const struct rte_eth_xstats_name_off rte_txq_stats_strings[] = {
 #define RTE_NB_TXQ_STATS (sizeof(rte_txq_stats_strings) /	\
 		sizeof(rte_txq_stats_strings[0]))
 
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+#define RTE_QUEUE_SW_STATS_BURST(_name, _idx) \
+	{_name, offsetof(struct rte_eth_queue_sw_stats, bursts) + \
+		(_idx) * sizeof(uint64_t)}
+
+static const struct rte_eth_xstats_name_off rte_rxq_sw_stats_strings[] = {
+	{"sw_packets", offsetof(struct rte_eth_queue_sw_stats, packets)},
+	{"sw_bytes", offsetof(struct rte_eth_queue_sw_stats, bytes)},
+	RTE_QUEUE_SW_STATS_BURST("sw_empty_polls", 0),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_1", 1),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_2_3", 2),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_4_7", 3),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_8_15", 4),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_16_31", 5),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_32_63", 6),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_64_plus", 7),
+};
+
+#define RTE_NB_RXQ_SW_STATS (sizeof(rte_rxq_sw_stats_strings) /	\
+		sizeof(rte_rxq_sw_stats_strings[0]))
+
+static const struct rte_eth_xstats_name_off rte_txq_sw_stats_strings[] = {
+	{"sw_packets", offsetof(struct rte_eth_queue_sw_stats, packets)},
+	{"sw_bytes", offsetof(struct rte_eth_queue_sw_stats, bytes)},
+	{"sw_errors", offsetof(struct rte_eth_queue_sw_stats, errors)},
+	RTE_QUEUE_SW_STATS_BURST("sw_empty_polls", 0),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_1", 1),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_2_3", 2),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_4_7", 3),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_8_15", 4),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_16_31", 5),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_32_63", 6),
+	RTE_QUEUE_SW_STATS_BURST("sw_bursts_64_plus", 7),
+};
+
+#define RTE_NB_TXQ_SW_STATS (sizeof(rte_txq_sw_stats_strings) /	\
+		sizeof(rte_txq_sw_stats_strings[0]))
+#endif
+
 #define RTE_RX_OFFLOAD_BIT2STR(_name)	\
 	{ DEV_RX_OFFLOAD_##_name, #_name }
 
@@ -560,6 +599,8 @@ rte_eth_dev_release_port(struct rte_eth_dev *eth_dev)
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
 		rte_free(eth_dev->data->rx_queues);
 		rte_free(eth_dev->data->tx_queues);
+		rte_free(eth_dev->data->rx_sw_stats);
+		rte_free(eth_dev->data->tx_sw_stats);
 		rte_free(eth_dev->data->mac_addrs);
 		rte_free(eth_dev->data->hash_mac_addrs);
 		rte_free(eth_dev->data->dev_private);
@@ -826,6 +867,35 @@ eth_err(uint16_t port_id, int ret)
 	return ret;
 }
 
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+/*
+ * Reset the software statistics of all queues, reallocating them only
+ * when the number of queues changes.
+ */
+static int
+eth_dev_queue_sw_stats_config(struct rte_eth_queue_sw_stats **stats,
+		uint16_t old_nb_queues, uint16_t nb_queues, const char *name)
+{
+	struct rte_eth_queue_sw_stats *new_stats = NULL;
+
+	if (*stats != NULL && nb_queues == old_nb_queues) {
+		memset(*stats, 0, sizeof(**stats) * nb_queues);
+		return 0;
+	}
+
+	if (nb_queues != 0) {
+		new_stats = rte_zmalloc(name, sizeof(*new_stats) * nb_queues,
+				RTE_CACHE_LINE_SIZE);
+		if (new_stats == NULL)
+			return -ENOMEM;
+	}
+
+	rte_free(*stats);
+	*stats = new_stats;
+	return 0;
+}
+#endif
+
 static int
 rte_eth_dev_rx_queue_config(struct rte_eth_dev *dev, uint16_t nb_queues)
 {
@@ -833,6 +903,12 @@ rte_eth_dev_rx_queue_config(struct rte_eth_dev *dev, uint16_t nb_queues)
 	void **rxq;
 	unsigned i;
 
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+	if (eth_dev_queue_sw_stats_config(&dev->data->rx_sw_stats,
+			old_nb_queues, nb_queues, "ethdev->rx_sw_stats") != 0)
+		return -(ENOMEM);
+#endif
+
 	if (dev->data->rx_queues == NULL && nb_queues != 0) { /* first time configuration */
 		dev->data->rx_queues = rte_zmalloc("ethdev->rx_queues",
 				sizeof(dev->data->rx_queues[0]) * nb_queues,
@@ -1029,6 +1105,12 @@ rte_eth_dev_tx_queue_config(struct rte_eth_dev *dev, uint16_t nb_queues)
 	void **txq;
 	unsigned i;
 
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+	if (eth_dev_queue_sw_stats_config(&dev->data->tx_sw_stats,
+			old_nb_queues, nb_queues, "ethdev->tx_sw_stats") != 0)
+		return -ENOMEM;
+#endif
+
 	if (dev->data->tx_queues == NULL && nb_queues != 0) { /* first time configuration */
 		dev->data->tx_queues = rte_zmalloc("ethdev->tx_queues",
 						   sizeof(dev->data->tx_queues[0]) * nb_queues,
@@ -1724,9 +1806,13 @@ rte_eth_dev_close(uint16_t port_id)
 	dev->data->nb_rx_queues = 0;
 	rte_free(dev->data->rx_queues);
 	dev->data->rx_queues = NULL;
+	rte_free(dev->data->rx_sw_stats);
+	dev->data->rx_sw_stats = NULL;
 	dev->data->nb_tx_queues = 0;
 	rte_free(dev->data->tx_queues);
 	dev->data->tx_queues = NULL;
+	rte_free(dev->data->tx_sw_stats);
+	dev->data->tx_sw_stats = NULL;
 }
 
 int
@@ -2389,6 +2475,21 @@ rte_eth_stats_get(uint16_t port_id, struct rte_eth_stats *stats)
 	return eth_err(port_id, (*dev->dev_ops->stats_get)(dev, stats));
 }
 
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+static void
+eth_dev_queue_sw_stats_reset(struct rte_eth_dev *dev)
+{
+	if (dev->data->rx_sw_stats != NULL)
+		memset(dev->data->rx_sw_stats, 0,
+			sizeof(dev->data->rx_sw_stats[0]) *
+			dev->data->nb_rx_queues);
+	if (dev->data->tx_sw_stats != NULL)
+		memset(dev->data->tx_sw_stats, 0,
+			sizeof(dev->data->tx_sw_stats[0]) *
+			dev->data->nb_tx_queues);
+}
+#endif
+
 int
 rte_eth_stats_reset(uint16_t port_id)
 {
@@ -2404,6 +2505,9 @@ rte_eth_stats_reset(uint16_t port_id)
 		return eth_err(port_id, ret);
 
 	dev->data->rx_mbuf_alloc_failed = 0;
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+	eth_dev_queue_sw_stats_reset(dev);
+#endif
 
 	return 0;
 }
@@ -2420,6 +2524,10 @@ get_xstats_basic_count(struct rte_eth_dev *dev)
 	count = RTE_NB_STATS;
 	count += nb_rxqs * RTE_NB_RXQ_STATS;
 	count += nb_txqs * RTE_NB_TXQ_STATS;
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+	count += dev->data->nb_rx_queues * RTE_NB_RXQ_SW_STATS;
+	count += dev->data->nb_tx_queues * RTE_NB_TXQ_SW_STATS;
+#endif
 
 	return count;
 }
@@ -2531,6 +2639,26 @@ rte_eth_basic_stats_get_names(struct rte_eth_dev *dev,
 			cnt_used_entries++;
 		}
 	}
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+	for (id_queue = 0; id_queue < dev->data->nb_rx_queues; id_queue++) {
+		for (idx = 0; idx < RTE_NB_RXQ_SW_STATS; idx++) {
+			snprintf(xstats_names[cnt_used_entries].name,
+				sizeof(xstats_names[0].name),
+				"rx_q%u_%s",
+				id_queue, rte_rxq_sw_stats_strings[idx].name);
+			cnt_used_entries++;
+		}
+	}
+	for (id_queue = 0; id_queue < dev->data->nb_tx_queues; id_queue++) {
+		for (idx = 0; idx < RTE_NB_TXQ_SW_STATS; idx++) {
+			snprintf(xstats_names[cnt_used_entries].name,
+				sizeof(xstats_names[0].name),
+				"tx_q%u_%s",
+				id_queue, rte_txq_sw_stats_strings[idx].name);
+			cnt_used_entries++;
+		}
+	}
+#endif
 	return cnt_used_entries;
 }
 
@@ -2729,6 +2857,26 @@ rte_eth_basic_stats_get(uint16_t port_id, struct rte_eth_xstat *xstats)
 			xstats[count++].value = val;
 		}
 	}
+
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+	/* per-rxq software stats */
+	for (q = 0; q < dev->data->nb_rx_queues; q++) {
+		for (i = 0; i < RTE_NB_RXQ_SW_STATS; i++) {
+			stats_ptr = RTE_PTR_ADD(&dev->data->rx_sw_stats[q],
+					rte_rxq_sw_stats_strings[i].offset);
+			xstats[count++].value = *stats_ptr;
+		}
+	}
+
+	/* per-txq software stats */
+	for (q = 0; q < dev->data->nb_tx_queues; q++) {
+		for (i = 0; i < RTE_NB_TXQ_SW_STATS; i++) {
+			stats_ptr = RTE_PTR_ADD(&dev->data->tx_sw_stats[q],
+					rte_txq_sw_stats_strings[i].offset);
+			xstats[count++].value = *stats_ptr;
+		}
+	}
+#endif
 	return count;
 }
 
@@ -2832,19 +2980,14 @@ rte_eth_xstats_get(uint16_t port_id, struct rte_eth_xstat *xstats,
 	struct rte_eth_dev *dev;
 	unsigned int count = 0, i;
 	signed int xcount = 0;
-	uint16_t nb_rxqs, nb_txqs;
 	int ret;
 
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -EINVAL);
 
 	dev = &rte_eth_devices[port_id];
 
-	nb_rxqs = RTE_MIN(dev->data->nb_rx_queues, RTE_ETHDEV_QUEUE_STAT_CNTRS);
-	nb_txqs = RTE_MIN(dev->data->nb_tx_queues, RTE_ETHDEV_QUEUE_STAT_CNTRS);
-
 	/* Return generic statistics */
-	count = RTE_NB_STATS + (nb_rxqs * RTE_NB_RXQ_STATS) +
-		(nb_txqs * RTE_NB_TXQ_STATS);
+	count = get_xstats_basic_count(dev);
 
 	/* implemented by the driver */
 	if (dev->dev_ops->xstats_get != NULL) {
@@ -2887,8 +3030,12 @@ rte_eth_xstats_reset(uint16_t port_id)
 	dev = &rte_eth_devices[port_id];
 
 	/* implemented by the driver */
-	if (dev->dev_ops->xstats_reset != NULL)
+	if (dev->dev_ops->xstats_reset != NULL) {
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+		eth_dev_queue_sw_stats_reset(dev);
+#endif
 		return eth_err(port_id, (*dev->dev_ops->xstats_reset)(dev));
+	}
 
 	/* fallback to default */
 	return rte_eth_stats_reset(port_id);
@@ -4286,6 +4286,35 @@ int rte_eth_dev_hairpin_capability_get(uint16_t port_id,
 
 #include <rte_ethdev_core.h>
 
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+/**
+ * @internal
+ * Count a burst in the software statistics of a queue.
+ *
+ * @param stats
+ *   The software statistics of the queue.
+ * @param pkts
+ *   The packets received or accepted by the driver.
+ * @param nb_pkts
+ *   The number of packets in *pkts*.
+ */
+static inline void
+rte_eth_queue_sw_stats_update(struct rte_eth_queue_sw_stats *stats,
+		struct rte_mbuf **pkts, uint16_t nb_pkts)
+{
+	uint64_t bytes = 0;
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts; i++)
+		bytes += rte_pktmbuf_pkt_len(pkts[i]);
+
+	stats->packets += nb_pkts;
+	stats->bytes += bytes;
+	stats->bursts[RTE_MIN(rte_fls_u32(nb_pkts),
+			RTE_ETH_QUEUE_SW_STATS_BURST_CNT - 1)]++;
+}
+#endif
+
 /**
  *
  * Retrieve a burst of input packets from a receive queue of an Ethernet
@@ -4387,6 +4416,11 @@ rte_eth_rx_burst(uint16_t port_id, uint16_t queue_id,
 	nb_rx = (*dev->rx_pkt_burst)(dev->data->rx_queues[queue_id],
 				     rx_pkts, nb_pkts);
 
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+	rte_eth_queue_sw_stats_update(&dev->data->rx_sw_stats[queue_id],
+			rx_pkts, nb_rx);
+#endif
+
 #ifdef RTE_ETHDEV_RXTX_CALLBACKS
 	if (unlikely(dev->post_rx_burst_cbs[queue_id] != NULL)) {
 		struct rte_eth_rxtx_callback *cb =
@@ -4640,6 +4674,11 @@ rte_eth_tx_burst(uint16_t port_id, uint16_t queue_id,
 		 struct rte_mbuf **tx_pkts, uint16_t nb_pkts)
 {
 	struct rte_eth_dev *dev = &rte_eth_devices[port_id];
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+	struct rte_eth_queue_sw_stats *stats;
+	uint16_t nb_tx;
+	uint16_t i;
+#endif
 
 #ifdef RTE_LIBRTE_ETHDEV_DEBUG
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, 0);
@@ -4663,7 +4702,25 @@ rte_eth_tx_burst(uint16_t port_id, uint16_t queue_id,
 	}
 #endif
 
+#ifdef RTE_ETHDEV_QUEUE_SW_STATS
+	/*
+	 * Accepted packets may be freed as soon as the driver returns,
+	 * so all packets are counted before, and the rejected ones, still
+	 * owned by the caller, are removed after.
+	 */
+	stats = &dev->data->tx_sw_stats[queue_id];
+	rte_eth_queue_sw_stats_update(stats, tx_pkts, nb_pkts);
+	nb_tx = (*dev->tx_pkt_burst)(dev->data->tx_queues[queue_id],
+			tx_pkts, nb_pkts);
+	for (i = nb_tx; i < nb_pkts; i++)
+		stats->bytes -= rte_pktmbuf_pkt_len(tx_pkts[i]);
+	stats->packets -= nb_pkts - nb_tx;
+	stats->errors += nb_pkts - nb_tx;
+
+	return nb_tx;
+#else
 	return (*dev->tx_pkt_burst)(dev->data->tx_queues[queue_id], tx_pkts, nb_pkts);
+#endif
 }
 
 /**
@@ -810,6 +810,28 @@ struct rte_eth_dev {
 struct rte_eth_dev_sriov;
 struct rte_eth_dev_owner;
 
+/** Number of burst size ranges counted by the queue software statistics. */
+#define RTE_ETH_QUEUE_SW_STATS_BURST_CNT 8
+
+/**
+ * @internal
+ * Software statistics of a queue, counted by rte_eth_rx_burst() and
+ * rte_eth_tx_burst() when RTE_ETHDEV_QUEUE_SW_STATS is defined.
+ *
+ * A queue is polled by a single lcore at a time, so each block is only
+ * written by that lcore and has its own cache lines.
+ */
+struct rte_eth_queue_sw_stats {
+	uint64_t packets; /**< Packets received or accepted by the driver. */
+	uint64_t bytes;   /**< Bytes received or accepted by the driver. */
+	uint64_t errors;  /**< Packets not accepted by the driver on Tx. */
+	/**
+	 * Number of bursts per size, received on Rx and requested on Tx:
+	 * 0, 1, 2-3, 4-7, ... 64 and more. The first one counts empty polls.
+	 */
+	uint64_t bursts[RTE_ETH_QUEUE_SW_STATS_BURST_CNT];
+} __rte_cache_aligned;
+
 /**
  * @internal
  * The data part, with no function pointers, associated with each ethernet device.
@@ -873,7 +895,11 @@ struct rte_eth_dev_data {
 			 */
 
 	uint64_t reserved_64s[4]; /**< Reserved for future fields */
-	void *reserved_ptrs[4];   /**< Reserved for future fields */
+	struct rte_eth_queue_sw_stats *rx_sw_stats;
+			/**< Software statistics of RX queues. */
+	struct rte_eth_queue_sw_stats *tx_sw_stats;
+			/**< Software statistics of TX queues. */
+	void *reserved_ptrs[2];   /**< Reserved for future fields */
 } __rte_cache_aligned;
 
 /**
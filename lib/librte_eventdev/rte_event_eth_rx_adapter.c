@@ -6,6 +6,7 @@
 #include <sys/epoll.h>
 #endif
 #include <unistd.h>
+#include <sys/queue.h>
 
 #include <rte_cycles.h>
 #include <rte_common.h>
@@ -14,6 +15,7 @@
 #include <rte_ethdev.h>
 #include <rte_log.h>
 #include <rte_malloc.h>
+#include <rte_mempool.h>
 #include <rte_service_component.h>
 #include <rte_thash.h>
 #include <rte_interrupts.h>
@@ -58,6 +60,32 @@ struct eth_rx_poll_entry {
 	uint16_t eth_rx_qid;
 };
 
+/*
+ * Event vector being filled for a vectorized Rx queue. Vectors holding at
+ * least one mbuf are linked in the adapter's vector list so that the
+ * service function can flush them on timeout.
+ */
+struct eth_rx_vector_data {
+	TAILQ_ENTRY(eth_rx_vector_data) next;
+	/* Eth port and Rx queue the vector collects mbufs for */
+	uint16_t port;
+	uint16_t queue;
+	/* Maximum number of mbufs in a vector */
+	uint16_t max_vector_count;
+	/* Event template of vector events */
+	uint64_t event;
+	/* TSC timestamp of the first mbuf in the vector */
+	uint64_t ts;
+	/* Flush timeout in TSC cycles */
+	uint64_t vector_timeout_ticks;
+	/* Vector mempool */
+	struct rte_mempool *vector_pool;
+	/* Vector being filled, NULL if none */
+	struct rte_event_vector *vector_ev;
+};
+
+TAILQ_HEAD(eth_rx_vector_data_list, eth_rx_vector_data);
+
 /* Instance per adapter */
 struct rte_eth_event_enqueue_buffer {
 	/* Count of events in this buffer */
@@ -91,6 +119,12 @@ struct rte_event_eth_rx_adapter {
 	uint32_t wrr_pos;
 	/* Event burst buffer */
 	struct rte_eth_event_enqueue_buffer event_enqueue_buffer;
+	/* Partially filled event vectors, oldest first */
+	struct eth_rx_vector_data_list vector_list;
+	/* Smallest vector timeout of the vectorized queues */
+	uint64_t vector_tmo_ticks;
+	/* Timestamp of the last vector timeout scan */
+	uint64_t prev_expiry_ts;
 	/* Per adapter stats */
 	struct rte_event_eth_rx_adapter_stats stats;
 	/* Block count, counts up to BLOCK_CNT_THRESHOLD */
@@ -200,6 +234,8 @@ struct eth_rx_queue_info {
 	uint16_t wt;		/* Polling weight */
 	uint32_t flow_id_mask;	/* Set to ~0 if app provides flow id else 0 */
 	uint64_t event;
+	int ena_vector;		/* True if mbufs are aggregated in vectors */
+	struct eth_rx_vector_data vector_data;
 };
 
 static struct rte_event_eth_rx_adapter **event_eth_rx_adapter;
@@ -741,6 +777,136 @@ rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
 	return n;
 }
 
+static inline int
+rxa_vector_alloc(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_vector_data *vec)
+{
+	struct rte_event_vector *v;
+
+	if (unlikely(rte_mempool_get(vec->vector_pool, (void **)&v) < 0))
+		return -ENOMEM;
+
+	v->nb_elem = 0;
+	v->rsvd = 0;
+	v->attr_valid = 1;
+	v->port = vec->port;
+	v->queue = vec->queue;
+	vec->vector_ev = v;
+	vec->ts = rte_get_tsc_cycles();
+	TAILQ_INSERT_TAIL(&rx_adapter->vector_list, vec, next);
+	return 0;
+}
+
+/* Detach the vector being filled and turn it into an event */
+static inline void
+rxa_vector_to_event(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_vector_data *vec,
+		struct rte_event *ev)
+{
+	ev->event = vec->event;
+	ev->vec = vec->vector_ev;
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
+}
+
+/* Drop the vector being filled along with the mbufs it holds */
+static void
+rxa_vector_free(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_vector_data *vec)
+{
+	struct rte_event_vector *v = vec->vector_ev;
+
+	if (v == NULL)
+		return;
+
+	rx_adapter->stats.rx_dropped += v->nb_elem;
+	rte_pktmbuf_free_bulk(v->mbufs, v->nb_elem);
+	rte_mempool_put(vec->vector_pool, v);
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
+}
+
+/* Add mbufs to the Rx queue's vector, returns the number of vector events
+ * written to the event buffer. A burst of at most BATCH_SIZE mbufs never
+ * produces more than BATCH_SIZE events.
+ */
+static inline uint16_t
+rxa_create_event_vector(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_queue_info *queue_info,
+		struct rte_eth_event_enqueue_buffer *buf,
+		struct rte_mbuf **mbufs,
+		uint16_t num)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	struct rte_event *ev = &buf->events[buf->count];
+	struct rte_event_vector *v;
+	uint16_t filled = 0;
+	uint16_t space;
+	uint16_t n;
+
+	while (num) {
+		if (vec->vector_ev == NULL &&
+				rxa_vector_alloc(rx_adapter, vec) < 0) {
+			rx_adapter->stats.rx_dropped += num;
+			rte_pktmbuf_free_bulk(mbufs, num);
+			break;
+		}
+
+		v = vec->vector_ev;
+		space = vec->max_vector_count - v->nb_elem;
+		n = RTE_MIN(num, space);
+		memcpy(&v->mbufs[v->nb_elem], mbufs, n * sizeof(*mbufs));
+		v->nb_elem += n;
+		mbufs += n;
+		num -= n;
+
+		if (v->nb_elem == vec->max_vector_count) {
+			rxa_vector_to_event(rx_adapter, vec, ev);
+			ev++;
+			filled++;
+		}
+	}
+
+	return filled;
+}
+
+/* Enqueue vectors that have been waiting longer than their timeout */
+static void
+rxa_vector_expire(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct rte_eth_event_enqueue_buffer *buf =
+					&rx_adapter->event_enqueue_buffer;
+	struct eth_rx_vector_data *vec;
+	struct eth_rx_vector_data *next;
+	uint64_t now;
+
+	if (TAILQ_EMPTY(&rx_adapter->vector_list))
+		return;
+
+	now = rte_get_tsc_cycles();
+	if (now - rx_adapter->prev_expiry_ts < rx_adapter->vector_tmo_ticks)
+		return;
+	rx_adapter->prev_expiry_ts = now;
+
+	for (vec = TAILQ_FIRST(&rx_adapter->vector_list); vec != NULL;
+			vec = next) {
+		next = TAILQ_NEXT(vec, next);
+		if (now - vec->ts < vec->vector_timeout_ticks)
+			continue;
+		if (buf->count == ETH_EVENT_BUFFER_SIZE) {
+			rxa_flush_event_buffer(rx_adapter);
+			if (buf->count == ETH_EVENT_BUFFER_SIZE)
+				break;
+		}
+		rxa_vector_to_event(rx_adapter, vec,
+				&buf->events[buf->count]);
+		buf->count++;
+	}
+
+	if (buf->count > 0)
+		rxa_flush_event_buffer(rx_adapter);
+}
+
 static inline void
 rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		uint16_t eth_dev_id,
@@ -780,6 +946,12 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		}
 	}
 
+	if (eth_rx_queue_info->ena_vector) {
+		buf->count += rxa_create_event_vector(rx_adapter,
+					eth_rx_queue_info, buf, mbufs, num);
+		return;
+	}
+
 	for (i = 0; i < num; i++) {
 		m = mbufs[i];
 
@@ -1150,6 +1322,7 @@ rxa_service_func(void *args)
 	stats = &rx_adapter->stats;
 	stats->rx_packets += rxa_intr_ring_dequeue(rx_adapter);
 	stats->rx_packets += rxa_poll(rx_adapter);
+	rxa_vector_expire(rx_adapter);
 	rte_spinlock_unlock(&rx_adapter->rx_lock);
 	return 0;
 }
@@ -1655,11 +1828,11 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_device_info *dev_info,
 	int32_t rx_queue_id)
 {
+	struct eth_rx_queue_info *queue_info;
 	int pollq;
 	int intrq;
 	int sintrq;
 
-
 	if (rx_adapter->nb_queues == 0)
 		return;
 
@@ -1676,6 +1849,9 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	pollq = rxa_polled_queue(dev_info, rx_queue_id);
 	intrq = rxa_intr_queue(dev_info, rx_queue_id);
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
+	queue_info = &dev_info->rx_queue[rx_queue_id];
+	rxa_vector_free(rx_adapter, &queue_info->vector_data);
+	queue_info->ena_vector = 0;
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 0);
 	rx_adapter->num_rx_polled -= pollq;
 	dev_info->nb_rx_poll -= pollq;
@@ -1684,6 +1860,42 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	dev_info->nb_shared_intr -= intrq && sintrq;
 }
 
+static void
+rxa_config_vector(struct rte_event_eth_rx_adapter *rx_adapter,
+	struct eth_rx_queue_info *queue_info,
+	uint16_t eth_dev_id,
+	uint16_t rx_queue_id,
+	const struct rte_event_eth_rx_adapter_event_vector_config *config,
+	uint64_t tmo_ticks)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	struct rte_event *ev;
+
+	rxa_vector_free(rx_adapter, vec);
+	queue_info->ena_vector = config->vector_sz != 0;
+	if (!queue_info->ena_vector)
+		return;
+
+	vec->port = eth_dev_id;
+	vec->queue = rx_queue_id;
+	vec->max_vector_count = config->vector_sz;
+	vec->vector_pool = config->vector_mp;
+	vec->vector_timeout_ticks = tmo_ticks;
+
+	vec->event = queue_info->event;
+	ev = (struct rte_event *)&vec->event;
+	ev->event_type = RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR;
+	/* All mbufs of a vector share a flow, unless the application supplied
+	 * one use the port and queue pair as the flow identifier.
+	 */
+	if (!queue_info->flow_id_mask)
+		ev->flow_id = (eth_dev_id & 0xFFF) |
+				((uint32_t)(rx_queue_id & 0xFF) << 12);
+
+	rx_adapter->vector_tmo_ticks = RTE_MIN(rx_adapter->vector_tmo_ticks,
+					tmo_ticks);
+}
+
 static void
 rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_device_info *dev_info,
@@ -1713,6 +1925,8 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 
 	queue_info = &dev_info->rx_queue[rx_queue_id];
 	queue_info->wt = conf->servicing_weight;
+	rxa_vector_free(rx_adapter, &queue_info->vector_data);
+	queue_info->ena_vector = 0;
 
 	qi_ev = (struct rte_event *)&queue_info->event;
 	qi_ev->event = ev->event;
@@ -1992,6 +2206,8 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 		return -ENOMEM;
 	}
 	rte_spinlock_init(&rx_adapter->rx_lock);
+	TAILQ_INIT(&rx_adapter->vector_list);
+	rx_adapter->vector_tmo_ticks = UINT64_MAX;
 	for (i = 0; i < RTE_MAX_ETHPORTS; i++)
 		rx_adapter->eth_devices[i].dev = &rte_eth_devices[i];
 
@@ -2266,6 +2482,93 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 	return ret;
 }
 
+int
+rte_event_eth_rx_adapter_queue_event_vector_config(uint8_t id,
+		uint16_t eth_dev_id, int32_t rx_queue_id,
+		struct rte_event_eth_rx_adapter_event_vector_config *config)
+{
+	struct rte_event_vector_pool_private *mp_priv;
+	struct rte_event_eth_rx_adapter *rx_adapter;
+	struct eth_device_info *dev_info;
+	struct eth_rx_queue_info *queue_info;
+	uint16_t nb_rx_queues;
+	uint64_t tmo_ticks;
+	uint32_t cap;
+	uint16_t i;
+	int ret;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if (rx_adapter == NULL || config == NULL)
+		return -EINVAL;
+
+	ret = rte_event_eth_rx_adapter_caps_get(rx_adapter->eventdev_id,
+						eth_dev_id,
+						&cap);
+	if (ret)
+		return ret;
+
+	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) == 0 ||
+		(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)) {
+		RTE_EDEV_LOG_ERR("Event vectorization is not supported,"
+				" eth port: %" PRIu16 " adapter id: %" PRIu8,
+				eth_dev_id, id);
+		return -ENOTSUP;
+	}
+
+	nb_rx_queues = rte_eth_devices[eth_dev_id].data->nb_rx_queues;
+	if (rx_queue_id != -1 && (uint16_t)rx_queue_id >= nb_rx_queues) {
+		RTE_EDEV_LOG_ERR("Invalid rx queue_id %" PRIu16,
+			 (uint16_t)rx_queue_id);
+		return -EINVAL;
+	}
+
+	if (config->vector_sz) {
+		if (config->vector_mp == NULL) {
+			RTE_EDEV_LOG_ERR("Vector mempool is required");
+			return -EINVAL;
+		}
+		mp_priv = rte_mempool_get_priv(config->vector_mp);
+		if (config->vector_sz > mp_priv->elem_size) {
+			RTE_EDEV_LOG_ERR("Vector size %" PRIu16 " exceeds"
+				" vector mempool element size %" PRIu16,
+				config->vector_sz, mp_priv->elem_size);
+			return -EINVAL;
+		}
+	}
+
+	tmo_ticks = (uint64_t)((double)config->vector_timeout_ns *
+			rte_get_tsc_hz() / 1E9);
+
+	dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	ret = 0;
+
+	rte_spinlock_lock(&rx_adapter->rx_lock);
+	if (dev_info->rx_queue == NULL) {
+		ret = -EINVAL;
+	} else if (rx_queue_id == -1) {
+		for (i = 0; i < nb_rx_queues; i++) {
+			queue_info = &dev_info->rx_queue[i];
+			if (!queue_info->queue_enabled)
+				continue;
+			rxa_config_vector(rx_adapter, queue_info, eth_dev_id,
+					i, config, tmo_ticks);
+		}
+	} else {
+		queue_info = &dev_info->rx_queue[rx_queue_id];
+		if (queue_info->queue_enabled)
+			rxa_config_vector(rx_adapter, queue_info, eth_dev_id,
+					rx_queue_id, config, tmo_ticks);
+		else
+			ret = -EINVAL;
+	}
+	rte_spinlock_unlock(&rx_adapter->rx_lock);
+
+	return ret;
+}
+
 int
 rte_event_eth_rx_adapter_start(uint8_t id)
 {
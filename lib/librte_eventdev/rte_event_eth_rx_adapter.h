@@ -37,6 +37,7 @@
  *  - rte_event_eth_rx_adapter_stop()
  *  - rte_event_eth_rx_adapter_stats_get()
  *  - rte_event_eth_rx_adapter_stats_reset()
+ *  - rte_event_eth_rx_adapter_queue_event_vector_config()
  *
  * The application creates an ethernet to event adapter using
  * rte_event_eth_rx_adapter_create_ext() or rte_event_eth_rx_adapter_create()
@@ -77,6 +78,14 @@
  * allows the application to register a callback that selects which packets are
  * enqueued to the event device by the SW adapter. The callback interface is
  * event based so the callback can also modify the event data if it needs to.
+ *
+ * When the adapter reports RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR, the
+ * rte_event_eth_rx_adapter_queue_event_vector_config() function can be used
+ * to have the mbufs received on a queue aggregated into event vectors
+ * (struct rte_event_vector) instead of one event per mbuf. A vector is
+ * enqueued once it holds the configured number of mbufs or when the oldest
+ * mbuf in it has waited for the configured timeout, whichever comes first.
+ * Vector events have the RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR event type.
  */
 
 #ifdef __cplusplus
@@ -173,6 +182,26 @@ struct rte_event_eth_rx_adapter_queue_conf {
 	 */
 };
 
+/**
+ * Rx queue event vector configuration structure
+ * @see rte_event_eth_rx_adapter_queue_event_vector_config()
+ */
+struct rte_event_eth_rx_adapter_event_vector_config {
+	uint16_t vector_sz;
+	/**< Maximum number of mbufs aggregated in a single event vector.
+	 * Must not exceed the element count of *vector_mp*. Setting it to
+	 * zero disables vectorization of the Rx queue.
+	 */
+	uint64_t vector_timeout_ns;
+	/**< Maximum time, in nanoseconds, a partially filled vector is held
+	 * by the adapter before it is enqueued to the event device.
+	 */
+	struct rte_mempool *vector_mp;
+	/**< Mempool of event vectors, created with
+	 * rte_event_vector_pool_create().
+	 */
+};
+
 /**
  * A structure used to retrieve statistics for an eth rx adapter instance.
  */
@@ -471,6 +500,44 @@ int rte_event_eth_rx_adapter_cb_register(uint8_t id, uint16_t eth_dev_id,
 					 rte_event_eth_rx_adapter_cb_fn cb_fn,
 					 void *cb_arg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Configure event vectorization for an Rx queue that has been added to the
+ * adapter. Mbufs received on the queue are grouped into vector events of up
+ * to *config->vector_sz* mbufs. All mbufs of a vector come from the same
+ * ethdev port and queue, and the vector's port and queue attributes are
+ * valid. The flow identifier of a vector event is the one configured with
+ * RTE_EVENT_ETH_RX_ADAPTER_QUEUE_FLOW_ID_VALID, if set, and is otherwise
+ * derived from the port and queue identifiers.
+ *
+ * The configuration is dropped when the queue is deleted or added again.
+ * The Rx callback registered with rte_event_eth_rx_adapter_cb_register()
+ * is not invoked for vectorized queues.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param eth_dev_id
+ *  Port identifier of Ethernet device.
+ * @param rx_queue_id
+ *  Ethernet device receive queue index.
+ *  If rx_queue_id is -1, then all Rx queues of the device that have been
+ *  added to the adapter are configured.
+ * @param config
+ *  Event vector configuration structure.
+ *
+ * @return
+ *  - 0: Success, vectorization configured.
+ *  - -ENOTSUP: The adapter doesn't support event vectorization for the
+ *    ethernet device.
+ *  - <0: Error code on failure.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_queue_event_vector_config(uint8_t id,
+		uint16_t eth_dev_id, int32_t rx_queue_id,
+		struct rte_event_eth_rx_adapter_event_vector_config *config);
+
 #ifdef __cplusplus
 }
 #endif
@@ -68,6 +68,12 @@
  * and rte_event_eth_tx_adapter_txq_get() functions to access the transmit
  * queue index, using these macros will help with minimizing application
  * impact due to a change in how the transmit queue index is specified.
+ *
+ * The service function also accepts event vectors (events whose event type
+ * has RTE_EVENT_TYPE_VECTOR set). If the vector's attr_valid bit is set, all
+ * of its mbufs are transmitted on the vector's port and queue; otherwise each
+ * mbuf's port and Tx queue are used. The vector is returned to its mempool
+ * once its mbufs have been transmitted.
  */
 
 #ifdef __cplusplus
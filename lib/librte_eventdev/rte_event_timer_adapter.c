@@ -19,6 +19,8 @@
 #include <rte_timer.h>
 #include <rte_service_component.h>
 #include <rte_cycles.h>
+#include <rte_spinlock.h>
+#include <rte_lcore.h>
 
 #include "rte_eventdev.h"
 #include "rte_eventdev_pmd.h"
@@ -35,6 +37,7 @@ static int evtim_buffer_logtype;
 static struct rte_event_timer_adapter adapters[RTE_EVENT_TIMER_ADAPTER_NUM_MAX];
 
 static const struct rte_event_timer_adapter_ops swtim_ops;
+static const struct rte_event_timer_adapter_ops twtim_ops;
 
 #define EVTIM_LOG(level, logtype, ...) \
 	rte_log(RTE_LOG_ ## level, logtype, \
@@ -207,11 +210,13 @@ rte_event_timer_adapter_create_ext(
 		}
 	}
 
-	/* If eventdev PMD did not provide ops, use default software
-	 * implementation.
+	/* If eventdev PMD did not provide ops, use one of the software
+	 * implementations.
 	 */
 	if (adapter->ops == NULL)
-		adapter->ops = &swtim_ops;
+		adapter->ops = (adapter->data->conf.flags &
+				RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL) ?
+				&twtim_ops : &swtim_ops;
 
 	/* Allow driver to do some setup */
 	FUNC_PTR_OR_NULL_RET_WITH_ERRNO(adapter->ops->init, ENOTSUP);
@@ -336,11 +341,13 @@ rte_event_timer_adapter_lookup(uint16_t adapter_id)
 		return NULL;
 	}
 
-	/* If eventdev PMD did not provide ops, use default software
-	 * implementation.
+	/* If eventdev PMD did not provide ops, use one of the software
+	 * implementations.
 	 */
 	if (adapter->ops == NULL)
-		adapter->ops = &swtim_ops;
+		adapter->ops = (adapter->data->conf.flags &
+				RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL) ?
+				&twtim_ops : &swtim_ops;
 
 	/* Set fast-path function pointers */
 	adapter->arm_burst = adapter->ops->arm_burst;
@@ -933,11 +940,14 @@ get_mapped_count_for_service(uint32_t service_id)
 	return mapped_count;
 }
 
+/* The start and stop functions only deal with the adapter's service, so they
+ * are shared by the rte_timer and timer wheel based implementations.
+ */
 static int
 swtim_start(const struct rte_event_timer_adapter *adapter)
 {
 	int mapped_count;
-	struct swtim *sw = swtim_pmd_priv(adapter);
+	uint32_t service_id = adapter->data->service_id;
 
 	/* Mapping the service to more than one service core can introduce
 	 * delays while one thread is waiting to acquire a lock, so only allow
@@ -946,26 +956,26 @@ swtim_start(const struct rte_event_timer_adapter *adapter)
 	 * Note: the service could be modified such that it spreads cores to
 	 * poll over multiple service instances.
 	 */
-	mapped_count = get_mapped_count_for_service(sw->service_id);
+	mapped_count = get_mapped_count_for_service(service_id);
 
 	if (mapped_count != 1)
 		return mapped_count < 1 ? -ENOENT : -ENOTSUP;
 
-	return rte_service_component_runstate_set(sw->service_id, 1);
+	return rte_service_component_runstate_set(service_id, 1);
 }
 
 static int
 swtim_stop(const struct rte_event_timer_adapter *adapter)
 {
 	int ret;
-	struct swtim *sw = swtim_pmd_priv(adapter);
+	uint32_t service_id = adapter->data->service_id;
 
-	ret = rte_service_component_runstate_set(sw->service_id, 0);
+	ret = rte_service_component_runstate_set(service_id, 0);
 	if (ret < 0)
 		return ret;
 
 	/* Wait for the service to complete its final iteration */
-	while (rte_service_may_be_active(sw->service_id))
+	while (rte_service_may_be_active(service_id))
 		rte_pause();
 
 	return 0;
@@ -1184,6 +1194,638 @@ static const struct rte_event_timer_adapter_ops swtim_ops = {
 	.cancel_burst		= swtim_cancel_burst,
 };
 
+/*
+ * Timer wheel software event timer adapter implementation
+ *
+ * Every lcore that arms event timers owns a hashed timing wheel: an array of
+ * slots, each holding a doubly-linked list of the timers whose expiry tick
+ * maps to that slot.  Arming and canceling are constant time list operations
+ * under the wheel's lock, regardless of how many timers are outstanding.  The
+ * service function visits only the slots of the ticks that elapsed since it
+ * last ran, and enqueues the expired timers' events in bursts.
+ */
+
+/* Upper bound on the number of slots in a wheel. Timeouts spanning more ticks
+ * than this share a slot with earlier expiries, and are left in place until
+ * their own tick comes around.
+ */
+#define TWTIM_MAX_SLOTS (1 << 14)
+
+struct twtim_node {
+	struct twtim_node *next;
+	struct twtim_node **pprev;
+	/* Adapter tick at which the timer expires */
+	uint64_t expiry;
+	struct rte_event_timer *evtim;
+};
+
+struct twtim_wheel {
+	/* Serializes the arming lcore, cancels and the service */
+	rte_spinlock_t lock;
+	/* Last tick whose slot has been processed by the service */
+	uint64_t last_tick;
+	/* Timer lists, indexed by expiry tick & slot_mask */
+	struct twtim_node **slots;
+} __rte_cache_aligned;
+
+struct twtim {
+	/* Identifier of service executing timer management logic. */
+	uint32_t service_id;
+	/* The tick resolution used by adapter instance. */
+	uint64_t timer_tick_ns;
+	/* Maximum timeout in nanoseconds allowed by adapter instance. */
+	uint64_t max_tmo_ns;
+	/* Timer cycle count corresponding to tick 0 */
+	uint64_t start_cycles;
+	uint64_t cycles_per_tick;
+	/* Last tick observed by the service */
+	uint64_t cur_tick;
+	uint32_t slot_mask;
+	/* Buffered timer expiry events to be enqueued to an event device. */
+	struct event_buffer buffer;
+	/* Statistics */
+	struct rte_event_timer_adapter_stats stats;
+	/* Mempool of wheel list nodes */
+	struct rte_mempool *node_pool;
+	/* Back pointer for convenience */
+	struct rte_event_timer_adapter *adapter;
+	/* Wheels that have been allocated and must be polled */
+	unsigned int wheel_ids[RTE_MAX_LCORE];
+	unsigned int nb_wheels;
+	struct twtim_wheel wheels[RTE_MAX_LCORE];
+	/* Nodes which have expired and can be returned to the mempool */
+	struct twtim_node *expired_nodes[EXP_TIM_BUF_SZ];
+	size_t n_expired_nodes;
+};
+
+static inline struct twtim *
+twtim_pmd_priv(const struct rte_event_timer_adapter *adapter)
+{
+	return adapter->data->adapter_priv;
+}
+
+static inline uint64_t
+twtim_now_tick(const struct twtim *tw)
+{
+	return (rte_get_timer_cycles() - tw->start_cycles) /
+		tw->cycles_per_tick;
+}
+
+static inline void
+twtim_node_insert(struct twtim_node **head, struct twtim_node *n)
+{
+	n->next = *head;
+	n->pprev = head;
+	if (n->next != NULL)
+		n->next->pprev = &n->next;
+	*head = n;
+}
+
+static inline void
+twtim_node_unlink(struct twtim_node *n)
+{
+	*n->pprev = n->next;
+	if (n->next != NULL)
+		n->next->pprev = n->pprev;
+}
+
+/* Check that event timer timeout value is in range */
+static __rte_always_inline int
+twtim_check_timeout(struct rte_event_timer *evtim, const struct twtim *tw)
+{
+	uint64_t tmo_nsec;
+
+	tmo_nsec = evtim->timeout_ticks * tw->timer_tick_ns;
+	if (tmo_nsec > tw->max_tmo_ns)
+		return -1;
+	if (tmo_nsec < tw->timer_tick_ns)
+		return -2;
+
+	return 0;
+}
+
+static void
+twtim_buffer_flush(struct rte_event_timer_adapter *adapter, struct twtim *tw)
+{
+	uint16_t nb_evs_flushed, nb_evs_invalid;
+
+	/* Drain the buffer until it is empty or the event device pushes
+	 * back.
+	 */
+	do {
+		nb_evs_flushed = 0;
+		nb_evs_invalid = 0;
+		event_buffer_flush(&tw->buffer,
+				   adapter->data->event_dev_id,
+				   adapter->data->event_port_id,
+				   &nb_evs_flushed,
+				   &nb_evs_invalid);
+
+		tw->stats.ev_enq_count += nb_evs_flushed;
+		tw->stats.ev_inv_count += nb_evs_invalid;
+	} while (nb_evs_flushed + nb_evs_invalid > 0);
+}
+
+/* Move the timers in a slot that are due by "now" into the event buffer,
+ * flushing it to the event device when it fills up. Returns -1 if the
+ * event device pushed back before the slot was emptied.
+ */
+static int
+twtim_expire_slot(struct twtim *tw, struct twtim_node **head, uint64_t now)
+{
+	struct twtim_node *n, *next;
+
+	for (n = *head; n != NULL; n = next) {
+		next = n->next;
+
+		if (n->expiry > now)
+			continue;
+
+		if (unlikely(event_buffer_full(&tw->buffer)))
+			twtim_buffer_flush(tw->adapter, tw);
+
+		if (event_buffer_add(&tw->buffer, &n->evtim->ev) < 0) {
+			tw->stats.evtim_retry_count++;
+			EVTIM_LOG_DBG("event buffer full, retrying expiry on "
+				      "next service iteration");
+			return -1;
+		}
+
+		twtim_node_unlink(n);
+		n->evtim->state = RTE_EVENT_TIMER_NOT_ARMED;
+		tw->stats.evtim_exp_count++;
+
+		if (unlikely(tw->n_expired_nodes == EXP_TIM_BUF_SZ)) {
+			rte_mempool_put_bulk(tw->node_pool,
+					     (void **)tw->expired_nodes,
+					     tw->n_expired_nodes);
+			tw->n_expired_nodes = 0;
+		}
+		tw->expired_nodes[tw->n_expired_nodes++] = n;
+	}
+
+	return 0;
+}
+
+static int
+twtim_service_func(void *arg)
+{
+	struct rte_event_timer_adapter *adapter = arg;
+	struct twtim *tw = twtim_pmd_priv(adapter);
+	struct twtim_wheel *w;
+	uint64_t now, end, t;
+	unsigned int i;
+	bool stalled = false;
+
+	now = twtim_now_tick(tw);
+	if (now == tw->cur_tick) {
+		/* Retry events the event device pushed back on */
+		twtim_buffer_flush(adapter, tw);
+		return 0;
+	}
+
+	/* Stop only when the event device pushes back */
+	for (i = 0; i < tw->nb_wheels && !stalled; i++) {
+		w = &tw->wheels[tw->wheel_ids[i]];
+
+		rte_spinlock_lock(&w->lock);
+
+		/* If the service fell behind by more than a full rotation,
+		 * every slot only needs to be visited once.
+		 */
+		end = RTE_MIN(now, w->last_tick + tw->slot_mask + 1);
+		for (t = w->last_tick + 1; t <= end; t++) {
+			if (twtim_expire_slot(tw,
+					      &w->slots[t & tw->slot_mask],
+					      now) < 0) {
+				stalled = true;
+				break;
+			}
+		}
+		w->last_tick = stalled ? t - 1 : now;
+
+		rte_spinlock_unlock(&w->lock);
+
+		twtim_buffer_flush(adapter, tw);
+	}
+
+	/* Return expired nodes back to mempool */
+	rte_mempool_put_bulk(tw->node_pool, (void **)tw->expired_nodes,
+			     tw->n_expired_nodes);
+	tw->n_expired_nodes = 0;
+
+	tw->cur_tick = now;
+	tw->stats.adapter_tick_count++;
+
+	return 0;
+}
+
+static int
+twtim_wheel_alloc(struct twtim *tw, unsigned int wheel_id, int socket_id)
+{
+	struct twtim_wheel *w = &tw->wheels[wheel_id];
+
+	w->slots = rte_zmalloc_socket("twtim_wheel",
+				      sizeof(*w->slots) * (tw->slot_mask + 1),
+				      RTE_CACHE_LINE_SIZE, socket_id);
+	if (w->slots == NULL)
+		return -ENOMEM;
+
+	rte_spinlock_init(&w->lock);
+	w->last_tick = 0;
+	tw->wheel_ids[tw->nb_wheels++] = wheel_id;
+
+	return 0;
+}
+
+static void
+twtim_wheels_free(struct twtim *tw)
+{
+	unsigned int i;
+
+	for (i = 0; i < tw->nb_wheels; i++) {
+		rte_free(tw->wheels[tw->wheel_ids[i]].slots);
+		tw->wheels[tw->wheel_ids[i]].slots = NULL;
+	}
+	tw->nb_wheels = 0;
+}
+
+static int
+twtim_init(struct rte_event_timer_adapter *adapter)
+{
+	int ret;
+	struct twtim *tw;
+	unsigned int i;
+	uint64_t nb_ticks;
+	struct rte_service_spec service;
+
+	/* Allocate storage for private data area */
+#define TWTIM_NAMESIZE 32
+	char twtim_name[TWTIM_NAMESIZE];
+	snprintf(twtim_name, TWTIM_NAMESIZE, "twtim_%"PRIu8,
+			adapter->data->id);
+	tw = rte_zmalloc_socket(twtim_name, sizeof(*tw), RTE_CACHE_LINE_SIZE,
+			adapter->data->socket_id);
+	if (tw == NULL) {
+		EVTIM_LOG_ERR("failed to allocate space for private data");
+		rte_errno = ENOMEM;
+		return -1;
+	}
+
+	/* Connect storage to adapter instance */
+	adapter->data->adapter_priv = tw;
+	tw->adapter = adapter;
+
+	tw->timer_tick_ns = adapter->data->conf.timer_tick_ns;
+	tw->max_tmo_ns = adapter->data->conf.max_tmo_ns;
+	tw->cycles_per_tick = tw->timer_tick_ns * rte_get_timer_hz() /
+			NSECPERSEC;
+	if (tw->cycles_per_tick == 0)
+		tw->cycles_per_tick = 1;
+
+	/* One slot per tick of the maximum timeout, rounded up to a power of
+	 * 2 so that the slot index is a mask of the expiry tick.
+	 */
+	nb_ticks = tw->max_tmo_ns / tw->timer_tick_ns + 1;
+	tw->slot_mask = rte_align32pow2(RTE_MIN(nb_ticks,
+						(uint64_t)TWTIM_MAX_SLOTS)) - 1;
+
+	/* Create a node pool */
+	char pool_name[TWTIM_NAMESIZE];
+	snprintf(pool_name, TWTIM_NAMESIZE, "twtim_pool_%"PRIu8,
+		 adapter->data->id);
+	/* Optimal mempool size is a power of 2 minus one */
+	uint64_t nb_timers = rte_align64pow2(adapter->data->conf.nb_timers);
+	int pool_size = nb_timers - 1;
+	int cache_size = compute_msg_mempool_cache_size(
+				adapter->data->conf.nb_timers, nb_timers);
+	tw->node_pool = rte_mempool_create(pool_name, pool_size,
+			sizeof(struct twtim_node), cache_size, 0, NULL, NULL,
+			NULL, NULL, adapter->data->socket_id, 0);
+	if (tw->node_pool == NULL) {
+		EVTIM_LOG_ERR("failed to create timer node mempool");
+		rte_errno = ENOMEM;
+		goto free_alloc;
+	}
+
+	/* Allocate a wheel per lcore, plus the wheel of the highest lcore,
+	 * which is shared by non-EAL threads and lcores without one.
+	 */
+	RTE_LCORE_FOREACH(i) {
+		if (i == RTE_MAX_LCORE - 1)
+			continue;
+		ret = twtim_wheel_alloc(tw, i, adapter->data->socket_id);
+		if (ret < 0)
+			goto free_wheels;
+	}
+	ret = twtim_wheel_alloc(tw, RTE_MAX_LCORE - 1,
+				adapter->data->socket_id);
+	if (ret < 0)
+		goto free_wheels;
+
+	/* Initialize timer event buffer */
+	event_buffer_init(&tw->buffer);
+
+	tw->start_cycles = rte_get_timer_cycles();
+
+	/* Register a service component to run adapter logic */
+	memset(&service, 0, sizeof(service));
+	snprintf(service.name, RTE_SERVICE_NAME_MAX,
+		 "twtim_svc_%"PRIu8, adapter->data->id);
+	service.socket_id = adapter->data->socket_id;
+	service.callback = twtim_service_func;
+	service.callback_userdata = adapter;
+	service.capabilities &= ~(RTE_SERVICE_CAP_MT_SAFE);
+	ret = rte_service_component_register(&service, &tw->service_id);
+	if (ret < 0) {
+		EVTIM_LOG_ERR("failed to register service %s with id %"PRIu32
+			      ": err = %d", service.name, tw->service_id,
+			      ret);
+
+		rte_errno = ENOSPC;
+		goto free_wheels;
+	}
+
+	EVTIM_LOG_DBG("registered service %s with id %"PRIu32, service.name,
+		      tw->service_id);
+
+	adapter->data->service_id = tw->service_id;
+	adapter->data->service_inited = 1;
+
+	return 0;
+free_wheels:
+	if (ret == -ENOMEM) {
+		EVTIM_LOG_ERR("failed to allocate timer wheel");
+		rte_errno = ENOMEM;
+	}
+	twtim_wheels_free(tw);
+	rte_mempool_free(tw->node_pool);
+free_alloc:
+	rte_free(tw);
+	return -1;
+}
+
+/* Put the nodes of outstanding timers back in the mempool before freeing the
+ * adapter.
+ */
+static int
+twtim_uninit(struct rte_event_timer_adapter *adapter)
+{
+	int ret;
+	unsigned int i, j;
+	struct twtim_node *n, *next;
+	struct twtim *tw = twtim_pmd_priv(adapter);
+
+	for (i = 0; i < tw->nb_wheels; i++) {
+		struct twtim_wheel *w = &tw->wheels[tw->wheel_ids[i]];
+
+		for (j = 0; j <= tw->slot_mask; j++) {
+			for (n = w->slots[j]; n != NULL; n = next) {
+				next = n->next;
+				rte_mempool_put(tw->node_pool, n);
+			}
+			w->slots[j] = NULL;
+		}
+	}
+
+	ret = rte_service_component_unregister(tw->service_id);
+	if (ret < 0) {
+		EVTIM_LOG_ERR("failed to unregister service component");
+		return ret;
+	}
+
+	twtim_wheels_free(tw);
+	rte_mempool_free(tw->node_pool);
+	rte_free(tw);
+	adapter->data->adapter_priv = NULL;
+
+	return 0;
+}
+
+static void
+twtim_get_info(const struct rte_event_timer_adapter *adapter,
+		struct rte_event_timer_adapter_info *adapter_info)
+{
+	struct twtim *tw = twtim_pmd_priv(adapter);
+	adapter_info->min_resolution_ns = tw->timer_tick_ns;
+	adapter_info->max_tmo_ns = tw->max_tmo_ns;
+}
+
+static int
+twtim_stats_get(const struct rte_event_timer_adapter *adapter,
+		struct rte_event_timer_adapter_stats *stats)
+{
+	struct twtim *tw = twtim_pmd_priv(adapter);
+	*stats = tw->stats; /* structure copy */
+	return 0;
+}
+
+static int
+twtim_stats_reset(const struct rte_event_timer_adapter *adapter)
+{
+	struct twtim *tw = twtim_pmd_priv(adapter);
+	memset(&tw->stats, 0, sizeof(tw->stats));
+	return 0;
+}
+
+static uint16_t
+__twtim_arm_burst(const struct rte_event_timer_adapter *adapter,
+		struct rte_event_timer **evtims,
+		uint16_t nb_evtims)
+{
+	int i, ret;
+	struct twtim *tw = twtim_pmd_priv(adapter);
+	unsigned int wheel_id = rte_lcore_id();
+	struct twtim_node *n, *nodes[nb_evtims];
+	struct twtim_wheel *w;
+	uint64_t base, cycles;
+
+#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
+	/* Check that the service is running. */
+	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+#endif
+
+	/* Non-EAL threads, and lcores that were not enabled when the adapter
+	 * was created, share the wheel of the highest lcore.
+	 */
+	if (wheel_id >= RTE_MAX_LCORE || tw->wheels[wheel_id].slots == NULL)
+		wheel_id = RTE_MAX_LCORE - 1;
+	w = &tw->wheels[wheel_id];
+
+	ret = rte_mempool_get_bulk(tw->node_pool, (void **)nodes,
+				   nb_evtims);
+	if (ret < 0) {
+		rte_errno = ENOSPC;
+		return 0;
+	}
+
+	rte_spinlock_lock(&w->lock);
+
+	/* Start from the current tick rounded up, so that a timer never
+	 * expires before its timeout, and never insert behind the slot the
+	 * service is about to visit.
+	 */
+	cycles = rte_get_timer_cycles() - tw->start_cycles;
+	base = cycles / tw->cycles_per_tick +
+		(cycles % tw->cycles_per_tick != 0);
+	base = RTE_MAX(base, w->last_tick);
+
+	for (i = 0; i < nb_evtims; i++) {
+		/* Don't modify the event timer state in these cases */
+		if (evtims[i]->state == RTE_EVENT_TIMER_ARMED) {
+			rte_errno = EALREADY;
+			break;
+		} else if (!(evtims[i]->state == RTE_EVENT_TIMER_NOT_ARMED ||
+			     evtims[i]->state == RTE_EVENT_TIMER_CANCELED)) {
+			rte_errno = EINVAL;
+			break;
+		}
+
+		ret = twtim_check_timeout(evtims[i], tw);
+		if (unlikely(ret == -1)) {
+			evtims[i]->state = RTE_EVENT_TIMER_ERROR_TOOLATE;
+			rte_errno = EINVAL;
+			break;
+		} else if (unlikely(ret == -2)) {
+			evtims[i]->state = RTE_EVENT_TIMER_ERROR_TOOEARLY;
+			rte_errno = EINVAL;
+			break;
+		}
+
+		if (unlikely(check_destination_event_queue(evtims[i],
+							   adapter) < 0)) {
+			evtims[i]->state = RTE_EVENT_TIMER_ERROR;
+			rte_errno = EINVAL;
+			break;
+		}
+
+		n = nodes[i];
+		n->expiry = base + evtims[i]->timeout_ticks;
+		n->evtim = evtims[i];
+		twtim_node_insert(&w->slots[n->expiry & tw->slot_mask], n);
+
+		evtims[i]->impl_opaque[0] = (uintptr_t)n;
+		evtims[i]->impl_opaque[1] = wheel_id;
+
+		rte_smp_wmb();
+		EVTIM_LOG_DBG("armed an event timer");
+		evtims[i]->state = RTE_EVENT_TIMER_ARMED;
+	}
+
+	rte_spinlock_unlock(&w->lock);
+
+	if (i < nb_evtims)
+		rte_mempool_put_bulk(tw->node_pool,
+				     (void **)&nodes[i], nb_evtims - i);
+
+	return i;
+}
+
+static uint16_t
+twtim_arm_burst(const struct rte_event_timer_adapter *adapter,
+		struct rte_event_timer **evtims,
+		uint16_t nb_evtims)
+{
+	return __twtim_arm_burst(adapter, evtims, nb_evtims);
+}
+
+static uint16_t
+twtim_cancel_burst(const struct rte_event_timer_adapter *adapter,
+		   struct rte_event_timer **evtims,
+		   uint16_t nb_evtims)
+{
+	int i;
+	uint64_t wheel_id;
+	struct twtim_node *n;
+	struct twtim_wheel *w;
+	struct twtim *tw = twtim_pmd_priv(adapter);
+
+#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
+	/* Check that the service is running. */
+	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+#endif
+
+	for (i = 0; i < nb_evtims; i++) {
+		/* Don't modify the event timer state in these cases */
+		if (evtims[i]->state == RTE_EVENT_TIMER_CANCELED) {
+			rte_errno = EALREADY;
+			break;
+		} else if (evtims[i]->state != RTE_EVENT_TIMER_ARMED) {
+			rte_errno = EINVAL;
+			break;
+		}
+
+		rte_smp_rmb();
+
+		n = (struct twtim_node *)(uintptr_t)evtims[i]->impl_opaque[0];
+		wheel_id = evtims[i]->impl_opaque[1];
+		if (unlikely(n == NULL || wheel_id >= RTE_MAX_LCORE ||
+			     tw->wheels[wheel_id].slots == NULL)) {
+			/* Timer was not armed by this adapter */
+			rte_errno = EINVAL;
+			break;
+		}
+		w = &tw->wheels[wheel_id];
+
+		rte_spinlock_lock(&w->lock);
+
+		/* The service may have expired the timer in the meantime */
+		if (evtims[i]->state != RTE_EVENT_TIMER_ARMED ||
+		    n->evtim != evtims[i]) {
+			rte_spinlock_unlock(&w->lock);
+			rte_errno = EINVAL;
+			break;
+		}
+
+		twtim_node_unlink(n);
+		evtims[i]->state = RTE_EVENT_TIMER_CANCELED;
+
+		rte_spinlock_unlock(&w->lock);
+
+		rte_mempool_put(tw->node_pool, n);
+
+		evtims[i]->impl_opaque[0] = 0;
+		evtims[i]->impl_opaque[1] = 0;
+
+		rte_smp_wmb();
+	}
+
+	return i;
+}
+
+static uint16_t
+twtim_arm_tmo_tick_burst(const struct rte_event_timer_adapter *adapter,
+			 struct rte_event_timer **evtims,
+			 uint64_t timeout_ticks,
+			 uint16_t nb_evtims)
+{
+	int i;
+
+	for (i = 0; i < nb_evtims; i++)
+		evtims[i]->timeout_ticks = timeout_ticks;
+
+	return __twtim_arm_burst(adapter, evtims, nb_evtims);
+}
+
+static const struct rte_event_timer_adapter_ops twtim_ops = {
+	.init			= twtim_init,
+	.uninit			= twtim_uninit,
+	.start			= swtim_start,
+	.stop			= swtim_stop,
+	.get_info		= twtim_get_info,
+	.stats_get		= twtim_stats_get,
+	.stats_reset		= twtim_stats_reset,
+	.arm_burst		= twtim_arm_burst,
+	.arm_tmo_tick_burst	= twtim_arm_tmo_tick_burst,
+	.cancel_burst		= twtim_cancel_burst,
+};
+
 RTE_INIT(event_timer_adapter_init_log)
 {
 	evtim_logtype = rte_log_register("lib.eventdev.adapter.timer");
@@ -149,6 +149,16 @@ enum rte_event_timer_adapter_clk_src {
  *
  * @see struct rte_event_timer_adapter_conf::flags
  */
+#define RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL	(1ULL << 2)
+/**< When the event device has no timer adapter of its own, use the timer
+ * wheel based software implementation instead of the rte_timer based one.
+ * It keeps a hashed timing wheel per arming lcore, so that the cost of arming
+ * and canceling an event timer does not depend on the number of outstanding
+ * timers, and enqueues expired timer events to the event device in bursts.
+ * The flag is ignored by adapters provided by the event device driver.
+ *
+ * @see struct rte_event_timer_adapter_conf::flags
+ */
 
 /**
  * Timer adapter configuration structure
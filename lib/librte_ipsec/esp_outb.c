@@ -403,6 +403,179 @@ esp_outb_trs_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	return k;
 }
 
+/*
+ * fill the IV for cpu-crypto processing of ESP outbound packet,
+ * update *pofs* to the start of the data to process, return its length.
+ * *iv* contains the IV written into the packet at input.
+ */
+static inline uint32_t
+outb_cpu_crypto_prepare(const struct rte_ipsec_sa *sa, uint32_t *pofs,
+	uint32_t plen, void *iv)
+{
+	uint64_t ivp;
+	struct aead_gcm_iv *gcm;
+	struct aesctr_cnt_blk *ctr;
+
+	/* the IV is overwritten by the algorithm specific one */
+	ivp = ((uint64_t *)iv)[0];
+
+	switch (sa->algo_type) {
+	case ALGO_TYPE_AES_GCM:
+		gcm = iv;
+		aead_gcm_iv_fill(gcm, ivp, sa->salt);
+
+		/* AEAD processes the cipher data only */
+		*pofs += sa->ctp.cipher.offset;
+		return sa->ctp.cipher.length + plen;
+	case ALGO_TYPE_AES_CTR:
+		ctr = iv;
+		aes_ctr_cnt_blk_fill(ctr, ivp, sa->salt);
+		break;
+	}
+
+	*pofs += sa->ctp.auth.offset;
+	return sa->ctp.auth.length + plen;
+}
+
+/*
+ * setup/update packets for ESP outbound tunnel case and perform the crypto
+ * processing synchronously (RTE_SECURITY_ACTION_TYPE_CPU_CRYPTO).
+ */
+uint16_t
+cpu_outb_tun_pkt_prepare(const struct rte_ipsec_session *ss,
+		struct rte_mbuf *mb[], uint16_t num)
+{
+	int32_t rc;
+	uint32_t i, k, n;
+	uint64_t sqn;
+	rte_be64_t sqc;
+	struct rte_ipsec_sa *sa;
+	union sym_op_data icv;
+	void *iv[num];
+	void *aad[num];
+	void *dgst[num];
+	uint32_t dr[num];
+	uint32_t l4ofs[num];
+	uint32_t clen[num];
+	uint64_t ivbuf[num][IPSEC_MAX_IV_QWORD];
+
+	sa = ss->sa;
+
+	n = num;
+	sqn = esn_outb_update_sqn(sa, &n);
+	if (n != num)
+		rte_errno = EOVERFLOW;
+
+	k = 0;
+	for (i = 0; i != n; i++) {
+
+		sqc = rte_cpu_to_be_64(sqn + i);
+		gen_iv(ivbuf[k], sqc);
+
+		/* try to update the packet itself */
+		rc = outb_tun_pkt_prepare(sa, sqc, ivbuf[k], mb[i], &icv,
+					  sa->sqh_len);
+
+		/* success, proceed with preparations */
+		if (rc >= 0) {
+			outb_pkt_xprepare(sa, sqc, &icv);
+
+			iv[k] = ivbuf[k];
+			l4ofs[k] = 0;
+			clen[k] = outb_cpu_crypto_prepare(sa, &l4ofs[k], rc,
+				iv[k]);
+			aad[k] = icv.va + sa->icv_len;
+			dgst[k++] = icv.va;
+		/* failure, put packet into the death-row */
+		} else {
+			dr[i - k] = i;
+			rte_errno = -rc;
+		}
+	}
+
+	/* copy not prepared mbufs beyond good ones */
+	if (k != n && k != 0)
+		move_bad_mbufs(mb, dr, n, n - k);
+
+	/* convert mbufs to iovecs and do actual crypto/auth processing */
+	if (k != 0)
+		cpu_crypto_bulk(ss, sa->cofs, mb, iv, aad, dgst, l4ofs, clen,
+			k);
+
+	return k;
+}
+
+/*
+ * setup/update packets for ESP outbound transport case and perform the
+ * crypto processing synchronously (RTE_SECURITY_ACTION_TYPE_CPU_CRYPTO).
+ */
+uint16_t
+cpu_outb_trs_pkt_prepare(const struct rte_ipsec_session *ss,
+		struct rte_mbuf *mb[], uint16_t num)
+{
+	int32_t rc;
+	uint32_t i, k, n, l2, l3;
+	uint64_t sqn;
+	rte_be64_t sqc;
+	struct rte_ipsec_sa *sa;
+	union sym_op_data icv;
+	void *iv[num];
+	void *aad[num];
+	void *dgst[num];
+	uint32_t dr[num];
+	uint32_t l4ofs[num];
+	uint32_t clen[num];
+	uint64_t ivbuf[num][IPSEC_MAX_IV_QWORD];
+
+	sa = ss->sa;
+
+	n = num;
+	sqn = esn_outb_update_sqn(sa, &n);
+	if (n != num)
+		rte_errno = EOVERFLOW;
+
+	k = 0;
+	for (i = 0; i != n; i++) {
+
+		l2 = mb[i]->l2_len;
+		l3 = mb[i]->l3_len;
+
+		sqc = rte_cpu_to_be_64(sqn + i);
+		gen_iv(ivbuf[k], sqc);
+
+		/* try to update the packet itself */
+		rc = outb_trs_pkt_prepare(sa, sqc, ivbuf[k], mb[i], l2, l3,
+					  &icv, sa->sqh_len);
+
+		/* success, proceed with preparations */
+		if (rc >= 0) {
+			outb_pkt_xprepare(sa, sqc, &icv);
+
+			iv[k] = ivbuf[k];
+			l4ofs[k] = l2 + l3;
+			clen[k] = outb_cpu_crypto_prepare(sa, &l4ofs[k], rc,
+				iv[k]);
+			aad[k] = icv.va + sa->icv_len;
+			dgst[k++] = icv.va;
+		/* failure, put packet into the death-row */
+		} else {
+			dr[i - k] = i;
+			rte_errno = -rc;
+		}
+	}
+
+	/* copy not prepared mbufs beyond good ones */
+	if (k != n && k != 0)
+		move_bad_mbufs(mb, dr, n, n - k);
+
+	/* convert mbufs to iovecs and do actual crypto/auth processing */
+	if (k != 0)
+		cpu_crypto_bulk(ss, sa->cofs, mb, iv, aad, dgst, l4ofs, clen,
+			k);
+
+	return k;
+}
+
 /*
  * process outbound packets for SA with ESN support,
  * for algorithms that require SQN.hibits to be implictly included
@@ -105,4 +105,90 @@ mbuf_cut_seg_ofs(struct rte_mbuf *mb, struct rte_mbuf *ms, uint32_t ofs,
 	mb->pkt_len -= len;
 }
 
+/*
+ * helper function for cpu_crypto_bulk(), process packets [first, last)
+ * with one call to the crypto device.
+ */
+static inline void
+cpu_crypto_bulk_flush(const struct rte_ipsec_session *ss,
+	union rte_crypto_sym_ofs ofs, struct rte_crypto_sgl vecpkt[],
+	void *iv[], void *aad[], void *dgst[], int32_t st[], uint32_t first,
+	uint32_t last)
+{
+	struct rte_crypto_sym_vec symvec;
+
+	if (first == last)
+		return;
+
+	symvec.sgl = &vecpkt[first];
+	symvec.iv = &iv[first];
+	symvec.aad = &aad[first];
+	symvec.digest = &dgst[first];
+	symvec.status = &st[first];
+	symvec.num = last - first;
+
+	rte_cryptodev_sym_cpu_crypto_process(ss->crypto.dev_id,
+		ss->crypto.ses, ofs, &symvec);
+}
+
+/*
+ * process packets using sync crypto engine.
+ * expects all packets to be in the same SA/session.
+ * packets that failed processing are flagged with PKT_RX_SEC_OFFLOAD_FAILED,
+ * to be rejected by *process* function.
+ */
+static inline void
+cpu_crypto_bulk(const struct rte_ipsec_session *ss,
+	union rte_crypto_sym_ofs ofs, struct rte_mbuf *mb[],
+	void *iv[], void *aad[], void *dgst[], uint32_t l4ofs[],
+	uint32_t clen[], uint32_t num)
+{
+	uint32_t i, j, vofs;
+	int32_t vcnt;
+	int32_t st[num];
+	struct rte_crypto_sgl vecpkt[num];
+	struct rte_crypto_vec vec[UINT8_MAX];
+
+	const uint32_t vnum = RTE_DIM(vec);
+
+	j = 0;
+	vofs = 0;
+	for (i = 0; i != num; i++) {
+
+		vcnt = rte_crypto_mbuf_to_vec(mb[i], l4ofs[i], clen[i],
+			&vec[vofs], vnum - vofs);
+
+		/* not enough space in vec[] to hold all segments */
+		if (vcnt < 0) {
+
+			/* flush vec array and try again */
+			cpu_crypto_bulk_flush(ss, ofs, vecpkt, iv, aad, dgst,
+				st, j, i);
+			vofs = 0;
+			j = i;
+
+			vcnt = rte_crypto_mbuf_to_vec(mb[i], l4ofs[i],
+				clen[i], vec, vnum);
+
+			/* too many segments for one packet */
+			if (vcnt < 0) {
+				st[i] = EMSGSIZE;
+				j = i + 1;
+				continue;
+			}
+		}
+
+		vecpkt[i].vec = &vec[vofs];
+		vecpkt[i].num = vcnt;
+		vofs += vcnt;
+	}
+
+	cpu_crypto_bulk_flush(ss, ofs, vecpkt, iv, aad, dgst, st, j, num);
+
+	for (i = 0; i != num; i++) {
+		if (st[i] != 0)
+			mb[i]->ol_flags |= PKT_RX_SEC_OFFLOAD_FAILED;
+	}
+}
+
 #endif /* _MISC_H_ */
@@ -11,9 +11,19 @@ session_check(struct rte_ipsec_session *ss)
 	if (ss == NULL || ss->sa == NULL)
 		return -EINVAL;
 
-	if (ss->type == RTE_SECURITY_ACTION_TYPE_NONE) {
+	if (ss->type == RTE_SECURITY_ACTION_TYPE_NONE ||
+			ss->type == RTE_SECURITY_ACTION_TYPE_CPU_CRYPTO) {
+		struct rte_cryptodev_info info;
+
 		if (ss->crypto.ses == NULL)
 			return -EINVAL;
+
+		if (ss->type == RTE_SECURITY_ACTION_TYPE_CPU_CRYPTO) {
+			rte_cryptodev_info_get(ss->crypto.dev_id, &info);
+			if (!(info.feature_flags &
+					RTE_CRYPTODEV_FF_SYM_CPU_CRYPTO))
+				return -ENOTSUP;
+		}
 	} else {
 		if (ss->security.ses == NULL)
 			return -EINVAL;
@@ -43,7 +53,8 @@ rte_ipsec_session_prepare(struct rte_ipsec_session *ss)
 
 	ss->pkt_func = fp;
 
-	if (ss->type == RTE_SECURITY_ACTION_TYPE_NONE)
+	if (ss->type == RTE_SECURITY_ACTION_TYPE_NONE ||
+			ss->type == RTE_SECURITY_ACTION_TYPE_CPU_CRYPTO)
 		ss->crypto.ses->opaque_data = (uintptr_t)ss;
 	else
 		ss->security.ses->opaque_data = (uintptr_t)ss;
@@ -33,6 +33,7 @@ latencystat_cycles_per_ns(void)
 
 static const char *MZ_RTE_LATENCY_STATS = "rte_latencystats";
 static int latency_stats_index;
+static int latency_hist_index = -1;
 static uint64_t samp_intvl;
 static uint64_t timer_tsc;
 static uint64_t prev_tsc;
@@ -68,6 +69,9 @@ static const struct latency_stats_nameoff lat_stats_strings[] = {
 #define NUM_LATENCY_STATS (sizeof(lat_stats_strings) / \
 				sizeof(lat_stats_strings[0]))
 
+/** Per-lcore histogram of all measured latencies */
+#define LATENCY_HIST_NAME "latency_hist_ns"
+
 int32_t
 rte_latencystats_update(void)
 {
@@ -164,6 +168,13 @@ calc_latency(uint16_t pid __rte_unused,
 			latency[cnt++] = now - pkts[i]->timestamp;
 	}
 
+	if (latency_hist_index >= 0) {
+		for (i = 0; i < cnt; i++)
+			rte_metrics_lcore_hist_add(latency_hist_index,
+				(uint64_t)(latency[i] /
+					latencystat_cycles_per_ns()));
+	}
+
 	for (i = 0; i < cnt; i++) {
 		/*
 		 * The jitter is calculated as statistical mean of interpacket
@@ -237,6 +248,13 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 		return -1;
 	}
 
+	/** Latency histogram is optional, updated lock-free per lcore */
+	latency_hist_index = rte_metrics_reg_lcore_metric(LATENCY_HIST_NAME,
+			RTE_METRICS_TYPE_LCORE_HISTOGRAM);
+	if (latency_hist_index < 0)
+		RTE_LOG(DEBUG, LATENCY_STATS,
+			"Failed to register latency histogram\n");
+
 	/** Register Rx/Tx callbacks */
 	RTE_ETH_FOREACH_DEV(pid) {
 		struct rte_eth_dev_info dev_info;
@@ -312,6 +330,11 @@ rte_latencystats_uninit(void)
 		}
 	}
 
+	if (latency_hist_index >= 0) {
+		rte_metrics_unreg_lcore_metric(latency_hist_index);
+		latency_hist_index = -1;
+	}
+
 	/* free up the memzone */
 	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
 	if (mz)
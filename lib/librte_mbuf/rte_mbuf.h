@@ -31,6 +31,7 @@
  * http://www.kohala.com/start/tcpipiv2.html
  */
 
+#include <stddef.h>
 #include <stdint.h>
 #include <rte_compat.h>
 #include <rte_common.h>
@@ -303,9 +304,43 @@ rte_mbuf_to_priv(struct rte_mbuf *m)
 struct rte_pktmbuf_pool_private {
 	uint16_t mbuf_data_room_size; /**< Size of data space in each mbuf. */
 	uint16_t mbuf_priv_size;      /**< Size of private area in each mbuf. */
-	uint32_t flags; /**< reserved for future use. */
+	uint32_t flags; /**< Pool flags, see RTE_PKTMBUF_POOL_F_*. */
 };
 
+/**
+ * The mbufs of the pool are attached to pinned external buffers. Such
+ * mbufs are never detached from their buffer, the attachment is done
+ * once at pool creation (see rte_pktmbuf_pool_create_extbuf()).
+ */
+#define RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF (1 << 0)
+
+/**
+ * Get the flags of a pktmbuf pool.
+ *
+ * @param mp
+ *   The packet mbuf pool.
+ * @return
+ *   The flags of the pool (RTE_PKTMBUF_POOL_F_*).
+ */
+static inline uint32_t
+rte_pktmbuf_priv_flags(struct rte_mempool *mp)
+{
+	struct rte_pktmbuf_pool_private *mbp_priv;
+
+	mbp_priv = (struct rte_pktmbuf_pool_private *)rte_mempool_get_priv(mp);
+	return mbp_priv->flags;
+}
+
+/**
+ * Returns TRUE if given mbuf has a pinned external buffer, or FALSE
+ * otherwise. The pinned external buffer is allocated at pool creation
+ * time and should not be freed on mbuf freeing.
+ *
+ * External buffer is a user-provided anonymous buffer.
+ */
+#define RTE_MBUF_HAS_PINNED_EXTBUF(mb) \
+	(rte_pktmbuf_priv_flags((mb)->pool) & RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF)
+
 #ifdef RTE_LIBRTE_MBUF_DEBUG
 
 /**  check mbuf type in debug mode */
@@ -571,7 +606,8 @@ static inline struct rte_mbuf *rte_mbuf_raw_alloc(struct rte_mempool *mp)
 static __rte_always_inline void
 rte_mbuf_raw_free(struct rte_mbuf *m)
 {
-	RTE_ASSERT(RTE_MBUF_DIRECT(m));
+	RTE_ASSERT(!RTE_MBUF_CLONED(m) &&
+		  (!RTE_MBUF_HAS_EXTBUF(m) || RTE_MBUF_HAS_PINNED_EXTBUF(m)));
 	RTE_ASSERT(rte_mbuf_refcnt_read(m) == 1);
 	RTE_ASSERT(m->next == NULL);
 	RTE_ASSERT(m->nb_segs == 1);
@@ -702,6 +738,78 @@ rte_pktmbuf_pool_create_by_ops(const char *name, unsigned int n,
 	unsigned int cache_size, uint16_t priv_size, uint16_t data_room_size,
 	int socket_id, const char *ops_name);
 
+/** A structure that describes the pinned external buffer segment. */
+struct rte_pktmbuf_extmem {
+	void *buf_ptr;		/**< The virtual address of data buffer. */
+	rte_iova_t buf_iova;	/**< The IO address of the data buffer. */
+	size_t buf_len;		/**< External buffer length in bytes. */
+	uint16_t elt_size;	/**< mbuf element size in bytes. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: This API may change without prior notice.
+ *
+ * Create a mbuf pool with external pinned data buffers.
+ *
+ * This function creates and initializes a packet mbuf pool that contains
+ * only mbufs with external buffer. It is a wrapper to rte_mempool
+ * functions.
+ *
+ * The data buffers are provided by the application as an array of memory
+ * areas; each area is split into elements of ext_mem->elt_size bytes and
+ * every mbuf of the pool is permanently attached to one of them. The
+ * mbufs are never detached from their data buffer, so the free path does
+ * not call any shared info free callback.
+ *
+ * The memory areas should be registered with rte_extmem_register() (and
+ * DMA-mapped if required) by the application before the pool is used.
+ *
+ * @param name
+ *   The name of the mbuf pool.
+ * @param n
+ *   The number of elements in the mbuf pool. The optimum size (in terms
+ *   of memory usage) for a mempool is when n is a power of two minus one:
+ *   n = (2^q - 1).
+ * @param cache_size
+ *   Size of the per-core object cache. See rte_mempool_create() for
+ *   details.
+ * @param priv_size
+ *   Size of application private are between the rte_mbuf structure
+ *   and the data buffer. This value must be aligned to RTE_MBUF_PRIV_ALIGN.
+ * @param data_room_size
+ *   Size of data buffer in each mbuf, including RTE_PKTMBUF_HEADROOM.
+ *   It must not exceed the elt_size of any of the memory areas.
+ * @param socket_id
+ *   The socket identifier where the memory should be allocated. The
+ *   value can be *SOCKET_ID_ANY* if there is no NUMA constraint for the
+ *   reserved zone.
+ * @param ext_mem
+ *   Pointer to the array of structures describing the external memory
+ *   for data buffers. It is caller responsibility to register this memory
+ *   with rte_extmem_register() (if needed), map this memory to appropriate
+ *   physical device, etc.
+ * @param ext_num
+ *   Number of elements in the ext_mem array.
+ * @return
+ *   The pointer to the new allocated mempool, on success. NULL on error
+ *   with rte_errno set appropriately. Possible rte_errno values include:
+ *    - E_RTE_NO_CONFIG - function could not get pointer to rte_config structure
+ *    - E_RTE_SECONDARY - function was called from a secondary process instance
+ *    - EINVAL - cache size provided is too large, or priv_size is not
+ *      aligned, or the external memory description is invalid.
+ *    - ENOSPC - the maximum number of memzones has already been allocated
+ *    - EEXIST - a memzone with the same name already exists
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ */
+__rte_experimental
+struct rte_mempool *
+rte_pktmbuf_pool_create_extbuf(const char *name, unsigned int n,
+	unsigned int cache_size, uint16_t priv_size,
+	uint16_t data_room_size, int socket_id,
+	const struct rte_pktmbuf_extmem *ext_mem,
+	unsigned int ext_num);
+
 /**
  * Get the data room size of mbufs stored in a pktmbuf_pool
  *
@@ -777,7 +885,7 @@ static inline void rte_pktmbuf_reset(struct rte_mbuf *m)
 	m->nb_segs = 1;
 	m->port = MBUF_INVALID_PORT;
 
-	m->ol_flags = 0;
+	m->ol_flags &= EXT_ATTACHED_MBUF;
 	m->packet_type = 0;
 	rte_pktmbuf_reset_headroom(m);
 
@@ -810,6 +918,13 @@ static inline struct rte_mbuf *rte_pktmbuf_alloc(struct rte_mempool *mp)
  * Allocate a bulk of mbufs, initialize refcnt and reset the fields to default
  * values.
  *
+ * The mbufs are reset as by rte_pktmbuf_reset(), but the 16 bytes of
+ * rearm_data and ol_flags are written from a template built once per call,
+ * with the same kind of wide store as the vector PMDs use to rearm their Rx
+ * descriptors. The template is derived from the first mbuf, all the mbufs of
+ * a pool having the same buffer length and the same kind of buffer
+ * attachment.
+ *
  *  @param pool
  *    The mempool from which mbufs are allocated.
  *  @param mbufs
@@ -823,41 +938,43 @@ static inline struct rte_mbuf *rte_pktmbuf_alloc(struct rte_mempool *mp)
 static inline int rte_pktmbuf_alloc_bulk(struct rte_mempool *pool,
 	 struct rte_mbuf **mbufs, unsigned count)
 {
-	unsigned idx = 0;
+	const size_t tmpl_off = offsetof(struct rte_mbuf, rearm_data);
+	struct rte_mbuf mb_def;
+	struct rte_mbuf *m;
+	unsigned idx;
 	int rc;
 
 	rc = rte_mempool_get_bulk(pool, (void **)mbufs, count);
 	if (unlikely(rc))
 		return rc;
+	if (unlikely(count == 0))
+		return 0;
 
-	/* To understand duff's device on loop unwinding optimization, see
-	 * https://en.wikipedia.org/wiki/Duff's_device.
-	 * Here while() loop is used rather than do() while{} to avoid extra
-	 * check if count is zero.
-	 */
-	switch (count % 4) {
-	case 0:
-		while (idx != count) {
-			MBUF_RAW_ALLOC_CHECK(mbufs[idx]);
-			rte_pktmbuf_reset(mbufs[idx]);
-			idx++;
-			/* fall-through */
-	case 3:
-			MBUF_RAW_ALLOC_CHECK(mbufs[idx]);
-			rte_pktmbuf_reset(mbufs[idx]);
-			idx++;
-			/* fall-through */
-	case 2:
-			MBUF_RAW_ALLOC_CHECK(mbufs[idx]);
-			rte_pktmbuf_reset(mbufs[idx]);
-			idx++;
-			/* fall-through */
-	case 1:
-			MBUF_RAW_ALLOC_CHECK(mbufs[idx]);
-			rte_pktmbuf_reset(mbufs[idx]);
-			idx++;
-			/* fall-through */
-		}
+	/* the template covers rearm_data and ol_flags, which follows it */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, ol_flags) !=
+			offsetof(struct rte_mbuf, rearm_data) + 8);
+
+	m = mbufs[0];
+	mb_def.data_off = (uint16_t)RTE_MIN((uint16_t)RTE_PKTMBUF_HEADROOM,
+			(uint16_t)m->buf_len);
+	rte_mbuf_refcnt_set(&mb_def, 1);
+	mb_def.nb_segs = 1;
+	mb_def.port = MBUF_INVALID_PORT;
+	mb_def.ol_flags = m->ol_flags & EXT_ATTACHED_MBUF;
+
+	for (idx = 0; idx < count; idx++) {
+		m = mbufs[idx];
+		MBUF_RAW_ALLOC_CHECK(m);
+		memcpy(RTE_PTR_ADD(m, tmpl_off), RTE_PTR_ADD(&mb_def, tmpl_off),
+				16);
+		m->packet_type = 0;
+		m->pkt_len = 0;
+		m->data_len = 0;
+		m->vlan_tci = 0;
+		m->vlan_tci_outer = 0;
+		m->next = NULL;
+		m->tx_offload = 0;
+		__rte_mbuf_sanity_check(m, 1);
 	}
 	return 0;
 }
@@ -1141,10 +1258,17 @@ static inline void rte_pktmbuf_detach(struct rte_mbuf *m)
 	uint32_t mbuf_size, buf_len;
 	uint16_t priv_size;
 
-	if (RTE_MBUF_HAS_EXTBUF(m))
+	if (RTE_MBUF_HAS_EXTBUF(m)) {
+		/*
+		 * The pinned external buffer should not be
+		 * detached from its backing mbuf, just exit.
+		 */
+		if (RTE_MBUF_HAS_PINNED_EXTBUF(m))
+			return;
 		__rte_pktmbuf_free_extbuf(m);
-	else
+	} else {
 		__rte_pktmbuf_free_direct(m);
+	}
 
 	priv_size = rte_pktmbuf_priv_size(mp);
 	mbuf_size = (uint32_t)(sizeof(struct rte_mbuf) + priv_size);
@@ -1159,6 +1283,42 @@ static inline void rte_pktmbuf_detach(struct rte_mbuf *m)
 	m->ol_flags = 0;
 }
 
+/**
+ * @internal Handle the packet mbufs with attached pinned external buffer
+ * on the mbuf freeing:
+ *
+ *  - return zero if reference counter in shinfo is one. It means there is
+ *  no more reference to this pinned buffer and mbuf can be returned to
+ *  the pool
+ *
+ *  - otherwise (if reference counter is not one), decrement reference
+ *  counter and return non-zero value to prevent freeing the backing mbuf.
+ *
+ * Returns non zero if mbuf should not be freed.
+ */
+static inline int __rte_pktmbuf_pinned_extbuf_decref(struct rte_mbuf *m)
+{
+	struct rte_mbuf_ext_shared_info *shinfo;
+
+	/* Clear flags, mbuf is being freed. */
+	m->ol_flags = EXT_ATTACHED_MBUF;
+	shinfo = m->shinfo;
+
+	/* Optimize for performance - do not dec/reinit */
+	if (likely(rte_mbuf_ext_refcnt_read(shinfo) == 1))
+		return 0;
+
+	/* Some clones still reference the buffer, the last detach
+	 * returns the mbuf to its pool through the free callback.
+	 */
+	if (likely(rte_mbuf_ext_refcnt_update(shinfo, -1) != 0))
+		return 1;
+
+	/* Reinitialize counter before mbuf freeing. */
+	rte_mbuf_ext_refcnt_set(shinfo, 1);
+	return 0;
+}
+
 /**
  * Decrease reference counter and unlink a mbuf segment
  *
@@ -1180,8 +1340,13 @@ rte_pktmbuf_prefree_seg(struct rte_mbuf *m)
 
 	if (likely(rte_mbuf_refcnt_read(m) == 1)) {
 
-		if (!RTE_MBUF_DIRECT(m))
+		if (!RTE_MBUF_DIRECT(m)) {
 			rte_pktmbuf_detach(m);
+			if (RTE_MBUF_HAS_EXTBUF(m) &&
+			    RTE_MBUF_HAS_PINNED_EXTBUF(m) &&
+			    __rte_pktmbuf_pinned_extbuf_decref(m))
+				return NULL;
+		}
 
 		if (m->next != NULL) {
 			m->next = NULL;
@@ -1192,8 +1357,13 @@ rte_pktmbuf_prefree_seg(struct rte_mbuf *m)
 
 	} else if (__rte_mbuf_refcnt_update(m, -1) == 0) {
 
-		if (!RTE_MBUF_DIRECT(m))
+		if (!RTE_MBUF_DIRECT(m)) {
 			rte_pktmbuf_detach(m);
+			if (RTE_MBUF_HAS_EXTBUF(m) &&
+			    RTE_MBUF_HAS_PINNED_EXTBUF(m) &&
+			    __rte_pktmbuf_pinned_extbuf_decref(m))
+				return NULL;
+		}
 
 		if (m->next != NULL) {
 			m->next = NULL;
@@ -1261,6 +1431,56 @@ static inline void rte_pktmbuf_free(struct rte_mbuf *m)
 __rte_experimental
 void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: This API may change without prior notice.
+ *
+ * Free a bulk of packet mbufs known to be of the simplest kind back into
+ * their mempool.
+ *
+ * Unlike rte_pktmbuf_free_bulk(), the mbufs are not checked one by one:
+ * they are put back in their mempool, usually in its per-lcore cache,
+ * with a single call. This is only valid if all the mbufs:
+ *  - are not NULL,
+ *  - have one segment,
+ *  - have a reference counter of 1,
+ *  - are direct, or attached to a pinned external buffer that is not
+ *    shared with other mbufs,
+ *  - come from the same mempool.
+ *
+ * This is the software counterpart of the DEV_TX_OFFLOAD_MBUF_FAST_FREE
+ * Tx offload.
+ *
+ *  @param mbufs
+ *    Array of pointers to packet mbufs.
+ *  @param count
+ *    Array size.
+ */
+__rte_experimental
+static inline void
+rte_pktmbuf_fast_free_bulk(struct rte_mbuf **mbufs, unsigned int count)
+{
+	unsigned int idx;
+
+	if (unlikely(count == 0))
+		return;
+
+	for (idx = 0; idx < count; idx++) {
+		struct rte_mbuf *m = mbufs[idx];
+
+		__rte_mbuf_sanity_check(m, 1);
+		RTE_ASSERT(m->pool == mbufs[0]->pool);
+		RTE_ASSERT(m->next == NULL && m->nb_segs == 1);
+		RTE_ASSERT(rte_mbuf_refcnt_read(m) == 1);
+		RTE_ASSERT(RTE_MBUF_DIRECT(m) ||
+			   (RTE_MBUF_HAS_PINNED_EXTBUF(m) &&
+			    rte_mbuf_ext_refcnt_read(m->shinfo) == 1));
+		RTE_SET_USED(m);
+	}
+
+	rte_mempool_put_bulk(mbufs[0]->pool, (void **)mbufs, count);
+}
+
 /**
  * Create a "clone" of the given packet mbuf.
  *
@@ -717,6 +717,121 @@ mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
 	cache->len = 0;
 }
 
+/*
+ * Number of get/put operations between two resize checks of an adaptive
+ * cache, and thresholds of pool accesses per check to grow or shrink it.
+ */
+#define CACHE_ADAPT_PERIOD	256
+#define CACHE_ADAPT_GROW_THRESH	(CACHE_ADAPT_PERIOD / 16)
+#define CACHE_ADAPT_IDLE_CHECKS	8
+
+/* check the pool accesses of an adaptive cache and resize it */
+void
+rte_mempool_cache_adapt(struct rte_mempool *mp,
+			struct rte_mempool_cache *cache)
+{
+	struct rte_mempool_cache_adapt_state *state;
+	uint32_t size = cache->size;
+	uint32_t events;
+
+	state = __mempool_cache_adapt_state(mp, cache);
+	if (state == NULL)
+		return;
+
+	events = state->slow;
+	state->slow = 0;
+	state->ops = CACHE_ADAPT_PERIOD;
+
+	if (events >= CACHE_ADAPT_GROW_THRESH) {
+		/* the pool is accessed too often, grow the cache */
+		state->idle = 0;
+		size = RTE_MIN(size * 2, mp->cache_size);
+	} else if (events == 0) {
+		/* shrink a cache that did not need the pool for a while */
+		if (++state->idle < CACHE_ADAPT_IDLE_CHECKS)
+			return;
+		state->idle = 0;
+		size = RTE_MAX(size / 2, state->min_size);
+	} else {
+		state->idle = 0;
+	}
+
+	if (size == cache->size)
+		return;
+
+	cache->size = size;
+	cache->flushthresh = CALC_CACHE_FLUSHTHRESH(size);
+	state->resize++;
+
+	/* give the objects that do not fit anymore back to the pool */
+	if (cache->len > size) {
+		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[size],
+				cache->len - size);
+		cache->len = size;
+	}
+}
+
+/* enable or disable the adaptive sizing of the default caches */
+int
+rte_mempool_cache_adaptive_set(struct rte_mempool *mp, uint32_t min_size)
+{
+	struct rte_mempool_cache_adapt_state *state;
+	struct rte_mempool_cache *cache;
+	unsigned int lcore_id;
+
+	if (mp->cache_size == 0 || min_size > mp->cache_size)
+		return -EINVAL;
+
+	mp->flags &= ~MEMPOOL_F_CACHE_ADAPTIVE;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		cache = &mp->local_cache[lcore_id];
+		state = __mempool_cache_adapt_state(mp, cache);
+
+		state->ops = CACHE_ADAPT_PERIOD;
+		state->slow = 0;
+		state->idle = 0;
+		state->min_size = min_size;
+
+		/* start from the creation size, as a fixed cache */
+		cache->size = mp->cache_size;
+		cache->flushthresh = CALC_CACHE_FLUSHTHRESH(mp->cache_size);
+	}
+
+	if (min_size != 0)
+		mp->flags |= MEMPOOL_F_CACHE_ADAPTIVE;
+
+	return 0;
+}
+
+/* get the statistics of a default cache */
+int
+rte_mempool_cache_stats_get(const struct rte_mempool *mp, unsigned int lcore_id,
+			    struct rte_mempool_cache_stats *stats,
+			    uint32_t *size)
+{
+	struct rte_mempool *m = (struct rte_mempool *)(uintptr_t)mp;
+	const struct rte_mempool_cache_adapt_state *state;
+
+	if (mp->cache_size == 0 || lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	if (stats != NULL) {
+		state = __mempool_cache_adapt_state(m,
+			&m->local_cache[lcore_id]);
+		stats->get_hit = state->get_hit;
+		stats->get_miss = state->get_miss;
+		stats->put_hit = state->put_hit;
+		stats->put_flush = state->put_flush;
+		stats->resize = state->resize;
+	}
+
+	if (size != NULL)
+		*size = mp->local_cache[lcore_id].size;
+
+	return 0;
+}
+
 /*
  * Create and initialize a cache for objects that are retrieved from and
  * returned to an underlying mempool. This structure is identical to the
@@ -829,6 +944,10 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	mempool_size = MEMPOOL_HEADER_SIZE(mp, cache_size);
 	mempool_size += private_data_size;
+	/* adaptive state of the default caches, after the private data */
+	if (cache_size != 0)
+		mempool_size += sizeof(struct rte_mempool_cache_adapt_state) *
+			RTE_MAX_LCORE;
 	mempool_size = RTE_ALIGN_CEIL(mempool_size, RTE_MEMPOOL_ALIGN);
 
 	ret = snprintf(mz_name, sizeof(mz_name), RTE_MEMPOOL_MZ_FORMAT, name);
@@ -851,7 +970,7 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 	}
 	mp->mz = mz;
 	mp->size = n;
-	mp->flags = flags;
+	mp->flags = flags & ~MEMPOOL_F_CACHE_ADAPTIVE;
 	mp->socket_id = socket_id;
 	mp->elt_size = objsz.elt_size;
 	mp->header_size = objsz.header_size;
@@ -874,6 +993,9 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 			mempool_cache_init(&mp->local_cache[lcore_id],
 					   cache_size);
+		memset(__mempool_cache_adapt_state(mp, &mp->local_cache[0]), 0,
+		       sizeof(struct rte_mempool_cache_adapt_state) *
+		       RTE_MAX_LCORE);
 	}
 
 	te->data = mp;
@@ -977,6 +1099,9 @@ rte_mempool_in_use_count(const struct rte_mempool *mp)
 static unsigned
 rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 {
+	struct rte_mempool *m = (struct rte_mempool *)(uintptr_t)mp;
+	const struct rte_mempool_cache_adapt_state *state;
+	struct rte_mempool_cache_stats sum;
 	unsigned lcore_id;
 	unsigned count = 0;
 	unsigned cache_count;
@@ -987,13 +1112,32 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 	if (mp->cache_size == 0)
 		return count;
 
+	memset(&sum, 0, sizeof(sum));
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
-		cache_count = mp->local_cache[lcore_id].len;
+		const struct rte_mempool_cache *cache =
+			&mp->local_cache[lcore_id];
+
+		cache_count = cache->len;
 		fprintf(f, "    cache_count[%u]=%"PRIu32"\n",
 			lcore_id, cache_count);
 		count += cache_count;
+
+		if (mp->flags & MEMPOOL_F_CACHE_ADAPTIVE)
+			fprintf(f, "    cache_adapted_size[%u]=%"PRIu32"\n",
+				lcore_id, cache->size);
+
+		state = __mempool_cache_adapt_state(m,
+			&m->local_cache[lcore_id]);
+		sum.get_hit += state->get_hit;
+		sum.get_miss += state->get_miss;
+		sum.put_hit += state->put_hit;
+		sum.put_flush += state->put_flush;
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
+	fprintf(f, "    cache_get_hit=%"PRIu64"\n", sum.get_hit);
+	fprintf(f, "    cache_get_miss=%"PRIu64"\n", sum.get_miss);
+	fprintf(f, "    cache_put_hit=%"PRIu64"\n", sum.put_hit);
+	fprintf(f, "    cache_put_flush=%"PRIu64"\n", sum.put_flush);
 	return count;
 }
 
@@ -77,6 +77,19 @@ struct rte_mempool_debug_stats {
 } __rte_cache_aligned;
 #endif
 
+/**
+ * A structure that stores the statistics of a per-core object cache.
+ *
+ * Each counter is a number of get or put operations (not objects).
+ */
+struct rte_mempool_cache_stats {
+	uint64_t get_hit;   /**< Gets served from the cache. */
+	uint64_t get_miss;  /**< Gets that had to access the pool. */
+	uint64_t put_hit;   /**< Puts absorbed by the cache. */
+	uint64_t put_flush; /**< Puts that had to flush to the pool. */
+	uint64_t resize;    /**< Number of adaptive cache size changes. */
+};
+
 /**
  * A structure that stores a per-core object cache.
  */
@@ -91,6 +104,26 @@ struct rte_mempool_cache {
 	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE * 3]; /**< Cache objects */
 } __rte_cache_aligned;
 
+/**
+ * @internal Statistics and adaptive sizing state of a per-lcore default
+ * cache.
+ *
+ * It is kept out of struct rte_mempool_cache, in an array stored after
+ * the private data of the mempool, so the layout used by the inline
+ * get/put functions is unchanged.
+ */
+struct rte_mempool_cache_adapt_state {
+	uint32_t ops;       /**< Ops before next resize check */
+	uint32_t slow;      /**< Pool accesses since the last check */
+	uint32_t idle;      /**< Consecutive checks without pool access */
+	uint32_t min_size;  /**< Lower bound of adaptive size */
+	uint64_t resize;    /**< Number of adaptive size changes */
+	uint64_t get_hit;   /**< Gets served from the cache */
+	uint64_t get_miss;  /**< Gets that had to access the pool */
+	uint64_t put_hit;   /**< Puts absorbed by the cache */
+	uint64_t put_flush; /**< Puts that had to flush to the pool */
+} __rte_cache_aligned;
+
 /**
  * A structure that stores the size of mempool elements.
  */
@@ -266,6 +299,7 @@ struct rte_mempool {
 #define MEMPOOL_F_SC_GET         0x0008 /**< Default get is "single-consumer".*/
 #define MEMPOOL_F_POOL_CREATED   0x0010 /**< Internal: pool is created. */
 #define MEMPOOL_F_NO_IOVA_CONTIG 0x0020 /**< Don't need IOVA contiguous objs. */
+#define MEMPOOL_F_CACHE_ADAPTIVE 0x0040 /**< Internal: adaptive cache size. */
 #define MEMPOOL_F_NO_PHYS_CONTIG MEMPOOL_F_NO_IOVA_CONTIG /* deprecated */
 
 /**
@@ -1266,6 +1300,139 @@ rte_mempool_default_cache(struct rte_mempool *mp, unsigned lcore_id)
 	return &mp->local_cache[lcore_id];
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the statistics of the per-lcore default mempool cache.
+ *
+ * The statistics are updated without synchronization by the lcore owning
+ * the cache, so the values read from another lcore may be slightly out
+ * of date. Operations on user-owned caches are not counted.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param lcore_id
+ *   The logical core id.
+ * @param stats
+ *   If not NULL, a pointer to a structure filled with the cache
+ *   statistics.
+ * @param size
+ *   If not NULL, filled with the current (possibly adapted) size of
+ *   the cache.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: The mempool has no cache or lcore_id is invalid.
+ */
+__rte_experimental
+int
+rte_mempool_cache_stats_get(const struct rte_mempool *mp, unsigned int lcore_id,
+			    struct rte_mempool_cache_stats *stats,
+			    uint32_t *size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable or disable the adaptive sizing of the per-lcore default caches.
+ *
+ * When enabled, each lcore cache periodically checks how often it had to
+ * access the underlying pool (refill on get, flush on put). A cache that
+ * often accesses the pool doubles its effective size, up to the
+ * cache_size given at mempool creation. A cache that did not access the
+ * pool for a while halves its size, down to min_size, and returns the
+ * excess objects to the pool.
+ *
+ * This function is not thread-safe: it must be called when no lcore is
+ * using the default caches of the mempool.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param min_size
+ *   The lower bound of the adaptive cache size, or 0 to disable the
+ *   adaptive sizing and restore the creation cache size.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: The mempool has no cache or min_size is greater than the
+ *     cache size of the mempool.
+ */
+__rte_experimental
+int
+rte_mempool_cache_adaptive_set(struct rte_mempool *mp, uint32_t min_size);
+
+/**
+ * @internal Check the pool accesses of an adaptive cache and resize it
+ * if needed; used internally.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the adaptive mempool cache.
+ */
+void
+rte_mempool_cache_adapt(struct rte_mempool *mp,
+			struct rte_mempool_cache *cache);
+
+/**
+ * @internal Get the adaptive state of a default cache, stored after the
+ * private data of the mempool; NULL for a user-owned cache.
+ */
+static inline struct rte_mempool_cache_adapt_state *
+__mempool_cache_adapt_state(struct rte_mempool *mp,
+			    struct rte_mempool_cache *cache)
+{
+	uintptr_t idx = ((uintptr_t)cache - (uintptr_t)mp->local_cache) /
+		sizeof(*cache);
+
+	/* no default caches, hence no state, without a cache size */
+	if (mp->cache_size == 0 || idx >= RTE_MAX_LCORE)
+		return NULL;
+
+	return (struct rte_mempool_cache_adapt_state *)RTE_PTR_ADD(mp,
+		MEMPOOL_HEADER_SIZE(mp, mp->cache_size) +
+		mp->private_data_size) + idx;
+}
+
+/**
+ * @internal Count an operation on a default cache in its statistics, and
+ * resize the cache if it is adaptive; used internally.
+ *
+ * @param put
+ *   1 for a put operation, 0 for a get.
+ * @param slow
+ *   1 if the operation had to access the pool, 0 otherwise.
+ */
+static __rte_always_inline void
+__mempool_cache_adapt_tick(struct rte_mempool *mp,
+			   struct rte_mempool_cache *cache, uint32_t put,
+			   uint32_t slow)
+{
+	struct rte_mempool_cache_adapt_state *state;
+
+	state = __mempool_cache_adapt_state(mp, cache);
+	if (state == NULL)
+		return;
+
+	if (put) {
+		if (slow)
+			state->put_flush++;
+		else
+			state->put_hit++;
+	} else {
+		if (slow)
+			state->get_miss++;
+		else
+			state->get_hit++;
+	}
+
+	if (likely((mp->flags & MEMPOOL_F_CACHE_ADAPTIVE) == 0))
+		return;
+
+	state->slow += slow;
+	if (--state->ops == 0)
+		rte_mempool_cache_adapt(mp, cache);
+}
+
 /**
  * Flush a user-owned mempool cache to the specified mempool.
  *
@@ -1307,10 +1474,16 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	/* increment stat now, adding in mempool always success */
 	__MEMPOOL_STAT_ADD(mp, put, n);
 
-	/* No cache provided or if put would overflow mem allocated for cache */
-	if (unlikely(cache == NULL || n > RTE_MEMPOOL_CACHE_MAX_SIZE))
+	/* No cache provided */
+	if (unlikely(cache == NULL))
 		goto ring_enqueue;
 
+	/* If put would overflow mem allocated for cache */
+	if (unlikely(n > RTE_MEMPOOL_CACHE_MAX_SIZE)) {
+		__mempool_cache_adapt_tick(mp, cache, 1, 1);
+		goto ring_enqueue;
+	}
+
 	cache_objs = &cache->objs[cache->len];
 
 	/*
@@ -1329,6 +1502,9 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
 				cache->len - cache->size);
 		cache->len = cache->size;
+		__mempool_cache_adapt_tick(mp, cache, 1, 1);
+	} else {
+		__mempool_cache_adapt_tick(mp, cache, 1, 0);
 	}
 
 	return;
@@ -1425,13 +1601,19 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 		      unsigned int n, struct rte_mempool_cache *cache)
 {
 	int ret;
-	uint32_t index, len;
+	uint32_t index, len, refill = 0;
 	void **cache_objs;
 
-	/* No cache provided or cannot be satisfied from cache */
-	if (unlikely(cache == NULL || n >= cache->size))
+	/* No cache provided */
+	if (unlikely(cache == NULL))
 		goto ring_dequeue;
 
+	/* Cannot be satisfied from cache */
+	if (unlikely(n >= cache->size)) {
+		__mempool_cache_adapt_tick(mp, cache, 0, 1);
+		goto ring_dequeue;
+	}
+
 	cache_objs = cache->objs;
 
 	/* Can this be satisfied from the cache? */
@@ -1439,6 +1621,8 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 		/* No. Backfill the cache first, and then fill from it */
 		uint32_t req = n + (cache->size - cache->len);
 
+		refill = 1;
+
 		/* How many do we require i.e. number to fill the cache + the request */
 		ret = rte_mempool_ops_dequeue_bulk(mp,
 			&cache->objs[cache->len], req);
@@ -1449,6 +1633,7 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 			 * the ring directly. If that fails, we are truly out of
 			 * buffers.
 			 */
+			__mempool_cache_adapt_tick(mp, cache, 0, 1);
 			goto ring_dequeue;
 		}
 
@@ -1461,6 +1646,8 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 
 	cache->len -= n;
 
+	__mempool_cache_adapt_tick(mp, cache, 0, refill);
+
 	__MEMPOOL_STAT_ADD(mp, get_success, n);
 
 	return 0;
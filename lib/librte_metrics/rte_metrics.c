@@ -14,8 +14,13 @@
 #include <rte_spinlock.h>
 
 #define RTE_METRICS_MAX_METRICS 256
+#define RTE_METRICS_MAX_LCORE_COUNTERS 32
+#define RTE_METRICS_MAX_LCORE_HISTOGRAMS 8
 #define RTE_METRICS_MEMZONE_NAME "RTE_METRICS"
 
+/* Per-lcore slot shared by threads that have no lcore id */
+#define RTE_METRICS_SHARED_SLOT RTE_MAX_LCORE
+
 /**
  * Internal stats metadata and value entry.
  *
@@ -32,8 +37,28 @@ struct rte_metrics_meta_s {
 	uint16_t idx_next_set;
 	/** Index of next metric in set (zero for none) */
 	uint16_t idx_next_stat;
+	/** Metric type, one of enum rte_metrics_type */
+	uint8_t type;
+	/** Index of the per-lcore counter or histogram backing the metric */
+	uint8_t idx_lcore;
+	/** Per-lcore metric was unregistered, its name may be reused */
+	uint8_t unregistered;
 };
 
+/**
+ * Internal per-lcore metric values.
+ *
+ * @internal
+ * Each lcore only ever writes its own cache line aligned slot, so
+ * producers do not need any lock. Readers aggregate all slots.
+ */
+struct rte_metrics_lcore_s {
+	/** Per-lcore counters */
+	uint64_t counters[RTE_METRICS_MAX_LCORE_COUNTERS];
+	/** Per-lcore histograms */
+	struct rte_metric_histogram hist[RTE_METRICS_MAX_LCORE_HISTOGRAMS];
+} __rte_cache_aligned;
+
 /**
  * Internal stats info structure.
  *
@@ -41,6 +66,10 @@ struct rte_metrics_meta_s {
  * Offsets into metadata are used instead of pointers because ASLR
  * means that having the same physical addresses in different
  * processes is not guaranteed.
+ *
+ * Entries are published by a release store of cnt_stats once they
+ * are fully written and never change afterwards, so only registration
+ * takes the lock; updates and queries are lock-free.
  */
 struct rte_metrics_data_s {
 	/**   Index of last metadata entry with valid data.
@@ -49,12 +78,131 @@ struct rte_metrics_data_s {
 	uint16_t idx_last_set;
 	/**   Number of metrics. */
 	uint16_t cnt_stats;
+	/** Number of per-lcore counters in use. */
+	uint16_t cnt_lcore_counters;
+	/** Number of per-lcore histograms in use. */
+	uint16_t cnt_lcore_hists;
 	/** Metric data memory block. */
 	struct rte_metrics_meta_s metadata[RTE_METRICS_MAX_METRICS];
-	/** Metric data access lock */
+	/** Metric registration lock */
 	rte_spinlock_t lock;
+	/** Per-lcore values, plus one slot for non-EAL threads. */
+	struct rte_metrics_lcore_s lcore[RTE_MAX_LCORE + 1];
 };
 
+/*
+ * Process local copy of the shared metrics memzone. Other processes are
+ * not told when the primary frees it, so the cached descriptor, which
+ * is cleared on free, is checked before the data is used.
+ */
+static const struct rte_memzone *metrics_memzone;
+static struct rte_metrics_data_s *metrics_data;
+
+static struct rte_metrics_data_s *
+metrics_get_data(void)
+{
+	const struct rte_memzone *memzone = metrics_memzone;
+
+	if (likely(memzone != NULL && memzone->addr == metrics_data &&
+			memzone->len == sizeof(struct rte_metrics_data_s)))
+		return metrics_data;
+
+	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
+	if (memzone == NULL) {
+		metrics_memzone = NULL;
+		metrics_data = NULL;
+		return NULL;
+	}
+	metrics_data = memzone->addr;
+	metrics_memzone = memzone;
+	return metrics_data;
+}
+
+static inline uint16_t
+metrics_cnt_stats(const struct rte_metrics_data_s *stats)
+{
+	return __atomic_load_n(&stats->cnt_stats, __ATOMIC_ACQUIRE);
+}
+
+/* Add to a value owned by the calling lcore; readers never see it torn */
+static inline void
+metrics_lcore_add(uint64_t *value, uint64_t delta, unsigned int lcore_id)
+{
+	if (lcore_id == RTE_METRICS_SHARED_SLOT)
+		__atomic_fetch_add(value, delta, __ATOMIC_RELAXED);
+	else
+		__atomic_store_n(value, *value + delta, __ATOMIC_RELAXED);
+}
+
+static inline unsigned int
+metrics_lcore_slot(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	return lcore_id < RTE_MAX_LCORE ? lcore_id : RTE_METRICS_SHARED_SLOT;
+}
+
+static inline unsigned int
+metrics_hist_bucket(uint64_t value)
+{
+	unsigned int idx;
+
+	if (value == 0)
+		return 0;
+	idx = 64 - __builtin_clzll(value);
+	return RTE_MIN(idx, RTE_METRICS_HIST_BUCKETS - 1u);
+}
+
+static uint64_t
+metrics_lcore_counter_sum(const struct rte_metrics_data_s *stats,
+	uint8_t idx_lcore)
+{
+	unsigned int lcore_id;
+	uint64_t sum = 0;
+
+	for (lcore_id = 0; lcore_id <= RTE_METRICS_SHARED_SLOT; lcore_id++)
+		sum += __atomic_load_n(
+			&stats->lcore[lcore_id].counters[idx_lcore],
+			__ATOMIC_RELAXED);
+	return sum;
+}
+
+static void
+metrics_lcore_hist_sum(const struct rte_metrics_data_s *stats,
+	uint8_t idx_lcore, struct rte_metric_histogram *hist)
+{
+	const struct rte_metric_histogram *h;
+	unsigned int lcore_id;
+	unsigned int i;
+
+	memset(hist, 0, sizeof(*hist));
+	for (lcore_id = 0; lcore_id <= RTE_METRICS_SHARED_SLOT; lcore_id++) {
+		h = &stats->lcore[lcore_id].hist[idx_lcore];
+		hist->count += __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+		hist->sum += __atomic_load_n(&h->sum, __ATOMIC_RELAXED);
+		for (i = 0; i < RTE_METRICS_HIST_BUCKETS; i++)
+			hist->buckets[i] += __atomic_load_n(&h->buckets[i],
+				__ATOMIC_RELAXED);
+	}
+}
+
+static uint64_t
+metrics_global_value(const struct rte_metrics_data_s *stats,
+	const struct rte_metrics_meta_s *entry)
+{
+	struct rte_metric_histogram hist;
+
+	switch (entry->type) {
+	case RTE_METRICS_TYPE_LCORE_COUNTER:
+		return metrics_lcore_counter_sum(stats, entry->idx_lcore);
+	case RTE_METRICS_TYPE_LCORE_HISTOGRAM:
+		metrics_lcore_hist_sum(stats, entry->idx_lcore, &hist);
+		return hist.count;
+	default:
+		return __atomic_load_n(&entry->global_value, __ATOMIC_RELAXED);
+	}
+}
+
 void
 rte_metrics_init(int socket_id)
 {
@@ -74,6 +222,8 @@ rte_metrics_init(int socket_id)
 	stats = memzone->addr;
 	memset(stats, 0, sizeof(struct rte_metrics_data_s));
 	rte_spinlock_init(&stats->lock);
+	metrics_data = stats;
+	metrics_memzone = memzone;
 }
 
 int
@@ -91,11 +241,50 @@ rte_metrics_deinit(void)
 
 	stats = memzone->addr;
 	memset(stats, 0, sizeof(struct rte_metrics_data_s));
+	metrics_memzone = NULL;
+	metrics_data = NULL;
 
 	return rte_memzone_free(memzone);
 
 }
 
+/* Must be called with the stats lock held */
+static int
+metrics_reg_names(struct rte_metrics_data_s *stats,
+	const char * const *names, uint16_t cnt_names,
+	enum rte_metrics_type type, uint8_t idx_lcore)
+{
+	struct rte_metrics_meta_s *entry = NULL;
+	uint16_t idx_name;
+	uint16_t idx_base;
+
+	if (stats->cnt_stats + cnt_names >= RTE_METRICS_MAX_METRICS)
+		return -ENOMEM;
+
+	/* Overwritten later if this is actually first set.. */
+	stats->metadata[stats->idx_last_set].idx_next_set = stats->cnt_stats;
+
+	stats->idx_last_set = idx_base = stats->cnt_stats;
+
+	for (idx_name = 0; idx_name < cnt_names; idx_name++) {
+		entry = &stats->metadata[idx_name + stats->cnt_stats];
+		strlcpy(entry->name, names[idx_name], RTE_METRICS_MAX_NAME_LEN);
+		memset(entry->value, 0, sizeof(entry->value));
+		entry->global_value = 0;
+		entry->idx_next_stat = idx_name + stats->cnt_stats + 1;
+		entry->type = type;
+		entry->idx_lcore = idx_lcore;
+	}
+	entry->idx_next_stat = 0;
+	entry->idx_next_set = 0;
+
+	/* Publish the new entries to lock-free readers */
+	__atomic_store_n(&stats->cnt_stats, stats->cnt_stats + cnt_names,
+		__ATOMIC_RELEASE);
+
+	return idx_base;
+}
+
 int
 rte_metrics_reg_name(const char *name)
 {
@@ -107,11 +296,9 @@ rte_metrics_reg_name(const char *name)
 int
 rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 {
-	struct rte_metrics_meta_s *entry = NULL;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
-	uint16_t idx_base;
+	int ret;
 
 	/* Some sanity checks */
 	if (cnt_names < 1 || names == NULL)
@@ -120,34 +307,127 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 		if (names[idx_name] == NULL)
 			return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_get_data();
+	if (stats == NULL)
 		return -EIO;
-	stats = memzone->addr;
-
-	if (stats->cnt_stats + cnt_names >= RTE_METRICS_MAX_METRICS)
-		return -ENOMEM;
 
 	rte_spinlock_lock(&stats->lock);
+	ret = metrics_reg_names(stats, names, cnt_names,
+		RTE_METRICS_TYPE_VALUE, 0);
+	rte_spinlock_unlock(&stats->lock);
 
-	/* Overwritten later if this is actually first set.. */
-	stats->metadata[stats->idx_last_set].idx_next_set = stats->cnt_stats;
+	return ret;
+}
 
-	stats->idx_last_set = idx_base = stats->cnt_stats;
+/* Clear all lcore copies of a per-lcore metric, with the stats lock held */
+static void
+metrics_lcore_reset(struct rte_metrics_data_s *stats,
+	const struct rte_metrics_meta_s *entry)
+{
+	unsigned int lcore_id;
 
-	for (idx_name = 0; idx_name < cnt_names; idx_name++) {
-		entry = &stats->metadata[idx_name + stats->cnt_stats];
-		strlcpy(entry->name, names[idx_name], RTE_METRICS_MAX_NAME_LEN);
-		memset(entry->value, 0, sizeof(entry->value));
-		entry->idx_next_stat = idx_name + stats->cnt_stats + 1;
+	for (lcore_id = 0; lcore_id <= RTE_METRICS_SHARED_SLOT; lcore_id++) {
+		if (entry->type == RTE_METRICS_TYPE_LCORE_COUNTER)
+			stats->lcore[lcore_id].counters[entry->idx_lcore] = 0;
+		else
+			memset(&stats->lcore[lcore_id].hist[entry->idx_lcore],
+				0, sizeof(struct rte_metric_histogram));
 	}
-	entry->idx_next_stat = 0;
-	entry->idx_next_set = 0;
-	stats->cnt_stats += cnt_names;
+}
+
+/* Find an unregistered per-lcore metric, with the stats lock held */
+static int
+metrics_find_unregistered(struct rte_metrics_data_s *stats,
+	const char *name, enum rte_metrics_type type)
+{
+	char entry_name[RTE_METRICS_MAX_NAME_LEN];
+	uint16_t idx_name;
+
+	strlcpy(entry_name, name, sizeof(entry_name));
+	for (idx_name = 0; idx_name < stats->cnt_stats; idx_name++) {
+		const struct rte_metrics_meta_s *entry =
+			&stats->metadata[idx_name];
 
+		if (entry->unregistered && entry->type == type &&
+				strcmp(entry->name, entry_name) == 0)
+			return idx_name;
+	}
+	return -ENOENT;
+}
+
+int
+rte_metrics_reg_lcore_metric(const char *name, enum rte_metrics_type type)
+{
+	const char * const list_names[] = {name};
+	struct rte_metrics_data_s *stats;
+	uint16_t *cnt_lcore;
+	uint16_t max_lcore;
+	int ret;
+
+	if (name == NULL)
+		return -EINVAL;
+
+	switch (type) {
+	case RTE_METRICS_TYPE_LCORE_COUNTER:
+		max_lcore = RTE_METRICS_MAX_LCORE_COUNTERS;
+		break;
+	case RTE_METRICS_TYPE_LCORE_HISTOGRAM:
+		max_lcore = RTE_METRICS_MAX_LCORE_HISTOGRAMS;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	stats = metrics_get_data();
+	if (stats == NULL)
+		return -EIO;
+
+	cnt_lcore = type == RTE_METRICS_TYPE_LCORE_COUNTER ?
+		&stats->cnt_lcore_counters : &stats->cnt_lcore_hists;
+
+	rte_spinlock_lock(&stats->lock);
+	/* reuse the key of the same metric registered by a previous user */
+	ret = metrics_find_unregistered(stats, name, type);
+	if (ret >= 0) {
+		__atomic_store_n(&stats->metadata[ret].unregistered, 0,
+			__ATOMIC_RELEASE);
+	} else if (*cnt_lcore >= max_lcore) {
+		ret = -ENOMEM;
+	} else {
+		ret = metrics_reg_names(stats, list_names, 1, type,
+			*cnt_lcore);
+		if (ret >= 0)
+			(*cnt_lcore)++;
+	}
 	rte_spinlock_unlock(&stats->lock);
 
-	return idx_base;
+	return ret;
+}
+
+int
+rte_metrics_unreg_lcore_metric(uint16_t key)
+{
+	struct rte_metrics_meta_s *entry;
+	struct rte_metrics_data_s *stats;
+	int ret = 0;
+
+	stats = metrics_get_data();
+	if (stats == NULL)
+		return -EIO;
+
+	rte_spinlock_lock(&stats->lock);
+	entry = key < stats->cnt_stats ? &stats->metadata[key] : NULL;
+	if (entry == NULL || entry->unregistered ||
+			(entry->type != RTE_METRICS_TYPE_LCORE_COUNTER &&
+			entry->type != RTE_METRICS_TYPE_LCORE_HISTOGRAM)) {
+		ret = -EINVAL;
+	} else {
+		__atomic_store_n(&entry->unregistered, 1, __ATOMIC_RELAXED);
+		metrics_lcore_reset(stats, entry);
+	}
+	rte_spinlock_unlock(&stats->lock);
+
+	return ret;
 }
 
 int
@@ -164,10 +444,10 @@ rte_metrics_update_values(int port_id,
 {
 	struct rte_metrics_meta_s *entry;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_metric;
 	uint16_t idx_value;
 	uint16_t cnt_setsize;
+	uint16_t cnt_stats;
 
 	if (port_id != RTE_METRICS_GLOBAL &&
 			(port_id < 0 || port_id >= RTE_MAX_ETHPORTS))
@@ -176,20 +456,16 @@ rte_metrics_update_values(int port_id,
 	if (values == NULL)
 		return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_get_data();
+	if (stats == NULL)
 		return -EIO;
-	stats = memzone->addr;
 
-	rte_spinlock_lock(&stats->lock);
-
-	if (key >= stats->cnt_stats) {
-		rte_spinlock_unlock(&stats->lock);
+	cnt_stats = metrics_cnt_stats(stats);
+	if (key >= cnt_stats)
 		return -EINVAL;
-	}
 	idx_metric = key;
 	cnt_setsize = 1;
-	while (idx_metric < stats->cnt_stats) {
+	while (idx_metric < cnt_stats) {
 		entry = &stats->metadata[idx_metric];
 		if (entry->idx_next_stat == 0)
 			break;
@@ -197,24 +473,73 @@ rte_metrics_update_values(int port_id,
 		idx_metric++;
 	}
 	/* Check update does not cross set border */
-	if (count > cnt_setsize) {
-		rte_spinlock_unlock(&stats->lock);
+	if (count > cnt_setsize)
 		return -ERANGE;
-	}
 
 	if (port_id == RTE_METRICS_GLOBAL)
 		for (idx_value = 0; idx_value < count; idx_value++) {
 			idx_metric = key + idx_value;
-			stats->metadata[idx_metric].global_value =
-				values[idx_value];
+			__atomic_store_n(
+				&stats->metadata[idx_metric].global_value,
+				values[idx_value], __ATOMIC_RELAXED);
 		}
 	else
 		for (idx_value = 0; idx_value < count; idx_value++) {
 			idx_metric = key + idx_value;
-			stats->metadata[idx_metric].value[port_id] =
-				values[idx_value];
+			__atomic_store_n(
+				&stats->metadata[idx_metric].value[port_id],
+				values[idx_value], __ATOMIC_RELAXED);
 		}
-	rte_spinlock_unlock(&stats->lock);
+	return 0;
+}
+
+int
+rte_metrics_lcore_add(uint16_t key, uint64_t delta)
+{
+	struct rte_metrics_meta_s *entry;
+	struct rte_metrics_data_s *stats;
+	unsigned int lcore_id;
+
+	stats = metrics_get_data();
+	if (stats == NULL)
+		return -EIO;
+	if (key >= metrics_cnt_stats(stats))
+		return -EINVAL;
+	entry = &stats->metadata[key];
+	if (entry->type != RTE_METRICS_TYPE_LCORE_COUNTER ||
+			__atomic_load_n(&entry->unregistered, __ATOMIC_ACQUIRE))
+		return -EINVAL;
+
+	lcore_id = metrics_lcore_slot();
+	metrics_lcore_add(&stats->lcore[lcore_id].counters[entry->idx_lcore],
+		delta, lcore_id);
+	return 0;
+}
+
+int
+rte_metrics_lcore_hist_add(uint16_t key, uint64_t sample)
+{
+	struct rte_metric_histogram *hist;
+	struct rte_metrics_meta_s *entry;
+	struct rte_metrics_data_s *stats;
+	unsigned int lcore_id;
+
+	stats = metrics_get_data();
+	if (stats == NULL)
+		return -EIO;
+	if (key >= metrics_cnt_stats(stats))
+		return -EINVAL;
+	entry = &stats->metadata[key];
+	if (entry->type != RTE_METRICS_TYPE_LCORE_HISTOGRAM ||
+			__atomic_load_n(&entry->unregistered, __ATOMIC_ACQUIRE))
+		return -EINVAL;
+
+	lcore_id = metrics_lcore_slot();
+	hist = &stats->lcore[lcore_id].hist[entry->idx_lcore];
+	metrics_lcore_add(&hist->buckets[metrics_hist_bucket(sample)], 1,
+		lcore_id);
+	metrics_lcore_add(&hist->sum, sample, lcore_id);
+	metrics_lcore_add(&hist->count, 1, lcore_id);
 	return 0;
 }
 
@@ -223,30 +548,23 @@ rte_metrics_get_names(struct rte_metric_name *names,
 	uint16_t capacity)
 {
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
-	int return_value;
+	uint16_t cnt_stats;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_get_data();
+	if (stats == NULL)
 		return -EIO;
 
-	stats = memzone->addr;
-	rte_spinlock_lock(&stats->lock);
+	cnt_stats = metrics_cnt_stats(stats);
 	if (names != NULL) {
-		if (capacity < stats->cnt_stats) {
-			return_value = stats->cnt_stats;
-			rte_spinlock_unlock(&stats->lock);
-			return return_value;
-		}
-		for (idx_name = 0; idx_name < stats->cnt_stats; idx_name++)
+		if (capacity < cnt_stats)
+			return cnt_stats;
+		for (idx_name = 0; idx_name < cnt_stats; idx_name++)
 			strlcpy(names[idx_name].name,
 				stats->metadata[idx_name].name,
 				RTE_METRICS_MAX_NAME_LEN);
 	}
-	return_value = stats->cnt_stats;
-	rte_spinlock_unlock(&stats->lock);
-	return return_value;
+	return cnt_stats;
 }
 
 int
@@ -256,45 +574,58 @@ rte_metrics_get_values(int port_id,
 {
 	struct rte_metrics_meta_s *entry;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
-	int return_value;
+	uint16_t cnt_stats;
 
 	if (port_id != RTE_METRICS_GLOBAL &&
 			(port_id < 0 || port_id >= RTE_MAX_ETHPORTS))
 		return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_get_data();
+	if (stats == NULL)
 		return -EIO;
 
-	stats = memzone->addr;
-	rte_spinlock_lock(&stats->lock);
-
+	cnt_stats = metrics_cnt_stats(stats);
 	if (values != NULL) {
-		if (capacity < stats->cnt_stats) {
-			return_value = stats->cnt_stats;
-			rte_spinlock_unlock(&stats->lock);
-			return return_value;
-		}
+		if (capacity < cnt_stats)
+			return cnt_stats;
 		if (port_id == RTE_METRICS_GLOBAL)
-			for (idx_name = 0;
-					idx_name < stats->cnt_stats;
-					idx_name++) {
+			for (idx_name = 0; idx_name < cnt_stats; idx_name++) {
 				entry = &stats->metadata[idx_name];
 				values[idx_name].key = idx_name;
-				values[idx_name].value = entry->global_value;
+				values[idx_name].value =
+					metrics_global_value(stats, entry);
 			}
 		else
-			for (idx_name = 0;
-					idx_name < stats->cnt_stats;
-					idx_name++) {
+			for (idx_name = 0; idx_name < cnt_stats; idx_name++) {
 				entry = &stats->metadata[idx_name];
 				values[idx_name].key = idx_name;
-				values[idx_name].value = entry->value[port_id];
+				values[idx_name].value = __atomic_load_n(
+					&entry->value[port_id],
+					__ATOMIC_RELAXED);
 			}
 	}
-	return_value = stats->cnt_stats;
-	rte_spinlock_unlock(&stats->lock);
-	return return_value;
+	return cnt_stats;
+}
+
+int
+rte_metrics_get_histogram(uint16_t key, struct rte_metric_histogram *hist)
+{
+	struct rte_metrics_meta_s *entry;
+	struct rte_metrics_data_s *stats;
+
+	if (hist == NULL)
+		return -EINVAL;
+
+	stats = metrics_get_data();
+	if (stats == NULL)
+		return -EIO;
+	if (key >= metrics_cnt_stats(stats))
+		return -EINVAL;
+	entry = &stats->metadata[key];
+	if (entry->type != RTE_METRICS_TYPE_LCORE_HISTOGRAM)
+		return -EINVAL;
+
+	metrics_lcore_hist_sum(stats, entry->idx_lcore, hist);
+	return 0;
 }
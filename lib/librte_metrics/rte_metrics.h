@@ -18,6 +18,12 @@
  * metric information by querying the central metric data, which is
  * held in shared memory. Currently only bulk querying of metrics
  * by consumers is supported.
+ *
+ * Only registration takes a lock: updates and queries are lock-free.
+ * Metrics written from several lcores at once, such as packet counters
+ * or latency histograms, can be registered as per-lcore metrics. Each
+ * lcore then updates its own cache line aligned copy and consumers,
+ * which may live in secondary processes, aggregate the copies on demand.
  */
 
 #ifndef _RTE_METRICS_H_
@@ -43,6 +49,26 @@ extern "C" {
  */
 #define RTE_METRICS_GLOBAL -1
 
+/**
+ * Number of buckets of a histogram metric.
+ *
+ * Bucket 0 counts samples equal to zero and bucket n counts samples in
+ * the range [2^(n-1), 2^n). The last bucket also counts all samples
+ * above its range.
+ */
+#define RTE_METRICS_HIST_BUCKETS 32
+
+/**
+ * Metric types.
+ */
+enum rte_metrics_type {
+	/** Value set with rte_metrics_update_values(). */
+	RTE_METRICS_TYPE_VALUE = 0,
+	/** Counter summed over all lcores, see rte_metrics_lcore_add(). */
+	RTE_METRICS_TYPE_LCORE_COUNTER,
+	/** Histogram merged over all lcores, see rte_metrics_lcore_hist_add(). */
+	RTE_METRICS_TYPE_LCORE_HISTOGRAM,
+};
 
 /**
  * A name-key lookup for metrics.
@@ -71,6 +97,18 @@ struct rte_metric_value {
 	uint64_t value;
 };
 
+/**
+ * Histogram metric value, returned by rte_metrics_get_histogram().
+ */
+struct rte_metric_histogram {
+	/** Number of samples */
+	uint64_t count;
+	/** Sum of all samples */
+	uint64_t sum;
+	/** Number of samples per log2 bucket, see RTE_METRICS_HIST_BUCKETS */
+	uint64_t buckets[RTE_METRICS_HIST_BUCKETS];
+};
+
 
 /**
  * Initializes metric module. This function must be called from
@@ -140,6 +178,67 @@ int rte_metrics_reg_name(const char *name);
  */
 int rte_metrics_reg_names(const char * const *names, uint16_t cnt_names);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Register a per-lcore metric.
+ *
+ * The metric is updated with rte_metrics_lcore_add() or
+ * rte_metrics_lcore_hist_add() depending on its type. Each lcore
+ * writes its own copy without any lock or atomic read-modify-write;
+ * non-EAL threads share one extra copy which they update atomically.
+ * The lcore ids of all processes updating per-lcore metrics must
+ * therefore be distinct.
+ *
+ * The global value returned by rte_metrics_get_values() is the sum of
+ * all lcore copies for a counter, and the number of samples for a
+ * histogram. Per-port values are not used.
+ *
+ * If a per-lcore metric of the same name and type was unregistered with
+ * rte_metrics_unreg_lcore_metric(), its key is returned again.
+ *
+ * @param name
+ *   Metric name. If this exceeds RTE_METRICS_MAX_NAME_LEN (including
+ *   the NULL terminator), it is truncated.
+ * @param type
+ *   RTE_METRICS_TYPE_LCORE_COUNTER or RTE_METRICS_TYPE_LCORE_HISTOGRAM.
+ *
+ * @return
+ *  - Zero or positive: Success (index key of new metric)
+ *  - -EIO: Error, unable to access metrics shared memory
+ *    (rte_metrics_init() not called)
+ *  - -EINVAL: Error, invalid parameters
+ *  - -ENOMEM: Error, maximum metrics of this type reached
+ */
+__rte_experimental
+int rte_metrics_reg_lcore_metric(const char *name,
+	enum rte_metrics_type type);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Unregister a per-lcore metric.
+ *
+ * The values of the metric are cleared and it can no longer be updated.
+ * Its name and key stay in the list of metrics, so that the keys of the
+ * other metrics do not change, and they are reused when a metric of the
+ * same name and type is registered again. The metric must not be
+ * updated concurrently.
+ *
+ * @param key
+ *   Key of a metric registered with rte_metrics_reg_lcore_metric().
+ *
+ * @return
+ *  - Zero: Success
+ *  - -EIO: Error, unable to access metrics shared memory
+ *    (rte_metrics_init() not called)
+ *  - -EINVAL: Error, key is not a registered per-lcore metric
+ */
+__rte_experimental
+int rte_metrics_unreg_lcore_metric(uint16_t key);
+
 /**
  * Get metric name-key lookup table.
  *
@@ -190,6 +289,26 @@ int rte_metrics_get_values(
 	struct rte_metric_value *values,
 	uint16_t capacity);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the value of a histogram metric, merged over all lcores.
+ *
+ * @param key
+ *   Key of a metric registered with type RTE_METRICS_TYPE_LCORE_HISTOGRAM.
+ * @param hist
+ *   Histogram to fill in.
+ *
+ * @return
+ *   - -EIO if unable to access shared metrics memory
+ *   - -EINVAL if key is not a histogram metric or hist is NULL
+ *   - Zero on success
+ */
+__rte_experimental
+int rte_metrics_get_histogram(uint16_t key,
+	struct rte_metric_histogram *hist);
+
 /**
  * Updates a metric
  *
@@ -233,6 +352,44 @@ int rte_metrics_update_values(
 	const uint64_t *values,
 	uint32_t count);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add to the calling lcore's copy of a per-lcore counter.
+ *
+ * @param key
+ *   Key of a metric registered with type RTE_METRICS_TYPE_LCORE_COUNTER.
+ * @param delta
+ *   Value to add.
+ *
+ * @return
+ *   - -EIO if unable to access shared metrics memory
+ *   - -EINVAL if key is not a per-lcore counter
+ *   - Zero on success
+ */
+__rte_experimental
+int rte_metrics_lcore_add(uint16_t key, uint64_t delta);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Record a sample in the calling lcore's copy of a histogram metric.
+ *
+ * @param key
+ *   Key of a metric registered with type RTE_METRICS_TYPE_LCORE_HISTOGRAM.
+ * @param sample
+ *   Sample value.
+ *
+ * @return
+ *   - -EIO if unable to access shared metrics memory
+ *   - -EINVAL if key is not a histogram metric
+ *   - Zero on success
+ */
+__rte_experimental
+int rte_metrics_lcore_hist_add(uint16_t key, uint64_t sample);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,622 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_ethdev.h>
+#include <rte_log.h>
+#include <rte_mbuf.h>
+
+#include "rte_pcapng.h"
+
+static int pcapng_logtype;
+
+#define PCAPNG_LOG(level, fmt, args...) \
+	rte_log(RTE_LOG_ ## level, pcapng_logtype, "%s(): " fmt "\n", \
+		__func__, ##args)
+
+/* Block types and options as defined by the pcapng specification */
+#define PCAPNG_SECTION_BLOCK		0x0A0D0D0A
+#define PCAPNG_INTERFACE_BLOCK		1
+#define PCAPNG_INTERFACE_STATS_BLOCK	5
+#define PCAPNG_ENHANCED_PACKET_BLOCK	6
+
+#define PCAPNG_BYTE_ORDER_MAGIC		0x1A2B3C4D
+#define PCAPNG_MAJOR_VERS		1
+#define PCAPNG_MINOR_VERS		0
+
+#define PCAPNG_LINKTYPE_ETHERNET	1
+
+enum pcapng_option_codes {
+	PCAPNG_OPT_END = 0,
+	PCAPNG_OPT_COMMENT = 1,
+
+	PCAPNG_SHB_HARDWARE = 2,
+	PCAPNG_SHB_OS = 3,
+	PCAPNG_SHB_USERAPPL = 4,
+
+	PCAPNG_IFB_NAME = 2,
+	PCAPNG_IFB_DESCRIPTION = 3,
+	PCAPNG_IFB_TSRESOL = 9,
+
+	PCAPNG_EPB_FLAGS = 2,
+	PCAPNG_EPB_QUEUE = 6,
+
+	PCAPNG_ISB_STARTTIME = 2,
+	PCAPNG_ISB_ENDTIME = 3,
+	PCAPNG_ISB_IFRECV = 4,
+	PCAPNG_ISB_IFDROP = 5,
+};
+
+/* timestamps are reported in nanoseconds (10^-9) */
+#define PCAPNG_TSRESOL_NS		9
+
+#define PCAPNG_PORT_UNKNOWN		UINT32_MAX
+
+struct pcapng_option {
+	uint16_t code;
+	uint16_t length;
+	uint8_t data[];
+};
+
+struct pcapng_section_header {
+	uint32_t block_type;
+	uint32_t block_length;
+	uint32_t byte_order_magic;
+	uint16_t major_version;
+	uint16_t minor_version;
+	uint64_t section_length;
+};
+
+struct pcapng_interface_block {
+	uint32_t block_type;
+	uint32_t block_length;
+	uint16_t link_type;
+	uint16_t reserved;
+	uint32_t snap_len;
+};
+
+struct pcapng_enhance_packet_block {
+	uint32_t block_type;
+	uint32_t block_length;
+	uint32_t interface_id;
+	uint32_t timestamp_hi;
+	uint32_t timestamp_lo;
+	uint32_t capture_length;
+	uint32_t original_length;
+};
+
+struct pcapng_statistics {
+	uint32_t block_type;
+	uint32_t block_length;
+	uint32_t interface_id;
+	uint32_t timestamp_hi;
+	uint32_t timestamp_lo;
+};
+
+/* Format of the capture file handle */
+struct rte_pcapng {
+	int outfd;		/* output file */
+	uint32_t nb_interfaces;	/* number of interface blocks written */
+	uint64_t tsc_base;	/* TSC value taken at open */
+	uint64_t tsc_hz;	/* TSC frequency */
+	uint64_t ns_base;	/* wall clock (ns since epoch) at open */
+	/* DPDK port id to interface index in the file */
+	uint32_t port_index[RTE_MAX_ETHPORTS];
+};
+
+/* length of an option with its data padded to 32 bits */
+static inline uint32_t
+pcapng_optlen(uint16_t len)
+{
+	return sizeof(struct pcapng_option) + RTE_ALIGN(len, sizeof(uint32_t));
+}
+
+/* build an option in place and return the address of the next one */
+static struct pcapng_option *
+pcapng_add_option(struct pcapng_option *popt, uint16_t code,
+		  const void *data, uint16_t len)
+{
+	popt->code = code;
+	popt->length = len;
+	if (len > 0) {
+		memcpy(popt->data, data, len);
+		memset(popt->data + len, 0, pcapng_optlen(len) - len -
+			sizeof(struct pcapng_option));
+	}
+
+	return (struct pcapng_option *)((uint8_t *)popt + pcapng_optlen(len));
+}
+
+static uint64_t
+pcapng_cycles_to_ns(const rte_pcapng_t *self, uint64_t cycles)
+{
+	/* split the conversion to avoid overflowing 64 bits */
+	return (cycles / self->tsc_hz) * NS_PER_S +
+		(cycles % self->tsc_hz) * NS_PER_S / self->tsc_hz;
+}
+
+/* convert a TSC value to nanoseconds since the Unix epoch */
+static uint64_t
+pcapng_tsc_to_ns(const rte_pcapng_t *self, uint64_t cycles)
+{
+	if (cycles >= self->tsc_base)
+		return self->ns_base +
+			pcapng_cycles_to_ns(self, cycles - self->tsc_base);
+
+	return self->ns_base -
+		pcapng_cycles_to_ns(self, self->tsc_base - cycles);
+}
+
+static ssize_t
+pcapng_write_block(rte_pcapng_t *self, const void *buf, size_t len)
+{
+	ssize_t ret;
+
+	ret = write(self->outfd, buf, len);
+	if (ret != (ssize_t)len) {
+		PCAPNG_LOG(ERR, "write of %zu bytes failed: %s",
+			len, ret < 0 ? strerror(errno) : "short write");
+		return -1;
+	}
+
+	return ret;
+}
+
+static int
+pcapng_section_block(rte_pcapng_t *self,
+		     const char *os, const char *hw,
+		     const char *app, const char *comment)
+{
+	struct pcapng_section_header *hdr;
+	struct pcapng_option *opt;
+	void *buf;
+	uint32_t len;
+	ssize_t ret;
+
+	len = sizeof(*hdr);
+	if (hw)
+		len += pcapng_optlen(strlen(hw));
+	if (os)
+		len += pcapng_optlen(strlen(os));
+	if (app)
+		len += pcapng_optlen(strlen(app));
+	if (comment)
+		len += pcapng_optlen(strlen(comment));
+
+	/* reserve space for OPT_END and the trailing block length */
+	len += pcapng_optlen(0);
+	len += sizeof(uint32_t);
+
+	buf = calloc(1, len);
+	if (buf == NULL)
+		return -1;
+
+	hdr = buf;
+	hdr->block_type = PCAPNG_SECTION_BLOCK;
+	hdr->block_length = len;
+	hdr->byte_order_magic = PCAPNG_BYTE_ORDER_MAGIC;
+	hdr->major_version = PCAPNG_MAJOR_VERS;
+	hdr->minor_version = PCAPNG_MINOR_VERS;
+	hdr->section_length = UINT64_MAX;
+
+	/* the header is 64 bit aligned, so the options follow it */
+	opt = (struct pcapng_option *)(hdr + 1);
+	if (comment)
+		opt = pcapng_add_option(opt, PCAPNG_OPT_COMMENT,
+					comment, strlen(comment));
+	if (hw)
+		opt = pcapng_add_option(opt, PCAPNG_SHB_HARDWARE,
+					hw, strlen(hw));
+	if (os)
+		opt = pcapng_add_option(opt, PCAPNG_SHB_OS,
+					os, strlen(os));
+	if (app)
+		opt = pcapng_add_option(opt, PCAPNG_SHB_USERAPPL,
+					app, strlen(app));
+
+	/* The standard requires last option to be OPT_END */
+	opt = pcapng_add_option(opt, PCAPNG_OPT_END, NULL, 0);
+
+	/* clone block_length after option */
+	memcpy(opt, &hdr->block_length, sizeof(uint32_t));
+
+	ret = pcapng_write_block(self, buf, len);
+	free(buf);
+
+	return ret < 0 ? -1 : 0;
+}
+
+/* write an interface description block for the port */
+static int
+pcapng_add_interface(rte_pcapng_t *self, uint16_t port)
+{
+	char ifname[RTE_ETH_NAME_MAX_LEN];
+	struct rte_eth_dev_info dev_info;
+	struct pcapng_interface_block *hdr;
+	struct pcapng_option *opt;
+	const uint8_t tsresol = PCAPNG_TSRESOL_NS;
+	const char *ifdescr = NULL;
+	/* room for three options of up to a device name, end and trailer */
+	uint32_t buf[(sizeof(*hdr) + 3 * (sizeof(*opt) + RTE_ETH_NAME_MAX_LEN) +
+		      2 * sizeof(uint32_t)) / sizeof(uint32_t)];
+	uint32_t len;
+
+	if (rte_eth_dev_get_name_by_port(port, ifname) < 0)
+		snprintf(ifname, sizeof(ifname), "port%u", port);
+
+	if (rte_eth_dev_info_get(port, &dev_info) == 0)
+		ifdescr = dev_info.driver_name;
+
+	len = sizeof(*hdr);
+	len += pcapng_optlen(sizeof(tsresol));
+	len += pcapng_optlen(strlen(ifname));
+	if (ifdescr)
+		len += pcapng_optlen(strlen(ifdescr));
+	len += pcapng_optlen(0);
+	len += sizeof(uint32_t);
+
+	if (len > sizeof(buf))
+		return -1;
+
+	hdr = (struct pcapng_interface_block *)buf;
+	hdr->block_type = PCAPNG_INTERFACE_BLOCK;
+	hdr->link_type = PCAPNG_LINKTYPE_ETHERNET;
+	hdr->reserved = 0;
+	hdr->snap_len = 0;	/* no limit */
+	hdr->block_length = len;
+
+	opt = (struct pcapng_option *)(hdr + 1);
+	opt = pcapng_add_option(opt, PCAPNG_IFB_TSRESOL,
+				&tsresol, sizeof(tsresol));
+	opt = pcapng_add_option(opt, PCAPNG_IFB_NAME,
+				ifname, strlen(ifname));
+	if (ifdescr)
+		opt = pcapng_add_option(opt, PCAPNG_IFB_DESCRIPTION,
+					ifdescr, strlen(ifdescr));
+	opt = pcapng_add_option(opt, PCAPNG_OPT_END, NULL, 0);
+
+	memcpy(opt, &hdr->block_length, sizeof(uint32_t));
+
+	if (pcapng_write_block(self, buf, len) < 0)
+		return -1;
+
+	self->port_index[port] = self->nb_interfaces++;
+	return 0;
+}
+
+/* look up the interface index of the port, describing it if needed */
+static int
+pcapng_port_index(rte_pcapng_t *self, uint16_t port, uint32_t *index)
+{
+	if (port >= RTE_MAX_ETHPORTS)
+		return -1;
+
+	if (self->port_index[port] == PCAPNG_PORT_UNKNOWN &&
+	    pcapng_add_interface(self, port) < 0)
+		return -1;
+
+	*index = self->port_index[port];
+	return 0;
+}
+
+ssize_t
+rte_pcapng_write_stats(rte_pcapng_t *self, uint16_t port_id,
+		       const char *comment,
+		       uint64_t start_time, uint64_t end_time,
+		       uint64_t ifrecv, uint64_t ifdrop)
+{
+	struct pcapng_statistics *hdr;
+	struct pcapng_option *opt;
+	uint32_t optlen, len, index;
+	uint32_t tv[2];
+	uint64_t ns;
+	uint8_t *buf;
+	ssize_t ret;
+
+	if (pcapng_port_index(self, port_id, &index) < 0)
+		return -1;
+
+	optlen = 0;
+	if (ifrecv != UINT64_MAX)
+		optlen += pcapng_optlen(sizeof(ifrecv));
+	if (ifdrop != UINT64_MAX)
+		optlen += pcapng_optlen(sizeof(ifdrop));
+	if (start_time != 0)
+		optlen += pcapng_optlen(sizeof(start_time));
+	if (end_time != 0)
+		optlen += pcapng_optlen(sizeof(end_time));
+	if (comment)
+		optlen += pcapng_optlen(strlen(comment));
+	if (optlen != 0)
+		optlen += pcapng_optlen(0);
+
+	len = sizeof(*hdr) + optlen + sizeof(uint32_t);
+	buf = calloc(1, len);
+	if (buf == NULL)
+		return -1;
+
+	hdr = (struct pcapng_statistics *)buf;
+	opt = (struct pcapng_option *)(hdr + 1);
+
+	if (comment)
+		opt = pcapng_add_option(opt, PCAPNG_OPT_COMMENT,
+					comment, strlen(comment));
+	/* times use the same (high, low) layout as block timestamps */
+	if (start_time != 0) {
+		ns = pcapng_tsc_to_ns(self, start_time);
+		tv[0] = ns >> 32;
+		tv[1] = (uint32_t)ns;
+		opt = pcapng_add_option(opt, PCAPNG_ISB_STARTTIME,
+					tv, sizeof(tv));
+	}
+	if (end_time != 0) {
+		ns = pcapng_tsc_to_ns(self, end_time);
+		tv[0] = ns >> 32;
+		tv[1] = (uint32_t)ns;
+		opt = pcapng_add_option(opt, PCAPNG_ISB_ENDTIME,
+					tv, sizeof(tv));
+	}
+	if (ifrecv != UINT64_MAX)
+		opt = pcapng_add_option(opt, PCAPNG_ISB_IFRECV,
+					&ifrecv, sizeof(ifrecv));
+	if (ifdrop != UINT64_MAX)
+		opt = pcapng_add_option(opt, PCAPNG_ISB_IFDROP,
+					&ifdrop, sizeof(ifdrop));
+	if (optlen != 0)
+		opt = pcapng_add_option(opt, PCAPNG_OPT_END, NULL, 0);
+
+	ns = pcapng_tsc_to_ns(self, rte_get_tsc_cycles());
+
+	hdr->block_type = PCAPNG_INTERFACE_STATS_BLOCK;
+	hdr->block_length = len;
+	hdr->interface_id = index;
+	hdr->timestamp_hi = ns >> 32;
+	hdr->timestamp_lo = (uint32_t)ns;
+
+	/* clone block_length after option */
+	memcpy(opt, &len, sizeof(uint32_t));
+
+	ret = pcapng_write_block(self, buf, len);
+	free(buf);
+
+	return ret;
+}
+
+uint32_t
+rte_pcapng_mbuf_size(uint32_t length)
+{
+	/* The EPB header is prepended in the mbuf headroom. */
+	RTE_BUILD_BUG_ON(sizeof(struct pcapng_enhance_packet_block) >
+			 RTE_PKTMBUF_HEADROOM);
+
+	/* The flags and queue information are added at the end. */
+	return RTE_PKTMBUF_HEADROOM
+		+ RTE_ALIGN(length, sizeof(uint32_t))
+		+ pcapng_optlen(sizeof(uint32_t)) /* flag option */
+		+ pcapng_optlen(sizeof(uint32_t)) /* queue option */
+		+ pcapng_optlen(0)		  /* end of options */
+		+ sizeof(uint32_t);		  /* length at end */
+}
+
+/* Make a copy of original mbuf with pcapng header and options */
+struct rte_mbuf *
+rte_pcapng_copy(uint16_t port_id, uint32_t queue,
+		const struct rte_mbuf *md,
+		struct rte_mempool *mp,
+		uint32_t length, uint64_t cycles,
+		enum rte_pcapng_direction direction)
+{
+	struct pcapng_enhance_packet_block *epb;
+	uint32_t orig_len, data_len, padding, flags;
+	uint32_t opt_buf[(3 * sizeof(struct pcapng_option) +
+			  3 * sizeof(uint32_t)) / sizeof(uint32_t)];
+	struct pcapng_option *opt;
+	struct rte_mbuf *mc;
+	uint32_t optlen;
+	uint8_t *tail;
+
+	orig_len = rte_pktmbuf_pkt_len(md);
+
+	mc = rte_pktmbuf_copy(md, mp, 0, length);
+	if (unlikely(mc == NULL))
+		return NULL;
+
+	/* data is padded to 32 bits, followed by the options */
+	data_len = rte_pktmbuf_pkt_len(mc);
+	padding = RTE_ALIGN(data_len, sizeof(uint32_t)) - data_len;
+
+	flags = direction;
+	opt = (struct pcapng_option *)opt_buf;
+	opt = pcapng_add_option(opt, PCAPNG_EPB_FLAGS,
+				&flags, sizeof(flags));
+	opt = pcapng_add_option(opt, PCAPNG_EPB_QUEUE,
+				&queue, sizeof(queue));
+	opt = pcapng_add_option(opt, PCAPNG_OPT_END, NULL, 0);
+	optlen = (uint8_t *)opt - (uint8_t *)opt_buf;
+
+	tail = (uint8_t *)rte_pktmbuf_append(mc,
+			padding + optlen + sizeof(uint32_t));
+	if (unlikely(tail == NULL))
+		goto fail;
+
+	epb = (struct pcapng_enhance_packet_block *)
+		rte_pktmbuf_prepend(mc, sizeof(*epb));
+	if (unlikely(epb == NULL))
+		goto fail;
+
+	epb->block_type = PCAPNG_ENHANCED_PACKET_BLOCK;
+	epb->block_length = rte_pktmbuf_pkt_len(mc);
+
+	/* port id and TSC are converted when the packet is written */
+	epb->interface_id = port_id;
+	epb->timestamp_hi = cycles >> 32;
+	epb->timestamp_lo = (uint32_t)cycles;
+	epb->capture_length = data_len;
+	epb->original_length = orig_len;
+
+	/* the tail of the last segment may not be 32 bit aligned */
+	memset(tail, 0, padding);
+	memcpy(tail + padding, opt_buf, optlen);
+	memcpy(tail + padding + optlen, &epb->block_length,
+		sizeof(uint32_t));
+
+	return mc;
+
+fail:
+	rte_pktmbuf_free(mc);
+	return NULL;
+}
+
+/* flush the gathered packet data to the file */
+static ssize_t
+pcapng_writev(rte_pcapng_t *self, const struct iovec *iov, int cnt)
+{
+	ssize_t ret;
+
+	if (cnt == 0)
+		return 0;
+
+	ret = writev(self->outfd, iov, cnt);
+	if (ret < 0)
+		PCAPNG_LOG(ERR, "writev failed: %s", strerror(errno));
+
+	return ret;
+}
+
+/* Write pre-formatted packets to file. */
+ssize_t
+rte_pcapng_write_packets(rte_pcapng_t *self,
+			 struct rte_mbuf *pkts[], uint16_t nb_pkts)
+{
+	struct iovec iov[IOV_MAX];
+	struct pcapng_enhance_packet_block *epb;
+	struct rte_mbuf *m;
+	ssize_t ret, total;
+	uint32_t index;
+	uint64_t ns;
+	int cnt;
+	uint16_t i;
+
+	total = 0;
+	cnt = 0;
+	for (i = 0; i < nb_pkts; i++) {
+		m = pkts[i];
+
+		/* sanity check that is really a pcapng mbuf */
+		epb = rte_pktmbuf_mtod(m, struct pcapng_enhance_packet_block *);
+		if (unlikely(epb->block_type != PCAPNG_ENHANCED_PACKET_BLOCK ||
+			     epb->block_length != rte_pktmbuf_pkt_len(m))) {
+			PCAPNG_LOG(ERR, "mbuf not prepared for pcapng");
+			continue;
+		}
+
+		/*
+		 * Flush before running out of iovecs, or before a new
+		 * interface block has to be written for an unseen port.
+		 */
+		if (cnt + m->nb_segs > IOV_MAX ||
+		    (epb->interface_id < RTE_MAX_ETHPORTS &&
+		     self->port_index[epb->interface_id] ==
+				PCAPNG_PORT_UNKNOWN)) {
+			ret = pcapng_writev(self, iov, cnt);
+			if (ret < 0)
+				goto out;
+			total += ret;
+			cnt = 0;
+		}
+
+		if (unlikely(m->nb_segs > IOV_MAX ||
+			     pcapng_port_index(self, epb->interface_id,
+					       &index) < 0)) {
+			PCAPNG_LOG(ERR, "can not write packet from port %u",
+				epb->interface_id);
+			continue;
+		}
+		epb->interface_id = index;
+
+		ns = pcapng_tsc_to_ns(self,
+			(uint64_t)epb->timestamp_hi << 32 | epb->timestamp_lo);
+		epb->timestamp_hi = ns >> 32;
+		epb->timestamp_lo = (uint32_t)ns;
+
+		do {
+			iov[cnt].iov_base = rte_pktmbuf_mtod(m, void *);
+			iov[cnt].iov_len = rte_pktmbuf_data_len(m);
+			cnt++;
+		} while ((m = m->next) != NULL);
+	}
+
+	ret = pcapng_writev(self, iov, cnt);
+	if (ret >= 0)
+		ret += total;
+out:
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+	return ret;
+}
+
+/* Create new pcapng writer handle */
+rte_pcapng_t *
+rte_pcapng_fdopen(int fd,
+		  const char *osname, const char *hardware,
+		  const char *appname, const char *comment)
+{
+	struct timespec ts;
+	rte_pcapng_t *self;
+	uint16_t port;
+
+	self = malloc(sizeof(*self));
+	if (!self) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	self->outfd = fd;
+	self->nb_interfaces = 0;
+	memset(self->port_index, 0xff, sizeof(self->port_index));
+
+	/* tie the TSC to the wall clock for timestamp conversion */
+	self->tsc_hz = rte_get_tsc_hz();
+	clock_gettime(CLOCK_REALTIME, &ts);
+	self->tsc_base = rte_get_tsc_cycles();
+	self->ns_base = (uint64_t)ts.tv_sec * NS_PER_S + ts.tv_nsec;
+
+	if (pcapng_section_block(self, osname, hardware, appname, comment) < 0)
+		goto fail;
+
+	RTE_ETH_FOREACH_DEV(port) {
+		if (pcapng_add_interface(self, port) < 0)
+			goto fail;
+	}
+
+	return self;
+fail:
+	free(self);
+	rte_errno = EIO;
+	return NULL;
+}
+
+void
+rte_pcapng_close(rte_pcapng_t *self)
+{
+	close(self->outfd);
+	free(self);
+}
+
+RTE_INIT(pcapng_init_log)
+{
+	pcapng_logtype = rte_log_register("lib.pcapng");
+	if (pcapng_logtype >= 0)
+		rte_log_set_level(pcapng_logtype, RTE_LOG_NOTICE);
+}
@@ -2,13 +2,14 @@
  * Copyright(c) 2016-2018 Intel Corporation
  */
 
-#include <rte_memcpy.h>
 #include <rte_mbuf.h>
 #include <rte_ethdev.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
+#include <rte_memzone.h>
 #include <rte_errno.h>
 #include <rte_string_fns.h>
+#include <rte_pcapng.h>
 
 #include "rte_pdump.h"
 
@@ -19,37 +20,40 @@
 /* Used for the multi-process communication */
 #define PDUMP_MP	"mp_pdump"
 
+/* Shared between the primary and the capturing processes */
+#define MZ_RTE_PDUMP_STATS "rte_pdump_stats"
+
 enum pdump_operation {
 	DISABLE = 1,
 	ENABLE = 2
 };
 
+/* Internal version number in request */
 enum pdump_version {
-	V1 = 1
+	V1 = 1,		    /* no filtering or snap length */
+	V2 = 2,		    /* adds snap length and bpf program */
 };
 
 struct pdump_request {
 	uint16_t ver;
 	uint16_t op;
 	uint32_t flags;
-	union pdump_data {
-		struct enable_v1 {
-			char device[DEVICE_ID_SIZE];
-			uint16_t queue;
-			struct rte_ring *ring;
-			struct rte_mempool *mp;
-			void *filter;
-		} en_v1;
-		struct disable_v1 {
-			char device[DEVICE_ID_SIZE];
-			uint16_t queue;
-			struct rte_ring *ring;
-			struct rte_mempool *mp;
-			void *filter;
-		} dis_v1;
-	} data;
+	char device[DEVICE_ID_SIZE];
+	uint16_t queue;
+	struct rte_ring *ring;
+	struct rte_mempool *mp;
+
+	/* program and instructions are in memory shared with the client */
+	const struct rte_bpf_prm *prm;
+	uint32_t snaplen;
 };
 
+/*
+ * V1 requests end with an unused filter pointer where V2 has the bpf
+ * program, and have no snap length.
+ */
+#define PDUMP_REQUEST_V1_SIZE offsetof(struct pdump_request, snaplen)
+
 struct pdump_response {
 	uint16_t ver;
 	uint16_t res_op;
@@ -60,139 +64,170 @@ static struct pdump_rxtx_cbs {
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
 	const struct rte_eth_rxtx_callback *cb;
-	void *filter;
+	struct rte_bpf *filter;
+	struct rte_bpf_jit jit;
+	uint32_t filter_mbuf; /* filter takes the mbuf, not its data */
+	uint32_t snaplen;
+	uint32_t flags;
 } rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT],
 tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
-static inline int
-pdump_pktmbuf_copy_data(struct rte_mbuf *seg, const struct rte_mbuf *m)
-{
-	if (rte_pktmbuf_tailroom(seg) < m->data_len) {
-		RTE_LOG(ERR, PDUMP,
-			"User mempool: insufficient data_len of mbuf\n");
-		return -EINVAL;
-	}
-
-	seg->port = m->port;
-	seg->vlan_tci = m->vlan_tci;
-	seg->hash = m->hash;
-	seg->tx_offload = m->tx_offload;
-	seg->ol_flags = m->ol_flags;
-	seg->packet_type = m->packet_type;
-	seg->vlan_tci_outer = m->vlan_tci_outer;
-	seg->data_len = m->data_len;
-	seg->pkt_len = seg->data_len;
-	rte_memcpy(rte_pktmbuf_mtod(seg, void *),
-			rte_pktmbuf_mtod(m, void *),
-			rte_pktmbuf_data_len(seg));
-
-	return 0;
-}
+/* per port statistics, updated from any queue of the port */
+static struct pdump_stats {
+	struct rte_pdump_stats rx[RTE_MAX_ETHPORTS];
+	struct rte_pdump_stats tx[RTE_MAX_ETHPORTS];
+} *pdump_stats;
 
-static inline struct rte_mbuf *
-pdump_pktmbuf_copy(struct rte_mbuf *m, struct rte_mempool *mp)
+/* run the filter program over the burst, setting rcs[] to its results */
+static inline void
+pdump_filter(const struct pdump_rxtx_cbs *cbs, struct rte_mbuf **pkts,
+	uint64_t *rcs, uint16_t nb_pkts)
 {
-	struct rte_mbuf *m_dup, *seg, **prev;
-	uint32_t pktlen;
-	uint16_t nseg;
-
-	m_dup = rte_pktmbuf_alloc(mp);
-	if (unlikely(m_dup == NULL))
-		return NULL;
-
-	seg = m_dup;
-	prev = &seg->next;
-	pktlen = m->pkt_len;
-	nseg = 0;
-
-	do {
-		nseg++;
-		if (pdump_pktmbuf_copy_data(seg, m) < 0) {
-			if (seg != m_dup)
-				rte_pktmbuf_free_seg(seg);
-			rte_pktmbuf_free(m_dup);
-			return NULL;
-		}
-		*prev = seg;
-		prev = &seg->next;
-	} while ((m = m->next) != NULL &&
-			(seg = rte_pktmbuf_alloc(mp)) != NULL);
-
-	*prev = NULL;
-	m_dup->nb_segs = nseg;
-	m_dup->pkt_len = pktlen;
-
-	/* Allocation of new indirect segment failed */
-	if (unlikely(seg == NULL)) {
-		rte_pktmbuf_free(m_dup);
-		return NULL;
-	}
-
-	__rte_mbuf_sanity_check(m_dup, 1);
-	return m_dup;
+	void *dp[nb_pkts];
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts; i++)
+		dp[i] = cbs->filter_mbuf ? (void *)pkts[i] :
+			rte_pktmbuf_mtod(pkts[i], void *);
+
+	if (cbs->jit.func != NULL) {
+		for (i = 0; i < nb_pkts; i++)
+			rcs[i] = cbs->jit.func(dp[i]);
+	} else
+		rte_bpf_exec_burst(cbs->filter, dp, rcs, nb_pkts);
 }
 
 static inline void
-pdump_copy(struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
+pdump_copy(uint16_t port, uint16_t queue,
+	enum rte_pcapng_direction direction,
+	struct rte_mbuf **pkts, uint16_t nb_pkts,
+	const struct pdump_rxtx_cbs *cbs,
+	struct rte_pdump_stats *stats)
 {
-	unsigned i;
+	unsigned int i;
 	int ring_enq;
 	uint16_t d_pkts = 0;
+	uint64_t filtered = 0, nombuf = 0;
 	struct rte_mbuf *dup_bufs[nb_pkts];
-	struct pdump_rxtx_cbs *cbs;
-	struct rte_ring *ring;
-	struct rte_mempool *mp;
+	uint64_t rcs[nb_pkts];
+	uint64_t ts;
 	struct rte_mbuf *p;
 
-	cbs  = user_params;
-	ring = cbs->ring;
-	mp = cbs->mp;
+	if (cbs->filter != NULL)
+		pdump_filter(cbs, pkts, rcs, nb_pkts);
+
+	ts = rte_get_tsc_cycles();
 	for (i = 0; i < nb_pkts; i++) {
-		p = pdump_pktmbuf_copy(pkts[i], mp);
-		if (p)
+		/*
+		 * Same return value convention as socket filters and
+		 * pcap_offline_filter(): zero means the packet does not
+		 * match and is not captured.
+		 */
+		if (cbs->filter != NULL && rcs[i] == 0) {
+			filtered++;
+			continue;
+		}
+
+		/* copy no more than the snap length */
+		if (cbs->flags & RTE_PDUMP_FLAG_PCAPNG)
+			p = rte_pcapng_copy(port, queue, pkts[i], cbs->mp,
+					cbs->snaplen, ts, direction);
+		else
+			p = rte_pktmbuf_copy(pkts[i], cbs->mp, 0,
+					cbs->snaplen);
+
+		if (unlikely(p == NULL))
+			nombuf++;
+		else
 			dup_bufs[d_pkts++] = p;
 	}
 
-	ring_enq = rte_ring_enqueue_burst(ring, (void *)dup_bufs, d_pkts, NULL);
+	__atomic_fetch_add(&stats->accepted, nb_pkts - filtered,
+			__ATOMIC_RELAXED);
+	if (filtered != 0)
+		__atomic_fetch_add(&stats->filtered, filtered,
+				__ATOMIC_RELAXED);
+	if (unlikely(nombuf != 0))
+		__atomic_fetch_add(&stats->nombuf, nombuf, __ATOMIC_RELAXED);
+
+	ring_enq = rte_ring_enqueue_burst(cbs->ring, (void *)dup_bufs, d_pkts,
+			NULL);
 	if (unlikely(ring_enq < d_pkts)) {
+		unsigned int drops = d_pkts - ring_enq;
+
 		RTE_LOG(DEBUG, PDUMP,
 			"only %d of packets enqueued to ring\n", ring_enq);
-		do {
-			rte_pktmbuf_free(dup_bufs[ring_enq]);
-		} while (++ring_enq < d_pkts);
+		__atomic_fetch_add(&stats->ringfull, drops, __ATOMIC_RELAXED);
+		rte_pktmbuf_free_bulk(&dup_bufs[ring_enq], drops);
 	}
 }
 
 static uint16_t
-pdump_rx(uint16_t port __rte_unused, uint16_t qidx __rte_unused,
+pdump_rx(uint16_t port, uint16_t queue,
 	struct rte_mbuf **pkts, uint16_t nb_pkts,
 	uint16_t max_pkts __rte_unused,
 	void *user_params)
 {
-	pdump_copy(pkts, nb_pkts, user_params);
+	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_IN, pkts, nb_pkts,
+		user_params, &pdump_stats->rx[port]);
 	return nb_pkts;
 }
 
 static uint16_t
-pdump_tx(uint16_t port __rte_unused, uint16_t qidx __rte_unused,
+pdump_tx(uint16_t port, uint16_t queue,
 		struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 {
-	pdump_copy(pkts, nb_pkts, user_params);
+	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_OUT, pkts, nb_pkts,
+		user_params, &pdump_stats->tx[port]);
 	return nb_pkts;
 }
 
+/* fill in the callback parameters from the enable request */
 static int
-pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
-				struct rte_ring *ring, struct rte_mempool *mp,
-				uint16_t operation)
+pdump_cbs_setup(struct pdump_rxtx_cbs *cbs, const struct pdump_request *p)
+{
+	/*
+	 * The filter of the previous capture can only be released here:
+	 * it may still be in use by a burst that was running while its
+	 * callback was removed.
+	 */
+	rte_bpf_destroy(cbs->filter);
+	cbs->filter = NULL;
+	memset(&cbs->jit, 0, sizeof(cbs->jit));
+
+	if (p->prm != NULL) {
+		cbs->filter = rte_bpf_load(p->prm);
+		if (cbs->filter == NULL) {
+			RTE_LOG(ERR, PDUMP,
+				"failed to load bpf filter, errno=%d\n",
+				rte_errno);
+			return -rte_errno;
+		}
+		rte_bpf_get_jit(cbs->filter, &cbs->jit);
+		cbs->filter_mbuf =
+			(p->prm->prog_arg.type == RTE_BPF_ARG_PTR_MBUF);
+	}
+
+	cbs->ring = p->ring;
+	cbs->mp = p->mp;
+	cbs->snaplen = p->snaplen;
+	cbs->flags = p->flags;
+
+	return 0;
+}
+
+static int
+pdump_register_rx_callbacks(const struct pdump_request *p, uint16_t end_q,
+				uint16_t port, uint16_t queue)
 {
 	uint16_t qid;
 	struct pdump_rxtx_cbs *cbs = NULL;
+	int ret;
 
 	qid = (queue == RTE_PDUMP_ALL_QUEUES) ? 0 : queue;
 	for (; qid < end_q; qid++) {
 		cbs = &rx_cbs[port][qid];
-		if (cbs && operation == ENABLE) {
+		if (cbs && p->op == ENABLE) {
 			if (cbs->cb) {
 				RTE_LOG(ERR, PDUMP,
 					"failed to add rx callback for port=%d "
@@ -200,8 +235,9 @@ pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 					port, qid);
 				return -EEXIST;
 			}
-			cbs->ring = ring;
-			cbs->mp = mp;
+			ret = pdump_cbs_setup(cbs, p);
+			if (ret < 0)
+				return ret;
 			cbs->cb = rte_eth_add_first_rx_callback(port, qid,
 								pdump_rx, cbs);
 			if (cbs->cb == NULL) {
@@ -211,9 +247,7 @@ pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 				return rte_errno;
 			}
 		}
-		if (cbs && operation == DISABLE) {
-			int ret;
-
+		if (cbs && p->op == DISABLE) {
 			if (cbs->cb == NULL) {
 				RTE_LOG(ERR, PDUMP,
 					"failed to delete non existing rx "
@@ -236,18 +270,18 @@ pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 }
 
 static int
-pdump_register_tx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
-				struct rte_ring *ring, struct rte_mempool *mp,
-				uint16_t operation)
+pdump_register_tx_callbacks(const struct pdump_request *p, uint16_t end_q,
+				uint16_t port, uint16_t queue)
 {
 
 	uint16_t qid;
 	struct pdump_rxtx_cbs *cbs = NULL;
+	int ret;
 
 	qid = (queue == RTE_PDUMP_ALL_QUEUES) ? 0 : queue;
 	for (; qid < end_q; qid++) {
 		cbs = &tx_cbs[port][qid];
-		if (cbs && operation == ENABLE) {
+		if (cbs && p->op == ENABLE) {
 			if (cbs->cb) {
 				RTE_LOG(ERR, PDUMP,
 					"failed to add tx callback for port=%d "
@@ -255,8 +289,9 @@ pdump_register_tx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 					port, qid);
 				return -EEXIST;
 			}
-			cbs->ring = ring;
-			cbs->mp = mp;
+			ret = pdump_cbs_setup(cbs, p);
+			if (ret < 0)
+				return ret;
 			cbs->cb = rte_eth_add_tx_callback(port, qid, pdump_tx,
 								cbs);
 			if (cbs->cb == NULL) {
@@ -266,9 +301,7 @@ pdump_register_tx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 				return rte_errno;
 			}
 		}
-		if (cbs && operation == DISABLE) {
-			int ret;
-
+		if (cbs && p->op == DISABLE) {
 			if (cbs->cb == NULL) {
 				RTE_LOG(ERR, PDUMP,
 					"failed to delete non existing tx "
@@ -297,37 +330,37 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	uint16_t port;
 	int ret = 0;
 	uint32_t flags;
-	uint16_t operation;
-	struct rte_ring *ring;
-	struct rte_mempool *mp;
+	struct pdump_request v1_req;
+
+	if (p->ver == V1) {
+		/* capture whole packets without filter, in the V1 format */
+		v1_req = *p;
+		v1_req.flags &= RTE_PDUMP_FLAG_RXTX;
+		v1_req.prm = NULL;
+		v1_req.snaplen = UINT32_MAX;
+		p = &v1_req;
+	} else if (p->ver != V2) {
+		RTE_LOG(ERR, PDUMP,
+			"incorrect client version %u, server version %u\n",
+			p->ver, V2);
+		return -EINVAL;
+	}
+
+	if (p->op == ENABLE && p->prm != NULL && p->prm->nb_xsym != 0) {
+		RTE_LOG(ERR, PDUMP,
+			"bpf filter with external symbols is not supported\n");
+		return -ENOTSUP;
+	}
 
 	flags = p->flags;
-	operation = p->op;
-	if (operation == ENABLE) {
-		ret = rte_eth_dev_get_port_by_name(p->data.en_v1.device,
-				&port);
-		if (ret < 0) {
-			RTE_LOG(ERR, PDUMP,
-				"failed to get port id for device id=%s\n",
-				p->data.en_v1.device);
-			return -EINVAL;
-		}
-		queue = p->data.en_v1.queue;
-		ring = p->data.en_v1.ring;
-		mp = p->data.en_v1.mp;
-	} else {
-		ret = rte_eth_dev_get_port_by_name(p->data.dis_v1.device,
-				&port);
-		if (ret < 0) {
-			RTE_LOG(ERR, PDUMP,
-				"failed to get port id for device id=%s\n",
-				p->data.dis_v1.device);
-			return -EINVAL;
-		}
-		queue = p->data.dis_v1.queue;
-		ring = p->data.dis_v1.ring;
-		mp = p->data.dis_v1.mp;
+	ret = rte_eth_dev_get_port_by_name(p->device, &port);
+	if (ret < 0) {
+		RTE_LOG(ERR, PDUMP,
+			"failed to get port id for device id=%s\n",
+			p->device);
+		return -EINVAL;
 	}
+	queue = p->queue;
 
 	/* validation if packet capture is for all queues */
 	if (queue == RTE_PDUMP_ALL_QUEUES) {
@@ -354,7 +387,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 			return -EINVAL;
 		}
 		if ((nb_tx_q == 0 || nb_rx_q == 0) &&
-			flags == RTE_PDUMP_FLAG_RXTX) {
+			(flags & RTE_PDUMP_FLAG_RXTX) == RTE_PDUMP_FLAG_RXTX) {
 			RTE_LOG(ERR, PDUMP,
 				"both tx&rx queues must be non zero\n");
 			return -EINVAL;
@@ -364,8 +397,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	/* register RX callback */
 	if (flags & RTE_PDUMP_FLAG_RX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_rx_q : queue + 1;
-		ret = pdump_register_rx_callbacks(end_q, port, queue, ring, mp,
-							operation);
+		ret = pdump_register_rx_callbacks(p, end_q, port, queue);
 		if (ret < 0)
 			return ret;
 	}
@@ -373,8 +405,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	/* register TX callback */
 	if (flags & RTE_PDUMP_FLAG_TX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_tx_q : queue + 1;
-		ret = pdump_register_tx_callbacks(end_q, port, queue, ring, mp,
-							operation);
+		ret = pdump_register_tx_callbacks(p, end_q, port, queue);
 		if (ret < 0)
 			return ret;
 	}
@@ -386,18 +417,20 @@ static int
 pdump_server(const struct rte_mp_msg *mp_msg, const void *peer)
 {
 	struct rte_mp_msg mp_resp;
-	const struct pdump_request *cli_req;
+	struct pdump_request cli_req;
 	struct pdump_response *resp = (struct pdump_response *)&mp_resp.param;
 
-	/* recv client requests */
-	if (mp_msg->len_param != sizeof(*cli_req)) {
+	/* recv client requests, V1 ones being shorter */
+	if (mp_msg->len_param != sizeof(cli_req) &&
+			mp_msg->len_param != PDUMP_REQUEST_V1_SIZE) {
 		RTE_LOG(ERR, PDUMP, "failed to recv from client\n");
 		resp->err_value = -EINVAL;
 	} else {
-		cli_req = (const struct pdump_request *)mp_msg->param;
-		resp->ver = cli_req->ver;
-		resp->res_op = cli_req->op;
-		resp->err_value = set_pdump_rxtx_cbs(cli_req);
+		memset(&cli_req, 0, sizeof(cli_req));
+		memcpy(&cli_req, mp_msg->param, mp_msg->len_param);
+		resp->ver = cli_req.ver;
+		resp->res_op = cli_req.op;
+		resp->err_value = set_pdump_rxtx_cbs(&cli_req);
 	}
 
 	strlcpy(mp_resp.name, PDUMP_MP, RTE_MP_MAX_NAME_LEN);
@@ -415,7 +448,24 @@ pdump_server(const struct rte_mp_msg *mp_msg, const void *peer)
 int
 rte_pdump_init(void)
 {
-	int ret = rte_mp_action_register(PDUMP_MP, pdump_server);
+	const struct rte_memzone *mz;
+	int ret;
+
+	RTE_BUILD_BUG_ON(sizeof(struct pdump_request) > RTE_MP_MAX_PARAM_LEN);
+
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY)
+		mz = rte_memzone_reserve(MZ_RTE_PDUMP_STATS,
+				sizeof(*pdump_stats), rte_socket_id(), 0);
+	else
+		mz = rte_memzone_lookup(MZ_RTE_PDUMP_STATS);
+	if (mz == NULL) {
+		RTE_LOG(ERR, PDUMP, "cannot allocate pdump statistics\n");
+		rte_errno = ENOMEM;
+		return -1;
+	}
+	pdump_stats = mz->addr;
+
+	ret = rte_mp_action_register(PDUMP_MP, pdump_server);
 	if (ret && rte_errno != ENOTSUP)
 		return -1;
 	return 0;
@@ -424,8 +474,17 @@ rte_pdump_init(void)
 int
 rte_pdump_uninit(void)
 {
+	const struct rte_memzone *mz;
+
 	rte_mp_action_unregister(PDUMP_MP);
 
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		mz = rte_memzone_lookup(MZ_RTE_PDUMP_STATS);
+		if (mz != NULL)
+			rte_memzone_free(mz);
+	}
+	pdump_stats = NULL;
+
 	return 0;
 }
 
@@ -457,8 +516,8 @@ pdump_validate_ring_mp(struct rte_ring *ring, struct rte_mempool *mp)
 static int
 pdump_validate_flags(uint32_t flags)
 {
-	if (flags != RTE_PDUMP_FLAG_RX && flags != RTE_PDUMP_FLAG_TX &&
-		flags != RTE_PDUMP_FLAG_RXTX) {
+	if ((flags & RTE_PDUMP_FLAG_RXTX) == 0 ||
+		(flags & ~(RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_PCAPNG)) != 0) {
 		RTE_LOG(ERR, PDUMP,
 			"invalid flags, should be either rx/tx/rxtx\n");
 		rte_errno = EINVAL;
@@ -468,6 +527,19 @@ pdump_validate_flags(uint32_t flags)
 	return 0;
 }
 
+static int
+pdump_validate_prm(const struct rte_bpf_prm *prm)
+{
+	if (prm != NULL && prm->nb_xsym != 0) {
+		RTE_LOG(ERR, PDUMP,
+			"bpf filter with external symbols is not supported\n");
+		rte_errno = ENOTSUP;
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 pdump_validate_port(uint16_t port, char *name)
 {
@@ -493,12 +565,12 @@ pdump_validate_port(uint16_t port, char *name)
 }
 
 static int
-pdump_prepare_client_request(char *device, uint16_t queue,
-				uint32_t flags,
+pdump_prepare_client_request(const char *device, uint16_t queue,
+				uint32_t flags, uint32_t snaplen,
 				uint16_t operation,
 				struct rte_ring *ring,
 				struct rte_mempool *mp,
-				void *filter)
+				const struct rte_bpf_prm *prm)
 {
 	int ret = -1;
 	struct rte_mp_msg mp_req, *mp_rep;
@@ -507,23 +579,19 @@ pdump_prepare_client_request(char *device, uint16_t queue,
 	struct pdump_request *req = (struct pdump_request *)mp_req.param;
 	struct pdump_response *resp;
 
-	req->ver = 1;
+	memset(req, 0, sizeof(*req));
+
+	req->ver = V2;
 	req->flags = flags;
 	req->op = operation;
+	req->queue = queue;
+	strlcpy(req->device, device, sizeof(req->device));
+
 	if ((operation & ENABLE) != 0) {
-		strlcpy(req->data.en_v1.device, device,
-			sizeof(req->data.en_v1.device));
-		req->data.en_v1.queue = queue;
-		req->data.en_v1.ring = ring;
-		req->data.en_v1.mp = mp;
-		req->data.en_v1.filter = filter;
-	} else {
-		strlcpy(req->data.dis_v1.device, device,
-			sizeof(req->data.dis_v1.device));
-		req->data.dis_v1.queue = queue;
-		req->data.dis_v1.ring = NULL;
-		req->data.dis_v1.mp = NULL;
-		req->data.dis_v1.filter = NULL;
+		req->ring = ring;
+		req->mp = mp;
+		req->prm = prm;
+		req->snaplen = snaplen;
 	}
 
 	strlcpy(mp_req.name, PDUMP_MP, RTE_MP_MAX_NAME_LEN);
@@ -544,14 +612,19 @@ pdump_prepare_client_request(char *device, uint16_t queue,
 	return ret;
 }
 
-int
-rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
-			struct rte_ring *ring,
-			struct rte_mempool *mp,
-			void *filter)
+/*
+ * There are two versions of this function, because although original API
+ * left place holder for future filter, it never checked the value.
+ * Therefore the API can't depend on application passing a non
+ * bogus value.
+ */
+static int
+pdump_enable(uint16_t port, uint16_t queue,
+	     uint32_t flags, uint32_t snaplen,
+	     struct rte_ring *ring, struct rte_mempool *mp,
+	     const struct rte_bpf_prm *prm)
 {
-
-	int ret = 0;
+	int ret;
 	char name[DEVICE_ID_SIZE];
 
 	ret = pdump_validate_port(port, name);
@@ -561,35 +634,80 @@ rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
 	if (ret < 0)
 		return ret;
 	ret = pdump_validate_flags(flags);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_prm(prm);
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(name, queue, flags,
-						ENABLE, ring, mp, filter);
+	return pdump_prepare_client_request(name, queue, flags, snaplen,
+					    ENABLE, ring, mp, prm);
+}
 
-	return ret;
+int
+rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
+		 struct rte_ring *ring,
+		 struct rte_mempool *mp,
+		 void *filter __rte_unused)
+{
+	return pdump_enable(port, queue, flags, UINT32_MAX,
+			    ring, mp, NULL);
 }
 
 int
-rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
-				uint32_t flags,
-				struct rte_ring *ring,
-				struct rte_mempool *mp,
-				void *filter)
+rte_pdump_enable_bpf(uint16_t port, uint16_t queue,
+		     uint32_t flags, uint32_t snaplen,
+		     struct rte_ring *ring,
+		     struct rte_mempool *mp,
+		     const struct rte_bpf_prm *prm)
 {
-	int ret = 0;
+	return pdump_enable(port, queue, flags, snaplen,
+			    ring, mp, prm);
+}
+
+static int
+pdump_enable_by_deviceid(const char *device_id, uint16_t queue,
+			 uint32_t flags, uint32_t snaplen,
+			 struct rte_ring *ring,
+			 struct rte_mempool *mp,
+			 const struct rte_bpf_prm *prm)
+{
+	int ret;
 
 	ret = pdump_validate_ring_mp(ring, mp);
 	if (ret < 0)
 		return ret;
 	ret = pdump_validate_flags(flags);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_prm(prm);
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(device_id, queue, flags,
-						ENABLE, ring, mp, filter);
+	return pdump_prepare_client_request(device_id, queue, flags, snaplen,
+					    ENABLE, ring, mp, prm);
+}
 
-	return ret;
+int
+rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
+			     uint32_t flags,
+			     struct rte_ring *ring,
+			     struct rte_mempool *mp,
+			     void *filter __rte_unused)
+{
+	return pdump_enable_by_deviceid(device_id, queue, flags,
+					UINT32_MAX, ring, mp, NULL);
+}
+
+int
+rte_pdump_enable_bpf_by_deviceid(const char *device_id, uint16_t queue,
+				 uint32_t flags, uint32_t snaplen,
+				 struct rte_ring *ring,
+				 struct rte_mempool *mp,
+				 const struct rte_bpf_prm *prm)
+{
+	return pdump_enable_by_deviceid(device_id, queue, flags, snaplen,
+					ring, mp, prm);
 }
 
 int
@@ -605,7 +723,7 @@ rte_pdump_disable(uint16_t port, uint16_t queue, uint32_t flags)
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(name, queue, flags,
+	ret = pdump_prepare_client_request(name, queue, flags, 0,
 						DISABLE, NULL, NULL, NULL);
 
 	return ret;
@@ -621,8 +739,67 @@ rte_pdump_disable_by_deviceid(char *device_id, uint16_t queue,
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(device_id, queue, flags,
+	ret = pdump_prepare_client_request(device_id, queue, flags, 0,
 						DISABLE, NULL, NULL, NULL);
 
 	return ret;
 }
+
+static void
+pdump_sum_stats(uint16_t port, struct rte_pdump_stats *total)
+{
+	const struct rte_pdump_stats *st[] = {
+		&pdump_stats->rx[port], &pdump_stats->tx[port],
+	};
+	unsigned int i;
+
+	memset(total, 0, sizeof(*total));
+	for (i = 0; i < RTE_DIM(st); i++) {
+		total->accepted += __atomic_load_n(&st[i]->accepted,
+						   __ATOMIC_RELAXED);
+		total->filtered += __atomic_load_n(&st[i]->filtered,
+						   __ATOMIC_RELAXED);
+		total->nombuf += __atomic_load_n(&st[i]->nombuf,
+						 __ATOMIC_RELAXED);
+		total->ringfull += __atomic_load_n(&st[i]->ringfull,
+						   __ATOMIC_RELAXED);
+	}
+}
+
+int
+rte_pdump_stats(uint16_t port, struct rte_pdump_stats *stats)
+{
+	const struct rte_memzone *mz;
+	int ret;
+
+	memset(stats, 0, sizeof(*stats));
+	ret = rte_eth_dev_is_valid_port(port);
+	if (ret == 0) {
+		RTE_LOG(ERR, PDUMP,
+			"port %u is not valid\n", port);
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	if (pdump_stats == NULL) {
+		if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
+			/* rte_pdump_init was not called */
+			RTE_LOG(ERR, PDUMP, "pdump stats not initialized\n");
+			rte_errno = EINVAL;
+			return -1;
+		}
+
+		/* secondary process looks up the memzone */
+		mz = rte_memzone_lookup(MZ_RTE_PDUMP_STATS);
+		if (mz == NULL) {
+			/* rte_pdump_init was not called in primary process */
+			RTE_LOG(ERR, PDUMP, "can not find pdump stats\n");
+			rte_errno = EINVAL;
+			return -1;
+		}
+		pdump_stats = mz->addr;
+	}
+
+	pdump_sum_stats(port, stats);
+	return 0;
+}
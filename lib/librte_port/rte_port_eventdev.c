@@ -140,13 +140,27 @@ struct rte_port_eventdev_writer {
 	uint8_t queue_id;
 	uint8_t sched_type;
 	uint8_t evt_op;
+	int flow_id_from_rss;
+	uint32_t flow_id;
 };
 
+/* The flow ID field of an event is 20 bits wide. */
+#define PORT_EVENTDEV_FLOW_ID_MASK ((1 << 20) - 1)
+
+static inline void
+event_flow_id_set(struct rte_event *ev, struct rte_mbuf *pkt,
+	int flow_id_from_rss, uint32_t flow_id)
+{
+	if (flow_id_from_rss && (pkt->ol_flags & PKT_RX_RSS_HASH))
+		ev->flow_id = pkt->hash.rss & PORT_EVENTDEV_FLOW_ID_MASK;
+	else
+		ev->flow_id = flow_id;
+}
+
 static void *
-rte_port_eventdev_writer_create(void *params, int socket_id)
+port_eventdev_writer_create(struct rte_port_eventdev_writer_params *conf,
+	int flow_id_from_rss, uint32_t flow_id, int socket_id)
 {
-	struct rte_port_eventdev_writer_params *conf =
-			params;
 	struct rte_port_eventdev_writer *port;
 	unsigned int i;
 
@@ -177,6 +191,8 @@ rte_port_eventdev_writer_create(void *params, int socket_id)
 	port->queue_id = conf->queue_id;
 	port->sched_type = conf->sched_type;
 	port->evt_op = conf->evt_op;
+	port->flow_id_from_rss = flow_id_from_rss;
+	port->flow_id = flow_id & PORT_EVENTDEV_FLOW_ID_MASK;
 	memset(&port->ev, 0, sizeof(port->ev));
 
 	for (i = 0; i < ARRAY_SIZE(port->ev); i++) {
@@ -188,6 +204,27 @@ rte_port_eventdev_writer_create(void *params, int socket_id)
 	return port;
 }
 
+static void *
+rte_port_eventdev_writer_create(void *params, int socket_id)
+{
+	return port_eventdev_writer_create(params, 0, 0, socket_id);
+}
+
+static void *
+rte_port_eventdev_writer_flow_create(void *params, int socket_id)
+{
+	struct rte_port_eventdev_writer_flow_params *conf =
+			params;
+
+	if (conf == NULL) {
+		RTE_LOG(ERR, PORT, "%s: Invalid input parameters\n", __func__);
+		return NULL;
+	}
+
+	return port_eventdev_writer_create(&conf->writer,
+		conf->flow_id_from_rss, conf->flow_id, socket_id);
+}
+
 static inline void
 send_burst(struct rte_port_eventdev_writer *p)
 {
@@ -210,6 +247,8 @@ rte_port_eventdev_writer_tx(void *port, struct rte_mbuf *pkt)
 {
 	struct rte_port_eventdev_writer *p = port;
 
+	event_flow_id_set(&p->ev[p->enq_buf_count], pkt, p->flow_id_from_rss,
+		p->flow_id);
 	p->ev[p->enq_buf_count++].mbuf  = pkt;
 	RTE_PORT_EVENTDEV_WRITER_STATS_PKTS_IN_ADD(p, 1);
 	if (p->enq_buf_count >= p->enq_burst_sz)
@@ -245,6 +284,8 @@ rte_port_eventdev_writer_tx_bulk(void *port,
 			events[i].queue_id = p->queue_id;
 			events[i].sched_type = p->sched_type;
 			events[i].op = p->evt_op;
+			event_flow_id_set(&events[i], pkts[i],
+				p->flow_id_from_rss, p->flow_id);
 		}
 
 		n_enq_ok = rte_event_enqueue_burst(p->eventdev_id, p->port_id,
@@ -260,6 +301,9 @@ rte_port_eventdev_writer_tx_bulk(void *port,
 			uint32_t pkt_index = __builtin_ctzll(pkts_mask);
 			uint64_t pkt_mask = 1LLU << pkt_index;
 
+			event_flow_id_set(&p->ev[enq_buf_count],
+				pkts[pkt_index], p->flow_id_from_rss,
+				p->flow_id);
 			p->ev[enq_buf_count++].mbuf = pkts[pkt_index];
 
 			RTE_PORT_EVENTDEV_WRITER_STATS_PKTS_IN_ADD(p, 1);
@@ -346,14 +390,16 @@ struct rte_port_eventdev_writer_nodrop {
 	uint8_t queue_id;
 	uint8_t sched_type;
 	uint8_t evt_op;
+	int flow_id_from_rss;
+	uint32_t flow_id;
 };
 
 
 static void *
-rte_port_eventdev_writer_nodrop_create(void *params, int socket_id)
+port_eventdev_writer_nodrop_create(
+	struct rte_port_eventdev_writer_nodrop_params *conf,
+	int flow_id_from_rss, uint32_t flow_id, int socket_id)
 {
-	struct rte_port_eventdev_writer_nodrop_params *conf =
-			params;
 	struct rte_port_eventdev_writer_nodrop *port;
 	unsigned int i;
 
@@ -384,6 +430,8 @@ rte_port_eventdev_writer_nodrop_create(void *params, int socket_id)
 	port->queue_id = conf->queue_id;
 	port->sched_type = conf->sched_type;
 	port->evt_op = conf->evt_op;
+	port->flow_id_from_rss = flow_id_from_rss;
+	port->flow_id = flow_id & PORT_EVENTDEV_FLOW_ID_MASK;
 	memset(&port->ev, 0, sizeof(port->ev));
 
 	for (i = 0; i < ARRAY_SIZE(port->ev); i++) {
@@ -401,6 +449,27 @@ rte_port_eventdev_writer_nodrop_create(void *params, int socket_id)
 	return port;
 }
 
+static void *
+rte_port_eventdev_writer_nodrop_create(void *params, int socket_id)
+{
+	return port_eventdev_writer_nodrop_create(params, 0, 0, socket_id);
+}
+
+static void *
+rte_port_eventdev_writer_nodrop_flow_create(void *params, int socket_id)
+{
+	struct rte_port_eventdev_writer_nodrop_flow_params *conf =
+			params;
+
+	if (conf == NULL) {
+		RTE_LOG(ERR, PORT, "%s: Invalid input parameters\n", __func__);
+		return NULL;
+	}
+
+	return port_eventdev_writer_nodrop_create(&conf->writer,
+		conf->flow_id_from_rss, conf->flow_id, socket_id);
+}
+
 static inline void
 send_burst_nodrop(struct rte_port_eventdev_writer_nodrop *p)
 {
@@ -440,6 +509,8 @@ rte_port_eventdev_writer_nodrop_tx(void *port, struct rte_mbuf *pkt)
 {
 	struct rte_port_eventdev_writer_nodrop *p = port;
 
+	event_flow_id_set(&p->ev[p->enq_buf_count], pkt, p->flow_id_from_rss,
+		p->flow_id);
 	p->ev[p->enq_buf_count++].mbuf = pkt;
 
 	RTE_PORT_EVENTDEV_WRITER_NODROP_STATS_PKTS_IN_ADD(p, 1);
@@ -478,6 +549,8 @@ rte_port_eventdev_writer_nodrop_tx_bulk(void *port,
 			events[i].queue_id = p->queue_id;
 			events[i].sched_type = p->sched_type;
 			events[i].op = p->evt_op;
+			event_flow_id_set(&events[i], pkts[i],
+				p->flow_id_from_rss, p->flow_id);
 		}
 
 		n_enq_ok = rte_event_enqueue_burst(p->eventdev_id, p->port_id,
@@ -492,6 +565,8 @@ rte_port_eventdev_writer_nodrop_tx_bulk(void *port,
 		 */
 		for (; n_enq_ok < n_pkts; n_enq_ok++) {
 			struct rte_mbuf *pkt = pkts[n_enq_ok];
+			event_flow_id_set(&p->ev[p->enq_buf_count], pkt,
+				p->flow_id_from_rss, p->flow_id);
 			p->ev[p->enq_buf_count++].mbuf = pkt;
 		}
 		send_burst_nodrop(p);
@@ -500,6 +575,9 @@ rte_port_eventdev_writer_nodrop_tx_bulk(void *port,
 			uint32_t pkt_index = __builtin_ctzll(pkts_mask);
 			uint64_t pkt_mask = 1LLU << pkt_index;
 
+			event_flow_id_set(&p->ev[enq_buf_count],
+				pkts[pkt_index], p->flow_id_from_rss,
+				p->flow_id);
 			p->ev[enq_buf_count++].mbuf = pkts[pkt_index];
 
 			RTE_PORT_EVENTDEV_WRITER_STATS_PKTS_IN_ADD(p, 1);
@@ -582,3 +660,21 @@ struct rte_port_out_ops rte_port_eventdev_writer_nodrop_ops = {
 	.f_flush = rte_port_eventdev_writer_nodrop_flush,
 	.f_stats = rte_port_eventdev_writer_nodrop_stats_read,
 };
+
+struct rte_port_out_ops rte_port_eventdev_writer_flow_ops = {
+	.f_create = rte_port_eventdev_writer_flow_create,
+	.f_free = rte_port_eventdev_writer_free,
+	.f_tx = rte_port_eventdev_writer_tx,
+	.f_tx_bulk = rte_port_eventdev_writer_tx_bulk,
+	.f_flush = rte_port_eventdev_writer_flush,
+	.f_stats = rte_port_eventdev_writer_stats_read,
+};
+
+struct rte_port_out_ops rte_port_eventdev_writer_nodrop_flow_ops = {
+	.f_create = rte_port_eventdev_writer_nodrop_flow_create,
+	.f_free = rte_port_eventdev_writer_nodrop_free,
+	.f_tx = rte_port_eventdev_writer_nodrop_tx,
+	.f_tx_bulk = rte_port_eventdev_writer_nodrop_tx_bulk,
+	.f_flush = rte_port_eventdev_writer_nodrop_flush,
+	.f_stats = rte_port_eventdev_writer_nodrop_stats_read,
+};
@@ -65,6 +65,26 @@ struct rte_port_eventdev_writer_params {
 /** Eventdev_writer port operations. */
 extern struct rte_port_out_ops rte_port_eventdev_writer_ops;
 
+/** Eventdev_writer port parameters with event flow ID selection. */
+struct rte_port_eventdev_writer_flow_params {
+	/** Eventdev_writer port parameters. */
+	struct rte_port_eventdev_writer_params writer;
+
+	/** When non-zero, the flow ID of each event is taken from the RSS
+	 * hash of its mbuf, so that packets of different flows can be
+	 * processed in parallel on atomic queues.
+	 */
+	int flow_id_from_rss;
+
+	/** Event flow ID used when flow_id_from_rss is zero or when the mbuf
+	 * carries no RSS hash (PKT_RX_RSS_HASH not set).
+	 */
+	uint32_t flow_id;
+};
+
+/** Eventdev_writer port operations with event flow ID selection. */
+extern struct rte_port_out_ops rte_port_eventdev_writer_flow_ops;
+
 /** Event_writer_nodrop port parameters. */
 struct rte_port_eventdev_writer_nodrop_params {
 	/** Eventdev Device ID. */
@@ -92,6 +112,25 @@ struct rte_port_eventdev_writer_nodrop_params {
 /** Eventdev_writer_nodrop port operations. */
 extern struct rte_port_out_ops rte_port_eventdev_writer_nodrop_ops;
 
+/** Eventdev_writer_nodrop port parameters with event flow ID selection. */
+struct rte_port_eventdev_writer_nodrop_flow_params {
+	/** Eventdev_writer_nodrop port parameters. */
+	struct rte_port_eventdev_writer_nodrop_params writer;
+
+	/** When non-zero, the flow ID of each event is taken from the RSS
+	 * hash of its mbuf, see rte_port_eventdev_writer_flow_params.
+	 */
+	int flow_id_from_rss;
+
+	/** Event flow ID used when flow_id_from_rss is zero or when the mbuf
+	 * carries no RSS hash (PKT_RX_RSS_HASH not set).
+	 */
+	uint32_t flow_id;
+};
+
+/** Eventdev_writer_nodrop port operations with event flow ID selection. */
+extern struct rte_port_out_ops rte_port_eventdev_writer_nodrop_flow_ops;
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,7 @@
 #include <rte_string_fns.h>
 #include <rte_log.h>
 #include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
@@ -38,19 +39,104 @@ struct cir_buffer {
 	struct rte_mbuf **entries;
 } __rte_cache_aligned;
 
+/* A sequence space: one per buffer, or one per flow in flow mode */
+struct reorder_window {
+	uint32_t min_seqn;  /**< Lowest seq. number that can be in the buffer */
+	int is_initialized;
+	int queued;         /**< Window is on the buffer's pending list */
+	struct cir_buffer ready_buf; /**< temp buffer for dequeued entries */
+	struct cir_buffer order_buf; /**< buffer used to reorder entries */
+};
+
 /* The reorder buffer data structure itself */
 struct rte_reorder_buffer {
 	char name[RTE_REORDER_NAMESIZE];
-	uint32_t min_seqn;  /**< Lowest seq. number that can be in the buffer */
 	unsigned int memsize; /**< memory area size of reorder buffer */
-	struct cir_buffer ready_buf; /**< temp buffer for dequeued entries */
-	struct cir_buffer order_buf; /**< buffer used to reorder entries */
-	int is_initialized;
+	int seqn_offset;    /**< mbuf offset of the 32-bit sequence number */
+	unsigned int nb_flows; /**< Number of sequence spaces */
+	unsigned int flow_mask; /**< [nb_flows - 1]: flow tag to window */
+	struct reorder_window *flows; /**< Sequence spaces, &win if only one */
+	uint32_t *pending;  /**< Ring of flows with mbufs ready to drain */
+	unsigned int pending_head;
+	unsigned int pending_tail;
+	unsigned int pending_count;
+	struct reorder_window win; /**< Sequence space of a single flow buffer */
 } __rte_cache_aligned;
 
+int rte_reorder_seqn_dynfield_offset = -1;
+
 static void
 rte_reorder_free_mbufs(struct rte_reorder_buffer *b);
 
+/* Lay out the two rings of a window in mem, which holds 2 * size entries */
+static void
+reorder_window_init(struct reorder_window *w, unsigned int size, void *mem)
+{
+	w->order_buf.size = w->ready_buf.size = size;
+	w->order_buf.mask = w->ready_buf.mask = size - 1;
+	w->ready_buf.entries = mem;
+	w->order_buf.entries = RTE_PTR_ADD(mem,
+			size * sizeof(w->ready_buf.entries[0]));
+}
+
+static void
+reorder_window_reset(struct reorder_window *w)
+{
+	const size_t len = w->order_buf.size * sizeof(w->order_buf.entries[0]);
+
+	memset(w->ready_buf.entries, 0, len);
+	memset(w->order_buf.entries, 0, len);
+	w->ready_buf.head = w->ready_buf.tail = 0;
+	w->order_buf.head = w->order_buf.tail = 0;
+	w->min_seqn = 0;
+	w->is_initialized = 0;
+	w->queued = 0;
+}
+
+/* Memory needed for a buffer of nb_flows windows of size entries each */
+static size_t
+reorder_memsize(unsigned int size, unsigned int nb_flows)
+{
+	size_t memsize = sizeof(struct rte_reorder_buffer);
+
+	if (nb_flows <= 1)
+		return memsize + 2 * size * sizeof(struct rte_mbuf *);
+
+	return memsize + (size_t)nb_flows * (sizeof(struct reorder_window) +
+			sizeof(uint32_t) + 2 * size * sizeof(struct rte_mbuf *));
+}
+
+static void
+reorder_buffer_init(struct rte_reorder_buffer *b, unsigned int bufsize,
+		const char *name, unsigned int size, unsigned int nb_flows,
+		int seqn_offset)
+{
+	void *mem = &b[1];
+	unsigned int i;
+
+	memset(b, 0, bufsize);
+	strlcpy(b->name, name, sizeof(b->name));
+	b->memsize = bufsize;
+	b->seqn_offset = seqn_offset;
+
+	if (nb_flows <= 1) {
+		b->nb_flows = 1;
+		b->flows = &b->win;
+		reorder_window_init(&b->win, size, mem);
+		return;
+	}
+
+	b->nb_flows = nb_flows;
+	b->flow_mask = nb_flows - 1;
+	b->flows = mem;
+	b->pending = RTE_PTR_ADD(mem, nb_flows * sizeof(b->flows[0]));
+	mem = RTE_PTR_ADD(b->pending, nb_flows * sizeof(b->pending[0]));
+	for (i = 0; i < nb_flows; i++) {
+		reorder_window_init(&b->flows[i], size, mem);
+		mem = RTE_PTR_ADD(mem, 2 * size * sizeof(struct rte_mbuf *));
+	}
+}
+
 struct rte_reorder_buffer *
 rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 		const char *name, unsigned int size)
@@ -83,26 +169,20 @@ rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 		return NULL;
 	}
 
-	memset(b, 0, bufsize);
-	strlcpy(b->name, name, sizeof(b->name));
-	b->memsize = bufsize;
-	b->order_buf.size = b->ready_buf.size = size;
-	b->order_buf.mask = b->ready_buf.mask = size - 1;
-	b->ready_buf.entries = (void *)&b[1];
-	b->order_buf.entries = RTE_PTR_ADD(&b[1],
-			size * sizeof(b->ready_buf.entries[0]));
+	reorder_buffer_init(b, bufsize, name, size, 1,
+			offsetof(struct rte_mbuf, seqn));
 
 	return b;
 }
 
-struct rte_reorder_buffer*
-rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+static struct rte_reorder_buffer *
+reorder_create(const char *name, unsigned int socket_id, unsigned int size,
+		unsigned int nb_flows, int seqn_offset)
 {
 	struct rte_reorder_buffer *b = NULL;
 	struct rte_tailq_entry *te;
 	struct rte_reorder_list *reorder_list;
-	const unsigned int bufsize = sizeof(struct rte_reorder_buffer) +
-					(2 * size * sizeof(struct rte_mbuf *));
+	size_t bufsize;
 
 	reorder_list = RTE_TAILQ_CAST(rte_reorder_tailq.head, rte_reorder_list);
 
@@ -113,12 +193,25 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 		rte_errno = EINVAL;
 		return NULL;
 	}
+	if (nb_flows > 1 && !rte_is_power_of_2(nb_flows)) {
+		RTE_LOG(ERR, REORDER, "Invalid number of reorder flows"
+				" - Not a power of 2\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
 	if (name == NULL) {
 		RTE_LOG(ERR, REORDER, "Invalid reorder buffer name ptr:"
 					" NULL\n");
 		rte_errno = EINVAL;
 		return NULL;
 	}
+	bufsize = reorder_memsize(size, nb_flows);
+	if (bufsize > UINT32_MAX) {
+		RTE_LOG(ERR, REORDER, "Reorder buffer too large: %u flows"
+				" of %u entries\n", nb_flows, size);
+		rte_errno = EINVAL;
+		return NULL;
+	}
 
 	rte_mcfg_tailq_write_lock();
 
@@ -147,7 +240,8 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 		rte_errno = ENOMEM;
 		rte_free(te);
 	} else {
-		rte_reorder_init(b, bufsize, name, size);
+		reorder_buffer_init(b, bufsize, name, size, nb_flows,
+				seqn_offset);
 		te->data = (void *)b;
 		TAILQ_INSERT_TAIL(reorder_list, te, next);
 	}
@@ -157,28 +251,82 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 	return b;
 }
 
+struct rte_reorder_buffer*
+rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+{
+	return reorder_create(name, socket_id, size, 1,
+			offsetof(struct rte_mbuf, seqn));
+}
+
+struct rte_reorder_buffer *
+rte_reorder_create_ext(const struct rte_reorder_params *params)
+{
+	if (params == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	if (rte_reorder_seqn_dynfield_register() < 0)
+		return NULL;
+
+	return reorder_create(params->name, params->socket_id, params->size,
+			params->nb_flows, rte_reorder_seqn_dynfield_offset);
+}
+
+int
+rte_reorder_seqn_dynfield_register(void)
+{
+	static const struct rte_mbuf_dynfield reorder_seqn_dynfield_desc = {
+		.name = RTE_REORDER_SEQN_DYNFIELD_NAME,
+		.size = sizeof(rte_reorder_seqn_t),
+		.align = __alignof__(rte_reorder_seqn_t),
+	};
+	int offset;
+
+	if (rte_reorder_seqn_dynfield_offset >= 0)
+		return rte_reorder_seqn_dynfield_offset;
+
+	offset = rte_mbuf_dynfield_register(&reorder_seqn_dynfield_desc);
+	/* secondary processes can only use a field the primary registered */
+	if (offset < 0 && rte_errno == EPERM)
+		offset = rte_mbuf_dynfield_lookup(RTE_REORDER_SEQN_DYNFIELD_NAME,
+				NULL);
+	if (offset < 0) {
+		RTE_LOG(ERR, REORDER, "Failed to register mbuf field for"
+				" sequence number: %s\n", rte_strerror(rte_errno));
+		return -1;
+	}
+
+	rte_reorder_seqn_dynfield_offset = offset;
+	return offset;
+}
+
 void
 rte_reorder_reset(struct rte_reorder_buffer *b)
 {
-	char name[RTE_REORDER_NAMESIZE];
+	unsigned int i;
 
 	rte_reorder_free_mbufs(b);
-	strlcpy(name, b->name, sizeof(name));
 	/* No error checking as current values should be valid */
-	rte_reorder_init(b, b->memsize, name, b->order_buf.size);
+	for (i = 0; i < b->nb_flows; i++)
+		reorder_window_reset(&b->flows[i]);
+	b->pending_head = b->pending_tail = b->pending_count = 0;
 }
 
 static void
 rte_reorder_free_mbufs(struct rte_reorder_buffer *b)
 {
-	unsigned i;
+	struct reorder_window *w;
+	unsigned i, f;
 
 	/* Free up the mbufs of order buffer & ready buffer */
-	for (i = 0; i < b->order_buf.size; i++) {
-		if (b->order_buf.entries[i])
-			rte_pktmbuf_free(b->order_buf.entries[i]);
-		if (b->ready_buf.entries[i])
-			rte_pktmbuf_free(b->ready_buf.entries[i]);
+	for (f = 0; f < b->nb_flows; f++) {
+		w = &b->flows[f];
+		for (i = 0; i < w->order_buf.size; i++) {
+			if (w->order_buf.entries[i])
+				rte_pktmbuf_free(w->order_buf.entries[i]);
+			if (w->ready_buf.entries[i])
+				rte_pktmbuf_free(w->ready_buf.entries[i]);
+		}
 	}
 }
 
@@ -247,7 +395,7 @@ rte_reorder_find_existing(const char *name)
 }
 
 static unsigned
-rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
+rte_reorder_fill_overflow(struct reorder_window *w, unsigned n)
 {
 	/*
 	 * 1. Move all ready entries that fit to the ready_buf
@@ -257,8 +405,8 @@ rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 	 * 5. Return the number of positions the order_buf head has moved
 	 */
 
-	struct cir_buffer *order_buf = &b->order_buf,
-			*ready_buf = &b->ready_buf;
+	struct cir_buffer *order_buf = &w->order_buf,
+			*ready_buf = &w->ready_buf;
 
 	unsigned int order_head_adv = 0;
 
@@ -292,26 +440,21 @@ rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 		}
 	}
 
-	b->min_seqn += order_head_adv;
+	w->min_seqn += order_head_adv;
 	/* Return the number of positions the order_buf head has moved */
 	return order_head_adv;
 }
 
-int
-rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+static inline int
+reorder_window_insert(struct reorder_window *w, struct rte_mbuf *mbuf,
+		uint32_t seqn)
 {
+	struct cir_buffer *order_buf = &w->order_buf;
 	uint32_t offset, position;
-	struct cir_buffer *order_buf;
 
-	if (b == NULL || mbuf == NULL) {
-		rte_errno = EINVAL;
-		return -1;
-	}
-
-	order_buf = &b->order_buf;
-	if (!b->is_initialized) {
-		b->min_seqn = mbuf->seqn;
-		b->is_initialized = 1;
+	if (!w->is_initialized) {
+		w->min_seqn = seqn;
+		w->is_initialized = 1;
 	}
 
 	/*
@@ -322,7 +465,7 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 	 *	mbuf_seqn = 0x0010
 	 *	offset    = 0x0010 - 0xFFFD = 0x13
 	 */
-	offset = mbuf->seqn - b->min_seqn;
+	offset = seqn - w->min_seqn;
 
 	/*
 	 * action to take depends on offset.
@@ -342,17 +485,17 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 	 *       was previously skipped, so just enqueue the packet for
 	 *       immediate return on the next drain call, or else return error.
 	 */
-	if (offset < b->order_buf.size) {
+	if (offset < order_buf->size) {
 		position = (order_buf->head + offset) & order_buf->mask;
 		order_buf->entries[position] = mbuf;
-	} else if (offset < 2 * b->order_buf.size) {
-		if (rte_reorder_fill_overflow(b, offset + 1 - order_buf->size)
+	} else if (offset < 2 * order_buf->size) {
+		if (rte_reorder_fill_overflow(w, offset + 1 - order_buf->size)
 				< (offset + 1 - order_buf->size)) {
 			/* Put in handling for enqueue straight to output */
 			rte_errno = ENOSPC;
 			return -1;
 		}
-		offset = mbuf->seqn - b->min_seqn;
+		offset = seqn - w->min_seqn;
 		position = (order_buf->head + offset) & order_buf->mask;
 		order_buf->entries[position] = mbuf;
 	} else {
@@ -363,14 +506,80 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 	return 0;
 }
 
+/* Whether the next drain of the window would return at least one mbuf */
+static inline int
+reorder_window_ready(const struct reorder_window *w)
+{
+	return w->ready_buf.tail != w->ready_buf.head ||
+		w->order_buf.entries[w->order_buf.head] != NULL;
+}
+
+static inline void
+reorder_pending_push(struct rte_reorder_buffer *b, struct reorder_window *w)
+{
+	/* each window is queued at most once, so the ring cannot overflow */
+	b->pending[b->pending_head] = w - b->flows;
+	b->pending_head = (b->pending_head + 1) & b->flow_mask;
+	b->pending_count++;
+	w->queued = 1;
+}
+
+static inline int
+reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+{
+	uint32_t seqn = *RTE_MBUF_DYNFIELD(mbuf, b->seqn_offset, uint32_t *);
+	struct reorder_window *w;
+	int ret;
+
+	if (b->nb_flows == 1)
+		return reorder_window_insert(&b->win, mbuf, seqn);
+
+	w = &b->flows[mbuf->hash.usr & b->flow_mask];
+	ret = reorder_window_insert(w, mbuf, seqn);
+	/* even a failed insert may have moved mbufs to the ready buffer */
+	if (!w->queued && reorder_window_ready(w))
+		reorder_pending_push(b, w);
+	return ret;
+}
+
+int
+rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+{
+	if (b == NULL || mbuf == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	return reorder_insert(b, mbuf);
+}
+
 unsigned int
-rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
-		unsigned max_mbufs)
+rte_reorder_insert_bulk(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int nb_mbufs)
+{
+	unsigned int i;
+
+	if (b == NULL || mbufs == NULL) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+
+	for (i = 0; i < nb_mbufs; i++) {
+		if (reorder_insert(b, mbufs[i]) != 0)
+			break;
+	}
+
+	return i;
+}
+
+static inline unsigned int
+reorder_window_drain(struct reorder_window *w, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs)
 {
 	unsigned int drain_cnt = 0;
 
-	struct cir_buffer *order_buf = &b->order_buf,
-			*ready_buf = &b->ready_buf;
+	struct cir_buffer *order_buf = &w->order_buf,
+			*ready_buf = &w->ready_buf;
 
 	/* Try to fetch requested number of mbufs from ready buffer */
 	while ((drain_cnt < max_mbufs) && (ready_buf->tail != ready_buf->head)) {
@@ -386,9 +595,39 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 			(order_buf->entries[order_buf->head] != NULL)) {
 		mbufs[drain_cnt++] = order_buf->entries[order_buf->head];
 		order_buf->entries[order_buf->head] = NULL;
-		b->min_seqn++;
+		w->min_seqn++;
 		order_buf->head = (order_buf->head + 1) & order_buf->mask;
 	}
 
 	return drain_cnt;
 }
+
+unsigned int
+rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned max_mbufs)
+{
+	unsigned int drain_cnt = 0;
+	struct reorder_window *w;
+
+	if (b->nb_flows == 1)
+		return reorder_window_drain(&b->win, mbufs, max_mbufs);
+
+	/*
+	 * Visit flows in the order they became ready. A flow that still has
+	 * mbufs once the output array is full goes to the back of the list,
+	 * so a busy flow cannot starve the others.
+	 */
+	while (drain_cnt < max_mbufs && b->pending_count != 0) {
+		w = &b->flows[b->pending[b->pending_tail]];
+		b->pending_tail = (b->pending_tail + 1) & b->flow_mask;
+		b->pending_count--;
+		w->queued = 0;
+
+		drain_cnt += reorder_window_drain(w, &mbufs[drain_cnt],
+				max_mbufs - drain_cnt);
+		if (reorder_window_ready(w))
+			reorder_pending_push(b, w);
+	}
+
+	return drain_cnt;
+}
@@ -13,9 +13,14 @@
  * provide ordering of out of ordered packets based on
  * sequence number present in mbuf.
  *
+ * Buffers created with rte_reorder_create_ext() take the sequence number
+ * from a dynamic mbuf field and can keep one sequence space per flow.
+ *
  */
 
+#include <rte_compat.h>
 #include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +28,71 @@ extern "C" {
 
 struct rte_reorder_buffer;
 
+/** Name of the dynamic mbuf field holding the reorder sequence number. */
+#define RTE_REORDER_SEQN_DYNFIELD_NAME "rte_reorder_seqn_dynfield"
+
+/** Type of the reorder sequence number dynamic mbuf field. */
+typedef uint32_t rte_reorder_seqn_t;
+
+/**
+ * Offset of the sequence number dynamic mbuf field, -1 until
+ * rte_reorder_seqn_dynfield_register() or rte_reorder_create_ext()
+ * has been called.
+ */
+extern int rte_reorder_seqn_dynfield_offset;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get a pointer to the sequence number dynamic field of an mbuf.
+ *
+ * The field must have been registered first, see
+ * rte_reorder_seqn_dynfield_register().
+ *
+ * @param mbuf
+ *   The mbuf.
+ * @return
+ *   Pointer to the sequence number of the mbuf.
+ */
+__rte_experimental
+static inline rte_reorder_seqn_t *
+rte_reorder_seqn(struct rte_mbuf *mbuf)
+{
+	return RTE_MBUF_DYNFIELD(mbuf, rte_reorder_seqn_dynfield_offset,
+		rte_reorder_seqn_t *);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Register the sequence number dynamic mbuf field.
+ *
+ * Only needed by a sequencing stage that runs before any buffer has been
+ * created with rte_reorder_create_ext(), which registers the field itself.
+ * Calling it again returns the already registered offset.
+ *
+ * @return
+ *   The offset of the field in the mbuf, or -1 on error with rte_errno set
+ *   as by rte_mbuf_dynfield_register().
+ */
+__rte_experimental
+int
+rte_reorder_seqn_dynfield_register(void);
+
+/** Parameters of a reorder buffer created with rte_reorder_create_ext(). */
+struct rte_reorder_params {
+	const char *name;       /**< Name of the reorder buffer instance. */
+	unsigned int socket_id; /**< NUMA node to allocate memory on. */
+	unsigned int size;      /**< Reorder window size of each flow,
+				  *  power of 2. */
+	unsigned int nb_flows;  /**< Number of independent sequence spaces,
+				  *  0 or 1 for a single one, else a power
+				  *  of 2. An mbuf belongs to flow
+				  *  (mbuf->hash.usr & (nb_flows - 1)). */
+};
+
 /**
  * Create a new reorder buffer instance
  *
@@ -45,6 +115,35 @@ struct rte_reorder_buffer;
 struct rte_reorder_buffer *
 rte_reorder_create(const char *name, unsigned socket_id, unsigned int size);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new reorder buffer instance using the sequence number field
+ * registered in the mbuf, optionally with one sequence space per flow.
+ *
+ * In flow mode each flow has its own reorder window of params->size
+ * entries and its own sequence numbers, starting at whatever value the
+ * first mbuf of the flow carries. A missing mbuf only holds back later
+ * mbufs of its own flow. rte_reorder_drain() returns each flow in order,
+ * interleaving flows in the order they became ready.
+ *
+ * The sequence number dynamic field is registered if needed, the
+ * sequencing stage writes it with rte_reorder_seqn().
+ *
+ * @param params
+ *   Parameters of the reorder buffer.
+ * @return
+ *   The initialized reorder buffer instance, or NULL on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ *    - EINVAL - invalid parameters
+ *    - any error of rte_reorder_seqn_dynfield_register()
+ */
+__rte_experimental
+struct rte_reorder_buffer *
+rte_reorder_create_ext(const struct rte_reorder_params *params);
+
 /**
  * Initializes given reorder buffer instance
  *
@@ -125,6 +224,31 @@ rte_reorder_free(struct rte_reorder_buffer *b);
 int
 rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Insert a burst of mbufs in reorder buffer in their correct positions
+ *
+ * Equivalent to calling rte_reorder_insert() on each mbuf in turn, but
+ * stops at the first mbuf that cannot be inserted.
+ *
+ * @param b
+ *   Reorder buffer where the mbufs have to be inserted.
+ * @param mbufs
+ *   Array of mbufs to insert.
+ * @param nb_mbufs
+ *   Number of mbufs in the array.
+ * @return
+ *   Number of mbufs inserted. If less than nb_mbufs, rte_errno is set as
+ *   by rte_reorder_insert() for mbufs[return value], which, like all the
+ *   following mbufs, is still owned by the caller.
+ */
+__rte_experimental
+unsigned int
+rte_reorder_insert_bulk(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int nb_mbufs);
+
 /**
  * Fetch reordered buffers
  *